@@ -0,0 +1,153 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class BenchmarkRunner;
+
+//==============================================================================
+/**
+    A group of related timings.
+
+    Like a UnitTest, each benchmark registers itself when it's created, so to add one
+    you just need to declare a static instance of your subclass.
+*/
+class Benchmark
+{
+public:
+    Benchmark (const String& benchmarkName, const String& benchmarkCategory);
+    virtual ~Benchmark();
+
+    /** Runs the timings, passing each result to BenchmarkRunner::report(). */
+    virtual void run (BenchmarkRunner& runner) = 0;
+
+    const String name, category;
+
+    /** Returns all the benchmarks that have been created. */
+    static Array<Benchmark*>& getAllBenchmarks();
+
+private:
+    JUCE_DECLARE_NON_COPYABLE (Benchmark)
+};
+
+//==============================================================================
+/**
+    Times functions and prints the results.
+*/
+class BenchmarkRunner
+{
+public:
+    /** Creates a runner that spends roughly the given time on each measurement. */
+    explicit BenchmarkRunner (double secondsPerMeasurementToUse)
+        : secondsPerMeasurement (secondsPerMeasurementToUse)
+    {
+    }
+
+    /** Returns the number of seconds that one call to a function takes.
+
+        The function is called in batches that each last at least a millisecond, and
+        the fastest batch is used, which filters out most of the noise caused by other
+        processes and by the first calls warming up the caches.
+    */
+    template <typename Function>
+    double timeCall (Function&& function)
+    {
+        function();
+
+        int64 callsPerBatch = 1;
+
+        while (timeBatch (function, callsPerBatch) < 0.001)
+            callsPerBatch *= 2;
+
+        auto fastest = std::numeric_limits<double>::max();
+        const auto start = Time::getMillisecondCounterHiRes();
+
+        for (int batch = 0; batch < 3 || Time::getMillisecondCounterHiRes() - start < secondsPerMeasurement * 1000.0; ++batch)
+            fastest = jmin (fastest, timeBatch (function, callsPerBatch));
+
+        return fastest / (double) callsPerBatch;
+    }
+
+    /** Prints a result, e.g. report ("add, 4096 values", "AVX2", 20.5, "GFLOP/s"). */
+    void report (const String& measurement, const String& variant, double value, const String& units)
+    {
+        std::cout << "  " << measurement.paddedRight (' ', 44)
+                  << " " << variant.paddedRight (' ', 20)
+                  << " " << String (value, 3).paddedLeft (' ', 12)
+                  << " " << units << std::endl;
+    }
+
+    /** Returns the time that one measurement should take. */
+    double getSecondsPerMeasurement() const noexcept    { return secondsPerMeasurement; }
+
+private:
+    template <typename Function>
+    static double timeBatch (Function& function, int64 numCalls)
+    {
+        const auto start = Time::getHighResolutionTicks();
+
+        for (int64 i = 0; i < numCalls; ++i)
+            function();
+
+        return Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+    }
+
+    const double secondsPerMeasurement;
+
+    JUCE_DECLARE_NON_COPYABLE (BenchmarkRunner)
+};
+
+//==============================================================================
+#if JUCE_LINUX || JUCE_BSD
+namespace juce::detail
+{
+    bool dispatchNextMessageOnSystemQueue (bool returnIfNoPendingMessages);
+}
+#endif
+
+/** Waits for the next message and delivers it, in the same way as the app's main loop.
+
+    A modal loop like runDispatchLoopUntil() sleeps for a millisecond whenever the queue
+    is empty, which would hide the time it takes to wake up the message thread.
+*/
+inline void dispatchNextMessage()
+{
+   #if JUCE_LINUX || JUCE_BSD
+    detail::dispatchNextMessageOnSystemQueue (false);
+   #else
+    MessageManager::getInstance()->runDispatchLoopUntil (1);
+   #endif
+}
+
+//==============================================================================
+/** Stops the compiler from optimising away a result that a benchmark doesn't use. */
+template <typename Type>
+void keepResult (const Type& result)
+{
+    static volatile char sink = 0;
+    sink = (char) (sink + *reinterpret_cast<const volatile char*> (&result));
+}
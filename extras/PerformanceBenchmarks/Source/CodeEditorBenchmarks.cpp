@@ -0,0 +1,142 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+#include "Benchmark.h"
+
+//==============================================================================
+/**
+    Times typing near the top of a long C++ file, both in a CodeDocument on its own and
+    in a CodeEditorComponent that is showing the end of the file, and the first jump
+    to the end of a newly loaded file.
+*/
+class CodeEditorBenchmark final : public Benchmark
+{
+public:
+    CodeEditorBenchmark()  : Benchmark ("CodeEditorComponent editing", "GUI") {}
+
+    void run (BenchmarkRunner& runner) override
+    {
+        const auto text = createSourceText();
+        const auto measurement = String (numLines) + "-line C++ file";
+
+        const auto reportMilliseconds = [&] (const String& variant, double seconds)
+        {
+            runner.report (measurement, variant, seconds * 1.0e3, "ms");
+        };
+
+        CodeDocument document;
+        document.replaceAllContent (text);
+        const auto editPosition = CodeDocument::Position (document, 10, 4).getPosition();
+
+        // Each call types a character and deletes it again, so the document doesn't grow
+        runner.report (measurement, "document edit", runner.timeCall ([&]
+        {
+            document.insertText (editPosition, "x");
+            document.deleteSection (editPosition, editPosition + 1);
+        }) * 1.0e6, "us");
+
+        CPlusPlusCodeTokeniser tokeniser;
+
+        {
+            CodeEditorComponent editor (document, &tokeniser);
+            editor.setSize (width, height);
+            editor.scrollToLine (numLines);
+            paint (editor);
+
+            reportMilliseconds ("edit, paint the end", runner.timeCall ([&]
+            {
+                document.insertText (editPosition, "x");
+                paint (editor);
+                document.deleteSection (editPosition, editPosition + 1);
+                paint (editor);
+            }));
+        }
+
+        reportMilliseconds ("jump after loading", timeJumpToEnd (text, tokeniser, 0));
+        reportMilliseconds ("jump after 1.5s idle", timeJumpToEnd (text, tokeniser, 1500));
+    }
+
+private:
+    static constexpr int numLines = 100000, width = 800, height = 600;
+
+    Image image { Image::ARGB, width, height, true };
+
+    void paint (Component& editor)
+    {
+        Graphics g (image);
+        editor.paintEntireComponent (g, false);
+    }
+
+    // This can only happen once per editor, so it's timed on a new one each time
+    double timeJumpToEnd (const String& text, CodeTokeniser& tokeniser, int idleMilliseconds)
+    {
+        auto fastest = std::numeric_limits<double>::max();
+
+        for (int i = 0; i < 3; ++i)
+        {
+            CodeDocument document;
+            CodeEditorComponent editor (document, &tokeniser);
+            editor.setSize (width, height);
+            editor.loadContent (text);
+            paint (editor);
+
+            if (idleMilliseconds > 0)
+                MessageManager::getInstance()->runDispatchLoopUntil (idleMilliseconds);
+
+            const auto start = Time::getHighResolutionTicks();
+            editor.scrollToLine (numLines);
+            paint (editor);
+            fastest = jmin (fastest, Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start));
+        }
+
+        return fastest;
+    }
+
+    static String createSourceText()
+    {
+        static const char* const snippets[] =
+        {
+            "    for (int i = 0; i < numSamples; ++i)",
+            "        buffer[i] = std::sin (phase += delta) * 0.5f; // update the oscillator",
+            "    /* a short block comment */ const auto gain = Decibels::decibelsToGain (-6.0f);",
+            "    if (auto* channel = getWritePointer (ch); channel != nullptr)",
+            "        logger.write (\"processed block \" + String (blockNumber));",
+            "    }",
+            "",
+            "#include <vector>"
+        };
+
+        Random random (1);
+        MemoryOutputStream text;
+
+        for (int line = 0; line < numLines; ++line)
+            text << snippets[random.nextInt (numElementsInArray (snippets))] << "\n";
+
+        return text.toString();
+    }
+};
+
+static CodeEditorBenchmark codeEditorBenchmark;
@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+#include "Benchmark.h"
+
+//==============================================================================
+/**
+    Compares painting a scene directly with recording it into a DisplayList and
+    replaying it, and times the comparison that finds what changed between frames.
+*/
+class DisplayListBenchmark final : public Benchmark
+{
+public:
+    DisplayListBenchmark()  : Benchmark ("Display lists", "Graphics") {}
+
+    void run (BenchmarkRunner& runner) override
+    {
+        Image image (Image::ARGB, width, height, true);
+        const Rectangle<int> bounds (width, height);
+        const auto measurement = String (numItems) + "-item scene, " + String (width) + "x" + String (height);
+
+        const auto reportMilliseconds = [&] (const String& variant, auto&& function)
+        {
+            runner.report (measurement, variant, runner.timeCall (function) * 1.0e3, "ms");
+        };
+
+        const auto record = [&] (int changedItem)
+        {
+            DisplayList list;
+
+            {
+                LowLevelGraphicsDisplayListRecorder recorder (list, bounds);
+                Graphics g (recorder);
+                drawScene (g, changedItem);
+            }
+
+            return list;
+        };
+
+        reportMilliseconds ("paint", [&]
+        {
+            Graphics g (image);
+            drawScene (g, -1);
+        });
+
+        reportMilliseconds ("record", [&] { keepResult (record (-1).getNumDrawingOperations()); });
+
+        const auto list = record (-1);
+
+        reportMilliseconds ("replay", [&]
+        {
+            LowLevelGraphicsSoftwareRenderer context (image);
+            list.replay (context);
+        });
+
+        reportMilliseconds ("replay 100x100 area", [&]
+        {
+            LowLevelGraphicsSoftwareRenderer context (image);
+            list.replay (context, { 250, 150, 100, 100 });
+        });
+
+        const auto changedList = record (numItems / 2);
+
+        reportMilliseconds ("find changed area", [&]
+        {
+            keepResult (DisplayList::findChangedArea (list, changedList).getBounds());
+        });
+
+        // Only the item that changed colour should need repainting
+        const auto changedArea = DisplayList::findChangedArea (list, changedList).getBounds();
+        runner.report (measurement, "changed area", changedArea.getWidth() * changedArea.getHeight(), "pixels");
+        runner.report (measurement, "operations", list.getNumDrawingOperations(), "ops");
+    }
+
+private:
+    static constexpr int width = 600, height = 400, numItems = 300;
+
+    // A mixture of shapes and labels, where one item can be given a different colour
+    static void drawScene (Graphics& g, int changedItem)
+    {
+        g.fillAll (Colours::white);
+        g.setFont (13.0f);
+
+        for (int i = 0; i < numItems; ++i)
+        {
+            Random r (i);
+            const Rectangle<float> area (r.nextFloat() * (float) width, r.nextFloat() * (float) height,
+                                         10.0f + r.nextFloat() * 50.0f, 10.0f + r.nextFloat() * 30.0f);
+            auto colour = Colour ((uint32) r.nextInt()).withAlpha (0.4f + 0.6f * r.nextFloat());
+
+            if (i == changedItem)
+                colour = colour.contrasting();
+
+            g.setColour (colour);
+
+            switch (i % 4)
+            {
+                case 0:  g.fillRoundedRectangle (area, 4.0f); break;
+                case 1:  g.drawEllipse (area, 2.0f); break;
+                case 2:  g.drawRect (area, 1.5f); break;
+                default: g.fillRect (area); break;
+            }
+
+            if (i % 3 == 0)
+            {
+                g.setColour (Colours::black);
+                g.drawText ("Item " + String (i), area, Justification::centred, false);
+            }
+        }
+    }
+};
+
+static DisplayListBenchmark displayListBenchmark;
@@ -0,0 +1,119 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+
+#if JUCE_LINUX || JUCE_BSD
+
+#include <fcntl.h>
+#include <unistd.h>
+
+//==============================================================================
+/**
+    Measures what it costs the message loop to wake up for one ready file descriptor
+    as the number of idle ones registered alongside it grows, and what each callback
+    costs when many descriptors are ready at once.
+*/
+class EventLoopBenchmark final : public Benchmark
+{
+public:
+    EventLoopBenchmark()  : Benchmark ("Event loop file descriptors", "Events") {}
+
+    void run (BenchmarkRunner& runner) override
+    {
+        for (auto numIdle : { 0, 16, 256 })
+        {
+            std::vector<std::unique_ptr<Pipe>> idle;
+
+            for (int i = 0; i < numIdle; ++i)
+                idle.push_back (std::make_unique<Pipe>());
+
+            Pipe active;
+
+            const auto measurement = String (numIdle) + " idle fds registered";
+            runner.report (measurement, "wake for 1 fd", runner.timeCall ([&]
+            {
+                active.signal();
+                dispatchNextMessage();
+            }) * 1.0e6, "us");
+        }
+
+        {
+            constexpr int numReady = 32;
+            std::vector<std::unique_ptr<Pipe>> ready;
+
+            for (int i = 0; i < numReady; ++i)
+                ready.push_back (std::make_unique<Pipe>());
+
+            runner.report (String (numReady) + " fds ready at once", "per callback", runner.timeCall ([&]
+            {
+                for (auto& pipe : ready)
+                    pipe->signal();
+
+                // they're all delivered in one batch
+                dispatchNextMessage();
+            }) * 1.0e6 / numReady, "us");
+        }
+    }
+
+private:
+    // A pipe whose read end is registered with the message loop
+    struct Pipe
+    {
+        Pipe()
+        {
+            [[maybe_unused]] const auto result = pipe (fds);
+            jassert (result == 0);
+            fcntl (fds[0], F_SETFL, fcntl (fds[0], F_GETFL) | O_NONBLOCK);
+
+            LinuxEventLoop::registerFdCallback (fds[0], [] (int fd)
+            {
+                char buffer[16];
+
+                while (read (fd, buffer, sizeof (buffer)) > 0)
+                {}
+            });
+        }
+
+        ~Pipe()
+        {
+            LinuxEventLoop::unregisterFdCallback (fds[0]);
+            close (fds[0]);
+            close (fds[1]);
+        }
+
+        void signal()
+        {
+            const char x = 0;
+            [[maybe_unused]] const auto numBytes = write (fds[1], &x, 1);
+        }
+
+        int fds[2];
+    };
+};
+
+static EventLoopBenchmark eventLoopBenchmark;
+
+#endif
@@ -0,0 +1,219 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+
+//==============================================================================
+/**
+    Draws scenes like the pages of the GraphicsDemo into a window-sized image,
+    comparing the single-threaded software renderer with
+    LowLevelGraphicsTiledSoftwareRenderer.
+*/
+class GraphicsRenderingBenchmark final : public Benchmark
+{
+public:
+    GraphicsRenderingBenchmark()  : Benchmark ("Software rendering", "Graphics") {}
+
+    void run (BenchmarkRunner& runner) override
+    {
+        const auto numThreads = jmax (1, SystemStats::getNumCpus() - 1) + 1;
+        const auto tiledName = "tiled, " + String (numThreads) + (numThreads == 1 ? " thread" : " threads");
+
+        for (auto& scene : getScenes())
+        {
+            const auto measurement = String (scene.name) + ", " + String (width) + "x" + String (height);
+
+            runner.report (measurement, "single-threaded",
+                           1.0 / runner.timeCall ([&] { renderFrame<LowLevelGraphicsSoftwareRenderer> (scene); }),
+                           "frames/s");
+
+            runner.report (measurement, tiledName,
+                           1.0 / runner.timeCall ([&] { renderFrame<LowLevelGraphicsTiledSoftwareRenderer> (scene); }),
+                           "frames/s");
+        }
+    }
+
+private:
+    static constexpr int width = 1280, height = 800;
+
+    struct Scene
+    {
+        const char* name;
+        std::function<void (Graphics&)> draw;
+    };
+
+    Image target { Image::ARGB, width, height, true };
+
+    template <typename RendererType>
+    void renderFrame (const Scene& scene)
+    {
+        // The tiled renderer only draws when it's deleted, so it has to be inside this scope
+        RendererType renderer (target);
+        Graphics g (renderer);
+
+        g.fillAll (Colours::white);
+        scene.draw (g);
+    }
+
+    // The same sort of animated transform that the GraphicsDemo uses, frozen at one position
+    static AffineTransform getTransform()
+    {
+        return AffineTransform::rotation (0.3f)
+                               .scaled (1.5f)
+                               .translated ((float) width * 0.5f, (float) height * 0.5f);
+    }
+
+    static std::vector<Scene> getScenes()
+    {
+        std::vector<Scene> scenes;
+
+        scenes.push_back ({ "rectangles", [] (Graphics& g)
+        {
+            g.addTransform (getTransform());
+            const auto size = jmin (width, height) / 2 - 20;
+
+            g.setColour (Colours::red.withAlpha (0.8f));
+            g.fillRect (-size, -size, size, size);
+
+            g.setGradientFill (ColourGradient (Colours::red, 10.0f, (float) -size, Colours::green, 10.0f + (float) size, 0.0f, false));
+            g.fillRect (10, -size, size, size);
+
+            g.setGradientFill (ColourGradient (Colours::red, (float) size * -0.5f, 10.0f + (float) size * 0.5f,
+                                               Colours::green, 0.0f, 10.0f + (float) size, true));
+            g.fillRect (-size, 10, size, size);
+            g.drawRect (10, 10, size, size, 5);
+        } });
+
+        scenes.push_back ({ "paths with a gradient", [shapes = createShapes()] (Graphics& g)
+        {
+            ColourGradient gradient (Colours::blue, 0.0f, 0.0f, Colours::orange, (float) width, (float) height, false);
+            gradient.addColour (0.4, Colours::green);
+
+            g.setGradientFill (gradient);
+            g.setOpacity (0.8f);
+            g.fillPath (shapes, getTransform());
+        } });
+
+        scenes.push_back ({ "stroked path", [outline = createCurve()] (Graphics& g)
+        {
+            g.setColour (Colours::purple.withAlpha (0.8f));
+            g.strokePath (outline, PathStrokeType (8.0f));
+        } });
+
+        scenes.push_back ({ "transformed image", [image = createImage()] (Graphics& g)
+        {
+            g.setOpacity (0.8f);
+            g.drawImageTransformed (image, AffineTransform::translation ((float) image.getWidth() * -0.5f,
+                                                                         (float) image.getHeight() * -0.5f)
+                                                           .followedBy (getTransform()));
+        } });
+
+        scenes.push_back ({ "glyphs", [glyphs = createGlyphs()] (Graphics& g)
+        {
+            g.setColour (Colours::black);
+            glyphs.draw (g, AffineTransform::rotation (0.1f));
+        } });
+
+        scenes.push_back ({ "lines", [] (Graphics& g)
+        {
+            RectangleList<float> lines;
+
+            for (int x = 0; x < width; ++x)
+            {
+                const auto y = (float) height * 0.3f;
+                const auto length = y * std::abs (std::sin ((float) x / 100.0f));
+                lines.addWithoutMerging ({ (float) x, y - length * 0.5f, 1.0f, length });
+            }
+
+            g.setColour (Colours::blue.withAlpha (0.8f));
+            g.fillRectList (lines);
+
+            g.setColour (Colours::red);
+            g.drawLine (0.0f, 0.0f, (float) width, (float) height);
+            g.drawLine (0.0f, (float) height, (float) width, 0.0f);
+        } });
+
+        return scenes;
+    }
+
+    static Path createShapes()
+    {
+        Path p;
+        p.addStar ({}, 12, 60.0f, 120.0f, 0.2f);
+        p.addStar ({ -300.0f, -50.0f }, 7, 30.0f, 70.0f, 0.1f);
+        p.addStar ({ 300.0f, 50.0f }, 6, 40.0f, 70.0f, 0.1f);
+        p.addEllipse (-100.0f, 150.0f, 200.0f, 140.0f);
+        p.addRoundedRectangle (-100.0f, -280.0f, 200.0f, 140.0f, 20.0f);
+        return p;
+    }
+
+    static Path createCurve()
+    {
+        Random random (1);
+        const auto randomPoint = [&] { return Point<float> (random.nextFloat() * (float) width, random.nextFloat() * (float) height); };
+
+        Path p;
+        p.startNewSubPath (randomPoint());
+
+        for (int i = 0; i < 8; ++i)
+            p.quadraticTo (randomPoint(), randomPoint());
+
+        p.closeSubPath();
+        return p;
+    }
+
+    static Image createImage()
+    {
+        Image image (Image::ARGB, 400, 300, true);
+        Graphics g (image);
+
+        g.setGradientFill (ColourGradient (Colours::yellow, 0.0f, 0.0f, Colours::darkblue, 400.0f, 300.0f, false));
+        g.fillRoundedRectangle (0.0f, 0.0f, 400.0f, 300.0f, 40.0f);
+
+        Random random (2);
+
+        for (int i = 0; i < 40; ++i)
+        {
+            g.setColour (Colour ((uint32) random.nextInt()).withAlpha (0.5f));
+            g.fillEllipse (random.nextFloat() * 360.0f, random.nextFloat() * 260.0f, 40.0f, 40.0f);
+        }
+
+        return image;
+    }
+
+    static GlyphArrangement createGlyphs()
+    {
+        GlyphArrangement glyphs;
+
+        for (int line = 0; line < 40; ++line)
+            glyphs.addLineOfText (Font (16.0f), "The Quick Brown Fox Jumped Over The Lazy Dog. "
+                                                "Pack my box with five dozen liquor jugs.",
+                                  20.0f, 20.0f + (float) line * 19.0f);
+
+        return glyphs;
+    }
+};
+
+static GraphicsRenderingBenchmark graphicsRenderingBenchmark;
@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+#include "Benchmark.h"
+
+//==============================================================================
+/**
+    Compares drawing a large image at a quarter of its size with high-quality
+    resampling on every paint against drawing the scaled copy that ImageCache keeps.
+*/
+class ImageCacheBenchmark final : public Benchmark
+{
+public:
+    ImageCacheBenchmark()  : Benchmark ("ImageCache scaled images", "Graphics") {}
+
+    void run (BenchmarkRunner& runner) override
+    {
+        constexpr int64 hashCode = 0x6a4e3c1b;
+        constexpr auto scale = 0.25f;
+
+        const auto original = createImage();
+        ImageCache::addImageToCache (original, hashCode);
+
+        const auto targetSize = roundToInt ((float) imageSize * scale);
+        const Rectangle<float> targetArea ((float) targetSize, (float) targetSize);
+        const auto measurement = String (imageSize) + "x" + String (imageSize) + " image drawn at "
+                                   + String (targetSize) + "x" + String (targetSize);
+
+        Image target (Image::ARGB, targetSize, targetSize, true);
+
+        const auto reportMilliseconds = [&] (const String& variant, auto&& function)
+        {
+            runner.report (measurement, variant, runner.timeCall (function) * 1.0e3, "ms");
+        };
+
+        reportMilliseconds ("resampled each paint", [&]
+        {
+            Graphics g (target);
+            g.setImageResamplingQuality (Graphics::highResamplingQuality);
+            g.drawImage (original, targetArea);
+        });
+
+        reportMilliseconds ("cached scaled copy", [&]
+        {
+            Graphics g (target);
+            g.drawImageAt (ImageCache::getFromHashCode (hashCode, scale), 0, 0);
+        });
+
+        // Replacing the original discards its scaled copies, so this is the one-off cost of a miss
+        reportMilliseconds ("creating scaled copy", [&]
+        {
+            ImageCache::addImageToCache (original, hashCode);
+            keepResult (ImageCache::getFromHashCode (hashCode, scale).getWidth());
+        });
+
+        ImageCache::releaseUnusedImages();
+    }
+
+private:
+    static constexpr int imageSize = 1024;
+
+    static Image createImage()
+    {
+        Image image (Image::ARGB, imageSize, imageSize, true);
+        Graphics g (image);
+        Random random (1);
+
+        for (int i = 0; i < 300; ++i)
+        {
+            g.setColour (Colour ((uint32) random.nextInt()));
+            g.fillEllipse ((float) random.nextInt (imageSize), (float) random.nextInt (imageSize),
+                           10.0f + random.nextFloat() * 200.0f, 10.0f + random.nextFloat() * 200.0f);
+        }
+
+        return image;
+    }
+};
+
+static ImageCacheBenchmark imageCacheBenchmark;
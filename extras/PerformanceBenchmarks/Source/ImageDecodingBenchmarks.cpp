@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+#include "Benchmark.h"
+
+//==============================================================================
+/**
+    Times making a thumbnail from a large JPEG, by decoding it at full size and then
+    rescaling it, and by asking the decoder for a smaller image, which lets it skip
+    most of the inverse DCT.
+*/
+class ImageDecodingBenchmark final : public Benchmark
+{
+public:
+    ImageDecodingBenchmark()  : Benchmark ("Image decoding", "Graphics") {}
+
+    void run (BenchmarkRunner& runner) override
+    {
+        const auto jpeg = createJPEG();
+        const auto measurement = String (sourceWidth) + "x" + String (sourceHeight) + " JPEG to "
+                                   + String (thumbnailWidth) + "x" + String (thumbnailHeight);
+
+        const auto reportMilliseconds = [&] (const String& variant, auto&& function)
+        {
+            runner.report (measurement, variant, runner.timeCall (function) * 1.0e3, "ms");
+        };
+
+        reportMilliseconds ("full size, rescale", [&]
+        {
+            const auto image = ImageFileFormat::loadFrom (jpeg.getData(), jpeg.getSize());
+            keepResult (image.rescaled (thumbnailWidth, thumbnailHeight).getWidth());
+        });
+
+        ImageFileFormat::DecodeOptions options;
+        options.minimumWidth = thumbnailWidth;
+        options.minimumHeight = thumbnailHeight;
+
+        reportMilliseconds ("reduced, rescale", [&]
+        {
+            const auto image = ImageFileFormat::loadFrom (jpeg.getData(), jpeg.getSize(), options);
+            keepResult (image.rescaled (thumbnailWidth, thumbnailHeight).getWidth());
+        });
+
+        runner.report (measurement, "reduced decode width",
+                       ImageFileFormat::loadFrom (jpeg.getData(), jpeg.getSize(), options).getWidth(), "pixels");
+    }
+
+private:
+    static constexpr int sourceWidth = 2048, sourceHeight = 1536, thumbnailWidth = 256, thumbnailHeight = 192;
+
+    // Smooth gradients and shapes with some noise, so that it compresses like a photo
+    static MemoryBlock createJPEG()
+    {
+        Image image (Image::RGB, sourceWidth, sourceHeight, true);
+
+        {
+            Graphics g (image);
+            g.setGradientFill (ColourGradient (Colours::skyblue, 0.0f, 0.0f, Colours::darkgreen, 0.0f, (float) sourceHeight, false));
+            g.fillAll();
+
+            Random random (1);
+
+            for (int i = 0; i < 200; ++i)
+            {
+                g.setColour (Colour ((uint32) random.nextInt()).withAlpha (0.5f));
+                g.fillEllipse ((float) random.nextInt (sourceWidth), (float) random.nextInt (sourceHeight),
+                               20.0f + random.nextFloat() * 300.0f, 20.0f + random.nextFloat() * 300.0f);
+            }
+
+            for (int i = 0; i < 200000; ++i)
+            {
+                g.setColour (Colour::greyLevel (random.nextFloat()).withAlpha (0.3f));
+                g.fillRect (random.nextInt (sourceWidth), random.nextInt (sourceHeight), 2, 2);
+            }
+        }
+
+        MemoryOutputStream stream;
+        JPEGImageFormat format;
+        format.setQuality (0.85f);
+        format.writeImageToStream (image, stream);
+        return stream.getMemoryBlock();
+    }
+};
+
+static ImageDecodingBenchmark imageDecodingBenchmark;
@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+
+//==============================================================================
+/**
+    Times performLayout() on a FlexBox of nested FlexBoxes, a single wrapping
+    FlexBox and an auto-placed Grid, each controlling 4000 components, when the
+    area changes size, when it only moves, and when nothing has changed.
+*/
+class LayoutBenchmark final : public Benchmark
+{
+public:
+    LayoutBenchmark()  : Benchmark ("FlexBox and Grid layout", "GUI") {}
+
+    void run (BenchmarkRunner& runner) override
+    {
+        OwnedArray<Component> components;
+
+        for (int i = 0; i < numRows * numColumns; ++i)
+            components.add (new Component());
+
+        runNestedFlexBox (runner, components);
+        runWrappingFlexBox (runner, components);
+        runGrid (runner, components);
+    }
+
+private:
+    static constexpr int numRows = 50, numColumns = 80;
+
+    template <typename LayOut>
+    static void reportResizing (BenchmarkRunner& runner, const String& measurement, LayOut&& layOut)
+    {
+        const auto reportMilliseconds = [&] (const String& variant, auto&& function)
+        {
+            runner.report (measurement, variant, runner.timeCall (function) * 1.0e3, "ms");
+        };
+
+        int count = 0;
+        reportMilliseconds ("width changed", [&] { layOut (Rectangle<int> (0, 0, 1600 + (++count & 1) * 8, 1000)); });
+        reportMilliseconds ("unchanged",     [&] { layOut (Rectangle<int> (0, 0, 1600, 1000)); });
+        reportMilliseconds ("moved only",    [&] { layOut (Rectangle<int> ((++count & 1) * 8, 0, 1600, 1000)); });
+    }
+
+    static void runNestedFlexBox (BenchmarkRunner& runner, OwnedArray<Component>& components)
+    {
+        std::vector<FlexBox> rows ((size_t) numRows);
+        FlexBox column (FlexBox::Direction::column, FlexBox::Wrap::noWrap, FlexBox::AlignContent::stretch,
+                        FlexBox::AlignItems::stretch, FlexBox::JustifyContent::flexStart);
+
+        for (int row = 0; row < numRows; ++row)
+        {
+            auto& box = rows[(size_t) row];
+
+            for (int i = 0; i < numColumns; ++i)
+                box.items.add (FlexItem (*components[row * numColumns + i]).withFlex (1.0f).withMinWidth (4.0f));
+
+            column.items.add (FlexItem (box).withFlex (1.0f));
+        }
+
+        const auto measurement = String (numRows) + " nested FlexBoxes of " + String (numColumns) + " items";
+        reportResizing (runner, measurement, [&] (Rectangle<int> area) { column.performLayout (area); });
+
+        // re-lays out one nested box in the area it was last given, as happens when
+        // only that box's items have changed
+        auto& box = rows.front();
+        int count = 0;
+        runner.report (measurement, "one row changed",
+                       runner.timeCall ([&]
+                       {
+                           box.items.getReference (0).flexGrow = (++count & 1) != 0 ? 2.0f : 1.0f;
+                           box.performLayout();
+                       }) * 1.0e3, "ms");
+    }
+
+    static void runWrappingFlexBox (BenchmarkRunner& runner, OwnedArray<Component>& components)
+    {
+        FlexBox box (FlexBox::Direction::row, FlexBox::Wrap::wrap, FlexBox::AlignContent::flexStart,
+                     FlexBox::AlignItems::stretch, FlexBox::JustifyContent::flexStart);
+
+        for (auto* c : components)
+            box.items.add (FlexItem (*c).withWidth (19.0f).withHeight (20.0f).withFlex (1.0f));
+
+        reportResizing (runner, "Wrapping FlexBox of " + String (components.size()) + " items",
+                        [&] (Rectangle<int> area) { box.performLayout (area); });
+    }
+
+    static void runGrid (BenchmarkRunner& runner, OwnedArray<Component>& components)
+    {
+        using Track = Grid::TrackInfo;
+
+        Grid grid;
+        grid.autoRows = Track (Grid::Px (20));
+
+        for (int i = 0; i < 8; ++i)
+            grid.templateColumns.add (Track (Grid::Fr (1)));
+
+        for (auto* c : components)
+            grid.items.add (GridItem (*c));
+
+        reportResizing (runner, "8-column Grid of " + String (components.size()) + " auto-placed items",
+                        [&] (Rectangle<int> area) { grid.performLayout (area); });
+    }
+};
+
+static LayoutBenchmark layoutBenchmark;
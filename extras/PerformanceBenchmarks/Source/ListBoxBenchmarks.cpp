@@ -0,0 +1,125 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+
+//==============================================================================
+/**
+    Times scrolling, jumping and selecting in a TableListBox with ten million rows
+    and a custom component in every cell, with uniform and variable row heights.
+*/
+class ListBoxBenchmark final : public Benchmark
+{
+public:
+    ListBoxBenchmark()  : Benchmark ("ListBox scrolling latency", "GUI") {}
+
+    void run (BenchmarkRunner& runner) override
+    {
+        for (auto variableHeights : { false, true })
+        {
+            Model model;
+            TableListBox table ({}, &model);
+
+            for (int column = 1; column <= numColumns; ++column)
+                table.getHeader().addColumn ("Column " + String (column), column, 90);
+
+            table.setBounds (0, 0, 800, 600);
+            table.setVisible (true);
+            table.setVariableRowHeightsEnabled (variableHeights);
+
+            const auto measurement = String (numRows / 1000000) + "M rows, " + (variableHeights ? "variable" : "uniform") + " heights";
+            const auto reportMilliseconds = [&] (const String& variant, auto&& function)
+            {
+                runner.report (measurement, variant, runner.timeCall (function) * 1.0e3, "ms");
+            };
+
+            // rebuilds the index of row positions when the heights vary
+            reportMilliseconds ("updateContent", [&] { table.updateContent(); });
+
+            auto& viewport = *table.getViewport();
+            const auto maxY = viewport.getViewedComponent()->getHeight() - viewport.getViewHeight();
+            int y = 0;
+            const auto scrollStep = [&]
+            {
+                y = y + 7 < maxY ? y + 7 : 0;
+                viewport.setViewPosition (0, y);
+            };
+
+            reportMilliseconds ("scroll 7 px", scrollStep);
+
+            model.numCellRefreshes = 0;
+
+            for (int i = 0; i < 1000; ++i)
+                scrollStep();
+
+            runner.report (measurement, "cells refreshed", model.numCellRefreshes / 1000.0, "per scroll");
+
+            Random random (1);
+            reportMilliseconds ("jump to a row", [&] { viewport.setViewPosition (0, random.nextInt (maxY)); });
+
+            reportMilliseconds ("scroll 7 px and paint", [&]
+            {
+                scrollStep();
+                Graphics g (image);
+                table.paintEntireComponent (g, false);
+            });
+
+            int row = 0;
+            reportMilliseconds ("select a row", [&] { table.selectRow (table.getRowContainingPosition (10, 300) + (row++ % 2)); });
+        }
+    }
+
+private:
+    static constexpr int numRows = 10000000, numColumns = 8;
+
+    Image image { Image::ARGB, 800, 600, true };
+
+    struct Model final : public TableListBoxModel
+    {
+        int getNumRows() override                       { return numRows; }
+        int getHeightForRow (int row) override          { return 16 + (row * 7919) % 25; }
+
+        void paintRowBackground (Graphics& g, int, int, int, bool selected) override
+        {
+            if (selected)
+                g.fillAll (Colours::lightblue);
+        }
+
+        void paintCell (Graphics&, int, int, int, int, bool) override {}
+
+        Component* refreshComponentForCell (int row, int column, bool, Component* existing) override
+        {
+            ++numCellRefreshes;
+
+            auto* label = existing != nullptr ? static_cast<Label*> (existing) : new Label();
+            label->setText (String (row) + ":" + String (column), dontSendNotification);
+            return label;
+        }
+
+        int64 numCellRefreshes = 0;
+    };
+};
+
+static ListBoxBenchmark listBoxBenchmark;
@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+
+//==============================================================================
+Benchmark::Benchmark (const String& benchmarkName, const String& benchmarkCategory)
+    : name (benchmarkName), category (benchmarkCategory)
+{
+    getAllBenchmarks().add (this);
+}
+
+Benchmark::~Benchmark()
+{
+    getAllBenchmarks().removeFirstMatchingValue (this);
+}
+
+Array<Benchmark*>& Benchmark::getAllBenchmarks()
+{
+    static Array<Benchmark*> benchmarks;
+    return benchmarks;
+}
+
+//==============================================================================
+int main (int argc, char** argv)
+{
+    ArgumentList args (argc, argv);
+
+    if (args.containsOption ("--help|-h"))
+    {
+        std::cout << argv[0] << " [--help|-h] [--list] [--category=category] [--name=name] [--seconds=seconds]" << std::endl
+                  << std::endl
+                  << "Runs the benchmarks with the given category or name, or all of them if neither is given." << std::endl
+                  << "Each measurement takes roughly the given number of seconds, which defaults to 0.2." << std::endl
+                  << "Build with optimisations turned on, or the results won't mean much." << std::endl;
+        return 0;
+    }
+
+    auto benchmarks = Benchmark::getAllBenchmarks();
+
+    std::stable_sort (benchmarks.begin(), benchmarks.end(), [] (const Benchmark* a, const Benchmark* b)
+    {
+        return a->category.compareNatural (b->category) < 0;
+    });
+
+    if (args.containsOption ("--list"))
+    {
+        for (auto* benchmark : benchmarks)
+            std::cout << benchmark->category << " / " << benchmark->name << std::endl;
+
+        return 0;
+    }
+
+    const auto category = args.getValueForOption ("--category");
+    const auto name = args.getValueForOption ("--name");
+    const auto seconds = args.containsOption ("--seconds") ? args.getValueForOption ("--seconds").getDoubleValue() : 0.2;
+
+    ScopedJuceInitialiser_GUI libraryInitialiser;
+    BenchmarkRunner runner (seconds);
+
+   #if JUCE_DEBUG
+    std::cout << "Warning: this is a debug build, so the timings won't be representative." << std::endl;
+   #endif
+
+    for (auto* benchmark : benchmarks)
+    {
+        if ((category.isNotEmpty() && ! benchmark->category.equalsIgnoreCase (category))
+             || (name.isNotEmpty() && ! benchmark->name.equalsIgnoreCase (name)))
+            continue;
+
+        std::cout << std::endl << benchmark->category << " / " << benchmark->name << std::endl;
+        benchmark->run (runner);
+    }
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+
+//==============================================================================
+/**
+    Measures how many messages per second the message loop can take from several
+    threads posting at once, what each post costs the thread making it, and how long
+    a single message takes to arrive when the queue is otherwise idle.
+*/
+class MessagingBenchmark final : public Benchmark
+{
+public:
+    MessagingBenchmark()  : Benchmark ("Message posting", "Events") {}
+
+    void run (BenchmarkRunner& runner) override
+    {
+        for (auto numProducers : { 1, 4, 16 })
+            runBurst (runner, numProducers);
+
+        runRoundTrips (runner);
+    }
+
+private:
+    static constexpr int messagesPerBurst = 200000, numRoundTrips = 2000;
+
+    struct CountingMessage final : public MessageManager::MessageBase
+    {
+        explicit CountingMessage (std::atomic<int>& counter)  : received (counter) {}
+        void messageCallback() override     { ++received; }
+
+        std::atomic<int>& received;
+    };
+
+    // All the producers start together and post their share of the messages as fast as they can
+    static void runBurst (BenchmarkRunner& runner, int numProducers)
+    {
+        std::atomic<int> received { 0 };
+        std::atomic<int64> postingTicks { 0 };
+        const auto messagesPerProducer = messagesPerBurst / numProducers;
+        const auto total = messagesPerProducer * numProducers;
+
+        std::vector<MessageManager::MessageBase::Ptr> messages;
+
+        for (int i = 0; i < total; ++i)
+            messages.push_back (new CountingMessage (received));
+
+        WaitableEvent go (true);
+        std::vector<std::unique_ptr<std::thread>> producers;
+
+        for (int p = 0; p < numProducers; ++p)
+        {
+            producers.push_back (std::make_unique<std::thread> ([&, p]
+            {
+                go.wait();
+                const auto start = Time::getHighResolutionTicks();
+
+                for (int i = 0; i < messagesPerProducer; ++i)
+                    messages[(size_t) (p * messagesPerProducer + i)]->post();
+
+                postingTicks += Time::getHighResolutionTicks() - start;
+            }));
+        }
+
+        const auto start = Time::getMillisecondCounterHiRes();
+        go.signal();
+
+        while (received < total)
+            dispatchNextMessage();
+
+        const auto elapsedSeconds = (Time::getMillisecondCounterHiRes() - start) * 0.001;
+
+        for (auto& producer : producers)
+            producer->join();
+
+        const auto measurement = String (numProducers) + (numProducers == 1 ? " producer" : " producers") + ", burst";
+        runner.report (measurement, "throughput", total / elapsedSeconds * 1.0e-6, "M msg/s");
+        runner.report (measurement, "post", Time::highResolutionTicksToSeconds (postingTicks) * 1.0e9 / total, "ns per post");
+    }
+
+    // One message at a time, each posted from another thread once the last has arrived
+    static void runRoundTrips (BenchmarkRunner& runner)
+    {
+        struct SignallingMessage final : public MessageManager::MessageBase
+        {
+            void messageCallback() override     { arrived = Time::getHighResolutionTicks(); delivered.signal(); }
+
+            int64 arrived = 0;
+            WaitableEvent delivered;
+        };
+
+        std::vector<double> latencies;
+        std::atomic<bool> finished { false };
+
+        std::thread producer ([&]
+        {
+            for (int i = 0; i < numRoundTrips; ++i)
+            {
+                MessageManager::MessageBase::Ptr message = new SignallingMessage();
+                auto& signalling = static_cast<SignallingMessage&> (*message);
+                const auto posted = Time::getHighResolutionTicks();
+                message->post();
+                signalling.delivered.wait();
+                latencies.push_back (Time::highResolutionTicksToSeconds (signalling.arrived - posted) * 1.0e6);
+                Thread::sleep (1);
+            }
+
+            finished = true;
+            MessageManager::callAsync ([] {});
+        });
+
+        while (! finished)
+            dispatchNextMessage();
+
+        producer.join();
+        std::sort (latencies.begin(), latencies.end());
+
+        const String measurement ("1 producer, one message at a time");
+        runner.report (measurement, "median latency", latencies[latencies.size() / 2], "us");
+        runner.report (measurement, "99th percentile", latencies[latencies.size() * 99 / 100], "us");
+    }
+};
+
+static MessagingBenchmark messagingBenchmark;
@@ -0,0 +1,217 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+
+//==============================================================================
+/**
+    Measures how quickly and how accurately curves are flattened into lines, and
+    what it costs to stroke a curve like an EQ display's on every repaint.
+*/
+class PathStrokingBenchmark final : public Benchmark
+{
+public:
+    PathStrokingBenchmark()  : Benchmark ("Path flattening and stroking", "Graphics") {}
+
+    void run (BenchmarkRunner& runner) override
+    {
+        measureFlattening (runner);
+        measureStroking (runner);
+    }
+
+private:
+    static constexpr int numCubics = 2000;
+
+    struct Cubic
+    {
+        Point<float> start, control1, control2, end;
+
+        Point<float> getPoint (float t) const noexcept
+        {
+            const auto u = 1.0f - t;
+            return start * (u * u * u) + control1 * (3.0f * u * u * t) + control2 * (3.0f * u * t * t) + end * (t * t * t);
+        }
+    };
+
+    static void measureFlattening (BenchmarkRunner& runner)
+    {
+        const auto cubics = createRandomCubics();
+
+        Path path;
+
+        for (auto& c : cubics)
+        {
+            path.startNewSubPath (c.start);
+            path.cubicTo (c.control1, c.control2, c.end);
+        }
+
+        const auto measurement = String (numCubics) + " cubics, 8-1000px";
+        std::vector<std::vector<Point<float>>> polylines ((size_t) numCubics);
+
+        {
+            PathFlatteningIterator iter (path);
+            int curve = -1;
+
+            while (iter.next())
+            {
+                if (iter.subPathIndex == 0)
+                    polylines[(size_t) ++curve].push_back ({ iter.x1, iter.y1 });
+
+                polylines[(size_t) curve].push_back ({ iter.x2, iter.y2 });
+            }
+        }
+
+        size_t numSegments = 0;
+
+        for (auto& line : polylines)
+            numSegments += line.size() - 1;
+
+        const auto seconds = runner.timeCall ([&]
+        {
+            PathFlatteningIterator iter (path);
+            float sum = 0;
+
+            while (iter.next())
+                sum += iter.x2 + iter.y2;
+
+            keepResult (sum);
+        });
+
+        runner.report (measurement, "flattening", seconds * 1.0e3, "ms");
+        runner.report (measurement, "segments", (double) numSegments, "lines");
+
+        // The error is sampled at many points along each curve, measuring the distance to the
+        // nearest of the lines it was flattened into.
+        float worstError = 0;
+
+        for (size_t i = 0; i < cubics.size(); ++i)
+        {
+            const auto& line = polylines[i];
+            Point<float> unused;
+
+            for (int step = 0; step <= 256; ++step)
+            {
+                const auto point = cubics[i].getPoint ((float) step / 256.0f);
+                auto nearest = std::numeric_limits<float>::max();
+
+                for (size_t j = 1; j < line.size(); ++j)
+                    nearest = jmin (nearest, Line<float> (line[j - 1], line[j]).getDistanceFromPoint (point, unused));
+
+                worstError = jmax (worstError, nearest);
+            }
+        }
+
+        runner.report (measurement, "worst error", worstError, "px");
+        runner.report (measurement, "tolerance", Path::defaultToleranceForMeasurement, "px");
+    }
+
+    static void measureStroking (BenchmarkRunner& runner)
+    {
+        constexpr int width = 800, height = 300;
+
+        const auto curve = createResponseCurve ((float) width, (float) height);
+        const PathStrokeType stroke (2.0f);
+        const auto measurement = String ("200-segment curve, ") + String (width) + "x" + String (height);
+
+        Image image (Image::ARGB, width, height, true);
+
+        const auto reportMicroseconds = [&] (const String& variant, auto&& function)
+        {
+            runner.report (measurement, variant, runner.timeCall (function) * 1.0e6, "us");
+        };
+
+        reportMicroseconds ("createStrokedPath", [&]
+        {
+            Path outline;
+            stroke.createStrokedPath (outline, curve);
+            keepResult (outline.getBounds());
+        });
+
+        reportMicroseconds ("getCachedStroke", [&]
+        {
+            keepResult (curve.getCachedStroke (stroke)->getBounds());
+        });
+
+        reportMicroseconds ("paint, uncached", [&]
+        {
+            // This is what strokePath() costs for a path that's rebuilt before every repaint
+            Path outline;
+            stroke.createStrokedPath (outline, curve);
+
+            Graphics g (image);
+            g.setColour (Colours::orange);
+            g.fillPath (outline);
+        });
+
+        reportMicroseconds ("paint, cached", [&]
+        {
+            Graphics g (image);
+            g.setColour (Colours::orange);
+            g.strokePath (curve, stroke);
+        });
+    }
+
+    static std::vector<Cubic> createRandomCubics()
+    {
+        Random random (1);
+        std::vector<Cubic> cubics;
+
+        for (int i = 0; i < numCubics; ++i)
+        {
+            const auto size = 8.0f + random.nextFloat() * 992.0f;
+            const auto randomPoint = [&] { return Point<float> (random.nextFloat(), random.nextFloat()) * size; };
+
+            cubics.push_back ({ randomPoint(), randomPoint(), randomPoint(), randomPoint() });
+        }
+
+        return cubics;
+    }
+
+    // Something like a parametric EQ's response, drawn as a chain of quadratic curves
+    static Path createResponseCurve (float width, float height)
+    {
+        const auto getY = [&] (float x)
+        {
+            const auto bump = [] (float pos, float centre, float widthOfBump) { return std::exp (-square ((pos - centre) / widthOfBump)); };
+            return height * (0.5f - 0.3f * bump (x, 0.2f, 0.05f) + 0.25f * bump (x, 0.6f, 0.1f) - 0.1f * bump (x, 0.85f, 0.02f));
+        };
+
+        Path p;
+        p.startNewSubPath (0.0f, getY (0.0f));
+
+        constexpr int numSegments = 200;
+
+        for (int i = 1; i <= numSegments; ++i)
+        {
+            const auto x0 = ((float) i - 0.5f) / (float) numSegments;
+            const auto x1 = (float) i / (float) numSegments;
+            p.quadraticTo (x0 * width, getY (x0), x1 * width, getY (x1));
+        }
+
+        return p;
+    }
+};
+
+static PathStrokingBenchmark pathStrokingBenchmark;
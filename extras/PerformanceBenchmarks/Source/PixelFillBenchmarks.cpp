@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+
+//==============================================================================
+/**
+    Measures how fast the software renderer's fills write pixels, with the
+    SpanBlitters set to each of the instruction sets the machine supports.
+*/
+class PixelFillBenchmark final : public Benchmark
+{
+public:
+    PixelFillBenchmark()  : Benchmark ("Pixel fills", "Graphics") {}
+
+    void run (BenchmarkRunner& runner) override
+    {
+        using namespace RenderingHelpers::SpanBlitters;
+
+        const auto sprite = createSprite (Image::ARGB);
+        const auto opaqueSprite = createSprite (Image::RGB);
+
+        for (auto format : { Image::ARGB, Image::RGB })
+        {
+            Image target (format, width, height, true);
+            const auto formatName = format == Image::ARGB ? String ("ARGB") : String ("RGB");
+
+            const auto measure = [&] (const String& fillName, const std::function<void (Graphics&)>& fill)
+            {
+                const auto measurement = fillName + ", " + formatName;
+                const auto previousSet = getInstructionSet();
+
+                for (auto set : getAvailableInstructionSets())
+                {
+                    setInstructionSet (set);
+                    const auto seconds = runner.timeCall ([&] { Graphics g (target); fill (g); });
+                    runner.report (measurement, getName (set), width * height / seconds * 1.0e-6, "Mpixels/s");
+                }
+
+                setInstructionSet (previousSet);
+            };
+
+            measure ("translucent colour", [] (Graphics& g)
+            {
+                g.setColour (Colours::orange.withAlpha (0.6f));
+                g.fillAll();
+            });
+
+            measure ("linear gradient", [] (Graphics& g)
+            {
+                g.setGradientFill (ColourGradient (Colours::red.withAlpha (0.8f), 0.0f, 0.0f,
+                                                   Colours::blue.withAlpha (0.4f), (float) width, (float) height, false));
+                g.fillAll();
+            });
+
+            measure ("ARGB image", [&] (Graphics& g)
+            {
+                g.setTiledImageFill (sprite, 0, 0, 1.0f);
+                g.fillAll();
+            });
+
+            measure ("RGB image, 50% opacity", [&] (Graphics& g)
+            {
+                g.setTiledImageFill (opaqueSprite, 0, 0, 0.5f);
+                g.fillAll();
+            });
+
+            measure ("ARGB image, bilinear x4", [&] (Graphics& g)
+            {
+                g.setImageResamplingQuality (Graphics::mediumResamplingQuality);
+                g.drawImageTransformed (sprite, AffineTransform::scale ((float) width  / (float) sprite.getWidth(),
+                                                                        (float) height / (float) sprite.getHeight()));
+            });
+        }
+    }
+
+private:
+    static constexpr int width = 1920, height = 1080;
+
+    static String getName (RenderingHelpers::SpanBlitters::InstructionSet set)
+    {
+        using InstructionSet = RenderingHelpers::SpanBlitters::InstructionSet;
+
+        switch (set)
+        {
+            case InstructionSet::scalar:    return "scalar";
+            case InstructionSet::sse2:      return "SSE2";
+            case InstructionSet::avx2:      return "AVX2";
+            case InstructionSet::neon:      return "NEON";
+        }
+
+        return {};
+    }
+
+    // A quarter of the size of the target, so that the bilinear fill scales it up by 4
+    static Image createSprite (Image::PixelFormat format)
+    {
+        Image image (format, width / 4, height / 4, true);
+        Graphics g (image);
+
+        g.setGradientFill (ColourGradient (Colours::yellow, 0.0f, 0.0f, Colours::darkblue.withAlpha (0.5f),
+                                           (float) image.getWidth(), (float) image.getHeight(), true));
+        g.fillAll();
+
+        return image;
+    }
+};
+
+static PixelFillBenchmark pixelFillBenchmark;
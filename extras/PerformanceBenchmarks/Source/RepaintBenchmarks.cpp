@@ -0,0 +1,138 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+#include "Benchmark.h"
+
+//==============================================================================
+/**
+    Times the shortcuts that keep repainting cheap: repaint() calls on a component
+    that's already waiting to be painted, painting siblings that are hidden behind
+    an opaque component, and merging a scattered repaint region into a few rectangles.
+*/
+class RepaintBenchmark final : public Benchmark
+{
+public:
+    RepaintBenchmark()  : Benchmark ("Repaint coalescing and culling", "GUI") {}
+
+    void run (BenchmarkRunner& runner) override
+    {
+        runRepeatedRepaints (runner);
+        runOccludedPainting (runner);
+        runRegionCoalescing (runner);
+    }
+
+private:
+    struct Box final : public Component
+    {
+        explicit Box (Colour c)  : colour (c)      { setOpaque (c.isOpaque()); }
+
+        void paint (Graphics& g) override
+        {
+            g.setColour (colour);
+            g.fillEllipse (getLocalBounds().toFloat());
+        }
+
+        Colour colour;
+    };
+
+    static void runRepeatedRepaints (BenchmarkRunner& runner)
+    {
+        constexpr int depth = 8;
+        OwnedArray<Component> chain;
+
+        for (int i = 0; i < depth; ++i)
+        {
+            auto* c = chain.add (new Component());
+            c->setBounds (1, 1, 500 - i * 2, 500 - i * 2);
+
+            if (i > 0)
+                chain[i - 1]->addAndMakeVisible (c);
+        }
+
+        auto& leaf = *chain.getLast();
+        const auto measurement = "repaint() on a component " + String (depth) + " levels deep";
+
+        // A part of the component has to be passed up through all the parents every time, but
+        // once the whole of it is pending, any more calls return straight away
+        runner.report (measurement, "part of it",             runner.timeCall ([&] { leaf.repaint (0, 0, 10, 10); }) * 1.0e9, "ns");
+        runner.report (measurement, "whole, already pending", runner.timeCall ([&] { leaf.repaint(); }) * 1.0e9, "ns");
+    }
+
+    static void runOccludedPainting (BenchmarkRunner& runner)
+    {
+        Component parent;
+        parent.setBounds (0, 0, 400, 400);
+        OwnedArray<Box> children;
+        Random random (1);
+
+        for (int i = 0; i < 200; ++i)
+        {
+            auto* child = children.add (new Box (Colour ((uint32) random.nextInt()).withAlpha (0.5f)));
+            child->setBounds (random.nextInt (300), random.nextInt (300), 100, 100);
+            parent.addAndMakeVisible (child);
+        }
+
+        Box cover (Colours::black);
+        cover.setBounds (parent.getLocalBounds());
+        parent.addChildComponent (cover);
+
+        Image image (Image::ARGB, parent.getWidth(), parent.getHeight(), true);
+        const auto paint = [&] { Graphics g (image); parent.paintEntireComponent (g, false); };
+        const auto measurement = String (children.size()) + " translucent children";
+
+        runner.report (measurement, "all visible", runner.timeCall (paint) * 1.0e3, "ms");
+
+        cover.setVisible (true);
+        runner.report (measurement, "behind opaque sibling", runner.timeCall (paint) * 1.0e3, "ms");
+    }
+
+    static void runRegionCoalescing (BenchmarkRunner& runner)
+    {
+        RectangleList<int> scattered;
+        Random random (1);
+
+        for (int i = 0; i < 400; ++i)
+            scattered.add ({ random.nextInt (1900), random.nextInt (1000), 4 + random.nextInt (20), 4 + random.nextInt (20) });
+
+        const auto measurement = String (scattered.getNumRectangles()) + " scattered rectangles";
+
+        runner.report (measurement, "consolidate()", runner.timeCall ([&]
+        {
+            auto region = scattered;
+            region.consolidate();
+            keepResult (region.getNumRectangles());
+        }) * 1.0e3, "ms");
+
+        runner.report (measurement, "coalesce() to 16", runner.timeCall ([&]
+        {
+            auto region = scattered;
+            region.coalesce (16, 64 * 64);
+            keepResult (region.getNumRectangles());
+        }) * 1.0e3, "ms");
+    }
+};
+
+static RepaintBenchmark repaintBenchmark;
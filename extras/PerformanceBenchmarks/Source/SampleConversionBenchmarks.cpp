@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+
+//==============================================================================
+/**
+    Times the conversions between interleaved integer or float file data and planar
+    native data that audio file readers and writers do, using AudioData's
+    interleaveSamples() and deinterleaveSamples(), and compares them with converting
+    one sample at a time through the Pointer's getAsFloat() and setAsFloat() methods.
+*/
+class SampleConversionBenchmark final : public Benchmark
+{
+public:
+    SampleConversionBenchmark()  : Benchmark ("AudioData sample conversion", "Audio") {}
+
+    void run (BenchmarkRunner& runner) override
+    {
+        measureDeinterleaving<AudioData::Int16,   AudioData::Float32> (runner, "int16 -> float");
+        measureDeinterleaving<AudioData::Int24,   AudioData::Float32> (runner, "int24 -> float");
+        measureDeinterleaving<AudioData::Int32,   AudioData::Float32> (runner, "int32 -> float");
+        measureDeinterleaving<AudioData::Float32, AudioData::Float32> (runner, "float -> float");
+        measureDeinterleaving<AudioData::Int24,   AudioData::Int32>   (runner, "int24 -> int32");
+
+        measureInterleaving<AudioData::Int16>   (runner, "float -> int16");
+        measureInterleaving<AudioData::Int24>   (runner, "float -> int24");
+        measureInterleaving<AudioData::Int32>   (runner, "float -> int32");
+        measureInterleaving<AudioData::Float32> (runner, "float -> float");
+    }
+
+private:
+    static constexpr int numChannels = 2, numFrames = 48000;
+
+    template <typename SourceFormat, typename DestFormat>
+    void measureDeinterleaving (BenchmarkRunner& runner, const String& conversion)
+    {
+        using SourceType = AudioData::Pointer<SourceFormat, AudioData::LittleEndian, AudioData::Interleaved, AudioData::Const>;
+        using DestType   = AudioData::Pointer<DestFormat, AudioData::NativeEndian, AudioData::NonInterleaved, AudioData::NonConst>;
+        using Source = AudioData::InterleavedSource<AudioData::Format<SourceFormat, AudioData::LittleEndian>>;
+        using Dest   = AudioData::NonInterleavedDest<AudioData::Format<DestFormat, AudioData::NativeEndian>>;
+
+        HeapBlock<char> fileData ((size_t) (numChannels * numFrames * SourceType::getBytesPerSample()));
+        fillWithNoise (AudioData::Pointer<SourceFormat, AudioData::LittleEndian, AudioData::Interleaved, AudioData::NonConst> (fileData, 1),
+                       numChannels * numFrames);
+
+        AudioBuffer<float> planar (numChannels, numFrames);
+        float* const* channels = planar.getArrayOfWritePointers();
+
+        report (runner, conversion + ", interleaved to planar", [&]
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                convertPerSample (DestType (channels[ch]), SourceType (fileData + ch * SourceType::getBytesPerSample(), numChannels));
+        },
+        [&]
+        {
+            AudioData::deinterleaveSamples (Source { reinterpret_cast<typename Source::DataType> (fileData.getData()), numChannels },
+                                            Dest { reinterpret_cast<typename Dest::DataType> (channels), numChannels },
+                                            numFrames);
+        });
+    }
+
+    template <typename DestFormat>
+    void measureInterleaving (BenchmarkRunner& runner, const String& conversion)
+    {
+        using SourceType = AudioData::Pointer<AudioData::Float32, AudioData::NativeEndian, AudioData::NonInterleaved, AudioData::Const>;
+        using DestType   = AudioData::Pointer<DestFormat, AudioData::LittleEndian, AudioData::Interleaved, AudioData::NonConst>;
+        using Source = AudioData::NonInterleavedSource<AudioData::Format<AudioData::Float32, AudioData::NativeEndian>>;
+        using Dest   = AudioData::InterleavedDest<AudioData::Format<DestFormat, AudioData::LittleEndian>>;
+
+        AudioBuffer<float> planar (numChannels, numFrames);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            fillWithNoise (AudioData::Pointer<AudioData::Float32, AudioData::NativeEndian, AudioData::NonInterleaved, AudioData::NonConst> (planar.getWritePointer (ch)),
+                           numFrames);
+
+        HeapBlock<char> fileData ((size_t) (numChannels * numFrames * DestType::getBytesPerSample()));
+        auto* const* channels = planar.getArrayOfReadPointers();
+
+        report (runner, conversion + ", planar to interleaved", [&]
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                convertPerSample (DestType (fileData + ch * DestType::getBytesPerSample(), numChannels), SourceType (channels[ch]));
+        },
+        [&]
+        {
+            AudioData::interleaveSamples (Source { channels, numChannels },
+                                          Dest { reinterpret_cast<typename Dest::DataType> (fileData.getData()), numChannels },
+                                          numFrames);
+        });
+    }
+
+    template <typename PerSampleFunction, typename ConverterFunction>
+    static void report (BenchmarkRunner& runner, const String& measurement,
+                        PerSampleFunction&& perSample, ConverterFunction&& converter)
+    {
+        constexpr auto numSamples = (double) (numChannels * numFrames);
+
+        runner.report (measurement, "per sample",     numSamples / runner.timeCall (perSample) * 1.0e-9, "Gsamples/s");
+        runner.report (measurement, "convertSamples", numSamples / runner.timeCall (converter) * 1.0e-9, "Gsamples/s");
+    }
+
+    // This is how Pointer::convertSamples() works when there's no faster loop for the formats
+    template <typename DestType, typename SourceType>
+    static void convertPerSample (DestType dest, SourceType source)
+    {
+        for (int i = 0; i < numFrames; ++i)
+        {
+            if (DestType::isFloatingPoint())
+                dest.setAsFloat (source.getAsFloat());
+            else
+                dest.setAsInt32 (source.getAsInt32());
+
+            ++dest;
+            ++source;
+        }
+    }
+
+    template <typename PointerType>
+    static void fillWithNoise (PointerType dest, int numSamples)
+    {
+        Random random (1);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            dest.setAsFloat (random.nextFloat() * 1.8f - 0.9f);
+            ++dest;
+        }
+    }
+};
+
+static SampleConversionBenchmark sampleConversionBenchmark;
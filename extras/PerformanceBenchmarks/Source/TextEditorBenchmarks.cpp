@@ -0,0 +1,122 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+
+//==============================================================================
+/**
+    Times the edits and scrolling that a log viewer makes in a multi-line
+    TextEditor, each followed by a repaint, for documents of different sizes.
+*/
+class TextEditorBenchmark final : public Benchmark
+{
+public:
+    TextEditorBenchmark()  : Benchmark ("TextEditor editing latency", "GUI") {}
+
+    void run (BenchmarkRunner& runner) override
+    {
+        for (auto numBytes : { 100 * 1024, 1024 * 1024, 5 * 1024 * 1024 })
+        {
+            const auto document = createLogText (numBytes);
+            const auto alternativeDocument = document + "\n";
+            const auto measurement = File::descriptionOfSizeInBytes (numBytes) + " document";
+
+            TextEditor editor;
+            editor.setMultiLine (true);
+            editor.setSize (width, height);
+
+            const auto reportMilliseconds = [&] (const String& variant, auto&& function)
+            {
+                runner.report (measurement, variant, runner.timeCall (function) * 1.0e3, "ms");
+            };
+
+            // setText() does nothing if the text hasn't changed, so this alternates between two
+            bool useAlternative = false;
+
+            reportMilliseconds ("setText", [&]
+            {
+                editor.setText ((useAlternative = ! useAlternative) ? alternativeDocument : document, false);
+                paint (editor);
+            });
+
+            reportMilliseconds ("append a line", [&]
+            {
+                editor.moveCaretToEnd();
+                editor.insertTextAtCaret ("2026-10-18 12:00:00.000 [INFO] benchmark: appended line\n");
+                paint (editor);
+            });
+
+            reportMilliseconds ("insert in the middle", [&]
+            {
+                editor.setCaretPosition (editor.getTotalNumChars() / 2);
+                editor.insertTextAtCaret ("x");
+                paint (editor);
+            });
+
+            int scrollStep = 0;
+
+            reportMilliseconds ("scroll and paint", [&]
+            {
+                // Jumps between positions spread through the document, like dragging the scrollbar
+                editor.setCaretPosition ((int) ((int64) editor.getTotalNumChars() * (scrollStep++ * 37 % 100) / 100));
+                paint (editor);
+            });
+        }
+    }
+
+private:
+    static constexpr int width = 800, height = 600;
+
+    Image image { Image::ARGB, width, height, true };
+
+    void paint (TextEditor& editor)
+    {
+        Graphics g (image);
+        editor.paintEntireComponent (g, false);
+    }
+
+    static String createLogText (int numBytes)
+    {
+        static const char* const components[] = { "audio", "midi", "network", "ui", "plugin-host" };
+        static const char* const levels[] = { "INFO", "DEBUG", "WARN" };
+
+        Random random (1);
+        MemoryOutputStream text;
+
+        for (int line = 0; (int) text.getDataSize() < numBytes; ++line)
+        {
+            text << "2026-10-18 12:" << String (line / 60 % 60).paddedLeft ('0', 2) << ":" << String (line % 60).paddedLeft ('0', 2)
+                 << "." << String (random.nextInt (1000)).paddedLeft ('0', 3)
+                 << " [" << levels[random.nextInt (numElementsInArray (levels))] << "] "
+                 << components[random.nextInt (numElementsInArray (components))]
+                 << ": processed block " << line << " with " << random.nextInt (4096) << " samples in "
+                 << String (random.nextDouble() * 3.0, 3) << " ms\n";
+        }
+
+        return text.toString();
+    }
+};
+
+static TextEditorBenchmark textEditorBenchmark;
@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+#include "Benchmark.h"
+
+//==============================================================================
+/**
+    Times a frame of small text with the glyph atlas at its default size, and with
+    it shrunk so that every glyph has to be rasterised again each time it's drawn.
+*/
+class TextRenderingBenchmark final : public Benchmark
+{
+public:
+    TextRenderingBenchmark()  : Benchmark ("Glyph atlas", "Graphics") {}
+
+    void run (BenchmarkRunner& runner) override
+    {
+        const auto originalSize = GlyphAtlas::getMaximumSize();
+        Image image (Image::ARGB, width, height, true);
+
+        for (auto gradient : { false, true })
+        {
+            const auto measurement = String (numLines) + " lines of 14px text, " + (gradient ? "gradient" : "solid colour");
+
+            const auto drawFrame = [&]
+            {
+                Graphics g (image);
+                g.fillAll (Colours::white);
+                g.setFont (14.0f);
+
+                if (gradient)
+                    g.setGradientFill (ColourGradient::vertical (Colours::black, 0.0f, Colours::darkblue, (float) height));
+                else
+                    g.setColour (Colours::black);
+
+                for (int i = 0; i < numLines; ++i)
+                {
+                    // Two columns, with the lines offset by fractions of a pixel so that several
+                    // sub-pixel positions of each glyph are used
+                    const Rectangle<float> area ((float) (i % 2) * (float) width * 0.5f + (float) (i % 4) * 0.25f,
+                                                 (float) (i / 2) * 15.0f, (float) width * 0.5f, 15.0f);
+
+                    g.drawText ("Line " + String (i) + ": the quick brown fox", area, Justification::centredLeft, false);
+                }
+            };
+
+            GlyphAtlas::setMaximumSize (originalSize);
+            GlyphAtlas::resetStatistics();
+
+            runner.report (measurement, "atlas", runner.timeCall (drawFrame) * 1.0e3, "ms");
+            runner.report (measurement, "atlas hit rate", GlyphAtlas::getStatistics().getHitRate() * 100.0, "%");
+
+            GlyphAtlas::setMaximumSize (0);
+            runner.report (measurement, "rasterised each time", runner.timeCall (drawFrame) * 1.0e3, "ms");
+        }
+
+        GlyphAtlas::setMaximumSize (originalSize);
+    }
+
+private:
+    static constexpr int width = 800, height = 600, numLines = 80;
+};
+
+static TextRenderingBenchmark textRenderingBenchmark;
@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+#include "Benchmark.h"
+
+//==============================================================================
+/**
+    Times the text in a scrolling table and a TextLayout with the shaped text cache
+    on and off. The table's cells move on every frame, so they can only come from the
+    cache because arrangements are stored at the origin rather than at their position.
+*/
+class TextShapingBenchmark final : public Benchmark
+{
+public:
+    TextShapingBenchmark()  : Benchmark ("Shaped text cache", "Graphics") {}
+
+    void run (BenchmarkRunner& runner) override
+    {
+        const auto originalSize = ShapedTextCache::getMaximumSize();
+        const auto cells = createCellText();
+
+        Image image (Image::ARGB, width, height, true);
+        int scrollPosition = 0;
+
+        const auto drawFrame = [&]
+        {
+            // Scrolls through the table a few pixels at a time, drawing only the visible rows
+            scrollPosition = (scrollPosition + 5) % ((numRows - numVisibleRows) * rowHeight);
+            const auto firstRow = scrollPosition / rowHeight;
+
+            Graphics g (image);
+            g.fillAll (Colours::white);
+            g.setColour (Colours::black);
+            g.setFont (14.0f);
+
+            for (int row = firstRow; row < firstRow + numVisibleRows; ++row)
+                for (int column = 0; column < numColumns; ++column)
+                    g.drawText (cells[(size_t) (row * numColumns + column)],
+                                column * columnWidth, row * rowHeight - scrollPosition, columnWidth, rowHeight,
+                                column == 0 ? Justification::centredLeft : Justification::centredRight, true);
+        };
+
+        AttributedString attributedString;
+        attributedString.append ("Shaped text cache. ", Font (16.0f, Font::bold), Colours::black);
+        attributedString.append (String::repeatedString ("The quick brown fox jumps over the lazy dog. ", 8), Font (14.0f), Colours::darkgrey);
+
+        const auto createLayout = [&]
+        {
+            TextLayout layout;
+            layout.createLayout (attributedString, 300.0f);
+            keepResult (layout.getHeight());
+        };
+
+        const auto tableMeasurement = String (numVisibleRows * numColumns) + " table cells, scrolling";
+        const auto layoutMeasurement = String ("TextLayout, ") + String (attributedString.getText().length()) + " characters";
+
+        for (auto enabled : { true, false })
+        {
+            ShapedTextCache::setMaximumSize (enabled ? originalSize : 0);
+            ShapedTextCache::clear();
+
+            const String variant (enabled ? "cached" : "cache off");
+            runner.report (tableMeasurement, variant, runner.timeCall (drawFrame) * 1.0e3, "ms");
+            runner.report (layoutMeasurement, variant, runner.timeCall (createLayout) * 1.0e6, "us");
+        }
+
+        ShapedTextCache::setMaximumSize (originalSize);
+    }
+
+private:
+    static constexpr int width = 800, height = 480, numRows = 200, numColumns = 6,
+                         rowHeight = 20, columnWidth = width / numColumns, numVisibleRows = height / rowHeight;
+
+    static std::vector<String> createCellText()
+    {
+        Random random (1);
+        std::vector<String> cells;
+
+        for (int row = 0; row < numRows; ++row)
+        {
+            cells.push_back ("Track " + String (row + 1));
+
+            for (int column = 1; column < numColumns; ++column)
+                cells.push_back (String (random.nextFloat() * 100.0f - 50.0f, 2) + " dB");
+        }
+
+        return cells;
+    }
+};
+
+static TextShapingBenchmark textShapingBenchmark;
@@ -0,0 +1,132 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+
+//==============================================================================
+/**
+    Times starting, restarting and stopping thousands of Timers, and measures how
+    many callbacks the message loop delivers, and how late they are, when they're
+    all running at once.
+*/
+class TimerBenchmark final : public Benchmark
+{
+public:
+    TimerBenchmark()  : Benchmark ("Timer wheel", "Events") {}
+
+    void run (BenchmarkRunner& runner) override
+    {
+        Random random (1);
+        std::vector<std::unique_ptr<TestTimer>> timers;
+
+        for (int i = 0; i < numTimers; ++i)
+            timers.push_back (std::make_unique<TestTimer> (10 + random.nextInt (41)));
+
+        const auto measurement = String (numTimers) + " timers, 10-50 ms";
+
+        const auto reportMicrosecondsPerTimer = [&] (const String& variant, auto&& function)
+        {
+            runner.report (measurement, variant, runner.timeCall (function) * 1.0e6 / numTimers, "us per timer");
+        };
+
+        reportMicrosecondsPerTimer ("start and stop", [&]
+        {
+            for (auto& t : timers)  t->start();
+            for (auto& t : timers)  t->stopTimer();
+        });
+
+        for (auto& t : timers)
+            t->start();
+
+        reportMicrosecondsPerTimer ("restart", [&]
+        {
+            for (auto& t : timers)
+                t->start();
+        });
+
+        // Lets the timers run, and compares the callbacks with the number they asked for
+        const auto seconds = jmax (1.0, runner.getSecondsPerMeasurement() * 5.0);
+        double expectedCallbacks = 0.0;
+
+        for (auto& t : timers)
+        {
+            t->start();
+            t->resetCounts();
+            expectedCallbacks += seconds * 1000.0 / t->getTimerInterval();
+        }
+
+        const auto startTime = Time::getMillisecondCounterHiRes();
+        MessageManager::getInstance()->runDispatchLoopUntil ((int) (seconds * 1000.0));
+        const auto elapsedSeconds = (Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+
+        int64 numCallbacks = 0;
+        double totalLateness = 0.0;
+
+        for (auto& t : timers)
+        {
+            t->stopTimer();
+            numCallbacks += t->numCallbacks;
+            totalLateness += t->totalLateness;
+        }
+
+        runner.report (measurement, "callbacks", (double) numCallbacks / elapsedSeconds, "per second");
+        runner.report (measurement, "delivered", 100.0 * (double) numCallbacks * seconds / (elapsedSeconds * expectedCallbacks), "% of intervals");
+        runner.report (measurement, "mean lateness", totalLateness / (double) jmax ((int64) 1, numCallbacks), "ms");
+    }
+
+private:
+    static constexpr int numTimers = 10000;
+
+    struct TestTimer final : public Timer
+    {
+        explicit TestTimer (int intervalToUse)  : interval (intervalToUse) {}
+
+        void start()
+        {
+            startTimer (interval);
+            lastTime = Time::getMillisecondCounterHiRes();
+        }
+
+        void resetCounts()
+        {
+            numCallbacks = 0;
+            totalLateness = 0.0;
+        }
+
+        void timerCallback() override
+        {
+            const auto now = Time::getMillisecondCounterHiRes();
+            totalLateness += jmax (0.0, now - lastTime - interval);
+            lastTime = now;
+            ++numCallbacks;
+        }
+
+        const int interval;
+        double lastTime = 0.0, totalLateness = 0.0;
+        int64 numCallbacks = 0;
+    };
+};
+
+static TimerBenchmark timerBenchmark;
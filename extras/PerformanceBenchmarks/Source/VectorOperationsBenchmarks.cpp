@@ -0,0 +1,139 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+
+//==============================================================================
+/**
+    Compares the throughput of the FloatVectorOperations functions that have AVX2 and
+    AVX-512 versions with each instruction set that the CPU supports, and with plain
+    loops as the compiler builds them.
+*/
+class VectorOperationsBenchmark final : public Benchmark
+{
+public:
+    VectorOperationsBenchmark()  : Benchmark ("FloatVectorOperations", "Audio") {}
+
+    void run (BenchmarkRunner& runner) override
+    {
+        using InstructionSet = FloatVectorOperations::InstructionSet;
+
+        const ScopedNoDenormals noDenormals;
+        const auto supported = FloatVectorOperations::getInstructionSet();
+
+        for (auto numValues : { 256, 4096, 65536 })
+        {
+            HeapBlock<float> source ((size_t) numValues), dest ((size_t) numValues);
+            Random random (1);
+
+            for (int i = 0; i < numValues; ++i)
+            {
+                source[i] = random.nextFloat() * 2.0f - 1.0f;
+                dest[i]   = random.nextFloat() * 2.0f - 1.0f;
+            }
+
+            for (auto& op : getOperations())
+            {
+                const auto measurement = String (op.name) + ", " + String (numValues) + " floats";
+                const auto flops = op.flopsPerValue * numValues;
+
+                auto reportTime = [&] (const String& variant, auto&& function)
+                {
+                    runner.report (measurement, variant, flops / runner.timeCall (function) * 1.0e-9, "GFLOP/s");
+                };
+
+                reportTime ("loop", [&] { op.loop (dest, source, numValues); });
+
+                for (auto set : { InstructionSet::baseline, InstructionSet::avx2, InstructionSet::avx512 })
+                {
+                    if (set > supported)
+                        break;
+
+                    const FloatVectorOperations::ScopedInstructionSetLimit limit (set);
+                    reportTime (getName (set), [&] { op.vectorised (dest, source, numValues); });
+                }
+            }
+        }
+    }
+
+private:
+    struct Operation
+    {
+        const char* name;
+        int flopsPerValue;
+        std::function<void (float*, const float*, int)> vectorised, loop;
+    };
+
+    static const std::vector<Operation>& getOperations()
+    {
+        static const std::vector<Operation> operations
+        {
+            { "add", 1,
+              [] (float* d, const float* s, int n) { FloatVectorOperations::add (d, s, n); },
+              [] (float* d, const float* s, int n) { for (int i = 0; i < n; ++i) d[i] += s[i]; } },
+
+            { "multiply", 1,
+              [] (float* d, const float* s, int n) { FloatVectorOperations::multiply (d, s, n); },
+              [] (float* d, const float* s, int n) { for (int i = 0; i < n; ++i) d[i] *= s[i]; } },
+
+            { "copyWithMultiply", 1,
+              [] (float* d, const float* s, int n) { FloatVectorOperations::copyWithMultiply (d, s, 0.5f, n); },
+              [] (float* d, const float* s, int n) { for (int i = 0; i < n; ++i) d[i] = s[i] * 0.5f; } },
+
+            { "addWithMultiply", 2,
+              [] (float* d, const float* s, int n) { FloatVectorOperations::addWithMultiply (d, s, 0.5f, n); },
+              [] (float* d, const float* s, int n) { for (int i = 0; i < n; ++i) d[i] += s[i] * 0.5f; } },
+
+            // (one comparison each for the minimum and maximum)
+            { "findMinAndMax", 2,
+              [] (float*, const float* s, int n) { keepResult (FloatVectorOperations::findMinAndMax (s, n)); },
+              [] (float*, const float* s, int n)
+              {
+                  auto result = Range<float>::emptyRange (s[0]);
+
+                  for (int i = 1; i < n; ++i)
+                      result = result.getUnionWith (s[i]);
+
+                  keepResult (result);
+              } }
+        };
+
+        return operations;
+    }
+
+    static String getName (FloatVectorOperations::InstructionSet set)
+    {
+        switch (set)
+        {
+            case FloatVectorOperations::InstructionSet::baseline:   return "baseline";
+            case FloatVectorOperations::InstructionSet::avx2:       return "AVX2";
+            case FloatVectorOperations::InstructionSet::avx512:     return "AVX-512";
+        }
+
+        return {};
+    }
+};
+
+static VectorOperationsBenchmark vectorOperationsBenchmark;
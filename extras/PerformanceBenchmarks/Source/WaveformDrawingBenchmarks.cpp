@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+#include "Benchmark.h"
+
+//==============================================================================
+/**
+    Compares drawing a waveform with drawPolyline() and fillWaveformColumns() against
+    building the same shapes as a Path or a RectangleList, as a waveform display that
+    changes on every repaint would have to.
+*/
+class WaveformDrawingBenchmark final : public Benchmark
+{
+public:
+    WaveformDrawingBenchmark()  : Benchmark ("Waveform drawing", "Graphics") {}
+
+    void run (BenchmarkRunner& runner) override
+    {
+        Image image (Image::ARGB, width, height, true);
+
+        for (auto numPoints : { 1000, 10000 })
+            measureLine (runner, image, numPoints);
+
+        measureColumns (runner, image, width);
+    }
+
+private:
+    static constexpr int width = 1000, height = 300;
+
+    static void measureLine (BenchmarkRunner& runner, Image& image, int numPoints)
+    {
+        const auto values = createSamples (numPoints);
+        const auto spacing = (float) width / (float) numPoints;
+        const auto measurement = String (numPoints) + "-point line, " + String (width) + "x" + String (height);
+
+        const auto reportMilliseconds = [&] (const String& variant, auto&& function)
+        {
+            runner.report (measurement, variant, runner.timeCall (function) * 1.0e3, "ms");
+        };
+
+        reportMilliseconds ("Path + strokePath", [&]
+        {
+            Path path;
+            path.preallocateSpace (numPoints * 3);
+            path.startNewSubPath (0.0f, values.front());
+
+            for (int i = 1; i < numPoints; ++i)
+                path.lineTo ((float) i * spacing, values[(size_t) i]);
+
+            Graphics g (image);
+            g.setColour (Colours::green);
+            g.strokePath (path, PathStrokeType (1.0f, PathStrokeType::beveled, PathStrokeType::butt));
+        });
+
+        reportMilliseconds ("drawPolyline", [&]
+        {
+            Graphics g (image);
+            g.setColour (Colours::green);
+            g.drawPolyline (0.0f, spacing, values.data(), numPoints);
+        });
+    }
+
+    static void measureColumns (BenchmarkRunner& runner, Image& image, int numColumns)
+    {
+        const auto levels = createSamples (numColumns);
+        std::vector<float> tops, bottoms;
+
+        for (auto level : levels)
+        {
+            const auto halfHeight = std::abs (level - (float) height * 0.5f);
+            tops.push_back ((float) height * 0.5f - halfHeight);
+            bottoms.push_back ((float) height * 0.5f + halfHeight);
+        }
+
+        const auto columnWidth = (float) width / (float) numColumns;
+        const auto measurement = String (numColumns) + " columns, " + String (width) + "x" + String (height);
+
+        const auto reportMilliseconds = [&] (const String& variant, auto&& function)
+        {
+            runner.report (measurement, variant, runner.timeCall (function) * 1.0e3, "ms");
+        };
+
+        reportMilliseconds ("fillRectList", [&]
+        {
+            RectangleList<float> columns;
+            columns.ensureStorageAllocated (numColumns);
+
+            for (int i = 0; i < numColumns; ++i)
+                columns.addWithoutMerging ({ (float) i * columnWidth, tops[(size_t) i],
+                                             columnWidth, bottoms[(size_t) i] - tops[(size_t) i] });
+
+            Graphics g (image);
+            g.setColour (Colours::green);
+            g.fillRectList (columns);
+        });
+
+        reportMilliseconds ("fillWaveformColumns", [&]
+        {
+            Graphics g (image);
+            g.setColour (Colours::green);
+            g.fillWaveformColumns (0.0f, columnWidth, tops.data(), bottoms.data(), numColumns);
+        });
+    }
+
+    // Noise on top of a couple of sine waves, scaled to the height of the image
+    static std::vector<float> createSamples (int numSamples)
+    {
+        Random random (1);
+        std::vector<float> samples;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto t = (float) i / (float) numSamples;
+            const auto value = 0.5f * std::sin (t * 40.0f) + 0.3f * std::sin (t * 170.0f) + 0.2f * (random.nextFloat() * 2.0f - 1.0f);
+            samples.push_back ((float) height * (0.5f + 0.45f * value));
+        }
+
+        return samples;
+    }
+};
+
+static WaveformDrawingBenchmark waveformDrawingBenchmark;
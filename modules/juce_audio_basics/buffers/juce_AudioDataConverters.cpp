@@ -23,6 +23,386 @@
 namespace juce
 {
 
+//==============================================================================
+namespace AudioDataHelpers
+{
+    // Reads an integer sample, shifted up so that it fills the range of an int32
+    template <int bytesPerSample, bool bigEndian>
+    static forcedinline int32 readInt (const char* src) noexcept
+    {
+        if constexpr (bytesPerSample == 2)
+        {
+            const auto v = readUnaligned<uint16> (src);
+            return (int32) ((uint32) (bigEndian ? ByteOrder::swapIfLittleEndian (v) : ByteOrder::swapIfBigEndian (v)) << 16);
+        }
+        else if constexpr (bytesPerSample == 3)
+        {
+            return (int32) ((uint32) (bigEndian ? ByteOrder::bigEndian24Bit (src) : ByteOrder::littleEndian24Bit (src)) << 8);
+        }
+        else
+        {
+            const auto v = readUnaligned<uint32> (src);
+            return (int32) (bigEndian ? ByteOrder::swapIfLittleEndian (v) : ByteOrder::swapIfBigEndian (v));
+        }
+    }
+
+    // Writes an integer sample which has already been scaled to the format's range
+    template <int bytesPerSample, bool bigEndian>
+    static forcedinline void writeInt (char* dest, int32 value) noexcept
+    {
+        if constexpr (bytesPerSample == 2)
+            writeUnaligned (dest, bigEndian ? ByteOrder::swapIfLittleEndian ((uint16) value) : ByteOrder::swapIfBigEndian ((uint16) value));
+        else if constexpr (bytesPerSample == 3)
+            bigEndian ? ByteOrder::bigEndian24BitToChars (value, dest) : ByteOrder::littleEndian24BitToChars (value, dest);
+        else
+            writeUnaligned (dest, bigEndian ? ByteOrder::swapIfLittleEndian ((uint32) value) : ByteOrder::swapIfBigEndian ((uint32) value));
+    }
+
+    template <bool bigEndian>
+    static forcedinline float readFloat (const char* src) noexcept
+    {
+        if constexpr (bigEndian == (bool) AudioData::NativeEndian::isBigEndian)
+            return readUnaligned<float> (src);
+
+        const auto v = ByteOrder::swap (readUnaligned<uint32> (src));
+        float result;
+        memcpy (&result, &v, sizeof (result));
+        return result;
+    }
+
+    template <bool bigEndian>
+    static forcedinline void writeFloat (char* dest, float value) noexcept
+    {
+        if constexpr (bigEndian == (bool) AudioData::NativeEndian::isBigEndian)
+        {
+            writeUnaligned (dest, value);
+        }
+        else
+        {
+            uint32 v;
+            memcpy (&v, &value, sizeof (v));
+            writeUnaligned (dest, ByteOrder::swap (v));
+        }
+    }
+
+    // These must produce exactly the same results as the setAsFloat() methods of the sample formats
+    template <int bytesPerSample>
+    static forcedinline int32 floatToInt (float value) noexcept
+    {
+        if constexpr (bytesPerSample == 4)
+        {
+            return (int32) ((double) 0x7fffffff * jlimit (-1.0, 1.0, (double) value));
+        }
+        else
+        {
+            constexpr auto maxValue = bytesPerSample == 2 ? 0x7fff : 0x7fffff;
+            return jlimit ((int) -maxValue, (int) maxValue, roundToInt (value * (1.0 + (double) maxValue)));
+        }
+    }
+
+    constexpr auto int32ToFloatScale = 1.0f / 2147483648.0f;
+
+   #if JUCE_USE_SSE_INTRINSICS
+    // The caller must make sure there's at least one more sample after these four, as
+    // little-endian 16 and 24-bit values are fetched with a 4-byte read and shifted into place.
+    template <int bytesPerSample, bool bigEndian>
+    static forcedinline __m128i readFourInts (const char* src, int stride) noexcept
+    {
+        if constexpr (bytesPerSample < 4 && ! bigEndian)
+        {
+            if (bytesPerSample == 2 && stride == 2)
+                return _mm_unpacklo_epi16 (_mm_setzero_si128(), _mm_loadl_epi64 (reinterpret_cast<const __m128i*> (src)));
+
+            return _mm_slli_epi32 (_mm_setr_epi32 (readUnaligned<int32> (src),
+                                                   readUnaligned<int32> (src + stride),
+                                                   readUnaligned<int32> (src + 2 * stride),
+                                                   readUnaligned<int32> (src + 3 * stride)), 32 - 8 * bytesPerSample);
+        }
+
+        if constexpr (bytesPerSample == 4 && ! bigEndian)
+            if (stride == 4)
+                return _mm_loadu_si128 (reinterpret_cast<const __m128i*> (src));
+
+        return _mm_setr_epi32 (readInt<bytesPerSample, bigEndian> (src),
+                               readInt<bytesPerSample, bigEndian> (src + stride),
+                               readInt<bytesPerSample, bigEndian> (src + 2 * stride),
+                               readInt<bytesPerSample, bigEndian> (src + 3 * stride));
+    }
+
+    template <int bytesPerSample, bool bigEndian>
+    static forcedinline void writeFourInts (char* dest, int stride, __m128i values) noexcept
+    {
+        if constexpr (bytesPerSample == 2 && ! bigEndian)
+        {
+            if (stride == 2)
+            {
+                _mm_storel_epi64 (reinterpret_cast<__m128i*> (dest), _mm_packs_epi32 (values, values));
+                return;
+            }
+        }
+
+        if constexpr (bytesPerSample == 4 && ! bigEndian)
+        {
+            if (stride == 4)
+            {
+                _mm_storeu_si128 (reinterpret_cast<__m128i*> (dest), values);
+                return;
+            }
+        }
+
+        int32 v[4];
+        _mm_storeu_si128 (reinterpret_cast<__m128i*> (v), values);
+
+        for (int i = 0; i < 4; ++i)
+            writeInt<bytesPerSample, bigEndian> (dest + i * stride, v[i]);
+    }
+
+    template <bool bigEndian>
+    static forcedinline __m128 readFourFloats (const char* src, int stride) noexcept
+    {
+        if constexpr (! bigEndian)
+            if (stride == 4)
+                return _mm_loadu_ps (reinterpret_cast<const float*> (src));
+
+        return _mm_setr_ps (readFloat<bigEndian> (src),
+                            readFloat<bigEndian> (src + stride),
+                            readFloat<bigEndian> (src + 2 * stride),
+                            readFloat<bigEndian> (src + 3 * stride));
+    }
+
+    static forcedinline void writeFourFloats (char* dest, int stride, __m128 values) noexcept
+    {
+        if (stride == 4)
+        {
+            _mm_storeu_ps (reinterpret_cast<float*> (dest), values);
+            return;
+        }
+
+        float v[4];
+        _mm_storeu_ps (v, values);
+
+        for (int i = 0; i < 4; ++i)
+            writeUnaligned (dest + i * stride, v[i]);
+    }
+
+    template <int bytesPerSample>
+    static forcedinline __m128i floatToIntFour (__m128 values) noexcept
+    {
+        if constexpr (bytesPerSample == 4)
+        {
+            // 0x7fffffff can't be represented as a float, so this needs doing at double precision
+            const auto lo = _mm_set1_pd (-1.0), hi = _mm_set1_pd (1.0), scale = _mm_set1_pd ((double) 0x7fffffff);
+            const auto first  = _mm_mul_pd (_mm_min_pd (_mm_max_pd (_mm_cvtps_pd (values), lo), hi), scale);
+            const auto second = _mm_mul_pd (_mm_min_pd (_mm_max_pd (_mm_cvtps_pd (_mm_movehl_ps (values, values)), lo), hi), scale);
+            return _mm_unpacklo_epi64 (_mm_cvttpd_epi32 (first), _mm_cvttpd_epi32 (second));
+        }
+        else
+        {
+            constexpr auto maxValue = (float) (bytesPerSample == 2 ? 0x7fff : 0x7fffff);
+            const auto scaled = _mm_mul_ps (values, _mm_set1_ps (maxValue + 1.0f));
+            return _mm_cvtps_epi32 (_mm_min_ps (_mm_max_ps (scaled, _mm_set1_ps (-maxValue)), _mm_set1_ps (maxValue)));
+        }
+    }
+   #endif
+
+    //==============================================================================
+    template <int bytesPerSample, bool isFloat, bool bigEndian>
+    static void convertToFloat (char* dest, int destStride, const char* src, int srcStride, int numSamples) noexcept
+    {
+        int i = 0;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        const auto scale = _mm_set1_ps (int32ToFloatScale);
+
+        for (; i + 4 < numSamples; i += 4)
+        {
+            if constexpr (isFloat)
+                writeFourFloats (dest, destStride, readFourFloats<bigEndian> (src, srcStride));
+            else
+                writeFourFloats (dest, destStride, _mm_mul_ps (_mm_cvtepi32_ps (readFourInts<bytesPerSample, bigEndian> (src, srcStride)), scale));
+
+            src  += 4 * srcStride;
+            dest += 4 * destStride;
+        }
+       #endif
+
+        for (; i < numSamples; ++i)
+        {
+            if constexpr (isFloat)
+                writeUnaligned (dest, readFloat<bigEndian> (src));
+            else
+                writeUnaligned (dest, (float) readInt<bytesPerSample, bigEndian> (src) * int32ToFloatScale);
+
+            src  += srcStride;
+            dest += destStride;
+        }
+    }
+
+    template <int bytesPerSample, bool isFloat, bool bigEndian>
+    static void convertFromFloat (char* dest, int destStride, const char* src, int srcStride, int numSamples) noexcept
+    {
+        int i = 0;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        if constexpr (! isFloat)
+        {
+            for (; i + 4 <= numSamples; i += 4)
+            {
+                writeFourInts<bytesPerSample, bigEndian> (dest, destStride, floatToIntFour<bytesPerSample> (readFourFloats<false> (src, srcStride)));
+                src  += 4 * srcStride;
+                dest += 4 * destStride;
+            }
+        }
+       #endif
+
+        for (; i < numSamples; ++i)
+        {
+            const auto value = readUnaligned<float> (src);
+
+            if constexpr (isFloat)
+                writeFloat<bigEndian> (dest, value);
+            else
+                writeInt<bytesPerSample, bigEndian> (dest, floatToInt<bytesPerSample> (value));
+
+            src  += srcStride;
+            dest += destStride;
+        }
+    }
+
+    template <int bytesPerSample, bool bigEndian>
+    static void convertToInt32 (char* dest, int destStride, const char* src, int srcStride, int numSamples) noexcept
+    {
+        int i = 0;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        for (; i + 4 < numSamples; i += 4)
+        {
+            writeFourInts<4, false> (dest, destStride, readFourInts<bytesPerSample, bigEndian> (src, srcStride));
+            src  += 4 * srcStride;
+            dest += 4 * destStride;
+        }
+       #endif
+
+        for (; i < numSamples; ++i)
+        {
+            writeUnaligned (dest, readInt<bytesPerSample, bigEndian> (src));
+            src  += srcStride;
+            dest += destStride;
+        }
+    }
+}
+
+void JUCE_CALLTYPE AudioData::convertToNativeFloat (float* dest, int destStride,
+                                                    const void* source, int sourceStride,
+                                                    int sourceBytesPerSample, bool sourceIsFloat, bool sourceIsBigEndian,
+                                                    int numSamples) noexcept
+{
+    using namespace AudioDataHelpers;
+    auto* d = reinterpret_cast<char*> (dest);
+    auto* s = static_cast<const char*> (source);
+
+    if (sourceIsFloat)
+    {
+        if (sourceIsBigEndian)  convertToFloat<4, true, true>  (d, destStride, s, sourceStride, numSamples);
+        else                    convertToFloat<4, true, false> (d, destStride, s, sourceStride, numSamples);
+        return;
+    }
+
+    switch (sourceBytesPerSample)
+    {
+        case 2:
+            if (sourceIsBigEndian)  convertToFloat<2, false, true>  (d, destStride, s, sourceStride, numSamples);
+            else                    convertToFloat<2, false, false> (d, destStride, s, sourceStride, numSamples);
+            break;
+
+        case 3:
+            if (sourceIsBigEndian)  convertToFloat<3, false, true>  (d, destStride, s, sourceStride, numSamples);
+            else                    convertToFloat<3, false, false> (d, destStride, s, sourceStride, numSamples);
+            break;
+
+        case 4:
+            if (sourceIsBigEndian)  convertToFloat<4, false, true>  (d, destStride, s, sourceStride, numSamples);
+            else                    convertToFloat<4, false, false> (d, destStride, s, sourceStride, numSamples);
+            break;
+
+        default:
+            jassertfalse;
+            break;
+    }
+}
+
+void JUCE_CALLTYPE AudioData::convertFromNativeFloat (void* dest, int destStride,
+                                                      int destBytesPerSample, bool destIsFloat, bool destIsBigEndian,
+                                                      const float* source, int sourceStride,
+                                                      int numSamples) noexcept
+{
+    using namespace AudioDataHelpers;
+    auto* d = static_cast<char*> (dest);
+    auto* s = reinterpret_cast<const char*> (source);
+
+    if (destIsFloat)
+    {
+        if (destIsBigEndian)  convertFromFloat<4, true, true>  (d, destStride, s, sourceStride, numSamples);
+        else                  convertFromFloat<4, true, false> (d, destStride, s, sourceStride, numSamples);
+        return;
+    }
+
+    switch (destBytesPerSample)
+    {
+        case 2:
+            if (destIsBigEndian)  convertFromFloat<2, false, true>  (d, destStride, s, sourceStride, numSamples);
+            else                  convertFromFloat<2, false, false> (d, destStride, s, sourceStride, numSamples);
+            break;
+
+        case 3:
+            if (destIsBigEndian)  convertFromFloat<3, false, true>  (d, destStride, s, sourceStride, numSamples);
+            else                  convertFromFloat<3, false, false> (d, destStride, s, sourceStride, numSamples);
+            break;
+
+        case 4:
+            if (destIsBigEndian)  convertFromFloat<4, false, true>  (d, destStride, s, sourceStride, numSamples);
+            else                  convertFromFloat<4, false, false> (d, destStride, s, sourceStride, numSamples);
+            break;
+
+        default:
+            jassertfalse;
+            break;
+    }
+}
+
+void JUCE_CALLTYPE AudioData::convertToNativeInt32 (uint32* dest, int destStride,
+                                                    const void* source, int sourceStride,
+                                                    int sourceBytesPerSample, bool sourceIsBigEndian,
+                                                    int numSamples) noexcept
+{
+    using namespace AudioDataHelpers;
+    auto* d = reinterpret_cast<char*> (dest);
+    auto* s = static_cast<const char*> (source);
+
+    switch (sourceBytesPerSample)
+    {
+        case 2:
+            if (sourceIsBigEndian)  convertToInt32<2, true>  (d, destStride, s, sourceStride, numSamples);
+            else                    convertToInt32<2, false> (d, destStride, s, sourceStride, numSamples);
+            break;
+
+        case 3:
+            if (sourceIsBigEndian)  convertToInt32<3, true>  (d, destStride, s, sourceStride, numSamples);
+            else                    convertToInt32<3, false> (d, destStride, s, sourceStride, numSamples);
+            break;
+
+        case 4:
+            if (sourceIsBigEndian)  convertToInt32<4, true>  (d, destStride, s, sourceStride, numSamples);
+            else                    convertToInt32<4, false> (d, destStride, s, sourceStride, numSamples);
+            break;
+
+        default:
+            jassertfalse;
+            break;
+    }
+}
+
+//==============================================================================
 JUCE_BEGIN_IGNORE_WARNINGS_GCC_LIKE ("-Wdeprecated-declarations")
 JUCE_BEGIN_IGNORE_WARNINGS_MSVC (4996)
 
@@ -565,6 +945,59 @@ public:
         }
     };
 
+    template <class Format, class Endianness>
+    struct FastPathTest
+    {
+        static void test (UnitTest& unitTest, Random& r)
+        {
+            constexpr int numChannels = 3, numSamples = 301, channel = numChannels - 1;
+
+            using FormatPointer      = AudioData::Pointer<Format, Endianness, AudioData::Interleaved, AudioData::NonConst>;
+            using ConstFormatPointer = AudioData::Pointer<Format, Endianness, AudioData::Interleaved, AudioData::Const>;
+            using FloatPointer       = AudioData::Pointer<AudioData::Float32, AudioData::NativeEndian, AudioData::NonInterleaved, AudioData::NonConst>;
+            using ConstFloatPointer  = AudioData::Pointer<AudioData::Float32, AudioData::NativeEndian, AudioData::NonInterleaved, AudioData::Const>;
+            using IntPointer         = AudioData::Pointer<AudioData::Int32, AudioData::NativeEndian, AudioData::NonInterleaved, AudioData::NonConst>;
+
+            const auto numBytes = (size_t) (numChannels * numSamples * FormatPointer::getBytesPerSample());
+            const auto offset = channel * FormatPointer::getBytesPerSample();
+            HeapBlock<char> converted (numBytes, true), expected (numBytes, true);
+            HeapBlock<float> floats (numSamples), floatResult (numSamples), floatExpected (numSamples);
+            HeapBlock<int32> intResult (numSamples), intExpected (numSamples);
+
+            for (int i = 0; i < numSamples; ++i)
+                floats[i] = r.nextFloat() * 2.4f - 1.2f;
+
+            // from native floats..
+            FormatPointer (converted + offset, numChannels).convertSamples (ConstFloatPointer (floats.get()), numSamples);
+
+            FormatPointer reference (expected + offset, numChannels);
+
+            for (int i = 0; i < numSamples; ++i, ++reference)
+                reference.setAsFloat (floats[i]);
+
+            unitTest.expect (memcmp (converted, expected, numBytes) == 0);
+
+            // ..and back to native floats and ints
+            if (! ConstFormatPointer::isFloatingPoint())
+                for (size_t i = 0; i < numBytes; ++i)
+                    expected[i] = (char) r.nextInt (256);
+
+            FloatPointer (floatResult.get()).convertSamples (ConstFormatPointer (expected + offset, numChannels), numSamples);
+            IntPointer (intResult.get()).convertSamples (ConstFormatPointer (expected + offset, numChannels), numSamples);
+
+            ConstFormatPointer source (expected + offset, numChannels);
+
+            for (int i = 0; i < numSamples; ++i, ++source)
+            {
+                floatExpected[i] = source.getAsFloat();
+                intExpected[i] = source.getAsInt32();
+            }
+
+            unitTest.expect (memcmp (floatResult, floatExpected, sizeof (float) * numSamples) == 0);
+            unitTest.expect (ConstFormatPointer::isFloatingPoint() || memcmp (intResult, intExpected, sizeof (int32) * numSamples) == 0);
+        }
+    };
+
     void runTest() override
     {
         auto r = getRandom();
@@ -581,6 +1014,18 @@ public:
 
         using Format = AudioData::Format<AudioData::Float32, AudioData::NativeEndian>;
 
+        beginTest ("Optimised conversions match per-sample conversions");
+        {
+            FastPathTest<AudioData::Int16,   AudioData::LittleEndian>::test (*this, r);
+            FastPathTest<AudioData::Int16,   AudioData::BigEndian>   ::test (*this, r);
+            FastPathTest<AudioData::Int24,   AudioData::LittleEndian>::test (*this, r);
+            FastPathTest<AudioData::Int24,   AudioData::BigEndian>   ::test (*this, r);
+            FastPathTest<AudioData::Int32,   AudioData::LittleEndian>::test (*this, r);
+            FastPathTest<AudioData::Int32,   AudioData::BigEndian>   ::test (*this, r);
+            FastPathTest<AudioData::Float32, AudioData::LittleEndian>::test (*this, r);
+            FastPathTest<AudioData::Float32, AudioData::BigEndian>   ::test (*this, r);
+        }
+
         beginTest ("Interleaving");
         {
             constexpr auto numChannels = 4;
@@ -464,6 +464,9 @@ public:
             // trying to write to a const pointer! For a writeable one, use AudioData::NonConst instead!
             static_assert (Constness::isConst == 0, "Attempt to write to a const pointer");
 
+            if (source.getRawData() != getRawData() && convertSamplesQuickly (source, numSamples))
+                return;
+
             Pointer dest (*this);
 
             if (source.getRawData() != getRawData() || source.getNumBytesBetweenSamples() >= getNumBytesBetweenSamples())
@@ -572,8 +575,51 @@ public:
         //==============================================================================
         SampleFormat data;
 
+        using SampleFormatType = SampleFormat;
+        using EndiannessType   = Endianness;
+
+        template <typename, typename, typename, typename>
+        friend class Pointer;
+
         inline void advance() noexcept                          { this->advanceData (data); }
 
+        template <class OtherPointerType>
+        bool convertSamplesQuickly (const OtherPointerType& source, int numSamples) const noexcept
+        {
+            using SourceFormat     = typename OtherPointerType::SampleFormatType;
+            using SourceEndianness = typename OtherPointerType::EndiannessType;
+
+            if constexpr (isNativeFloat<SampleFormat, Endianness>() && hasFastConversion<SourceFormat>())
+            {
+                convertToNativeFloat (data.data, getNumBytesBetweenSamples(),
+                                      source.getRawData(), source.getNumBytesBetweenSamples(),
+                                      (int) SourceFormat::bytesPerSample, (bool) SourceFormat::isFloat, (bool) SourceEndianness::isBigEndian,
+                                      numSamples);
+                return true;
+            }
+            else if constexpr (isNativeFloat<SourceFormat, SourceEndianness>() && hasFastConversion<SampleFormat>())
+            {
+                convertFromNativeFloat (data.data, getNumBytesBetweenSamples(),
+                                        (int) SampleFormat::bytesPerSample, (bool) SampleFormat::isFloat, (bool) Endianness::isBigEndian,
+                                        static_cast<const float*> (source.getRawData()), source.getNumBytesBetweenSamples(),
+                                        numSamples);
+                return true;
+            }
+            else if constexpr (isNativeInt32<SampleFormat, Endianness>() && hasFastConversion<SourceFormat>() && ! SourceFormat::isFloat)
+            {
+                convertToNativeInt32 (data.data, getNumBytesBetweenSamples(),
+                                      source.getRawData(), source.getNumBytesBetweenSamples(),
+                                      (int) SourceFormat::bytesPerSample, (bool) SourceEndianness::isBigEndian,
+                                      numSamples);
+                return true;
+            }
+            else
+            {
+                ignoreUnused (source, numSamples);
+                return false;
+            }
+        }
+
         Pointer operator++ (int); // private to force you to use the more efficient pre-increment!
         Pointer operator-- (int);
     };
@@ -657,6 +703,46 @@ public:
     };
 
 private:
+    //==============================================================================
+    template <typename SampleFormat>
+    static constexpr bool hasFastConversion() noexcept
+    {
+        return std::is_same_v<SampleFormat, Int16> || std::is_same_v<SampleFormat, Int24>
+            || std::is_same_v<SampleFormat, Int32> || std::is_same_v<SampleFormat, Float32>;
+    }
+
+    template <typename SampleFormat, typename Endianness>
+    static constexpr bool isNativeFloat() noexcept
+    {
+        return std::is_same_v<SampleFormat, Float32> && (bool) Endianness::isBigEndian == (bool) NativeEndian::isBigEndian;
+    }
+
+    template <typename SampleFormat, typename Endianness>
+    static constexpr bool isNativeInt32() noexcept
+    {
+        return std::is_same_v<SampleFormat, Int32> && (bool) Endianness::isBigEndian == (bool) NativeEndian::isBigEndian;
+    }
+
+    /*  Vectorised loops for the most common conversions, which Pointer::convertSamples() uses
+        in place of its per-sample loop whenever one side is a native-endian float (or, when
+        reading integer data, a native-endian Int32) and the other is an Int16, Int24, Int32
+        or Float32 of either endianness. The strides are the number of bytes between samples.
+    */
+    static void JUCE_CALLTYPE convertToNativeFloat (float* dest, int destStride,
+                                                    const void* source, int sourceStride,
+                                                    int sourceBytesPerSample, bool sourceIsFloat, bool sourceIsBigEndian,
+                                                    int numSamples) noexcept;
+
+    static void JUCE_CALLTYPE convertFromNativeFloat (void* dest, int destStride,
+                                                      int destBytesPerSample, bool destIsFloat, bool destIsBigEndian,
+                                                      const float* source, int sourceStride,
+                                                      int numSamples) noexcept;
+
+    static void JUCE_CALLTYPE convertToNativeInt32 (uint32* dest, int destStride,
+                                                    const void* source, int sourceStride,
+                                                    int sourceBytesPerSample, bool sourceIsBigEndian,
+                                                    int numSamples) noexcept;
+
     template <bool IsInterleaved, bool IsConst, typename...>
     struct ChannelDataSubtypes;
 
@@ -491,6 +491,240 @@ namespace FloatVectorHelpers
     };
    #endif
 
+    //==============================================================================
+   #if JUCE_USE_AVX_INTRINSICS
+    /*  On x86, the wider AVX2 and AVX-512 registers can only be used if the CPU
+        we end up running on supports them, so these kernels are compiled with
+        per-function target attributes and chosen at runtime rather than relying
+        on the compiler flags used for the rest of the module.
+    */
+    #if JUCE_MSVC
+     #define JUCE_AVX2_TARGET
+     #define JUCE_AVX512_TARGET
+    #else
+     #define JUCE_AVX2_TARGET     __attribute__ ((target ("avx2,fma")))
+     #define JUCE_AVX512_TARGET   __attribute__ ((target ("avx512f,avx2,fma")))
+    #endif
+
+    struct AVX2Ops32
+    {
+        using Type = float;
+        using ParallelType = __m256;
+        enum { numParallel = 8 };
+
+        JUCE_AVX2_TARGET static forcedinline ParallelType load1 (Type v) noexcept                                     { return _mm256_set1_ps (v); }
+        JUCE_AVX2_TARGET static forcedinline ParallelType loadU (const Type* v) noexcept                              { return _mm256_loadu_ps (v); }
+        JUCE_AVX2_TARGET static forcedinline void storeU (Type* dest, ParallelType a) noexcept                        { _mm256_storeu_ps (dest, a); }
+
+        JUCE_AVX2_TARGET static forcedinline ParallelType add (ParallelType a, ParallelType b) noexcept               { return _mm256_add_ps (a, b); }
+        JUCE_AVX2_TARGET static forcedinline ParallelType mul (ParallelType a, ParallelType b) noexcept               { return _mm256_mul_ps (a, b); }
+        JUCE_AVX2_TARGET static forcedinline ParallelType mulAdd (ParallelType a, ParallelType b, ParallelType c) noexcept { return _mm256_fmadd_ps (a, b, c); }
+        JUCE_AVX2_TARGET static forcedinline ParallelType max (ParallelType a, ParallelType b) noexcept               { return _mm256_max_ps (a, b); }
+        JUCE_AVX2_TARGET static forcedinline ParallelType min (ParallelType a, ParallelType b) noexcept               { return _mm256_min_ps (a, b); }
+    };
+
+    struct AVX2Ops64
+    {
+        using Type = double;
+        using ParallelType = __m256d;
+        enum { numParallel = 4 };
+
+        JUCE_AVX2_TARGET static forcedinline ParallelType load1 (Type v) noexcept                                     { return _mm256_set1_pd (v); }
+        JUCE_AVX2_TARGET static forcedinline ParallelType loadU (const Type* v) noexcept                              { return _mm256_loadu_pd (v); }
+        JUCE_AVX2_TARGET static forcedinline void storeU (Type* dest, ParallelType a) noexcept                        { _mm256_storeu_pd (dest, a); }
+
+        JUCE_AVX2_TARGET static forcedinline ParallelType add (ParallelType a, ParallelType b) noexcept               { return _mm256_add_pd (a, b); }
+        JUCE_AVX2_TARGET static forcedinline ParallelType mul (ParallelType a, ParallelType b) noexcept               { return _mm256_mul_pd (a, b); }
+        JUCE_AVX2_TARGET static forcedinline ParallelType mulAdd (ParallelType a, ParallelType b, ParallelType c) noexcept { return _mm256_fmadd_pd (a, b, c); }
+        JUCE_AVX2_TARGET static forcedinline ParallelType max (ParallelType a, ParallelType b) noexcept               { return _mm256_max_pd (a, b); }
+        JUCE_AVX2_TARGET static forcedinline ParallelType min (ParallelType a, ParallelType b) noexcept               { return _mm256_min_pd (a, b); }
+    };
+
+    struct AVX512Ops32
+    {
+        using Type = float;
+        using ParallelType = __m512;
+        enum { numParallel = 16 };
+
+        JUCE_AVX512_TARGET static forcedinline ParallelType load1 (Type v) noexcept                                   { return _mm512_set1_ps (v); }
+        JUCE_AVX512_TARGET static forcedinline ParallelType loadU (const Type* v) noexcept                            { return _mm512_loadu_ps (v); }
+        JUCE_AVX512_TARGET static forcedinline void storeU (Type* dest, ParallelType a) noexcept                      { _mm512_storeu_ps (dest, a); }
+
+        JUCE_AVX512_TARGET static forcedinline ParallelType add (ParallelType a, ParallelType b) noexcept             { return _mm512_add_ps (a, b); }
+        JUCE_AVX512_TARGET static forcedinline ParallelType mul (ParallelType a, ParallelType b) noexcept             { return _mm512_mul_ps (a, b); }
+        JUCE_AVX512_TARGET static forcedinline ParallelType mulAdd (ParallelType a, ParallelType b, ParallelType c) noexcept { return _mm512_fmadd_ps (a, b, c); }
+        JUCE_AVX512_TARGET static forcedinline ParallelType max (ParallelType a, ParallelType b) noexcept             { return _mm512_max_ps (a, b); }
+        JUCE_AVX512_TARGET static forcedinline ParallelType min (ParallelType a, ParallelType b) noexcept             { return _mm512_min_ps (a, b); }
+    };
+
+    struct AVX512Ops64
+    {
+        using Type = double;
+        using ParallelType = __m512d;
+        enum { numParallel = 8 };
+
+        JUCE_AVX512_TARGET static forcedinline ParallelType load1 (Type v) noexcept                                   { return _mm512_set1_pd (v); }
+        JUCE_AVX512_TARGET static forcedinline ParallelType loadU (const Type* v) noexcept                            { return _mm512_loadu_pd (v); }
+        JUCE_AVX512_TARGET static forcedinline void storeU (Type* dest, ParallelType a) noexcept                      { _mm512_storeu_pd (dest, a); }
+
+        JUCE_AVX512_TARGET static forcedinline ParallelType add (ParallelType a, ParallelType b) noexcept             { return _mm512_add_pd (a, b); }
+        JUCE_AVX512_TARGET static forcedinline ParallelType mul (ParallelType a, ParallelType b) noexcept             { return _mm512_mul_pd (a, b); }
+        JUCE_AVX512_TARGET static forcedinline ParallelType mulAdd (ParallelType a, ParallelType b, ParallelType c) noexcept { return _mm512_fmadd_pd (a, b, c); }
+        JUCE_AVX512_TARGET static forcedinline ParallelType max (ParallelType a, ParallelType b) noexcept             { return _mm512_max_pd (a, b); }
+        JUCE_AVX512_TARGET static forcedinline ParallelType min (ParallelType a, ParallelType b) noexcept             { return _mm512_min_pd (a, b); }
+    };
+
+    /*  The same set of loops is needed for both instruction sets, but as the target attribute
+        can't depend on a template parameter, this macro stamps out one kernel template per set.
+        Unaligned loads and stores are used throughout, as they cost nothing extra on the
+        CPUs that support these instructions.
+    */
+    #define JUCE_DECLARE_WIDE_VECTOR_KERNELS(KernelName, TARGET) \
+        template <typename Mode> \
+        struct KernelName \
+        { \
+            using Type = typename Mode::Type; \
+            using ParallelType = typename Mode::ParallelType; \
+            static constexpr size_t step = (size_t) Mode::numParallel; \
+         \
+            TARGET static void add (Type* dest, Type amount, size_t num) noexcept \
+            { \
+                const auto am = Mode::load1 (amount); \
+                size_t i = 0; \
+                for (; i + step <= num; i += step)  Mode::storeU (dest + i, Mode::add (Mode::loadU (dest + i), am)); \
+                for (; i < num; ++i)                dest[i] += amount; \
+            } \
+         \
+            TARGET static void add (Type* dest, const Type* src, size_t num) noexcept \
+            { \
+                size_t i = 0; \
+                for (; i + step <= num; i += step)  Mode::storeU (dest + i, Mode::add (Mode::loadU (dest + i), Mode::loadU (src + i))); \
+                for (; i < num; ++i)                dest[i] += src[i]; \
+            } \
+         \
+            TARGET static void add (Type* dest, const Type* src1, const Type* src2, size_t num) noexcept \
+            { \
+                size_t i = 0; \
+                for (; i + step <= num; i += step)  Mode::storeU (dest + i, Mode::add (Mode::loadU (src1 + i), Mode::loadU (src2 + i))); \
+                for (; i < num; ++i)                dest[i] = src1[i] + src2[i]; \
+            } \
+         \
+            TARGET static void multiply (Type* dest, Type multiplier, size_t num) noexcept \
+            { \
+                const auto mult = Mode::load1 (multiplier); \
+                size_t i = 0; \
+                for (; i + step <= num; i += step)  Mode::storeU (dest + i, Mode::mul (Mode::loadU (dest + i), mult)); \
+                for (; i < num; ++i)                dest[i] *= multiplier; \
+            } \
+         \
+            TARGET static void multiply (Type* dest, const Type* src, size_t num) noexcept \
+            { \
+                size_t i = 0; \
+                for (; i + step <= num; i += step)  Mode::storeU (dest + i, Mode::mul (Mode::loadU (dest + i), Mode::loadU (src + i))); \
+                for (; i < num; ++i)                dest[i] *= src[i]; \
+            } \
+         \
+            TARGET static void multiply (Type* dest, const Type* src1, const Type* src2, size_t num) noexcept \
+            { \
+                size_t i = 0; \
+                for (; i + step <= num; i += step)  Mode::storeU (dest + i, Mode::mul (Mode::loadU (src1 + i), Mode::loadU (src2 + i))); \
+                for (; i < num; ++i)                dest[i] = src1[i] * src2[i]; \
+            } \
+         \
+            TARGET static void copyWithMultiply (Type* dest, const Type* src, Type multiplier, size_t num) noexcept \
+            { \
+                const auto mult = Mode::load1 (multiplier); \
+                size_t i = 0; \
+                for (; i + step <= num; i += step)  Mode::storeU (dest + i, Mode::mul (Mode::loadU (src + i), mult)); \
+                for (; i < num; ++i)                dest[i] = src[i] * multiplier; \
+            } \
+         \
+            TARGET static void addWithMultiply (Type* dest, const Type* src, Type multiplier, size_t num) noexcept \
+            { \
+                const auto mult = Mode::load1 (multiplier); \
+                size_t i = 0; \
+                for (; i + step <= num; i += step)  Mode::storeU (dest + i, Mode::mulAdd (Mode::loadU (src + i), mult, Mode::loadU (dest + i))); \
+                for (; i < num; ++i)                dest[i] += src[i] * multiplier; \
+            } \
+         \
+            TARGET static void addWithMultiply (Type* dest, const Type* src1, const Type* src2, size_t num) noexcept \
+            { \
+                size_t i = 0; \
+                for (; i + step <= num; i += step)  Mode::storeU (dest + i, Mode::mulAdd (Mode::loadU (src1 + i), Mode::loadU (src2 + i), Mode::loadU (dest + i))); \
+                for (; i < num; ++i)                dest[i] += src1[i] * src2[i]; \
+            } \
+         \
+            TARGET static Range<Type> findMinAndMax (const Type* src, size_t num) noexcept \
+            { \
+                if (num < 2 * step) \
+                    return Range<Type>::findMinAndMax (src, (int) num); \
+         \
+                auto mn = Mode::loadU (src), mx = mn; \
+                size_t i = step; \
+         \
+                for (; i + step <= num; i += step) \
+                { \
+                    const auto v = Mode::loadU (src + i); \
+                    mn = Mode::min (mn, v); \
+                    mx = Mode::max (mx, v); \
+                } \
+         \
+                Type lanes[2][step]; \
+                Mode::storeU (lanes[0], mn); \
+                Mode::storeU (lanes[1], mx); \
+                Range<Type> result (lanes[0][0], lanes[1][0]); \
+         \
+                for (size_t j = 1; j < step; ++j) \
+                    result = Range<Type> (jmin (result.getStart(), lanes[0][j]), jmax (result.getEnd(), lanes[1][j])); \
+         \
+                for (; i < num; ++i) \
+                    result = result.getUnionWith (src[i]); \
+         \
+                return result; \
+            } \
+        };
+
+    JUCE_DECLARE_WIDE_VECTOR_KERNELS (AVX2Kernels, JUCE_AVX2_TARGET)
+    JUCE_DECLARE_WIDE_VECTOR_KERNELS (AVX512Kernels, JUCE_AVX512_TARGET)
+
+    template <typename Type> struct WideModeType;
+    template <> struct WideModeType<float>  { using AVX2 = AVX2Kernels<AVX2Ops32>; using AVX512 = AVX512Kernels<AVX512Ops32>; };
+    template <> struct WideModeType<double> { using AVX2 = AVX2Kernels<AVX2Ops64>; using AVX512 = AVX512Kernels<AVX512Ops64>; };
+
+    using InstructionSet = FloatVectorOperations::InstructionSet;
+
+    static InstructionSet getSupportedInstructionSet() noexcept
+    {
+        return SystemStats::hasAVX512F() ? InstructionSet::avx512
+             : (SystemStats::hasAVX2() && SystemStats::hasFMA3()) ? InstructionSet::avx2
+                                                                  : InstructionSet::baseline;
+    }
+
+    static std::atomic<InstructionSet>& getActiveInstructionSet() noexcept
+    {
+        static std::atomic<InstructionSet> set { getSupportedInstructionSet() };
+        return set;
+    }
+
+    /*  Hands the whole operation over to the widest kernel available on this CPU, or falls
+        through to the SSE loop that follows it. Very short vectors aren't worth the switch.
+    */
+    #define JUCE_DISPATCH_WIDE_VEC_OP(type, op, ...) \
+        if (num >= 16) \
+        { \
+            using WideMode = FloatVectorHelpers::WideModeType<type>; \
+         \
+            switch (FloatVectorHelpers::getActiveInstructionSet().load (std::memory_order_relaxed)) \
+            { \
+                case FloatVectorHelpers::InstructionSet::avx512:    return WideMode::AVX512::op (__VA_ARGS__, (size_t) num); \
+                case FloatVectorHelpers::InstructionSet::avx2:      return WideMode::AVX2::op (__VA_ARGS__, (size_t) num); \
+                case FloatVectorHelpers::InstructionSet::baseline:  break; \
+            } \
+        }
+   #else
+    #define JUCE_DISPATCH_WIDE_VEC_OP(type, op, ...)
+   #endif
+
 //==============================================================================
 namespace
 {
@@ -546,6 +780,8 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vsmul (src, 1, &multiplier, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (float, copyWithMultiply, dest, src, multiplier)
+
         JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = src[i] * multiplier,
                                       Mode::mul (mult, s),
                                       JUCE_LOAD_SRC,
@@ -560,6 +796,8 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vsmulD (src, 1, &multiplier, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (double, copyWithMultiply, dest, src, multiplier)
+
         JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = src[i] * multiplier,
                                       Mode::mul (mult, s),
                                       JUCE_LOAD_SRC,
@@ -574,6 +812,8 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vsadd (dest, 1, &amount, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (float, add, dest, amount)
+
         JUCE_PERFORM_VEC_OP_DEST (dest[i] += amount,
                                   Mode::add (d, amountToAdd),
                                   JUCE_LOAD_DEST,
@@ -584,6 +824,8 @@ namespace
     template <typename Size>
     void add (double* dest, double amount, Size num) noexcept
     {
+        JUCE_DISPATCH_WIDE_VEC_OP (double, add, dest, amount)
+
         JUCE_PERFORM_VEC_OP_DEST (dest[i] += amount,
                                   Mode::add (d, amountToAdd),
                                   JUCE_LOAD_DEST,
@@ -624,6 +866,8 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vadd (src, 1, dest, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (float, add, dest, src)
+
         JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] += src[i],
                                       Mode::add (d, s),
                                       JUCE_LOAD_SRC_DEST,
@@ -637,6 +881,8 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vaddD (src, 1, dest, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (double, add, dest, src)
+
         JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] += src[i],
                                       Mode::add (d, s),
                                       JUCE_LOAD_SRC_DEST,
@@ -650,6 +896,8 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vadd (src1, 1, src2, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (float, add, dest, src1, src2)
+
         JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST (dest[i] = src1[i] + src2[i],
                                             Mode::add (s1, s2),
                                             JUCE_LOAD_SRC1_SRC2,
@@ -663,6 +911,8 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vaddD (src1, 1, src2, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (double, add, dest, src1, src2)
+
         JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST (dest[i] = src1[i] + src2[i],
                                             Mode::add (s1, s2),
                                             JUCE_LOAD_SRC1_SRC2,
@@ -728,6 +978,8 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vsma (src, 1, &multiplier, dest, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (float, addWithMultiply, dest, src, multiplier)
+
         JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] += src[i] * multiplier,
                                       Mode::add (d, Mode::mul (mult, s)),
                                       JUCE_LOAD_SRC_DEST,
@@ -742,6 +994,8 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vsmaD (src, 1, &multiplier, dest, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (double, addWithMultiply, dest, src, multiplier)
+
         JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] += src[i] * multiplier,
                                       Mode::add (d, Mode::mul (mult, s)),
                                       JUCE_LOAD_SRC_DEST,
@@ -756,6 +1010,8 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vma ((float*) src1, 1, (float*) src2, 1, dest, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (float, addWithMultiply, dest, src1, src2)
+
         JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST_DEST (dest[i] += src1[i] * src2[i],
                                                  Mode::add (d, Mode::mul (s1, s2)),
                                                  JUCE_LOAD_SRC1_SRC2_DEST,
@@ -769,6 +1025,8 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vmaD ((double*) src1, 1, (double*) src2, 1, dest, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (double, addWithMultiply, dest, src1, src2)
+
         JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST_DEST (dest[i] += src1[i] * src2[i],
                                                  Mode::add (d, Mode::mul (s1, s2)),
                                                  JUCE_LOAD_SRC1_SRC2_DEST,
@@ -820,6 +1078,8 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vmul (src, 1, dest, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (float, multiply, dest, src)
+
         JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] *= src[i],
                                       Mode::mul (d, s),
                                       JUCE_LOAD_SRC_DEST,
@@ -833,6 +1093,8 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vmulD (src, 1, dest, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (double, multiply, dest, src)
+
         JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] *= src[i],
                                       Mode::mul (d, s),
                                       JUCE_LOAD_SRC_DEST,
@@ -846,6 +1108,8 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vmul (src1, 1, src2, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (float, multiply, dest, src1, src2)
+
         JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST (dest[i] = src1[i] * src2[i],
                                             Mode::mul (s1, s2),
                                             JUCE_LOAD_SRC1_SRC2,
@@ -859,6 +1123,8 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vmulD (src1, 1, src2, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (double, multiply, dest, src1, src2)
+
         JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST (dest[i] = src1[i] * src2[i],
                                             Mode::mul (s1, s2),
                                             JUCE_LOAD_SRC1_SRC2,
@@ -872,6 +1138,8 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vsmul (dest, 1, &multiplier, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (float, multiply, dest, multiplier)
+
         JUCE_PERFORM_VEC_OP_DEST (dest[i] *= multiplier,
                                   Mode::mul (d, mult),
                                   JUCE_LOAD_DEST,
@@ -885,6 +1153,8 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vsmulD (dest, 1, &multiplier, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (double, multiply, dest, multiplier)
+
         JUCE_PERFORM_VEC_OP_DEST (dest[i] *= multiplier,
                                   Mode::mul (d, mult),
                                   JUCE_LOAD_DEST,
@@ -895,6 +1165,8 @@ namespace
     template <typename Size>
     void multiply (float* dest, const float* src, float multiplier, Size num) noexcept
     {
+        JUCE_DISPATCH_WIDE_VEC_OP (float, copyWithMultiply, dest, src, multiplier)
+
         JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = src[i] * multiplier,
                                       Mode::mul (mult, s),
                                       JUCE_LOAD_SRC,
@@ -905,6 +1177,8 @@ namespace
     template <typename Size>
     void multiply (double* dest, const double* src, double multiplier, Size num) noexcept
     {
+        JUCE_DISPATCH_WIDE_VEC_OP (double, copyWithMultiply, dest, src, multiplier)
+
         JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = src[i] * multiplier,
                                       Mode::mul (mult, s),
                                       JUCE_LOAD_SRC,
@@ -1094,6 +1368,8 @@ namespace
     template <typename Size>
     Range<float> findMinAndMax (const float* src, Size num) noexcept
     {
+        JUCE_DISPATCH_WIDE_VEC_OP (float, findMinAndMax, src)
+
        #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
         return FloatVectorHelpers::MinMax<FloatVectorHelpers::BasicOps32>::findMinAndMax (src, num);
        #else
@@ -1104,6 +1380,8 @@ namespace
     template <typename Size>
     Range<double> findMinAndMax (const double* src, Size num) noexcept
     {
+        JUCE_DISPATCH_WIDE_VEC_OP (double, findMinAndMax, src)
+
        #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
         return FloatVectorHelpers::MinMax<FloatVectorHelpers::BasicOps64>::findMinAndMax (src, num);
        #else
@@ -1529,6 +1807,24 @@ bool JUCE_CALLTYPE FloatVectorOperations::areDenormalsDisabled() noexcept
   #endif
 }
 
+FloatVectorOperations::InstructionSet JUCE_CALLTYPE FloatVectorOperations::limitInstructionSet ([[maybe_unused]] InstructionSet widestSetToUse) noexcept
+{
+  #if JUCE_USE_AVX_INTRINSICS
+    return FloatVectorHelpers::getActiveInstructionSet().exchange (jmin (widestSetToUse, FloatVectorHelpers::getSupportedInstructionSet()));
+  #else
+    return InstructionSet::baseline;
+  #endif
+}
+
+FloatVectorOperations::InstructionSet JUCE_CALLTYPE FloatVectorOperations::getInstructionSet() noexcept
+{
+  #if JUCE_USE_AVX_INTRINSICS
+    return FloatVectorHelpers::getActiveInstructionSet().load();
+  #else
+    return InstructionSet::baseline;
+  #endif
+}
+
 ScopedNoDenormals::ScopedNoDenormals() noexcept
 {
   #if JUCE_USE_SSE_INTRINSICS || (JUCE_USE_ARM_NEON || (JUCE_64BIT && JUCE_ARM))
@@ -1646,6 +1942,65 @@ public:
             u.expect (areAllValuesEqual (data1, num, (ValueType) 8));
         }
 
+        static void runArithmeticTest (UnitTest& u, Random random)
+        {
+            const int num = random.nextInt (600) + 1;
+
+            HeapBlock<ValueType> buffer1 (num + 16), buffer2 (num + 16), buffer3 (num + 16), expected (num);
+
+           #if JUCE_ARM
+            ValueType* const data1 = buffer1;
+            ValueType* const data2 = buffer2;
+            ValueType* const data3 = buffer3;
+           #else
+            ValueType* const data1 = addBytesToPointer (buffer1.get(), random.nextInt (16));
+            ValueType* const data2 = addBytesToPointer (buffer2.get(), random.nextInt (16));
+            ValueType* const data3 = addBytesToPointer (buffer3.get(), random.nextInt (16));
+           #endif
+
+            fillRandomly (random, data1, num);
+            fillRandomly (random, data2, num);
+            const auto scalar = (ValueType) (random.nextDouble() * 10.0 - 5.0);
+
+            u.expect (FloatVectorOperations::findMinAndMax (data1, num) == Range<ValueType>::findMinAndMax (data1, num));
+
+            for (int i = 0; i < num; ++i)  expected[i] = data1[i] + data2[i];
+            FloatVectorOperations::add (data3, data1, data2, num);
+            u.expect (buffersMatchRelative (data3, expected, num));
+
+            for (int i = 0; i < num; ++i)  expected[i] += data1[i];
+            FloatVectorOperations::add (data3, data1, num);
+            u.expect (buffersMatchRelative (data3, expected, num));
+
+            for (int i = 0; i < num; ++i)  expected[i] += scalar;
+            FloatVectorOperations::add (data3, scalar, num);
+            u.expect (buffersMatchRelative (data3, expected, num));
+
+            for (int i = 0; i < num; ++i)  expected[i] = data1[i] * data2[i];
+            FloatVectorOperations::multiply (data3, data1, data2, num);
+            u.expect (buffersMatchRelative (data3, expected, num));
+
+            for (int i = 0; i < num; ++i)  expected[i] *= data2[i];
+            FloatVectorOperations::multiply (data3, data2, num);
+            u.expect (buffersMatchRelative (data3, expected, num));
+
+            for (int i = 0; i < num; ++i)  expected[i] *= scalar;
+            FloatVectorOperations::multiply (data3, scalar, num);
+            u.expect (buffersMatchRelative (data3, expected, num));
+
+            for (int i = 0; i < num; ++i)  expected[i] = data1[i] * scalar;
+            FloatVectorOperations::copyWithMultiply (data3, data1, scalar, num);
+            u.expect (buffersMatchRelative (data3, expected, num));
+
+            for (int i = 0; i < num; ++i)  expected[i] += data2[i] * scalar;
+            FloatVectorOperations::addWithMultiply (data3, data2, scalar, num);
+            u.expect (buffersMatchRelative (data3, expected, num));
+
+            for (int i = 0; i < num; ++i)  expected[i] += data1[i] * data2[i];
+            FloatVectorOperations::addWithMultiply (data3, data1, data2, num);
+            u.expect (buffersMatchRelative (data3, expected, num));
+        }
+
         static void doConversionTest (UnitTest& u, float* data1, float* data2, int* const int1, int num)
         {
             FloatVectorOperations::convertFixedToFloat (data1, int1, 2.0f, num);
@@ -1695,6 +2050,20 @@ public:
         {
             return std::abs (v1 - v2) < std::numeric_limits<ValueType>::epsilon();
         }
+
+        // Fused multiply-adds round once rather than twice, so allow for a few ulps of difference
+        static bool buffersMatchRelative (const ValueType* d1, const ValueType* d2, int num)
+        {
+            while (--num >= 0)
+            {
+                const auto v1 = *d1++, v2 = *d2++;
+
+                if (std::abs (v1 - v2) > std::numeric_limits<ValueType>::epsilon() * 4 * jmax ((ValueType) 1, std::abs (v2)))
+                    return false;
+            }
+
+            return true;
+        }
     };
 
     void runTest() override
@@ -1706,6 +2075,54 @@ public:
             TestRunner<float>::runTest (*this, getRandom());
             TestRunner<double>::runTest (*this, getRandom());
         }
+
+        beginTest ("Arithmetic matches scalar results");
+
+        for (int i = 200; --i >= 0;)
+        {
+            TestRunner<float>::runArithmeticTest (*this, getRandom());
+            TestRunner<double>::runArithmeticTest (*this, getRandom());
+        }
+
+        using InstructionSet = FloatVectorOperations::InstructionSet;
+
+        for (auto set : { InstructionSet::baseline, InstructionSet::avx2 })
+        {
+            if (set >= FloatVectorOperations::getInstructionSet())
+                continue;
+
+            beginTest (set == InstructionSet::baseline ? "Arithmetic matches scalar results (baseline instruction set)"
+                                                       : "Arithmetic matches scalar results (AVX2)");
+
+            const FloatVectorOperations::ScopedInstructionSetLimit limit (set);
+            expect (FloatVectorOperations::getInstructionSet() == set);
+
+            for (int i = 200; --i >= 0;)
+            {
+                TestRunner<float>::runArithmeticTest (*this, getRandom());
+                TestRunner<double>::runArithmeticTest (*this, getRandom());
+            }
+        }
+
+        beginTest ("Instruction set limits are undone");
+        {
+            const auto supported = FloatVectorOperations::getInstructionSet();
+
+            {
+                const FloatVectorOperations::ScopedInstructionSetLimit limit (InstructionSet::baseline);
+                expect (FloatVectorOperations::getInstructionSet() == InstructionSet::baseline);
+
+                {
+                    // asking for more than the CPU supports gives whatever it does support
+                    const FloatVectorOperations::ScopedInstructionSetLimit wider (InstructionSet::avx512);
+                    expect (FloatVectorOperations::getInstructionSet() == supported);
+                }
+
+                expect (FloatVectorOperations::getInstructionSet() == InstructionSet::baseline);
+            }
+
+            expect (FloatVectorOperations::getInstructionSet() == supported);
+        }
     }
 };
 
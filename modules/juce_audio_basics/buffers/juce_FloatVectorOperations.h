@@ -46,6 +46,12 @@ class ScopedNoDenormals;
     FloatVectorOperations::clear (data, 64);
     @endcode
 
+    On Intel CPUs, the add, multiply, copyWithMultiply, addWithMultiply and findMinAndMax
+    functions will use AVX2/FMA or AVX-512 code when the machine they're running on
+    supports it. Note that this means addWithMultiply uses fused multiply-adds on these
+    machines, so its results may differ in the last bit from those on older CPUs. You can
+    set JUCE_USE_AVX_INTRINSICS=0 to stick to the SSE versions.
+
     @see FloatVectorOperations
 
     @tags{Audio}
@@ -201,6 +207,45 @@ public:
     /** This method returns true if denormals are currently disabled. */
     static bool JUCE_CALLTYPE areDenormalsDisabled() noexcept;
 
+    //==============================================================================
+    /** The sets of SIMD instructions that the vector operations can use. */
+    enum class InstructionSet
+    {
+        baseline,   /**< SSE on Intel, NEON on Arm, or plain loops elsewhere. */
+        avx2,       /**< AVX2 and FMA. */
+        avx512      /**< AVX-512F. */
+    };
+
+    /** Stops the vector operations from using anything wider than the given instruction set.
+
+        By default, the widest set that the CPU supports is used, so this is mostly useful for
+        comparing the different code paths in tests and benchmarks. The limit is global, so
+        avoid changing it while other threads are using these functions.
+
+        Returns the instruction set that was in use before the call, which you can pass back
+        in to undo the change, or use a ScopedInstructionSetLimit to do that for you.
+    */
+    static InstructionSet JUCE_CALLTYPE limitInstructionSet (InstructionSet widestSetToUse) noexcept;
+
+    /** Returns the widest instruction set that the vector operations are currently using. */
+    static InstructionSet JUCE_CALLTYPE getInstructionSet() noexcept;
+
+    /** Limits the instruction set with limitInstructionSet() for the lifetime of the object,
+        and restores the previous one when it's deleted.
+    */
+    struct ScopedInstructionSetLimit
+    {
+        explicit ScopedInstructionSetLimit (InstructionSet widestSetToUse) noexcept
+            : previous (limitInstructionSet (widestSetToUse)) {}
+
+        ~ScopedInstructionSetLimit() noexcept    { limitInstructionSet (previous); }
+
+    private:
+        const InstructionSet previous;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedInstructionSetLimit)
+    };
+
 private:
     friend ScopedNoDenormals;
 
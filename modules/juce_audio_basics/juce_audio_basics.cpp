@@ -39,6 +39,13 @@
  #include <emmintrin.h>
 #endif
 
+#if JUCE_USE_AVX_INTRINSICS
+ // Some versions of GCC report false positives from the _undefined_ placeholders in these headers
+ JUCE_BEGIN_IGNORE_WARNINGS_GCC_LIKE ("-Wmaybe-uninitialized")
+ #include <immintrin.h>
+ JUCE_END_IGNORE_WARNINGS_GCC_LIKE
+#endif
+
 #if JUCE_MAC || JUCE_IOS
  #ifndef JUCE_USE_VDSP_FRAMEWORK
   #define JUCE_USE_VDSP_FRAMEWORK 1
@@ -826,6 +826,7 @@ public:
                                          reader.bytesPerFrame * reader.lengthInSamples, reader.bytesPerFrame),
           littleEndian (reader.littleEndian)
     {
+        dataIsLittleEndian = littleEndian;
     }
 
     bool readSamples (int* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
@@ -0,0 +1,514 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+static const char* const rawPCMFormatName = "Raw PCM file";
+
+//==============================================================================
+bool RawPCMAudioFormat::Layout::isValid() const noexcept
+{
+    return sampleRate > 0
+        && numChannels > 0
+        && (bitsPerSample == 8 || bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32)
+        && (! usesFloatingPointData || bitsPerSample == 32)
+        && headerSize >= 0;
+}
+
+//==============================================================================
+class RawPCMAudioFormatReader final : public AudioFormatReader
+{
+public:
+    RawPCMAudioFormatReader (InputStream* in, const RawPCMAudioFormat::Layout& layout)
+        : AudioFormatReader (in, rawPCMFormatName),
+          dataChunkStart (layout.headerSize),
+          bytesPerFrame (layout.getBytesPerFrame()),
+          littleEndian (layout.isLittleEndian)
+    {
+        sampleRate            = layout.sampleRate;
+        numChannels           = layout.numChannels;
+        bitsPerSample         = layout.bitsPerSample;
+        usesFloatingPointData = layout.usesFloatingPointData;
+
+        auto totalLength = input->getTotalLength();
+
+        if (bytesPerFrame > 0 && totalLength > dataChunkStart)
+        {
+            lengthInSamples = (totalLength - dataChunkStart) / bytesPerFrame;
+            dataLength = lengthInSamples * bytesPerFrame;
+        }
+    }
+
+    //==============================================================================
+    bool readSamples (int* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                      int64 startSampleInFile, int numSamples) override
+    {
+        clearSamplesBeyondAvailableLength (destSamples, numDestChannels, startOffsetInDestBuffer,
+                                           startSampleInFile, numSamples, lengthInSamples);
+
+        if (numSamples <= 0)
+            return true;
+
+        input->setPosition (dataChunkStart + startSampleInFile * bytesPerFrame);
+
+        while (numSamples > 0)
+        {
+            const int tempBufSize = 480 * 3 * 4; // (keep this a multiple of 3)
+            char tempBuffer[tempBufSize];
+
+            auto numThisTime = jmin (tempBufSize / bytesPerFrame, numSamples);
+            auto bytesRead = input->read (tempBuffer, numThisTime * bytesPerFrame);
+
+            if (bytesRead < numThisTime * bytesPerFrame)
+            {
+                jassert (bytesRead >= 0);
+                zeromem (tempBuffer + bytesRead, (size_t) (numThisTime * bytesPerFrame - bytesRead));
+            }
+
+            copySampleData<AudioData::Int32> (littleEndian, bitsPerSample, usesFloatingPointData,
+                                              destSamples, startOffsetInDestBuffer, numDestChannels,
+                                              tempBuffer, (int) numChannels, numThisTime);
+
+            startOffsetInDestBuffer += numThisTime;
+            numSamples -= numThisTime;
+        }
+
+        return true;
+    }
+
+    /** Converts interleaved raw data with a run-time byte-order. Integer source data is
+        converted to IntegerDestType, and floating point data is always copied as Float32.
+    */
+    template <typename IntegerDestType, typename TargetType>
+    static void copySampleData (bool isLittleEndian, unsigned int numBitsPerSample, bool floatingPointData,
+                                TargetType* const* destSamples, int startOffsetInDestBuffer, int numDestChannels,
+                                const void* sourceData, int numberOfChannels, int numSamples) noexcept
+    {
+        if (isLittleEndian)
+            copySampleData<IntegerDestType, AudioData::LittleEndian> (numBitsPerSample, floatingPointData, destSamples, startOffsetInDestBuffer,
+                                                                      numDestChannels, sourceData, numberOfChannels, numSamples);
+        else
+            copySampleData<IntegerDestType, AudioData::BigEndian> (numBitsPerSample, floatingPointData, destSamples, startOffsetInDestBuffer,
+                                                                   numDestChannels, sourceData, numberOfChannels, numSamples);
+    }
+
+    template <typename IntegerDestType, typename Endianness, typename TargetType>
+    static void copySampleData (unsigned int numBitsPerSample, bool floatingPointData,
+                                TargetType* const* destSamples, int startOffsetInDestBuffer, int numDestChannels,
+                                const void* sourceData, int numberOfChannels, int numSamples) noexcept
+    {
+        switch (numBitsPerSample)
+        {
+            case 8:     ReadHelper<IntegerDestType, AudioData::UInt8, Endianness>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numberOfChannels, numSamples); break;
+            case 16:    ReadHelper<IntegerDestType, AudioData::Int16, Endianness>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numberOfChannels, numSamples); break;
+            case 24:    ReadHelper<IntegerDestType, AudioData::Int24, Endianness>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numberOfChannels, numSamples); break;
+            case 32:    if (floatingPointData) ReadHelper<AudioData::Float32, AudioData::Float32, Endianness>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numberOfChannels, numSamples);
+                        else                   ReadHelper<IntegerDestType,    AudioData::Int32,   Endianness>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numberOfChannels, numSamples);
+                        break;
+            default:    jassertfalse; break;
+        }
+    }
+
+    int64 dataChunkStart = 0, dataLength = 0;
+    int bytesPerFrame = 0;
+    bool littleEndian = true;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RawPCMAudioFormatReader)
+};
+
+//==============================================================================
+class RawPCMAudioFormatWriter final : public AudioFormatWriter
+{
+public:
+    RawPCMAudioFormatWriter (OutputStream* out, double rate, unsigned int numChans,
+                             unsigned int bits, bool floatingPointData, bool isLittleEndian)
+        : AudioFormatWriter (out, rawPCMFormatName, rate, numChans, bits),
+          littleEndian (isLittleEndian)
+    {
+        usesFloatingPointData = floatingPointData;
+    }
+
+    //==============================================================================
+    bool write (const int** data, int numSamples) override
+    {
+        jassert (numSamples >= 0);
+        jassert (data != nullptr && *data != nullptr); // the input must contain at least one channel!
+
+        if (writeFailed)
+            return false;
+
+        auto bytes = numChannels * (size_t) numSamples * bitsPerSample / 8;
+        tempBlock.ensureSize (bytes, false);
+
+        if (littleEndian)
+            writeSamples<AudioData::LittleEndian> (data, numSamples);
+        else
+            writeSamples<AudioData::BigEndian> (data, numSamples);
+
+        if (! output->write (tempBlock.getData(), bytes))
+        {
+            writeFailed = true;
+            return false;
+        }
+
+        return true;
+    }
+
+private:
+    MemoryBlock tempBlock;
+    const bool littleEndian;
+    bool writeFailed = false;
+
+    template <typename Endianness>
+    void writeSamples (const int** data, int numSamples)
+    {
+        switch (bitsPerSample)
+        {
+            case 8:     WriteHelper<AudioData::UInt8, AudioData::Int32, Endianness>::write (tempBlock.getData(), (int) numChannels, data, numSamples); break;
+            case 16:    WriteHelper<AudioData::Int16, AudioData::Int32, Endianness>::write (tempBlock.getData(), (int) numChannels, data, numSamples); break;
+            case 24:    WriteHelper<AudioData::Int24, AudioData::Int32, Endianness>::write (tempBlock.getData(), (int) numChannels, data, numSamples); break;
+            case 32:    WriteHelper<AudioData::Int32, AudioData::Int32, Endianness>::write (tempBlock.getData(), (int) numChannels, data, numSamples); break;
+            default:    jassertfalse; break;
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RawPCMAudioFormatWriter)
+};
+
+//==============================================================================
+class MemoryMappedRawPCMReader final : public MemoryMappedAudioFormatReader
+{
+public:
+    MemoryMappedRawPCMReader (const File& f, const RawPCMAudioFormatReader& reader)
+        : MemoryMappedAudioFormatReader (f, reader, reader.dataChunkStart,
+                                         reader.dataLength, reader.bytesPerFrame)
+    {
+        dataIsLittleEndian = reader.littleEndian;
+    }
+
+    bool readSamples (int* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                      int64 startSampleInFile, int numSamples) override
+    {
+        clearSamplesBeyondAvailableLength (destSamples, numDestChannels, startOffsetInDestBuffer,
+                                           startSampleInFile, numSamples, lengthInSamples);
+
+        if (numSamples <= 0)
+            return true;
+
+        if (map == nullptr || ! mappedSection.contains (Range<int64> (startSampleInFile, startSampleInFile + numSamples)))
+        {
+            jassertfalse; // you must make sure that the window contains all the samples you're going to attempt to read.
+            return false;
+        }
+
+        RawPCMAudioFormatReader::copySampleData<AudioData::Int32> (dataIsLittleEndian, bitsPerSample, usesFloatingPointData,
+                                                                   destSamples, startOffsetInDestBuffer, numDestChannels,
+                                                                   sampleToPointer (startSampleInFile), (int) numChannels, numSamples);
+        return true;
+    }
+
+    void getSample (int64 sample, float* result) const noexcept override
+    {
+        auto num = (int) numChannels;
+
+        if (map == nullptr || ! mappedSection.contains (sample))
+        {
+            jassertfalse; // you must make sure that the window contains all the samples you're going to attempt to read.
+
+            zeromem (result, (size_t) num * sizeof (float));
+            return;
+        }
+
+        RawPCMAudioFormatReader::copySampleData<AudioData::Float32> (dataIsLittleEndian, bitsPerSample, usesFloatingPointData,
+                                                                     &result, 0, 1, sampleToPointer (sample), 1, num);
+    }
+
+    void readMaxLevels (int64 startSampleInFile, int64 numSamples, Range<float>* results, int numChannelsToRead) override
+    {
+        numSamples = jmin (numSamples, lengthInSamples - startSampleInFile);
+
+        if (map == nullptr || numSamples <= 0 || ! mappedSection.contains (Range<int64> (startSampleInFile, startSampleInFile + numSamples)))
+        {
+            jassert (numSamples <= 0); // you must make sure that the window contains all the samples you're going to attempt to read.
+
+            for (int i = 0; i < numChannelsToRead; ++i)
+                results[i] = {};
+
+            return;
+        }
+
+        switch (bitsPerSample)
+        {
+            case 8:     scanMinAndMax<AudioData::UInt8> (startSampleInFile, numSamples, results, numChannelsToRead); break;
+            case 16:    scanMinAndMax<AudioData::Int16> (startSampleInFile, numSamples, results, numChannelsToRead); break;
+            case 24:    scanMinAndMax<AudioData::Int24> (startSampleInFile, numSamples, results, numChannelsToRead); break;
+            case 32:    if (usesFloatingPointData) scanMinAndMax<AudioData::Float32> (startSampleInFile, numSamples, results, numChannelsToRead);
+                        else                       scanMinAndMax<AudioData::Int32>   (startSampleInFile, numSamples, results, numChannelsToRead);
+                        break;
+            default:    jassertfalse; break;
+        }
+    }
+
+    using AudioFormatReader::readMaxLevels;
+
+private:
+    template <typename SampleType>
+    void scanMinAndMax (int64 startSampleInFile, int64 numSamples, Range<float>* results, int numChannelsToRead) const noexcept
+    {
+        for (int i = 0; i < numChannelsToRead; ++i)
+            results[i] = dataIsLittleEndian ? scanMinAndMaxInterleaved<SampleType, AudioData::LittleEndian> (i, startSampleInFile, numSamples)
+                                            : scanMinAndMaxInterleaved<SampleType, AudioData::BigEndian>    (i, startSampleInFile, numSamples);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MemoryMappedRawPCMReader)
+};
+
+//==============================================================================
+RawPCMAudioFormat::RawPCMAudioFormat (const Layout& layoutToUse)
+    : AudioFormat (rawPCMFormatName, ".raw .pcm"),
+      layout (layoutToUse)
+{
+}
+
+RawPCMAudioFormat::~RawPCMAudioFormat() {}
+
+Array<int> RawPCMAudioFormat::getPossibleSampleRates()
+{
+    return { 8000,  11025, 12000, 16000,  22050,  32000,  44100,
+             48000, 88200, 96000, 176400, 192000, 352800, 384000 };
+}
+
+Array<int> RawPCMAudioFormat::getPossibleBitDepths()
+{
+    return { 8, 16, 24, 32 };
+}
+
+bool RawPCMAudioFormat::canDoStereo()  { return true; }
+bool RawPCMAudioFormat::canDoMono()    { return true; }
+
+AudioFormatReader* RawPCMAudioFormat::createReaderFor (InputStream* sourceStream, bool deleteStreamIfOpeningFails)
+{
+    if (sourceStream != nullptr && layout.isValid())
+    {
+        std::unique_ptr<RawPCMAudioFormatReader> r (new RawPCMAudioFormatReader (sourceStream, layout));
+
+        if (r->lengthInSamples > 0)
+            return r.release();
+
+        if (! deleteStreamIfOpeningFails)
+            r->input = nullptr;
+
+        return nullptr;
+    }
+
+    if (deleteStreamIfOpeningFails)
+        delete sourceStream;
+
+    return nullptr;
+}
+
+MemoryMappedAudioFormatReader* RawPCMAudioFormat::createMemoryMappedReader (const File& file)
+{
+    return createMemoryMappedReader (file.createInputStream().release());
+}
+
+MemoryMappedAudioFormatReader* RawPCMAudioFormat::createMemoryMappedReader (FileInputStream* fin)
+{
+    // Like the other formats, this takes ownership of the stream whether or not it succeeds
+    std::unique_ptr<FileInputStream> stream (fin);
+
+    if (stream != nullptr && layout.isValid())
+    {
+        RawPCMAudioFormatReader reader (stream.release(), layout);
+
+        if (reader.lengthInSamples > 0)
+            return new MemoryMappedRawPCMReader (fin->getFile(), reader);
+    }
+
+    return nullptr;
+}
+
+AudioFormatWriter* RawPCMAudioFormat::createWriterFor (OutputStream* out, double sampleRate,
+                                                       unsigned int numChannels, int bitsPerSample,
+                                                       const StringPairArray&, int)
+{
+    if (out != nullptr && numChannels > 0 && getPossibleBitDepths().contains (bitsPerSample))
+        return new RawPCMAudioFormatWriter (out, sampleRate, numChannels, (unsigned int) bitsPerSample,
+                                            bitsPerSample == 32 && layout.usesFloatingPointData,
+                                            layout.isLittleEndian);
+
+    return nullptr;
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct RawPCMAudioFormatTests final : public UnitTest
+{
+    RawPCMAudioFormatTests()
+        : UnitTest ("Raw PCM audio format tests", UnitTestCategories::audio)
+    {}
+
+    void runTest() override
+    {
+        AudioBuffer<float> source (2, 1000);
+
+        for (int ch = 0; ch < source.getNumChannels(); ++ch)
+            for (int i = 0; i < source.getNumSamples(); ++i)
+                source.setSample (ch, i, (float) std::sin ((i + 1) * (ch + 1) * 0.01) * 0.5f);
+
+        beginTest ("Float data can be read back through a memory-mapped reader");
+        {
+            RawPCMAudioFormat::Layout layout;
+            layout.numChannels = 2;
+            layout.bitsPerSample = 32;
+            layout.usesFloatingPointData = true;
+            layout.isLittleEndian = ! ByteOrder::isBigEndian();
+
+            RawPCMAudioFormat format (layout);
+            TemporaryFile temp (".raw");
+            writeToFile (format, temp.getFile(), source, 32);
+
+            std::unique_ptr<MemoryMappedAudioFormatReader> reader (format.createMemoryMappedReader (temp.getFile()));
+            expect (reader != nullptr);
+            expectEquals (reader->lengthInSamples, (int64) source.getNumSamples());
+            expect (reader->mapEntireFile());
+
+            expectBuffersEqual (readAll (*reader), source, 0.0f);
+
+            beginTest ("Native-format data can be accessed without copying");
+            auto* mapped = reader->getMappedSamplePointer<float> (10);
+            expect (mapped != nullptr);
+
+            if (mapped != nullptr)
+            {
+                expectEquals (mapped[0], source.getSample (0, 10));
+                expectEquals (mapped[1], source.getSample (1, 10));
+                expectEquals (mapped[2], source.getSample (0, 11));
+            }
+
+            expect (reader->getMappedSamplePointer<int16> (10) == nullptr);
+            expect (reader->getMappedSamplePointer<float> (reader->lengthInSamples) == nullptr);
+            expect (reader->getMappedSamplePointer<float> (10, reader->lengthInSamples - 10) == mapped);
+            expect (reader->getMappedSamplePointer<float> (10, reader->lengthInSamples - 9) == nullptr);
+
+            expect (reader->mapSectionOfFile ({ 100, 200 }));
+            expect (reader->getMappedSamplePointer<float> (100, 100) != nullptr);
+            expect (reader->getMappedSamplePointer<float> (150, 51) == nullptr);
+        }
+
+        beginTest ("Big-endian integer data with a header can be read with and without memory-mapping");
+        {
+            RawPCMAudioFormat::Layout layout;
+            layout.numChannels = 2;
+            layout.bitsPerSample = 24;
+            layout.isLittleEndian = false;
+
+            TemporaryFile temp (".raw");
+
+            {
+                RawPCMAudioFormat headerlessFormat (layout);
+                writeToFile (headerlessFormat, temp.getFile(), source, 24);
+            }
+
+            {
+                // prepend a dummy header to the data
+                MemoryBlock data;
+                expect (temp.getFile().loadFileAsData (data));
+                data.insert ("HEADER", 6, 0);
+                expect (temp.getFile().replaceWithData (data.getData(), data.getSize()));
+            }
+
+            layout.headerSize = 6;
+            RawPCMAudioFormat format (layout);
+
+            std::unique_ptr<AudioFormatReader> streamReader (format.createReaderFor (temp.getFile().createInputStream().release(), true));
+            expect (streamReader != nullptr);
+            expectBuffersEqual (readAll (*streamReader), source, 1.0e-6f);
+
+            std::unique_ptr<MemoryMappedAudioFormatReader> mappedReader (format.createMemoryMappedReader (temp.getFile()));
+            expect (mappedReader != nullptr);
+            expect (mappedReader->mapEntireFile());
+            expectBuffersEqual (readAll (*mappedReader), source, 1.0e-6f);
+            expect (mappedReader->getMappedSamplePointer<int32> (0) == nullptr);
+
+            float frame[2];
+            mappedReader->getSample (20, frame);
+            expectWithinAbsoluteError (frame[0], source.getSample (0, 20), 1.0e-6f);
+            expectWithinAbsoluteError (frame[1], source.getSample (1, 20), 1.0e-6f);
+        }
+
+        beginTest ("A memory-mapped reader isn't created for an invalid layout");
+        {
+            RawPCMAudioFormat::Layout layout;
+            layout.numChannels = 0;
+
+            TemporaryFile temp (".raw");
+            expect (temp.getFile().replaceWithText ("data"));
+
+            // The stream is deleted by the format, which the leak detector will check
+            RawPCMAudioFormat format (layout);
+            expect (format.createMemoryMappedReader (temp.getFile()) == nullptr);
+        }
+    }
+
+private:
+    void writeToFile (RawPCMAudioFormat& format, const File& file, const AudioBuffer<float>& buffer, int bitDepth)
+    {
+        std::unique_ptr<AudioFormatWriter> writer (format.createWriterFor (file.createOutputStream().release(),
+                                                                           44100.0, (unsigned int) buffer.getNumChannels(),
+                                                                           bitDepth, {}, 0));
+        expect (writer != nullptr);
+
+        if (writer != nullptr)
+            expect (writer->writeFromAudioSampleBuffer (buffer, 0, buffer.getNumSamples()));
+    }
+
+    static AudioBuffer<float> readAll (AudioFormatReader& reader)
+    {
+        AudioBuffer<float> result ((int) reader.numChannels, (int) reader.lengthInSamples);
+        reader.read (&result, 0, result.getNumSamples(), 0, true, true);
+        return result;
+    }
+
+    void expectBuffersEqual (const AudioBuffer<float>& a, const AudioBuffer<float>& b, float tolerance)
+    {
+        expectEquals (a.getNumChannels(), b.getNumChannels());
+        expectEquals (a.getNumSamples(), b.getNumSamples());
+
+        for (int ch = 0; ch < jmin (a.getNumChannels(), b.getNumChannels()); ++ch)
+            for (int i = 0; i < jmin (a.getNumSamples(), b.getNumSamples()); ++i)
+                expectWithinAbsoluteError (a.getSample (ch, i), b.getSample (ch, i), tolerance);
+    }
+};
+
+static RawPCMAudioFormatTests rawPCMAudioFormatTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,137 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Reads and writes headerless ("raw") PCM audio files.
+
+    Because a raw file contains nothing but sample data, the sample rate, channel
+    count and sample format can't be discovered from the file itself, so you need
+    to describe them with a Layout object when creating the format.
+
+    The format supports memory-mapped reading, which makes it a good choice for
+    streaming very large files that were written by other tools.
+
+    e.g.
+    @code
+    RawPCMAudioFormat::Layout layout;
+    layout.sampleRate = 96000.0;
+    layout.numChannels = 2;
+    layout.bitsPerSample = 32;
+    layout.usesFloatingPointData = true;
+
+    RawPCMAudioFormat format (layout);
+    std::unique_ptr<MemoryMappedAudioFormatReader> reader (format.createMemoryMappedReader (file));
+    @endcode
+
+    @see AudioFormat, MemoryMappedAudioFormatReader
+
+    @tags{Audio}
+*/
+class JUCE_API  RawPCMAudioFormat  : public AudioFormat
+{
+public:
+    //==============================================================================
+    /** Describes how the samples are laid out in a raw PCM file. */
+    struct Layout
+    {
+        /** The sample rate that readers will report. */
+        double sampleRate = 44100.0;
+
+        /** The number of interleaved channels in each frame. */
+        unsigned int numChannels = 2;
+
+        /** The number of bits in each sample: 8, 16, 24 or 32.
+            8-bit data is treated as unsigned, the same way as WAV files.
+        */
+        unsigned int bitsPerSample = 16;
+
+        /** If true, 32-bit samples are treated as IEEE floats rather than integers. */
+        bool usesFloatingPointData = false;
+
+        /** The byte-order of the sample data. */
+        bool isLittleEndian = true;
+
+        /** The number of bytes at the start of the file to skip before the sample data begins. */
+        int64 headerSize = 0;
+
+        /** Returns the number of bytes in each frame of interleaved samples. */
+        int getBytesPerFrame() const noexcept   { return (int) (numChannels * bitsPerSample / 8); }
+
+        /** Returns true if this describes a layout that can be read and written. */
+        bool isValid() const noexcept;
+    };
+
+    //==============================================================================
+    /** Creates a format object that will read and write data using the given layout.
+
+        If the layout isn't valid, createReaderFor() and createMemoryMappedReader() will
+        fail, so it's worth checking Layout::isValid() on layouts that come from a user.
+    */
+    explicit RawPCMAudioFormat (const Layout& layoutToUse);
+
+    /** Destructor. */
+    ~RawPCMAudioFormat() override;
+
+    /** Returns the layout that this format was created with. */
+    const Layout& getLayout() const noexcept    { return layout; }
+
+    //==============================================================================
+    Array<int> getPossibleSampleRates() override;
+    Array<int> getPossibleBitDepths() override;
+    bool canDoStereo() override;
+    bool canDoMono() override;
+
+    //==============================================================================
+    AudioFormatReader* createReaderFor (InputStream* sourceStream,
+                                        bool deleteStreamIfOpeningFails) override;
+
+    MemoryMappedAudioFormatReader* createMemoryMappedReader (const File&)      override;
+    MemoryMappedAudioFormatReader* createMemoryMappedReader (FileInputStream*) override;
+
+    /** Creates a writer that writes raw samples without any header.
+
+        The sample rate, channel count and bit depth passed in are used rather than the ones
+        in the layout, but the byte-order and the usesFloatingPointData flag (for 32-bit
+        data) are taken from the layout.
+    */
+    AudioFormatWriter* createWriterFor (OutputStream* streamToWriteTo,
+                                        double sampleRateToUse,
+                                        unsigned int numberOfChannels,
+                                        int bitsPerSample,
+                                        const StringPairArray& metadataValues,
+                                        int qualityOptionIndex) override;
+    using AudioFormat::createWriterFor;
+
+private:
+    Layout layout;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RawPCMAudioFormat)
+};
+
+} // namespace juce
@@ -1220,9 +1220,9 @@ public:
         auto streamStartPos = input->getPosition();
         auto firstChunkType = input->readInt();
 
-        if (firstChunkType == chunkName ("RF64"))
+        if (firstChunkType == chunkName ("RF64") || firstChunkType == chunkName ("BW64"))
         {
-            input->skipNextBytes (4); // size is -1 for RF64
+            input->skipNextBytes (4); // size is -1 for RF64 and BW64
             isRF64 = true;
         }
         else if (firstChunkType == chunkName ("RIFF"))
@@ -2261,6 +2261,81 @@ struct WaveAudioFormatTests final : public UnitTest
                 expect (reader->metadataValues.getValue (WavAudioFormat::aswgVersion, "") == "3.01");
             }
         }
+
+        {
+            beginTest ("BW64 files can be read with and without memory-mapping");
+
+            AudioBuffer<float> buffer (numTestAudioBufferChannels, numTestAudioBufferSamples);
+
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    buffer.setSample (ch, i, (float) std::sin ((i + 1) * (ch + 1) * 0.05) * 0.5f);
+
+            TemporaryFile temp (".wav");
+
+            {
+                auto writer = rawToUniquePtr (format.createWriterFor (temp.getFile().createOutputStream().release(), 44100.0,
+                                                                      (unsigned int) buffer.getNumChannels(), 32, {}, 0));
+                expect (writer != nullptr);
+
+                if (writer != nullptr)
+                    expect (writer->writeFromAudioSampleBuffer (buffer, 0, buffer.getNumSamples()));
+            }
+
+            {
+                // The writer leaves room for a ds64 chunk after the WAVE tag, so the
+                // header can be turned into a BW64 one in place
+                MemoryBlock data;
+                expect (temp.getFile().loadFileAsData (data));
+                expect (memcmp (data.begin() + 12, "JUNK", 4) == 0);
+
+                auto setInt64 = [&data] (int offset, int64 value)
+                {
+                    value = (int64) ByteOrder::swapIfBigEndian ((uint64) value);
+                    data.copyFrom (&value, offset, sizeof (value));
+                };
+
+                data.copyFrom ("BW64", 0, 4);
+                data.copyFrom ("\xff\xff\xff\xff", 4, 4); // (the RIFF size is -1, as it's in the ds64 chunk)
+                data.copyFrom ("ds64", 12, 4);
+                setInt64 (20, (int64) data.getSize() - 8);
+                setInt64 (28, (int64) (buffer.getNumChannels() * buffer.getNumSamples()) * 4);
+                setInt64 (36, buffer.getNumSamples());
+                expect (temp.getFile().replaceWithData (data.getData(), data.getSize()));
+            }
+
+            auto streamReader = rawToUniquePtr (format.createReaderFor (temp.getFile().createInputStream().release(), true));
+            auto mappedReader = rawToUniquePtr (format.createMemoryMappedReader (temp.getFile()));
+            expect (streamReader != nullptr);
+            expect (mappedReader != nullptr);
+
+            if (streamReader != nullptr && mappedReader != nullptr)
+            {
+                const auto numSamples = buffer.getNumSamples();
+                expectEquals (streamReader->lengthInSamples, (int64) numSamples);
+                expectEquals (mappedReader->lengthInSamples, (int64) numSamples);
+                expect (mappedReader->mapEntireFile());
+
+                AudioBuffer<float> streamed (buffer.getNumChannels(), numSamples), mapped (buffer.getNumChannels(), numSamples);
+                expect (streamReader->read (&streamed, 0, numSamples, 0, true, true));
+                expect (mappedReader->read (&mapped, 0, numSamples, 0, true, true));
+
+                auto* direct = mappedReader->getMappedSamplePointer<float> (0, numSamples);
+                expect (direct != nullptr);
+
+                for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                {
+                    for (int i = 0; i < numSamples; ++i)
+                    {
+                        expectEquals (streamed.getSample (ch, i), buffer.getSample (ch, i));
+                        expectEquals (mapped.getSample (ch, i), streamed.getSample (ch, i));
+
+                        if (direct != nullptr)
+                            expectEquals (direct[i * buffer.getNumChannels() + ch], streamed.getSample (ch, i));
+                    }
+                }
+            }
+        }
     }
 
 private:
@@ -81,6 +81,54 @@ public:
     /** Returns the number of bytes currently being mapped */
     size_t getNumBytesUsed() const                          { return map != nullptr ? map->getSize() : 0; }
 
+    /** Returns the number of bytes used by each frame (i.e. one sample for every channel) in the file. */
+    int getBytesPerFrame() const noexcept                   { return bytesPerFrame; }
+
+    /** Returns true if the data in the file is stored in little-endian byte order. */
+    bool isDataLittleEndian() const noexcept                { return dataIsLittleEndian; }
+
+    /** Returns a pointer directly into the mapped file memory for a run of samples,
+        without doing any copying or conversion.
+
+        This only succeeds if the samples in the file are already stored as interleaved,
+        native-endian values of the requested type, i.e. SampleType must be float, int32
+        or int16, and must match the bit-depth, number format and byte order of the file.
+        The pointer that is returned points at the first channel of the frame at
+        sampleIndex, and successive frames are numChannels values apart.
+
+        If the format doesn't match, if any of the numSamples frames starting at sampleIndex
+        lie outside the mapped section, or if the mapped data isn't suitably aligned for
+        SampleType, this will return nullptr, in which case you should fall back to using
+        read() or getSample().
+
+        @code
+        if (auto* data = reader->getMappedSamplePointer<float> (startSample, numSamples))
+            for (int i = 0; i < numSamples; ++i)
+                doSomething (data[i * (int) reader->numChannels + channel]);
+        @endcode
+    */
+    template <typename SampleType>
+    const SampleType* getMappedSamplePointer (int64 sampleIndex, int64 numSamples = 1) const noexcept
+    {
+        static_assert (std::is_same_v<SampleType, float> || std::is_same_v<SampleType, int32> || std::is_same_v<SampleType, int16>,
+                       "getMappedSamplePointer only supports float, int32 and int16 sample types");
+
+        if (map == nullptr || numSamples <= 0
+             || ! mappedSection.contains (Range<int64> (sampleIndex, sampleIndex + numSamples))
+             || bitsPerSample != sizeof (SampleType) * 8
+             || usesFloatingPointData != std::is_floating_point_v<SampleType>
+             || bytesPerFrame != (int) (numChannels * sizeof (SampleType))
+             || dataIsLittleEndian == ByteOrder::isBigEndian())
+            return nullptr;
+
+        auto* data = sampleToPointer (sampleIndex);
+
+        if (((pointer_sized_uint) data % alignof (SampleType)) != 0)
+            return nullptr;
+
+        return static_cast<const SampleType*> (data);
+    }
+
 protected:
     File file;
     Range<int64> mappedSection;
@@ -88,6 +136,9 @@ protected:
     int64 dataChunkStart, dataLength;
     int bytesPerFrame;
 
+    /** Subclasses should set this to false if their sample data is stored in big-endian order. */
+    bool dataIsLittleEndian = true;
+
     /** Converts a sample index to a byte position in the file. */
     inline int64 sampleToFilePos (int64 sample) const noexcept       { return dataChunkStart + sample * bytesPerFrame; }
 
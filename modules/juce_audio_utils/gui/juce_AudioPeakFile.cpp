@@ -0,0 +1,998 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+/*  File layout (all values are little-endian):
+
+    Two header slots of headerSlotSize bytes each, containing:
+
+    "jpkf"                          magic number
+    int32                           version
+    int64                           generation, which goes up by one each time a header is written
+    int32                           number of channels
+    int32                           number of levels
+    int32                           source samples per peak in level 0
+    int32                           level ratio
+    double                          source sample rate
+    int64                           number of source samples
+    int64                           hash code of the source
+    numLevels * { int64, int64, int64 }   offset, capacity and number of peaks for each level
+    uint32                          checksum of all the header bytes before it
+
+    followed by the levels. Each level is an array of 'capacity' peaks, and each peak
+    contains an { int16 min, int16 max, uint16 rms } entry for every channel.
+
+    Readers may have the file mapped while it's being written, so it never shrinks
+    and existing peaks are never moved. When a level runs out of space, a bigger copy
+    of all the levels is appended to the file and the header is pointed at it.
+
+    The writer alternates between the two header slots, so while one of them is being
+    rewritten the other still holds the previous complete header. Readers use the
+    checksums to ignore a slot that's only partly written, and take the valid one with
+    the highest generation.
+*/
+namespace PeakFileHelpers
+{
+    constexpr int version = 3;
+    constexpr int fixedHeaderSize = 56;
+    constexpr int levelHeaderSize = 24;
+    constexpr int checksumSize = 4;
+    constexpr int maxNumLevels = 32;
+    constexpr int headerSlotSize = fixedHeaderSize + levelHeaderSize * maxNumLevels + checksumSize;
+    constexpr int64 dataStart = 2 * headerSlotSize;
+    constexpr int bytesPerChannelEntry = 6;
+    constexpr int defaultInitialCapacity = 1024;
+
+    static int getMagicNumber() noexcept        { return (int) ByteOrder::littleEndianInt ("jpkf"); }
+
+    static int64 getHeaderSize (int numLevels) noexcept
+    {
+        return fixedHeaderSize + (int64) levelHeaderSize * numLevels + checksumSize;
+    }
+
+    static uint32 getChecksum (const void* data, size_t numBytes) noexcept
+    {
+        // 32-bit FNV-1a
+        uint32 hash = 2166136261u;
+
+        for (size_t i = 0; i < numBytes; ++i)
+            hash = (hash ^ static_cast<const uint8*> (data)[i]) * 16777619u;
+
+        return hash;
+    }
+
+    // Returns the generation of a header slot, or -1 if it doesn't hold a complete header
+    static int64 getGeneration (const void* slot) noexcept
+    {
+        if ((int) ByteOrder::littleEndianInt (slot) != getMagicNumber()
+             || (int) ByteOrder::littleEndianInt (addBytesToPointer (slot, 4)) != version)
+            return -1;
+
+        const auto numLevels = (int) ByteOrder::littleEndianInt (addBytesToPointer (slot, 20));
+
+        if (numLevels <= 0 || numLevels > maxNumLevels)
+            return -1;
+
+        const auto checksumOffset = (size_t) getHeaderSize (numLevels) - checksumSize;
+
+        if (getChecksum (slot, checksumOffset) != ByteOrder::littleEndianInt (addBytesToPointer (slot, checksumOffset)))
+            return -1;
+
+        return (int64) ByteOrder::littleEndianInt64 (addBytesToPointer (slot, 8));
+    }
+
+    static int64 divideRoundingUp (int64 a, int64 b) noexcept
+    {
+        return (a + b - 1) / b;
+    }
+
+    static int16 floatToInt16 (float value) noexcept
+    {
+        return (int16) jlimit (-32767, 32767, roundToInt (value * 32767.0f));
+    }
+
+    static void writeUInt16 (uint8* dest, uint16 value) noexcept
+    {
+        dest[0] = (uint8) (value & 0xff);
+        dest[1] = (uint8) (value >> 8);
+    }
+}
+
+//==============================================================================
+struct AudioPeakFile::Writer::Accumulator
+{
+    float minimum = std::numeric_limits<float>::max();
+    float maximum = std::numeric_limits<float>::lowest();
+    double sumOfSquares = 0;
+
+    void add (const Accumulator& other) noexcept
+    {
+        minimum = jmin (minimum, other.minimum);
+        maximum = jmax (maximum, other.maximum);
+        sumOfSquares += other.sumOfSquares;
+    }
+
+    void writeEntry (uint8* dest, int64 numSourceSamples) const noexcept
+    {
+        using namespace PeakFileHelpers;
+
+        const auto hasData = numSourceSamples > 0 && minimum <= maximum;
+        const auto rms = hasData ? (float) std::sqrt (sumOfSquares / (double) numSourceSamples) : 0.0f;
+
+        writeUInt16 (dest,     (uint16) floatToInt16 (hasData ? minimum : 0.0f));
+        writeUInt16 (dest + 2, (uint16) floatToInt16 (hasData ? maximum : 0.0f));
+        writeUInt16 (dest + 4, (uint16) floatToInt16 (jmin (rms, 1.0f)));
+    }
+};
+
+struct AudioPeakFile::Writer::Level
+{
+    int64 samplesPerPeak = 0, dataOffset = 0, capacity = 0;
+    int64 numWritten = 0, samplesInCurrentPeak = 0;
+    MemoryBlock pending;
+};
+
+//==============================================================================
+AudioPeakFile::Writer::Writer (const File& peakFile, int samplesPerPeakToUse)
+    : file (peakFile), samplesPerPeak (samplesPerPeakToUse)
+{
+    jassert (samplesPerPeak > 0);
+}
+
+AudioPeakFile::Writer::~Writer()
+{
+    flush();
+}
+
+int AudioPeakFile::Writer::getEntrySize() const noexcept
+{
+    return numChannels * PeakFileHelpers::bytesPerChannelEntry;
+}
+
+void AudioPeakFile::Writer::reset (int newNumChannels, double newSampleRate, int64 totalSamplesInSource)
+{
+    using namespace PeakFileHelpers;
+
+    numChannels = jmax (0, newNumChannels);
+    sampleRate = newSampleRate;
+    numSamples = numSamplesAtLastFlush = fileSize = headerGeneration = 0;
+    writeFailed = false;
+    output.reset();
+
+    levels.clear();
+    levels.resize (defaultNumLevels);
+    accumulators.clear();
+    accumulators.resize ((size_t) (defaultNumLevels * numChannels));
+
+    auto capacity = totalSamplesInSource > 0 ? divideRoundingUp (totalSamplesInSource, samplesPerPeak)
+                                             : (int64) defaultInitialCapacity;
+
+    for (size_t i = 0; i < levels.size(); ++i)
+    {
+        auto& level = levels[i];
+        level.samplesPerPeak = i == 0 ? samplesPerPeak : levels[i - 1].samplesPerPeak * levelRatio;
+        level.capacity = jmax ((int64) 1, divideRoundingUp (capacity * samplesPerPeak, level.samplesPerPeak));
+    }
+
+    if (numChannels == 0 || ! createFile())
+    {
+        output.reset();
+        writeFailed = true;
+    }
+}
+
+bool AudioPeakFile::Writer::createFile()
+{
+    // The new file is written alongside the old one and then moved over it, so anyone
+    // who still has the old file mapped keeps a complete copy rather than a truncated one
+    TemporaryFile temp (file);
+
+    {
+        FileOutputStream out (temp.getFile());
+
+        if (out.failedToOpen()
+             || ! writeLayout (out, PeakFileHelpers::dataStart, nullptr)
+             || ! writeHeader (out))
+            return false;
+
+        out.flush();
+
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    if (! temp.overwriteTargetFileWithTemporary())
+        return false;
+
+    output = std::make_unique<FileOutputStream> (file);
+    return ! output->failedToOpen();
+}
+
+void AudioPeakFile::Writer::addBlock (int64 sampleNumberInSource, const AudioBuffer<float>& newData,
+                                      int startOffsetInBuffer, int numSamplesToAdd)
+{
+    // The blocks must be added in order, starting at zero!
+    jassert (sampleNumberInSource == numSamples);
+    ignoreUnused (sampleNumberInSource);
+
+    if (output == nullptr || writeFailed)
+        return;
+
+    const auto numChannelsToRead = jmin (numChannels, newData.getNumChannels());
+
+    while (numSamplesToAdd > 0)
+    {
+        auto& level = levels.front();
+        auto numThisTime = (int) jmin ((int64) numSamplesToAdd, level.samplesPerPeak - level.samplesInCurrentPeak);
+
+        for (int i = 0; i < numChannels; ++i)
+        {
+            Accumulator block;
+
+            if (i < numChannelsToRead)
+            {
+                auto* data = newData.getReadPointer (i, startOffsetInBuffer);
+                auto range = FloatVectorOperations::findMinAndMax (data, numThisTime);
+
+                block.minimum = range.getStart();
+                block.maximum = range.getEnd();
+
+                for (int j = 0; j < numThisTime; ++j)
+                    block.sumOfSquares += (double) (data[j] * data[j]);
+            }
+            else
+            {
+                block.minimum = block.maximum = 0.0f;
+            }
+
+            addToLevel (0, i, block);
+        }
+
+        level.samplesInCurrentPeak += numThisTime;
+        numSamples += numThisTime;
+        startOffsetInBuffer += numThisTime;
+        numSamplesToAdd -= numThisTime;
+
+        if (level.samplesInCurrentPeak == level.samplesPerPeak)
+            finishPeak (0);
+    }
+
+    // Keep the file reasonably up-to-date for anyone reading it while we're recording
+    if (numSamples - numSamplesAtLastFlush >= (int64) samplesPerPeak * 512)
+        flush();
+}
+
+void AudioPeakFile::Writer::addToLevel (int level, int channel, const Accumulator& values)
+{
+    accumulators[(size_t) (level * numChannels + channel)].add (values);
+}
+
+void AudioPeakFile::Writer::finishPeak (int levelIndex)
+{
+    auto& level = levels[(size_t) levelIndex];
+    const auto entrySize = (size_t) getEntrySize();
+    const auto pendingSize = level.pending.getSize();
+
+    level.pending.setSize (pendingSize + entrySize);
+    auto* entry = static_cast<uint8*> (level.pending.getData()) + pendingSize;
+
+    const auto hasNextLevel = (size_t) levelIndex + 1 < levels.size();
+
+    for (int i = 0; i < numChannels; ++i)
+    {
+        auto& acc = accumulators[(size_t) (levelIndex * numChannels + i)];
+        acc.writeEntry (entry + i * PeakFileHelpers::bytesPerChannelEntry, level.samplesInCurrentPeak);
+
+        if (hasNextLevel)
+            addToLevel (levelIndex + 1, i, acc);
+
+        acc = {};
+    }
+
+    if (hasNextLevel)
+    {
+        auto& nextLevel = levels[(size_t) levelIndex + 1];
+        nextLevel.samplesInCurrentPeak += level.samplesInCurrentPeak;
+        level.samplesInCurrentPeak = 0;
+
+        if (nextLevel.samplesInCurrentPeak == nextLevel.samplesPerPeak)
+            finishPeak (levelIndex + 1);
+    }
+    else
+    {
+        level.samplesInCurrentPeak = 0;
+    }
+}
+
+bool AudioPeakFile::Writer::flush()
+{
+    using namespace PeakFileHelpers;
+
+    if (output == nullptr || writeFailed)
+        return false;
+
+    if (! ensureCapacity())
+    {
+        writeFailed = true;
+        return false;
+    }
+
+    const auto entrySize = getEntrySize();
+    HeapBlock<uint8> partialEntry ((size_t) entrySize, true);
+
+    // The partial peak of each level also has to include the partial peaks of the levels below it
+    std::vector<Accumulator> carried ((size_t) numChannels);
+    int64 carriedSamples = 0;
+
+    for (size_t i = 0; i < levels.size(); ++i)
+    {
+        auto& level = levels[i];
+
+        if (level.pending.getSize() > 0)
+        {
+            if (! (output->setPosition (level.dataOffset + level.numWritten * entrySize)
+                    && output->write (level.pending.getData(), level.pending.getSize())))
+            {
+                writeFailed = true;
+                return false;
+            }
+
+            level.numWritten += (int64) level.pending.getSize() / entrySize;
+            level.pending.reset();
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            carried[(size_t) ch].add (accumulators[i * (size_t) numChannels + (size_t) ch]);
+
+        carriedSamples += level.samplesInCurrentPeak;
+
+        if (carriedSamples > 0)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                carried[(size_t) ch].writeEntry (partialEntry + ch * bytesPerChannelEntry, carriedSamples);
+
+            if (! (output->setPosition (level.dataOffset + level.numWritten * entrySize)
+                    && output->write (partialEntry, (size_t) entrySize)))
+            {
+                writeFailed = true;
+                return false;
+            }
+        }
+    }
+
+    if (! writeHeader (*output))
+    {
+        writeFailed = true;
+        return false;
+    }
+
+    output->flush();
+    numSamplesAtLastFlush = numSamples;
+    return true;
+}
+
+bool AudioPeakFile::Writer::ensureCapacity()
+{
+    using namespace PeakFileHelpers;
+
+    bool needsToGrow = false;
+
+    for (auto& level : levels)
+        needsToGrow = needsToGrow || divideRoundingUp (numSamples, level.samplesPerPeak) > level.capacity;
+
+    if (! needsToGrow)
+        return true;
+
+    // Double the space for each level, and append a copy of the existing data in the new
+    // layout. The old copy stays where it is until the header stops referring to it.
+    output->flush();
+
+    FileInputStream oldContents (file);
+
+    if (oldContents.failedToOpen())
+        return false;
+
+    for (auto& level : levels)
+        level.capacity = jmax (level.capacity * 2, divideRoundingUp (numSamples, level.samplesPerPeak));
+
+    return writeLayout (*output, fileSize, &oldContents);
+}
+
+bool AudioPeakFile::Writer::writeLayout (OutputStream& out, int64 startOffset, InputStream* oldContents)
+{
+    const auto entrySize = getEntrySize();
+    auto offset = startOffset;
+
+    if (! out.setPosition (startOffset))
+        return false;
+
+    for (auto& level : levels)
+    {
+        const auto bytesToCopy = level.numWritten * entrySize;
+
+        if (bytesToCopy > 0)
+        {
+            if (oldContents == nullptr
+                 || ! oldContents->setPosition (level.dataOffset)
+                 || out.writeFromInputStream (*oldContents, bytesToCopy) != bytesToCopy)
+                return false;
+        }
+
+        if (! out.writeRepeatedByte (0, (size_t) (level.capacity * entrySize - bytesToCopy)))
+            return false;
+
+        level.dataOffset = offset;
+        offset += level.capacity * entrySize;
+    }
+
+    fileSize = offset;
+    return true;
+}
+
+bool AudioPeakFile::Writer::writeHeader (OutputStream& out)
+{
+    using namespace PeakFileHelpers;
+
+    MemoryOutputStream header;
+    header.writeInt (getMagicNumber());
+    header.writeInt (version);
+    header.writeInt64 (++headerGeneration);
+    header.writeInt (numChannels);
+    header.writeInt ((int) levels.size());
+    header.writeInt (samplesPerPeak);
+    header.writeInt (levelRatio);
+    header.writeDouble (sampleRate);
+    header.writeInt64 (numSamples);
+    header.writeInt64 (sourceHash);
+
+    for (auto& level : levels)
+    {
+        header.writeInt64 (level.dataOffset);
+        header.writeInt64 (level.capacity);
+        header.writeInt64 (jmin (level.capacity, divideRoundingUp (numSamples, level.samplesPerPeak)));
+    }
+
+    header.writeInt ((int) getChecksum (header.getData(), header.getDataSize()));
+
+    jassert ((int64) header.getDataSize() == getHeaderSize ((int) levels.size()));
+
+    return out.setPosition ((headerGeneration % 2) * headerSlotSize)
+        && out.write (header.getData(), header.getDataSize());
+}
+
+//==============================================================================
+AudioPeakFile::AudioPeakFile (const File& peakFile)  : file (peakFile)
+{
+    refresh();
+}
+
+AudioPeakFile::~AudioPeakFile() = default;
+
+bool AudioPeakFile::refresh()
+{
+    map.reset();
+    map = std::make_unique<MemoryMappedFile> (file, MemoryMappedFile::readOnly);
+
+    if (map->getData() != nullptr && readHeader())
+        return true;
+
+    map.reset();
+    levels.clear();
+    numChannels = 0;
+    sampleRate = 0;
+    numSamples = sourceHash = 0;
+    return false;
+}
+
+bool AudioPeakFile::readHeader()
+{
+    using namespace PeakFileHelpers;
+
+    const auto fileSize = (int64) map->getSize();
+
+    if (fileSize < dataStart)
+        return false;
+
+    // Take a copy of the headers, so that they can't change between being checked and used
+    const MemoryBlock headers (map->getData(), (size_t) dataStart);
+    const int64 generations[] { getGeneration (headers.getData()),
+                                getGeneration (addBytesToPointer (headers.getData(), headerSlotSize)) };
+
+    const auto newest = generations[1] > generations[0] ? 1 : 0;
+
+    for (auto slot : { newest, 1 - newest })
+        if (generations[slot] >= 0 && readHeader (addBytesToPointer (headers.getData(), slot * headerSlotSize), fileSize))
+            return true;
+
+    return false;
+}
+
+bool AudioPeakFile::readHeader (const void* slot, int64 fileSize)
+{
+    using namespace PeakFileHelpers;
+
+    MemoryInputStream in (slot, (size_t) headerSlotSize, false);
+    in.skipNextBytes (16);
+
+    numChannels = in.readInt();
+    const auto numLevels = in.readInt();
+    auto samplesPerPeak = (int64) in.readInt();
+    auto ratio = (int64) in.readInt();
+    sampleRate = in.readDouble();
+    numSamples = in.readInt64();
+    sourceHash = in.readInt64();
+
+    if (numChannels <= 0 || samplesPerPeak <= 0 || ratio <= 1 || numSamples < 0)
+        return false;
+
+    const auto entrySize = (int64) numChannels * bytesPerChannelEntry;
+    levels.clear();
+
+    for (int i = 0; i < numLevels; ++i)
+    {
+        LevelInfo info;
+        info.dataOffset = in.readInt64();
+        auto capacity = in.readInt64();
+        info.numPeaks = in.readInt64();
+        info.samplesPerPeak = samplesPerPeak;
+
+        if (info.dataOffset < dataStart || info.numPeaks < 0 || info.numPeaks > capacity
+             || info.dataOffset + info.numPeaks * entrySize > fileSize)
+            return false;
+
+        levels.push_back (info);
+
+        if (samplesPerPeak > std::numeric_limits<int64>::max() / ratio)
+            break;
+
+        samplesPerPeak *= ratio;
+    }
+
+    return true;
+}
+
+int64 AudioPeakFile::getSamplesPerPeak (int level) const noexcept
+{
+    return isPositiveAndBelow (level, getNumLevels()) ? levels[(size_t) level].samplesPerPeak : 0;
+}
+
+int64 AudioPeakFile::getNumPeaks (int level) const noexcept
+{
+    return isPositiveAndBelow (level, getNumLevels()) ? levels[(size_t) level].numPeaks : 0;
+}
+
+const uint8* AudioPeakFile::getEntry (int level, int channel, int64 peakIndex) const noexcept
+{
+    auto& info = levels[(size_t) level];
+    return static_cast<const uint8*> (map->getData()) + info.dataOffset
+             + (peakIndex * numChannels + channel) * PeakFileHelpers::bytesPerChannelEntry;
+}
+
+AudioPeakFile::Peak AudioPeakFile::getPeak (int level, int channel, int64 peakIndex) const noexcept
+{
+    if (! (isValid() && isPositiveAndBelow (channel, numChannels) && isPositiveAndBelow (peakIndex, getNumPeaks (level))))
+    {
+        jassertfalse;
+        return {};
+    }
+
+    auto* entry = getEntry (level, channel, peakIndex);
+
+    return { (float) (int16) ByteOrder::littleEndianShort (entry)     / 32767.0f,
+             (float) (int16) ByteOrder::littleEndianShort (entry + 2) / 32767.0f,
+             (float) (int16) ByteOrder::littleEndianShort (entry + 4) / 32767.0f };
+}
+
+struct AudioPeakFile::RangeSummary
+{
+    Peak peak { std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest(), 0.0f };
+    double sumOfSquares = 0, numSamples = 0;
+
+    void add (Peak p, int64 numSamplesInPeak) noexcept
+    {
+        peak.minimum = jmin (peak.minimum, p.minimum);
+        peak.maximum = jmax (peak.maximum, p.maximum);
+        sumOfSquares += (double) (p.rms * p.rms) * (double) numSamplesInPeak;
+        numSamples += (double) numSamplesInPeak;
+    }
+};
+
+void AudioPeakFile::addToSummary (RangeSummary& summary, int level, int channel, int64 start, int64 end) const noexcept
+{
+    if (end <= start)
+        return;
+
+    auto& info = levels[(size_t) level];
+    const auto size = info.samplesPerPeak;
+
+    // The peaks that lie completely inside the range. The last peak of the file only
+    // covers the samples up to the end, so it counts as inside if the range reaches it.
+    auto first = PeakFileHelpers::divideRoundingUp (start, size);
+    auto last = end >= numSamples ? PeakFileHelpers::divideRoundingUp (numSamples, size) : end / size;
+
+    if (level == 0)
+    {
+        // This is as fine as the peaks go, so take in the ones that the range only partly covers
+        first = start / size;
+        last = PeakFileHelpers::divideRoundingUp (end, size);
+    }
+    else if (first >= last)
+    {
+        addToSummary (summary, level - 1, channel, start, end);
+        return;
+    }
+    else
+    {
+        addToSummary (summary, level - 1, channel, start, first * size);
+        addToSummary (summary, level - 1, channel, last * size, end);
+    }
+
+    for (auto i = first; i < jmin (last, info.numPeaks); ++i)
+    {
+        const auto covered = jmin (end, (i + 1) * size, numSamples) - jmax (start, i * size);
+        summary.add (getPeak (level, channel, i), covered);
+    }
+}
+
+AudioPeakFile::Peak AudioPeakFile::getPeakForRange (int channel, int64 startSample, int64 numSamplesInRange) const noexcept
+{
+    const auto start = jmax ((int64) 0, startSample);
+    const auto end = jmin (startSample + numSamplesInRange, numSamples);
+
+    if (! isValid() || ! isPositiveAndBelow (channel, numChannels) || end <= start)
+        return {};
+
+    // Start from the coarsest level whose peaks could fit inside the range
+    int level = 0;
+
+    while (level + 1 < getNumLevels() && levels[(size_t) level + 1].samplesPerPeak <= end - start)
+        ++level;
+
+    RangeSummary summary;
+    addToSummary (summary, level, channel, start, end);
+
+    if (summary.numSamples <= 0)
+        return {};
+
+    summary.peak.rms = (float) std::sqrt (summary.sumOfSquares / summary.numSamples);
+    return summary.peak;
+}
+
+//==============================================================================
+File AudioPeakFile::getPeakFileFor (const File& audioFile)
+{
+    return audioFile.getSiblingFile (audioFile.getFileName() + ".peaks");
+}
+
+bool AudioPeakFile::createFrom (AudioFormatReader& reader, const File& peakFile, int64 sourceHash, int samplesPerPeak)
+{
+    Writer writer (peakFile, samplesPerPeak);
+    writer.reset ((int) reader.numChannels, reader.sampleRate, reader.lengthInSamples);
+    writer.setSourceHash (sourceHash);
+
+    AudioBuffer<float> buffer ((int) reader.numChannels, samplesPerPeak * 256);
+
+    for (int64 pos = 0; pos < reader.lengthInSamples;)
+    {
+        auto numThisTime = (int) jmin ((int64) buffer.getNumSamples(), reader.lengthInSamples - pos);
+
+        if (! reader.read (&buffer, 0, numThisTime, pos, true, true))
+            return false;
+
+        writer.addBlock (pos, buffer, 0, numThisTime);
+        pos += numThisTime;
+    }
+
+    return writer.flush();
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AudioPeakFileTests final : public UnitTest
+{
+public:
+    AudioPeakFileTests()
+        : UnitTest ("AudioPeakFile", UnitTestCategories::audio)
+    {}
+
+    void runTest() override
+    {
+        constexpr int samplesPerPeak = 64;
+        const auto signal = createSignal (2, 300000);
+
+        beginTest ("Peaks match the source audio at every level");
+        {
+            TemporaryFile temp (".peaks");
+
+            {
+                AudioPeakFile::Writer writer (temp.getFile(), samplesPerPeak);
+                writer.reset (signal.getNumChannels(), 48000.0, 0);
+                addInBlocks (writer, signal, 0, signal.getNumSamples());
+            }
+
+            AudioPeakFile peaks (temp.getFile());
+            expect (peaks.isValid());
+            expectEquals (peaks.getNumChannels(), signal.getNumChannels());
+            expectEquals (peaks.getNumSamples(), (int64) signal.getNumSamples());
+            expectEquals (peaks.getSampleRate(), 48000.0);
+            expectEquals (peaks.getSamplesPerPeak (0), (int64) samplesPerPeak);
+
+            for (int level = 0; level < peaks.getNumLevels(); ++level)
+            {
+                auto size = peaks.getSamplesPerPeak (level);
+                expectEquals (peaks.getNumPeaks (level), (signal.getNumSamples() + size - 1) / size);
+
+                for (int64 start = 0; start + size <= signal.getNumSamples(); start += size * 7)
+                    for (int ch = 0; ch < signal.getNumChannels(); ++ch)
+                        expectPeakMatches (peaks.getPeakForRange (ch, start, size), signal, ch, (int) start, (int) size);
+            }
+
+            beginTest ("Partial peaks at the end of the file are stored");
+            auto lastStart = signal.getNumSamples() - signal.getNumSamples() % samplesPerPeak;
+            expectPeakMatches (peaks.getPeakForRange (0, lastStart, samplesPerPeak),
+                               signal, 0, (int) lastStart, signal.getNumSamples() - (int) lastStart);
+
+            beginTest ("Ranges that don't line up with the coarser levels are summarised exactly");
+            Random r (42);
+
+            for (int i = 0; i < 200; ++i)
+            {
+                const auto numPeaks = signal.getNumSamples() / samplesPerPeak;
+                const auto start = r.nextInt (numPeaks) * samplesPerPeak;
+                const auto num = jmin ((1 + r.nextInt (2000)) * samplesPerPeak, signal.getNumSamples() - start);
+                const auto ch = r.nextInt (signal.getNumChannels());
+
+                expectPeakMatches (peaks.getPeakForRange (ch, start, num), signal, ch, start, num);
+            }
+
+            beginTest ("Ranges that don't line up with any level only reach into the finest peaks at their ends");
+
+            for (int i = 0; i < 200; ++i)
+            {
+                const auto start = r.nextInt (signal.getNumSamples() - 1);
+                const auto end = jmin (start + 1 + r.nextInt (100000), signal.getNumSamples());
+                const auto outerStart = start - start % samplesPerPeak;
+                const auto outerEnd = jmin (end + (samplesPerPeak - end % samplesPerPeak) % samplesPerPeak, signal.getNumSamples());
+
+                const auto peak = peaks.getPeakForRange (0, start, end - start);
+                const auto inner = FloatVectorOperations::findMinAndMax (signal.getReadPointer (0, start), end - start);
+                const auto outer = FloatVectorOperations::findMinAndMax (signal.getReadPointer (0, outerStart), outerEnd - outerStart);
+
+                expect (peak.minimum <= inner.getStart() + 1.0e-4f && peak.minimum >= outer.getStart() - 1.0e-4f);
+                expect (peak.maximum >= inner.getEnd() - 1.0e-4f && peak.maximum <= outer.getEnd() + 1.0e-4f);
+            }
+        }
+
+        beginTest ("A reader can follow a file that's still being written");
+        {
+            TemporaryFile temp (".peaks");
+            AudioPeakFile::Writer writer (temp.getFile(), samplesPerPeak);
+            writer.reset (signal.getNumChannels(), 44100.0, 0);
+
+            addInBlocks (writer, signal, 0, 100000);
+            expect (writer.flush());
+
+            AudioPeakFile peaks (temp.getFile());
+            expect (peaks.isValid());
+            expectEquals (peaks.getNumSamples(), (int64) 100000);
+
+            addInBlocks (writer, signal, 100000, signal.getNumSamples() - 100000);
+            expect (writer.flush());
+
+            expect (peaks.refresh());
+            expectEquals (peaks.getNumSamples(), (int64) signal.getNumSamples());
+            expectPeakMatches (peaks.getPeakForRange (1, 256000, samplesPerPeak * 16), signal, 1, 256000, samplesPerPeak * 16);
+        }
+
+        beginTest ("Peak files can be created from a reader and loaded into a thumbnail");
+        {
+            TemporaryFile temp (".peaks");
+            AudioBufferSource reader (signal);
+            expect (AudioPeakFile::createFrom (reader, temp.getFile(), 1234));
+
+            AudioFormatManager manager;
+            AudioThumbnailCache cache (1);
+            AudioThumbnail thumbnail (512, manager, cache);
+
+            expect (thumbnail.loadFrom (AudioPeakFile (temp.getFile())));
+            expectEquals (thumbnail.getNumChannels(), signal.getNumChannels());
+            expect (thumbnail.isFullyLoaded());
+            expectEquals (thumbnail.getTotalLength(), signal.getNumSamples() / 44100.0);
+
+            float minValue = 0, maxValue = 0;
+            thumbnail.getApproximateMinMax (0.0, thumbnail.getTotalLength(), 0, minValue, maxValue);
+            auto range = FloatVectorOperations::findMinAndMax (signal.getReadPointer (0), signal.getNumSamples());
+            expectWithinAbsoluteError (minValue, range.getStart(), 0.02f);
+            expectWithinAbsoluteError (maxValue, range.getEnd(), 0.02f);
+        }
+
+        beginTest ("Growing a file doesn't disturb a reader that has it mapped");
+        {
+            TemporaryFile temp (".peaks");
+            AudioPeakFile::Writer writer (temp.getFile(), samplesPerPeak);
+            writer.reset (signal.getNumChannels(), 44100.0, samplesPerPeak * 10);
+
+            addInBlocks (writer, signal, 0, samplesPerPeak * 10);
+            expect (writer.flush());
+
+            AudioPeakFile peaks (temp.getFile());
+            expect (peaks.isValid());
+            const auto sizeBefore = temp.getFile().getSize();
+
+            addInBlocks (writer, signal, samplesPerPeak * 10, signal.getNumSamples() - samplesPerPeak * 10);
+            expect (writer.flush());
+
+            expect (temp.getFile().getSize() > sizeBefore);
+            expectEquals (peaks.getNumSamples(), (int64) samplesPerPeak * 10);
+            expectPeakMatches (peaks.getPeakForRange (0, samplesPerPeak * 3, samplesPerPeak), signal, 0, samplesPerPeak * 3, samplesPerPeak);
+
+            expect (peaks.refresh());
+            expectEquals (peaks.getNumSamples(), (int64) signal.getNumSamples());
+            expectPeakMatches (peaks.getPeakForRange (0, samplesPerPeak * 3, samplesPerPeak), signal, 0, samplesPerPeak * 3, samplesPerPeak);
+            expectPeakMatches (peaks.getPeakForRange (1, 200704, samplesPerPeak * 4), signal, 1, 200704, samplesPerPeak * 4);
+        }
+
+        beginTest ("A damaged header falls back to the previous one, and is rejected if both are damaged");
+        {
+            TemporaryFile temp (".peaks");
+            AudioPeakFile::Writer writer (temp.getFile(), samplesPerPeak);
+            writer.reset (signal.getNumChannels(), 44100.0, 0);
+
+            addInBlocks (writer, signal, 0, 1000);
+            expect (writer.flush());
+            addInBlocks (writer, signal, 1000, 2000);
+            expect (writer.flush());
+            expectEquals (AudioPeakFile (temp.getFile()).getNumSamples(), (int64) 3000);
+
+            const auto damage = [&] (int64 position)
+            {
+                FileOutputStream out (temp.getFile());
+                expect (out.setPosition (position));
+                out.writeByte (0x55);
+            };
+
+            // The headers were written by reset() and the two flushes, so the second slot
+            // holds the newest one, and the first slot the one from the first flush
+            damage (PeakFileHelpers::headerSlotSize + 60);
+
+            AudioPeakFile previous (temp.getFile());
+            expect (previous.isValid());
+            expectEquals (previous.getNumSamples(), (int64) 1000);
+
+            damage (60);
+            expect (! AudioPeakFile (temp.getFile()).isValid());
+        }
+
+        beginTest ("Thumbnails only use a peak file that was made from the same source");
+        {
+            TemporaryFile temp (".peaks");
+            AudioBufferSource reader (signal);
+            expect (AudioPeakFile::createFrom (reader, temp.getFile(), 1234));
+            expectEquals (AudioPeakFile (temp.getFile()).getSourceHash(), (int64) 1234);
+
+            AudioFormatManager manager;
+            AudioThumbnailCache cache (1);
+            AudioThumbnail thumbnail (512, manager, cache);
+
+            expect (thumbnail.setSource (new HashOnlySource (1234), temp.getFile()));
+            expect (thumbnail.isFullyLoaded());
+
+            // The source has changed since the peaks were written, so they're ignored and
+            // the thumbnail falls back to reading the audio (which this source can't provide)
+            expect (! thumbnail.setSource (new HashOnlySource (5678), temp.getFile()));
+            expectEquals (thumbnail.getNumChannels(), 0);
+        }
+    }
+
+private:
+    struct HashOnlySource final : public InputSource
+    {
+        explicit HashOnlySource (int64 h) : hash (h) {}
+
+        InputStream* createInputStream() override                   { return nullptr; }
+        InputStream* createInputStreamFor (const String&) override  { return nullptr; }
+        int64 hashCode() const override                             { return hash; }
+
+        int64 hash;
+    };
+
+    struct AudioBufferSource final : public AudioFormatReader
+    {
+        explicit AudioBufferSource (const AudioBuffer<float>& b)
+            : AudioFormatReader (nullptr, "test"), buffer (b)
+        {
+            sampleRate = 44100.0;
+            bitsPerSample = 32;
+            usesFloatingPointData = true;
+            lengthInSamples = buffer.getNumSamples();
+            numChannels = (unsigned int) buffer.getNumChannels();
+        }
+
+        bool readSamples (int* const* destChannels, int numDestChannels, int startOffsetInDestBuffer,
+                          int64 startSampleInFile, int numSamples) override
+        {
+            clearSamplesBeyondAvailableLength (destChannels, numDestChannels, startOffsetInDestBuffer,
+                                               startSampleInFile, numSamples, lengthInSamples);
+
+            for (int i = 0; i < numDestChannels; ++i)
+                if (destChannels[i] != nullptr && i < buffer.getNumChannels())
+                    memcpy (destChannels[i] + startOffsetInDestBuffer,
+                            buffer.getReadPointer (i, (int) startSampleInFile),
+                            (size_t) numSamples * sizeof (float));
+
+            return true;
+        }
+
+        const AudioBuffer<float>& buffer;
+    };
+
+    static AudioBuffer<float> createSignal (int numChannels, int numSamples)
+    {
+        AudioBuffer<float> result (numChannels, numSamples);
+        Random r (1234);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                result.setSample (ch, i, (float) std::sin (i * 0.001 * (ch + 1)) * 0.8f + r.nextFloat() * 0.2f - 0.1f);
+
+        return result;
+    }
+
+    static void addInBlocks (AudioPeakFile::Writer& writer, const AudioBuffer<float>& signal, int start, int num)
+    {
+        for (int blockSize = 1; num > 0; blockSize = (blockSize * 3 + 17) % 5000)
+        {
+            auto numThisTime = jmin (blockSize, num);
+            writer.addBlock (start, signal, start, numThisTime);
+            start += numThisTime;
+            num -= numThisTime;
+        }
+    }
+
+    void expectPeakMatches (AudioPeakFile::Peak peak, const AudioBuffer<float>& signal, int channel, int start, int num)
+    {
+        auto* data = signal.getReadPointer (channel, start);
+        auto range = FloatVectorOperations::findMinAndMax (data, num);
+
+        double sumOfSquares = 0;
+
+        for (int i = 0; i < num; ++i)
+            sumOfSquares += (double) (data[i] * data[i]);
+
+        expectWithinAbsoluteError (peak.minimum, range.getStart(), 1.0e-4f);
+        expectWithinAbsoluteError (peak.maximum, range.getEnd(), 1.0e-4f);
+        expectWithinAbsoluteError (peak.rms, (float) std::sqrt (sumOfSquares / num), 1.0e-3f);
+    }
+};
+
+static AudioPeakFileTests audioPeakFileTests;
+
+#endif
+
+} // namespace juce
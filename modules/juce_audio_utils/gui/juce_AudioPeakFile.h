@@ -0,0 +1,255 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A memory-mapped, multi-resolution file of waveform peak data.
+
+    A peak file stores the minimum, maximum and RMS level of each channel of an
+    audio source at several resolutions. The finest level contains one peak for
+    every getSamplesPerPeak (0) source samples, and each following level summarises
+    a fixed number of peaks from the level below it, so any range of the source
+    can be summarised by combining just a handful of stored values.
+
+    Peak files are usually written alongside the audio that they describe (see
+    getPeakFileFor()), either in one go with createFrom(), or incrementally while
+    recording by using a Writer. An AudioThumbnail can then be filled from a peak
+    file without having to read the original audio again.
+
+    The file is mapped into memory when it's opened. If a Writer is still adding
+    data to the file, call refresh() to pick up anything that has been written
+    since it was opened.
+
+    Each file also records the hash code of the source that it describes (see
+    getSourceHash()), so that a peak file which is out of date can be recognised.
+
+    @see AudioThumbnail::loadFrom, AudioPeakFile::Writer
+
+    @tags{Audio}
+*/
+class JUCE_API  AudioPeakFile
+{
+public:
+    //==============================================================================
+    /** Opens and memory-maps a peak file.
+        Use isValid() to find out whether the file could be opened.
+    */
+    explicit AudioPeakFile (const File& peakFile);
+
+    /** Destructor. */
+    ~AudioPeakFile();
+
+    //==============================================================================
+    /** Returns true if the file was mapped and contains a valid set of peaks. */
+    bool isValid() const noexcept                       { return map != nullptr; }
+
+    /** Re-maps the file, picking up any data that has been added by a Writer since
+        it was last opened. Returns true if the file is still valid.
+    */
+    bool refresh();
+
+    /** Returns the file that this object is reading. */
+    const File& getFile() const noexcept                { return file; }
+
+    //==============================================================================
+    /** Returns the number of channels of the source audio. */
+    int getNumChannels() const noexcept                 { return numChannels; }
+
+    /** Returns the sample rate of the source audio. */
+    double getSampleRate() const noexcept               { return sampleRate; }
+
+    /** Returns the number of source samples that the file describes. */
+    int64 getNumSamples() const noexcept                { return numSamples; }
+
+    /** Returns the hash code of the source that the file was written from.
+
+        This is the value that was given to createFrom() or Writer::setSourceHash(),
+        which would normally be the InputSource::hashCode() of the audio file.
+    */
+    int64 getSourceHash() const noexcept                { return sourceHash; }
+
+    /** Returns the number of resolution levels in the file. */
+    int getNumLevels() const noexcept                   { return (int) levels.size(); }
+
+    /** Returns the number of source samples that each peak in the given level summarises. */
+    int64 getSamplesPerPeak (int level) const noexcept;
+
+    /** Returns the number of peaks that are available in the given level. */
+    int64 getNumPeaks (int level) const noexcept;
+
+    //==============================================================================
+    /** The levels of a section of one channel. */
+    struct Peak
+    {
+        float minimum = 0.0f, maximum = 0.0f, rms = 0.0f;
+    };
+
+    /** Returns one of the stored peaks. */
+    Peak getPeak (int level, int channel, int64 peakIndex) const noexcept;
+
+    /** Returns the levels for a range of source samples.
+
+        The range doesn't need to line up with the peaks of any level: the middle of it
+        is summarised from the coarsest peaks that fit inside it, and the ends from finer
+        levels, so the result can only include extra samples from the finest peaks that
+        the range starts and ends part-way through.
+    */
+    Peak getPeakForRange (int channel, int64 startSample, int64 numSamplesInRange) const noexcept;
+
+    //==============================================================================
+    /** Returns the peak file that would normally be stored alongside an audio file,
+        e.g. "take1.wav.peaks" for "take1.wav".
+    */
+    static File getPeakFileFor (const File& audioFile);
+
+    /** Reads all the audio from a reader and writes a peak file describing it.
+
+        The sourceHash is stored in the file to identify the audio that it was made
+        from - see getSourceHash().
+
+        Returns false if the file couldn't be written.
+    */
+    static bool createFrom (AudioFormatReader& reader, const File& peakFile, int64 sourceHash,
+                            int samplesPerPeak = defaultSamplesPerPeak);
+
+    /** The number of source samples per peak that new files use by default. */
+    static constexpr int defaultSamplesPerPeak = 256;
+
+    /** The number of peaks from one level that are summarised by each peak in the next level. */
+    static constexpr int levelRatio = 4;
+
+    /** The number of resolution levels stored in new files. */
+    static constexpr int defaultNumLevels = 8;
+
+    //==============================================================================
+    /**
+        Writes a peak file incrementally from blocks of incoming audio.
+
+        The writer can be given to an AudioFormatWriter::ThreadedWriter with
+        setDataReceiver() so that the peak file is built while recording, or you can
+        call reset() and addBlock() yourself. The blocks must be added in order, and
+        the file is updated every so often, so an AudioPeakFile that has the same file
+        open will see the new data after calling AudioPeakFile::refresh().
+
+        Data that is already in the file is never moved or truncated while it's being
+        written, so it's safe for an AudioPeakFile to have it mapped at the same time.
+
+        The writer isn't thread-safe, so calls to its methods mustn't overlap. When it's
+        attached to a ThreadedWriter, reset() is called by setDataReceiver() and
+        addBlock() is called on the ThreadedWriter's background thread, so only call
+        setSourceHash() or flush() yourself once the ThreadedWriter has been deleted or
+        given a different receiver.
+
+        @tags{Audio}
+    */
+    class JUCE_API  Writer  : public AudioFormatWriter::ThreadedWriter::IncomingDataReceiver
+    {
+    public:
+        /** Creates a writer for the given file.
+            Nothing is written until reset() is called.
+        */
+        explicit Writer (const File& peakFile, int samplesPerPeak = defaultSamplesPerPeak);
+
+        /** Destructor. Any pending data is flushed to the file. */
+        ~Writer() override;
+
+        /** Replaces the file with an empty set of peaks in the given format.
+            If the total length is known, passing it in here lets the file be allocated
+            at its final size straight away.
+        */
+        void reset (int numChannels, double sampleRate, int64 totalSamplesInSource) override;
+
+        /** Sets the hash code of the source that is being described, which is written
+            to the file at the next flush(). See AudioPeakFile::getSourceHash().
+
+            When recording, call this once the audio file has been closed, so that the
+            hash reflects its final state, and then call flush().
+        */
+        void setSourceHash (int64 newSourceHash) noexcept      { sourceHash = newSourceHash; }
+
+        /** Adds the next block of source audio. */
+        void addBlock (int64 sampleNumberInSource, const AudioBuffer<float>& newData,
+                       int startOffsetInBuffer, int numSamples) override;
+
+        /** Writes all pending peaks, including any partially-filled ones, and updates
+            the file header. Returns false if the file couldn't be written.
+        */
+        bool flush();
+
+        /** Returns the number of source samples that have been added so far. */
+        int64 getNumSamplesWritten() const noexcept     { return numSamples; }
+
+    private:
+        struct Accumulator;
+        struct Level;
+
+        File file;
+        std::unique_ptr<FileOutputStream> output;
+        std::vector<Level> levels;
+        std::vector<Accumulator> accumulators;
+        int numChannels = 0, samplesPerPeak;
+        double sampleRate = 0;
+        int64 numSamples = 0, numSamplesAtLastFlush = 0, sourceHash = 0, fileSize = 0, headerGeneration = 0;
+        bool writeFailed = false;
+
+        void addToLevel (int level, int channel, const Accumulator&);
+        void finishPeak (int level);
+        bool createFile();
+        bool ensureCapacity();
+        bool writeLayout (OutputStream&, int64 startOffset, InputStream* oldContents);
+        bool writeHeader (OutputStream&);
+        int getEntrySize() const noexcept;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Writer)
+    };
+
+private:
+    //==============================================================================
+    struct LevelInfo
+    {
+        int64 dataOffset = 0, samplesPerPeak = 0, numPeaks = 0;
+    };
+
+    File file;
+    std::unique_ptr<MemoryMappedFile> map;
+    std::vector<LevelInfo> levels;
+    int numChannels = 0;
+    double sampleRate = 0;
+    int64 numSamples = 0, sourceHash = 0;
+
+    struct RangeSummary;
+
+    bool readHeader();
+    bool readHeader (const void* headerSlot, int64 fileSize);
+    void addToSummary (RangeSummary&, int level, int channel, int64 start, int64 end) const noexcept;
+    const uint8* getEntry (int level, int channel, int64 peakIndex) const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioPeakFile)
+};
+
+} // namespace juce
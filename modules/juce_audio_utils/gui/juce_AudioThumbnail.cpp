@@ -159,7 +159,11 @@ public:
 
     ~LevelDataSource() override
     {
-        owner.cache.getTimeSliceThread().removeTimeSliceClient (this);
+        // The source can't be deleted by its own scan job (e.g. by calling setSource()
+        // from onLoadingProgress), because the job is still using it.
+        jassert (job == nullptr || ThreadPoolJob::getCurrentThreadPoolJob() != job.get());
+
+        stopScanning();
     }
 
     enum { timeBeforeDeletingReader = 3000 };
@@ -181,10 +185,32 @@ public:
             if (lengthInSamples <= 0 || isFullyLoaded())
                 reader.reset();
             else
-                owner.cache.getTimeSliceThread().addTimeSliceClient (this);
+                startScanning();
         }
     }
 
+    void stopScanning()
+    {
+        scanningCancelled = true;
+
+        if (job != nullptr)
+        {
+            // When this is called from inside the scan (i.e. from onLoadingProgress), waiting
+            // for the job would never return, so just leave it to see the flag and finish.
+            if (ThreadPoolJob::getCurrentThreadPoolJob() == job.get())
+                return;
+
+            if (auto* pool = owner.cache.getThreadPool())
+                pool->removeJob (job.get(), true, -1);
+        }
+
+        // (asking for the thread would start it, so it's only used if this has been added to it)
+        if (isTimeSliceClient)
+            owner.cache.getTimeSliceThread().removeTimeSliceClient (this);
+
+        releaseReaderIfRecreatable();
+    }
+
     void getLevels (int64 startSample, int numSamples, Array<Range<float>>& levels)
     {
         const ScopedLock sl (readerLock);
@@ -196,7 +222,7 @@ public:
             if (reader != nullptr)
             {
                 lastReaderUseTime = Time::getMillisecondCounter();
-                owner.cache.getTimeSliceThread().addTimeSliceClient (this);
+                addToTimeSliceThread();
             }
         }
 
@@ -217,9 +243,17 @@ public:
         reader.reset();
     }
 
+    void releaseReaderIfRecreatable()
+    {
+        const ScopedLock sl (readerLock);
+
+        if (source != nullptr)
+            reader.reset();
+    }
+
     int useTimeSlice() override
     {
-        if (isFullyLoaded())
+        if (isFullyLoaded() || scanningCancelled || job != nullptr)
         {
             if (reader != nullptr && source != nullptr)
             {
@@ -269,11 +303,82 @@ public:
     int64 hashCode = 0;
 
 private:
+    //==============================================================================
+    class ScanJob final : public ThreadPoolJob
+    {
+    public:
+        explicit ScanJob (LevelDataSource& s)  : ThreadPoolJob ("thumbnail scan"), levelSource (s) {}
+
+        JobStatus runJob() override
+        {
+            if (shouldExit() || levelSource.scanningCancelled)
+            {
+                levelSource.releaseReaderIfRecreatable();
+                return jobHasFinished;
+            }
+
+            bool justFinished = false;
+
+            {
+                const ScopedLock sl (levelSource.readerLock);
+                levelSource.createReader();
+
+                if (levelSource.reader == nullptr)
+                    return jobHasFinished;
+
+                // Return between blocks so that other files sharing the pool get a turn
+                if (! levelSource.readNextBlock())
+                {
+                    if (! levelSource.scanningCancelled)
+                        return jobNeedsRunningAgain;
+
+                    levelSource.releaseReaderIfRecreatable();
+                    return jobHasFinished;
+                }
+
+                justFinished = true;
+                levelSource.releaseReaderIfRecreatable();
+            }
+
+            if (justFinished)
+                levelSource.owner.cache.storeThumb (levelSource.owner, levelSource.hashCode);
+
+            return jobHasFinished;
+        }
+
+    private:
+        LevelDataSource& levelSource;
+    };
+
     AudioThumbnail& owner;
     std::unique_ptr<InputSource> source;
     std::unique_ptr<AudioFormatReader> reader;
+    std::unique_ptr<ScanJob> job;
     CriticalSection readerLock;
+    AudioBuffer<float> scanBuffer;
     std::atomic<uint32> lastReaderUseTime { 0 };
+    std::atomic<bool> scanningCancelled { false }, isTimeSliceClient { false };
+
+    void startScanning()
+    {
+        scanningCancelled = false;
+
+        if (auto* pool = owner.cache.getThreadPool())
+        {
+            job = std::make_unique<ScanJob> (*this);
+            pool->addJob (job.get(), false);
+        }
+        else
+        {
+            addToTimeSliceThread();
+        }
+    }
+
+    void addToTimeSliceThread()
+    {
+        isTimeSliceClient = true;
+        owner.cache.getTimeSliceThread().addTimeSliceClient (this);
+    }
 
     void createReader()
     {
@@ -304,20 +409,46 @@ private:
                 for (int i = 0; i < (int) numChannels; ++i)
                     levels[i] = levelData + i * numThumbSamps;
 
-                HeapBlock<Range<float>> levelsRead (numChannels);
+                // Read the whole block in one go, and then scan it a thumbnail sample at a time
+                auto firstSampleToScan = (int64) firstThumbIndex * owner.samplesPerThumbSample;
+                auto numToScan = (int) jmin ((int64) numThumbSamps * owner.samplesPerThumbSample,
+                                             lengthInSamples - firstSampleToScan);
+
+                scanBuffer.setSize ((int) numChannels, numToScan, false, false, true);
+
+                if (! reader->read (scanBuffer.getArrayOfWritePointers(), (int) numChannels, firstSampleToScan, numToScan))
+                {
+                    // The source has ended early (e.g. a truncated file), so stop at the last
+                    // block that could be read, rather than storing levels for missing audio
+                    lengthInSamples = numSamplesFinished;
+
+                    const ScopedUnlock su (readerLock);
+                    owner.setEndOfSource (numSamplesFinished);
+                    return true;
+                }
 
-                for (int i = 0; i < numThumbSamps; ++i)
+                for (int j = 0; j < (int) numChannels; ++j)
                 {
-                    reader->readMaxLevels ((firstThumbIndex + i) * owner.samplesPerThumbSample,
-                                           owner.samplesPerThumbSample, levelsRead, (int) numChannels);
+                    auto* channelData = scanBuffer.getReadPointer (j);
 
-                    for (int j = 0; j < (int) numChannels; ++j)
-                        levels[j][i].setFloat (levelsRead[j]);
+                    for (int i = 0; i < numThumbSamps; ++i)
+                    {
+                        auto offset = i * owner.samplesPerThumbSample;
+                        auto numInThumbSample = jmin (owner.samplesPerThumbSample, numToScan - offset);
+
+                        if (numInThumbSample > 0)
+                            levels[j][i].setFloat (FloatVectorOperations::findMinAndMax (channelData + offset, numInThumbSample));
+                        else
+                            levels[j][i].set (1, 0);
+                    }
                 }
 
                 {
                     const ScopedUnlock su (readerLock);
                     owner.setLevels (levels, firstThumbIndex, (int) numChannels, numThumbSamps);
+
+                    if (owner.onLoadingProgress != nullptr)
+                        owner.onLoadingProgress (owner.getProportionComplete());
                 }
 
                 numSamplesFinished += numToDo;
@@ -457,26 +588,25 @@ public:
 
                 auto* cacheData = getData (channelNum, clip.getX() - area.getX());
 
-                RectangleList<float> waveform;
-                waveform.ensureStorageAllocated (clip.getWidth());
-
-                auto x = (float) clip.getX();
+                auto numColumns = clip.getWidth();
+                HeapBlock<float> tops ((size_t) numColumns), bottoms ((size_t) numColumns);
 
-                for (int w = clip.getWidth(); --w >= 0;)
+                for (int i = 0; i < numColumns; ++i)
                 {
                     if (cacheData->isNonZero())
                     {
-                        auto top    = jmax (midY - cacheData->getMaxValue() * vscale - 0.3f, topY);
-                        auto bottom = jmin (midY - cacheData->getMinValue() * vscale + 0.3f, bottomY);
-
-                        waveform.addWithoutMerging (Rectangle<float> (x, top, 1.0f, bottom - top));
+                        tops[i]    = jmax (midY - cacheData->getMaxValue() * vscale - 0.3f, topY);
+                        bottoms[i] = jmin (midY - cacheData->getMinValue() * vscale + 0.3f, bottomY);
+                    }
+                    else
+                    {
+                        tops[i] = bottoms[i] = midY;
                     }
 
-                    x += 1.0f;
                     ++cacheData;
                 }
 
-                g.fillRectList (waveform);
+                g.fillWaveformColumns ((float) clip.getX(), 1.0f, tops, bottoms, numColumns);
             }
         }
     }
@@ -698,6 +828,36 @@ void AudioThumbnail::saveTo (OutputStream& output) const
             channels.getUnchecked (chan)->getData (i)->write (output);
 }
 
+bool AudioThumbnail::loadFrom (const AudioPeakFile& peakFile)
+{
+    if (! peakFile.isValid())
+        return false;
+
+    {
+        const ScopedLock sl (lock);
+        clearChannelData();
+
+        numChannels = peakFile.getNumChannels();
+        sampleRate = peakFile.getSampleRate();
+        totalSamples = numSamplesFinished = peakFile.getNumSamples();
+
+        auto numThumbnailSamples = (int) ((totalSamples + samplesPerThumbSample - 1) / samplesPerThumbSample);
+        createChannels (numThumbnailSamples);
+
+        for (int chan = 0; chan < numChannels; ++chan)
+        {
+            for (int i = 0; i < numThumbnailSamples; ++i)
+            {
+                auto peak = peakFile.getPeakForRange (chan, i * (int64) samplesPerThumbSample, samplesPerThumbSample);
+                channels.getUnchecked (chan)->getData (i)->setFloat ({ peak.minimum, peak.maximum });
+            }
+        }
+    }
+
+    sendChangeMessage();
+    return true;
+}
+
 //==============================================================================
 bool AudioThumbnail::setDataSource (LevelDataSource* newSource)
 {
@@ -708,13 +868,7 @@ bool AudioThumbnail::setDataSource (LevelDataSource* newSource)
 
     if (cache.loadThumb (*this, newSource->hashCode) && isFullyLoaded())
     {
-        source.reset (newSource); // (make sure this isn't done before loadThumb is called)
-
-        source->lengthInSamples = totalSamples;
-        source->sampleRate = sampleRate;
-        source->numChannels = (unsigned int) numChannels;
-        source->numSamplesFinished = numSamplesFinished;
-
+        setLoadedDataSource (newSource); // (make sure this isn't done before loadThumb is called)
         return wasSuccessful();
     }
 
@@ -732,6 +886,16 @@ bool AudioThumbnail::setDataSource (LevelDataSource* newSource)
     return wasSuccessful();
 }
 
+void AudioThumbnail::setLoadedDataSource (LevelDataSource* newSource)
+{
+    source.reset (newSource);
+
+    source->lengthInSamples = totalSamples;
+    source->sampleRate = sampleRate;
+    source->numChannels = (unsigned int) numChannels;
+    source->numSamplesFinished = numSamplesFinished;
+}
+
 bool AudioThumbnail::setSource (InputSource* const newSource)
 {
     clear();
@@ -739,6 +903,24 @@ bool AudioThumbnail::setSource (InputSource* const newSource)
     return newSource != nullptr && setDataSource (new LevelDataSource (*this, newSource));
 }
 
+bool AudioThumbnail::setSource (InputSource* newSource, const File& peakFile)
+{
+    clear();
+
+    if (newSource == nullptr)
+        return false;
+
+    const AudioPeakFile peaks (peakFile);
+
+    if (peaks.getNumSamples() > 0 && peaks.getSourceHash() == newSource->hashCode() && loadFrom (peaks))
+    {
+        setLoadedDataSource (new LevelDataSource (*this, newSource));
+        return true;
+    }
+
+    return setDataSource (new LevelDataSource (*this, newSource));
+}
+
 void AudioThumbnail::setReader (AudioFormatReader* newReader, int64 hash)
 {
     clear();
@@ -757,6 +939,12 @@ void AudioThumbnail::setSource (const AudioBuffer<int>* newSource, double rate,
     setReader (new AudioBufferReader<int> (newSource, rate), hash);
 }
 
+void AudioThumbnail::cancelLoading()
+{
+    if (source != nullptr)
+        source->stopScanning();
+}
+
 int64 AudioThumbnail::getHashCode() const
 {
     return source == nullptr ? 0 : source->hashCode;
@@ -815,6 +1003,16 @@ void AudioThumbnail::setLevels (const MinMaxValue* const* values, int thumbIndex
     sendChangeMessage();
 }
 
+void AudioThumbnail::setEndOfSource (int64 numSamplesInSource)
+{
+    const ScopedLock sl (lock);
+
+    totalSamples = numSamplesInSource;
+    numSamplesFinished = jmax (numSamplesFinished, numSamplesInSource);
+    window->invalidate();
+    sendChangeMessage();
+}
+
 //==============================================================================
 int AudioThumbnail::getNumChannels() const noexcept
 {
@@ -898,4 +1096,251 @@ void AudioThumbnail::drawChannels (Graphics& g, const Rectangle<int>& area, doub
     }
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AudioThumbnailTests final : public UnitTest
+{
+public:
+    AudioThumbnailTests()
+        : UnitTest ("AudioThumbnail", UnitTestCategories::audio)
+    {}
+
+    void runTest() override
+    {
+        constexpr int samplesPerThumbSample = 64;
+
+        beginTest ("Thumbnails can be scanned in parallel on a ThreadPool");
+        {
+            ThreadPool pool (2);
+            AudioFormatManager manager;
+            AudioThumbnailCache cache (8, pool);
+
+            std::vector<AudioBuffer<float>> buffers;
+            std::vector<std::unique_ptr<AudioThumbnail>> thumbnails;
+            std::atomic<int> numProgressCallbacks { 0 };
+
+            for (int i = 0; i < 5; ++i)
+                buffers.push_back (createSignal (0.2f * (float) (i + 1), 100000));
+
+            for (int i = 0; i < (int) buffers.size(); ++i)
+            {
+                thumbnails.push_back (std::make_unique<AudioThumbnail> (samplesPerThumbSample, manager, cache));
+                thumbnails.back()->onLoadingProgress = [&] (double) { ++numProgressCallbacks; };
+                thumbnails.back()->setSource (&buffers[(size_t) i], 44100.0, i + 1);
+            }
+
+            for (auto& thumbnail : thumbnails)
+                expect (waitUntilLoaded (*thumbnail));
+
+            expect (numProgressCallbacks.load() > 0);
+
+            for (int i = 0; i < (int) thumbnails.size(); ++i)
+            {
+                float minValue = 0, maxValue = 0;
+                thumbnails[(size_t) i]->getApproximateMinMax (0.0, thumbnails[(size_t) i]->getTotalLength(), 0, minValue, maxValue);
+                expectWithinAbsoluteError (maxValue, 0.2f * (float) (i + 1), 0.02f);
+                expectWithinAbsoluteError (minValue, -0.2f * (float) (i + 1), 0.02f);
+            }
+        }
+
+        beginTest ("Scanning can be cancelled");
+        {
+            ThreadPool pool (1);
+            AudioFormatManager manager;
+            AudioThumbnailCache cache (1, pool);
+            AudioThumbnail thumbnail (samplesPerThumbSample, manager, cache);
+            WaitableEvent firstBlockScanned;
+
+            thumbnail.onLoadingProgress = [&] (double)
+            {
+                firstBlockScanned.signal();
+                Thread::sleep (100);
+            };
+
+            auto buffer = createSignal (0.5f, 1000000);
+            thumbnail.setSource (&buffer, 44100.0, 1);
+
+            expect (firstBlockScanned.wait (5000));
+            thumbnail.cancelLoading();
+
+            const auto numFinished = thumbnail.getNumSamplesFinished();
+            Thread::sleep (50);
+
+            expect (! thumbnail.isFullyLoaded());
+            expectEquals (thumbnail.getNumSamplesFinished(), numFinished);
+            expect (numFinished < buffer.getNumSamples());
+        }
+
+        beginTest ("Scanning can be cancelled from the progress callback");
+        {
+            ThreadPool pool (1);
+            AudioFormatManager manager;
+            manager.registerBasicFormats();
+            AudioThumbnailCache cache (1, pool);
+            AudioThumbnail thumbnail (samplesPerThumbSample, manager, cache);
+            WaitableEvent cancelled;
+
+            thumbnail.onLoadingProgress = [&] (double)
+            {
+                thumbnail.cancelLoading();
+                cancelled.signal();
+            };
+
+            std::atomic<int> numOpenStreams { 0 };
+            thumbnail.setSource (new CountingInputSource (createWavFile (createSignal (0.5f, 200000)), numOpenStreams));
+
+            expect (cancelled.wait (5000));
+
+            for (int i = 0; i < 500 && numOpenStreams.load() > 0; ++i)
+                Thread::sleep (10);
+
+            expect (! thumbnail.isFullyLoaded());
+            expectEquals (numOpenStreams.load(), 0);
+        }
+
+        beginTest ("Sources that aren't a whole number of thumbnail samples are scanned");
+        {
+            ThreadPool pool (1);
+            AudioFormatManager manager;
+            AudioThumbnailCache cache (1, pool);
+            AudioThumbnail thumbnail (samplesPerThumbSample, manager, cache);
+
+            auto buffer = createSignal (0.5f, 10 * samplesPerThumbSample + samplesPerThumbSample / 2);
+            thumbnail.setSource (&buffer, 44100.0, 1);
+
+            expect (waitUntilLoaded (thumbnail));
+
+            float minValue = 0, maxValue = 0;
+            thumbnail.getApproximateMinMax (0.0, thumbnail.getTotalLength(), 0, minValue, maxValue);
+            expect (maxValue > 0.0f && maxValue <= 0.5f);
+        }
+
+        beginTest ("A source that can't be read to the end is treated as ending there");
+        {
+            for (auto usePool : { false, true })
+            {
+                ThreadPool pool (1);
+                AudioFormatManager manager;
+                std::unique_ptr<AudioThumbnailCache> cache (usePool ? new AudioThumbnailCache (1, pool)
+                                                                    : new AudioThumbnailCache (1));
+                AudioThumbnail thumbnail (samplesPerThumbSample, manager, *cache);
+
+                const auto buffer = createSignal (0.5f, 100000);
+                constexpr int64 firstUnreadableSample = 40000;
+                thumbnail.setReader (new FailingReader (buffer, firstUnreadableSample), 1);
+
+                expect (waitUntilLoaded (thumbnail));
+
+                // The scan reads whole blocks, so it stops at the start of the one that failed
+                const auto length = (int64) roundToInt (thumbnail.getTotalLength() * 44100.0);
+                expect (length > 0 && length <= firstUnreadableSample);
+                expectEquals (length % (256 * samplesPerThumbSample), (int64) 0);
+
+                float minValue = 0, maxValue = 0;
+                thumbnail.getApproximateMinMax (0.0, thumbnail.getTotalLength(), 0, minValue, maxValue);
+                expectWithinAbsoluteError (maxValue, 0.5f, 0.02f);
+            }
+        }
+    }
+
+private:
+    // A reader whose data can't be read beyond a certain point, like a truncated file
+    struct FailingReader final : public AudioFormatReader
+    {
+        FailingReader (const AudioBuffer<float>& b, int64 firstUnreadable)
+            : AudioFormatReader (nullptr, "test"), buffer (b), firstUnreadableSample (firstUnreadable)
+        {
+            sampleRate = 44100.0;
+            bitsPerSample = 32;
+            usesFloatingPointData = true;
+            lengthInSamples = buffer.getNumSamples();
+            numChannels = (unsigned int) buffer.getNumChannels();
+        }
+
+        bool readSamples (int* const* destChannels, int numDestChannels, int startOffsetInDestBuffer,
+                          int64 startSampleInFile, int numSamples) override
+        {
+            if (startSampleInFile + numSamples > firstUnreadableSample)
+                return false;
+
+            for (int i = 0; i < numDestChannels; ++i)
+                if (destChannels[i] != nullptr)
+                    memcpy (destChannels[i] + startOffsetInDestBuffer,
+                            buffer.getReadPointer (jmin (i, buffer.getNumChannels() - 1), (int) startSampleInFile),
+                            (size_t) numSamples * sizeof (float));
+
+            return true;
+        }
+
+        const AudioBuffer<float>& buffer;
+        const int64 firstUnreadableSample;
+    };
+
+    struct CountingInputSource final : public InputSource
+    {
+        struct Stream final : public MemoryInputStream
+        {
+            Stream (const MemoryBlock& block, std::atomic<int>& numOpenIn)
+                : MemoryInputStream (block, false), numOpen (numOpenIn)  { ++numOpen; }
+
+            ~Stream() override  { --numOpen; }
+
+            std::atomic<int>& numOpen;
+        };
+
+        CountingInputSource (MemoryBlock dataIn, std::atomic<int>& numOpenIn)
+            : data (std::move (dataIn)), numOpen (numOpenIn) {}
+
+        InputStream* createInputStream() override                   { return new Stream (data, numOpen); }
+        InputStream* createInputStreamFor (const String&) override  { return nullptr; }
+        int64 hashCode() const override                             { return (int64) data.getSize(); }
+
+        MemoryBlock data;
+        std::atomic<int>& numOpen;
+    };
+
+    static MemoryBlock createWavFile (const AudioBuffer<float>& buffer)
+    {
+        MemoryBlock result;
+
+        {
+            std::unique_ptr<AudioFormatWriter> writer (WavAudioFormat().createWriterFor (new MemoryOutputStream (result, false),
+                                                                                         44100.0, (unsigned int) buffer.getNumChannels(),
+                                                                                         16, {}, 0));
+            writer->writeFromAudioSampleBuffer (buffer, 0, buffer.getNumSamples());
+        }
+
+        return result;
+    }
+
+    static AudioBuffer<float> createSignal (float amplitude, int numSamples)
+    {
+        AudioBuffer<float> result (1, numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+            result.setSample (0, i, amplitude * (float) std::sin (i * 0.01));
+
+        return result;
+    }
+
+    static bool waitUntilLoaded (const AudioThumbnail& thumbnail)
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            if (thumbnail.isFullyLoaded())
+                return true;
+
+            Thread::sleep (10);
+        }
+
+        return false;
+    }
+};
+
+static AudioThumbnailTests audioThumbnailTests;
+
+#endif
+
 } // namespace juce
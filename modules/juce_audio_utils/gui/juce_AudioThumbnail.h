@@ -111,6 +111,20 @@ public:
     /** Same as the other setSource() overload except for int data. */
     void setSource (const AudioBuffer<int>* newSource, double sampleRate, int64 hashCode);
 
+    /** Specifies the audio source, along with a peak file that describes it.
+
+        If the peak file can be opened, and its AudioPeakFile::getSourceHash() matches
+        the source's hashCode(), the thumbnail is filled from it straight away and the
+        source audio isn't scanned. Otherwise, this behaves just like
+        setSource (InputSource*).
+
+        To make sure that a peak file is ignored once the audio has been modified, use
+        a FileInputSource that includes the file time in its hash code.
+
+        @see AudioPeakFile::getPeakFileFor, AudioPeakFile::createFrom
+    */
+    bool setSource (InputSource* newSource, const File& peakFile);
+
     /** Resets the thumbnail, ready for adding data with the specified format.
         If you're going to generate a thumbnail yourself, call this before using addBlock()
         to add the data.
@@ -139,6 +153,17 @@ public:
     */
     void saveTo (OutputStream& output) const override;
 
+    /** Fills the thumbnail with level data from a peak file, without reading any audio.
+
+        The thumbnail takes its channel count, sample rate and length from the peak file.
+        If the peak file is still being written, you can call AudioPeakFile::refresh()
+        and then call this again to pick up the new data.
+
+        @returns false if the peak file isn't valid
+        @see AudioPeakFile
+    */
+    bool loadFrom (const AudioPeakFile& peakFile);
+
     //==============================================================================
     /** Returns the number of channels in the file. */
     int getNumChannels() const noexcept override;
@@ -182,6 +207,24 @@ public:
     /** Returns a value between 0 and 1 to indicate the progress towards loading the entire file. */
     double getProportionComplete() const noexcept;
 
+    /** Stops the background scanning of the current source.
+
+        Any level data that has already been generated is kept, but the rest of the
+        file won't be scanned, so isFullyLoaded() will return false until a new
+        source is set.
+    */
+    void cancelLoading();
+
+    /** If set, this is called each time another block of the source has been scanned,
+        with the value that getProportionComplete() would return.
+
+        Note that this is called on the thread that's doing the scanning, which will be
+        either the cache's TimeSliceThread, or one of the threads of its ThreadPool.
+        Set it before calling setSource(). The callback may call cancelLoading(), but
+        mustn't change or clear the source.
+    */
+    std::function<void (double proportionComplete)> onLoadingProgress;
+
     /** Returns the number of samples that have been set in the thumbnail. */
     int64 getNumSamplesFinished() const noexcept override;
 
@@ -225,7 +268,9 @@ private:
 
     void clearChannelData();
     bool setDataSource (LevelDataSource* newSource);
+    void setLoadedDataSource (LevelDataSource* newSource);
     void setLevels (const MinMaxValue* const* values, int thumbIndex, int numChans, int numValues);
+    void setEndOfSource (int64 numSamplesInSource);
     void createChannels (int length);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioThumbnail)
@@ -60,17 +60,34 @@ private:
 
 //==============================================================================
 AudioThumbnailCache::AudioThumbnailCache (const int maxNumThumbs)
-    : thread ("thumb cache"),
-      maxNumThumbsToStore (maxNumThumbs)
+    : maxNumThumbsToStore (maxNumThumbs)
 {
     jassert (maxNumThumbsToStore > 0);
-    thread.startThread (Thread::Priority::low);
+}
+
+AudioThumbnailCache::AudioThumbnailCache (const int maxNumThumbs, ThreadPool& poolToUseForScanning)
+    : AudioThumbnailCache (maxNumThumbs)
+{
+    pool = &poolToUseForScanning;
 }
 
 AudioThumbnailCache::~AudioThumbnailCache()
 {
 }
 
+TimeSliceThread& AudioThumbnailCache::getTimeSliceThread()
+{
+    const ScopedLock sl (threadLock);
+
+    if (thread == nullptr)
+    {
+        thread = std::make_unique<TimeSliceThread> ("thumb cache");
+        thread->startThread (Thread::Priority::low);
+    }
+
+    return *thread;
+}
+
 AudioThumbnailCache::ThumbnailCacheEntry* AudioThumbnailCache::findThumbFor (const int64 hash) const
 {
     for (int i = thumbs.size(); --i >= 0;)
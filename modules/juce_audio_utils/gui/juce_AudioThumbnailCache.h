@@ -34,6 +34,12 @@ namespace juce
     that need it, and it maintains a set of low-res previews in memory, to avoid
     having to re-scan audio files too often.
 
+    If you need to open lots of files at once, you can also give the cache a
+    ThreadPool, in which case each thumbnail will be scanned by its own job in the
+    pool, so that several files can be scanned in parallel. The cache's own thread
+    is then only started if a thumbnail has to re-open its source later on, to
+    draw it at a higher resolution than its stored levels.
+
     @see AudioThumbnail
 
     @tags{Audio}
@@ -49,6 +55,14 @@ public:
     */
     explicit AudioThumbnailCache (int maxNumThumbsToStore);
 
+    /** Creates a cache object that scans its thumbnails using a ThreadPool.
+
+        Each thumbnail that needs scanning is given its own job in the pool. The pool
+        must not be deleted until the cache and all the thumbnails that use it have
+        been deleted.
+    */
+    AudioThumbnailCache (int maxNumThumbsToStore, ThreadPool& poolToUseForScanning);
+
     /** Destructor. */
     virtual ~AudioThumbnailCache();
 
@@ -86,8 +100,15 @@ public:
     */
     void writeToStream (OutputStream& stream);
 
-    /** Returns the thread that client thumbnails can use. */
-    TimeSliceThread& getTimeSliceThread() noexcept      { return thread; }
+    /** Returns the thread that client thumbnails can use.
+        The thread is started the first time that this is called.
+    */
+    TimeSliceThread& getTimeSliceThread();
+
+    /** Returns the pool that thumbnails should use for scanning, or nullptr if they
+        should use the TimeSliceThread instead.
+    */
+    ThreadPool* getThreadPool() const noexcept          { return pool; }
 
 protected:
     /** This can be overridden to provide a custom callback for saving thumbnails
@@ -102,7 +123,9 @@ protected:
 
 private:
     //==============================================================================
-    TimeSliceThread thread;
+    std::unique_ptr<TimeSliceThread> thread;
+    CriticalSection threadLock;
+    ThreadPool* pool = nullptr;
 
     class ThumbnailCacheEntry;
     OwnedArray<ThumbnailCacheEntry> thumbs;
@@ -57,6 +57,7 @@
 #endif
 
 #include "gui/juce_AudioDeviceSelectorComponent.cpp"
+#include "gui/juce_AudioPeakFile.cpp"
 #include "gui/juce_AudioThumbnail.cpp"
 #include "gui/juce_AudioThumbnailCache.cpp"
 #include "gui/juce_AudioVisualiserComponent.cpp"
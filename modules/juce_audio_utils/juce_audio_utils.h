@@ -76,6 +76,7 @@
 
 //==============================================================================
 #include "gui/juce_AudioDeviceSelectorComponent.h"
+#include "gui/juce_AudioPeakFile.h"
 #include "gui/juce_AudioThumbnailBase.h"
 #include "gui/juce_AudioThumbnail.h"
 #include "gui/juce_AudioThumbnailCache.h"
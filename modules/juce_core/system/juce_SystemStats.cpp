@@ -124,10 +124,79 @@ StringArray SystemStats::getMachineIdentifiers (MachineIdFlags flags)
 //==============================================================================
 struct CPUInformation
 {
-    CPUInformation() noexcept    { initialise(); }
+    CPUInformation() noexcept
+    {
+        initialise();
+        clearFeaturesNotEnabledByOS();
+    }
 
     void initialise() noexcept;
 
+    /*  The CPUID bits only describe what the processor can do. Before AVX or AVX-512
+        instructions can be used, the OS must also save the ymm/zmm registers when it
+        switches context, and it reports which register states it saves in XCR0. If
+        those states aren't enabled, the instructions fault, so the flags are cleared.
+    */
+    void clearFeaturesNotEnabledByOS() noexcept
+    {
+       #if JUCE_INTEL && ! JUCE_NO_INLINE_ASM
+        const auto enabledStates = getOSEnabledRegisterStates();
+
+        constexpr uint64 sseAndAVXStates = 0x6;     // xmm and the upper halves of the ymm registers
+        constexpr uint64 avx512States    = 0xe6;    // the above, plus the opmask and zmm registers
+
+        if ((enabledStates & sseAndAVXStates) != sseAndAVXStates)
+            hasAVX = hasAVX2 = hasFMA3 = hasFMA4 = false;
+
+        if ((enabledStates & avx512States) != avx512States)
+            hasAVX512F = hasAVX512BW = hasAVX512CD = hasAVX512DQ = hasAVX512ER
+                = hasAVX512IFMA = hasAVX512PF = hasAVX512VBMI = hasAVX512VL = hasAVX512VPOPCNTDQ = false;
+       #endif
+    }
+
+   #if JUCE_INTEL && ! JUCE_NO_INLINE_ASM
+    /*  Returns the contents of XCR0, or 0 if the OS hasn't enabled XSAVE (in which case
+        XGETBV isn't available either).
+    */
+    static uint64 getOSEnabledRegisterStates() noexcept
+    {
+        constexpr uint32 osxsaveBit = 1u << 27;
+
+       #if JUCE_MSVC
+        int info[4] = {};
+        __cpuid (info, 1);
+
+        if (((uint32) info[2] & osxsaveBit) == 0)
+            return 0;
+
+        return (uint64) _xgetbv (0);
+       #else
+        uint32 a = 0, b = 0, c = 0, d = 0;
+
+       #if JUCE_32BIT && defined (__pic__)
+        asm ("mov %%ebx, %%edi\n"
+             "cpuid\n"
+             "xchg %%edi, %%ebx\n"
+               : "=a" (a), "=D" (b), "=c" (c), "=d" (d)
+               : "a" (1), "c" (0));
+       #else
+        asm ("cpuid\n"
+               : "=a" (a), "=b" (b), "=c" (c), "=d" (d)
+               : "a" (1), "c" (0));
+       #endif
+
+        if ((c & osxsaveBit) == 0)
+            return 0;
+
+        asm ("xgetbv\n"
+               : "=a" (a), "=d" (d)
+               : "c" (0));
+
+        return ((uint64) d << 32) | a;
+       #endif
+    }
+   #endif
+
     int numLogicalCPUs = 0, numPhysicalCPUs = 0;
 
     bool hasMMX      = false, hasSSE        = false, hasSSE2       = false, hasSSE3       = false,
@@ -51,6 +51,10 @@
 
 #elif JUCE_LINUX || JUCE_BSD
  #include <unistd.h>
+
+ #if JUCE_LINUX
+  #include <sys/epoll.h>
+ #endif
 #endif
 
 //==============================================================================
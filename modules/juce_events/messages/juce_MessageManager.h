@@ -189,6 +189,15 @@ public:
 
         using Ptr = ReferenceCountedObjectPtr<MessageBase>;
 
+       #if JUCE_LINUX || JUCE_BSD
+    private:
+        friend class InternalMessageQueue;
+
+        // Links used by the lock-free queue that messages are posted to
+        std::atomic<MessageBase*> nextInQueue { nullptr };
+        std::atomic<bool> isInQueue { false };
+       #endif
+
         JUCE_DECLARE_NON_COPYABLE (MessageBase)
     };
 
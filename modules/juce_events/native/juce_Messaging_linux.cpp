@@ -24,18 +24,33 @@ namespace juce
 {
 
 //==============================================================================
+/*  Messages are posted to a lock-free, multiple-producer single-consumer queue that is
+    linked through the messages themselves, so posting never blocks or allocates.
+
+    The message thread is woken by a file descriptor, which is only written to when it
+    isn't already due to wake up, so a burst of posts costs a single system call.
+*/
 class InternalMessageQueue
 {
 public:
     InternalMessageQueue()
     {
-        [[maybe_unused]] auto err = ::socketpair (AF_LOCAL, SOCK_STREAM, 0, msgpipe);
+       #if JUCE_LINUX
+        wakeupFds[0] = wakeupFds[1] = ::eventfd (0, EFD_CLOEXEC | EFD_NONBLOCK);
+        jassert (wakeupFds[0] >= 0);
+       #else
+        [[maybe_unused]] auto err = ::socketpair (AF_LOCAL, SOCK_STREAM, 0, wakeupFds);
         jassert (err == 0);
 
+        fcntl (getReadHandle(), F_SETFL, fcntl (getReadHandle(), F_GETFL) | O_NONBLOCK);
+       #endif
+
         LinuxEventLoop::registerFdCallback (getReadHandle(),
                                             [this] (int fd)
                                             {
-                                                while (auto msg = popNextMessage (fd))
+                                                clearWakeup (fd);
+
+                                                while (auto msg = popNextMessage())
                                                 {
                                                     JUCE_TRY
                                                     {
@@ -50,25 +65,40 @@ public:
     {
         LinuxEventLoop::unregisterFdCallback (getReadHandle());
 
+        while (popNextMessage() != nullptr)
+        {}
+
         close (getReadHandle());
-        close (getWriteHandle());
+
+        if (getWriteHandle() != getReadHandle())
+            close (getWriteHandle());
 
         clearSingletonInstance();
     }
 
     //==============================================================================
-    void postMessage (MessageManager::MessageBase* const msg) noexcept
+    void postMessage (MessageManager::MessageBase* msg) noexcept
     {
-        ScopedLock sl (lock);
-        queue.add (msg);
+        // The queue links through the message itself, so a message that's already waiting
+        // to be delivered is posted again by wrapping it in another one
+        if (msg->isInQueue.exchange (true))
+        {
+            msg = new RepostedMessage (msg);
+            msg->isInQueue = true;
+        }
+
+        msg->incReferenceCount();
+        push (msg);
 
-        if (bytesInSocket < maxBytesInSocketQueue)
+        if (! wakeupPending.exchange (true))
         {
-            bytesInSocket++;
+           #if JUCE_LINUX
+            const uint64 x = 1;
+           #else
+            const unsigned char x = 0xff;
+           #endif
 
-            ScopedUnlock ul (lock);
-            unsigned char x = 0xff;
-            [[maybe_unused]] auto numBytes = write (getWriteHandle(), &x, 1);
+            [[maybe_unused]] auto numBytes = write (getWriteHandle(), &x, sizeof (x));
         }
     }
 
@@ -76,30 +106,92 @@ public:
     JUCE_DECLARE_SINGLETON (InternalMessageQueue, false)
 
 private:
-    CriticalSection lock;
-    ReferenceCountedArray <MessageManager::MessageBase> queue;
+    using MessageBase = MessageManager::MessageBase;
+
+    struct RepostedMessage final : public MessageBase
+    {
+        explicit RepostedMessage (MessageBase::Ptr m) : message (std::move (m)) {}
+        void messageCallback() override    { message->messageCallback(); }
+
+        MessageBase::Ptr message;
+    };
+
+    struct Stub final : public MessageBase
+    {
+        void messageCallback() override    {}
+    };
+
+    // head is where producers add messages, tail is where the message thread removes them
+    const MessageBase::Ptr stub { new Stub() };
+    std::atomic<MessageBase*> head { stub.get() };
+    MessageBase* tail = stub.get();
 
-    int msgpipe[2];
-    int bytesInSocket = 0;
-    static constexpr int maxBytesInSocketQueue = 128;
+    std::atomic<bool> wakeupPending { false };
+    int wakeupFds[2];
 
-    int getWriteHandle() const noexcept  { return msgpipe[0]; }
-    int getReadHandle() const noexcept   { return msgpipe[1]; }
+    int getWriteHandle() const noexcept  { return wakeupFds[0]; }
+    int getReadHandle() const noexcept   { return wakeupFds[1]; }
 
-    MessageManager::MessageBase::Ptr popNextMessage (int fd) noexcept
+    void push (MessageBase* msg) noexcept
     {
-        const ScopedLock sl (lock);
+        msg->nextInQueue.store (nullptr, std::memory_order_relaxed);
+        auto* previous = head.exchange (msg, std::memory_order_acq_rel);
+        previous->nextInQueue.store (msg, std::memory_order_release);
+    }
 
-        if (bytesInSocket > 0)
+    void clearWakeup (int fd) noexcept
+    {
+       #if JUCE_LINUX
+        uint64 x;
+       #else
+        unsigned char x[64];
+       #endif
+
+        while (read (fd, &x, sizeof (x)) > 0)
+        {}
+
+        // Any message posted after this point will wake us up again, so it's safe to
+        // stop reading from the queue as soon as it looks empty
+        wakeupPending.exchange (false);
+    }
+
+    // Only called on the message thread
+    MessageBase::Ptr popNextMessage() noexcept
+    {
+        auto* msg = tail;
+        auto* next = msg->nextInQueue.load (std::memory_order_acquire);
+
+        if (msg == stub.get())
+        {
+            if (next == nullptr)
+                return nullptr;
+
+            tail = msg = next;
+            next = msg->nextInQueue.load (std::memory_order_acquire);
+        }
+
+        if (next == nullptr)
         {
-            --bytesInSocket;
+            // Another thread is part-way through posting a message, and will wake us up
+            // again once it's finished
+            if (msg != head.load (std::memory_order_acquire))
+                return nullptr;
+
+            // The last message can only be removed once something else follows it
+            push (stub.get());
+            next = msg->nextInQueue.load (std::memory_order_acquire);
 
-            ScopedUnlock ul (lock);
-            unsigned char x;
-            [[maybe_unused]] auto numBytes = read (fd, &x, 1);
+            if (next == nullptr)
+                return nullptr;
         }
 
-        return queue.removeAndReturn (0);
+        tail = next;
+
+        msg->isInQueue.store (false, std::memory_order_release);
+
+        MessageBase::Ptr result (msg);
+        msg->decReferenceCount();
+        return result;
     }
 };
 
@@ -111,8 +203,10 @@ JUCE_IMPLEMENT_SINGLETON (InternalMessageQueue)
 
     The callback for a particular FD should be called whenever that file has data to read.
 
-    For standalone apps, the main thread will call poll to wait for new data on any FD, and then
-    call the associated callbacks for any FDs that changed.
+    For standalone apps, the main thread will wait for new data on any FD, and then call the
+    associated callbacks for all the FDs that changed in one batch. On Linux this uses an
+    epoll set, so the cost of each wait doesn't depend on how many FDs are registered.
+    Elsewhere, poll is called with the full set of FDs.
 
     For plugins, the host (generally) provides some kind of run loop mechanism instead.
     - In VST2 plugins, the host should call effEditIdle at regular intervals, and plugins can
@@ -128,13 +222,41 @@ JUCE_IMPLEMENT_SINGLETON (InternalMessageQueue)
 struct InternalRunLoop
 {
 public:
-    InternalRunLoop() = default;
+    InternalRunLoop()
+    {
+       #if JUCE_LINUX
+        epollFd = epoll_create1 (EPOLL_CLOEXEC);
+        jassert (epollFd >= 0);
+       #endif
+    }
+
+    ~InternalRunLoop()
+    {
+       #if JUCE_LINUX
+        close (epollFd);
+       #endif
+    }
 
     void registerFdCallback (int fd, std::function<void()>&& cb, short eventMask)
     {
         {
             const ScopedLock sl (lock);
 
+           #if JUCE_LINUX
+            if (callbacks.emplace (fd, std::make_shared<std::function<void()>> (std::move (cb))).second)
+            {
+                epoll_event event{};
+                event.events = (uint32_t) (unsigned short) eventMask;
+                event.data.fd = fd;
+
+                [[maybe_unused]] const auto result = epoll_ctl (epollFd, EPOLL_CTL_ADD, fd, &event);
+                jassert (result == 0);
+            }
+            else
+            {
+                jassertfalse;
+            }
+           #else
             callbacks.emplace (fd, std::make_shared<std::function<void()>> (std::move (cb)));
 
             const auto iter = getPollfd (fd);
@@ -145,6 +267,7 @@ public:
                 jassertfalse;
 
             jassert (pfdsAreSorted());
+           #endif
         }
 
         listeners.call ([] (auto& l) { l.fdCallbacksChanged(); });
@@ -155,6 +278,16 @@ public:
         {
             const ScopedLock sl (lock);
 
+           #if JUCE_LINUX
+            if (callbacks.erase (fd) != 0)
+            {
+                epoll_ctl (epollFd, EPOLL_CTL_DEL, fd, nullptr);
+            }
+            else
+            {
+                jassertfalse;
+            }
+           #else
             callbacks.erase (fd);
 
             const auto iter = getPollfd (fd);
@@ -165,6 +298,7 @@ public:
                 jassertfalse;
 
             jassert (pfdsAreSorted());
+           #endif
         }
 
         listeners.call ([] (auto& l) { l.fdCallbacksChanged(); });
@@ -175,9 +309,11 @@ public:
         callbackStorage.clear();
         getFunctionsToCallThisTime (callbackStorage);
 
-        // CriticalSection should be available during the callback
-        for (auto& fn : callbackStorage)
-            (*fn)();
+        // CriticalSection should be available during the callback. A callback earlier in the
+        // batch may have unregistered one of the later ones, in which case it's skipped.
+        for (auto& weakFn : callbackStorage)
+            if (const auto fn = weakFn.lock())
+                (*fn)();
 
         return ! callbackStorage.empty();
     }
@@ -198,8 +334,14 @@ public:
 
     bool sleepUntilNextEvent (int timeoutMs)
     {
+       #if JUCE_LINUX
+        // The epoll set can be changed by other threads while we wait, so the lock isn't held here
+        epoll_event event;
+        return epoll_wait (epollFd, &event, 1, timeoutMs) != 0;
+       #else
         const ScopedLock sl (lock);
         return poll (pfds.data(), static_cast<nfds_t> (pfds.size()), timeoutMs) != 0;
+       #endif
     }
 
     std::vector<int> getRegisteredFds()
@@ -222,15 +364,33 @@ public:
 
 private:
     using SharedCallback = std::shared_ptr<std::function<void()>>;
+    using WeakCallback = std::weak_ptr<std::function<void()>>;
 
     /*  Appends any functions that need to be called to the passed-in vector.
 
-        We take a copy of each shared function so that the functions can be called without
-        locking or racing in the event that the function attempts to register/deregister a
-        new FD callback.
+        We take a weak reference to each shared function so that the functions can be called
+        without locking or racing in the event that the function attempts to register/deregister
+        a new FD callback, and so that a function whose FD is unregistered before its turn
+        comes won't be called.
     */
-    void getFunctionsToCallThisTime (std::vector<SharedCallback>& functions)
+    void getFunctionsToCallThisTime (std::vector<WeakCallback>& functions)
     {
+       #if JUCE_LINUX
+        // Only the FDs that are ready are returned, however many are registered. If there are
+        // more than fit in the buffer, epoll hands out the rest next time round.
+        std::array<epoll_event, 64> events;
+        const auto numEvents = epoll_wait (epollFd, events.data(), (int) events.size(), 0);
+
+        const ScopedLock sl (lock);
+
+        for (int i = 0; i < numEvents; ++i)
+        {
+            const auto iter = callbacks.find (events[(size_t) i].data.fd);
+
+            if (iter != callbacks.end())
+                functions.emplace_back (iter->second);
+        }
+       #else
         const ScopedLock sl (lock);
 
         if (! sleepUntilNextEvent (0))
@@ -246,8 +406,12 @@ private:
                     functions.emplace_back (iter->second);
             }
         }
+       #endif
     }
 
+   #if JUCE_LINUX
+    int epollFd = -1;
+   #else
     std::vector<pollfd>::iterator getPollfd (int fd)
     {
         return std::lower_bound (pfds.begin(), pfds.end(), fd, [] (auto descriptor, auto toFind)
@@ -261,11 +425,13 @@ private:
         return std::is_sorted (pfds.begin(), pfds.end(), [] (auto a, auto b) { return a.fd < b.fd; });
     }
 
+    std::vector<pollfd> pfds;
+   #endif
+
     CriticalSection lock;
 
     std::map<int, SharedCallback> callbacks;
-    std::vector<SharedCallback> callbackStorage;
-    std::vector<pollfd> pfds;
+    std::vector<WeakCallback> callbackStorage;
 
     ListenerList<LinuxEventLoopInternal::Listener> listeners;
 };
@@ -393,4 +559,289 @@ std::vector<int> LinuxEventLoopInternal::getRegisteredFds()
     return {};
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class InternalMessageQueueTests final : public UnitTest
+{
+public:
+    InternalMessageQueueTests() : UnitTest ("InternalMessageQueue", UnitTestCategories::native) {}
+
+    void runTest() override
+    {
+        // Messages can only be delivered by the thread that runs the message loop
+        if (! MessageManager::getInstance()->isThisTheMessageThread())
+        {
+            logMessage ("Skipped, because the tests aren't running on the message thread");
+            return;
+        }
+
+        auto& runLoop = *InternalRunLoop::getInstanceWithoutCreating();
+
+        beginTest ("Messages from many threads arrive once each, in the order each thread posted them");
+        {
+            constexpr int numProducers = 8, messagesPerProducer = 5000;
+
+            InternalMessageQueue queue;
+            std::vector<int> nextExpected (numProducers, 0);
+            int numReceived = 0, numOutOfOrder = 0;
+
+            std::vector<std::thread> producers;
+
+            for (int p = 0; p < numProducers; ++p)
+            {
+                producers.emplace_back ([&, p]
+                {
+                    for (int i = 0; i < messagesPerProducer; ++i)
+                    {
+                        queue.postMessage (new FunctionMessage ([&, p, i]
+                        {
+                            if (nextExpected[(size_t) p]++ != i)
+                                ++numOutOfOrder;
+
+                            ++numReceived;
+                        }));
+
+                        if (i % 500 == 0)
+                            Thread::yield();
+                    }
+                });
+            }
+
+            // Each wait ends as soon as the queue's fd is signalled, so if a wakeup were lost
+            // with messages still queued, this would time out
+            bool timedOut = false;
+
+            while (numReceived < numProducers * messagesPerProducer)
+            {
+                if (! runLoop.dispatchPendingEvents() && ! runLoop.sleepUntilNextEvent (5000))
+                {
+                    timedOut = true;
+                    break;
+                }
+            }
+
+            for (auto& producer : producers)
+                producer.join();
+
+            expect (! timedOut);
+            expectEquals (numReceived, numProducers * messagesPerProducer);
+            expectEquals (numOutOfOrder, 0);
+        }
+
+        beginTest ("A message that's still queued can be posted again");
+        {
+            InternalMessageQueue queue;
+            int numCalls = 0;
+
+            MessageManager::MessageBase::Ptr message (new FunctionMessage ([&] { ++numCalls; }));
+
+            for (int i = 0; i < 3; ++i)
+                queue.postMessage (message.get());
+
+            for (int attempts = 0; numCalls < 3 && attempts < 100; ++attempts)
+                if (! runLoop.dispatchPendingEvents())
+                    runLoop.sleepUntilNextEvent (100);
+
+            expectEquals (numCalls, 3);
+            expectEquals (message->getReferenceCount(), 1);
+
+            // once it's been delivered it goes back through the queue directly
+            queue.postMessage (message.get());
+
+            for (int attempts = 0; numCalls < 4 && attempts < 100; ++attempts)
+                if (! runLoop.dispatchPendingEvents())
+                    runLoop.sleepUntilNextEvent (100);
+
+            expectEquals (numCalls, 4);
+            expectEquals (message->getReferenceCount(), 1);
+        }
+
+        beginTest ("Messages that are still queued are released when the queue is deleted");
+        {
+            struct CountedMessage final : public MessageManager::MessageBase
+            {
+                CountedMessage (int& calls, int& deletions)  : numCalls (calls), numDeletions (deletions) {}
+                ~CountedMessage() override          { ++numDeletions; }
+                void messageCallback() override     { ++numCalls; }
+
+                int& numCalls;
+                int& numDeletions;
+            };
+
+            int numCalls = 0, numDeletions = 0;
+
+            {
+                InternalMessageQueue queue;
+
+                for (int i = 0; i < 100; ++i)
+                    queue.postMessage (new CountedMessage (numCalls, numDeletions));
+            }
+
+            expectEquals (numCalls, 0);
+            expectEquals (numDeletions, 100);
+        }
+    }
+
+private:
+    struct FunctionMessage final : public MessageManager::MessageBase
+    {
+        explicit FunctionMessage (std::function<void()> fn)  : function (std::move (fn)) {}
+        void messageCallback() override     { function(); }
+
+        std::function<void()> function;
+    };
+};
+
+static InternalMessageQueueTests internalMessageQueueTests;
+
+//==============================================================================
+class InternalRunLoopTests final : public UnitTest
+{
+public:
+    InternalRunLoopTests() : UnitTest ("InternalRunLoop", UnitTestCategories::native) {}
+
+    void runTest() override
+    {
+        beginTest ("Several ready fds are handled in one batch");
+        {
+            InternalRunLoop loop;
+            std::vector<std::unique_ptr<Pipe>> pipes;
+            int numCalls = 0;
+
+            for (int i = 0; i < 10; ++i)
+            {
+                pipes.push_back (std::make_unique<Pipe>());
+                auto& pipe = *pipes.back();
+                loop.registerFdCallback (pipe.getReadFd(), [&] { pipe.drain(); ++numCalls; }, POLLIN);
+                pipe.signal();
+            }
+
+            expect (loop.dispatchPendingEvents());
+            expectEquals (numCalls, 10);
+
+            expect (! loop.dispatchPendingEvents());
+            expectEquals (numCalls, 10);
+
+            for (auto& pipe : pipes)
+                loop.unregisterFdCallback (pipe->getReadFd());
+        }
+
+        beginTest ("Callbacks can register and unregister fds");
+        {
+            InternalRunLoop loop;
+            Pipe a, b;
+            int numCallsA = 0, numCallsB = 0;
+
+            loop.registerFdCallback (a.getReadFd(), [&]
+            {
+                a.drain();
+                ++numCallsA;
+                loop.unregisterFdCallback (a.getReadFd());
+                loop.registerFdCallback (b.getReadFd(), [&] { b.drain(); ++numCallsB; }, POLLIN);
+            }, POLLIN);
+
+            a.signal();
+            b.signal();
+
+            expect (loop.dispatchPendingEvents());
+            expectEquals (numCallsA, 1);
+            expectEquals (numCallsB, 0);
+
+            a.signal();
+            expect (loop.dispatchPendingEvents());
+            expectEquals (numCallsA, 1);
+            expectEquals (numCallsB, 1);
+
+            loop.unregisterFdCallback (b.getReadFd());
+        }
+
+       #if JUCE_LINUX
+        // Elsewhere, the poll() call holds the lock, so the set can't change during a wait
+        beginTest ("An fd registered by another thread during a wait wakes it up");
+        {
+            InternalRunLoop loop;
+            Pipe pipe;
+            int numCalls = 0;
+            pipe.signal();
+
+            std::thread registerer ([&]
+            {
+                Thread::sleep (50);
+                loop.registerFdCallback (pipe.getReadFd(), [&] { pipe.drain(); ++numCalls; }, POLLIN);
+            });
+
+            const auto start = Time::getMillisecondCounter();
+            expect (loop.sleepUntilNextEvent (5000));
+            expect (Time::getMillisecondCounter() - start < 4000);
+
+            registerer.join();
+            expect (loop.dispatchPendingEvents());
+            expectEquals (numCalls, 1);
+
+            loop.unregisterFdCallback (pipe.getReadFd());
+        }
+       #endif
+
+        beginTest ("An fd that's unregistered after its event was fetched isn't called");
+        {
+            InternalRunLoop loop;
+            Pipe a, b;
+            int numCalls = 0;
+
+            // whichever runs first removes the other, even though both were ready
+            loop.registerFdCallback (a.getReadFd(), [&] { a.drain(); ++numCalls; loop.unregisterFdCallback (b.getReadFd()); }, POLLIN);
+            loop.registerFdCallback (b.getReadFd(), [&] { b.drain(); ++numCalls; loop.unregisterFdCallback (a.getReadFd()); }, POLLIN);
+
+            a.signal();
+            b.signal();
+
+            expect (loop.dispatchPendingEvents());
+            expectEquals (numCalls, 1);
+            expectEquals ((int) loop.getRegisteredFds().size(), 1);
+
+            loop.unregisterFdCallback (loop.getRegisteredFds().front());
+        }
+    }
+
+private:
+    struct Pipe
+    {
+        Pipe()
+        {
+            [[maybe_unused]] const auto result = pipe (fds);
+            jassert (result == 0);
+            fcntl (fds[0], F_SETFL, fcntl (fds[0], F_GETFL) | O_NONBLOCK);
+        }
+
+        ~Pipe()
+        {
+            close (fds[0]);
+            close (fds[1]);
+        }
+
+        int getReadFd() const noexcept  { return fds[0]; }
+
+        void signal()
+        {
+            const char x = 0;
+            [[maybe_unused]] const auto numBytes = write (fds[1], &x, 1);
+        }
+
+        void drain()
+        {
+            char buffer[16];
+
+            while (read (fds[0], buffer, sizeof (buffer)) > 0)
+            {}
+        }
+
+        int fds[2];
+    };
+};
+
+static InternalRunLoopTests internalRunLoopTests;
+
+#endif
+
 } // namespace juce
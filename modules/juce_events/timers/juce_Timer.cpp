@@ -23,6 +23,261 @@
 namespace juce
 {
 
+//==============================================================================
+/*  A hierarchical timing wheel, which lets entries be added, removed and rescheduled in
+    constant time, however many of them there are.
+
+    Each level of the wheel has 64 slots, and each slot on a level spans 64 times as many
+    ticks as a slot on the level below it. An entry is put into the lowest level that can
+    reach its due time, and whenever a level wraps around, the next slot of the level above
+    is emptied into the levels below. Entries become expired on the tick they're due, and
+    are kept in a list in the order that they expired.
+*/
+template <typename ItemType>
+class TimerWheel
+{
+public:
+    using EntryIndex = size_t;
+    static constexpr EntryIndex invalidIndex = std::numeric_limits<EntryIndex>::max();
+
+    TimerWheel() = default;
+
+    /** Adds an item that will expire after the given number of ticks. */
+    EntryIndex add (ItemType item, int64 delayTicks)
+    {
+        EntryIndex index;
+
+        if (freeEntries.empty())
+        {
+            index = entries.size();
+            entries.emplace_back();
+        }
+        else
+        {
+            index = freeEntries.back();
+            freeEntries.pop_back();
+        }
+
+        entries[index].item = item;
+        schedule (index, delayTicks);
+        return index;
+    }
+
+    /** Removes an entry, whether or not it has expired. */
+    void remove (EntryIndex index)
+    {
+        unlink (index);
+        entries[index].item = {};
+        freeEntries.push_back (index);
+    }
+
+    /** Moves an entry so that it'll expire after the given number of ticks from now. */
+    void reschedule (EntryIndex index, int64 delayTicks)
+    {
+        unlink (index);
+        schedule (index, delayTicks);
+    }
+
+    /** Moves time on, expiring any entries that become due. */
+    void advance (int64 numTicks)
+    {
+        const auto targetTick = currentTick + numTicks;
+
+        while (currentTick < targetTick)
+        {
+            if (numInWheel == 0)
+            {
+                currentTick = targetTick;
+                break;
+            }
+
+            // If nothing else on the lowest level is due before it wraps, skip straight to the end of it
+            const auto slot = (int) (currentTick & slotMask);
+
+            if (slot < slotMask && (occupied[0] >> (slot + 1)) == 0)
+            {
+                const auto lastTickOfRotation = currentTick + (slotMask - slot);
+
+                if (lastTickOfRotation >= targetTick)
+                {
+                    currentTick = targetTick;
+                    break;
+                }
+
+                currentTick = lastTickOfRotation;
+            }
+
+            processTick (++currentTick);
+        }
+    }
+
+    /** Returns the oldest expired entry, or invalidIndex if there aren't any. */
+    EntryIndex getFirstExpired() const noexcept             { return lists[expiredList].head; }
+
+    const ItemType& getItem (EntryIndex index) const        { return entries[index].item; }
+
+    /** Returns the number of ticks before anything could next expire, or -1 if there's nothing left to expire.
+        This may be an underestimate if the next entry is on one of the wheel's upper levels.
+    */
+    int64 getTicksUntilNextExpiry() const noexcept
+    {
+        if (getFirstExpired() != invalidIndex)
+            return 0;
+
+        if (numInWheel == 0)
+            return -1;
+
+        const auto slot = (int) (currentTick & slotMask);
+
+        for (int i = slot + 1; i < slotsPerLevel; ++i)
+            if ((occupied[0] & ((uint64) 1 << i)) != 0)
+                return i - slot;
+
+        return slotsPerLevel - slot;
+    }
+
+    int64 getCurrentTick() const noexcept                   { return currentTick; }
+
+private:
+    static constexpr int bitsPerLevel = 6;
+    static constexpr int slotsPerLevel = 1 << bitsPerLevel;
+    static constexpr int slotMask = slotsPerLevel - 1;
+    static constexpr int numLevels = 6;
+    static constexpr int expiredList = numLevels * slotsPerLevel;
+
+    struct Entry
+    {
+        ItemType item {};
+        int64 dueTick = 0;
+        EntryIndex previous = invalidIndex, next = invalidIndex;
+        int list = -1;
+    };
+
+    struct List
+    {
+        EntryIndex head = invalidIndex, tail = invalidIndex;
+    };
+
+    std::vector<Entry> entries;
+    std::vector<EntryIndex> freeEntries;
+    List lists[expiredList + 1];
+    uint64 occupied[numLevels] = {};
+    int64 currentTick = 0;
+    size_t numInWheel = 0;
+
+    //==============================================================================
+    void schedule (EntryIndex index, int64 delayTicks)
+    {
+        entries[index].dueTick = currentTick + delayTicks;
+        insert (index);
+    }
+
+    void insert (EntryIndex index)
+    {
+        const auto dueTick = entries[index].dueTick;
+        const auto delay = dueTick - currentTick;
+
+        if (delay <= 0)
+        {
+            append (index, expiredList);
+            return;
+        }
+
+        int level = 0;
+
+        while (level < numLevels - 1 && (delay >> ((level + 1) * bitsPerLevel)) != 0)
+            ++level;
+
+        const auto slot = (int) ((dueTick >> (level * bitsPerLevel)) & slotMask);
+        append (index, level * slotsPerLevel + slot);
+        occupied[level] |= (uint64) 1 << slot;
+        ++numInWheel;
+    }
+
+    void append (EntryIndex index, int listIndex)
+    {
+        auto& entry = entries[index];
+        auto& list = lists[listIndex];
+
+        entry.list = listIndex;
+        entry.previous = list.tail;
+        entry.next = invalidIndex;
+
+        if (list.tail != invalidIndex)
+            entries[list.tail].next = index;
+        else
+            list.head = index;
+
+        list.tail = index;
+    }
+
+    void unlink (EntryIndex index)
+    {
+        auto& entry = entries[index];
+        auto& list = lists[entry.list];
+
+        if (entry.previous != invalidIndex)  entries[entry.previous].next = entry.next;
+        else                                 list.head = entry.next;
+
+        if (entry.next != invalidIndex)      entries[entry.next].previous = entry.previous;
+        else                                 list.tail = entry.previous;
+
+        if (entry.list != expiredList)
+        {
+            --numInWheel;
+
+            if (list.head == invalidIndex)
+                occupied[entry.list / slotsPerLevel] &= ~((uint64) 1 << (entry.list & slotMask));
+        }
+
+        entry.list = -1;
+    }
+
+    void processTick (int64 tick)
+    {
+        int topLevel = 0;
+
+        while (topLevel < numLevels - 1 && (tick & ((int64 { 1 } << ((topLevel + 1) * bitsPerLevel)) - 1)) == 0)
+            ++topLevel;
+
+        // Going from the top down means that anything moved from a higher level into one that's
+        // also wrapping on this tick gets moved down again
+        for (int level = topLevel; level > 0; --level)
+        {
+            const auto slot = (int) ((tick >> (level * bitsPerLevel)) & slotMask);
+            auto& list = lists[level * slotsPerLevel + slot];
+
+            for (auto index = std::exchange (list.head, invalidIndex); index != invalidIndex;)
+            {
+                const auto next = entries[index].next;
+                --numInWheel;
+                insert (index);
+                index = next;
+            }
+
+            list.tail = invalidIndex;
+            occupied[level] &= ~((uint64) 1 << slot);
+        }
+
+        const auto slot = (int) (tick & slotMask);
+        auto& list = lists[slot];
+
+        for (auto index = std::exchange (list.head, invalidIndex); index != invalidIndex;)
+        {
+            const auto next = entries[index].next;
+            --numInWheel;
+            append (index, expiredList);
+            index = next;
+        }
+
+        list.tail = invalidIndex;
+        occupied[0] &= ~((uint64) 1 << slot);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (TimerWheel)
+};
+
+//==============================================================================
 class Timer::TimerThread final : private Thread
 {
 public:
@@ -30,7 +285,6 @@ public:
 
     TimerThread()  : Thread ("JUCE Timer")
     {
-        timers.reserve (32);
     }
 
     ~TimerThread() override
@@ -42,17 +296,11 @@ public:
 
     void run() override
     {
-        auto lastTime = Time::getMillisecondCounter();
         ReferenceCountedObjectPtr<CallTimersMessage> messageToSend (new CallTimersMessage());
 
         while (! threadShouldExit())
         {
-            auto now = Time::getMillisecondCounter();
-            auto elapsed = (int) (now >= lastTime ? (now - lastTime)
-                                                  : (std::numeric_limits<uint32>::max() - (lastTime - now)));
-            lastTime = now;
-
-            auto timeUntilFirstTimer = getTimeUntilFirstTimer (elapsed);
+            auto timeUntilFirstTimer = getTimeUntilFirstTimer();
 
             if (timeUntilFirstTimer <= 0)
             {
@@ -88,16 +336,18 @@ public:
 
         const LockType::ScopedLockType sl (lock);
 
-        while (! timers.empty())
+        advanceToCurrentTime();
+
+        // All the timers that have become due are called in the same message callback
+        for (;;)
         {
-            auto& first = timers.front();
+            auto index = wheel.getFirstExpired();
 
-            if (first.countdownMs > 0)
+            if (index == Wheel::invalidIndex)
                 break;
 
-            auto* timer = first.timer;
-            first.countdownMs = timer->timerPeriodMs;
-            shuffleTimerBackInQueue (0);
+            auto* timer = wheel.getItem (index);
+            wheel.reschedule (index, timer->timerPeriodMs);
             notify();
 
             const LockType::ScopedUnlockType ul (lock);
@@ -130,14 +380,10 @@ public:
 
         // Trying to add a timer that's already here - shouldn't get to this point,
         // so if you get this assertion, let me know!
-        jassert (std::none_of (timers.begin(), timers.end(),
-                               [t] (TimerCountdown i) { return i.timer == t; }));
+        jassert (t->positionInQueue == Wheel::invalidIndex);
 
-        auto pos = timers.size();
-
-        timers.push_back ({ t, t->timerPeriodMs });
-        t->positionInQueue = pos;
-        shuffleTimerForwardInQueue (pos);
+        advanceToCurrentTime();
+        t->positionInQueue = wheel.add (t, t->timerPeriodMs);
         notify();
     }
 
@@ -145,56 +391,31 @@ public:
     {
         const LockType::ScopedLockType sl (lock);
 
-        auto pos = t->positionInQueue;
-        auto lastIndex = timers.size() - 1;
-
-        jassert (pos <= lastIndex);
-        jassert (timers[pos].timer == t);
-
-        for (auto i = pos; i < lastIndex; ++i)
-        {
-            timers[i] = timers[i + 1];
-            timers[i].timer->positionInQueue = i;
-        }
+        jassert (t->positionInQueue != Wheel::invalidIndex);
+        jassert (wheel.getItem (t->positionInQueue) == t);
 
-        timers.pop_back();
+        wheel.remove (t->positionInQueue);
+        t->positionInQueue = Wheel::invalidIndex;
     }
 
     void resetTimerCounter (Timer* t) noexcept
     {
         const LockType::ScopedLockType sl (lock);
 
-        auto pos = t->positionInQueue;
-
-        jassert (pos < timers.size());
-        jassert (timers[pos].timer == t);
+        jassert (t->positionInQueue != Wheel::invalidIndex);
+        jassert (wheel.getItem (t->positionInQueue) == t);
 
-        auto lastCountdown = timers[pos].countdownMs;
-        auto newCountdown = t->timerPeriodMs;
-
-        if (newCountdown != lastCountdown)
-        {
-            timers[pos].countdownMs = newCountdown;
-
-            if (newCountdown > lastCountdown)
-                shuffleTimerBackInQueue (pos);
-            else
-                shuffleTimerForwardInQueue (pos);
-
-            notify();
-        }
+        advanceToCurrentTime();
+        wheel.reschedule (t->positionInQueue, t->timerPeriodMs);
+        notify();
     }
 
 private:
-    LockType lock;
-
-    struct TimerCountdown
-    {
-        Timer* timer;
-        int countdownMs;
-    };
+    using Wheel = TimerWheel<Timer*>;
 
-    std::vector<TimerCountdown> timers;
+    LockType lock;
+    Wheel wheel;
+    uint32 lastTime = Time::getMillisecondCounter();
 
     WaitableEvent callbackArrived;
 
@@ -210,67 +431,24 @@ private:
     };
 
     //==============================================================================
-    void shuffleTimerBackInQueue (size_t pos)
+    void advanceToCurrentTime()
     {
-        auto numTimers = timers.size();
+        auto now = Time::getMillisecondCounter();
+        auto elapsed = (int64) (now >= lastTime ? (now - lastTime)
+                                                : (std::numeric_limits<uint32>::max() - (lastTime - now)));
+        lastTime = now;
 
-        if (pos < numTimers - 1)
-        {
-            auto t = timers[pos];
-
-            for (;;)
-            {
-                auto next = pos + 1;
-
-                if (next == numTimers || timers[next].countdownMs >= t.countdownMs)
-                    break;
-
-                timers[pos] = timers[next];
-                timers[pos].timer->positionInQueue = pos;
-
-                ++pos;
-            }
-
-            timers[pos] = t;
-            t.timer->positionInQueue = pos;
-        }
+        wheel.advance (elapsed);
     }
 
-    void shuffleTimerForwardInQueue (size_t pos)
-    {
-        if (pos > 0)
-        {
-            auto t = timers[pos];
-
-            while (pos > 0)
-            {
-                auto& prev = timers[(size_t) pos - 1];
-
-                if (prev.countdownMs <= t.countdownMs)
-                    break;
-
-                timers[pos] = prev;
-                timers[pos].timer->positionInQueue = pos;
-
-                --pos;
-            }
-
-            timers[pos] = t;
-            t.timer->positionInQueue = pos;
-        }
-    }
-
-    int getTimeUntilFirstTimer (int numMillisecsElapsed)
+    int getTimeUntilFirstTimer()
     {
         const LockType::ScopedLockType sl (lock);
 
-        if (timers.empty())
-            return 1000;
+        advanceToCurrentTime();
 
-        for (auto& t : timers)
-            t.countdownMs -= numMillisecsElapsed;
-
-        return timers.front().countdownMs;
+        auto ticks = wheel.getTicksUntilNextExpiry();
+        return ticks < 0 ? 1000 : (int) ticks;
     }
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TimerThread)
@@ -361,4 +539,120 @@ void JUCE_CALLTYPE Timer::callAfterDelay (int milliseconds, std::function<void()
     new LambdaInvoker (milliseconds, std::move (f));
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class TimerWheelTests final : public UnitTest
+{
+public:
+    TimerWheelTests() : UnitTest ("TimerWheel", UnitTestCategories::time) {}
+
+    void runTest() override
+    {
+        using Wheel = TimerWheel<int>;
+
+        const auto popExpired = [] (Wheel& wheel)
+        {
+            Array<int> items;
+
+            for (auto index = wheel.getFirstExpired(); index != Wheel::invalidIndex; index = wheel.getFirstExpired())
+            {
+                items.add (wheel.getItem (index));
+                wheel.remove (index);
+            }
+
+            return items;
+        };
+
+        beginTest ("Entries expire on the tick they're due");
+        {
+            const int64 delays[] = { 1, 2, 63, 64, 65, 127, 128, 4095, 4096, 4097, 262143, 262144, 262145, 300000 };
+
+            Wheel wheel;
+            wheel.advance (12345);
+            const auto startTick = wheel.getCurrentTick();
+
+            for (int i = 0; i < numElementsInArray (delays); ++i)
+                wheel.add (i, delays[i]);
+
+            int numExpired = 0;
+
+            while (numExpired < numElementsInArray (delays))
+            {
+                wheel.advance (1);
+
+                for (auto i : popExpired (wheel))
+                {
+                    expectEquals (wheel.getCurrentTick() - startTick, delays[i]);
+                    ++numExpired;
+                }
+            }
+        }
+
+        beginTest ("Entries expire during the advance that passes their due time");
+        {
+            auto rng = getRandom();
+            Wheel wheel;
+            Array<int64> dueTicks;
+
+            for (int i = 0; i < 2000; ++i)
+            {
+                const auto delay = (int64) 1 + rng.nextInt (i % 10 == 0 ? 20000000 : 5000);
+                dueTicks.add (wheel.getCurrentTick() + delay);
+                wheel.add (i, delay);
+            }
+
+            int numExpired = 0;
+
+            while (numExpired < dueTicks.size())
+            {
+                const auto previousTick = wheel.getCurrentTick();
+                const auto ticksUntilNext = wheel.getTicksUntilNextExpiry();
+                expect (ticksUntilNext > 0);
+
+                wheel.advance (ticksUntilNext - 1);
+                expect (wheel.getFirstExpired() == Wheel::invalidIndex);
+
+                wheel.advance (1 + rng.nextInt (rng.nextBool() ? 50 : 100000));
+
+                for (auto i : popExpired (wheel))
+                {
+                    expect (dueTicks[i] > previousTick && dueTicks[i] <= wheel.getCurrentTick());
+                    ++numExpired;
+                }
+            }
+
+            expectEquals (wheel.getTicksUntilNextExpiry(), (int64) -1);
+        }
+
+        beginTest ("Entries can be removed and rescheduled");
+        {
+            Wheel wheel;
+            const auto a = wheel.add (1, 100);
+            wheel.add (2, 100);
+            const auto c = wheel.add (3, 100);
+            const auto d = wheel.add (4, 5000);
+
+            wheel.remove (a);
+            wheel.reschedule (c, 10);
+            wheel.reschedule (d, 100);
+
+            wheel.advance (10);
+            expect (popExpired (wheel) == Array<int> (3));
+
+            wheel.advance (89);
+            expect (popExpired (wheel).isEmpty());
+
+            wheel.advance (1);
+            expect (popExpired (wheel) == Array<int> (2, 4));
+            expectEquals (wheel.getTicksUntilNextExpiry(), (int64) -1);
+        }
+    }
+};
+
+static TimerWheelTests timerWheelTests;
+
+#endif
+
 } // namespace juce
@@ -0,0 +1,1278 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+enum class DisplayList::OperationType : uint8
+{
+    setOrigin,
+    addTransform,
+    clipToRectangle,
+    clipToRectangleList,
+    excludeClipRectangle,
+    clipToPath,
+    clipToImageAlpha,
+    saveState,
+    restoreState,
+    beginTransparencyLayer,
+    endTransparencyLayer,
+    setFill,
+    setOpacity,
+    setInterpolationQuality,
+    setFont,
+
+    // Everything from here on draws something
+    fillRect,
+    fillRectReplacing,
+    fillRectFloat,
+    fillRectList,
+    fillPath,
+    drawImage,
+    drawLine,
+    drawPolyline,
+    fillWaveformColumns,
+    drawGlyph
+};
+
+struct DisplayList::Operation
+{
+    bool isDrawing() const noexcept     { return type >= OperationType::fillRect; }
+
+    void setTransform (const AffineTransform& t) noexcept
+    {
+        args.floats[0] = t.mat00;  args.floats[1] = t.mat01;  args.floats[2] = t.mat02;
+        args.floats[3] = t.mat10;  args.floats[4] = t.mat11;  args.floats[5] = t.mat12;
+    }
+
+    AffineTransform getTransform() const noexcept
+    {
+        return { args.floats[0], args.floats[1], args.floats[2],
+                 args.floats[3], args.floats[4], args.floats[5] };
+    }
+
+    void setRectangle (Rectangle<int> r) noexcept
+    {
+        args.ints[0] = r.getX();  args.ints[1] = r.getY();  args.ints[2] = r.getWidth();  args.ints[3] = r.getHeight();
+    }
+
+    Rectangle<int> getRectangle() const noexcept
+    {
+        return { args.ints[0], args.ints[1], args.ints[2], args.ints[3] };
+    }
+
+    void setRectangle (Rectangle<float> r) noexcept
+    {
+        args.floats[0] = r.getX();  args.floats[1] = r.getY();  args.floats[2] = r.getWidth();  args.floats[3] = r.getHeight();
+    }
+
+    Rectangle<float> getFloatRectangle() const noexcept
+    {
+        return { args.floats[0], args.floats[1], args.floats[2], args.floats[3] };
+    }
+
+    OperationType type;
+
+    // An index into one of the list's pools of paths, images, fills, fonts, rectangle
+    // lists or float arrays, or the glyph number or resampling quality for the operations that use those.
+    int index = -1;
+
+    // For drawing operations, the state in which the operation was recorded, and the
+    // area which it could have affected.
+    int state = -1;
+    Rectangle<int> area;
+
+    union
+    {
+        float floats[6];
+        int ints[6];
+    } args {};
+};
+
+struct DisplayList::State
+{
+    AffineTransform transform;
+    int fill, font, scope;
+    float opacity;
+    Graphics::ResamplingQuality quality;
+};
+
+/*  An operation that restricts the drawing which follows it until the state is restored,
+    i.e. a change to the clip region or the start of a transparency layer. These form a
+    tree, so that the full set that applies to any operation can be found by following
+    the parent links.
+*/
+struct DisplayList::Scope
+{
+    int parent, operation;
+    AffineTransform transform;
+    Graphics::ResamplingQuality quality;
+};
+
+struct DisplayList::RecordedFill
+{
+    FillType fill;
+    int image;
+};
+
+class DisplayList::ImageWatcher final  : private ImagePixelData::Listener
+{
+public:
+    explicit ImageWatcher (const Image& im)  : image (im)
+    {
+        if (auto* data = image.getPixelData())
+            data->listeners.add (this);
+    }
+
+    ~ImageWatcher() override
+    {
+        if (auto* data = image.getPixelData())
+            data->listeners.remove (this);
+    }
+
+    bool hasChanged() const noexcept    { return changed; }
+
+    const Image image;
+
+private:
+    void imageDataChanged (ImagePixelData*) override        { changed = true; }
+    void imageDataBeingDeleted (ImagePixelData*) override   {}
+
+    std::atomic<bool> changed { false };
+
+    JUCE_DECLARE_NON_COPYABLE (ImageWatcher)
+};
+
+//==============================================================================
+DisplayList::DisplayList() = default;
+DisplayList::~DisplayList() = default;
+DisplayList::DisplayList (DisplayList&&) noexcept = default;
+DisplayList& DisplayList::operator= (DisplayList&&) noexcept = default;
+
+void DisplayList::clear()
+{
+    operations.clear();
+    states.clear();
+    scopes.clear();
+    paths.clear();
+    fills.clear();
+    fonts.clear();
+    rectangleLists.clear();
+    floatRectangleLists.clear();
+    floatArrays.clear();
+    images.clear();
+    bounds = {};
+    numDrawingOperations = 0;
+}
+
+//==============================================================================
+void DisplayList::replay (LowLevelGraphicsContext& target) const
+{
+    replay (target, bounds);
+}
+
+void DisplayList::replay (LowLevelGraphicsContext& g, Rectangle<int> areaToDraw) const
+{
+    if (! bounds.intersects (areaToDraw))
+        return;
+
+    // Each entry is true for a transparency layer, or false for a saved state.
+    std::vector<bool> openScopes;
+
+    g.saveState();
+
+    for (auto& op : operations)
+    {
+        if (op.isDrawing() && ! op.area.intersects (areaToDraw))
+            continue;
+
+        switch (op.type)
+        {
+            case OperationType::setOrigin:                g.setOrigin ({ op.args.ints[0], op.args.ints[1] }); break;
+            case OperationType::addTransform:             g.addTransform (op.getTransform()); break;
+            case OperationType::clipToRectangle:          g.clipToRectangle (op.getRectangle()); break;
+            case OperationType::clipToRectangleList:      g.clipToRectangleList (rectangleLists[(size_t) op.index]); break;
+            case OperationType::excludeClipRectangle:     g.excludeClipRectangle (op.getRectangle()); break;
+            case OperationType::clipToPath:               g.clipToPath (paths[(size_t) op.index], op.getTransform()); break;
+            case OperationType::clipToImageAlpha:         g.clipToImageAlpha (images[(size_t) op.index]->image, op.getTransform()); break;
+
+            case OperationType::saveState:
+                g.saveState();
+                openScopes.push_back (false);
+                break;
+
+            case OperationType::beginTransparencyLayer:
+                g.beginTransparencyLayer (op.args.floats[0]);
+                openScopes.push_back (true);
+                break;
+
+            case OperationType::restoreState:
+            case OperationType::endTransparencyLayer:
+                if (! openScopes.empty())
+                {
+                    if (op.type == OperationType::endTransparencyLayer)
+                        g.endTransparencyLayer();
+                    else
+                        g.restoreState();
+
+                    openScopes.pop_back();
+                }
+
+                break;
+
+            case OperationType::setFill:                  g.setFill (fills[(size_t) op.index].fill); break;
+            case OperationType::setOpacity:               g.setOpacity (op.args.floats[0]); break;
+            case OperationType::setInterpolationQuality:  g.setInterpolationQuality ((Graphics::ResamplingQuality) op.index); break;
+            case OperationType::setFont:                  g.setFont (fonts[(size_t) op.index]); break;
+
+            case OperationType::fillRect:                 g.fillRect (op.getRectangle(), false); break;
+            case OperationType::fillRectReplacing:        g.fillRect (op.getRectangle(), true); break;
+            case OperationType::fillRectFloat:            g.fillRect (op.getFloatRectangle()); break;
+            case OperationType::fillRectList:             g.fillRectList (floatRectangleLists[(size_t) op.index]); break;
+            case OperationType::fillPath:                 g.fillPath (paths[(size_t) op.index], op.getTransform()); break;
+            case OperationType::drawImage:                g.drawImage (images[(size_t) op.index]->image, op.getTransform()); break;
+            case OperationType::drawGlyph:                g.drawGlyph (op.index, op.getTransform()); break;
+
+            case OperationType::drawLine:
+                g.drawLine ({ op.args.floats[0], op.args.floats[1], op.args.floats[2], op.args.floats[3] });
+                break;
+
+            case OperationType::drawPolyline:
+            {
+                // (the points are stored as interleaved x and y coordinates)
+                auto& coords = floatArrays[(size_t) op.index];
+                g.drawPolyline (reinterpret_cast<const Point<float>*> (coords.data()), (int) coords.size() / 2, op.args.floats[0]);
+                break;
+            }
+
+            case OperationType::fillWaveformColumns:
+            {
+                // (the tops are followed by the bottoms)
+                auto& levels = floatArrays[(size_t) op.index];
+                auto numColumns = levels.size() / 2;
+                g.fillWaveformColumns (op.args.floats[0], op.args.floats[1], levels.data(), levels.data() + numColumns, (int) numColumns);
+                break;
+            }
+        }
+    }
+
+    for (auto i = openScopes.size(); i > 0; --i)
+    {
+        if (openScopes[i - 1])
+            g.endTransparencyLayer();
+        else
+            g.restoreState();
+    }
+
+    g.restoreState();
+}
+
+void DisplayList::draw (Graphics& g, const AffineTransform& transform) const
+{
+    Graphics::ScopedSaveState state (g);
+    g.addTransform (transform);
+    replay (g.getInternalContext(), g.getClipBounds());
+}
+
+//==============================================================================
+template <typename RectangleListType>
+static bool rectangleListsMatch (const RectangleListType& a, const RectangleListType& b)
+{
+    return a.getNumRectangles() == b.getNumRectangles()
+            && std::equal (a.begin(), a.end(), b.begin());
+}
+
+bool DisplayList::imagesMatch (int a, const DisplayList& other, int b) const
+{
+    auto& imageA = *images[(size_t) a];
+    auto& imageB = *other.images[(size_t) b];
+
+    return imageA.image == imageB.image && ! imageA.hasChanged() && ! imageB.hasChanged();
+}
+
+bool DisplayList::fillsMatch (int a, const DisplayList& other, int b) const
+{
+    if (a < 0 || b < 0)
+        return a == b;
+
+    auto& fillA = fills[(size_t) a];
+    auto& fillB = other.fills[(size_t) b];
+
+    return fillA.fill == fillB.fill
+            && (fillA.image < 0 || imagesMatch (fillA.image, other, fillB.image));
+}
+
+bool DisplayList::scopesMatch (int a, const DisplayList& other, int b) const
+{
+    while (a >= 0 && b >= 0)
+    {
+        auto& scopeA = scopes[(size_t) a];
+        auto& scopeB = other.scopes[(size_t) b];
+
+        if (scopeA.transform != scopeB.transform
+             || scopeA.quality != scopeB.quality
+             || ! operationsMatch (operations[(size_t) scopeA.operation], other, other.operations[(size_t) scopeB.operation]))
+            return false;
+
+        a = scopeA.parent;
+        b = scopeB.parent;
+    }
+
+    return a < 0 && b < 0;
+}
+
+bool DisplayList::statesMatch (int a, const DisplayList& other, int b, bool compareFonts) const
+{
+    if (a < 0 || b < 0)
+        return a == b;
+
+    auto& stateA = states[(size_t) a];
+    auto& stateB = other.states[(size_t) b];
+
+    if (stateA.transform != stateB.transform
+         || ! exactlyEqual (stateA.opacity, stateB.opacity)
+         || stateA.quality != stateB.quality
+         || ! fillsMatch (stateA.fill, other, stateB.fill))
+        return false;
+
+    if (compareFonts)
+    {
+        if (stateA.font < 0 || stateB.font < 0)
+        {
+            if (stateA.font != stateB.font)
+                return false;
+        }
+        else if (fonts[(size_t) stateA.font] != other.fonts[(size_t) stateB.font])
+        {
+            return false;
+        }
+    }
+
+    return scopesMatch (stateA.scope, other, stateB.scope);
+}
+
+bool DisplayList::operationsMatch (const Operation& a, const DisplayList& other, const Operation& b) const
+{
+    if (a.type != b.type
+         || a.area != b.area
+         || memcmp (&a.args, &b.args, sizeof (a.args)) != 0
+         || ! statesMatch (a.state, other, b.state, a.type == OperationType::drawGlyph))
+        return false;
+
+    switch (a.type)
+    {
+        case OperationType::clipToRectangleList:  return rectangleListsMatch (rectangleLists[(size_t) a.index], other.rectangleLists[(size_t) b.index]);
+        case OperationType::fillRectList:         return rectangleListsMatch (floatRectangleLists[(size_t) a.index], other.floatRectangleLists[(size_t) b.index]);
+
+        case OperationType::clipToPath:
+        case OperationType::fillPath:             return paths[(size_t) a.index] == other.paths[(size_t) b.index];
+
+        case OperationType::clipToImageAlpha:
+        case OperationType::drawImage:            return imagesMatch (a.index, other, b.index);
+
+        case OperationType::drawGlyph:            return a.index == b.index;
+
+        case OperationType::drawPolyline:
+        case OperationType::fillWaveformColumns:  return floatArrays[(size_t) a.index] == other.floatArrays[(size_t) b.index];
+
+        case OperationType::setOrigin:
+        case OperationType::addTransform:
+        case OperationType::clipToRectangle:
+        case OperationType::excludeClipRectangle:
+        case OperationType::saveState:
+        case OperationType::restoreState:
+        case OperationType::beginTransparencyLayer:
+        case OperationType::endTransparencyLayer:
+        case OperationType::setFill:
+        case OperationType::setOpacity:
+        case OperationType::setInterpolationQuality:
+        case OperationType::setFont:
+        case OperationType::fillRect:
+        case OperationType::fillRectReplacing:
+        case OperationType::fillRectFloat:
+        case OperationType::drawLine:
+            break;
+    }
+
+    return true;
+}
+
+uint64 DisplayList::getMatchingHash (const Operation& op) const noexcept
+{
+    // This only covers the cheap parts of an operation, and is used to quickly rule
+    // out pairs of operations before doing a full comparison.
+    uint64 hash = 14695981039346656037ull;
+
+    auto add = [&hash] (uint32 value)
+    {
+        hash = (hash ^ value) * 1099511628211ull;
+    };
+
+    auto addFloat = [&add] (float value)
+    {
+        uint32 bits;
+        memcpy (&bits, &value, sizeof (bits));
+        add (bits);
+    };
+
+    add ((uint32) op.type);
+    add ((uint32) op.area.getX());
+    add ((uint32) op.area.getY());
+    add ((uint32) op.area.getWidth());
+    add ((uint32) op.area.getHeight());
+
+    uint32 args[6];
+    memcpy (args, &op.args, sizeof (args));
+
+    for (auto value : args)
+        add (value);
+
+    if (op.type == OperationType::drawGlyph)
+        add ((uint32) op.index);
+
+    if (op.state >= 0)
+    {
+        auto& state = states[(size_t) op.state];
+
+        for (auto value : { state.transform.mat00, state.transform.mat01, state.transform.mat02,
+                            state.transform.mat10, state.transform.mat11, state.transform.mat12,
+                            state.opacity })
+            addFloat (value);
+    }
+
+    return hash;
+}
+
+RectangleList<int> DisplayList::findChangedArea (const DisplayList& oldList, const DisplayList& newList)
+{
+    struct DrawingOperation
+    {
+        const Operation* op;
+        uint64 hash;
+    };
+
+    auto getDrawingOperations = [] (const DisplayList& list)
+    {
+        std::vector<DrawingOperation> result;
+        result.reserve ((size_t) list.numDrawingOperations);
+
+        for (auto& op : list.operations)
+            if (op.isDrawing())
+                result.push_back ({ &op, list.getMatchingHash (op) });
+
+        return result;
+    };
+
+    const auto oldOps = getDrawingOperations (oldList);
+    const auto newOps = getDrawingOperations (newList);
+
+    auto matches = [&] (size_t i, size_t j)
+    {
+        return oldOps[i].hash == newOps[j].hash
+                && oldList.operationsMatch (*oldOps[i].op, newList, *newOps[j].op);
+    };
+
+    // Pairs of operations are matched up in order, so that every pixel sees the same sequence
+    // of matched operations in both lists. Any pixel which isn't touched by an unmatched
+    // operation must therefore end up the same. When there's a mismatch, the nearest pair
+    // that does match is searched for, so that an operation being inserted, removed or changed
+    // doesn't make everything that follows it look different.
+    constexpr size_t maxLookAhead = 32;
+
+    RectangleList<int> changedArea;
+    size_t i = 0, j = 0;
+
+    while (i < oldOps.size() && j < newOps.size())
+    {
+        if (matches (i, j))
+        {
+            ++i;
+            ++j;
+            continue;
+        }
+
+        auto nextI = i + 1, nextJ = j + 1;
+
+        for (size_t distance = 1; distance <= maxLookAhead; ++distance)
+        {
+            bool found = false;
+
+            for (size_t di = 0; di <= distance; ++di)
+            {
+                auto ti = i + di, tj = j + distance - di;
+
+                if (ti < oldOps.size() && tj < newOps.size() && matches (ti, tj))
+                {
+                    nextI = ti;
+                    nextJ = tj;
+                    found = true;
+                    break;
+                }
+            }
+
+            if (found)
+                break;
+        }
+
+        for (; i < nextI; ++i)  changedArea.add (oldOps[i].op->area);
+        for (; j < nextJ; ++j)  changedArea.add (newOps[j].op->area);
+    }
+
+    for (; i < oldOps.size(); ++i)  changedArea.add (oldOps[i].op->area);
+    for (; j < newOps.size(); ++j)  changedArea.add (newOps[j].op->area);
+
+    changedArea.consolidate();
+    return changedArea;
+}
+
+//==============================================================================
+Rectangle<int> LowLevelGraphicsDisplayListRecorder::ClipTracker::getDeviceClipBounds() const
+{
+    return stack->clip != nullptr ? stack->clip->getClipBounds() : Rectangle<int>();
+}
+
+Rectangle<int> LowLevelGraphicsDisplayListRecorder::ClipTracker::getGlyphBounds (int glyphNumber, const AffineTransform& t) const
+{
+    return stack->getGlyphBounds (glyphNumber, t);
+}
+
+//==============================================================================
+static Rectangle<int> getAffectedArea (Rectangle<float> geometry, Rectangle<int> clipBounds)
+{
+    // Anti-aliasing and image resampling can spill into the pixels that surround a
+    // shape, so the area is rounded outwards and given an extra pixel of margin.
+    auto limits = clipBounds.toFloat().expanded (2.0f);
+    auto left   = jmax (geometry.getX(),      limits.getX());
+    auto top    = jmax (geometry.getY(),      limits.getY());
+    auto right  = jmin (geometry.getRight(),  limits.getRight());
+    auto bottom = jmin (geometry.getBottom(), limits.getBottom());
+
+    if (! (left <= right && top <= bottom))
+        return {};
+
+    return Rectangle<float>::leftTopRightBottom (left, top, right, bottom)
+             .getSmallestIntegerContainer().expanded (1)
+             .getIntersection (clipBounds);
+}
+
+//==============================================================================
+LowLevelGraphicsDisplayListRecorder::LowLevelGraphicsDisplayListRecorder (DisplayList& listToRecordInto,
+                                                                          Rectangle<int> clipBounds,
+                                                                          float physicalPixelScale)
+    : list (listToRecordInto),
+      physicalScale (physicalPixelScale),
+      // The tracker never draws anything, so its image is only a placeholder.
+      trackerImage (Image::ARGB, 1, 1, false, SoftwareImageType()),
+      clipTracker (trackerImage, {}, RectangleList<int> (clipBounds))
+{
+    list.clear();
+    currentState.clipLimit = clipBounds;
+}
+
+LowLevelGraphicsDisplayListRecorder::~LowLevelGraphicsDisplayListRecorder() = default;
+
+DisplayList::Operation& LowLevelGraphicsDisplayListRecorder::addOperation (DisplayList::OperationType type)
+{
+    list.operations.emplace_back();
+    auto& op = list.operations.back();
+    op.type = type;
+    return op;
+}
+
+DisplayList::Operation* LowLevelGraphicsDisplayListRecorder::addDrawingOperation (DisplayList::OperationType type,
+                                                                                  Rectangle<int> deviceArea)
+{
+    auto area = deviceArea.getIntersection (clipTracker.getDeviceClipBounds())
+                          .getIntersection (currentState.clipLimit);
+
+    if (area.isEmpty())
+        return nullptr;
+
+    if (currentStateIndex < 0)
+    {
+        list.states.push_back ({ currentState.transform, currentState.fill, currentState.font,
+                                 currentState.scope, currentState.opacity, currentState.quality });
+        currentStateIndex = (int) list.states.size() - 1;
+    }
+
+    auto& op = addOperation (type);
+    op.state = currentStateIndex;
+    op.area = area;
+
+    list.bounds = list.bounds.getUnion (area);
+    ++list.numDrawingOperations;
+    return &op;
+}
+
+DisplayList::Operation* LowLevelGraphicsDisplayListRecorder::addDrawingOperation (DisplayList::OperationType type,
+                                                                                  Rectangle<float> deviceGeometry)
+{
+    return addDrawingOperation (type, getAffectedArea (deviceGeometry, clipTracker.getDeviceClipBounds()));
+}
+
+DisplayList::Operation& LowLevelGraphicsDisplayListRecorder::addScope (DisplayList::OperationType type)
+{
+    auto& op = addOperation (type);
+
+    list.scopes.push_back ({ currentState.scope, (int) list.operations.size() - 1,
+                             currentState.transform, currentState.quality });
+    currentState.scope = (int) list.scopes.size() - 1;
+    stateChanged();
+
+    return op;
+}
+
+void LowLevelGraphicsDisplayListRecorder::limitClip (Rectangle<float> deviceArea)
+{
+    // The tracker's clip bounds don't shrink when it's clipped to a shape, so the shape's
+    // own bounds are used to keep the areas of the operations that follow it tight.
+    currentState.clipLimit = getAffectedArea (deviceArea, currentState.clipLimit);
+}
+
+int LowLevelGraphicsDisplayListRecorder::addImage (const Image& image)
+{
+    auto& index = imageIndexes.emplace (image.getPixelData(), -1).first->second;
+
+    if (index < 0)
+    {
+        list.images.push_back (std::make_unique<DisplayList::ImageWatcher> (image));
+        index = (int) list.images.size() - 1;
+    }
+
+    return index;
+}
+
+//==============================================================================
+bool LowLevelGraphicsDisplayListRecorder::isVectorDevice() const    { return false; }
+
+void LowLevelGraphicsDisplayListRecorder::setOrigin (Point<int> o)
+{
+    clipTracker.setOrigin (o);
+    currentState.transform = AffineTransform::translation ((float) o.x, (float) o.y).followedBy (currentState.transform);
+    stateChanged();
+
+    auto& op = addOperation (DisplayList::OperationType::setOrigin);
+    op.args.ints[0] = o.x;
+    op.args.ints[1] = o.y;
+}
+
+void LowLevelGraphicsDisplayListRecorder::addTransform (const AffineTransform& t)
+{
+    clipTracker.addTransform (t);
+    currentState.transform = t.followedBy (currentState.transform);
+    stateChanged();
+
+    addOperation (DisplayList::OperationType::addTransform).setTransform (t);
+}
+
+float LowLevelGraphicsDisplayListRecorder::getPhysicalPixelScaleFactor()
+{
+    return physicalScale * clipTracker.getPhysicalPixelScaleFactor();
+}
+
+bool LowLevelGraphicsDisplayListRecorder::clipToRectangle (const Rectangle<int>& r)
+{
+    addScope (DisplayList::OperationType::clipToRectangle).setRectangle (r);
+    return clipTracker.clipToRectangle (r);
+}
+
+bool LowLevelGraphicsDisplayListRecorder::clipToRectangleList (const RectangleList<int>& clipRegion)
+{
+    list.rectangleLists.push_back (clipRegion);
+    addScope (DisplayList::OperationType::clipToRectangleList).index = (int) list.rectangleLists.size() - 1;
+    return clipTracker.clipToRectangleList (clipRegion);
+}
+
+void LowLevelGraphicsDisplayListRecorder::excludeClipRectangle (const Rectangle<int>& r)
+{
+    clipTracker.excludeClipRectangle (r);
+    addScope (DisplayList::OperationType::excludeClipRectangle).setRectangle (r);
+}
+
+void LowLevelGraphicsDisplayListRecorder::clipToPath (const Path& path, const AffineTransform& t)
+{
+    clipTracker.clipToPath (path, t);
+    limitClip (path.getBoundsTransformed (t.followedBy (currentState.transform)));
+    list.paths.push_back (path);
+
+    auto& op = addScope (DisplayList::OperationType::clipToPath);
+    op.index = (int) list.paths.size() - 1;
+    op.setTransform (t);
+}
+
+void LowLevelGraphicsDisplayListRecorder::clipToImageAlpha (const Image& image, const AffineTransform& t)
+{
+    clipTracker.clipToImageAlpha (image, t);
+    limitClip (image.getBounds().toFloat().transformedBy (t.followedBy (currentState.transform)));
+    auto imageIndex = addImage (image);
+
+    auto& op = addScope (DisplayList::OperationType::clipToImageAlpha);
+    op.index = imageIndex;
+    op.setTransform (t);
+}
+
+bool LowLevelGraphicsDisplayListRecorder::clipRegionIntersects (const Rectangle<int>& r)
+{
+    return clipTracker.clipRegionIntersects (r);
+}
+
+Rectangle<int> LowLevelGraphicsDisplayListRecorder::getClipBounds() const
+{
+    return clipTracker.getClipBounds();
+}
+
+bool LowLevelGraphicsDisplayListRecorder::isClipEmpty() const
+{
+    return clipTracker.isClipEmpty();
+}
+
+void LowLevelGraphicsDisplayListRecorder::saveState()
+{
+    clipTracker.saveState();
+    savedStates.push_back (currentState);
+    addOperation (DisplayList::OperationType::saveState);
+}
+
+void LowLevelGraphicsDisplayListRecorder::restoreState()
+{
+    if (savedStates.empty())
+    {
+        jassertfalse; // trying to pop with an empty stack!
+        return;
+    }
+
+    clipTracker.restoreState();
+    currentState = savedStates.back();
+    savedStates.pop_back();
+    stateChanged();
+
+    addOperation (DisplayList::OperationType::restoreState);
+}
+
+void LowLevelGraphicsDisplayListRecorder::beginTransparencyLayer (float opacity)
+{
+    // A layer has the same clip region as its parent, so there's no need to make the
+    // tracker allocate an image for it.
+    clipTracker.saveState();
+    savedStates.push_back (currentState);
+    addScope (DisplayList::OperationType::beginTransparencyLayer).args.floats[0] = opacity;
+}
+
+void LowLevelGraphicsDisplayListRecorder::endTransparencyLayer()
+{
+    if (savedStates.empty())
+    {
+        jassertfalse; // trying to pop with an empty stack!
+        return;
+    }
+
+    clipTracker.restoreState();
+    currentState = savedStates.back();
+    savedStates.pop_back();
+    stateChanged();
+
+    addOperation (DisplayList::OperationType::endTransparencyLayer);
+}
+
+//==============================================================================
+void LowLevelGraphicsDisplayListRecorder::setFill (const FillType& fillType)
+{
+    list.fills.push_back ({ fillType, fillType.isTiledImage() ? addImage (fillType.image) : -1 });
+    currentState.fill = (int) list.fills.size() - 1;
+    stateChanged();
+
+    addOperation (DisplayList::OperationType::setFill).index = currentState.fill;
+}
+
+void LowLevelGraphicsDisplayListRecorder::setOpacity (float newOpacity)
+{
+    currentState.opacity = newOpacity;
+    stateChanged();
+
+    addOperation (DisplayList::OperationType::setOpacity).args.floats[0] = newOpacity;
+}
+
+void LowLevelGraphicsDisplayListRecorder::setInterpolationQuality (Graphics::ResamplingQuality quality)
+{
+    currentState.quality = quality;
+    stateChanged();
+
+    addOperation (DisplayList::OperationType::setInterpolationQuality).index = (int) quality;
+}
+
+//==============================================================================
+void LowLevelGraphicsDisplayListRecorder::fillRect (const Rectangle<int>& r, bool replaceExistingContents)
+{
+    if (auto* op = addDrawingOperation (replaceExistingContents ? DisplayList::OperationType::fillRectReplacing
+                                                                : DisplayList::OperationType::fillRect,
+                                        r.toFloat().transformedBy (currentState.transform)))
+        op->setRectangle (r);
+}
+
+void LowLevelGraphicsDisplayListRecorder::fillRect (const Rectangle<float>& r)
+{
+    if (auto* op = addDrawingOperation (DisplayList::OperationType::fillRectFloat, r.transformedBy (currentState.transform)))
+        op->setRectangle (r);
+}
+
+void LowLevelGraphicsDisplayListRecorder::fillRectList (const RectangleList<float>& rects)
+{
+    if (auto* op = addDrawingOperation (DisplayList::OperationType::fillRectList, rects.getBounds().transformedBy (currentState.transform)))
+    {
+        list.floatRectangleLists.push_back (rects);
+        op->index = (int) list.floatRectangleLists.size() - 1;
+    }
+}
+
+void LowLevelGraphicsDisplayListRecorder::fillPath (const Path& path, const AffineTransform& t)
+{
+    if (auto* op = addDrawingOperation (DisplayList::OperationType::fillPath,
+                                        path.getBoundsTransformed (t.followedBy (currentState.transform))))
+    {
+        list.paths.push_back (path);
+        op->index = (int) list.paths.size() - 1;
+        op->setTransform (t);
+    }
+}
+
+void LowLevelGraphicsDisplayListRecorder::drawImage (const Image& image, const AffineTransform& t)
+{
+    if (auto* op = addDrawingOperation (DisplayList::OperationType::drawImage,
+                                        image.getBounds().toFloat().transformedBy (t.followedBy (currentState.transform))))
+    {
+        op->index = addImage (image);
+        op->setTransform (t);
+    }
+}
+
+void LowLevelGraphicsDisplayListRecorder::drawLine (const Line<float>& line)
+{
+    auto geometry = Rectangle<float> (line.getStart(), line.getEnd()).expanded (1.0f);
+
+    if (auto* op = addDrawingOperation (DisplayList::OperationType::drawLine, geometry.transformedBy (currentState.transform)))
+    {
+        op->args.floats[0] = line.getStartX();
+        op->args.floats[1] = line.getStartY();
+        op->args.floats[2] = line.getEndX();
+        op->args.floats[3] = line.getEndY();
+    }
+}
+
+void LowLevelGraphicsDisplayListRecorder::drawPolyline (const Point<float>* points, int numPoints, float lineThickness)
+{
+    auto geometry = Rectangle<float>::findAreaContainingPoints (points, numPoints).expanded (lineThickness);
+
+    if (auto* op = addDrawingOperation (DisplayList::OperationType::drawPolyline, geometry.transformedBy (currentState.transform)))
+    {
+        std::vector<float> coords;
+        coords.reserve ((size_t) numPoints * 2);
+
+        for (int i = 0; i < numPoints; ++i)
+        {
+            coords.push_back (points[i].x);
+            coords.push_back (points[i].y);
+        }
+
+        list.floatArrays.push_back (std::move (coords));
+        op->index = (int) list.floatArrays.size() - 1;
+        op->args.floats[0] = lineThickness;
+    }
+}
+
+void LowLevelGraphicsDisplayListRecorder::fillWaveformColumns (float x, float columnWidth,
+                                                               const float* tops, const float* bottoms, int numColumns)
+{
+    auto minY = std::numeric_limits<float>::max(), maxY = std::numeric_limits<float>::lowest();
+
+    for (int i = 0; i < numColumns; ++i)
+    {
+        if (tops[i] < bottoms[i])
+        {
+            minY = jmin (minY, tops[i]);
+            maxY = jmax (maxY, bottoms[i]);
+        }
+    }
+
+    if (minY > maxY)
+        return;
+
+    auto geometry = Rectangle<float>::leftTopRightBottom (x, minY, x + columnWidth * (float) numColumns, maxY);
+
+    if (auto* op = addDrawingOperation (DisplayList::OperationType::fillWaveformColumns, geometry.transformedBy (currentState.transform)))
+    {
+        std::vector<float> levels (tops, tops + numColumns);
+        levels.insert (levels.end(), bottoms, bottoms + numColumns);
+
+        list.floatArrays.push_back (std::move (levels));
+        op->index = (int) list.floatArrays.size() - 1;
+        op->args.floats[0] = x;
+        op->args.floats[1] = columnWidth;
+    }
+}
+
+void LowLevelGraphicsDisplayListRecorder::setFont (const Font& newFont)
+{
+    clipTracker.setFont (newFont);
+    list.fonts.push_back (newFont);
+    currentState.font = (int) list.fonts.size() - 1;
+    stateChanged();
+
+    addOperation (DisplayList::OperationType::setFont).index = currentState.font;
+}
+
+const Font& LowLevelGraphicsDisplayListRecorder::getFont()
+{
+    return clipTracker.getFont();
+}
+
+void LowLevelGraphicsDisplayListRecorder::drawGlyph (int glyphNumber, const AffineTransform& t)
+{
+    if (auto* op = addDrawingOperation (DisplayList::OperationType::drawGlyph, clipTracker.getGlyphBounds (glyphNumber, t)))
+    {
+        op->index = glyphNumber;
+        op->setTransform (t);
+    }
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class DisplayListTests final : public UnitTest
+{
+public:
+    DisplayListTests()
+        : UnitTest ("DisplayList", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        const Image sprite = createSprite();
+
+        beginTest ("Replaying a recording matches drawing directly");
+        {
+            for (auto format : { Image::ARGB, Image::RGB })
+            {
+                Image expected (format, width, height, true, SoftwareImageType());
+                Image actual (format, width, height, true, SoftwareImageType());
+
+                {
+                    Graphics g (expected);
+                    drawScene (g, sprite, {});
+                }
+
+                auto list = record (sprite, {});
+                expect (list.getNumDrawingOperations() > 50);
+                expect (list.getBounds() == expected.getBounds());
+
+                {
+                    LowLevelGraphicsSoftwareRenderer context (actual);
+                    list.replay (context);
+                }
+
+                expectEquals (countDifferentPixels (expected, actual, {}), 0);
+            }
+        }
+
+        beginTest ("Replaying part of a recording matches drawing directly");
+        {
+            const Rectangle<int> area (57, 31, 143, 97);
+            Image expected (Image::ARGB, width, height, true, SoftwareImageType());
+            Image actual (Image::ARGB, width, height, true, SoftwareImageType());
+
+            {
+                Graphics g (expected);
+                g.reduceClipRegion (area);
+                drawScene (g, sprite, {});
+            }
+
+            auto list = record (sprite, {});
+
+            {
+                LowLevelGraphicsSoftwareRenderer context (actual, {}, area);
+                list.replay (context, area);
+            }
+
+            expectEquals (countDifferentPixels (expected, actual, {}), 0);
+        }
+
+        beginTest ("Drawing a recording with a transform matches drawing directly");
+        {
+            const auto transform = AffineTransform::scale (1.5f).translated (-20.0f, 13.0f);
+            Image expected (Image::ARGB, width, height, true, SoftwareImageType());
+            Image actual (Image::ARGB, width, height, true, SoftwareImageType());
+
+            {
+                Graphics g (expected);
+                g.addTransform (transform);
+                drawScene (g, sprite, {});
+            }
+
+            auto list = record (sprite, {}, 1.5f, Rectangle<float> (width, height).transformedBy (transform.inverted())
+                                                                                   .getSmallestIntegerContainer());
+
+            {
+                Graphics g (actual);
+                list.draw (g, transform);
+            }
+
+            expectEquals (countDifferentPixels (expected, actual, {}), 0);
+        }
+
+        beginTest ("Identical recordings have no changed area");
+        {
+            auto a = record (sprite, {});
+            auto b = record (sprite, {});
+            expect (DisplayList::findChangedArea (a, b).isEmpty());
+            expect (DisplayList::findChangedArea (a, a).isEmpty());
+        }
+
+        beginTest ("The changed area covers every pixel that changes");
+        {
+            for (auto change : { Change::itemColour, Change::itemPosition, Change::itemRemoved, Change::itemAdded,
+                                 Change::clipShape, Change::textContent, Change::allItemsMoved })
+            {
+                for (int item = 0; item < numItems; item += 7)
+                {
+                    Modification modification { change, item };
+                    auto before = record (sprite, {});
+                    auto after = record (sprite, modification);
+                    auto changedArea = DisplayList::findChangedArea (before, after);
+
+                    expectEquals (countDifferentPixels (render (before), render (after), changedArea), 0);
+
+                    if (change != Change::allItemsMoved)
+                        expect (getArea (changedArea) < width * height / 4, "The changed area is too large");
+                }
+            }
+        }
+
+        beginTest ("Images that are modified after being recorded are reported as changed");
+        {
+            Image image (Image::ARGB, 20, 20, true, SoftwareImageType());
+
+            auto recordImage = [&image]
+            {
+                DisplayList list;
+                LowLevelGraphicsDisplayListRecorder recorder (list, { width, height });
+                Graphics g (recorder);
+                g.drawImageAt (image, 30, 40);
+                return list;
+            };
+
+            auto before = recordImage();
+            expect (DisplayList::findChangedArea (before, recordImage()).isEmpty());
+
+            image.setPixelAt (3, 3, Colours::red);
+
+            auto changedArea = DisplayList::findChangedArea (before, recordImage());
+            expect (changedArea.containsRectangle ({ 30, 40, 20, 20 }));
+        }
+
+        beginTest ("Clip queries are answered while recording");
+        {
+            DisplayList list;
+            LowLevelGraphicsDisplayListRecorder recorder (list, { width, height }, 2.0f);
+            Graphics g (recorder);
+
+            expect (g.getClipBounds() == Rectangle<int> (width, height));
+            expectEquals (recorder.getPhysicalPixelScaleFactor(), 2.0f);
+
+            g.reduceClipRegion (10, 20, 30, 40);
+            g.addTransform (AffineTransform::scale (2.0f));
+            expect (g.getClipBounds() == Rectangle<int> (5, 10, 15, 20));
+            expectEquals (recorder.getPhysicalPixelScaleFactor(), 4.0f);
+
+            g.fillRect (100, 100, 10, 10);
+            expect (list.isEmpty());
+
+            g.fillRect (5, 10, 10, 10);
+            expectEquals (list.getNumDrawingOperations(), 1);
+            expect (list.getBounds().contains (Rectangle<int> (10, 20, 20, 20)));
+            expect (Rectangle<int> (10, 20, 30, 40).contains (list.getBounds()));
+        }
+    }
+
+private:
+    static constexpr int width = 400, height = 300, numItems = 40;
+
+    enum class Change
+    {
+        none,
+        itemColour,
+        itemPosition,
+        itemRemoved,
+        itemAdded,
+        clipShape,
+        textContent,
+        allItemsMoved
+    };
+
+    struct Modification
+    {
+        Change change = Change::none;
+        int item = -1;
+    };
+
+    static Image createSprite()
+    {
+        Image sprite (Image::ARGB, 31, 19, true, SoftwareImageType());
+        Graphics g (sprite);
+        g.setGradientFill (ColourGradient (Colours::red, 0.0f, 0.0f, Colours::cyan.withAlpha (0.5f), 31.0f, 19.0f, false));
+        g.fillEllipse (sprite.getBounds().toFloat());
+        return sprite;
+    }
+
+    static void drawScene (Graphics& g, const Image& sprite, Modification modification)
+    {
+        auto isChanged = [&modification] (Change change, int item)
+        {
+            return modification.change == change && modification.item == item;
+        };
+
+        g.setGradientFill (ColourGradient (Colours::darkblue, 0.0f, 0.0f, Colours::orange, 200.0f, 300.0f, false));
+        g.fillAll();
+
+        for (int i = 0; i < numItems; ++i)
+        {
+            if (isChanged (Change::itemRemoved, i))
+                continue;
+
+            Random r (i);
+            auto area = Rectangle<float> (r.nextFloat() * (float) width, r.nextFloat() * (float) height,
+                                          5.0f + r.nextFloat() * 40.0f, 5.0f + r.nextFloat() * 30.0f);
+            auto colour = Colour ((uint32) r.nextInt()).withAlpha (0.3f + 0.7f * r.nextFloat());
+
+            if (isChanged (Change::itemColour, i))
+                colour = colour.contrasting();
+
+            if (isChanged (Change::itemPosition, i))
+                area.translate (7.0f, -3.0f);
+
+            if (modification.change == Change::allItemsMoved)
+                area.translate (0.0f, 1.0f);
+
+            g.setColour (colour);
+
+            switch (i % 5)
+            {
+                case 0:  g.fillRoundedRectangle (area, 4.5f); break;
+                case 1:  g.drawEllipse (area, 2.3f); break;
+                case 2:  g.drawLine ({ area.getTopLeft(), area.getBottomRight() }, 1.7f); break;
+                case 3:  g.drawImage (sprite, area); break;
+                default: g.fillRect (area); break;
+            }
+
+            if (isChanged (Change::itemAdded, i))
+                g.fillEllipse (area.translated (10.0f, 10.0f));
+        }
+
+        {
+            float tops[100], bottoms[100];
+
+            for (int i = 0; i < 100; ++i)
+            {
+                tops[i]    = 250.0f - 30.0f * std::abs (std::sin ((float) i * 0.13f));
+                bottoms[i] = 250.0f + 20.0f * std::abs (std::cos ((float) i * 0.09f));
+            }
+
+            g.setColour (Colours::lightgreen);
+            g.fillWaveformColumns (220.0f, 1.5f, tops, bottoms, 100);
+            g.setColour (Colours::darkgreen);
+            g.drawPolyline (220.0f, 1.5f, bottoms, 100, 1.5f);
+        }
+
+        for (int i = 0; i < 4; ++i)
+        {
+            Graphics::ScopedSaveState state (g);
+
+            Path star;
+            star.addStar ({ 50.0f + 100.0f * (float) i, 150.0f }, 5, 10.0f, 35.0f,
+                          isChanged (Change::clipShape, i * 7) ? 0.5f : 0.0f);
+            g.reduceClipRegion (star);
+
+            g.setGradientFill (ColourGradient (Colours::white, 0.0f, 100.0f, Colours::transparentBlack, 0.0f, 200.0f, false));
+            g.fillAll();
+        }
+
+        g.setColour (Colours::black);
+        g.setFont (15.0f);
+
+        for (int i = 0; i < 6; ++i)
+            g.drawText (isChanged (Change::textContent, i * 7) ? "Changed line" : "Line " + String (i),
+                        10, 20 + i * 45, 150, 20, Justification::centredLeft);
+    }
+
+    static DisplayList record (const Image& sprite, Modification modification,
+                               float scale = 1.0f, Rectangle<int> bounds = { width, height })
+    {
+        DisplayList list;
+        LowLevelGraphicsDisplayListRecorder recorder (list, bounds, scale);
+        Graphics g (recorder);
+        drawScene (g, sprite, modification);
+        return list;
+    }
+
+    static Image render (const DisplayList& list)
+    {
+        Image image (Image::ARGB, width, height, true, SoftwareImageType());
+        LowLevelGraphicsSoftwareRenderer context (image);
+        list.replay (context);
+        return image;
+    }
+
+    static int getArea (const RectangleList<int>& area)
+    {
+        int total = 0;
+
+        for (auto& r : area)
+            total += r.getWidth() * r.getHeight();
+
+        return total;
+    }
+
+    static int countDifferentPixels (const Image& a, const Image& b, const RectangleList<int>& areaToIgnore)
+    {
+        const Image::BitmapData dataA (a, Image::BitmapData::readOnly);
+        const Image::BitmapData dataB (b, Image::BitmapData::readOnly);
+        int numDifferences = 0;
+
+        for (int y = 0; y < dataA.height; ++y)
+            for (int x = 0; x < dataA.width; ++x)
+                if (memcmp (dataA.getPixelPointer (x, y), dataB.getPixelPointer (x, y), (size_t) dataA.pixelStride) != 0
+                     && ! areaToIgnore.containsPoint ({ x, y }))
+                    ++numDifferences;
+
+        return numDifferences;
+    }
+};
+
+static DisplayListTests displayListTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,265 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A recording of a sequence of drawing operations, which can be played back into
+    any LowLevelGraphicsContext.
+
+    A DisplayList is filled by painting into a LowLevelGraphicsDisplayListRecorder.
+    Each operation is stored compactly along with the area that it could have
+    affected, so a list can be replayed into just part of a target without visiting
+    the operations that don't touch it, and can be drawn with a different transform
+    without running the code that produced it again.
+
+    Two lists can also be compared with findChangedArea(), which works out which
+    parts of the image they'd produce could possibly differ. This makes it possible to
+    re-record something after its state has changed, and then repaint only the pixels
+    that actually need to be updated.
+
+    Any images that are drawn or used as clip masks are referenced rather than copied.
+    If one of them is modified after being recorded, the list notices, and treats the
+    operations that use it as having changed.
+
+    @see LowLevelGraphicsDisplayListRecorder, DisplayListCachedComponentImage
+
+    @tags{Graphics}
+*/
+class JUCE_API  DisplayList  final
+{
+public:
+    //==============================================================================
+    /** Creates an empty list. */
+    DisplayList();
+
+    /** Destructor. */
+    ~DisplayList();
+
+    DisplayList (DisplayList&&) noexcept;
+    DisplayList& operator= (DisplayList&&) noexcept;
+
+    //==============================================================================
+    /** Removes all the recorded operations. */
+    void clear();
+
+    /** Returns true if nothing has been drawn into this list. */
+    bool isEmpty() const noexcept                       { return numDrawingOperations == 0; }
+
+    /** Returns the number of drawing operations that have been recorded.
+        This doesn't include operations that just change the state, such as setFill()
+        or clipToRectangle().
+    */
+    int getNumDrawingOperations() const noexcept        { return numDrawingOperations; }
+
+    /** Returns the area that the list could draw into.
+        This is in the coordinate space that the list was recorded in.
+    */
+    Rectangle<int> getBounds() const noexcept           { return bounds; }
+
+    //==============================================================================
+    /** Plays back all the recorded operations into a context.
+
+        The operations are applied on top of the context's current state, so any
+        transform or clip region that it already has will affect them. The context's
+        state is left as it was found.
+    */
+    void replay (LowLevelGraphicsContext& target) const;
+
+    /** Plays back the recorded operations that could affect a given area.
+
+        The area is in the coordinate space that the list was recorded in. This
+        produces the same result as replaying everything, as long as the target's clip
+        region lies within the area.
+    */
+    void replay (LowLevelGraphicsContext& target, Rectangle<int> areaToDraw) const;
+
+    /** Plays back the list into a Graphics context, with an extra transform applied.
+        Only the operations that can affect the context's current clip region are replayed.
+    */
+    void draw (Graphics& g, const AffineTransform& transform = {}) const;
+
+    //==============================================================================
+    /** Compares two lists, and returns the area in which the images that they'd draw
+        could be different.
+
+        Operations which are identical and are drawn with an identical state in both
+        lists are matched up, and the result is the union of the bounds of all the
+        operations that couldn't be matched. Images which have been modified since
+        being recorded never match.
+    */
+    static RectangleList<int> findChangedArea (const DisplayList& oldList, const DisplayList& newList);
+
+private:
+    //==============================================================================
+    friend class LowLevelGraphicsDisplayListRecorder;
+
+    enum class OperationType : uint8;
+    struct Operation;
+    struct State;
+    struct Scope;
+    struct RecordedFill;
+    class ImageWatcher;
+
+    bool operationsMatch (const Operation&, const DisplayList&, const Operation&) const;
+    bool statesMatch (int, const DisplayList&, int, bool compareFonts) const;
+    bool scopesMatch (int, const DisplayList&, int) const;
+    bool fillsMatch (int, const DisplayList&, int) const;
+    bool imagesMatch (int, const DisplayList&, int) const;
+    uint64 getMatchingHash (const Operation&) const noexcept;
+
+    std::vector<Operation> operations;
+    std::vector<State> states;
+    std::vector<Scope> scopes;
+    std::vector<Path> paths;
+    std::vector<RecordedFill> fills;
+    std::vector<Font> fonts;
+    std::vector<RectangleList<int>> rectangleLists;
+    std::vector<RectangleList<float>> floatRectangleLists;
+    std::vector<std::vector<float>> floatArrays;
+    std::vector<std::unique_ptr<ImageWatcher>> images;
+    Rectangle<int> bounds;
+    int numDrawingOperations = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DisplayList)
+};
+
+//==============================================================================
+/**
+    A LowLevelGraphicsContext which records everything that's drawn into it as a
+    DisplayList.
+
+    The recorder keeps track of the clip region, transform and font in the same way
+    that a LowLevelGraphicsSoftwareRenderer would, so that queries such as
+    getClipBounds() return the right answers while the recording is being made.
+
+    @see DisplayList
+
+    @tags{Graphics}
+*/
+class JUCE_API  LowLevelGraphicsDisplayListRecorder    : public LowLevelGraphicsContext
+{
+public:
+    //==============================================================================
+    /** Creates a recorder which will write into the given list.
+
+        Anything that was already in the list is cleared. The list must not be used
+        for anything else until the recorder has been deleted.
+
+        @param listToRecordInto       the list that will be filled
+        @param clipBounds             the initial clip region
+        @param physicalPixelScale     the value that getPhysicalPixelScaleFactor() should return
+                                      before any transforms have been added, i.e. the scale
+                                      at which the list is likely to be replayed
+    */
+    LowLevelGraphicsDisplayListRecorder (DisplayList& listToRecordInto,
+                                         Rectangle<int> clipBounds,
+                                         float physicalPixelScale = 1.0f);
+
+    /** Destructor. */
+    ~LowLevelGraphicsDisplayListRecorder() override;
+
+    //==============================================================================
+    bool isVectorDevice() const override;
+    void setOrigin (Point<int>) override;
+    void addTransform (const AffineTransform&) override;
+    float getPhysicalPixelScaleFactor() override;
+
+    bool clipToRectangle (const Rectangle<int>&) override;
+    bool clipToRectangleList (const RectangleList<int>&) override;
+    void excludeClipRectangle (const Rectangle<int>&) override;
+    void clipToPath (const Path&, const AffineTransform&) override;
+    void clipToImageAlpha (const Image&, const AffineTransform&) override;
+
+    bool clipRegionIntersects (const Rectangle<int>&) override;
+    Rectangle<int> getClipBounds() const override;
+    bool isClipEmpty() const override;
+
+    void saveState() override;
+    void restoreState() override;
+
+    void beginTransparencyLayer (float opacity) override;
+    void endTransparencyLayer() override;
+
+    //==============================================================================
+    void setFill (const FillType&) override;
+    void setOpacity (float) override;
+    void setInterpolationQuality (Graphics::ResamplingQuality) override;
+
+    //==============================================================================
+    void fillRect (const Rectangle<int>&, bool replaceExistingContents) override;
+    void fillRect (const Rectangle<float>&) override;
+    void fillRectList (const RectangleList<float>&) override;
+    void fillPath (const Path&, const AffineTransform&) override;
+    void drawImage (const Image&, const AffineTransform&) override;
+    void drawLine (const Line<float>&) override;
+    void drawPolyline (const Point<float>*, int numPoints, float lineThickness) override;
+    void fillWaveformColumns (float x, float columnWidth, const float* tops, const float* bottoms, int numColumns) override;
+
+    void setFont (const Font&) override;
+    const Font& getFont() override;
+    void drawGlyph (int glyphNumber, const AffineTransform&) override;
+
+private:
+    //==============================================================================
+    struct ClipTracker  : public LowLevelGraphicsSoftwareRenderer
+    {
+        using LowLevelGraphicsSoftwareRenderer::LowLevelGraphicsSoftwareRenderer;
+        Rectangle<int> getDeviceClipBounds() const;
+        Rectangle<int> getGlyphBounds (int glyphNumber, const AffineTransform&) const;
+    };
+
+    struct SavedState
+    {
+        AffineTransform transform;
+        Rectangle<int> clipLimit;
+        int fill = -1, font = -1, scope = -1;
+        float opacity = 1.0f;
+        Graphics::ResamplingQuality quality = Graphics::mediumResamplingQuality;
+    };
+
+    DisplayList::Operation& addOperation (DisplayList::OperationType);
+    DisplayList::Operation* addDrawingOperation (DisplayList::OperationType, Rectangle<int> deviceArea);
+    DisplayList::Operation* addDrawingOperation (DisplayList::OperationType, Rectangle<float> deviceGeometry);
+    DisplayList::Operation& addScope (DisplayList::OperationType);
+    int addImage (const Image&);
+    void limitClip (Rectangle<float> deviceArea);
+    void stateChanged() noexcept                { currentStateIndex = -1; }
+
+    DisplayList& list;
+    const float physicalScale;
+    const Image trackerImage;
+    ClipTracker clipTracker;
+    SavedState currentState;
+    std::vector<SavedState> savedStates;
+    std::map<ImagePixelData*, int> imageIndexes;
+    int currentStateIndex = -1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LowLevelGraphicsDisplayListRecorder)
+};
+
+} // namespace juce
@@ -26,107 +26,8 @@
 namespace juce
 {
 
-struct GraphicsFontHelpers
-{
-    static auto compareFont (const Font& a, const Font& b) { return Font::compare (a, b); }
-};
-
-static auto operator< (const Font& a, const Font& b)
-{
-    return GraphicsFontHelpers::compareFont (a, b);
-}
-
-template <typename T>
-static auto operator< (const Rectangle<T>& a, const Rectangle<T>& b)
-{
-    const auto tie = [] (auto& t) { return std::make_tuple (t.getX(), t.getY(), t.getWidth(), t.getHeight()); };
-    return tie (a) < tie (b);
-}
-
-static auto operator< (const Justification& a, const Justification& b)
-{
-    return a.getFlags() < b.getFlags();
-}
-
-//==============================================================================
 namespace
 {
-    struct ConfiguredArrangement
-    {
-        void draw (const Graphics& g) const { arrangement.draw (g, transform); }
-
-        GlyphArrangement arrangement;
-        AffineTransform transform;
-    };
-
-    template <typename ArrangementArgs>
-    class GlyphArrangementCache final : public DeletedAtShutdown
-    {
-    public:
-        GlyphArrangementCache() = default;
-
-        ~GlyphArrangementCache() override
-        {
-            clearSingletonInstance();
-        }
-
-        template <typename ConfigureArrangement>
-        void draw (const Graphics& g, ArrangementArgs&& args, ConfigureArrangement&& configureArrangement)
-        {
-            const ScopedTryLock stl (lock);
-
-            if (! stl.isLocked())
-            {
-                configureArrangement (args).draw (g);
-                return;
-            }
-
-            const auto cached = [&]
-            {
-                const auto iter = cache.find (args);
-
-                if (iter != cache.end())
-                {
-                    if (iter->second.cachePosition != cacheOrder.begin())
-                        cacheOrder.splice (cacheOrder.begin(), cacheOrder, iter->second.cachePosition);
-
-                    return iter;
-                }
-
-                auto result = cache.emplace (std::move (args), CachedGlyphArrangement { configureArrangement (args), {} }).first;
-                cacheOrder.push_front (result);
-                return result;
-            }();
-
-            cached->second.cachePosition = cacheOrder.begin();
-            cached->second.configured.draw (g);
-
-            while (cache.size() > cacheSize)
-            {
-                cache.erase (cacheOrder.back());
-                cacheOrder.pop_back();
-            }
-        }
-
-        JUCE_DECLARE_SINGLETON (GlyphArrangementCache<ArrangementArgs>, false)
-
-    private:
-        struct CachedGlyphArrangement
-        {
-            using CachePtr = typename std::map<ArrangementArgs, CachedGlyphArrangement>::const_iterator;
-            ConfiguredArrangement configured;
-            typename std::list<CachePtr>::const_iterator cachePosition;
-        };
-
-        static constexpr size_t cacheSize = 128;
-        std::map<ArrangementArgs, CachedGlyphArrangement> cache;
-        std::list<typename CachedGlyphArrangement::CachePtr> cacheOrder;
-        CriticalSection lock;
-    };
-
-    template <typename ArrangementArgs>
-    juce::SingletonHolder<GlyphArrangementCache<ArrangementArgs>, juce::CriticalSection, false> GlyphArrangementCache<ArrangementArgs>::singletonHolder;
-
     //==============================================================================
     template <typename Type>
     Rectangle<Type> coordsToRectangle (Type x, Type y, Type w, Type h) noexcept
@@ -345,38 +246,28 @@ void Graphics::drawSingleLineText (const String& text, const int startX, const i
     if (flags == Justification::left && startX > context.getClipBounds().getRight())
         return;
 
-    struct ArrangementArgs
-    {
-        auto tie() const noexcept { return std::tie (font, text, startX, baselineY); }
-        bool operator< (const ArrangementArgs& other) const { return tie() < other.tie(); }
-
-        const Font font;
-        const String text;
-        const int startX, baselineY, flags;
-    };
-
-    auto configureArrangement = [] (const ArrangementArgs& args)
+    auto createArrangement = [] (const ShapedTextCache::ArrangementKey& key)
     {
         AffineTransform transform;
         GlyphArrangement arrangement;
-        arrangement.addLineOfText (args.font, args.text, (float) args.startX, (float) args.baselineY);
+        arrangement.addLineOfText (key.font, key.text, 0.0f, 0.0f);
 
-        if (args.flags != Justification::left)
+        if (key.justification != Justification::left)
         {
             auto w = arrangement.getBoundingBox (0, -1, true).getWidth();
 
-            if ((args.flags & (Justification::horizontallyCentred | Justification::horizontallyJustified)) != 0)
+            if ((key.justification & (Justification::horizontallyCentred | Justification::horizontallyJustified)) != 0)
                 w /= 2.0f;
 
             transform = AffineTransform::translation (-w, 0);
         }
 
-        return ConfiguredArrangement { std::move (arrangement), std::move (transform) };
+        return ShapedTextCache::ShapedArrangement { std::move (arrangement), std::move (transform) };
     };
 
-    GlyphArrangementCache<ArrangementArgs>::getInstance()->draw (*this,
-                                                                 { context.getFont(), text, startX, baselineY, flags },
-                                                                 std::move (configureArrangement));
+    ShapedTextCache::findOrCreateArrangement ({ ShapedTextCache::ArrangementKey::Method::singleLine, context.getFont(), text, 0, 0, 0, flags, 0 },
+                                              createArrangement)
+        ->draw (*this, AffineTransform::translation ((float) startX, (float) baselineY));
 }
 
 void Graphics::drawMultiLineText (const String& text, const int startX,
@@ -386,30 +277,17 @@ void Graphics::drawMultiLineText (const String& text, const int startX,
     if (text.isEmpty() || startX >= context.getClipBounds().getRight())
         return;
 
-    struct ArrangementArgs
-    {
-        auto tie() const noexcept { return std::tie (font, text, startX, baselineY, maximumLineWidth, justification, leading); }
-        bool operator< (const ArrangementArgs& other) const { return tie() < other.tie(); }
-
-        const Font font;
-        const String text;
-        const int startX, baselineY, maximumLineWidth;
-        const Justification justification;
-        const float leading;
-    };
-
-    auto configureArrangement = [] (const ArrangementArgs& args)
+    auto createArrangement = [] (const ShapedTextCache::ArrangementKey& key)
     {
         GlyphArrangement arrangement;
-        arrangement.addJustifiedText (args.font, args.text,
-                                      (float) args.startX, (float) args.baselineY, (float) args.maximumLineWidth,
-                                      args.justification, args.leading);
-        return ConfiguredArrangement { std::move (arrangement), {} };
+        arrangement.addJustifiedText (key.font, key.text, 0.0f, 0.0f, key.width, key.justification, key.extra);
+        return ShapedTextCache::ShapedArrangement { std::move (arrangement), {} };
     };
 
-    GlyphArrangementCache<ArrangementArgs>::getInstance()->draw (*this,
-                                                                 { context.getFont(), text, startX, baselineY, maximumLineWidth, justification, leading },
-                                                                 std::move (configureArrangement));
+    ShapedTextCache::findOrCreateArrangement ({ ShapedTextCache::ArrangementKey::Method::multiLine, context.getFont(), text,
+                                                (float) maximumLineWidth, 0, leading, justification.getFlags(), 0 },
+                                              createArrangement)
+        ->draw (*this, AffineTransform::translation ((float) startX, (float) baselineY));
 }
 
 void Graphics::drawText (const String& text, Rectangle<float> area,
@@ -418,33 +296,19 @@ void Graphics::drawText (const String& text, Rectangle<float> area,
     if (text.isEmpty() || ! context.clipRegionIntersects (area.getSmallestIntegerContainer()))
         return;
 
-    struct ArrangementArgs
-    {
-        auto tie() const noexcept { return std::tie (font, text, area, justificationType, useEllipsesIfTooBig); }
-        bool operator< (const ArrangementArgs& other) const { return tie() < other.tie(); }
-
-        const Font font;
-        const String text;
-        const Rectangle<float> area;
-        const Justification justificationType;
-        const bool useEllipsesIfTooBig;
-    };
-
-    auto configureArrangement = [] (const ArrangementArgs& args)
+    auto createArrangement = [] (const ShapedTextCache::ArrangementKey& key)
     {
         GlyphArrangement arrangement;
-        arrangement.addCurtailedLineOfText (args.font, args.text, 0.0f, 0.0f,
-                                            args.area.getWidth(), args.useEllipsesIfTooBig);
-
-        arrangement.justifyGlyphs (0, arrangement.getNumGlyphs(),
-                                   args.area.getX(), args.area.getY(), args.area.getWidth(), args.area.getHeight(),
-                                   args.justificationType);
-        return ConfiguredArrangement { std::move (arrangement), {} };
+        arrangement.addCurtailedLineOfText (key.font, key.text, 0.0f, 0.0f, key.width, key.useEllipsis);
+        arrangement.justifyGlyphs (0, arrangement.getNumGlyphs(), 0.0f, 0.0f, key.width, key.height, key.justification);
+        return ShapedTextCache::ShapedArrangement { std::move (arrangement), {} };
     };
 
-    GlyphArrangementCache<ArrangementArgs>::getInstance()->draw (*this,
-                                                                 { context.getFont(), text, area, justificationType, useEllipsesIfTooBig },
-                                                                 std::move (configureArrangement));
+    ShapedTextCache::findOrCreateArrangement ({ ShapedTextCache::ArrangementKey::Method::curtailedLine, context.getFont(), text,
+                                                area.getWidth(), area.getHeight(), 0, justificationType.getFlags(), 0,
+                                                useEllipsesIfTooBig },
+                                              createArrangement)
+        ->draw (*this, AffineTransform::translation (area.getX(), area.getY()));
 }
 
 void Graphics::drawText (const String& text, Rectangle<int> area,
@@ -467,34 +331,19 @@ void Graphics::drawFittedText (const String& text, Rectangle<int> area,
     if (text.isEmpty() || area.isEmpty() || ! context.clipRegionIntersects (area))
         return;
 
-    struct ArrangementArgs
-    {
-        auto tie() const noexcept { return std::tie (font, text, area, justification, maximumNumberOfLines, minimumHorizontalScale); }
-        bool operator< (const ArrangementArgs& other) const noexcept { return tie() < other.tie(); }
-
-        const Font font;
-        const String text;
-        const Rectangle<float> area;
-        const Justification justification;
-        const int maximumNumberOfLines;
-        const float minimumHorizontalScale;
-    };
-
-    auto configureArrangement = [] (const ArrangementArgs& args)
+    auto createArrangement = [] (const ShapedTextCache::ArrangementKey& key)
     {
         GlyphArrangement arrangement;
-        arrangement.addFittedText (args.font, args.text,
-                                   args.area.getX(), args.area.getY(),
-                                   args.area.getWidth(), args.area.getHeight(),
-                                   args.justification,
-                                   args.maximumNumberOfLines,
-                                   args.minimumHorizontalScale);
-        return ConfiguredArrangement { std::move (arrangement), {} };
+        arrangement.addFittedText (key.font, key.text, 0.0f, 0.0f, key.width, key.height,
+                                   key.justification, key.maximumLines, key.extra);
+        return ShapedTextCache::ShapedArrangement { std::move (arrangement), {} };
     };
 
-    GlyphArrangementCache<ArrangementArgs>::getInstance()->draw (*this,
-                                                                 { context.getFont(), text, area.toFloat(), justification, maximumNumberOfLines, minimumHorizontalScale },
-                                                                 std::move (configureArrangement));
+    ShapedTextCache::findOrCreateArrangement ({ ShapedTextCache::ArrangementKey::Method::fitted, context.getFont(), text,
+                                                (float) area.getWidth(), (float) area.getHeight(), minimumHorizontalScale,
+                                                justification.getFlags(), maximumNumberOfLines },
+                                              createArrangement)
+        ->draw (*this, AffineTransform::translation ((float) area.getX(), (float) area.getY()));
 }
 
 void Graphics::drawFittedText (const String& text, int x, int y, int width, int height,
@@ -572,9 +421,8 @@ void Graphics::strokePath (const Path& path,
                            const PathStrokeType& strokeType,
                            const AffineTransform& transform) const
 {
-    Path stroke;
-    strokeType.createStrokedPath (stroke, path, transform, context.getPhysicalPixelScaleFactor());
-    fillPath (stroke);
+    if (! (context.isClipEmpty() || path.isEmpty()))
+        fillPath (*path.getCachedStroke (strokeType, transform, context.getPhysicalPixelScaleFactor()));
 }
 
 //==============================================================================
@@ -721,6 +569,37 @@ void Graphics::fillCheckerBoard (Rectangle<float> area, float checkWidth, float
     }
 }
 
+//==============================================================================
+void LowLevelGraphicsContext::drawPolyline (const Point<float>* points, int numPoints, float lineThickness)
+{
+    if (numPoints < 2)
+        return;
+
+    Path p;
+    p.preallocateSpace (numPoints * 3);
+    p.startNewSubPath (points[0]);
+
+    for (int i = 1; i < numPoints; ++i)
+        p.lineTo (points[i]);
+
+    Path stroke;
+    PathStrokeType (lineThickness, PathStrokeType::beveled, PathStrokeType::butt).createStrokedPath (stroke, p);
+    fillPath (stroke, {});
+}
+
+void LowLevelGraphicsContext::fillWaveformColumns (float x, float columnWidth,
+                                                   const float* tops, const float* bottoms, int numColumns)
+{
+    RectangleList<float> columns;
+    columns.ensureStorageAllocated (numColumns);
+
+    for (int i = 0; i < numColumns; ++i)
+        if (tops[i] < bottoms[i])
+            columns.addWithoutMerging ({ x + (float) i * columnWidth, tops[i], columnWidth, bottoms[i] - tops[i] });
+
+    fillRectList (columns);
+}
+
 //==============================================================================
 void Graphics::drawVerticalLine (const int x, float top, float bottom) const
 {
@@ -734,6 +613,36 @@ void Graphics::drawHorizontalLine (const int y, float left, float right) const
         context.fillRect (Rectangle<float> (left, (float) y, right - left, 1.0f));
 }
 
+void Graphics::drawPolyline (const Point<float>* points, int numPoints, float lineThickness) const
+{
+    jassert (points != nullptr || numPoints == 0);
+
+    if (numPoints > 1 && lineThickness > 0.0f && ! context.isClipEmpty())
+        context.drawPolyline (points, numPoints, lineThickness);
+}
+
+void Graphics::drawPolyline (float x, float xSpacing, const float* yValues, int numValues, float lineThickness) const
+{
+    if (numValues < 2)
+        return;
+
+    HeapBlock<Point<float>> points ((size_t) numValues);
+
+    for (int i = 0; i < numValues; ++i)
+        points[i] = { x + (float) i * xSpacing, yValues[i] };
+
+    drawPolyline (points, numValues, lineThickness);
+}
+
+void Graphics::fillWaveformColumns (float x, float columnWidth,
+                                    const float* tops, const float* bottoms, int numColumns) const
+{
+    jassert ((tops != nullptr && bottoms != nullptr) || numColumns == 0);
+
+    if (numColumns > 0 && columnWidth > 0.0f && ! context.isClipEmpty())
+        context.fillWaveformColumns (x, columnWidth, tops, bottoms, numColumns);
+}
+
 void Graphics::drawLine (Line<float> line) const
 {
     context.drawLine (line);
@@ -428,6 +428,36 @@ public:
     */
     void drawHorizontalLine (int y, float left, float right) const;
 
+    /** Draws a line joining a sequence of points, using the current colour or brush.
+
+        The line has flat ends and bevelled joints. For long sequences such as the samples of
+        a waveform this is much cheaper than building a Path and stroking it, because the
+        renderer can rasterise the segments directly.
+
+        @see drawLine, strokePath
+    */
+    void drawPolyline (const Point<float>* points, int numPoints, float lineThickness = 1.0f) const;
+
+    /** Draws a line joining a sequence of evenly-spaced values, using the current colour or brush.
+
+        Value i is placed at (x + i * xSpacing, yValues[i]).
+
+        @see drawPolyline
+    */
+    void drawPolyline (float x, float xSpacing, const float* yValues, int numValues, float lineThickness = 1.0f) const;
+
+    /** Fills a row of adjacent vertical columns, such as the min/max levels of a waveform.
+
+        Column i spans horizontally from (x + i * columnWidth) to (x + (i + 1) * columnWidth), and
+        vertically from tops[i] to bottoms[i]. A column whose top isn't above its bottom is left
+        empty. This is much cheaper than filling a RectangleList with the same columns, because
+        the renderer can rasterise the outline of the whole waveform in one pass.
+
+        @see fillRectList
+    */
+    void fillWaveformColumns (float x, float columnWidth,
+                              const float* tops, const float* bottoms, int numColumns) const;
+
     //==============================================================================
     /** Fills a path using the currently selected colour or brush. */
     void fillPath (const Path& path) const;
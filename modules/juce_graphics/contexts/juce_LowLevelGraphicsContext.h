@@ -94,6 +94,18 @@ public:
     virtual void drawImage (const Image&, const AffineTransform&) = 0;
     virtual void drawLine (const Line<float>&) = 0;
 
+    /** Draws a bevel-jointed, butt-ended line through a series of points.
+        The default implementation strokes a Path, so renderers that can rasterise the
+        segments directly should override this.
+    */
+    virtual void drawPolyline (const Point<float>* points, int numPoints, float lineThickness);
+
+    /** Fills a row of adjacent vertical columns, see Graphics::fillWaveformColumns().
+        The default implementation fills a RectangleList.
+    */
+    virtual void fillWaveformColumns (float x, float columnWidth,
+                                      const float* tops, const float* bottoms, int numColumns);
+
     virtual void setFont (const Font&) = 0;
     virtual const Font& getFont() = 0;
     virtual void drawGlyph (int glyphNumber, const AffineTransform&) = 0;
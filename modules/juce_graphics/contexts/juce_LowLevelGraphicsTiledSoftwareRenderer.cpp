@@ -0,0 +1,631 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+struct LowLevelGraphicsTiledSoftwareRenderer::Command
+{
+    virtual ~Command() = default;
+    virtual void replay (LowLevelGraphicsContext&) const = 0;
+
+    // For drawing operations, this is the device-space clip bounds at the time the operation
+    // was recorded, so that tiles which it can't touch are able to skip it. It's left empty
+    // for operations that change the state, as those must always be replayed.
+    Rectangle<int> deviceArea;
+};
+
+template <typename Fn>
+struct LowLevelGraphicsTiledSoftwareRenderer::CommandWithFunction final  : public Command
+{
+    explicit CommandWithFunction (Fn&& f) : fn (std::move (f)) {}
+
+    void replay (LowLevelGraphicsContext& g) const override    { fn (g); }
+
+    Fn fn;
+};
+
+//==============================================================================
+/*  Wraps the pixels of the image that's being rendered onto, so that all the tiles can
+    share it without each one sending change messages to the image's listeners, which
+    wouldn't be thread-safe.
+*/
+class LowLevelGraphicsTiledSoftwareRenderer::TileTargetPixelData final  : public ImagePixelData
+{
+public:
+    explicit TileTargetPixelData (const Image::BitmapData& targetPixels)
+        : ImagePixelData (targetPixels.pixelFormat, targetPixels.width, targetPixels.height),
+          target (targetPixels)
+    {
+    }
+
+    std::unique_ptr<LowLevelGraphicsContext> createLowLevelContext() override
+    {
+        return std::make_unique<LowLevelGraphicsSoftwareRenderer> (Image (*this));
+    }
+
+    void initialiseBitmapData (Image::BitmapData& bitmap, int x, int y, Image::BitmapData::ReadWriteMode) override
+    {
+        bitmap.data = target.getPixelPointer (x, y);
+        bitmap.size = target.size - (size_t) (bitmap.data - target.data);
+        bitmap.pixelFormat = target.pixelFormat;
+        bitmap.lineStride = target.lineStride;
+        bitmap.pixelStride = target.pixelStride;
+    }
+
+    ImagePixelData::Ptr clone() override
+    {
+        Image newImage (SoftwareImageType().create (pixelFormat, width, height, false));
+        Image::BitmapData dest (newImage, Image::BitmapData::writeOnly);
+
+        for (int y = 0; y < height; ++y)
+            memcpy (dest.getLinePointer (y), target.getLinePointer (y), (size_t) (width * target.pixelStride));
+
+        return *newImage.getPixelData();
+    }
+
+    std::unique_ptr<ImageType> createType() const override    { return std::make_unique<SoftwareImageType>(); }
+
+private:
+    const Image::BitmapData& target;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TileTargetPixelData)
+};
+
+//==============================================================================
+/*  The tiles are claimed one at a time by the pool's threads and the thread that's
+    doing the rendering. This is reference-counted because a pool job may not get
+    started until all the tiles have already been finished by other threads.
+*/
+class LowLevelGraphicsTiledSoftwareRenderer::TileQueue final  : public ReferenceCountedObject
+{
+public:
+    using Ptr = ReferenceCountedObjectPtr<TileQueue>;
+
+    TileQueue (int numTilesToRender, std::function<void (int)> tileRenderer)
+        : numTiles (numTilesToRender), tilesRemaining (numTilesToRender), renderTile (std::move (tileRenderer))
+    {
+    }
+
+    void renderAvailableTiles()
+    {
+        for (;;)
+        {
+            auto tileIndex = nextTile++;
+
+            if (tileIndex >= numTiles)
+                return;
+
+            renderTile (tileIndex);
+
+            if (--tilesRemaining == 0)
+                finished.signal();
+        }
+    }
+
+    void waitUntilFinished()
+    {
+        finished.wait();
+    }
+
+private:
+    const int numTiles;
+    std::atomic<int> nextTile { 0 }, tilesRemaining;
+    const std::function<void (int)> renderTile;
+    WaitableEvent finished;
+
+    JUCE_DECLARE_NON_COPYABLE (TileQueue)
+};
+
+//==============================================================================
+class LowLevelGraphicsTiledSoftwareRenderer::ThreadPoolHolder  : private DeletedAtShutdown
+{
+public:
+    ThreadPoolHolder() = default;
+
+    ~ThreadPoolHolder() override
+    {
+        clearSingletonInstance();
+    }
+
+    JUCE_DECLARE_SINGLETON (ThreadPoolHolder, false)
+
+    // The thread that's doing the painting renders tiles too, so one less is needed here.
+    ThreadPool pool { ThreadPoolOptions{}.withThreadName ("Tiled renderer")
+                                         .withNumberOfThreads (jmax (1, SystemStats::getNumCpus() - 1)) };
+
+    JUCE_DECLARE_NON_COPYABLE (ThreadPoolHolder)
+};
+
+JUCE_IMPLEMENT_SINGLETON (LowLevelGraphicsTiledSoftwareRenderer::ThreadPoolHolder)
+
+//==============================================================================
+Rectangle<int> LowLevelGraphicsTiledSoftwareRenderer::ClipTracker::getDeviceClipBounds() const
+{
+    return stack->clip != nullptr ? stack->clip->getClipBounds() : Rectangle<int>();
+}
+
+Rectangle<int> LowLevelGraphicsTiledSoftwareRenderer::ClipTracker::getDeviceBounds (Rectangle<float> userArea) const
+{
+    // The extra pixel allows for anti-aliased edges and rounding in the rasteriser
+    return userArea.transformedBy (stack->transform.getTransform())
+                   .getSmallestIntegerContainer()
+                   .expanded (1)
+                   .getIntersection (getDeviceClipBounds());
+}
+
+Rectangle<int> LowLevelGraphicsTiledSoftwareRenderer::ClipTracker::getGlyphBounds (int glyphNumber, const AffineTransform& t) const
+{
+    return stack->getGlyphBounds (glyphNumber, t);
+}
+
+//==============================================================================
+LowLevelGraphicsTiledSoftwareRenderer::LowLevelGraphicsTiledSoftwareRenderer (const Image& im)
+    : LowLevelGraphicsTiledSoftwareRenderer (im, {}, im.getBounds())
+{
+}
+
+LowLevelGraphicsTiledSoftwareRenderer::LowLevelGraphicsTiledSoftwareRenderer (const Image& im, Point<int> o,
+                                                                              const RectangleList<int>& initialClip)
+    : image (im), origin (o), clipRegion (initialClip), clipTracker (im, o, initialClip)
+{
+}
+
+LowLevelGraphicsTiledSoftwareRenderer::~LowLevelGraphicsTiledSoftwareRenderer()
+{
+    renderAllTiles();
+}
+
+template <typename Fn>
+void LowLevelGraphicsTiledSoftwareRenderer::addCommand (Fn&& fn)
+{
+    commands.push_back (std::make_unique<CommandWithFunction<std::decay_t<Fn>>> (std::forward<Fn> (fn)));
+}
+
+template <typename Fn>
+void LowLevelGraphicsTiledSoftwareRenderer::addDrawingCommand (Fn&& fn)
+{
+    addDrawingCommand (clipTracker.getDeviceClipBounds(), std::forward<Fn> (fn));
+}
+
+template <typename Fn>
+void LowLevelGraphicsTiledSoftwareRenderer::addDrawingCommand (Rectangle<int> deviceArea, Fn&& fn)
+{
+    if (! deviceArea.isEmpty())
+    {
+        addCommand (std::forward<Fn> (fn));
+        commands.back()->deviceArea = deviceArea;
+    }
+}
+
+//==============================================================================
+bool LowLevelGraphicsTiledSoftwareRenderer::isVectorDevice() const    { return false; }
+
+void LowLevelGraphicsTiledSoftwareRenderer::setOrigin (Point<int> o)
+{
+    clipTracker.setOrigin (o);
+    addCommand ([o] (auto& g) { g.setOrigin (o); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::addTransform (const AffineTransform& t)
+{
+    clipTracker.addTransform (t);
+    addCommand ([t] (auto& g) { g.addTransform (t); });
+}
+
+float LowLevelGraphicsTiledSoftwareRenderer::getPhysicalPixelScaleFactor()
+{
+    return clipTracker.getPhysicalPixelScaleFactor();
+}
+
+bool LowLevelGraphicsTiledSoftwareRenderer::clipToRectangle (const Rectangle<int>& r)
+{
+    addCommand ([r] (auto& g) { g.clipToRectangle (r); });
+    return clipTracker.clipToRectangle (r);
+}
+
+bool LowLevelGraphicsTiledSoftwareRenderer::clipToRectangleList (const RectangleList<int>& list)
+{
+    addCommand ([list] (auto& g) { g.clipToRectangleList (list); });
+    return clipTracker.clipToRectangleList (list);
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::excludeClipRectangle (const Rectangle<int>& r)
+{
+    clipTracker.excludeClipRectangle (r);
+    addCommand ([r] (auto& g) { g.excludeClipRectangle (r); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::clipToPath (const Path& path, const AffineTransform& t)
+{
+    clipTracker.clipToPath (path, t);
+    addCommand ([path, t] (auto& g) { g.clipToPath (path, t); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::clipToImageAlpha (const Image& im, const AffineTransform& t)
+{
+    clipTracker.clipToImageAlpha (im, t);
+    addCommand ([im, t] (auto& g) { g.clipToImageAlpha (im, t); });
+}
+
+bool LowLevelGraphicsTiledSoftwareRenderer::clipRegionIntersects (const Rectangle<int>& r)
+{
+    return clipTracker.clipRegionIntersects (r);
+}
+
+Rectangle<int> LowLevelGraphicsTiledSoftwareRenderer::getClipBounds() const
+{
+    return clipTracker.getClipBounds();
+}
+
+bool LowLevelGraphicsTiledSoftwareRenderer::isClipEmpty() const
+{
+    return clipTracker.isClipEmpty();
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::saveState()
+{
+    clipTracker.saveState();
+    addCommand ([] (auto& g) { g.saveState(); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::restoreState()
+{
+    clipTracker.restoreState();
+    addCommand ([] (auto& g) { g.restoreState(); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::beginTransparencyLayer (float opacity)
+{
+    // A layer has the same clip region as its parent, so there's no need to make the
+    // tracker allocate an image for it.
+    clipTracker.saveState();
+    addCommand ([opacity] (auto& g) { g.beginTransparencyLayer (opacity); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::endTransparencyLayer()
+{
+    clipTracker.restoreState();
+    addCommand ([] (auto& g) { g.endTransparencyLayer(); });
+}
+
+//==============================================================================
+void LowLevelGraphicsTiledSoftwareRenderer::setFill (const FillType& fillType)
+{
+    addCommand ([fillType] (auto& g) { g.setFill (fillType); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::setOpacity (float newOpacity)
+{
+    addCommand ([newOpacity] (auto& g) { g.setOpacity (newOpacity); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::setInterpolationQuality (Graphics::ResamplingQuality quality)
+{
+    addCommand ([quality] (auto& g) { g.setInterpolationQuality (quality); });
+}
+
+//==============================================================================
+void LowLevelGraphicsTiledSoftwareRenderer::fillRect (const Rectangle<int>& r, bool replaceExistingContents)
+{
+    addDrawingCommand ([r, replaceExistingContents] (auto& g) { g.fillRect (r, replaceExistingContents); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::fillRect (const Rectangle<float>& r)
+{
+    addDrawingCommand (clipTracker.getDeviceBounds (r), [r] (auto& g) { g.fillRect (r); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::fillRectList (const RectangleList<float>& list)
+{
+    addDrawingCommand (clipTracker.getDeviceBounds (list.getBounds()), [list] (auto& g) { g.fillRectList (list); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::fillPath (const Path& path, const AffineTransform& t)
+{
+    addDrawingCommand (clipTracker.getDeviceBounds (path.getBoundsTransformed (t)),
+                       [path, t] (auto& g) { g.fillPath (path, t); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::drawImage (const Image& im, const AffineTransform& t)
+{
+    addDrawingCommand (clipTracker.getDeviceBounds (im.getBounds().toFloat().transformedBy (t)),
+                       [im, t] (auto& g) { g.drawImage (im, t); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::drawLine (const Line<float>& line)
+{
+    addDrawingCommand (clipTracker.getDeviceBounds (Rectangle<float> (line.getStart(), line.getEnd()).expanded (1.0f)),
+                       [line] (auto& g) { g.drawLine (line); });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::drawPolyline (const Point<float>* points, int numPoints, float lineThickness)
+{
+    std::vector<Point<float>> copy (points, points + numPoints);
+
+    // The joints never reach further from the points than the line's thickness
+    const auto area = Rectangle<float>::findAreaContainingPoints (points, numPoints).expanded (lineThickness);
+
+    addDrawingCommand (clipTracker.getDeviceBounds (area), [copy = std::move (copy), lineThickness] (auto& g)
+    {
+        g.drawPolyline (copy.data(), (int) copy.size(), lineThickness);
+    });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::fillWaveformColumns (float x, float columnWidth,
+                                                                 const float* tops, const float* bottoms, int numColumns)
+{
+    std::vector<float> copiedTops (tops, tops + numColumns), copiedBottoms (bottoms, bottoms + numColumns);
+
+    addDrawingCommand ([x, columnWidth, copiedTops = std::move (copiedTops), copiedBottoms = std::move (copiedBottoms)] (auto& g)
+    {
+        g.fillWaveformColumns (x, columnWidth, copiedTops.data(), copiedBottoms.data(), (int) copiedTops.size());
+    });
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::setFont (const Font& newFont)
+{
+    clipTracker.setFont (newFont);
+    addCommand ([newFont] (auto& g) { g.setFont (newFont); });
+}
+
+const Font& LowLevelGraphicsTiledSoftwareRenderer::getFont()
+{
+    return clipTracker.getFont();
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::drawGlyph (int glyphNumber, const AffineTransform& t)
+{
+    // Looking up the glyph's bounds also puts it into the glyph cache, so the tiles won't
+    // need to generate it.
+    addDrawingCommand (clipTracker.getGlyphBounds (glyphNumber, t),
+                       [glyphNumber, t] (auto& g) { g.drawGlyph (glyphNumber, t); });
+}
+
+//==============================================================================
+Array<RectangleList<int>> LowLevelGraphicsTiledSoftwareRenderer::getTileClipRegions() const
+{
+    // Tiles are full-width bands, so that every scanline of every tile is clipped
+    // exactly as it would be if the whole area were rendered in one go.
+    constexpr int minimumTileHeight = 32;
+    constexpr int tilesPerThread = 4;
+
+    auto bounds = clipRegion.getBounds();
+    auto numThreads = ThreadPoolHolder::getInstance()->pool.getNumThreads() + 1;
+    auto numTiles = jlimit (1, numThreads * tilesPerThread, bounds.getHeight() / minimumTileHeight);
+
+    Array<RectangleList<int>> tiles;
+
+    for (int i = 0; i < numTiles; ++i)
+    {
+        auto top    = bounds.getY() + bounds.getHeight() * i / numTiles;
+        auto bottom = bounds.getY() + bounds.getHeight() * (i + 1) / numTiles;
+
+        RectangleList<int> tile (clipRegion);
+        tile.clipTo (Rectangle<int>::leftTopRightBottom (bounds.getX(), top, bounds.getRight(), bottom));
+
+        if (! tile.isEmpty())
+            tiles.add (std::move (tile));
+    }
+
+    return tiles;
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::renderTile (const Image& target, const RectangleList<int>& tileClip) const
+{
+    LowLevelGraphicsSoftwareRenderer g (target, origin, tileClip);
+    auto tileBounds = tileClip.getBounds();
+
+    for (auto& command : commands)
+        if (command->deviceArea.isEmpty() || command->deviceArea.intersects (tileBounds))
+            command->replay (g);
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::renderAllTiles()
+{
+    if (commands.empty() || clipRegion.isEmpty())
+        return;
+
+    auto tiles = getTileClipRegions();
+
+    if (tiles.size() <= 1)
+    {
+        renderTile (image, clipRegion);
+        return;
+    }
+
+    const Image::BitmapData targetPixels (image, Image::BitmapData::readWrite);
+    const Image target (*new TileTargetPixelData (targetPixels));
+
+    TileQueue::Ptr queue (new TileQueue (tiles.size(), [&] (int index) { renderTile (target, tiles.getReference (index)); }));
+
+    auto& pool = ThreadPoolHolder::getInstance()->pool;
+
+    for (int i = jmin (pool.getNumThreads(), tiles.size() - 1); --i >= 0;)
+        pool.addJob ([queue] { queue->renderAvailableTiles(); });
+
+    queue->renderAvailableTiles();
+    queue->waitUntilFinished();
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class TiledSoftwareRendererTests final : public UnitTest
+{
+public:
+    TiledSoftwareRendererTests()
+        : UnitTest ("LowLevelGraphicsTiledSoftwareRenderer", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Rendering a whole image matches the software renderer");
+        {
+            RectangleList<int> clip (Rectangle<int> (0, 0, 640, 480));
+            expectRenderersMatch (Image::ARGB, clip, 1.0f);
+            expectRenderersMatch (Image::RGB, clip, 1.0f);
+        }
+
+        beginTest ("Rendering a scaled, partially clipped image matches the software renderer");
+        {
+            RectangleList<int> clip;
+            clip.add ({ 13, 7, 300, 211 });
+            clip.add ({ 101, 250, 517, 199 });
+            clip.add ({ 590, 300, 41, 170 });
+
+            expectRenderersMatch (Image::ARGB, clip, 1.37f);
+            expectRenderersMatch (Image::RGB, clip, 2.0f);
+        }
+    }
+
+private:
+    static void drawScene (Graphics& g, float scale)
+    {
+        g.addTransform (AffineTransform::scale (scale));
+
+        g.setGradientFill (ColourGradient (Colours::darkblue, 0.0f, 0.0f, Colours::orange, 300.0f, 400.0f, false));
+        g.fillAll();
+
+        for (int i = 0; i < 40; ++i)
+        {
+            Random r (i);
+            auto area = Rectangle<float> (r.nextFloat() * 400.0f, r.nextFloat() * 300.0f,
+                                          20.0f + r.nextFloat() * 200.0f, 20.0f + r.nextFloat() * 150.0f);
+            g.setColour (Colour ((uint32) r.nextInt()).withAlpha (0.3f + 0.7f * r.nextFloat()));
+
+            switch (i % 4)
+            {
+                case 0:  g.fillRoundedRectangle (area, 9.5f); break;
+                case 1:  g.drawEllipse (area, 3.3f); break;
+                case 2:  g.drawLine ({ area.getTopLeft(), area.getBottomRight() }, 1.7f); break;
+                default: g.fillRect (area); break;
+            }
+        }
+
+        {
+            Graphics::ScopedSaveState state (g);
+
+            Path star;
+            star.addStar ({ 320.0f, 240.0f }, 7, 60.0f, 200.0f, 0.3f);
+            g.reduceClipRegion (star);
+            g.excludeClipRegion ({ 300, 200, 50, 50 });
+
+            g.setGradientFill (ColourGradient (Colours::white, 320.0f, 240.0f, Colours::transparentBlack, 500.0f, 240.0f, true));
+            g.fillAll();
+        }
+
+        {
+            g.beginTransparencyLayer (0.6f);
+            g.setColour (Colours::green);
+            g.fillEllipse (150.5f, 120.25f, 330.0f, 250.0f);
+            g.endTransparencyLayer();
+        }
+
+        Image sprite (Image::ARGB, 37, 23, true);
+
+        {
+            Graphics sg (sprite);
+            sg.setGradientFill (ColourGradient (Colours::red, 0.0f, 0.0f, Colours::cyan.withAlpha (0.5f), 37.0f, 23.0f, false));
+            sg.fillEllipse (sprite.getBounds().toFloat());
+        }
+
+        g.setImageResamplingQuality (Graphics::highResamplingQuality);
+        g.drawImageTransformed (sprite, AffineTransform::rotation (0.4f).scaled (4.3f).translated (210.0f, 30.0f));
+        g.setOpacity (0.7f);
+        g.drawImageAt (sprite, 500, 400);
+
+        {
+            float tops[200], bottoms[200];
+
+            for (int i = 0; i < 200; ++i)
+            {
+                tops[i]    = 100.0f - 80.0f * std::abs (std::sin ((float) i * 0.11f));
+                bottoms[i] = 100.0f + 60.0f * std::abs (std::cos ((float) i * 0.07f));
+            }
+
+            g.setColour (Colours::yellow.withAlpha (0.8f));
+            g.fillWaveformColumns (400.0f, 1.2f, tops, bottoms, 200);
+            g.setColour (Colours::purple);
+            g.drawPolyline (400.0f, 1.2f, tops, 200, 2.5f);
+        }
+
+        {
+            RectangleList<float> bars;
+
+            for (int i = 0; i < 30; ++i)
+                bars.addWithoutMerging ({ 20.0f + (float) i * 7.3f, 480.0f - (float) i * 5.1f, 3.5f, 60.0f });
+
+            g.setColour (Colours::cyan.withAlpha (0.6f));
+            g.fillRectList (bars);
+        }
+
+        g.setColour (Colours::black);
+        g.setFont (23.0f);
+        g.drawText ("The quick brown fox jumps over the lazy dog", 20, 400, 600, 40, Justification::centred);
+
+        GlyphArrangement rotated;
+        rotated.addLineOfText (g.getCurrentFont(), "Rotated text", 0.0f, 0.0f);
+        rotated.draw (g, AffineTransform::rotation (-0.5f).translated (60.0f, 300.0f));
+    }
+
+    void expectRenderersMatch (Image::PixelFormat format, const RectangleList<int>& clip, float scale)
+    {
+        const Point<int> origin (-3, 5);
+        Image expected (format, 640, 480, true, SoftwareImageType());
+        Image actual (format, 640, 480, true, SoftwareImageType());
+
+        {
+            LowLevelGraphicsSoftwareRenderer context (expected, origin, clip);
+            Graphics g (context);
+            drawScene (g, scale);
+        }
+
+        {
+            LowLevelGraphicsTiledSoftwareRenderer context (actual, origin, clip);
+            Graphics g (context);
+            drawScene (g, scale);
+        }
+
+        const Image::BitmapData e (expected, Image::BitmapData::readOnly);
+        const Image::BitmapData a (actual, Image::BitmapData::readOnly);
+        int numDifferences = 0;
+
+        for (int y = 0; y < e.height; ++y)
+            if (memcmp (e.getLinePointer (y), a.getLinePointer (y), (size_t) (e.width * e.pixelStride)) != 0)
+                ++numDifferences;
+
+        expectEquals (numDifferences, 0, "Lines that don't match");
+    }
+};
+
+static TiledSoftwareRendererTests tiledSoftwareRendererTests;
+
+#endif
+
+} // namespace juce
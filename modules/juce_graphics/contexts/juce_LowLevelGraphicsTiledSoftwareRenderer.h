@@ -0,0 +1,153 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A software renderer that spreads its rasterisation across several threads.
+
+    Rather than drawing each operation as it arrives, this context records the
+    operations it's given, keeping track of the clip region, transform and font so
+    that queries such as getClipBounds() still return the right answers. When the
+    context is deleted, the clip region is divided into horizontal tiles, and the
+    recording is replayed into a separate LowLevelGraphicsSoftwareRenderer for each
+    tile, with the tiles being rendered concurrently on a shared pool of threads.
+
+    Every pixel sees exactly the same sequence of operations as it would if the
+    drawing had been done by a single LowLevelGraphicsSoftwareRenderer, so the
+    result is pixel-identical.
+
+    On Linux, a window can be switched to this renderer with
+    ComponentPeer::setCurrentRenderingEngine().
+
+    Because the rendering is deferred, the image that's being drawn onto won't
+    contain the results until this object has been deleted, and any images that are
+    drawn or used as clip masks mustn't be modified until then.
+
+    User code is not supposed to create instances of this class directly - do all your
+    rendering via the Graphics class instead.
+
+    @see LowLevelGraphicsSoftwareRenderer
+
+    @tags{Graphics}
+*/
+class JUCE_API  LowLevelGraphicsTiledSoftwareRenderer    : public LowLevelGraphicsContext
+{
+public:
+    //==============================================================================
+    /** Creates a context to render into an image. */
+    LowLevelGraphicsTiledSoftwareRenderer (const Image& imageToRenderOnto);
+
+    /** Creates a context to render into a clipped subsection of an image. */
+    LowLevelGraphicsTiledSoftwareRenderer (const Image& imageToRenderOnto, Point<int> origin,
+                                           const RectangleList<int>& initialClip);
+
+    /** Destructor.
+        This is where the recorded operations actually get rendered into the image.
+    */
+    ~LowLevelGraphicsTiledSoftwareRenderer() override;
+
+    //==============================================================================
+    bool isVectorDevice() const override;
+    void setOrigin (Point<int>) override;
+    void addTransform (const AffineTransform&) override;
+    float getPhysicalPixelScaleFactor() override;
+
+    bool clipToRectangle (const Rectangle<int>&) override;
+    bool clipToRectangleList (const RectangleList<int>&) override;
+    void excludeClipRectangle (const Rectangle<int>&) override;
+    void clipToPath (const Path&, const AffineTransform&) override;
+    void clipToImageAlpha (const Image&, const AffineTransform&) override;
+
+    bool clipRegionIntersects (const Rectangle<int>&) override;
+    Rectangle<int> getClipBounds() const override;
+    bool isClipEmpty() const override;
+
+    void saveState() override;
+    void restoreState() override;
+
+    void beginTransparencyLayer (float opacity) override;
+    void endTransparencyLayer() override;
+
+    //==============================================================================
+    void setFill (const FillType&) override;
+    void setOpacity (float) override;
+    void setInterpolationQuality (Graphics::ResamplingQuality) override;
+
+    //==============================================================================
+    void fillRect (const Rectangle<int>&, bool replaceExistingContents) override;
+    void fillRect (const Rectangle<float>&) override;
+    void fillRectList (const RectangleList<float>&) override;
+    void fillPath (const Path&, const AffineTransform&) override;
+    void drawImage (const Image&, const AffineTransform&) override;
+    void drawLine (const Line<float>&) override;
+    void drawPolyline (const Point<float>*, int numPoints, float lineThickness) override;
+    void fillWaveformColumns (float x, float columnWidth, const float* tops, const float* bottoms, int numColumns) override;
+
+    void setFont (const Font&) override;
+    const Font& getFont() override;
+    void drawGlyph (int glyphNumber, const AffineTransform&) override;
+
+private:
+    //==============================================================================
+    struct Command;
+    template <typename Fn> struct CommandWithFunction;
+    class TileTargetPixelData;
+    class TileQueue;
+    class ThreadPoolHolder;
+
+    struct ClipTracker  : public LowLevelGraphicsSoftwareRenderer
+    {
+        using LowLevelGraphicsSoftwareRenderer::LowLevelGraphicsSoftwareRenderer;
+        Rectangle<int> getDeviceClipBounds() const;
+        Rectangle<int> getDeviceBounds (Rectangle<float> userArea) const;
+        Rectangle<int> getGlyphBounds (int glyphNumber, const AffineTransform&) const;
+    };
+
+    template <typename Fn>
+    void addCommand (Fn&&);
+
+    template <typename Fn>
+    void addDrawingCommand (Fn&&);
+
+    template <typename Fn>
+    void addDrawingCommand (Rectangle<int> deviceArea, Fn&&);
+
+    Array<RectangleList<int>> getTileClipRegions() const;
+    void renderTile (const Image& target, const RectangleList<int>& tileClip) const;
+    void renderAllTiles();
+
+    Image image;
+    Point<int> origin;
+    RectangleList<int> clipRegion;
+    ClipTracker clipTracker;
+    std::vector<std::unique_ptr<Command>> commands;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LowLevelGraphicsTiledSoftwareRenderer)
+};
+
+} // namespace juce
@@ -170,15 +170,11 @@ void Typeface::setTypefaceCacheSize (int numFontsToCache)
     TypefaceCache::getInstance()->setSize (numFontsToCache);
 }
 
-void (*clearOpenGLGlyphCache)() = nullptr;
-
 void Typeface::clearTypefaceCache()
 {
     TypefaceCache::getInstance()->clear();
 
-    RenderingHelpers::SoftwareRendererSavedState::clearGlyphCache();
-
-    NullCheckedInvocation::invoke (clearOpenGLGlyphCache);
+    GlyphAtlas::clear();
 }
 
 //==============================================================================
@@ -0,0 +1,510 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace GlyphAtlasHelpers
+{
+    /** Writes the levels produced by iterating an EdgeTable into an 8-bit mask. */
+    struct MaskWriter
+    {
+        MaskWriter (uint8* data, Rectangle<int> area) noexcept  : mask (data), bounds (area) {}
+
+        void setEdgeTableYPos (int y) noexcept
+        {
+            line = mask + (size_t) ((y - bounds.getY()) * bounds.getWidth()) - bounds.getX();
+        }
+
+        void handleEdgeTablePixel (int x, int alpha) const noexcept        { line[x] = (uint8) jmin (255, alpha); }
+        void handleEdgeTablePixelFull (int x) const noexcept               { line[x] = 255; }
+
+        void handleEdgeTableLine (int x, int width, int alpha) const noexcept
+        {
+            std::fill (line + x, line + x + width, (uint8) jmin (255, alpha));
+        }
+
+        void handleEdgeTableLineFull (int x, int width) const noexcept
+        {
+            std::fill (line + x, line + x + width, (uint8) 255);
+        }
+
+        uint8* mask;
+        uint8* line = nullptr;
+        Rectangle<int> bounds;
+    };
+
+    static Rectangle<int> findNonZeroArea (const uint8* mask, Rectangle<int> area) noexcept
+    {
+        auto left = area.getRight(), right = area.getX(), top = area.getBottom(), bottom = area.getY();
+
+        for (int y = 0; y < area.getHeight(); ++y)
+        {
+            auto* line = mask + (size_t) (y * area.getWidth());
+
+            for (int x = 0; x < area.getWidth(); ++x)
+            {
+                if (line[x] != 0)
+                {
+                    left   = jmin (left,   area.getX() + x);
+                    right  = jmax (right,  area.getX() + x + 1);
+                    top    = jmin (top,    area.getY() + y);
+                    bottom = jmax (bottom, area.getY() + y + 1);
+                }
+            }
+        }
+
+        if (left >= right)
+            return {};
+
+        return { left, top, right - left, bottom - top };
+    }
+
+    static int floorDiv (int value, int divisor) noexcept
+    {
+        auto result = value / divisor;
+        return (value % divisor < 0) ? result - 1 : result;
+    }
+}
+
+//==============================================================================
+GlyphAtlas::Glyph::Glyph (const Font& font, int glyphNumber, int subpixelOffset, int numSubpixelOffsets)
+{
+    auto typeface = font.getTypefacePtr();
+    isHinted = typeface->isHinted();
+
+    if (isHinted)
+        subpixelOffset = 0;
+
+    auto fontHeight = font.getHeight();
+    std::unique_ptr<EdgeTable> edgeTable (typeface->getEdgeTableForGlyph (glyphNumber,
+                                                                          AffineTransform::scale (fontHeight * font.getHorizontalScale(),
+                                                                                                  fontHeight), fontHeight));
+    if (edgeTable == nullptr)
+        return;
+
+    if (subpixelOffset != 0)
+        edgeTable->translate ((float) subpixelOffset / (float) numSubpixelOffsets, 0);
+
+    auto area = edgeTable->getMaximumBounds();
+
+    if (area.isEmpty())
+        return;
+
+    HeapBlock<uint8> fullMask ((size_t) area.getWidth() * (size_t) area.getHeight(), true);
+    GlyphAtlasHelpers::MaskWriter writer (fullMask, area);
+    edgeTable->iterate (writer);
+
+    bounds = GlyphAtlasHelpers::findNonZeroArea (fullMask, area);
+
+    if (bounds.isEmpty())
+        return;
+
+    coverage.malloc ((size_t) bounds.getWidth() * (size_t) bounds.getHeight());
+
+    for (int y = 0; y < bounds.getHeight(); ++y)
+        memcpy (coverage + (size_t) (y * bounds.getWidth()),
+                fullMask + (size_t) ((bounds.getY() - area.getY() + y) * area.getWidth() + bounds.getX() - area.getX()),
+                (size_t) bounds.getWidth());
+}
+
+size_t GlyphAtlas::Glyph::getSizeInBytes() const noexcept
+{
+    return sizeof (Glyph) + (size_t) bounds.getWidth() * (size_t) bounds.getHeight();
+}
+
+void GlyphAtlas::Glyph::clipEdgeTable (EdgeTable& edgeTable, Point<int> origin) const
+{
+    auto area = bounds + origin;
+    edgeTable.clipToRectangle (area);
+
+    if (edgeTable.isEmpty())
+        return;
+
+    for (int y = 0; y < area.getHeight(); ++y)
+        edgeTable.clipLineToMask (area.getX(), area.getY() + y, getLinePointer (y), 1, area.getWidth());
+}
+
+//==============================================================================
+struct GlyphAtlas::Pimpl  : private DeletedAtShutdown
+{
+    Pimpl() = default;
+
+    ~Pimpl() override
+    {
+        clearSingletonInstance();
+    }
+
+    JUCE_DECLARE_SINGLETON (GlyphAtlas::Pimpl, false)
+
+    PositionedGlyph findOrCreateGlyph (const Font& font, int glyphNumber, Point<float> position)
+    {
+        const ScopedLock sl (lock);
+
+        auto quantisedX = roundToInt (position.x * (float) numSubpixelPositions);
+        Key key { font, glyphNumber, (quantisedX % numSubpixelPositions + numSubpixelPositions) % numSubpixelPositions };
+
+        Glyph::Ptr glyph;
+        auto found = entries.find (key);
+
+        if (found != entries.end())
+        {
+            ++statistics.hits;
+            lru.splice (lru.begin(), lru, found->second);
+            glyph = found->second->glyph;
+        }
+        else
+        {
+            ++statistics.misses;
+            glyph = new Glyph (font, glyphNumber, key.subpixelOffset, numSubpixelPositions);
+            addGlyph (key, glyph);
+        }
+
+        auto x = glyph->isHinted ? (int) std::floor (position.x + 0.5f)
+                                 : GlyphAtlasHelpers::floorDiv (quantisedX, numSubpixelPositions);
+
+        return { glyph, { x, roundToInt (position.y) } };
+    }
+
+    std::unique_ptr<EdgeTable> createUncachedGlyph (const Font& font, int glyphNumber, const AffineTransform& transform)
+    {
+        const ScopedLock sl (lock);
+        return std::unique_ptr<EdgeTable> (font.getTypefacePtr()->getEdgeTableForGlyph (glyphNumber, transform, font.getHeight()));
+    }
+
+    void setMaximumSize (size_t newMaximum)
+    {
+        const ScopedLock sl (lock);
+        maximumBytes = newMaximum;
+        removeExcessGlyphs();
+    }
+
+    void setNumSubpixelPositions (int newNumPositions)
+    {
+        const ScopedLock sl (lock);
+
+        if (numSubpixelPositions != newNumPositions)
+        {
+            numSubpixelPositions = newNumPositions;
+            clear();
+        }
+    }
+
+    void clear()
+    {
+        const ScopedLock sl (lock);
+        entries.clear();
+        lru.clear();
+        bytesUsed = 0;
+    }
+
+    Statistics getStatistics()
+    {
+        const ScopedLock sl (lock);
+        auto s = statistics;
+        s.numGlyphs = (int) entries.size();
+        s.bytesUsed = bytesUsed;
+        return s;
+    }
+
+    void resetStatistics()
+    {
+        const ScopedLock sl (lock);
+        statistics = {};
+    }
+
+    size_t maximumBytes = 4 * 1024 * 1024;
+    int numSubpixelPositions = 4;
+    CriticalSection lock;
+
+private:
+    struct Key
+    {
+        Font font;
+        int glyph, subpixelOffset;
+
+        bool operator== (const Key& other) const noexcept
+        {
+            return glyph == other.glyph && subpixelOffset == other.subpixelOffset && font == other.font;
+        }
+    };
+
+    struct KeyHash
+    {
+        size_t operator() (const Key& key) const noexcept
+        {
+            auto h = (size_t) key.font.getTypefaceName().hashCode64();
+            h = h * 31 + (size_t) key.font.getTypefaceStyle().hashCode();
+            h = h * 31 + std::hash<float>() (key.font.getHeight());
+            h = h * 31 + std::hash<float>() (key.font.getHorizontalScale());
+            h = h * 31 + (size_t) key.glyph;
+            return h * 31 + (size_t) key.subpixelOffset;
+        }
+    };
+
+    struct Entry
+    {
+        Key key;
+        Glyph::Ptr glyph;
+    };
+
+    std::list<Entry> lru;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> entries;
+    size_t bytesUsed = 0;
+    Statistics statistics;
+
+    void addGlyph (const Key& key, const Glyph::Ptr& glyph)
+    {
+        lru.push_front ({ key, glyph });
+        entries[key] = lru.begin();
+        bytesUsed += glyph->getSizeInBytes();
+        removeExcessGlyphs();
+    }
+
+    void removeExcessGlyphs()
+    {
+        // the most recently used glyph is always kept, even if it's bigger than the limit
+        while (bytesUsed > maximumBytes && lru.size() > 1)
+        {
+            auto& last = lru.back();
+            bytesUsed -= last.glyph->getSizeInBytes();
+            entries.erase (last.key);
+            lru.pop_back();
+            ++statistics.evictions;
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Pimpl)
+};
+
+JUCE_IMPLEMENT_SINGLETON (GlyphAtlas::Pimpl)
+
+//==============================================================================
+GlyphAtlas::PositionedGlyph GlyphAtlas::findOrCreateGlyph (const Font& deviceFont, int glyphNumber, Point<float> devicePosition)
+{
+    return Pimpl::getInstance()->findOrCreateGlyph (deviceFont, glyphNumber, devicePosition);
+}
+
+std::unique_ptr<EdgeTable> GlyphAtlas::createUncachedGlyph (const Font& font, int glyphNumber, const AffineTransform& transform)
+{
+    return Pimpl::getInstance()->createUncachedGlyph (font, glyphNumber, transform);
+}
+
+void GlyphAtlas::setMaximumSize (size_t maxBytes)
+{
+    Pimpl::getInstance()->setMaximumSize (maxBytes);
+}
+
+size_t GlyphAtlas::getMaximumSize()
+{
+    return Pimpl::getInstance()->maximumBytes;
+}
+
+void GlyphAtlas::setNumSubpixelPositions (int numPositions)
+{
+    jassert (numPositions > 0 && numPositions <= 16);
+    Pimpl::getInstance()->setNumSubpixelPositions (jlimit (1, 16, numPositions));
+}
+
+int GlyphAtlas::getNumSubpixelPositions()
+{
+    return Pimpl::getInstance()->numSubpixelPositions;
+}
+
+void GlyphAtlas::clear()
+{
+    if (auto* instance = Pimpl::getInstanceWithoutCreating())
+        instance->clear();
+}
+
+GlyphAtlas::Statistics GlyphAtlas::getStatistics()
+{
+    return Pimpl::getInstance()->getStatistics();
+}
+
+void GlyphAtlas::resetStatistics()
+{
+    Pimpl::getInstance()->resetStatistics();
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class GlyphAtlasTests final : public UnitTest
+{
+public:
+    GlyphAtlasTests()
+        : UnitTest ("GlyphAtlas", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        const auto originalMaximumSize = GlyphAtlas::getMaximumSize();
+        const auto originalNumPositions = GlyphAtlas::getNumSubpixelPositions();
+
+        beginTest ("Repeated text is drawn from the cache");
+        {
+            GlyphAtlas::clear();
+            GlyphAtlas::resetStatistics();
+
+            drawText ("abc", { 5.0f, 20.0f });
+            auto first = GlyphAtlas::getStatistics();
+
+            expectEquals ((int) first.misses, 3);
+            expectEquals ((int) first.hits, 0);
+            expectEquals (first.numGlyphs, 3);
+            expect (first.bytesUsed > 0);
+
+            drawText ("abc", { 5.0f, 20.0f });
+            auto second = GlyphAtlas::getStatistics();
+
+            expectEquals ((int) second.misses, 3);
+            expectEquals ((int) second.hits, 3);
+            expectEquals (second.getHitRate(), 0.5);
+
+            GlyphAtlas::resetStatistics();
+            expectEquals ((int) GlyphAtlas::getStatistics().hits, 0);
+        }
+
+        beginTest ("The cache stays within its maximum size");
+        {
+            GlyphAtlas::clear();
+            GlyphAtlas::resetStatistics();
+            GlyphAtlas::setMaximumSize (2000);
+
+            drawText ("The quick brown fox jumps over the lazy dog", { 3.3f, 20.0f });
+            auto stats = GlyphAtlas::getStatistics();
+
+            expect (stats.bytesUsed <= 2000);
+            expect (stats.evictions > 0);
+            expect (stats.numGlyphs > 0);
+
+            GlyphAtlas::setMaximumSize (originalMaximumSize);
+        }
+
+        beginTest ("Glyphs at the same sub-pixel offset are identical");
+        {
+            GlyphAtlas::clear();
+
+            auto a = drawText ("Wg", { 10.25f, 20.0f });
+            auto b = drawText ("Wg", { 13.25f, 21.0f });
+
+            expectEquals (countDifferences (a, b, { 3, 1 }, 0), 0);
+
+            auto c = drawText ("Wg", { 10.75f, 20.0f });
+            expect (countDifferences (a, c, {}, 0) > 0);
+        }
+
+        beginTest ("Sub-pixel positioning can be changed");
+        {
+            GlyphAtlas::setNumSubpixelPositions (1);
+            expectEquals (GlyphAtlas::getStatistics().numGlyphs, 0);
+
+            auto a = drawText ("W", { 10.0f, 20.0f });
+            auto b = drawText ("W", { 10.3f, 20.0f });
+            expectEquals (countDifferences (a, b, {}, 0), 0);
+
+            GlyphAtlas::setNumSubpixelPositions (originalNumPositions);
+        }
+
+        beginTest ("Drawing into a rectangular clip matches drawing through an edge table");
+        {
+            for (auto colour : { Colours::black, Colours::white, Colours::orange.withAlpha (0.7f) })
+            {
+                for (auto format : { Image::ARGB, Image::RGB })
+                {
+                    auto rectangleClip = drawText ("Jiggly text!", { 4.6f, 22.0f }, colour, format, false);
+                    auto edgeTableClip = drawText ("Jiggly text!", { 4.6f, 22.0f }, colour, format, true);
+
+                    expectEquals (countDifferences (rectangleClip, edgeTableClip, {}, 2), 0);
+                }
+            }
+        }
+
+        GlyphAtlas::clear();
+    }
+
+private:
+    static Image drawText (const String& text, Point<float> position, Colour colour = Colours::black,
+                           Image::PixelFormat format = Image::ARGB, bool usePathClip = false)
+    {
+        Image image (format, 160, 40, true, SoftwareImageType());
+        Graphics g (image);
+
+        if (format == Image::RGB)
+            g.fillAll (Colours::darkgrey);
+
+        if (usePathClip)
+        {
+            Path p;
+            p.addRectangle (image.getBounds().reduced (2).toFloat());
+            g.reduceClipRegion (p);
+        }
+        else
+        {
+            g.reduceClipRegion (image.getBounds().reduced (2));
+        }
+
+        g.setColour (colour);
+        g.setFont (18.0f);
+
+        GlyphArrangement glyphs;
+        glyphs.addLineOfText (g.getCurrentFont(), text, position.x, position.y);
+        glyphs.draw (g);
+        return image;
+    }
+
+    static int countDifferences (const Image& a, const Image& b, Point<int> offsetInB, int tolerance)
+    {
+        const Image::BitmapData da (a, Image::BitmapData::readOnly);
+        const Image::BitmapData db (b, Image::BitmapData::readOnly);
+        int numDifferent = 0;
+
+        for (int y = 0; y < a.getHeight(); ++y)
+        {
+            for (int x = 0; x < a.getWidth(); ++x)
+            {
+                auto bx = x + offsetInB.x, by = y + offsetInB.y;
+                auto pa = da.getPixelColour (x, y).getPixelARGB();
+                auto pb = (b.getBounds().contains (bx, by) ? db.getPixelColour (bx, by) : Colours::transparentBlack).getPixelARGB();
+
+                if (std::abs ((int) pa.getRed()   - (int) pb.getRed())   > tolerance
+                 || std::abs ((int) pa.getGreen() - (int) pb.getGreen()) > tolerance
+                 || std::abs ((int) pa.getBlue()  - (int) pb.getBlue())  > tolerance
+                 || std::abs ((int) pa.getAlpha() - (int) pb.getAlpha()) > tolerance)
+                    ++numDifferent;
+            }
+        }
+
+        return numDifferent;
+    }
+};
+
+static GlyphAtlasTests glyphAtlasTests;
+
+#endif
+
+} // namespace juce
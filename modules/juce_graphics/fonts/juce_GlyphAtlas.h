@@ -0,0 +1,205 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A global cache of rasterised glyphs, which is shared by all the fonts and
+    renderers in the process.
+
+    Each entry is an 8-bit coverage mask for one glyph of a particular font (i.e. a
+    typeface, style, height and horizontal scale), rendered at one of a small number of
+    sub-pixel horizontal offsets. When a glyph is drawn at an arbitrary position, the
+    mask whose offset is closest is drawn at the nearest whole pixel, so text that's laid
+    out at fractional positions keeps its spacing without needing to be rasterised again.
+
+    The cache is limited to a maximum number of bytes, with the least recently used
+    glyphs being discarded when it's full. The software renderer and the OpenGL
+    renderer both draw their text from here, so getStatistics() can be used to check
+    whether the size is big enough for the amount of text that an app draws.
+
+    @tags{Graphics}
+*/
+class JUCE_API  GlyphAtlas
+{
+public:
+    //==============================================================================
+    /** A glyph's coverage mask. */
+    class JUCE_API  Glyph final  : public ReferenceCountedObject
+    {
+    public:
+        using Ptr = ReferenceCountedObjectPtr<Glyph>;
+
+        /** Returns the area covered by the mask, relative to the pixel at which the
+            glyph's origin is drawn.
+        */
+        Rectangle<int> getBounds() const noexcept               { return bounds; }
+
+        /** Returns the coverage levels (0 to 255) for one row of the mask, where 0 is the top row. */
+        const uint8* getLinePointer (int row) const noexcept    { return coverage + (size_t) (row * bounds.getWidth()); }
+
+        /** Returns the number of bytes that this glyph is using. */
+        size_t getSizeInBytes() const noexcept;
+
+        /** Restricts an edge table to the glyph's shape, with its origin at the given pixel.
+            This is for renderers that fill shapes using edge tables.
+        */
+        void clipEdgeTable (EdgeTable& edgeTable, Point<int> origin) const;
+
+        /** Passes the glyph's coverage within a rectangle to an EdgeTable-style renderer.
+
+            The renderer is called in the same way as by EdgeTable::iterate(). Each level
+            is scaled by levelMultiplier / 256, in the same way as EdgeTable::multiplyLevels().
+        */
+        template <class Renderer>
+        void iterate (Renderer& r, Point<int> origin, Rectangle<int> clipArea, int levelMultiplier = 256) const noexcept
+        {
+            auto area = (bounds + origin).getIntersection (clipArea);
+
+            for (int y = area.getY(); y < area.getBottom(); ++y)
+            {
+                auto* line = getLinePointer (y - origin.y - bounds.getY()) - origin.x - bounds.getX();
+                r.setEdgeTableYPos (y);
+
+                for (int x = area.getX(); x < area.getRight();)
+                {
+                    auto level = (int) line[x];
+                    auto runEnd = x + 1;
+
+                    while (runEnd < area.getRight() && line[runEnd] == level)
+                        ++runEnd;
+
+                    if (level > 0)
+                    {
+                        if (levelMultiplier != 256)
+                            level = jmin (255, (level * levelMultiplier) >> 8);
+
+                        if (level >= 255)
+                        {
+                            if (runEnd - x == 1)  r.handleEdgeTablePixelFull (x);
+                            else                  r.handleEdgeTableLineFull (x, runEnd - x);
+                        }
+                        else
+                        {
+                            if (runEnd - x == 1)  r.handleEdgeTablePixel (x, level);
+                            else                  r.handleEdgeTableLine (x, runEnd - x, level);
+                        }
+                    }
+
+                    x = runEnd;
+                }
+            }
+        }
+
+    private:
+        friend class GlyphAtlas;
+        Glyph (const Font&, int glyphNumber, int subpixelOffset, int numSubpixelOffsets);
+
+        HeapBlock<uint8> coverage;
+        Rectangle<int> bounds;
+        bool isHinted = false;
+
+        JUCE_DECLARE_NON_COPYABLE (Glyph)
+    };
+
+    /** A glyph, and the device pixel at which its origin should be drawn. */
+    struct PositionedGlyph
+    {
+        Glyph::Ptr glyph;
+        Point<int> origin;
+
+        /** Returns the device-space area that the glyph covers. */
+        Rectangle<int> getBounds() const noexcept     { return glyph != nullptr ? glyph->getBounds() + origin : Rectangle<int>(); }
+    };
+
+    //==============================================================================
+    /** Returns the glyph to use when drawing a glyph at a position in device space,
+        rasterising it if it isn't already in the cache.
+
+        The font must already have been scaled to the size at which it's going to
+        appear on the device.
+    */
+    static PositionedGlyph findOrCreateGlyph (const Font& deviceFont, int glyphNumber, Point<float> devicePosition);
+
+    /** Creates an edge table for a glyph that's drawn with a transform that can't be
+        handled by the cache.
+
+        This is done while holding the cache's lock, so that a typeface will never be
+        asked for outlines by several rendering threads at once.
+    */
+    static std::unique_ptr<EdgeTable> createUncachedGlyph (const Font& font, int glyphNumber, const AffineTransform& transform);
+
+    //==============================================================================
+    /** Sets the maximum amount of memory the cache can use. The default is 4MB. */
+    static void setMaximumSize (size_t maxBytes);
+
+    /** Returns the maximum amount of memory the cache can use. */
+    static size_t getMaximumSize();
+
+    /** Sets the number of horizontal sub-pixel offsets at which each glyph can be
+        rasterised, between 1 and 16. The default is 4, i.e. quarter-pixel positioning.
+        Changing this clears the cache.
+    */
+    static void setNumSubpixelPositions (int numPositions);
+
+    /** Returns the number of horizontal sub-pixel offsets at which glyphs are rasterised. */
+    static int getNumSubpixelPositions();
+
+    /** Removes all the glyphs from the cache. */
+    static void clear();
+
+    //==============================================================================
+    /** Counters describing how well the cache is working. */
+    struct Statistics
+    {
+        int64 hits = 0;           /**< The number of lookups which found a glyph in the cache. */
+        int64 misses = 0;         /**< The number of lookups which had to rasterise a glyph. */
+        int64 evictions = 0;      /**< The number of glyphs which were discarded to make room for others. */
+        int numGlyphs = 0;        /**< The number of glyphs currently in the cache. */
+        size_t bytesUsed = 0;     /**< The amount of memory that the glyphs are currently using. */
+
+        /** Returns the proportion of lookups that were hits, from 0 to 1. */
+        double getHitRate() const noexcept      { return hits + misses > 0 ? (double) hits / (double) (hits + misses) : 0.0; }
+    };
+
+    /** Returns the cache's current statistics. */
+    static Statistics getStatistics();
+
+    /** Resets the hit, miss and eviction counters to zero. */
+    static void resetStatistics();
+
+private:
+    //==============================================================================
+    struct Pimpl;
+    friend struct Pimpl;
+
+    GlyphAtlas() = delete;
+
+    JUCE_DECLARE_NON_COPYABLE (GlyphAtlas)
+};
+
+} // namespace juce
@@ -0,0 +1,513 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+bool ShapedTextCache::ArrangementKey::operator== (const ArrangementKey& other) const
+{
+    return method == other.method
+        && exactlyEqual (width, other.width)
+        && exactlyEqual (height, other.height)
+        && exactlyEqual (extra, other.extra)
+        && justification == other.justification
+        && maximumLines == other.maximumLines
+        && useEllipsis == other.useEllipsis
+        && text == other.text
+        && font == other.font;
+}
+
+//==============================================================================
+struct ShapedTextCache::Pimpl  : private DeletedAtShutdown
+{
+    Pimpl() = default;
+
+    ~Pimpl() override
+    {
+        clearSingletonInstance();
+    }
+
+    JUCE_DECLARE_SINGLETON (ShapedTextCache::Pimpl, false)
+
+    //==============================================================================
+    struct LayoutKey
+    {
+        AttributedString text;
+        float maxWidth, maxHeight;
+        bool balanceLineLengths;
+
+        bool operator== (const LayoutKey& other) const
+        {
+            if (! (exactlyEqual (maxWidth, other.maxWidth)
+                    && exactlyEqual (maxHeight, other.maxHeight)
+                    && balanceLineLengths == other.balanceLineLengths
+                    && exactlyEqual (text.getLineSpacing(), other.text.getLineSpacing())
+                    && text.getJustification() == other.text.getJustification()
+                    && text.getWordWrap() == other.text.getWordWrap()
+                    && text.getReadingDirection() == other.text.getReadingDirection()
+                    && text.getNumAttributes() == other.text.getNumAttributes()
+                    && text.getText() == other.text.getText()))
+                return false;
+
+            for (int i = 0; i < text.getNumAttributes(); ++i)
+            {
+                auto& a = text.getAttribute (i);
+                auto& b = other.text.getAttribute (i);
+
+                if (a.range != b.range || a.colour != b.colour || a.font != b.font)
+                    return false;
+            }
+
+            return true;
+        }
+    };
+
+    struct KeyHash
+    {
+        static size_t hashFont (const Font& font) noexcept
+        {
+            auto h = (size_t) font.getTypefaceName().hashCode64();
+            h = h * 31 + (size_t) font.getTypefaceStyle().hashCode();
+            h = h * 31 + std::hash<float>() (font.getHeight());
+            return h * 31 + std::hash<float>() (font.getHorizontalScale());
+        }
+
+        size_t operator() (const ArrangementKey& key) const noexcept
+        {
+            auto h = (size_t) key.text.hashCode64();
+            h = h * 31 + hashFont (key.font);
+            h = h * 31 + std::hash<float>() (key.width);
+            h = h * 31 + std::hash<float>() (key.height);
+            return h * 31 + (size_t) key.method;
+        }
+
+        size_t operator() (const LayoutKey& key) const noexcept
+        {
+            auto h = (size_t) key.text.getText().hashCode64();
+
+            if (key.text.getNumAttributes() > 0)
+                h = h * 31 + hashFont (key.text.getAttribute (0).font);
+
+            h = h * 31 + std::hash<float>() (key.maxWidth);
+            return h * 31 + std::hash<float>() (key.maxHeight);
+        }
+    };
+
+    //==============================================================================
+    template <typename Value, typename Key, typename Map, typename CreateFn>
+    std::shared_ptr<const Value> findOrCreate (Map& map, Key&& key, CreateFn&& create)
+    {
+        {
+            const ScopedLock sl (lock);
+            auto found = map.find (key);
+
+            if (found != map.end())
+            {
+                ++statistics.hits;
+                lru.splice (lru.begin(), lru, found->second);
+                return std::static_pointer_cast<const Value> (found->second->value);
+            }
+
+            ++statistics.misses;
+        }
+
+        // The text is shaped without holding the lock, so that other threads can
+        // carry on using the cache in the meantime.
+        auto value = std::make_shared<const Value> (create());
+        auto size = getSizeInBytes (*value) + getSizeInBytes (key);
+
+        const ScopedLock sl (lock);
+
+        if (size <= maximumBytes && map.find (key) == map.end())
+        {
+            lru.push_front ({ key, value, size });
+            map.emplace (std::move (key), lru.begin());
+            bytesUsed += size;
+            removeExcessEntries();
+        }
+
+        return value;
+    }
+
+    void setMaximumSize (size_t newMaximum)
+    {
+        const ScopedLock sl (lock);
+        maximumBytes = newMaximum;
+        removeExcessEntries();
+    }
+
+    void clear()
+    {
+        const ScopedLock sl (lock);
+        arrangements.clear();
+        layouts.clear();
+        lru.clear();
+        bytesUsed = 0;
+    }
+
+    Statistics getStatistics()
+    {
+        const ScopedLock sl (lock);
+        auto s = statistics;
+        s.numEntries = (int) lru.size();
+        s.bytesUsed = bytesUsed;
+        return s;
+    }
+
+    void resetStatistics()
+    {
+        const ScopedLock sl (lock);
+        statistics = {};
+    }
+
+    //==============================================================================
+    struct Entry
+    {
+        std::variant<ArrangementKey, LayoutKey> key;
+        std::shared_ptr<const void> value;
+        size_t size;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    EntryList lru;
+    std::unordered_map<ArrangementKey, EntryList::iterator, KeyHash> arrangements;
+    std::unordered_map<LayoutKey, EntryList::iterator, KeyHash> layouts;
+    size_t bytesUsed = 0, maximumBytes = 1024 * 1024;
+    Statistics statistics;
+    CriticalSection lock;
+
+private:
+    void removeExcessEntries()
+    {
+        while (bytesUsed > maximumBytes && ! lru.empty())
+        {
+            auto& last = lru.back();
+
+            if (auto* arrangementKey = std::get_if<ArrangementKey> (&last.key))
+                arrangements.erase (*arrangementKey);
+            else
+                layouts.erase (std::get<LayoutKey> (last.key));
+
+            bytesUsed -= last.size;
+            lru.pop_back();
+            ++statistics.evictions;
+        }
+    }
+
+    static size_t getSizeInBytes (const String& s)            { return s.getNumBytesAsUTF8() + 1; }
+    static size_t getSizeInBytes (const ArrangementKey& key)  { return getSizeInBytes (key.text); }
+
+    static size_t getSizeInBytes (const LayoutKey& key)
+    {
+        return getSizeInBytes (key.text.getText()) + (size_t) key.text.getNumAttributes() * sizeof (AttributedString::Attribute);
+    }
+
+    static size_t getSizeInBytes (const ShapedArrangement& shaped)
+    {
+        return sizeof (Entry) + sizeof (ShapedArrangement) + (size_t) shaped.arrangement.getNumGlyphs() * sizeof (PositionedGlyph);
+    }
+
+    static size_t getSizeInBytes (const TextLayout& layout)
+    {
+        auto size = sizeof (Entry) + sizeof (TextLayout);
+
+        for (auto& line : layout)
+        {
+            size += sizeof (TextLayout::Line);
+
+            for (auto* run : line.runs)
+                size += sizeof (TextLayout::Run) + (size_t) run->glyphs.size() * sizeof (TextLayout::Glyph);
+        }
+
+        return size;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Pimpl)
+};
+
+JUCE_IMPLEMENT_SINGLETON (ShapedTextCache::Pimpl)
+
+//==============================================================================
+ShapedTextCache::ArrangementPtr ShapedTextCache::findOrCreateArrangement (ArrangementKey key, const std::function<ShapedArrangement (const ArrangementKey&)>& create)
+{
+    auto& pimpl = *Pimpl::getInstance();
+    return pimpl.findOrCreate<ShapedArrangement> (pimpl.arrangements, std::move (key), [&] { return create (key); });
+}
+
+ShapedTextCache::LayoutPtr ShapedTextCache::findOrCreateLayout (const AttributedString& text, float maxWidth, float maxHeight,
+                                                                bool balanceLineLengths, const std::function<TextLayout()>& create)
+{
+    auto& pimpl = *Pimpl::getInstance();
+    return pimpl.findOrCreate<TextLayout> (pimpl.layouts, Pimpl::LayoutKey { text, maxWidth, maxHeight, balanceLineLengths }, create);
+}
+
+void ShapedTextCache::setMaximumSize (size_t maxBytes)
+{
+    Pimpl::getInstance()->setMaximumSize (maxBytes);
+}
+
+size_t ShapedTextCache::getMaximumSize()
+{
+    return Pimpl::getInstance()->maximumBytes;
+}
+
+void ShapedTextCache::clear()
+{
+    if (auto* instance = Pimpl::getInstanceWithoutCreating())
+        instance->clear();
+}
+
+ShapedTextCache::Statistics ShapedTextCache::getStatistics()
+{
+    return Pimpl::getInstance()->getStatistics();
+}
+
+void ShapedTextCache::resetStatistics()
+{
+    Pimpl::getInstance()->resetStatistics();
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ShapedTextCacheTests final : public UnitTest
+{
+public:
+    ShapedTextCacheTests()
+        : UnitTest ("ShapedTextCache", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        const auto originalMaximumSize = ShapedTextCache::getMaximumSize();
+
+        beginTest ("Text drawn at different positions is only shaped once");
+        {
+            reset();
+
+            Image image (Image::ARGB, 200, 200, true, SoftwareImageType());
+            Graphics g (image);
+
+            for (int row = 0; row < 10; ++row)
+                g.drawText ("Table cell", Rectangle<float> (3.0f, (float) row * 17.5f, 80.0f, 17.5f), Justification::centredLeft, true);
+
+            auto stats = ShapedTextCache::getStatistics();
+            expectEquals ((int) stats.misses, 1);
+            expectEquals ((int) stats.hits, 9);
+            expectEquals (stats.numEntries, 1);
+            expect (stats.bytesUsed > 0);
+            expectEquals (stats.getHitRate(), 0.9);
+
+            g.drawText ("Table cell", Rectangle<float> (3.0f, 0.0f, 81.0f, 17.5f), Justification::centredLeft, true);
+            g.drawText ("Table cell", Rectangle<float> (3.0f, 0.0f, 80.0f, 17.5f), Justification::centred, true);
+            g.setFont (20.0f);
+            g.drawText ("Table cell", Rectangle<float> (3.0f, 0.0f, 80.0f, 17.5f), Justification::centredLeft, true);
+
+            expectEquals ((int) ShapedTextCache::getStatistics().misses, 4);
+        }
+
+        beginTest ("Cached text is drawn in the same place as uncached text");
+        {
+            auto drawAll = [] (Graphics& g)
+            {
+                g.setFont (15.0f);
+                g.drawText ("Some text...", Rectangle<int> (10, 10, 60, 20), Justification::centredRight, true);
+                g.drawFittedText ("Some much longer text that needs to be wrapped", Rectangle<int> (10, 40, 90, 50), Justification::centred, 3);
+                g.drawSingleLineText ("Single line", 150, 120, Justification::right);
+                g.drawMultiLineText ("Several lines of text, wrapped", 10, 140, 80, Justification::left, 2.0f);
+            };
+
+            for (auto maximumSize : { (size_t) 0, originalMaximumSize })
+            {
+                reset();
+                ShapedTextCache::setMaximumSize (maximumSize);
+
+                Image uncached (Image::ARGB, 200, 200, true, SoftwareImageType());
+                Image cached (Image::ARGB, 200, 200, true, SoftwareImageType());
+                Image moved (Image::ARGB, 200, 200, true, SoftwareImageType());
+
+                {
+                    Graphics g (uncached);
+                    drawAll (g);
+                }
+
+                {
+                    Graphics g (cached);
+                    drawAll (g);
+                }
+
+                {
+                    Graphics g (moved);
+                    g.setOrigin ({ 7, 3 });
+                    drawAll (g);
+                }
+
+                expect (! isBlank (uncached));
+                expect (imagesMatch (uncached, cached, {}));
+                expect (imagesMatch (uncached, moved, { 7, 3 }));
+                expectEquals ((int) ShapedTextCache::getStatistics().hits, maximumSize > 0 ? 8 : 0);
+            }
+
+            ShapedTextCache::setMaximumSize (originalMaximumSize);
+        }
+
+        beginTest ("TextLayouts are cached");
+        {
+            reset();
+
+            AttributedString text;
+            text.append ("Hello ", Font (16.0f), Colours::red);
+            text.append ("world, this is some wrapped text", Font (14.0f, Font::bold), Colours::blue);
+
+            TextLayout uncached;
+            ShapedTextCache::setMaximumSize (0);
+            uncached.createLayout (text, 120.0f, 100.0f);
+            ShapedTextCache::setMaximumSize (originalMaximumSize);
+            ShapedTextCache::resetStatistics();
+
+            TextLayout a, b;
+            a.createLayout (text, 120.0f, 100.0f);
+            b.createLayout (text, 120.0f, 100.0f);
+
+            auto stats = ShapedTextCache::getStatistics();
+            expectEquals ((int) stats.misses, 1);
+            expectEquals ((int) stats.hits, 1);
+
+            expect (layoutsMatch (uncached, a));
+            expect (layoutsMatch (uncached, b));
+
+            text.setColour (Colours::green);
+            TextLayout c;
+            c.createLayout (text, 120.0f, 100.0f);
+            expectEquals ((int) ShapedTextCache::getStatistics().misses, 2);
+            expect (c.getLine (0).runs[0]->colour == Colours::green);
+
+            TextLayout d;
+            d.createLayoutWithBalancedLineLengths (text, 120.0f, 100.0f);
+            d.createLayoutWithBalancedLineLengths (text, 120.0f, 100.0f);
+            stats = ShapedTextCache::getStatistics();
+            expectEquals ((int) stats.misses, 3);
+            expectEquals ((int) stats.hits, 2);
+        }
+
+        beginTest ("The cache stays within its maximum size");
+        {
+            reset();
+            ShapedTextCache::setMaximumSize (4000);
+
+            Image image (Image::ARGB, 100, 100, true, SoftwareImageType());
+            Graphics g (image);
+
+            for (int i = 0; i < 100; ++i)
+                g.drawText ("Item " + String (i), 0, 0, 100, 20, Justification::centredLeft);
+
+            auto stats = ShapedTextCache::getStatistics();
+            expect (stats.bytesUsed <= 4000);
+            expect (stats.numEntries > 1 && stats.numEntries < 100);
+            expectEquals ((int) stats.evictions, 100 - stats.numEntries);
+
+            ShapedTextCache::setMaximumSize (originalMaximumSize);
+        }
+
+        reset();
+    }
+
+private:
+    static void reset()
+    {
+        ShapedTextCache::clear();
+        ShapedTextCache::resetStatistics();
+    }
+
+    static bool isBlank (const Image& image)
+    {
+        const Image::BitmapData data (image, Image::BitmapData::readOnly);
+
+        for (int y = 0; y < image.getHeight(); ++y)
+            for (int x = 0; x < image.getWidth(); ++x)
+                if (data.getPixelColour (x, y).getAlpha() != 0)
+                    return false;
+
+        return true;
+    }
+
+    static bool imagesMatch (const Image& a, const Image& b, Point<int> offsetInB)
+    {
+        const Image::BitmapData da (a, Image::BitmapData::readOnly);
+        const Image::BitmapData db (b, Image::BitmapData::readOnly);
+
+        for (int y = 0; y < a.getHeight() - offsetInB.y; ++y)
+            for (int x = 0; x < a.getWidth() - offsetInB.x; ++x)
+                if (da.getPixelColour (x, y) != db.getPixelColour (x + offsetInB.x, y + offsetInB.y))
+                    return false;
+
+        return true;
+    }
+
+    static bool layoutsMatch (const TextLayout& a, const TextLayout& b)
+    {
+        if (a.getNumLines() != b.getNumLines()
+             || ! exactlyEqual (a.getWidth(), b.getWidth())
+             || ! exactlyEqual (a.getHeight(), b.getHeight()))
+            return false;
+
+        for (int i = 0; i < a.getNumLines(); ++i)
+        {
+            auto& la = a.getLine (i);
+            auto& lb = b.getLine (i);
+
+            if (la.lineOrigin != lb.lineOrigin || la.runs.size() != lb.runs.size())
+                return false;
+
+            for (int r = 0; r < la.runs.size(); ++r)
+            {
+                auto& ra = *la.runs.getUnchecked (r);
+                auto& rb = *lb.runs.getUnchecked (r);
+
+                if (ra.font != rb.font || ra.colour != rb.colour || ra.glyphs.size() != rb.glyphs.size())
+                    return false;
+
+                for (int g = 0; g < ra.glyphs.size(); ++g)
+                {
+                    auto& ga = ra.glyphs.getReference (g);
+                    auto& gb = rb.glyphs.getReference (g);
+
+                    if (ga.glyphCode != gb.glyphCode || ga.anchor != gb.anchor)
+                        return false;
+                }
+            }
+        }
+
+        return true;
+    }
+};
+
+static ShapedTextCacheTests shapedTextCacheTests;
+
+#endif
+
+} // namespace juce
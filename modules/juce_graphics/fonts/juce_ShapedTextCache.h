@@ -0,0 +1,138 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A global cache of shaped and measured text, which is used by the Graphics text
+    drawing methods and by TextLayout.
+
+    Turning a string into positioned glyphs means asking the typeface for glyph
+    numbers, advances and kerning, and then breaking and justifying the lines. When the
+    same text is drawn repeatedly (e.g. the cells of a table being repainted or scrolled)
+    the results are the same every time, so they're kept here and reused.
+
+    Graphics::drawText(), drawFittedText(), drawSingleLineText() and drawMultiLineText()
+    store their layouts relative to the area in which they're drawn, so a string that
+    moves around but keeps the same font, size and justification is only shaped once.
+    TextLayout::createLayout() and createLayoutWithBalancedLineLengths() store their
+    results keyed by the AttributedString's contents and the size limits.
+
+    The cache is limited to a maximum number of bytes, and discards the least
+    recently used layouts when it's full.
+
+    @tags{Graphics}
+*/
+class JUCE_API  ShapedTextCache
+{
+public:
+    //==============================================================================
+    /** Sets the maximum amount of memory the cache can use. The default is 1MB.
+        A size of zero turns the cache off.
+    */
+    static void setMaximumSize (size_t maxBytes);
+
+    /** Returns the maximum amount of memory the cache can use. */
+    static size_t getMaximumSize();
+
+    /** Removes everything from the cache. */
+    static void clear();
+
+    //==============================================================================
+    /** Counters describing how well the cache is working. */
+    struct Statistics
+    {
+        int64 hits = 0;           /**< The number of lookups which found a layout in the cache. */
+        int64 misses = 0;         /**< The number of lookups which had to shape the text. */
+        int64 evictions = 0;      /**< The number of layouts which were discarded to make room for others. */
+        int numEntries = 0;       /**< The number of layouts currently in the cache. */
+        size_t bytesUsed = 0;     /**< The approximate amount of memory that the cached layouts are using. */
+
+        /** Returns the proportion of lookups that were hits, from 0 to 1. */
+        double getHitRate() const noexcept      { return hits + misses > 0 ? (double) hits / (double) (hits + misses) : 0.0; }
+    };
+
+    /** Returns the cache's current statistics. */
+    static Statistics getStatistics();
+
+    /** Resets the hit, miss and eviction counters to zero. */
+    static void resetStatistics();
+
+private:
+    //==============================================================================
+    friend class Graphics;
+    friend class TextLayout;
+
+    /** The parameters that a GlyphArrangement was created from. Positions aren't
+        included, because the arrangement is created at the origin and moved to where
+        it's drawn.
+    */
+    struct ArrangementKey
+    {
+        enum class Method
+        {
+            singleLine,
+            multiLine,
+            curtailedLine,
+            fitted
+        };
+
+        Method method;
+        Font font;
+        String text;
+        float width = 0, height = 0, extra = 0;
+        int justification = 0, maximumLines = 0;
+        bool useEllipsis = false;
+
+        bool operator== (const ArrangementKey&) const;
+    };
+
+    /** A cached GlyphArrangement, and a transform to apply when drawing it. */
+    struct ShapedArrangement
+    {
+        void draw (const Graphics& g, AffineTransform placement) const    { arrangement.draw (g, transform.followedBy (placement)); }
+
+        GlyphArrangement arrangement;
+        AffineTransform transform;
+    };
+
+    using ArrangementPtr = std::shared_ptr<const ShapedArrangement>;
+    using LayoutPtr = std::shared_ptr<const TextLayout>;
+
+    static ArrangementPtr findOrCreateArrangement (ArrangementKey, const std::function<ShapedArrangement (const ArrangementKey&)>& create);
+    static LayoutPtr findOrCreateLayout (const AttributedString&, float maxWidth, float maxHeight,
+                                         bool balanceLineLengths, const std::function<TextLayout()>& create);
+
+    struct Pimpl;
+    friend struct Pimpl;
+
+    ShapedTextCache() = delete;
+
+    JUCE_DECLARE_NON_COPYABLE (ShapedTextCache)
+};
+
+} // namespace juce
@@ -246,6 +246,16 @@ void TextLayout::createLayout (const AttributedString& text, float maxWidth)
 }
 
 void TextLayout::createLayout (const AttributedString& text, float maxWidth, float maxHeight)
+{
+    *this = *ShapedTextCache::findOrCreateLayout (text, maxWidth, maxHeight, false, [&]
+    {
+        TextLayout layout;
+        layout.createUncachedLayout (text, maxWidth, maxHeight);
+        return layout;
+    });
+}
+
+void TextLayout::createUncachedLayout (const AttributedString& text, float maxWidth, float maxHeight)
 {
     lines.clear();
     width = maxWidth;
@@ -264,6 +274,16 @@ void TextLayout::createLayoutWithBalancedLineLengths (const AttributedString& te
 }
 
 void TextLayout::createLayoutWithBalancedLineLengths (const AttributedString& text, float maxWidth, float maxHeight)
+{
+    *this = *ShapedTextCache::findOrCreateLayout (text, maxWidth, maxHeight, true, [&]
+    {
+        TextLayout layout;
+        layout.createUncachedLayoutWithBalancedLineLengths (text, maxWidth, maxHeight);
+        return layout;
+    });
+}
+
+void TextLayout::createUncachedLayoutWithBalancedLineLengths (const AttributedString& text, float maxWidth, float maxHeight)
 {
     auto minimumWidth = maxWidth / 2.0f;
     auto bestWidth = maxWidth;
@@ -271,7 +291,7 @@ void TextLayout::createLayoutWithBalancedLineLengths (const AttributedString& te
 
     while (maxWidth > minimumWidth)
     {
-        createLayout (text, maxWidth, maxHeight);
+        createUncachedLayout (text, maxWidth, maxHeight);
 
         if (getNumLines() < 2)
             return;
@@ -295,7 +315,7 @@ void TextLayout::createLayoutWithBalancedLineLengths (const AttributedString& te
     }
 
     if (! approximatelyEqual (bestWidth, maxWidth))
-        createLayout (text, bestWidth, maxHeight);
+        createUncachedLayout (text, bestWidth, maxHeight);
 }
 
 //==============================================================================
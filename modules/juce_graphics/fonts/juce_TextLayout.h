@@ -261,6 +261,8 @@ private:
     float width, height;
     Justification justification;
 
+    void createUncachedLayout (const AttributedString&, float maxWidth, float maxHeight);
+    void createUncachedLayoutWithBalancedLineLengths (const AttributedString&, float maxWidth, float maxHeight);
     void createStandardLayout (const AttributedString&);
     bool createNativeLayout (const AttributedString&);
 
@@ -46,64 +46,151 @@ EdgeTable::EdgeTable (Rectangle<int> area, const Path& path, const AffineTransfo
         t += lineStrideElements;
     }
 
-    auto leftLimit   = scale * static_cast<int64_t> (bounds.getX());
-    auto topLimit    = scale * static_cast<int64_t> (bounds.getY());
-    auto rightLimit  = scale * static_cast<int64_t> (bounds.getRight());
-    auto heightLimit = scale * static_cast<int64_t> (bounds.getHeight());
-
     PathFlatteningIterator iter (path, transform);
 
     while (iter.next())
+        addLine (iter.x1, iter.y1, iter.x2, iter.y2);
+
+    sanitiseLevels (path.isUsingNonZeroWinding());
+}
+
+EdgeTable::EdgeTable (Rectangle<int> clipLimits, const Point<float>* points, int numPoints,
+                      float lineThickness, const AffineTransform& transform)
+   : bounds (clipLimits),
+     maxEdgesPerLine (jmax (defaultEdgesPerLine / 2, 4 * (int) std::sqrt (numPoints * 3))),
+     lineStrideElements (maxEdgesPerLine * 2 + 1)
+{
+    const auto halfThickness = lineThickness * 0.5f;
+
+    if (numPoints > 0)
+        bounds = bounds.getIntersection (Rectangle<float>::findAreaContainingPoints (points, numPoints)
+                                            .expanded (halfThickness)
+                                            .transformedBy (transform)
+                                            .getSmallestIntegerContainer()
+                                            .expanded (1));
+
+    allocate();
+    clearLineSizes();
+
+    // Each segment is added as a quadrilateral, and the gaps on the outsides of the joints are
+    // filled with triangles. These all wind in the same direction, so where they overlap the
+    // non-zero winding rule just merges them.
+    const auto isIdentity = transform.isIdentity();
+
+    auto addPolygon = [&] (std::initializer_list<Point<float>> corners)
     {
-        const auto scaleIterY = [] (auto y)
+        auto previous = *std::prev (corners.end());
+
+        if (! isIdentity)
+            previous = previous.transformedBy (transform);
+
+        for (auto corner : corners)
         {
-            return static_cast<int64_t> (y * 256.0f + (y >= 0 ? 0.5f : -0.5f));
-        };
+            if (! isIdentity)
+                corner = corner.transformedBy (transform);
+
+            addLine (previous.x, previous.y, corner.x, corner.y);
+            previous = corner;
+        }
+    };
+
+    auto getNormal = [halfThickness] (Point<float> start, Point<float> end)
+    {
+        auto delta = end - start;
+        auto length = delta.getDistanceFromOrigin();
+        return length > 0.0f ? Point<float> (-delta.y, delta.x) * (halfThickness / length) : Point<float>();
+    };
+
+    Point<float> lastNormal;
+
+    for (int i = 1; i < numPoints; ++i)
+    {
+        auto start = points[i - 1], end = points[i];
+        auto normal = getNormal (start, end);
+
+        if (normal.isOrigin())
+            continue;
 
-        auto y1 = scaleIterY (iter.y1);
-        auto y2 = scaleIterY (iter.y2);
+        addPolygon ({ start + normal, end + normal, end - normal, start - normal });
 
-        if (y1 != y2)
+        if (! lastNormal.isOrigin())
         {
-            y1 -= topLimit;
-            y2 -= topLimit;
+            // (only the outside of the joint needs filling, as the segments overlap on the inside)
+            if (lastNormal.x * normal.y - lastNormal.y * normal.x > 0)
+                addPolygon ({ start, start - normal, start - lastNormal });
+            else
+                addPolygon ({ start, start + lastNormal, start + normal });
+        }
 
-            auto startY = y1;
-            int direction = -1;
+        lastNormal = normal;
+    }
 
-            if (y1 > y2)
-            {
-                std::swap (y1, y2);
-                direction = 1;
-            }
+    sanitiseLevels (true);
+}
 
-            if (y1 < 0)
-                y1 = 0;
+EdgeTable::EdgeTable (Rectangle<int> clipLimits, float x, float columnWidth,
+                      const float* tops, const float* bottoms, int numColumns,
+                      const AffineTransform& transform)
+   : bounds (clipLimits),
+     maxEdgesPerLine (defaultEdgesPerLine),
+     lineStrideElements (defaultEdgesPerLine * 2 + 1)
+{
+    // only scaling and translation are supported, as the columns must stay vertical
+    jassert (approximatelyEqual (transform.mat01, 0.0f) && approximatelyEqual (transform.mat10, 0.0f));
 
-            if (y2 > heightLimit)
-                y2 = heightLimit;
+    auto minY = std::numeric_limits<float>::max(), maxY = std::numeric_limits<float>::lowest();
 
-            if (y1 < y2)
-            {
-                const double startX = 256.0f * iter.x1;
-                const double multiplier = (iter.x2 - iter.x1) / (iter.y2 - iter.y1);
-                auto stepSize = static_cast<int64_t> (jlimit (1, 256, 256 / (1 + (int) std::abs (multiplier))));
+    for (int i = 0; i < numColumns; ++i)
+    {
+        if (tops[i] < bottoms[i])
+        {
+            minY = jmin (minY, tops[i]);
+            maxY = jmax (maxY, bottoms[i]);
+        }
+    }
 
-                do
-                {
-                    auto step = jmin (stepSize, y2 - y1, 256 - (y1 & 255));
-                    auto x = static_cast<int64_t> (startX + multiplier * static_cast<double> ((y1 + (step >> 1)) - startY));
-                    auto clampedX = static_cast<int> (jlimit (leftLimit, rightLimit - 1, x));
+    if (minY <= maxY)
+        bounds = bounds.getIntersection (Rectangle<float>::leftTopRightBottom (x, minY, x + columnWidth * (float) numColumns, maxY)
+                                            .transformedBy (transform)
+                                            .getSmallestIntegerContainer()
+                                            .expanded (1));
+    else
+        bounds.setHeight (0);
 
-                    addEdgePoint (clampedX, static_cast<int> (y1 / scale), static_cast<int> (direction * step));
-                    y1 += step;
-                }
-                while (y1 < y2);
-            }
+    allocate();
+    clearLineSizes();
+
+    // Rather than adding the sides of every column, this traces the outline of the whole
+    // waveform, so each boundary between two columns just gets the vertical edges that make
+    // up the difference between their tops and their bottoms.
+    auto previousTop = 0.0f, previousBottom = 0.0f;
+
+    for (int i = 0; i <= numColumns; ++i)
+    {
+        auto top = previousBottom, bottom = previousBottom;
+
+        if (i < numColumns && tops[i] < bottoms[i])
+        {
+            top    = tops[i]    * transform.mat11 + transform.mat12;
+            bottom = bottoms[i] * transform.mat11 + transform.mat12;
+
+            if (top > bottom)
+                std::swap (top, bottom);
         }
+
+        if (i == 0)
+            previousTop = previousBottom = top;
+
+        auto edgeX = (x + columnWidth * (float) i) * transform.mat00 + transform.mat02;
+
+        addLine (edgeX, previousTop, edgeX, top);
+        addLine (edgeX, bottom, edgeX, previousBottom);
+
+        previousTop = top;
+        previousBottom = bottom;
     }
 
-    sanitiseLevels (path.isUsingNonZeroWinding());
+    sanitiseLevels (true);
 }
 
 EdgeTable::EdgeTable (Rectangle<int> rectangleToAdd)
@@ -461,6 +548,61 @@ void EdgeTable::addEdgePointPair (int x1, int x2, int y, int winding)
     line[4] = -winding;
 }
 
+void EdgeTable::addLine (float lineX1, float lineY1, float lineX2, float lineY2)
+{
+    auto leftLimit   = scale * static_cast<int64_t> (bounds.getX());
+    auto topLimit    = scale * static_cast<int64_t> (bounds.getY());
+    auto rightLimit  = scale * static_cast<int64_t> (bounds.getRight());
+    auto heightLimit = scale * static_cast<int64_t> (bounds.getHeight());
+
+    const auto scaleY = [] (auto y)
+    {
+        return static_cast<int64_t> (y * 256.0f + (y >= 0 ? 0.5f : -0.5f));
+    };
+
+    auto y1 = scaleY (lineY1);
+    auto y2 = scaleY (lineY2);
+
+    if (y1 != y2)
+    {
+        y1 -= topLimit;
+        y2 -= topLimit;
+
+        auto startY = y1;
+        int direction = -1;
+
+        if (y1 > y2)
+        {
+            std::swap (y1, y2);
+            direction = 1;
+        }
+
+        if (y1 < 0)
+            y1 = 0;
+
+        if (y2 > heightLimit)
+            y2 = heightLimit;
+
+        if (y1 < y2)
+        {
+            const double startX = 256.0f * lineX1;
+            const double multiplier = (lineX2 - lineX1) / (lineY2 - lineY1);
+            auto stepSize = static_cast<int64_t> (jlimit (1, 256, 256 / (1 + (int) std::abs (multiplier))));
+
+            do
+            {
+                auto step = jmin (stepSize, y2 - y1, 256 - (y1 & 255));
+                auto x = static_cast<int64_t> (startX + multiplier * static_cast<double> ((y1 + (step >> 1)) - startY));
+                auto clampedX = static_cast<int> (jlimit (leftLimit, rightLimit, x));
+
+                addEdgePoint (clampedX, static_cast<int> (y1 / scale), static_cast<int> (direction * step));
+                y1 += step;
+            }
+            while (y1 < y2);
+        }
+    }
+}
+
 void EdgeTable::translate (float dx, int dy) noexcept
 {
     bounds.translate ((int) std::floor (dx), dy);
@@ -840,4 +982,179 @@ bool EdgeTable::isEmpty() noexcept
 
 JUCE_END_IGNORE_WARNINGS_MSVC
 
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class EdgeTableTests final : public UnitTest
+{
+public:
+    EdgeTableTests()
+        : UnitTest ("EdgeTable", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        auto random = getRandom();
+
+        beginTest ("Waveform columns match the equivalent rectangles");
+        {
+            constexpr int numColumns = 150;
+            float tops[numColumns], bottoms[numColumns];
+
+            for (int i = 0; i < numColumns; ++i)
+            {
+                tops[i]    = 50.0f - random.nextFloat() * 45.0f;
+                bottoms[i] = 50.0f + random.nextFloat() * 45.0f;
+
+                if (random.nextInt (10) == 0)
+                    std::swap (tops[i], bottoms[i]);
+            }
+
+            for (auto transform : { AffineTransform(),
+                                    AffineTransform::translation (3.3f, -2.7f),
+                                    AffineTransform::scale (1.7f, 0.6f).translated (-5.0f, 20.0f) })
+            {
+                for (auto columnWidth : { 1.0f, 0.75f, 2.3f })
+                {
+                    auto expected = render ([&] (Graphics& g)
+                    {
+                        RectangleList<float> columns;
+
+                        for (int i = 0; i < numColumns; ++i)
+                            if (tops[i] < bottoms[i])
+                                columns.addWithoutMerging ({ 10.25f + (float) i * columnWidth, tops[i], columnWidth, bottoms[i] - tops[i] });
+
+                        g.addTransform (transform);
+                        g.fillRectList (columns);
+                    });
+
+                    auto actual = render ([&] (Graphics& g)
+                    {
+                        g.addTransform (transform);
+                        g.fillWaveformColumns (10.25f, columnWidth, tops, bottoms, numColumns);
+                    });
+
+                    expectLessOrEqual (getMaxDifference (expected, actual), 2);
+                }
+            }
+        }
+
+        beginTest ("Polylines match the equivalent stroked path");
+        {
+            constexpr int numPoints = 200;
+            Point<float> points[numPoints];
+
+            for (int i = 0; i < numPoints; ++i)
+                points[i] = { 5.0f + (float) i * 1.5f, 20.0f + random.nextFloat() * 60.0f };
+
+            for (auto thickness : { 1.0f, 3.5f })
+            {
+                auto expected = render ([&] (Graphics& g)
+                {
+                    Path p;
+                    p.startNewSubPath (points[0]);
+
+                    for (int i = 1; i < numPoints; ++i)
+                        p.lineTo (points[i]);
+
+                    g.strokePath (p, PathStrokeType (thickness, PathStrokeType::beveled, PathStrokeType::butt));
+                });
+
+                auto actual = render ([&] (Graphics& g) { g.drawPolyline (points, numPoints, thickness); });
+
+                // The segments overlap on the insides of the joints, and where both of them only
+                // partly cover a pixel its coverage is added twice. That only happens to pixels
+                // touching the joint's circle, and as the sum is clamped it can't add more than
+                // half a pixel. The inner edges can cross in the corner of a pixel, so up to a
+                // 2x2 block of them may be affected at each joint.
+                const auto maxDistance = thickness * 0.5f + MathConstants<float>::sqrt2 * 0.5f;
+                int numDifferencesAtJoint[numPoints] = {};
+
+                for (int y = 0; y < actual.getHeight(); ++y)
+                {
+                    for (int x = 0; x < actual.getWidth(); ++x)
+                    {
+                        auto difference = getDifference (expected, actual, x, y);
+
+                        if (difference <= 8)
+                            continue;
+
+                        const Point<float> centre ((float) x + 0.5f, (float) y + 0.5f);
+                        auto nearestJoint = 1;
+
+                        for (int i = 2; i < numPoints - 1; ++i)
+                            if (centre.getDistanceFrom (points[i]) < centre.getDistanceFrom (points[nearestJoint]))
+                                nearestJoint = i;
+
+                        expectLessOrEqual (centre.getDistanceFrom (points[nearestJoint]), maxDistance);
+                        expectLessThan (difference, 128);
+
+                        if (difference > 32)
+                            ++numDifferencesAtJoint[nearestJoint];
+                    }
+                }
+
+                expectLessOrEqual (*std::max_element (std::begin (numDifferencesAtJoint), std::end (numDifferencesAtJoint)), 4);
+            }
+        }
+
+        beginTest ("Polylines are drawn at the expected position");
+        {
+            auto image = render ([] (Graphics& g)
+            {
+                const float values[] = { 10.5f, 10.5f, 10.5f };
+                g.drawPolyline (20.0f, 15.0f, values, 3, 1.0f);
+            });
+
+            expectEquals ((int) image.getPixelAt (35, 10).getAlpha(), 255);
+            expectEquals ((int) image.getPixelAt (35, 9).getAlpha(), 0);
+            expectEquals ((int) image.getPixelAt (35, 11).getAlpha(), 0);
+            expectEquals ((int) image.getPixelAt (19, 10).getAlpha(), 0);
+            expectEquals ((int) image.getPixelAt (50, 10).getAlpha(), 0);
+        }
+
+        beginTest ("Tables are limited to the clip region");
+        {
+            const Point<float> points[] = { { -100.0f, -100.0f }, { 500.0f, 500.0f } };
+            EdgeTable table ({ 10, 10, 50, 50 }, points, 2, 4.0f, {});
+
+            expect (Rectangle<int> (10, 10, 50, 50).contains (table.getMaximumBounds()));
+            expect (! table.isEmpty());
+        }
+    }
+
+private:
+    template <typename Fn>
+    static Image render (Fn&& draw)
+    {
+        Image image (Image::ARGB, 300, 100, true, SoftwareImageType());
+        Graphics g (image);
+        g.setColour (Colours::white);
+        draw (g);
+        return image;
+    }
+
+    static int getDifference (const Image& a, const Image& b, int x, int y)
+    {
+        return std::abs ((int) a.getPixelAt (x, y).getAlpha() - (int) b.getPixelAt (x, y).getAlpha());
+    }
+
+    static int getMaxDifference (const Image& a, const Image& b)
+    {
+        int maxDifference = 0;
+
+        for (int y = 0; y < a.getHeight(); ++y)
+            for (int x = 0; x < a.getWidth(); ++x)
+                maxDifference = jmax (maxDifference, getDifference (a, b, x, y));
+
+        return maxDifference;
+    }
+};
+
+static EdgeTableTests edgeTableTests;
+
+#endif
+
 } // namespace juce
@@ -51,6 +51,44 @@ public:
                const Path& pathToAdd,
                const AffineTransform& transform);
 
+    /** Creates an edge table containing a line that joins a series of points.
+
+        The line has flat ends and bevelled joints. This is much quicker than adding the
+        points to a Path and stroking it, although because the segments overlap at the
+        joints, the anti-aliasing around sharp corners can be slightly heavier.
+
+        @param clipLimits       only the region of the line that lies within this area will be added
+        @param points           the points to join
+        @param numPoints        the number of points
+        @param lineThickness    the thickness of the line, before the transform is applied
+        @param transform        a transform to apply to the line
+    */
+    EdgeTable (Rectangle<int> clipLimits,
+               const Point<float>* points, int numPoints,
+               float lineThickness,
+               const AffineTransform& transform);
+
+    /** Creates an edge table containing a row of adjacent vertical columns, e.g. the levels
+        of a waveform.
+
+        Column i spans horizontally from (x + i * columnWidth) to (x + (i + 1) * columnWidth),
+        and vertically from tops[i] to bottoms[i]. Columns whose top isn't above their bottom
+        are left empty.
+
+        @param clipLimits       only the region of the columns that lies within this area will be added
+        @param x                the left-hand edge of the first column
+        @param columnWidth      the width of each column
+        @param tops             the top of each column
+        @param bottoms          the bottom of each column
+        @param numColumns       the number of columns
+        @param transform        a transform to apply to the columns, which can only contain
+                                a scale and a translation
+    */
+    EdgeTable (Rectangle<int> clipLimits,
+               float x, float columnWidth,
+               const float* tops, const float* bottoms, int numColumns,
+               const AffineTransform& transform);
+
     /** Creates an edge table containing a rectangle. */
     explicit EdgeTable (Rectangle<int> rectangleToAdd);
 
@@ -69,6 +107,12 @@ public:
     /** Copies from another edge table. */
     EdgeTable& operator= (const EdgeTable&);
 
+    /** Move constructor. */
+    EdgeTable (EdgeTable&&) noexcept = default;
+
+    /** Move assignment operator. */
+    EdgeTable& operator= (EdgeTable&&) noexcept = default;
+
     /** Destructor. */
     ~EdgeTable();
 
@@ -213,6 +257,7 @@ private:
     void clearLineSizes() noexcept;
     void addEdgePoint (int x, int y, int winding);
     void addEdgePointPair (int x1, int x2, int y, int winding);
+    void addLine (float x1, float y1, float x2, float y2);
     void remapTableForNumEdges (int newNumEdgesPerLine);
     void remapWithExtraSpace (int numPointsNeeded);
     void intersectWithEdgeTableLine (int y, const int* otherLine);
@@ -97,6 +97,35 @@ void Path::PathBounds::extend (float x, float y) noexcept
     else if (y > pathYMax) pathYMax = y;
 }
 
+//==============================================================================
+// Copies of a path share this until one of them is modified, so its contents have
+// their own lock, separate from the one that guards each path's pointer to it.
+struct Path::CachedGeometry
+{
+    struct Stroke
+    {
+        PathStrokeType type;
+        AffineTransform transform;
+        float extraAccuracy;
+        std::shared_ptr<const Path> outline; // (null until the path has been stroked twice)
+
+        bool matches (const PathStrokeType& t, const AffineTransform& tr, float accuracy) const noexcept
+        {
+            return type == t && transform == tr && exactlyEqual (extraAccuracy, accuracy);
+        }
+    };
+
+    struct Fill
+    {
+        AffineTransform transform;
+        std::unique_ptr<EdgeTable> edgeTable; // (null until the path has been filled twice)
+    };
+
+    std::optional<Stroke> stroke;
+    std::optional<Fill> fill;
+    SpinLock lock;
+};
+
 //==============================================================================
 Path::Path()
 {
@@ -109,7 +138,8 @@ Path::~Path()
 Path::Path (const Path& other)
     : data (other.data),
       bounds (other.bounds),
-      useNonZeroWinding (other.useNonZeroWinding)
+      useNonZeroWinding (other.useNonZeroWinding),
+      cachedGeometry (other.getCachedGeometry (false))
 {
 }
 
@@ -120,6 +150,7 @@ Path& Path::operator= (const Path& other)
         data = other.data;
         bounds = other.bounds;
         useNonZeroWinding = other.useNonZeroWinding;
+        cachedGeometry = other.getCachedGeometry (false);
     }
 
     return *this;
@@ -128,7 +159,8 @@ Path& Path::operator= (const Path& other)
 Path::Path (Path&& other) noexcept
     : data (std::move (other.data)),
       bounds (other.bounds),
-      useNonZeroWinding (other.useNonZeroWinding)
+      useNonZeroWinding (other.useNonZeroWinding),
+      cachedGeometry (std::move (other.cachedGeometry))
 {
 }
 
@@ -137,6 +169,7 @@ Path& Path::operator= (Path&& other) noexcept
     data = std::move (other.data);
     bounds = other.bounds;
     useNonZeroWinding = other.useNonZeroWinding;
+    cachedGeometry = std::move (other.cachedGeometry);
     return *this;
 }
 
@@ -147,6 +180,7 @@ void Path::clear() noexcept
 {
     data.clearQuick();
     bounds.reset();
+    invalidateCachedGeometry();
 }
 
 void Path::swapWithPath (Path& other) noexcept
@@ -157,12 +191,14 @@ void Path::swapWithPath (Path& other) noexcept
     std::swap (bounds.pathYMin, other.bounds.pathYMin);
     std::swap (bounds.pathYMax, other.bounds.pathYMax);
     std::swap (useNonZeroWinding, other.useNonZeroWinding);
+    std::swap (cachedGeometry, other.cachedGeometry);
 }
 
 //==============================================================================
 void Path::setUsingNonZeroWinding (const bool isNonZero) noexcept
 {
     useNonZeroWinding = isNonZero;
+    invalidateCachedGeometry();
 }
 
 void Path::scaleToFit (float x, float y, float w, float h, bool preserveProportions) noexcept
@@ -218,6 +254,7 @@ void Path::startNewSubPath (const float x, const float y)
         bounds.extend (x, y);
 
     data.add (moveMarker, x, y);
+    invalidateCachedGeometry();
 }
 
 void Path::startNewSubPath (Point<float> start)
@@ -234,6 +271,7 @@ void Path::lineTo (const float x, const float y)
 
     data.add (lineMarker, x, y);
     bounds.extend (x, y);
+    invalidateCachedGeometry();
 }
 
 void Path::lineTo (Point<float> end)
@@ -252,6 +290,7 @@ void Path::quadraticTo (const float x1, const float y1,
 
     data.add (quadMarker, x1, y1, x2, y2);
     bounds.extend (x1, y1, x2, y2);
+    invalidateCachedGeometry();
 }
 
 void Path::quadraticTo (Point<float> controlPoint, Point<float> endPoint)
@@ -273,6 +312,7 @@ void Path::cubicTo (const float x1, const float y1,
 
     data.add (cubicMarker, x1, y1, x2, y2, x3, y3);
     bounds.extend (x1, y1, x2, y2, x3, y3);
+    invalidateCachedGeometry();
 }
 
 void Path::cubicTo (Point<float> controlPoint1,
@@ -287,7 +327,10 @@ void Path::cubicTo (Point<float> controlPoint1,
 void Path::closeSubPath()
 {
     if (! (data.isEmpty() || isMarker (data.getLast(), closeSubPathMarker)))
+    {
         data.add (closeSubPathMarker);
+        invalidateCachedGeometry();
+    }
 }
 
 Point<float> Path::getCurrentPosition() const
@@ -342,6 +385,8 @@ void Path::addRectangle (float x, float y, float w, float h)
               lineMarker, x2, y1,
               lineMarker, x2, y2,
               closeSubPathMarker);
+
+    invalidateCachedGeometry();
 }
 
 void Path::addRoundedRectangle (float x, float y, float w, float h, float csx, float csy)
@@ -817,6 +862,7 @@ void Path::addPath (const Path& other,
 //==============================================================================
 void Path::applyTransform (const AffineTransform& transform) noexcept
 {
+    invalidateCachedGeometry();
     bounds.reset();
     bool firstPoint = true;
     float* d = data.begin();
@@ -1270,11 +1316,11 @@ void Path::loadPathFromStream (InputStream& source)
             break;
 
         case 'n':
-            useNonZeroWinding = true;
+            setUsingNonZeroWinding (true);
             break;
 
         case 'z':
-            useNonZeroWinding = false;
+            setUsingNonZeroWinding (false);
             break;
 
         case 'e':
@@ -1340,6 +1386,115 @@ void Path::writePathToStream (OutputStream& dest) const
     dest.writeByte ('e'); // marks the end-of-path
 }
 
+//==============================================================================
+void Path::invalidateCachedGeometry() noexcept
+{
+    // (any copies that are sharing the cache keep it)
+    cachedGeometry.reset();
+}
+
+std::shared_ptr<Path::CachedGeometry> Path::getCachedGeometry (bool createIfNeeded) const
+{
+    const SpinLock::ScopedLockType sl (cachedGeometryLock);
+
+    if (cachedGeometry == nullptr && createIfNeeded)
+        cachedGeometry = std::make_shared<CachedGeometry>();
+
+    return cachedGeometry;
+}
+
+std::shared_ptr<const Path> Path::getCachedStroke (const PathStrokeType& strokeType,
+                                                   const AffineTransform& transform,
+                                                   float extraAccuracy) const
+{
+    const auto cache = getCachedGeometry (true);
+
+    {
+        const SpinLock::ScopedLockType sl (cache->lock);
+        const auto& stroke = cache->stroke;
+
+        if (stroke.has_value() && stroke->outline != nullptr && stroke->matches (strokeType, transform, extraAccuracy))
+            return stroke->outline;
+    }
+
+    auto outline = std::make_shared<Path>();
+    strokeType.createStrokedPath (*outline, *this, transform, extraAccuracy);
+
+    const SpinLock::ScopedLockType sl (cache->lock);
+    auto& stroke = cache->stroke;
+
+    // Like the edge table, the outline is only kept once the path has been stroked the same
+    // way twice, so a temporary path doesn't hang on to it
+    if (stroke.has_value() && stroke->matches (strokeType, transform, extraAccuracy))
+        stroke->outline = outline;
+    else
+        stroke = CachedGeometry::Stroke { strokeType, transform, extraAccuracy, nullptr };
+
+    return outline;
+}
+
+EdgeTable Path::createEdgeTable (Rectangle<int> clipLimits, const AffineTransform& transform) const
+{
+    // A cached table has to cover the whole path, so very tall ones aren't kept, as
+    // they'd mostly be clipped away anyway.
+    constexpr int maxCachedHeight = 2048;
+    const auto pathBounds = getBoundsTransformed (transform).getSmallestIntegerContainer().expanded (1);
+
+    if (pathBounds.getHeight() > maxCachedHeight)
+        return EdgeTable (clipLimits, *this, transform);
+
+    // Returns the whole-pixel offset between two transforms, if that's all that separates them
+    auto getOffsetBetween = [] (const AffineTransform& a, const AffineTransform& b) -> std::optional<Point<int>>
+    {
+        if (! (exactlyEqual (a.mat00, b.mat00) && exactlyEqual (a.mat01, b.mat01)
+                && exactlyEqual (a.mat10, b.mat10) && exactlyEqual (a.mat11, b.mat11)))
+            return {};
+
+        const auto dx = a.mat02 - b.mat02, dy = a.mat12 - b.mat12;
+        const Point<int> offset (roundToInt (dx), roundToInt (dy));
+
+        if (std::abs (dx - (float) offset.x) > 1.0f / 1024.0f || std::abs (dy - (float) offset.y) > 1.0f / 1024.0f)
+            return {};
+
+        return offset;
+    };
+
+    const auto cache = getCachedGeometry (true);
+
+    {
+        const SpinLock::ScopedLockType sl (cache->lock);
+        auto& fill = cache->fill;
+        const auto offset = fill.has_value() ? getOffsetBetween (transform, fill->transform) : std::nullopt;
+
+        if (! offset.has_value())
+        {
+            // The first time that a path is filled in a particular way, this is just noted,
+            // so that a temporary path doesn't pay for a copy of its table.
+            fill = CachedGeometry::Fill { transform, nullptr };
+            return EdgeTable (clipLimits, *this, transform);
+        }
+
+        if (fill->edgeTable != nullptr)
+        {
+            EdgeTable result (*fill->edgeTable);
+            result.translate ((float) offset->x, offset->y);
+            return result;
+        }
+    }
+
+    EdgeTable table (pathBounds, *this, transform);
+
+    const SpinLock::ScopedLockType sl (cache->lock);
+
+    if (cache->fill.has_value() && cache->fill->edgeTable == nullptr)
+    {
+        cache->fill->transform = transform;
+        cache->fill->edgeTable = std::make_unique<EdgeTable> (table);
+    }
+
+    return table;
+}
+
 String Path::toString() const
 {
     MemoryOutputStream s (2048);
@@ -1533,4 +1688,221 @@ bool Path::Iterator::next() noexcept
 
 #undef JUCE_CHECK_COORDS_ARE_VALID
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class PathTests final : public UnitTest
+{
+public:
+    PathTests()
+        : UnitTest ("Path", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        auto random = getRandom();
+
+        beginTest ("Flattened curves stay within the tolerance");
+        {
+            for (int i = 0; i < 200; ++i)
+            {
+                const auto size = (float) (8 << (i % 8));
+                const auto p0 = randomPoint (random, size), p1 = randomPoint (random, size),
+                           p2 = randomPoint (random, size), p3 = randomPoint (random, size);
+
+                Path cubic;
+                cubic.startNewSubPath (p0);
+                cubic.cubicTo (p1, p2, p3);
+
+                expect (getMaximumDeviation (cubic, [&] (float t)
+                {
+                    const auto u = 1.0f - t;
+                    return p0 * (u * u * u) + p1 * (3.0f * u * u * t) + p2 * (3.0f * u * t * t) + p3 * (t * t * t);
+                }) <= Path::defaultToleranceForMeasurement);
+
+                Path quad;
+                quad.startNewSubPath (p0);
+                quad.quadraticTo (p1, p2);
+
+                expect (getMaximumDeviation (quad, [&] (float t)
+                {
+                    const auto u = 1.0f - t;
+                    return p0 * (u * u) + p1 * (2.0f * u * t) + p2 * (t * t);
+                }) <= Path::defaultToleranceForMeasurement);
+            }
+        }
+
+        beginTest ("Flattening reports sub-paths correctly");
+        {
+            Path p;
+            p.startNewSubPath (0.0f, 0.0f);
+            p.quadraticTo (50.0f, 100.0f, 100.0f, 0.0f);
+            p.closeSubPath();
+            p.startNewSubPath (200.0f, 0.0f);
+            p.lineTo (300.0f, 0.0f);
+
+            PathFlatteningIterator it (p);
+            int numLines = 0, numClosingLines = 0, numLastInSubpath = 0;
+
+            while (it.next())
+            {
+                if (it.subPathIndex == 0)
+                    expect (numLines == 0 || approximatelyEqual (it.x1, 200.0f));
+
+                numLines += 1;
+                numClosingLines += it.closesSubPath ? 1 : 0;
+
+                if (it.isLastInSubpath())
+                {
+                    ++numLastInSubpath;
+                    expect (it.closesSubPath || approximatelyEqual (it.x2, 300.0f));
+                }
+            }
+
+            expect (numLines > 4);
+            expectEquals (numClosingLines, 1);
+            expectEquals (numLastInSubpath, 2);
+        }
+
+        beginTest ("Stroked outlines are cached until the path changes");
+        {
+            Path p;
+            p.startNewSubPath (10.0f, 10.0f);
+            p.cubicTo (50.0f, 90.0f, 80.0f, -20.0f, 120.0f, 40.0f);
+
+            const PathStrokeType stroke (3.0f);
+            Path expected;
+            stroke.createStrokedPath (expected, p);
+
+            // The first outline isn't kept, in case the path is only stroked once
+            auto first = p.getCachedStroke (stroke);
+            expect (*first == expected);
+            expectEquals (first.use_count(), 1L);
+
+            auto outline = p.getCachedStroke (stroke);
+            expect (*outline == expected);
+            expect (outline != first);
+            expect (p.getCachedStroke (stroke) == outline);
+
+            const auto thicker = PathStrokeType (4.0f);
+            expect (p.getCachedStroke (thicker) != outline);
+            expect (p.getCachedStroke (stroke) != outline);
+
+            outline = p.getCachedStroke (stroke);
+            expect (p.getCachedStroke (stroke) == outline);
+
+            beginTest ("Copies of a path share its cached outline until they're modified");
+            Path copy (p);
+            expect (copy.getCachedStroke (stroke) == outline);
+
+            p.lineTo (150.0f, 10.0f);
+            expect (copy.getCachedStroke (stroke) == outline);
+
+            auto modified = p.getCachedStroke (stroke);
+            expect (modified != outline);
+            expect (modified->getBounds().getRight() > outline->getBounds().getRight());
+
+            Path assigned;
+            assigned = copy;
+            expect (assigned.getCachedStroke (stroke) == outline);
+        }
+
+        beginTest ("Cached edge tables match uncached ones");
+        {
+            Path p;
+            p.addStar ({ 40.0f, 40.0f }, 7, 12.0f, 35.0f, 0.3f);
+            p.addEllipse (10.3f, 60.7f, 50.0f, 25.0f);
+            p.setUsingNonZeroWinding (false);
+
+            const Rectangle<int> clip (0, 0, 200, 120);
+
+            for (auto offset : { Point<float> (0.0f, 0.0f), Point<float> (0.0f, 0.0f),
+                                 Point<float> (0.0f, 0.0f), Point<float> (17.0f, 5.0f),
+                                 Point<float> (-3.0f, 11.0f), Point<float> (2.5f, 0.25f) })
+            {
+                const auto transform = AffineTransform::translation (offset);
+                expect (tablesMatch (p.createEdgeTable (clip, transform), EdgeTable (clip, Path (p), transform), clip));
+            }
+
+            auto copy = p;
+            p.applyTransform (AffineTransform::scale (1.5f));
+            expect (tablesMatch (p.createEdgeTable (clip, {}), EdgeTable (clip, copy, AffineTransform::scale (1.5f)), clip));
+            expect (tablesMatch (p.createEdgeTable (clip, {}), EdgeTable (clip, copy, AffineTransform::scale (1.5f)), clip));
+        }
+    }
+
+    static Point<float> randomPoint (Random& random, float size)
+    {
+        return { random.nextFloat() * size, random.nextFloat() * size };
+    }
+
+    template <typename CurveFunction>
+    static float getMaximumDeviation (const Path& path, CurveFunction&& curve)
+    {
+        Array<Line<float>> lines;
+
+        for (PathFlatteningIterator it (path); it.next();)
+            lines.add ({ it.x1, it.y1, it.x2, it.y2 });
+
+        float maxDeviation = 0.0f;
+
+        for (int i = 0; i <= 200; ++i)
+        {
+            const auto point = curve ((float) i / 200.0f);
+            auto nearest = std::numeric_limits<float>::max();
+
+            for (auto& line : lines)
+            {
+                Point<float> pointOnLine;
+                nearest = jmin (nearest, line.getDistanceFromPoint (point, pointOnLine));
+            }
+
+            maxDeviation = jmax (maxDeviation, nearest);
+        }
+
+        return maxDeviation;
+    }
+
+    static bool tablesMatch (EdgeTable a, EdgeTable b, Rectangle<int> clip)
+    {
+        a.clipToRectangle (clip);
+        b.clipToRectangle (clip);
+
+        auto render = [&] (const EdgeTable& table)
+        {
+            Image image (Image::SingleChannel, clip.getWidth(), clip.getHeight(), true);
+            const Image::BitmapData data (image, Image::BitmapData::writeOnly);
+            MaskRenderer renderer { data };
+            table.iterate (renderer);
+            return image;
+        };
+
+        auto imageA = render (a), imageB = render (b);
+
+        for (int y = 0; y < clip.getHeight(); ++y)
+            for (int x = 0; x < clip.getWidth(); ++x)
+                if (imageA.getPixelAt (x, y) != imageB.getPixelAt (x, y))
+                    return false;
+
+        return true;
+    }
+
+    struct MaskRenderer
+    {
+        const Image::BitmapData& data;
+        uint8* line = nullptr;
+
+        void setEdgeTableYPos (int y) noexcept                                  { line = data.getLinePointer (y); }
+        void handleEdgeTablePixel (int x, int alpha) noexcept                   { line[x] = (uint8) alpha; }
+        void handleEdgeTablePixelFull (int x) noexcept                          { line[x] = 255; }
+        void handleEdgeTableLine (int x, int width, int alpha) noexcept         { std::fill (line + x, line + x + width, (uint8) alpha); }
+        void handleEdgeTableLineFull (int x, int width) noexcept                { std::fill (line + x, line + x + width, (uint8) 255); }
+    };
+};
+
+static PathTests pathTests;
+
+#endif
+
 } // namespace juce
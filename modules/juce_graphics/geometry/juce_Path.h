@@ -798,12 +798,40 @@ public:
     */
     void restoreFromString (StringRef stringVersion);
 
+    //==============================================================================
+    /** Returns the outline that PathStrokeType::createStrokedPath() would create for
+        this path.
+
+        Once a path has been stroked the same way twice, the outline is kept with the path
+        and returned again for as long as the path isn't modified and is stroked in the same
+        way, so a path which is stroked every time a component is painted only needs to be
+        flattened and stroked when it changes. This is what Graphics::strokePath() uses.
+
+        Copies of a path share the cached outline and edge table until either of them is
+        modified, and it's safe for several threads to call this (or createEdgeTable()) on
+        the same path, or on copies of it, at once.
+    */
+    std::shared_ptr<const Path> getCachedStroke (const PathStrokeType& strokeType,
+                                                 const AffineTransform& transform = {},
+                                                 float extraAccuracy = 1.0f) const;
+
+    /** Creates an EdgeTable which rasterises this path, as the EdgeTable constructor would.
+
+        When a path is rasterised more than once with the same transform (or with transforms
+        that only differ by a whole number of pixels), the table is kept with the path and
+        copied for subsequent calls until the path is modified. The table that's returned
+        may then extend beyond the clip limits, which should be applied by the caller.
+    */
+    EdgeTable createEdgeTable (Rectangle<int> clipLimits, const AffineTransform& transform) const;
+
 private:
     //==============================================================================
     friend class PathFlatteningIterator;
     friend class Path::Iterator;
     friend class EdgeTable;
 
+    struct CachedGeometry;
+
     Array<float> data;
 
     struct PathBounds
@@ -827,6 +855,12 @@ private:
     PathBounds bounds;
     bool useNonZeroWinding = true;
 
+    mutable std::shared_ptr<CachedGeometry> cachedGeometry;
+    mutable SpinLock cachedGeometryLock;
+
+    void invalidateCachedGeometry() noexcept;
+    std::shared_ptr<CachedGeometry> getCachedGeometry (bool createIfNeeded) const;
+
     static constexpr float lineMarker           = 100001.0f;
     static constexpr float moveMarker           = 100002.0f;
     static constexpr float quadMarker           = 100003.0f;
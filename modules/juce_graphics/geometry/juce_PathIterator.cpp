@@ -33,7 +33,7 @@ namespace juce
 //==============================================================================
 PathFlatteningIterator::PathFlatteningIterator (const Path& pathToUse,
                                                 const AffineTransform& t,
-                                                float tolerance)
+                                                float toleranceToUse)
     : x2 (0),
       y2 (0),
       closesSubPath (false),
@@ -41,10 +41,9 @@ PathFlatteningIterator::PathFlatteningIterator (const Path& pathToUse,
       path (pathToUse),
       transform (t),
       source (path.data.begin()),
-      toleranceSquared (tolerance * tolerance),
+      tolerance (toleranceToUse),
       isIdentityTransform (t.isIdentity())
 {
-    stackPos = stackBase;
 }
 
 PathFlatteningIterator::~PathFlatteningIterator()
@@ -53,218 +52,72 @@ PathFlatteningIterator::~PathFlatteningIterator()
 
 bool PathFlatteningIterator::isLastInSubpath() const noexcept
 {
-    return stackPos == stackBase.get()
+    return curveSegment == numCurveSegments
              && (source == path.data.end() || isMarker (*source, Path::moveMarker));
 }
 
+void PathFlatteningIterator::startCurve (Point<float> a, Point<float> b, Point<float> c, Point<float> end,
+                                         float secondDifference, float degreeFactor)
+{
+    // Wang's formula gives the number of equal parameter steps needed to keep a curve within
+    // a given distance of its chords, so the lines can be evaluated directly rather than
+    // found by repeated subdivision. The curves are kept within a quarter of the tolerance,
+    // which is about as close as the subdivision used to get them.
+    constexpr int maxSegments = 4096;
+    const auto numSegments = std::ceil (std::sqrt (degreeFactor * 4.0f * secondDifference / tolerance));
+
+    curveA = a;
+    curveB = b;
+    curveC = c;
+    curveStart = { x1, y1 };
+    curveEnd = end;
+    curveSegment = 0;
+    numCurveSegments = numSegments < (float) maxSegments ? jmax (1, (int) numSegments) : maxSegments;
+}
+
+bool PathFlatteningIterator::finishLine() noexcept
+{
+    ++subPathIndex;
+
+    closesSubPath = curveSegment == numCurveSegments
+                     && source != path.data.end()
+                     && isMarker (*source, Path::closeSubPathMarker)
+                     && approximatelyEqual (x2, subPathCloseX)
+                     && approximatelyEqual (y2, subPathCloseY);
+
+    return true;
+}
+
 bool PathFlatteningIterator::next()
 {
     x1 = x2;
     y1 = y2;
 
-    float x3 = 0;
-    float y3 = 0;
-    float x4 = 0;
-    float y4 = 0;
-
     for (;;)
     {
-        float type;
-
-        if (stackPos == stackBase.get())
+        if (curveSegment < numCurveSegments)
         {
-            if (source == path.data.end())
-                return false;
-
-            type = *source++;
-
-            if (! isMarker (type, Path::closeSubPathMarker))
-            {
-                x2 = *source++;
-                y2 = *source++;
-
-                if (isMarker (type, Path::quadMarker))
-                {
-                    x3 = *source++;
-                    y3 = *source++;
-
-                    if (! isIdentityTransform)
-                        transform.transformPoints (x2, y2, x3, y3);
-                }
-                else if (isMarker (type, Path::cubicMarker))
-                {
-                    x3 = *source++;
-                    y3 = *source++;
-                    x4 = *source++;
-                    y4 = *source++;
-
-                    if (! isIdentityTransform)
-                        transform.transformPoints (x2, y2, x3, y3, x4, y4);
-                }
-                else
-                {
-                    if (! isIdentityTransform)
-                        transform.transformPoint (x2, y2);
-                }
-            }
-        }
-        else
-        {
-            type = *--stackPos;
-
-            if (! isMarker (type, Path::closeSubPathMarker))
-            {
-                x2 = *--stackPos;
-                y2 = *--stackPos;
-
-                if (isMarker (type, Path::quadMarker))
-                {
-                    x3 = *--stackPos;
-                    y3 = *--stackPos;
-                }
-                else if (isMarker (type, Path::cubicMarker))
-                {
-                    x3 = *--stackPos;
-                    y3 = *--stackPos;
-                    x4 = *--stackPos;
-                    y4 = *--stackPos;
-                }
-            }
-        }
-
-        if (isMarker (type, Path::lineMarker))
-        {
-            ++subPathIndex;
-
-            closesSubPath = stackPos == stackBase.get()
-                             && source != path.data.end()
-                             && isMarker (*source, Path::closeSubPathMarker)
-                             && approximatelyEqual (x2, subPathCloseX)
-                             && approximatelyEqual (y2, subPathCloseY);
-
-            return true;
-        }
-
-        if (isMarker (type, Path::quadMarker))
-        {
-            const size_t offset = (size_t) (stackPos - stackBase);
-
-            if (offset >= stackSize - 10)
-            {
-                stackSize <<= 1;
-                stackBase.realloc (stackSize);
-                stackPos = stackBase + offset;
-            }
-
-            auto m1x = (x1 + x2) * 0.5f;
-            auto m1y = (y1 + y2) * 0.5f;
-            auto m2x = (x2 + x3) * 0.5f;
-            auto m2y = (y2 + y3) * 0.5f;
-            auto m3x = (m1x + m2x) * 0.5f;
-            auto m3y = (m1y + m2y) * 0.5f;
-
-            auto errorX = m3x - x2;
-            auto errorY = m3y - y2;
-
-            auto outsideTolerance = errorX * errorX + errorY * errorY > toleranceSquared;
-            auto canBeSubdivided = (! approximatelyEqual (m3x, m1x) && ! approximatelyEqual (m3x, m2x))
-                                || (! approximatelyEqual (m3y, m1y) && ! approximatelyEqual (m3y, m2y));
-
-            if (outsideTolerance && canBeSubdivided)
+            if (++curveSegment == numCurveSegments)
             {
-                *stackPos++ = y3;
-                *stackPos++ = x3;
-                *stackPos++ = m2y;
-                *stackPos++ = m2x;
-                *stackPos++ = Path::quadMarker;
-
-                *stackPos++ = m3y;
-                *stackPos++ = m3x;
-                *stackPos++ = m1y;
-                *stackPos++ = m1x;
-                *stackPos++ = Path::quadMarker;
+                x2 = curveEnd.x;
+                y2 = curveEnd.y;
             }
             else
             {
-                *stackPos++ = y3;
-                *stackPos++ = x3;
-                *stackPos++ = Path::lineMarker;
-
-                *stackPos++ = m3y;
-                *stackPos++ = m3x;
-                *stackPos++ = Path::lineMarker;
+                auto t = (float) curveSegment / (float) numCurveSegments;
+                x2 = ((curveA.x * t + curveB.x) * t + curveC.x) * t + curveStart.x;
+                y2 = ((curveA.y * t + curveB.y) * t + curveC.y) * t + curveStart.y;
             }
 
-            jassert (stackPos < stackBase + stackSize);
+            return finishLine();
         }
-        else if (isMarker (type, Path::cubicMarker))
-        {
-            const size_t offset = (size_t) (stackPos - stackBase);
 
-            if (offset >= stackSize - 16)
-            {
-                stackSize <<= 1;
-                stackBase.realloc (stackSize);
-                stackPos = stackBase + offset;
-            }
-
-            auto m1x = (x1 + x2) * 0.5f;
-            auto m1y = (y1 + y2) * 0.5f;
-            auto m2x = (x3 + x2) * 0.5f;
-            auto m2y = (y3 + y2) * 0.5f;
-            auto m3x = (x3 + x4) * 0.5f;
-            auto m3y = (y3 + y4) * 0.5f;
-            auto m4x = (m1x + m2x) * 0.5f;
-            auto m4y = (m1y + m2y) * 0.5f;
-            auto m5x = (m3x + m2x) * 0.5f;
-            auto m5y = (m3y + m2y) * 0.5f;
-
-            auto error1X = m4x - x2;
-            auto error1Y = m4y - y2;
-            auto error2X = m5x - x3;
-            auto error2Y = m5y - y3;
-
-            auto outsideTolerance = error1X * error1X + error1Y * error1Y > toleranceSquared
-                                 || error2X * error2X + error2Y * error2Y > toleranceSquared;
-            auto canBeSubdivided = (! approximatelyEqual (m4x, m1x) && ! approximatelyEqual (m4x, m2x))
-                                || (! approximatelyEqual (m4y, m1y) && ! approximatelyEqual (m4y, m2y))
-                                || (! approximatelyEqual (m5x, m3x) && ! approximatelyEqual (m5x, m2x))
-                                || (! approximatelyEqual (m5y, m3y) && ! approximatelyEqual (m5y, m2y));
-
-            if (outsideTolerance && canBeSubdivided)
-            {
-                *stackPos++ = y4;
-                *stackPos++ = x4;
-                *stackPos++ = m3y;
-                *stackPos++ = m3x;
-                *stackPos++ = m5y;
-                *stackPos++ = m5x;
-                *stackPos++ = Path::cubicMarker;
-
-                *stackPos++ = (m4y + m5y) * 0.5f;
-                *stackPos++ = (m4x + m5x) * 0.5f;
-                *stackPos++ = m4y;
-                *stackPos++ = m4x;
-                *stackPos++ = m1y;
-                *stackPos++ = m1x;
-                *stackPos++ = Path::cubicMarker;
-            }
-            else
-            {
-                *stackPos++ = y4;
-                *stackPos++ = x4;
-                *stackPos++ = Path::lineMarker;
+        if (source == path.data.end())
+            return false;
 
-                *stackPos++ = m5y;
-                *stackPos++ = m5x;
-                *stackPos++ = Path::lineMarker;
+        const auto type = *source++;
 
-                *stackPos++ = m4y;
-                *stackPos++ = m4x;
-                *stackPos++ = Path::lineMarker;
-            }
-        }
-        else if (isMarker (type, Path::closeSubPathMarker))
+        if (isMarker (type, Path::closeSubPathMarker))
         {
             if (! approximatelyEqual (x2, subPathCloseX) || ! approximatelyEqual (y2, subPathCloseY))
             {
@@ -276,9 +129,55 @@ bool PathFlatteningIterator::next()
 
                 return true;
             }
+
+            continue;
+        }
+
+        x2 = *source++;
+        y2 = *source++;
+
+        if (isMarker (type, Path::quadMarker))
+        {
+            auto x3 = *source++;
+            auto y3 = *source++;
+
+            if (! isIdentityTransform)
+                transform.transformPoints (x2, y2, x3, y3);
+
+            const Point<float> p0 (x1, y1), p1 (x2, y2), p2 (x3, y3);
+            const auto b = p0 - p1 * 2.0f + p2;
+
+            startCurve ({}, b, (p1 - p0) * 2.0f, p2, b.getDistanceFromOrigin(), 0.25f);
+            x2 = x1;
+            y2 = y1;
+        }
+        else if (isMarker (type, Path::cubicMarker))
+        {
+            auto x3 = *source++;
+            auto y3 = *source++;
+            auto x4 = *source++;
+            auto y4 = *source++;
+
+            if (! isIdentityTransform)
+                transform.transformPoints (x2, y2, x3, y3, x4, y4);
+
+            const Point<float> p0 (x1, y1), p1 (x2, y2), p2 (x3, y3), p3 (x4, y4);
+            const auto d1 = p0 - p1 * 2.0f + p2;
+            const auto d2 = p1 - p2 * 2.0f + p3;
+
+            startCurve (d2 - d1, d1 * 3.0f, (p1 - p0) * 3.0f, p3,
+                        jmax (d1.getDistanceFromOrigin(), d2.getDistanceFromOrigin()), 0.75f);
+            x2 = x1;
+            y2 = y1;
         }
         else
         {
+            if (! isIdentityTransform)
+                transform.transformPoint (x2, y2);
+
+            if (isMarker (type, Path::lineMarker))
+                return finishLine();
+
             jassert (isMarker (type, Path::moveMarker));
 
             subPathIndex = -1;
@@ -97,13 +97,17 @@ private:
     const Path& path;
     const AffineTransform transform;
     const float* source;
-    const float toleranceSquared;
+    const float tolerance;
     float subPathCloseX = 0, subPathCloseY = 0;
     const bool isIdentityTransform;
 
-    HeapBlock<float> stackBase { 32 };
-    float* stackPos;
-    size_t stackSize = 32;
+    // The curve that's currently being split into lines, as the coefficients of its
+    // polynomial, i.e. point (t) = ((a * t + b) * t + c) * t + start
+    Point<float> curveA, curveB, curveC, curveStart, curveEnd;
+    int curveSegment = 0, numCurveSegments = 0;
+
+    void startCurve (Point<float> a, Point<float> b, Point<float> c, Point<float> end, float secondDifference, float degreeFactor);
+    bool finishLine() noexcept;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PathFlatteningIterator)
 };
@@ -617,6 +617,112 @@ public:
         }
     }
 
+    /** Simplifies the list by merging rectangles together, accepting some extra area.
+
+        After calling consolidate() on the list, this repeatedly replaces the pair of rectangles whose
+        bounding box adds the least uncovered area with that bounding box. It stops once the
+        list has no more than maxNumRectangles entries and the next merge would add more
+        than maxExtraAreaPerMerge to the total area.
+
+        The resulting region always contains the original one, and its rectangles still
+        don't overlap. This is useful for something like a repaint region, where painting a
+        few extra pixels is usually much cheaper than handling many small rectangles.
+    */
+    void coalesce (int maxNumRectangles, ValueType maxExtraAreaPerMerge)
+    {
+        maxNumRectangles = jmax (1, maxNumRectangles);
+
+        const auto areaOf = [] (RectangleType r) { return (double) r.getWidth() * (double) r.getHeight(); };
+
+        // Replaces the rectangle at the end of the list with its union with any others that
+        // it overlaps, until none of them overlap again.
+        const auto absorbOverlaps = [this]
+        {
+            auto merged = rects.getLast();
+            rects.removeLast();
+
+            for (int i = rects.size(); --i >= 0;)
+            {
+                if (merged.intersects (rects.getReference (i)))
+                {
+                    merged = merged.getUnion (rects.getReference (i));
+                    rects.remove (i);
+                    i = rects.size();
+                }
+            }
+
+            rects.add (merged);
+        };
+
+        constexpr int maxNumForPairwiseSearch = 64;
+
+        if (rects.size() > maxNumForPairwiseSearch)
+        {
+            // Consolidating or comparing every pair would be too slow, so start by merging
+            // everything that falls into each cell of a coarse grid.
+            constexpr int gridSize = 8;
+            const auto bounds = getBounds();
+            const auto cellW = jmax ((double) bounds.getWidth() / gridSize, 1.0);
+            const auto cellH = jmax ((double) bounds.getHeight() / gridSize, 1.0);
+
+            RectangleType cells[gridSize * gridSize];
+            bool used[gridSize * gridSize] = {};
+
+            for (auto& r : rects)
+            {
+                auto centre = r.getCentre();
+                auto cx = jlimit (0, gridSize - 1, (int) ((double) (centre.x - bounds.getX()) / cellW));
+                auto cy = jlimit (0, gridSize - 1, (int) ((double) (centre.y - bounds.getY()) / cellH));
+                auto index = cy * gridSize + cx;
+
+                cells[index] = used[index] ? cells[index].getUnion (r) : r;
+                used[index] = true;
+            }
+
+            rects.clearQuick();
+
+            for (int i = 0; i < gridSize * gridSize; ++i)
+                if (used[i])
+                    add (cells[i]);
+        }
+
+        if (rects.size() <= maxNumForPairwiseSearch)
+            consolidate();
+
+        while (rects.size() > 1)
+        {
+            int bestA = 0, bestB = 1;
+            auto bestExtraArea = std::numeric_limits<double>::max();
+
+            for (int a = 0; a < rects.size() - 1; ++a)
+            {
+                auto& ra = rects.getReference (a);
+
+                for (int b = a + 1; b < rects.size(); ++b)
+                {
+                    auto& rb = rects.getReference (b);
+                    auto extraArea = areaOf (ra.getUnion (rb)) - areaOf (ra) - areaOf (rb);
+
+                    if (extraArea < bestExtraArea)
+                    {
+                        bestExtraArea = extraArea;
+                        bestA = a;
+                        bestB = b;
+                    }
+                }
+            }
+
+            if (rects.size() <= maxNumRectangles && bestExtraArea > (double) maxExtraAreaPerMerge)
+                break;
+
+            auto merged = rects.getReference (bestA).getUnion (rects.getReference (bestB));
+            rects.remove (bestB);
+            rects.remove (bestA);
+            rects.add (merged);
+            absorbOverlaps();
+        }
+    }
+
     /** Adds an x and y value to all the coordinates. */
     void offsetAll (Point<ValueType> offset) noexcept
     {
@@ -43,6 +43,51 @@ struct RectangleUnitTest final : public UnitTest
             const Rectangle<int> c (1, 2, 3, 4);
             expect (Rectangle<int>::fromString (c.toString()) == c);
         }
+
+        beginTest ("RectangleList coalescing");
+        {
+            const auto isDisjointCover = [] (const RectangleList<int>& list, const RectangleList<int>& original)
+            {
+                for (int i = 0; i < list.getNumRectangles(); ++i)
+                    for (int j = i + 1; j < list.getNumRectangles(); ++j)
+                        if (list.getRectangle (i).intersects (list.getRectangle (j)))
+                            return false;
+
+                for (auto& r : original)
+                    if (! list.containsRectangle (r))
+                        return false;
+
+                return true;
+            };
+
+            RectangleList<int> nearAndFar;
+            nearAndFar.add ({ 0, 0, 10, 10 });
+            nearAndFar.add ({ 12, 0, 10, 10 });
+            nearAndFar.add ({ 500, 500, 10, 10 });
+
+            auto merged = nearAndFar;
+            merged.coalesce (8, 100);
+            expectEquals (merged.getNumRectangles(), 2);
+            expect (merged.getRectangle (0) == Rectangle<int> (500, 500, 10, 10)
+                     || merged.getRectangle (1) == Rectangle<int> (500, 500, 10, 10));
+            expect (isDisjointCover (merged, nearAndFar));
+
+            auto limited = nearAndFar;
+            limited.coalesce (1, 0);
+            expectEquals (limited.getNumRectangles(), 1);
+            expect (limited.getRectangle (0) == nearAndFar.getBounds());
+
+            RectangleList<int> scattered;
+            auto rng = getRandom();
+
+            for (int i = 0; i < 500; ++i)
+                scattered.add ({ rng.nextInt (2000), rng.nextInt (2000), 1 + rng.nextInt (40), 1 + rng.nextInt (40) });
+
+            auto coalesced = scattered;
+            coalesced.coalesce (16, 0);
+            expect (coalesced.getNumRectangles() <= 16);
+            expect (isDisjointCover (coalesced, scattered));
+        }
     }
 };
 
@@ -250,9 +250,14 @@ bool JPEGImageFormat::canUnderstand (InputStream& in)
 #endif
 
 Image JPEGImageFormat::decodeImage (InputStream& in)
+{
+    return decodeImageWithOptions (in, {});
+}
+
+Image JPEGImageFormat::decodeImageWithOptions (InputStream& in, const DecodeOptions& options)
 {
    #if JUCE_USING_COREIMAGE_LOADER
-    return juce_loadWithCoreImage (in);
+    return ImageFileFormat::decodeImageWithOptions (in, options);
    #else
     using namespace jpeglibNamespace;
     using namespace JPEGHelpers;
@@ -291,6 +296,24 @@ Image JPEGImageFormat::decodeImage (InputStream& in)
 
         if (! hasFailed)
         {
+            if (options.hasMinimumSize())
+            {
+                // Find the smallest scale that the inverse DCT can produce directly which
+                // still gives an image that's at least as big as the caller needs.
+                for (unsigned int denominator = 8; denominator > 1; denominator /= 2)
+                {
+                    auto scaledWidth  = (int) ((jpegDecompStruct.image_width  + denominator - 1) / denominator);
+                    auto scaledHeight = (int) ((jpegDecompStruct.image_height + denominator - 1) / denominator);
+
+                    if (scaledWidth >= options.minimumWidth && scaledHeight >= options.minimumHeight)
+                    {
+                        jpegDecompStruct.scale_num = 1;
+                        jpegDecompStruct.scale_denom = denominator;
+                        break;
+                    }
+                }
+            }
+
             jpeg_calc_output_dimensions (&jpegDecompStruct);
 
             if (! hasFailed)
@@ -307,14 +330,24 @@ Image JPEGImageFormat::decodeImage (InputStream& in)
 
                 if (jpeg_start_decompress (&jpegDecompStruct) && ! hasFailed)
                 {
-                    image = Image (Image::RGB, width, height, false);
+                    image = Image (Image::RGB, width, height, options.progressCallback != nullptr);
                     image.getProperties()->set ("originalImageHadAlpha", false);
                     const bool hasAlphaChan = image.hasAlphaChannel(); // (the native image creator may not give back what we expect)
 
                     const Image::BitmapData destData (image, Image::BitmapData::writeOnly);
+                    const int rowsPerProgressCallback = jlimit (1, 64, height / 16);
+                    bool wasCancelled = false;
 
                     for (int y = 0; y < height; ++y)
                     {
+                        if (options.progressCallback != nullptr
+                             && y > 0 && y % rowsPerProgressCallback == 0
+                             && ! options.progressCallback (image, (float) y / (float) height))
+                        {
+                            wasCancelled = true;
+                            break;
+                        }
+
                         jpeg_read_scanlines (&jpegDecompStruct, buffer, 1);
 
                         if (hasFailed)
@@ -344,10 +377,17 @@ Image JPEGImageFormat::decodeImage (InputStream& in)
                         }
                     }
 
-                    if (! hasFailed)
-                        jpeg_finish_decompress (&jpegDecompStruct);
+                    if (wasCancelled || (options.progressCallback != nullptr && ! options.progressCallback (image, 1.0f)))
+                    {
+                        image = {};
+                    }
+                    else
+                    {
+                        if (! hasFailed)
+                            jpeg_finish_decompress (&jpegDecompStruct);
 
-                    in.setPosition (((char*) jpegDecompStruct.src->next_input_byte) - (char*) mb.getData());
+                        in.setPosition (((char*) jpegDecompStruct.src->next_input_byte) - (char*) mb.getData());
+                    }
                 }
             }
         }
@@ -398,7 +398,7 @@ namespace PNGHelpers
         return false;
     }
 
-    static bool readImageData (png_structp pngReadStruct, png_infop pngInfoStruct, jmp_buf& errorJumpBuf, png_bytepp rows) noexcept
+    static int startReadingImageData (png_structp pngReadStruct, png_infop pngInfoStruct, jmp_buf& errorJumpBuf) noexcept
     {
         if (setjmp (errorJumpBuf) == 0)
         {
@@ -407,34 +407,48 @@ namespace PNGHelpers
 
             png_set_add_alpha (pngReadStruct, 0xff, PNG_FILLER_AFTER);
 
-            png_read_image (pngReadStruct, rows);
-            png_read_end (pngReadStruct, pngInfoStruct);
+            auto numPasses = png_set_interlace_handling (pngReadStruct);
+            png_start_read_image (pngReadStruct);
+            return numPasses;
+        }
+
+        return 0;
+    }
+
+    static bool readRows (png_structp pngReadStruct, jmp_buf& errorJumpBuf, png_bytepp rows, int numRows) noexcept
+    {
+        if (setjmp (errorJumpBuf) == 0)
+        {
+            png_read_rows (pngReadStruct, rows, nullptr, (png_uint_32) numRows);
             return true;
         }
 
         return false;
     }
 
-    JUCE_END_IGNORE_WARNINGS_MSVC
-
-    static Image createImageFromData (bool hasAlphaChan, int width, int height, png_bytepp rows)
+    static bool finishReading (png_structp pngReadStruct, png_infop pngInfoStruct, jmp_buf& errorJumpBuf) noexcept
     {
-        // now convert the data to a juce image format..
-        Image image (hasAlphaChan ? Image::ARGB : Image::RGB, width, height, hasAlphaChan);
+        if (setjmp (errorJumpBuf) == 0)
+        {
+            png_read_end (pngReadStruct, pngInfoStruct);
+            return true;
+        }
 
-        image.getProperties()->set ("originalImageHadAlpha", image.hasAlphaChannel());
-        hasAlphaChan = image.hasAlphaChannel(); // (the native image creator may not give back what we expect)
+        return false;
+    }
 
-        const Image::BitmapData destData (image, Image::BitmapData::writeOnly);
+    JUCE_END_IGNORE_WARNINGS_MSVC
 
-        for (int y = 0; y < (int) height; ++y)
+    static void copyRowsToImage (const Image::BitmapData& destData, bool hasAlphaChan, int startY, int numRows, png_bytepp rows)
+    {
+        for (int y = 0; y < numRows; ++y)
         {
             const uint8* src = rows[y];
-            uint8* dest = destData.getLinePointer (y);
+            uint8* dest = destData.getLinePointer (startY + y);
 
             if (hasAlphaChan)
             {
-                for (int i = (int) width; --i >= 0;)
+                for (int i = destData.width; --i >= 0;)
                 {
                     ((PixelARGB*) dest)->setARGB (src[3], src[0], src[1], src[2]);
                     ((PixelARGB*) dest)->premultiply();
@@ -444,7 +458,7 @@ namespace PNGHelpers
             }
             else
             {
-                for (int i = (int) width; --i >= 0;)
+                for (int i = destData.width; --i >= 0;)
                 {
                     ((PixelRGB*) dest)->setARGB (0, src[0], src[1], src[2]);
                     dest += destData.pixelStride;
@@ -452,11 +466,10 @@ namespace PNGHelpers
                 }
             }
         }
-
-        return image;
     }
 
-    static Image readImage (InputStream& in, png_structp pngReadStruct, png_infop pngInfoStruct)
+    static Image readImage (InputStream& in, png_structp pngReadStruct, png_infop pngInfoStruct,
+                            const ImageFileFormat::DecodeOptions& options)
     {
         jmp_buf errorJumpBuf;
         png_set_error_fn (pngReadStruct, &errorJumpBuf, errorCallback, warningCallback);
@@ -464,37 +477,88 @@ namespace PNGHelpers
         png_uint_32 width = 0, height = 0;
         int bitDepth = 0, colorType = 0, interlaceType = 0;
 
-        if (readHeader (in, pngReadStruct, pngInfoStruct, errorJumpBuf,
-                        width, height, bitDepth, colorType, interlaceType))
+        if (! readHeader (in, pngReadStruct, pngInfoStruct, errorJumpBuf,
+                          width, height, bitDepth, colorType, interlaceType))
+            return {};
+
+        png_bytep trans_alpha = nullptr;
+        png_color_16p trans_color = nullptr;
+        int num_trans = 0;
+        png_get_tRNS (pngReadStruct, pngInfoStruct, &trans_alpha, &num_trans, &trans_color);
+
+        auto numPasses = startReadingImageData (pngReadStruct, pngInfoStruct, errorJumpBuf);
+
+        if (numPasses <= 0)
+            return {};
+
+        // now convert the data to a juce image format..
+        const bool imageHasAlpha = (colorType & PNG_COLOR_MASK_ALPHA) != 0 || num_trans != 0;
+        Image image (imageHasAlpha ? Image::ARGB : Image::RGB, (int) width, (int) height,
+                     imageHasAlpha || options.progressCallback != nullptr);
+
+        image.getProperties()->set ("originalImageHadAlpha", image.hasAlphaChannel());
+        const bool hasAlphaChan = image.hasAlphaChannel(); // (the native image creator may not give back what we expect)
+
+        // An interlaced image is refined in place by each pass, so it needs a buffer for the
+        // whole image. Otherwise, the rows are read and converted a few at a time.
+        const bool isInterlaced = numPasses > 1;
+        const auto numRows = (int) height;
+        const auto rowsPerBatch = isInterlaced ? numRows : jlimit (1, 64, numRows / 16);
+        const size_t lineStride = width * 4;
+
+        HeapBlock<uint8> tempBuffer ((size_t) rowsPerBatch * lineStride, true);
+        HeapBlock<png_bytep> rows (rowsPerBatch);
+
+        for (int y = 0; y < rowsPerBatch; ++y)
+            rows[y] = (png_bytep) (tempBuffer + lineStride * (size_t) y);
+
+        const Image::BitmapData destData (image, Image::BitmapData::writeOnly);
+
+        auto reportProgress = [&] (float proportionComplete)
         {
-            // Load the image into a temp buffer..
-            const size_t lineStride = width * 4;
-            HeapBlock<uint8> tempBuffer (height * lineStride);
-            HeapBlock<png_bytep> rows (height);
-
-            for (size_t y = 0; y < height; ++y)
-                rows[y] = (png_bytep) (tempBuffer + lineStride * y);
-
-            png_bytep trans_alpha = nullptr;
-            png_color_16p trans_color = nullptr;
-            int num_trans = 0;
-            png_get_tRNS (pngReadStruct, pngInfoStruct, &trans_alpha, &num_trans, &trans_color);
-
-            if (readImageData (pngReadStruct, pngInfoStruct, errorJumpBuf, rows))
-                return createImageFromData ((colorType & PNG_COLOR_MASK_ALPHA) != 0 || num_trans != 0,
-                                            (int) width, (int) height, rows);
+            return options.progressCallback == nullptr || options.progressCallback (image, proportionComplete);
+        };
+
+        for (int pass = 0; pass < numPasses; ++pass)
+        {
+            for (int y = 0; y < numRows; y += rowsPerBatch)
+            {
+                auto numInBatch = jmin (rowsPerBatch, numRows - y);
+
+                if (! readRows (pngReadStruct, errorJumpBuf, rows, numInBatch))
+                    return {};
+
+                if (! isInterlaced)
+                {
+                    copyRowsToImage (destData, hasAlphaChan, y, numInBatch, rows);
+
+                    if (! reportProgress ((float) (y + numInBatch) / (float) numRows))
+                        return {};
+                }
+            }
+
+            if (isInterlaced)
+            {
+                copyRowsToImage (destData, hasAlphaChan, 0, numRows, rows);
+
+                if (! reportProgress ((float) (pass + 1) / (float) numPasses))
+                    return {};
+            }
         }
 
-        return Image();
+        if (! finishReading (pngReadStruct, pngInfoStruct, errorJumpBuf))
+            return {};
+
+        return image;
     }
 
-    static Image readImage (InputStream& in)
+    static Image readImage (InputStream& in, const ImageFileFormat::DecodeOptions& options)
     {
         if (png_structp pngReadStruct = png_create_read_struct (PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr))
         {
             if (png_infop pngInfoStruct = png_create_info_struct (pngReadStruct))
             {
-                Image image (readImage (in, pngReadStruct, pngInfoStruct));
+                Image image (readImage (in, pngReadStruct, pngInfoStruct, options));
                 png_destroy_read_struct (&pngReadStruct, &pngInfoStruct, nullptr);
                 return image;
             }
@@ -534,7 +598,16 @@ Image PNGImageFormat::decodeImage (InputStream& in)
    #if JUCE_USING_COREIMAGE_LOADER
     return juce_loadWithCoreImage (in);
    #else
-    return PNGHelpers::readImage (in);
+    return PNGHelpers::readImage (in, {});
+   #endif
+}
+
+Image PNGImageFormat::decodeImageWithOptions (InputStream& in, const DecodeOptions& options)
+{
+   #if JUCE_USING_COREIMAGE_LOADER
+    return ImageFileFormat::decodeImageWithOptions (in, options);
+   #else
+    return PNGHelpers::readImage (in, options);
    #endif
 }
 
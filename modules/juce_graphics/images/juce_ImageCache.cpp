@@ -34,37 +34,68 @@ struct ImageCache::Pimpl     : private Timer,
     ~Pimpl() override
     {
         stopTimer();
+        loaderPool.reset();
         clearSingletonInstance();
     }
 
     JUCE_DECLARE_SINGLETON (ImageCache::Pimpl, false)
 
-    Image getFromHashCode (const int64 hashCode) noexcept
+    //==============================================================================
+    // An image is identified by the hash code it was added with, plus the scale factor
+    // (in thousandths) for a scaled copy, or zero for the image as it was added.
+    struct Key
     {
-        const ScopedLock sl (lock);
+        int64 hashCode;
+        int scale = 0;
 
-        for (auto& item : images)
+        bool operator< (const Key& other) const noexcept
         {
-            if (item.hashCode == hashCode)
-            {
-                item.lastUseTime = Time::getApproximateMillisecondCounter();
-                return item.image;
-            }
+            return std::tie (hashCode, scale) < std::tie (other.hashCode, other.scale);
         }
+    };
 
-        return {};
-     }
+    Image getFromHashCode (const int64 hashCode) noexcept
+    {
+        const ScopedLock sl (lock);
+        return findImage ({ hashCode });
+    }
 
     void addImageToCache (const Image& image, const int64 hashCode)
     {
-        if (image.isValid())
-        {
-            if (! isTimerRunning())
-                startTimer (2000);
+        addImage ({ hashCode }, image);
+    }
+
+    Image getScaledImage (const int64 hashCode, float scaleFactor, const std::function<Image()>& getOriginal)
+    {
+        jassert (scaleFactor > 0.0f);
+        const Key key { hashCode, roundToInt (scaleFactor * 1000.0f) };
 
+        if (key.scale <= 0)
+            return {};
+
+        if (key.scale != 1000)
+        {
             const ScopedLock sl (lock);
-            images.add ({ image, hashCode, Time::getApproximateMillisecondCounter() });
+            auto image = findImage (key);
+
+            if (image.isValid())
+                return image;
         }
+
+        auto original = getOriginal();
+
+        if (! original.isValid())
+            return {};
+
+        const auto width  = jmax (1, roundToInt ((float) original.getWidth()  * scaleFactor));
+        const auto height = jmax (1, roundToInt ((float) original.getHeight() * scaleFactor));
+
+        if (width == original.getWidth() && height == original.getHeight())
+            return original;
+
+        auto image = createScaledImage (original, width, height);
+        addImage (key, image);
+        return image;
     }
 
     void timerCallback() override
@@ -73,22 +104,22 @@ struct ImageCache::Pimpl     : private Timer,
 
         const ScopedLock sl (lock);
 
-        for (int i = images.size(); --i >= 0;)
+        for (auto i = items.begin(); i != items.end();)
         {
-            auto& item = images.getReference (i);
+            auto item = i++;
 
-            if (item.image.getReferenceCount() <= 1)
+            if (item->image.getReferenceCount() <= 1)
             {
-                if (now > item.lastUseTime + cacheTimeout || now < item.lastUseTime - 1000)
-                    images.remove (i);
+                if (now > item->lastUseTime + cacheTimeout || now < item->lastUseTime - 1000)
+                    removeItem (item);
             }
             else
             {
-                item.lastUseTime = now; // multiply-referenced, so this image is still in use.
+                item->lastUseTime = now; // multiply-referenced, so this image is still in use.
             }
         }
 
-        if (images.isEmpty())
+        if (items.empty())
             stopTimer();
     }
 
@@ -96,22 +127,254 @@ struct ImageCache::Pimpl     : private Timer,
     {
         const ScopedLock sl (lock);
 
-        for (int i = images.size(); --i >= 0;)
-            if (images.getReference (i).image.getReferenceCount() <= 1)
-                images.remove (i);
+        for (auto i = items.begin(); i != items.end();)
+        {
+            auto item = i++;
+
+            if (item->image.getReferenceCount() <= 1)
+                removeItem (item);
+        }
+    }
+
+    void setMaximumSize (size_t newMaxBytes)
+    {
+        const ScopedLock sl (lock);
+        maxBytes = newMaxBytes;
+        removeLeastRecentlyUsed();
+    }
+
+    Statistics getStatistics()
+    {
+        const ScopedLock sl (lock);
+        auto result = stats;
+        result.numImages = (int) items.size();
+        result.bytesUsed = bytesUsed;
+        return result;
+    }
+
+    void resetStatistics()
+    {
+        const ScopedLock sl (lock);
+        stats = {};
+    }
+
+    //==============================================================================
+    using LoadCallback = std::function<void (const Image&)>;
+
+    // The requests that are waiting for an image to be decoded, keyed by the order in
+    // which they were made. The decoded image is kept here rather than in the message
+    // that delivers it, so it's released as soon as all its requests are cancelled.
+    struct PendingLoad
+    {
+        std::map<int64, LoadCallback> callbacks;
+        Image image;
+        bool isDecoded = false;
+    };
+
+    ErasedScopeGuard loadAsync (int64 hashCode, std::function<Image()> decode, LoadCallback callback)
+    {
+        const ScopedLock sl (lock);
+        const auto requestId = ++lastRequestId;
+        auto& pending = pendingLoads[hashCode];
+        pending.callbacks[requestId] = std::move (callback);
+
+        ErasedScopeGuard cancel { [hashCode, requestId]
+        {
+            if (auto* instance = getInstanceWithoutCreating())
+                instance->cancelLoad (hashCode, requestId);
+        } };
+
+        if (pending.callbacks.size() > 1)
+            return cancel; // this image is already being decoded
+
+        if (loaderPool == nullptr)
+            loaderPool = std::make_unique<ThreadPool> (ThreadPoolOptions{}.withThreadName ("ImageCache loader")
+                                                                          .withNumberOfThreads (jlimit (1, 4, SystemStats::getNumCpus() - 1)));
+
+        loaderPool->addJob ([this, hashCode, decode = std::move (decode)]
+        {
+            {
+                const ScopedLock jobLock (lock);
+
+                if (pendingLoads.find (hashCode) == pendingLoads.end())
+                    return; // every request was cancelled before the decoding started
+            }
+
+            auto image = decode();
+            addImageToCache (image, hashCode);
+
+            const ScopedLock jobLock (lock);
+            auto found = pendingLoads.find (hashCode);
+
+            if (found == pendingLoads.end() || found->second.isDecoded)
+                return;
+
+            found->second.image = image;
+            found->second.isDecoded = true;
+
+            MessageManager::callAsync ([hashCode]
+            {
+                if (auto* instance = getInstanceWithoutCreating())
+                    instance->deliverLoadedImage (hashCode);
+            });
+        });
+
+        return cancel;
+    }
+
+    void cancelLoad (int64 hashCode, int64 requestId)
+    {
+        const ScopedLock sl (lock);
+        auto found = pendingLoads.find (hashCode);
+
+        if (found == pendingLoads.end())
+            return;
+
+        found->second.callbacks.erase (requestId);
+
+        if (found->second.callbacks.empty())
+            pendingLoads.erase (found);
     }
 
+    void deliverLoadedImage (int64 hashCode)
+    {
+        // The callbacks are taken one at a time, so that if one of them cancels another
+        // request for the same image, the cancelled callback won't be called.
+        for (;;)
+        {
+            LoadCallback callback;
+            Image image;
+
+            {
+                const ScopedLock sl (lock);
+                auto found = pendingLoads.find (hashCode);
+
+                if (found == pendingLoads.end() || ! found->second.isDecoded)
+                    return;
+
+                auto& pending = found->second;
+                callback = std::move (pending.callbacks.begin()->second);
+                image = pending.image;
+                pending.callbacks.erase (pending.callbacks.begin());
+
+                if (pending.callbacks.empty())
+                    pendingLoads.erase (found);
+            }
+
+            NullCheckedInvocation::invoke (callback, image);
+        }
+    }
+
+    //==============================================================================
     struct Item
     {
+        Key key;
         Image image;
-        int64 hashCode;
+        size_t sizeInBytes;
         uint32 lastUseTime;
     };
 
-    Array<Item> images;
+    using ItemList = std::list<Item>;
+
+    static size_t getSizeInBytes (const Image& image) noexcept
+    {
+        // (this avoids creating a BitmapData, which could mean copying the pixels from a GPU)
+        const auto bytesPerPixel = image.getFormat() == Image::ARGB ? 4 : (image.getFormat() == Image::RGB ? 3 : 1);
+        return (size_t) image.getWidth() * (size_t) image.getHeight() * (size_t) bytesPerPixel;
+    }
+
+    static Image createScaledImage (Image image, int width, int height)
+    {
+        // Halving the image until it's less than twice the target size means that each step
+        // averages all of its source pixels, so large reductions don't alias the way that a
+        // single resampling step would.
+        while (image.getWidth() >= width * 2 && image.getHeight() >= height * 2)
+            image = image.rescaled (image.getWidth() / 2, image.getHeight() / 2, Graphics::highResamplingQuality);
+
+        return image.rescaled (width, height, Graphics::highResamplingQuality);
+    }
+
+    Image findImage (const Key& key)
+    {
+        auto found = index.find (key);
+
+        if (found == index.end())
+        {
+            ++stats.misses;
+            return {};
+        }
+
+        ++stats.hits;
+        auto item = found->second;
+        item->lastUseTime = Time::getApproximateMillisecondCounter();
+        items.splice (items.begin(), items, item);
+        return item->image;
+    }
+
+    void addImage (const Key& key, const Image& image)
+    {
+        if (! image.isValid())
+            return;
+
+        if (! isTimerRunning())
+            startTimer (2000);
+
+        const ScopedLock sl (lock);
+
+        if (key.scale == 0)
+        {
+            // replacing an image makes any scaled copies of the old one out of date
+            for (auto i = index.lower_bound (key); i != index.end() && i->first.hashCode == key.hashCode;)
+                removeItem ((i++)->second);
+        }
+        else if (auto found = index.find (key); found != index.end())
+        {
+            removeItem (found->second);
+        }
+
+        const auto size = getSizeInBytes (image);
+        items.push_front ({ key, image, size, Time::getApproximateMillisecondCounter() });
+        index[key] = items.begin();
+        bytesUsed += size;
+
+        removeLeastRecentlyUsed();
+    }
+
+    void removeItem (ItemList::iterator item)
+    {
+        bytesUsed -= item->sizeInBytes;
+        index.erase (item->key);
+        items.erase (item);
+    }
+
+    void removeLeastRecentlyUsed()
+    {
+        // Images that are still referenced elsewhere are skipped, as removing them
+        // from the cache wouldn't free any memory.
+        for (auto i = items.end(); bytesUsed > maxBytes && i != items.begin();)
+        {
+            auto item = --i;
+
+            if (item->image.getReferenceCount() <= 1)
+            {
+                i = std::next (item);
+                removeItem (item);
+                ++stats.evictions;
+            }
+        }
+    }
+
+    ItemList items;
+    std::map<Key, ItemList::iterator> index;
+    size_t bytesUsed = 0, maxBytes = 64 * 1024 * 1024;
+    Statistics stats;
     CriticalSection lock;
     unsigned int cacheTimeout = 5000;
 
+    std::map<int64, PendingLoad> pendingLoads;
+    int64 lastRequestId = 0;
+    std::unique_ptr<ThreadPool> loaderPool;
+
     JUCE_DECLARE_NON_COPYABLE (Pimpl)
 };
 
@@ -160,6 +423,71 @@ Image ImageCache::getFromMemory (const void* imageData, const int dataSize)
     return image;
 }
 
+Image ImageCache::getFromFile (const File& file, float scaleFactor)
+{
+    return Pimpl::getInstance()->getScaledImage (file.hashCode64(), scaleFactor,
+                                                 [&] { return getFromFile (file); });
+}
+
+Image ImageCache::getFromMemory (const void* imageData, int dataSize, float scaleFactor)
+{
+    return Pimpl::getInstance()->getScaledImage ((int64) (pointer_sized_int) imageData, scaleFactor,
+                                                 [&] { return getFromMemory (imageData, dataSize); });
+}
+
+Image ImageCache::getFromHashCode (int64 hashCode, float scaleFactor)
+{
+    return Pimpl::getInstance()->getScaledImage (hashCode, scaleFactor,
+                                                 [&] { return getFromHashCode (hashCode); });
+}
+
+//==============================================================================
+static int64 getHashCodeForDecodeOptions (int64 hashCode, const ImageFileFormat::DecodeOptions& options)
+{
+    if (! options.hasMinimumSize())
+        return hashCode;
+
+    // reduced-size images are cached separately from the full-size ones
+    auto h = (uint64) hashCode;
+    h = h * 101 + (uint64) options.minimumWidth;
+    h = h * 101 + (uint64) options.minimumHeight;
+    return (int64) h;
+}
+
+ErasedScopeGuard ImageCache::getFromFileAsync (const File& file, std::function<void (const Image&)> callback,
+                                               const ImageFileFormat::DecodeOptions& options)
+{
+    auto hashCode = getHashCodeForDecodeOptions (file.hashCode64(), options);
+    auto image = getFromHashCode (hashCode);
+
+    if (image.isValid())
+    {
+        NullCheckedInvocation::invoke (callback, image);
+        return {};
+    }
+
+    return Pimpl::getInstance()->loadAsync (hashCode,
+                                     [file, options] { return ImageFileFormat::loadFrom (file, options); },
+                                     std::move (callback));
+}
+
+ErasedScopeGuard ImageCache::getFromMemoryAsync (const void* imageData, const int dataSize, std::function<void (const Image&)> callback,
+                                                 const ImageFileFormat::DecodeOptions& options)
+{
+    auto hashCode = getHashCodeForDecodeOptions ((int64) (pointer_sized_int) imageData, options);
+    auto image = getFromHashCode (hashCode);
+
+    if (image.isValid())
+    {
+        NullCheckedInvocation::invoke (callback, image);
+        return {};
+    }
+
+    return Pimpl::getInstance()->loadAsync (hashCode,
+                                     [imageData, dataSize, options] { return ImageFileFormat::loadFrom (imageData, (size_t) dataSize, options); },
+                                     std::move (callback));
+}
+
 void ImageCache::setCacheTimeout (const int millisecs)
 {
     jassert (millisecs >= 0);
@@ -171,4 +499,222 @@ void ImageCache::releaseUnusedImages()
     Pimpl::getInstance()->releaseUnusedImages();
 }
 
+void ImageCache::setMaximumSize (size_t maxBytes)
+{
+    Pimpl::getInstance()->setMaximumSize (maxBytes);
+}
+
+size_t ImageCache::getMaximumSize()
+{
+    auto* pimpl = Pimpl::getInstance();
+    const ScopedLock sl (pimpl->lock);
+    return pimpl->maxBytes;
+}
+
+ImageCache::Statistics ImageCache::getStatistics()
+{
+    if (auto* pimpl = Pimpl::getInstanceWithoutCreating())
+        return pimpl->getStatistics();
+
+    return {};
+}
+
+void ImageCache::resetStatistics()
+{
+    if (auto* pimpl = Pimpl::getInstanceWithoutCreating())
+        pimpl->resetStatistics();
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ImageCacheTests final : public UnitTest
+{
+public:
+    ImageCacheTests()
+        : UnitTest ("ImageCache", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        Image source (Image::RGB, 256, 128, true);
+        Graphics (source).fillCheckerBoard (source.getBounds().toFloat(), 16.0f, 16.0f, Colours::orange, Colours::navy);
+
+        beginTest ("Scaled copies are created once and cached");
+        {
+            const int64 testHashCode = 0x12345678;
+            ImageCache::addImageToCache (source, testHashCode);
+            ImageCache::resetStatistics();
+
+            auto half = ImageCache::getFromHashCode (testHashCode, 0.5f);
+            expect (half.getBounds() == Rectangle<int> (128, 64));
+            expect (ImageCache::getFromHashCode (testHashCode, 0.5f) == half);
+            expect (ImageCache::getFromHashCode (testHashCode, 1.0f) == source);
+            expectEquals (ImageCache::getStatistics().hits, (int64) 3);
+
+            // a large reduction should average the checkerboard rather than pick out single squares
+            auto tiny = ImageCache::getFromHashCode (testHashCode, 1.0f / 32.0f);
+            expect (tiny.getBounds() == Rectangle<int> (8, 4));
+            const auto average = Colours::orange.interpolatedWith (Colours::navy, 0.5f);
+            expect (std::abs (tiny.getPixelAt (3, 2).getRed() - average.getRed()) < 16);
+
+            // replacing the original discards its scaled copies
+            ImageCache::addImageToCache (Image (Image::RGB, 50, 20, true), testHashCode);
+            expect (ImageCache::getFromHashCode (testHashCode, 0.5f).getBounds() == Rectangle<int> (25, 10));
+
+            expect (! ImageCache::getFromHashCode (testHashCode + 1, 0.5f).isValid());
+        }
+
+        ImageCache::releaseUnusedImages();
+
+        beginTest ("The least recently used images are released when the cache is full");
+        {
+            // (any images that are still in use elsewhere can't be released)
+            const auto initialStats = ImageCache::getStatistics();
+            const auto oldMaxSize = ImageCache::getMaximumSize();
+            const size_t imageSize = 100 * 100 * 4;
+            const auto maxSize = initialStats.bytesUsed + imageSize * 3;
+            ImageCache::setMaximumSize (maxSize);
+            ImageCache::resetStatistics();
+
+            Image stillInUse (Image::ARGB, 100, 100, true);
+            ImageCache::addImageToCache (stillInUse, 1);
+
+            for (int64 i = 2; i <= 6; ++i)
+            {
+                ImageCache::addImageToCache (Image (Image::ARGB, 100, 100, true), i);
+                expect (ImageCache::getStatistics().bytesUsed <= maxSize);
+            }
+
+            expect (ImageCache::getFromHashCode (1) == stillInUse);
+            expect (! ImageCache::getFromHashCode (2).isValid());
+            expect (! ImageCache::getFromHashCode (4).isValid());
+            expect (ImageCache::getFromHashCode (5).isValid());
+            expect (ImageCache::getFromHashCode (6).isValid());
+            expectEquals (ImageCache::getStatistics().evictions, (int64) 3);
+            expectEquals (ImageCache::getStatistics().numImages, initialStats.numImages + 3);
+
+            ImageCache::setMaximumSize (oldMaxSize);
+        }
+
+        ImageCache::releaseUnusedImages();
+
+        // (the async tests come last, as the loader threads may still be holding the images afterwards)
+        beginTest ("Images can be loaded asynchronously");
+        {
+            // Each file has a unique name, so its hash code can't be in the cache already
+            const TemporaryFile file (".jpg");
+            writeImage (file.getFile(), Random::getSystemRandom().nextInt());
+            const auto hashCode = file.getFile().hashCode64();
+
+            expect (! ImageCache::getFromHashCode (hashCode).isValid());
+
+            ImageCache::getFromFileAsync (file.getFile(), nullptr).release();
+
+            auto image = waitForImage (hashCode);
+            expect (image.getBounds() == source.getBounds());
+
+            Image result;
+            auto guard = ImageCache::getFromFileAsync (file.getFile(), [&] (const Image& i) { result = i; });
+            expect (result == image);
+
+            beginTest ("Reduced-size images are cached separately");
+
+            ImageFileFormat::DecodeOptions options;
+            options.minimumWidth = 64;
+
+            ImageCache::getFromFileAsync (file.getFile(), nullptr, options).release();
+
+            auto thumbnail = waitForImage (getHashCodeForDecodeOptions (hashCode, options));
+            expect (thumbnail.getBounds() == Rectangle<int> (64, 32));
+            expect (ImageCache::getFromHashCode (hashCode).getBounds() == source.getBounds());
+        }
+
+       #if JUCE_MODAL_LOOPS_PERMITTED
+        if (MessageManager::getInstance()->isThisTheMessageThread())
+        {
+            beginTest ("Pending loads can be cancelled");
+
+            // Keep the loader threads busy, so that the requests below are all still
+            // waiting to be decoded when they're cancelled
+            WaitableEvent releaseLoaders (true);
+            OwnedArray<TemporaryFile> files;
+
+            for (int i = 0; i < 6; ++i)
+                writeImage (files.add (new TemporaryFile (".jpg"))->getFile(), i);
+
+            std::vector<ErasedScopeGuard> blockers;
+
+            for (int i = 0; i < 4; ++i)
+            {
+                ImageFileFormat::DecodeOptions options;
+                options.progressCallback = [&] (const Image&, float) { releaseLoaders.wait(); return true; };
+                blockers.push_back (ImageCache::getFromFileAsync (files[i]->getFile(), nullptr, options));
+            }
+
+            // A cancelled request isn't called back, and the image isn't decoded if nothing
+            // else is waiting for it
+            std::atomic<bool> cancelledImageWasDecoded { false };
+            ImageFileFormat::DecodeOptions cancelledOptions;
+            cancelledOptions.progressCallback = [&] (const Image&, float) { cancelledImageWasDecoded = true; return true; };
+
+            bool cancelledCallbackWasCalled = false;
+            ImageCache::getFromFileAsync (files[4]->getFile(), [&] (const Image&) { cancelledCallbackWasCalled = true; },
+                                          cancelledOptions).reset();
+
+            // Other requests for the same image are still called back after one of them is cancelled
+            Image result, cancelledResult;
+            auto kept = ImageCache::getFromFileAsync (files[5]->getFile(), [&] (const Image& i) { result = i; });
+            ImageCache::getFromFileAsync (files[5]->getFile(), [&] (const Image& i) { cancelledResult = i; }).reset();
+
+            releaseLoaders.signal();
+
+            for (int i = 0; i < 500 && ! result.isValid(); ++i)
+                MessageManager::getInstance()->runDispatchLoopUntil (10);
+
+            // (the loaders are still using the event until their images have been decoded)
+            for (int i = 0; i < 4; ++i)
+                expect (waitForImage (files[i]->getFile().hashCode64()).isValid());
+
+            expect (result.isValid());
+            expect (! cancelledResult.isValid());
+            expect (! cancelledCallbackWasCalled);
+            expect (! cancelledImageWasDecoded);
+            expect (! ImageCache::getFromHashCode (files[4]->getFile().hashCode64()).isValid());
+        }
+       #endif
+    }
+
+    void writeImage (const File& file, int seed)
+    {
+        Image image (Image::RGB, 256, 128, true);
+        Random random (seed);
+        Graphics (image).fillCheckerBoard (image.getBounds().toFloat(), 16.0f, 16.0f,
+                                           Colour ((uint32) random.nextInt()).withAlpha (1.0f), Colours::navy);
+
+        FileOutputStream out (file);
+        expect (out.openedOk() && JPEGImageFormat().writeImageToStream (image, out));
+    }
+
+    static Image waitForImage (int64 hashCode)
+    {
+        for (int i = 0; i < 500; ++i)
+        {
+            auto image = ImageCache::getFromHashCode (hashCode);
+
+            if (image.isValid())
+                return image;
+
+            Thread::sleep (10);
+        }
+
+        return {};
+    }
+};
+
+static ImageCacheTests imageCacheTests;
+
+#endif
+
 } // namespace juce
@@ -39,6 +39,12 @@ namespace juce
     loading/deleting the same image, it'll reduce the chances of having to reload it
     each time.
 
+    The cache can also hold scaled copies of its images, so that an image which is
+    drawn at a different size (e.g. on a high-DPI display) doesn't need to be resampled
+    every time it's painted. The total size of the cache is limited by setMaximumSize(),
+    and when it's exceeded, the least recently used images that aren't being referenced
+    anywhere else are discarded.
+
     @see Image, ImageFileFormat
 
     @tags{Graphics}
@@ -80,6 +86,83 @@ public:
     */
     static Image getFromMemory (const void* imageData, int dataSize);
 
+    //==============================================================================
+    /** Returns a copy of an image file that has been scaled by the given factor, (or
+        just returns the scaled image if it's already cached).
+
+        The original image is loaded in the same way as getFromFile(), and the scaled
+        copy is kept in the cache alongside it, so that it's only resampled once for
+        each scale factor. Large reductions are done in steps of one half, like a
+        mip-map, which gives a smoother result than resampling in a single step.
+
+        @param file         the file to try to load
+        @param scaleFactor  the amount by which to scale the image, which must be greater than 0
+        @returns            the scaled image, or an invalid image if the file couldn't be loaded
+        @see getFromFile
+    */
+    static Image getFromFile (const File& file, float scaleFactor);
+
+    /** Returns a copy of an in-memory image file that has been scaled by the given
+        factor, (or just returns the scaled image if it's already cached).
+
+        @see getFromMemory, getFromFile (const File&, float)
+    */
+    static Image getFromMemory (const void* imageData, int dataSize, float scaleFactor);
+
+    /** Returns a copy of the image with a particular hashcode, scaled by the given factor.
+
+        This will return an invalid image if the original isn't in the cache.
+
+        @see getFromHashCode, getFromFile (const File&, float)
+    */
+    static Image getFromHashCode (int64 hashCode, float scaleFactor);
+
+    //==============================================================================
+    /** Loads an image from a file on a background thread, (or just returns the image
+        if it's already cached).
+
+        The file is decoded by a pool of worker threads, and the decoded image is added
+        to the cache before the callback is called on the message thread. If the image
+        is already in the cache, the callback is called before this method returns. If
+        the same image is requested again while it's still being decoded, both callbacks
+        will receive the same image.
+
+        If the options include a minimum size, the decoder may produce a smaller image
+        (see ImageFileFormat::DecodeOptions), which is cached separately from the
+        full-size one. Any progress callback in the options will be called on the
+        worker thread.
+
+        The request is cancelled when the returned guard is destroyed or reset, after
+        which the callback won't be called. If that leaves nothing waiting for the image
+        and it hasn't started decoding yet, the decoding is skipped as well. So, for
+        example, a component can keep the guard as a member to make sure that it isn't
+        called back after it has been deleted. If you don't need to cancel the request,
+        call release() on the guard.
+
+        @param file         the file to try to load
+        @param callback     called on the message thread with the image, or with an
+                            invalid image if it couldn't be loaded
+        @param options      options for the decoder
+        @returns            a guard which cancels the request when it's destroyed
+        @see getFromFile, getFromMemoryAsync
+    */
+    static ErasedScopeGuard getFromFileAsync (const File& file,
+                                              std::function<void (const Image&)> callback,
+                                              const ImageFileFormat::DecodeOptions& options = {});
+
+    /** Loads an image from an in-memory image file on a background thread, (or just
+        returns the image if it's already cached).
+
+        This works in the same way as getFromFileAsync(). The memory must remain valid
+        until the callback has been called, so this is mainly intended for data that
+        is embedded in the binary.
+
+        @see getFromMemory, getFromFileAsync
+    */
+    static ErasedScopeGuard getFromMemoryAsync (const void* imageData, int dataSize,
+                                                std::function<void (const Image&)> callback,
+                                                const ImageFileFormat::DecodeOptions& options = {});
+
     //==============================================================================
     /** Checks the cache for an image with a particular hashcode.
 
@@ -113,6 +196,37 @@ public:
     */
     static void releaseUnusedImages();
 
+    //==============================================================================
+    /** Sets the maximum amount of memory that the cache's images can use. The default is 64MB.
+
+        When the limit is exceeded, unused images are released in least-recently-used order
+        until the cache fits again. Images that are still being referenced elsewhere are never
+        released, so the cache may temporarily exceed this size.
+    */
+    static void setMaximumSize (size_t maxBytes);
+
+    /** Returns the maximum amount of memory that the cache's images can use. */
+    static size_t getMaximumSize();
+
+    /** Counters describing how well the cache is working. */
+    struct Statistics
+    {
+        int64 hits = 0;           /**< The number of lookups which found an image in the cache. */
+        int64 misses = 0;         /**< The number of lookups which didn't find an image. */
+        int64 evictions = 0;      /**< The number of images which were released to stay within the maximum size. */
+        int numImages = 0;        /**< The number of images (including scaled copies) currently in the cache. */
+        size_t bytesUsed = 0;     /**< The approximate amount of memory used by the cached images. */
+
+        /** Returns the proportion of lookups that were hits, from 0 to 1. */
+        double getHitRate() const noexcept      { return hits + misses > 0 ? (double) hits / (double) (hits + misses) : 0.0; }
+    };
+
+    /** Returns the cache's current statistics. */
+    static Statistics getStatistics();
+
+    /** Resets the hit, miss and eviction counters to zero. */
+    static void resetStatistics();
+
 private:
     //==============================================================================
     struct Pimpl;
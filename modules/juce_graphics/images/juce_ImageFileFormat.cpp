@@ -75,6 +75,17 @@ ImageFileFormat* ImageFileFormat::findImageFormatForFileExtension (const File& f
     return nullptr;
 }
 
+//==============================================================================
+Image ImageFileFormat::decodeImageWithOptions (InputStream& input, const DecodeOptions& options)
+{
+    auto image = decodeImage (input);
+
+    if (image.isValid() && options.progressCallback != nullptr && ! options.progressCallback (image, 1.0f))
+        return {};
+
+    return image;
+}
+
 //==============================================================================
 Image ImageFileFormat::loadFrom (InputStream& input)
 {
@@ -108,4 +119,193 @@ Image ImageFileFormat::loadFrom (const void* rawData, const size_t numBytes)
     return Image();
 }
 
+Image ImageFileFormat::loadFrom (InputStream& input, const DecodeOptions& options)
+{
+    if (ImageFileFormat* format = findImageFormatForStream (input))
+        return format->decodeImageWithOptions (input, options);
+
+    return Image();
+}
+
+Image ImageFileFormat::loadFrom (const File& file, const DecodeOptions& options)
+{
+    FileInputStream stream (file);
+
+    if (stream.openedOk())
+    {
+        BufferedInputStream b (stream, 8192);
+        return loadFrom (b, options);
+    }
+
+    return Image();
+}
+
+Image ImageFileFormat::loadFrom (const void* rawData, const size_t numBytes, const DecodeOptions& options)
+{
+    if (rawData != nullptr && numBytes > 4)
+    {
+        MemoryInputStream stream (rawData, numBytes, false);
+        return loadFrom (stream, options);
+    }
+
+    return Image();
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ImageFileFormatTests final : public UnitTest
+{
+public:
+    ImageFileFormatTests()
+        : UnitTest ("ImageFileFormat", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        for (auto isPNG : { true, false })
+        {
+            const auto source = createTestImage (256, 128, isPNG ? Image::ARGB : Image::RGB);
+            const auto data = encode (source, isPNG);
+            const auto full = ImageFileFormat::loadFrom (data.getData(), data.getSize());
+            const String formatName (isPNG ? "PNG" : "JPEG");
+
+            beginTest (formatName + ": partial decoding reports its progress");
+            {
+                Array<float> progress;
+                bool partialImageWasIncomplete = false;
+
+                ImageFileFormat::DecodeOptions options;
+                options.progressCallback = [&] (const Image& partial, float proportion)
+                {
+                    if (progress.isEmpty())
+                        partialImageWasIncomplete = partial.getPixelAt (100, 120) != full.getPixelAt (100, 120);
+
+                    progress.add (proportion);
+                    return true;
+                };
+
+                auto image = ImageFileFormat::loadFrom (data.getData(), data.getSize(), options);
+
+                expect (image.isValid());
+                expect (imagesMatch (image, full));
+                expect (progress.size() > 2);
+                expect (partialImageWasIncomplete);
+                expectEquals (progress.getLast(), 1.0f);
+
+                for (int i = 1; i < progress.size(); ++i)
+                    expect (progress[i] > progress[i - 1]);
+            }
+
+            beginTest (formatName + ": partial decoding can be cancelled");
+            {
+                int numCalls = 0;
+
+                ImageFileFormat::DecodeOptions options;
+                options.progressCallback = [&] (const Image&, float) { return ++numCalls < 2; };
+
+                expect (! ImageFileFormat::loadFrom (data.getData(), data.getSize(), options).isValid());
+                expectEquals (numCalls, 2);
+            }
+        }
+
+        beginTest ("JPEG: images can be decoded at a reduced size");
+        {
+            const auto source = createTestImage (256, 128, Image::RGB);
+            const auto data = encode (source, false);
+
+            auto decodeWithMinimumSize = [&] (int w, int h)
+            {
+                ImageFileFormat::DecodeOptions options;
+                options.minimumWidth = w;
+                options.minimumHeight = h;
+                return ImageFileFormat::loadFrom (data.getData(), data.getSize(), options);
+            };
+
+            expect (decodeWithMinimumSize (30, 16).getBounds()    == Rectangle<int> (32, 16));
+            expect (decodeWithMinimumSize (60, 30).getBounds()    == Rectangle<int> (64, 32));
+            expect (decodeWithMinimumSize (100, 0).getBounds()    == Rectangle<int> (128, 64));
+            expect (decodeWithMinimumSize (0, 100).getBounds()    == Rectangle<int> (256, 128));
+            expect (decodeWithMinimumSize (1000, 1000).getBounds() == Rectangle<int> (256, 128));
+
+            auto small = decodeWithMinimumSize (60, 30);
+            auto reference = source.rescaled (64, 32, Graphics::highResamplingQuality);
+            expect (getAverageDifference (small, reference) < 6.0);
+        }
+
+        beginTest ("PNG: a size hint is ignored");
+        {
+            const auto data = encode (createTestImage (64, 32, Image::ARGB), true);
+
+            ImageFileFormat::DecodeOptions options;
+            options.minimumWidth = 8;
+            expect (ImageFileFormat::loadFrom (data.getData(), data.getSize(), options).getBounds() == Rectangle<int> (64, 32));
+        }
+    }
+
+    static Image createTestImage (int width, int height, Image::PixelFormat format)
+    {
+        Image image (format, width, height, true);
+        Graphics g (image);
+        g.setGradientFill (ColourGradient (Colours::red, 0.0f, 0.0f, Colours::blue, (float) width, (float) height, false));
+        g.fillEllipse (image.getBounds().toFloat().reduced (4.0f));
+        g.setColour (Colours::green.withAlpha (0.5f));
+        g.fillRect (image.getBounds().withTrimmedLeft (width / 2).withTrimmedBottom (height / 3));
+        return image;
+    }
+
+    static MemoryBlock encode (const Image& image, bool asPNG)
+    {
+        MemoryOutputStream out;
+
+        if (asPNG)
+        {
+            PNGImageFormat png;
+            png.writeImageToStream (image, out);
+        }
+        else
+        {
+            JPEGImageFormat jpeg;
+            jpeg.setQuality (0.95f);
+            jpeg.writeImageToStream (image, out);
+        }
+
+        return out.getMemoryBlock();
+    }
+
+    static bool imagesMatch (const Image& a, const Image& b)
+    {
+        if (a.getBounds() != b.getBounds())
+            return false;
+
+        for (int y = 0; y < a.getHeight(); ++y)
+            for (int x = 0; x < a.getWidth(); ++x)
+                if (a.getPixelAt (x, y) != b.getPixelAt (x, y))
+                    return false;
+
+        return true;
+    }
+
+    static double getAverageDifference (const Image& a, const Image& b)
+    {
+        double total = 0;
+
+        for (int y = 0; y < a.getHeight(); ++y)
+        {
+            for (int x = 0; x < a.getWidth(); ++x)
+            {
+                auto ca = a.getPixelAt (x, y), cb = b.getPixelAt (x, y);
+                total += std::abs (ca.getRed() - cb.getRed()) + std::abs (ca.getGreen() - cb.getGreen()) + std::abs (ca.getBlue() - cb.getBlue());
+            }
+        }
+
+        return total / (3.0 * a.getWidth() * a.getHeight());
+    }
+};
+
+static ImageFileFormatTests imageFileFormatTests;
+
+#endif
+
 } // namespace juce
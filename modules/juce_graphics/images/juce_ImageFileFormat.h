@@ -84,6 +84,46 @@ public:
     */
     virtual Image decodeImage (InputStream& input) = 0;
 
+    //==============================================================================
+    /** Options that control how decodeImageWithOptions() decodes an image. */
+    struct DecodeOptions
+    {
+        /** If either of these is greater than zero, a format that can decode a smaller
+            version of the image more cheaply than the full-size one may return one,
+            as long as it's at least this big. This is intended for loading thumbnails.
+
+            The JPEG format does this by scaling down by 1/2, 1/4 or 1/8 while it does its
+            inverse DCT, which skips most of the decoding work. Formats that can't
+            do this will return the full-size image.
+        */
+        int minimumWidth = 0, minimumHeight = 0;
+
+        /** If this is set, it'll be called on the decoding thread as the image is decoded,
+            with the partially-decoded image and the proportion of the work that's been
+            done, from 0 to 1.0.
+
+            For most images, the rows are filled in from the top down. Interlaced PNGs
+            are refined in several passes over the whole image.
+
+            If the callback returns false, decoding stops and an invalid image is returned.
+        */
+        std::function<bool (const Image& partialImage, float proportionComplete)> progressCallback;
+
+        /** Returns true if a size hint has been given. */
+        bool hasMinimumSize() const noexcept    { return minimumWidth > 0 || minimumHeight > 0; }
+    };
+
+    /** Tries to decode an image from the given stream, with some extra options.
+
+        The default implementation calls decodeImage(), and then calls the progress
+        callback once when the image is complete. The PNG and JPEG formats
+        implement partial decoding, and the JPEG format implements reduced-size
+        decoding.
+
+        @see decodeImage, DecodeOptions
+    */
+    virtual Image decodeImageWithOptions (InputStream& input, const DecodeOptions& options);
+
     //==============================================================================
     /** Attempts to write an image to a stream.
 
@@ -137,6 +177,21 @@ public:
     */
     static Image loadFrom (const void* rawData,
                            size_t numBytesOfData);
+
+    /** Tries to load an image from a stream, using some decoding options.
+        @see decodeImageWithOptions
+    */
+    static Image loadFrom (InputStream& input, const DecodeOptions& options);
+
+    /** Tries to load an image from a file, using some decoding options.
+        @see decodeImageWithOptions
+    */
+    static Image loadFrom (const File& file, const DecodeOptions& options);
+
+    /** Tries to load an image from a block of raw image data, using some decoding options.
+        @see decodeImageWithOptions
+    */
+    static Image loadFrom (const void* rawData, size_t numBytesOfData, const DecodeOptions& options);
 };
 
 //==============================================================================
@@ -159,6 +214,7 @@ public:
     bool usesFileExtension (const File&) override;
     bool canUnderstand (InputStream&) override;
     Image decodeImage (InputStream&) override;
+    Image decodeImageWithOptions (InputStream&, const DecodeOptions&) override;
     bool writeImageToStream (const Image&, OutputStream&) override;
 };
 
@@ -191,6 +247,7 @@ public:
     bool usesFileExtension (const File&) override;
     bool canUnderstand (InputStream&) override;
     Image decodeImage (InputStream&) override;
+    Image decodeImageWithOptions (InputStream&, const DecodeOptions&) override;
     bool writeImageToStream (const Image&, OutputStream&) override;
 
 private:
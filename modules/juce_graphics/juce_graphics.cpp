@@ -98,6 +98,24 @@
 
 #undef SIZEOF
 
+#if JUCE_USE_SIMD_SPAN_BLITTERS
+ #if JUCE_INTEL && (defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2))
+  #define JUCE_SPAN_BLITTERS_SSE2 1
+  #include <emmintrin.h>
+
+  #if ! JUCE_MINGW
+   #define JUCE_SPAN_BLITTERS_AVX2 1
+   // Some versions of GCC report false positives from the _undefined_ placeholders in these headers
+   JUCE_BEGIN_IGNORE_WARNINGS_GCC_LIKE ("-Wmaybe-uninitialized")
+   #include <immintrin.h>
+   JUCE_END_IGNORE_WARNINGS_GCC_LIKE
+  #endif
+ #elif JUCE_ARM && JUCE_LITTLE_ENDIAN && (defined (__ARM_NEON__) || defined (__ARM_NEON) || defined (_M_ARM64))
+  #define JUCE_SPAN_BLITTERS_NEON 1
+  #include <arm_neon.h>
+ #endif
+#endif
+
 #if (JUCE_MAC || JUCE_IOS) && USE_COREGRAPHICS_RENDERING && JUCE_USE_COREIMAGE_LOADER
  #define JUCE_USING_COREIMAGE_LOADER 1
 #else
@@ -118,6 +136,8 @@
 #include "contexts/juce_GraphicsContext.cpp"
 #include "contexts/juce_LowLevelGraphicsPostScriptRenderer.cpp"
 #include "contexts/juce_LowLevelGraphicsSoftwareRenderer.cpp"
+#include "contexts/juce_LowLevelGraphicsTiledSoftwareRenderer.cpp"
+#include "contexts/juce_DisplayList.cpp"
 #include "images/juce_Image.cpp"
 #include "images/juce_ImageCache.cpp"
 #include "images/juce_ImageConvolutionKernel.cpp"
@@ -131,8 +151,11 @@
 #include "fonts/juce_Font.cpp"
 #include "fonts/juce_GlyphArrangement.cpp"
 #include "fonts/juce_TextLayout.cpp"
+#include "fonts/juce_GlyphAtlas.cpp"
+#include "fonts/juce_ShapedTextCache.cpp"
 #include "effects/juce_DropShadowEffect.cpp"
 #include "effects/juce_GlowEffect.cpp"
+#include "native/juce_SpanBlitters.cpp"
 
 #if JUCE_UNIT_TESTS
  #include "geometry/juce_Rectangle_test.cpp"
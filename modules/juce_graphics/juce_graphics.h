@@ -87,6 +87,16 @@
  #define JUCE_DISABLE_COREGRAPHICS_FONT_SMOOTHING 0
 #endif
 
+/** Config: JUCE_USE_SIMD_SPAN_BLITTERS
+
+    Enables the SSE2, AVX2 and NEON pixel loops used by the software renderer to fill
+    and blend spans of pixels. Disabling it leaves all pixel operations to the plain
+    per-pixel code, which produces exactly the same results, only more slowly.
+*/
+#ifndef JUCE_USE_SIMD_SPAN_BLITTERS
+ #define JUCE_USE_SIMD_SPAN_BLITTERS 1
+#endif
+
 #ifndef JUCE_INCLUDE_PNGLIB_CODE
  #define JUCE_INCLUDE_PNGLIB_CODE 1
 #endif
@@ -105,6 +115,8 @@ namespace juce
     class Image;
     class AffineTransform;
     class Path;
+    class PathStrokeType;
+    class EdgeTable;
     class Font;
     class Graphics;
     class FillType;
@@ -128,22 +140,27 @@ namespace juce
 #include "geometry/juce_PathIterator.h"
 #include "geometry/juce_PathStrokeType.h"
 #include "placement/juce_RectanglePlacement.h"
+#include "images/juce_ImageFileFormat.h"
 #include "images/juce_ImageCache.h"
 #include "images/juce_ImageConvolutionKernel.h"
-#include "images/juce_ImageFileFormat.h"
 #include "fonts/juce_Typeface.h"
 #include "fonts/juce_Font.h"
 #include "fonts/juce_AttributedString.h"
 #include "fonts/juce_GlyphArrangement.h"
 #include "fonts/juce_TextLayout.h"
+#include "fonts/juce_ShapedTextCache.h"
 #include "fonts/juce_CustomTypeface.h"
+#include "fonts/juce_GlyphAtlas.h"
 #include "contexts/juce_GraphicsContext.h"
 #include "contexts/juce_LowLevelGraphicsContext.h"
 #include "images/juce_Image.h"
 #include "images/juce_ScaledImage.h"
 #include "colour/juce_FillType.h"
+#include "native/juce_SpanBlitters.h"
 #include "native/juce_RenderingHelpers.h"
 #include "contexts/juce_LowLevelGraphicsSoftwareRenderer.h"
+#include "contexts/juce_LowLevelGraphicsTiledSoftwareRenderer.h"
+#include "contexts/juce_DisplayList.h"
 #include "contexts/juce_LowLevelGraphicsPostScriptRenderer.h"
 #include "effects/juce_ImageEffectFilter.h"
 #include "effects/juce_DropShadowEffect.h"
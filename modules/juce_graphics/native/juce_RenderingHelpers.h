@@ -175,10 +175,7 @@ public:
     void drawGlyph (RenderTargetType& target, const Font& font, const int glyphNumber, Point<float> pos)
     {
         if (auto glyph = findOrCreateGlyph (font, glyphNumber))
-        {
-            glyph->lastAccessCount = ++accessCounter;
             glyph->draw (target, pos);
-        }
     }
 
     ReferenceCountedObjectPtr<CachedGlyphType> findOrCreateGlyph (const Font& font, int glyphNumber)
@@ -188,6 +185,7 @@ public:
         if (auto g = findExistingGlyph (font, glyphNumber))
         {
             ++hits;
+            g->lastAccessCount = ++accessCounter;
             return g;
         }
 
@@ -195,9 +193,21 @@ public:
         auto g = getGlyphForReuse();
         jassert (g != nullptr);
         g->generate (font, glyphNumber);
+        g->lastAccessCount = ++accessCounter;
         return g;
     }
 
+    /** Creates an edge table for a glyph that's too heavily transformed to be worth caching.
+
+        Like the cached glyphs, this is done while holding the cache's lock, so that a typeface
+        will never be asked for outlines by several rendering threads at once.
+    */
+    std::unique_ptr<EdgeTable> createUncachedGlyph (const Font& font, int glyphNumber, const AffineTransform& transform)
+    {
+        const ScopedLock sl (lock);
+        return std::unique_ptr<EdgeTable> (font.getTypefacePtr()->getEdgeTableForGlyph (glyphNumber, transform, font.getHeight()));
+    }
+
 private:
     ReferenceCountedArray<CachedGlyphType> glyphs;
     Atomic<int> accessCounter, hits, misses;
@@ -666,7 +676,8 @@ namespace EdgeTableFillers
 
         inline void blendLine (PixelType* dest, PixelARGB colour, int width) const noexcept
         {
-            JUCE_PERFORM_PIXEL_OP_LOOP (blend (colour))
+            if (! SpanBlitters::blendColourSpan (dest, destData.pixelStride, colour, width))
+                JUCE_PERFORM_PIXEL_OP_LOOP (blend (colour))
         }
 
         forcedinline void replaceLine (PixelRGB* dest, PixelARGB colour, int width) const noexcept
@@ -726,15 +737,23 @@ namespace EdgeTableFillers
             auto* dest = getPixel (x);
 
             if (alphaLevel < 0xff)
-                JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++), (uint32) alphaLevel))
+            {
+                if (! blendSpan (dest, x, width, (uint32) alphaLevel))
+                    JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++), (uint32) alphaLevel))
+            }
             else
-                JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++)))
+            {
+                if (! blendSpan (dest, x, width, 256))
+                    JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++)))
+            }
         }
 
         void handleEdgeTableLineFull (int x, int width) const noexcept
         {
             auto* dest = getPixel (x);
-            JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++)))
+
+            if (! blendSpan (dest, x, width, 256))
+                JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++)))
         }
 
         void handleEdgeTableRectangle (int x, int y, int width, int height, int alphaLevel) noexcept
@@ -764,6 +783,35 @@ namespace EdgeTableFillers
             return addBytesToPointer (linePixels, x * destData.pixelStride);
         }
 
+        // Looks up the gradient's colours a chunk at a time, so that they can be blended as a span
+        bool blendSpan (PixelType* dest, int x, int width, uint32 alphaLevel) const noexcept
+        {
+            if (width < SpanBlitters::minimumSpanLength
+                 || SpanBlitters::getLayout (dest, destData.pixelStride) == SpanBlitters::Layout::unsupported)
+                return false;
+
+            PixelARGB colours[128];
+
+            while (width > 0)
+            {
+                const auto num = jmin (width, (int) numElementsInArray (colours));
+
+                for (int i = 0; i < num; ++i)
+                    colours[i] = GradientType::getPixel (x++);
+
+                if (! SpanBlitters::blendSpan (dest, destData.pixelStride, colours, (int) sizeof (PixelARGB), num, alphaLevel))
+                {
+                    for (int i = 0; i < num; ++i)
+                        addBytesToPointer (dest, i * destData.pixelStride)->blend (colours[i], alphaLevel);
+                }
+
+                dest = addBytesToPointer (dest, num * destData.pixelStride);
+                width -= num;
+            }
+
+            return true;
+        }
+
         JUCE_DECLARE_NON_COPYABLE (Gradient)
     };
 
@@ -815,17 +863,14 @@ namespace EdgeTableFillers
 
             if (repeatPattern)
             {
-                if (alphaLevel < 0xfe)
-                    JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (x++ % srcData.width), (uint32) alphaLevel))
-                else
-                    JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (x++ % srcData.width)))
+                blendRepeatedRow (dest, x, width, alphaLevel < 0xfe ? (uint32) alphaLevel : 256);
             }
             else
             {
                 jassert (x >= 0 && x + width <= srcData.width);
 
                 if (alphaLevel < 0xfe)
-                    JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (x++), (uint32) alphaLevel))
+                    blendRow (dest, getSrcPixel (x), width, (uint32) alphaLevel);
                 else
                     copyRow (dest, getSrcPixel (x), width);
             }
@@ -838,17 +883,14 @@ namespace EdgeTableFillers
 
             if (repeatPattern)
             {
-                if (extraAlpha < 0xfe)
-                    JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (x++ % srcData.width), (uint32) extraAlpha))
-                else
-                    JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (x++ % srcData.width)))
+                blendRepeatedRow (dest, x, width, extraAlpha < 0xfe ? (uint32) extraAlpha : 256);
             }
             else
             {
                 jassert (x >= 0 && x + width <= srcData.width);
 
                 if (extraAlpha < 0xfe)
-                    JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (x++), (uint32) extraAlpha))
+                    blendRow (dest, getSrcPixel (x), width, (uint32) extraAlpha);
                 else
                     copyRow (dest, getSrcPixel (x), width);
             }
@@ -913,6 +955,30 @@ namespace EdgeTableFillers
                 memcpy ((void*) dest, src, (size_t) (width * srcStride));
             }
             else
+            {
+                blendRow (dest, src, width, 256);
+            }
+        }
+
+        // An alpha of 256 blends each pixel without an extra opacity multiplier
+        void blendRow (DestPixelType* dest, SrcPixelType const* src, int width, uint32 alpha) const noexcept
+        {
+            auto destStride = destData.pixelStride;
+            auto srcStride  = srcData.pixelStride;
+
+            if (SpanBlitters::blendSpan (dest, destStride, src, srcStride, width, alpha))
+                return;
+
+            if (alpha < 256)
+            {
+                do
+                {
+                    dest->blend (*src, alpha);
+                    dest = addBytesToPointer (dest, destStride);
+                    src  = addBytesToPointer (src, srcStride);
+                } while (--width > 0);
+            }
+            else
             {
                 do
                 {
@@ -923,6 +989,22 @@ namespace EdgeTableFillers
             }
         }
 
+        // Splits the row wherever it wraps around the end of the source image
+        void blendRepeatedRow (DestPixelType* dest, int x, int width, uint32 alpha) const noexcept
+        {
+            while (width > 0)
+            {
+                const auto srcX = x % srcData.width;
+                const auto num = jmin (width, srcData.width - srcX);
+
+                blendRow (dest, getSrcPixel (srcX), num, alpha);
+
+                dest = addBytesToPointer (dest, num * destData.pixelStride);
+                x += num;
+                width -= num;
+            }
+        }
+
         JUCE_DECLARE_NON_COPYABLE (ImageFill)
     };
 
@@ -983,6 +1065,10 @@ namespace EdgeTableFillers
             alphaLevel *= extraAlpha;
             alphaLevel >>= 8;
 
+            if (SpanBlitters::blendSpan (dest, destData.pixelStride, span, (int) sizeof (SrcPixelType),
+                                         width, alphaLevel < 0xfe ? (uint32) alphaLevel : 256))
+                return;
+
             if (alphaLevel < 0xfe)
                 JUCE_PERFORM_PIXEL_OP_LOOP (blend (*span++, (uint32) alphaLevel))
             else
@@ -1112,6 +1198,10 @@ namespace EdgeTableFillers
         //==============================================================================
         void render4PixelAverage (PixelARGB* dest, const uint8* src, int subPixelX, int subPixelY) noexcept
         {
+            if (SpanBlitters::renderBilinearPixel (dest, src, this->srcData.pixelStride, this->srcData.lineStride,
+                                                   (uint32) subPixelX, (uint32) subPixelY))
+                return;
+
             uint32 c[4] = { 256 * 128, 256 * 128, 256 * 128, 256 * 128 };
 
             auto weight = (uint32) ((256 - subPixelX) * (256 - subPixelY));
@@ -1622,6 +1712,7 @@ struct ClipRegions
     struct EdgeTableRegion  : public Base
     {
         EdgeTableRegion (const EdgeTable& e)            : edgeTable (e) {}
+        EdgeTableRegion (EdgeTable&& e)                 : edgeTable (std::move (e)) {}
         EdgeTableRegion (Rectangle<int> r)              : edgeTable (r) {}
         EdgeTableRegion (Rectangle<float> r)            : edgeTable (r) {}
         EdgeTableRegion (const RectangleList<int>& r)   : edgeTable (r) {}
@@ -1997,11 +2088,13 @@ struct ClipRegions
                             {
                                 if (h == 1)
                                 {
+                                    // (the edges use the same arithmetic as handleEdgeTableRectangle, so that a
+                                    // row looks the same whether or not the clip region happens to split it off)
                                     r.setEdgeTableYPos (y1);
 
-                                    if (doLeftAlpha)        r.handleEdgeTablePixel (f.totalLeft, f.leftAlpha);
+                                    if (doLeftAlpha)        r.handleEdgeTableLine (f.totalLeft, 1, f.leftAlpha);
                                     if (clippedWidth > 0)   r.handleEdgeTableLineFull (clippedLeft, clippedWidth);
-                                    if (doRightAlpha)       r.handleEdgeTablePixel (f.right, f.rightAlpha);
+                                    if (doRightAlpha)       r.handleEdgeTableLine (f.right, 1, f.rightAlpha);
                                 }
                                 else
                                 {
@@ -2065,7 +2158,8 @@ public:
     {
     }
 
-    SavedStateType& getThis() noexcept  { return *static_cast<SavedStateType*> (this); }
+    SavedStateType& getThis() noexcept              { return *static_cast<SavedStateType*> (this); }
+    const SavedStateType& getThis() const noexcept  { return *static_cast<const SavedStateType*> (this); }
 
     bool clipToRectangle (Rectangle<int> r)
     {
@@ -2327,7 +2421,7 @@ public:
             auto clipRect = clip->getClipBounds();
 
             if (path.getBoundsTransformed (trans).getSmallestIntegerContainer().intersects (clipRect))
-                fillShape (*new EdgeTableRegionType (clipRect, path, trans), false);
+                fillShape (*new EdgeTableRegionType (path.createEdgeTable (clipRect, trans)), false);
         }
     }
 
@@ -2338,18 +2432,97 @@ public:
             auto* edgeTableClip = new EdgeTableRegionType (edgeTable);
             edgeTableClip->edgeTable.translate (x, y);
 
-            if (fillType.isColour())
-            {
-                auto brightness = fillType.colour.getBrightness() - 0.5f;
+            auto levelMultiplier = getGlyphLevelMultiplier();
 
-                if (brightness > 0.0f)
-                    edgeTableClip->edgeTable.multiplyLevels (1.0f + 1.6f * brightness);
-            }
+            if (levelMultiplier != 256)
+                edgeTableClip->edgeTable.multiplyLevels ((float) levelMultiplier / 256.0f);
 
             fillShape (*edgeTableClip, false);
         }
     }
 
+    /** Returns the amount (out of 256) by which the coverage of text is scaled when it's
+        drawn with the current fill. Light text is made slightly heavier, because it
+        otherwise looks thinner than dark text.
+    */
+    int getGlyphLevelMultiplier() const noexcept
+    {
+        if (fillType.isColour())
+        {
+            auto brightness = fillType.colour.getBrightness() - 0.5f;
+
+            if (brightness > 0.0f)
+                return (int) ((1.0f + 1.6f * brightness) * 256.0f);
+        }
+
+        return 256;
+    }
+
+    //==============================================================================
+    /** If drawGlyph() would draw this glyph from the GlyphAtlas, this returns the glyph
+        and the device pixel at which it should be drawn.
+    */
+    std::optional<GlyphAtlas::PositionedGlyph> findAtlasGlyph (int glyphNumber, const AffineTransform& trans) const
+    {
+        if (! trans.isOnlyTranslation() || transform.isRotated)
+            return {};
+
+        const auto& font = getThis().font;
+        Point<float> pos (trans.getTranslationX(), trans.getTranslationY());
+
+        if (transform.isOnlyTranslated)
+            return GlyphAtlas::findOrCreateGlyph (font, glyphNumber, pos + transform.offset.toFloat());
+
+        Font f (font);
+        f.setHeight (font.getHeight() * transform.complexTransform.mat11);
+
+        auto xScale = transform.complexTransform.mat00 / transform.complexTransform.mat11;
+
+        if (std::abs (xScale - 1.0f) > 0.01f)
+            f.setHorizontalScale (xScale);
+
+        return GlyphAtlas::findOrCreateGlyph (f, glyphNumber, transform.transformed (pos));
+    }
+
+    /** Fills a glyph from the GlyphAtlas by turning its coverage mask into an edge table. */
+    void fillAtlasGlyph (const GlyphAtlas::PositionedGlyph& positioned)
+    {
+        auto area = positioned.getBounds();
+
+        if (clip != nullptr && ! area.isEmpty())
+        {
+            auto* edgeTableClip = new EdgeTableRegionType (area);
+            positioned.glyph->clipEdgeTable (edgeTableClip->edgeTable, positioned.origin);
+
+            auto levelMultiplier = getGlyphLevelMultiplier();
+
+            if (levelMultiplier != 256)
+                edgeTableClip->edgeTable.multiplyLevels ((float) levelMultiplier / 256.0f);
+
+            fillShape (*edgeTableClip, false);
+        }
+    }
+
+    /** Draws a glyph whose transform can't be handled by the GlyphAtlas. */
+    void fillUncachedGlyph (int glyphNumber, const AffineTransform& trans)
+    {
+        if (clip != nullptr)
+            if (auto et = createUncachedGlyph (glyphNumber, trans))
+                fillShape (*new EdgeTableRegionType (*et), false);
+    }
+
+    /** Creates the device-space edge table that fillUncachedGlyph() would fill. */
+    std::unique_ptr<EdgeTable> createUncachedGlyph (int glyphNumber, const AffineTransform& trans) const
+    {
+        const auto& font = getThis().font;
+        auto fontHeight = font.getHeight();
+
+        auto t = transform.getTransformWith (AffineTransform::scale (fontHeight * font.getHorizontalScale(), fontHeight)
+                                                             .followedBy (trans));
+
+        return GlyphAtlas::createUncachedGlyph (font, glyphNumber, t);
+    }
+
     void drawLine (Line<float> line)
     {
         Path p;
@@ -2357,6 +2530,35 @@ public:
         fillPath (p, {});
     }
 
+    void drawPolyline (const Point<float>* points, int numPoints, float lineThickness)
+    {
+        if (clip != nullptr)
+            fillShape (*new EdgeTableRegionType (EdgeTable (clip->getClipBounds(), points, numPoints,
+                                                            lineThickness, transform.getTransform())), false);
+    }
+
+    void fillWaveformColumns (float x, float columnWidth, const float* tops, const float* bottoms, int numColumns)
+    {
+        if (clip != nullptr)
+        {
+            if (transform.isRotated)
+            {
+                RectangleList<float> columns;
+
+                for (int i = 0; i < numColumns; ++i)
+                    if (tops[i] < bottoms[i])
+                        columns.addWithoutMerging ({ x + (float) i * columnWidth, tops[i], columnWidth, bottoms[i] - tops[i] });
+
+                fillPath (columns.toPath(), {});
+            }
+            else
+            {
+                fillShape (*new EdgeTableRegionType (EdgeTable (clip->getClipBounds(), x, columnWidth, tops, bottoms,
+                                                                numColumns, transform.getTransform())), false);
+            }
+        }
+    }
+
     void drawImage (const Image& sourceImage, const AffineTransform& trans)
     {
         if (clip != nullptr && ! fillType.colour.isTransparent())
@@ -2523,53 +2725,55 @@ public:
         }
     }
 
-    using GlyphCacheType = GlyphCache<CachedGlyphEdgeTable<SoftwareRendererSavedState>, SoftwareRendererSavedState>;
-
     static void clearGlyphCache()
     {
-        GlyphCacheType::getInstance().reset();
+        GlyphAtlas::clear();
     }
 
     //==============================================================================
+    /** Returns the device-space area that drawGlyph() could affect. */
+    Rectangle<int> getGlyphBounds (int glyphNumber, const AffineTransform& trans) const
+    {
+        if (clip == nullptr)
+            return {};
+
+        if (auto positioned = findAtlasGlyph (glyphNumber, trans))
+            return positioned->getBounds().getIntersection (clip->getClipBounds());
+
+        // Building the outline here means each tile only has to rasterise the glyphs that
+        // touch it, rather than every rotated or sheared glyph in the whole area.
+        if (auto et = createUncachedGlyph (glyphNumber, trans))
+            return et->getMaximumBounds().getIntersection (clip->getClipBounds());
+
+        return {};
+    }
+
     void drawGlyph (int glyphNumber, const AffineTransform& trans)
     {
         if (clip != nullptr)
         {
-            if (trans.isOnlyTranslation() && ! transform.isRotated)
+            if (auto positioned = findAtlasGlyph (glyphNumber, trans))
             {
-                auto& cache = GlyphCacheType::getInstance();
-                Point<float> pos (trans.getTranslationX(), trans.getTranslationY());
+                if (positioned->glyph == nullptr)
+                    return;
 
-                if (transform.isOnlyTranslated)
+                // When filling a colour through a rectangular clip, the mask can be blended
+                // straight into the image, without building an edge table for it first.
+                if (fillType.isColour())
                 {
-                    cache.drawGlyph (*this, font, glyphNumber, pos + transform.offset.toFloat());
+                    if (auto* rectangleClip = dynamic_cast<RectangleListRegionType*> (clip.get()))
+                    {
+                        GlyphMaskIterator iter { *positioned, rectangleClip->clip, getGlyphLevelMultiplier() };
+                        fillWithSolidColour (iter, fillType.colour.getPixelARGB(), false);
+                        return;
+                    }
                 }
-                else
-                {
-                    pos = transform.transformed (pos);
 
-                    Font f (font);
-                    f.setHeight (font.getHeight() * transform.complexTransform.mat11);
-
-                    auto xScale = transform.complexTransform.mat00 / transform.complexTransform.mat11;
-
-                    if (std::abs (xScale - 1.0f) > 0.01f)
-                        f.setHorizontalScale (xScale);
-
-                    cache.drawGlyph (*this, f, glyphNumber, pos);
-                }
+                fillAtlasGlyph (*positioned);
             }
             else
             {
-                auto fontHeight = font.getHeight();
-
-                auto t = transform.getTransformWith (AffineTransform::scale (fontHeight * font.getHorizontalScale(), fontHeight)
-                                                                     .followedBy (trans));
-
-                std::unique_ptr<EdgeTable> et (font.getTypefacePtr()->getEdgeTableForGlyph (glyphNumber, t, fontHeight));
-
-                if (et != nullptr)
-                    fillShape (*new EdgeTableRegionType (*et), false);
+                fillUncachedGlyph (glyphNumber, trans);
             }
         }
     }
@@ -2577,6 +2781,24 @@ public:
     Rectangle<int> getMaximumBounds() const     { return image.getBounds(); }
 
     //==============================================================================
+    /** Iterates the parts of a glyph's coverage mask that lie inside a rectangular clip. */
+    struct GlyphMaskIterator
+    {
+        template <class Renderer>
+        void iterate (Renderer& r) const noexcept
+        {
+            auto glyphBounds = positioned.getBounds();
+
+            for (auto& rect : clip)
+                if (rect.intersects (glyphBounds))
+                    positioned.glyph->iterate (r, positioned.origin, rect, levelMultiplier);
+        }
+
+        const GlyphAtlas::PositionedGlyph& positioned;
+        const RectangleList<int>& clip;
+        int levelMultiplier;
+    };
+
     template <typename IteratorType>
     void renderImageTransformed (IteratorType& iter, const Image& src, int alpha, const AffineTransform& trans, Graphics::ResamplingQuality quality, bool tiledFill) const
     {
@@ -2723,6 +2945,17 @@ public:
     void drawImage (const Image& im, const AffineTransform& t) override          { stack->drawImage (im, t); }
     void drawGlyph (int glyphNumber, const AffineTransform& t) override          { stack->drawGlyph (glyphNumber, t); }
     void drawLine (const Line<float>& line) override                             { stack->drawLine (line); }
+
+    void drawPolyline (const Point<float>* points, int numPoints, float lineThickness) override
+    {
+        stack->drawPolyline (points, numPoints, lineThickness);
+    }
+
+    void fillWaveformColumns (float x, float columnWidth, const float* tops, const float* bottoms, int numColumns) override
+    {
+        stack->fillWaveformColumns (x, columnWidth, tops, bottoms, numColumns);
+    }
+
     void setFont (const Font& newFont) override                                  { stack->font = newFont; }
     const Font& getFont() override                                               { return stack->font; }
 
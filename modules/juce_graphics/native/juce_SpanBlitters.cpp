@@ -0,0 +1,910 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::RenderingHelpers::SpanBlitters
+{
+
+template <Layout layout>
+using SpanPixelType = std::conditional_t<layout == Layout::argb, PixelARGB, PixelRGB>;
+
+template <Layout layout>
+constexpr int spanPixelSize = layout == Layout::rgb ? 3 : 4;
+
+// Vectors treat ARGB and RGB pixels as interchangeable runs of bytes, so mixing the two
+// is only possible if their colour channels sit in the same order in memory.
+constexpr bool rgbMatchesARGBByteOrder = (int) PixelRGB::indexR == (int) PixelARGB::indexR
+                                      && (int) PixelRGB::indexG == (int) PixelARGB::indexG
+                                      && (int) PixelRGB::indexB == (int) PixelARGB::indexB
+                                      && (int) PixelARGB::indexA == 3;
+
+template <Layout destLayout, Layout srcLayout>
+static void blendPixelsScalar (uint8* dest, const uint8* src, int num, uint32 extraAlpha) noexcept
+{
+    for (; num > 0; --num)
+    {
+        reinterpret_cast<SpanPixelType<destLayout>*> (dest)->blend (*reinterpret_cast<const SpanPixelType<srcLayout>*> (src), extraAlpha);
+        dest += spanPixelSize<destLayout>;
+        src  += spanPixelSize<srcLayout>;
+    }
+}
+
+template <Layout destLayout>
+static void blendColourScalar (uint8* dest, PixelARGB colour, int num) noexcept
+{
+    for (; num > 0; --num)
+    {
+        reinterpret_cast<SpanPixelType<destLayout>*> (dest)->blend (colour);
+        dest += spanPixelSize<destLayout>;
+    }
+}
+
+/*  When blending a solid colour, each destination byte becomes min (255, c + ((d * (256 - a)) >> 8)),
+    where c and a only depend on the byte's position within its pixel. This lays out those c and a
+    bytes for a run of pixels, so that they can be loaded straight into vectors.
+
+    The padding byte of an rgbx pixel is given c = 0, a = 0, which leaves it unchanged.
+*/
+template <Layout destLayout, size_t numBytes>
+static void fillColourPattern (uint8 (&colourBytes)[numBytes], uint8 (&alphaBytes)[numBytes], PixelARGB colour) noexcept
+{
+    constexpr auto pixelSize = (size_t) spanPixelSize<destLayout>;
+    static_assert (numBytes % pixelSize == 0, "The pattern must hold a whole number of pixels");
+
+    for (size_t i = 0; i < numBytes; i += pixelSize)
+    {
+        auto* c = colourBytes + i;
+        auto* a = alphaBytes + i;
+
+        if constexpr (destLayout == Layout::argb)
+        {
+            c[PixelARGB::indexA] = colour.getAlpha();
+            c[PixelARGB::indexR] = colour.getRed();
+            c[PixelARGB::indexG] = colour.getGreen();
+            c[PixelARGB::indexB] = colour.getBlue();
+            std::fill (a, a + 4, colour.getAlpha());
+        }
+        else
+        {
+            c[PixelRGB::indexR] = colour.getRed();
+            c[PixelRGB::indexG] = colour.getGreen();
+            c[PixelRGB::indexB] = colour.getBlue();
+            std::fill (a, a + 3, colour.getAlpha());
+
+            if constexpr (destLayout == Layout::rgbx)
+                c[3] = a[3] = 0;
+        }
+    }
+}
+
+/*  Turns a runtime choice of layouts into a call to one of a kernel set's templated loops. */
+template <typename Kernels>
+struct SpanDispatcher
+{
+    static bool blendColour (uint8* dest, Layout destLayout, PixelARGB colour, int num) noexcept
+    {
+        switch (destLayout)
+        {
+            case Layout::argb:          Kernels::template blendColour<Layout::argb> (dest, colour, num); return true;
+            case Layout::rgbx:          Kernels::template blendColour<Layout::rgbx> (dest, colour, num); return true;
+            case Layout::rgb:           Kernels::template blendColour<Layout::rgb>  (dest, colour, num); return true;
+            case Layout::unsupported:   break;
+        }
+
+        return false;
+    }
+
+    static bool blend (uint8* dest, Layout destLayout, const uint8* src, Layout srcLayout, int num, uint32 extraAlpha) noexcept
+    {
+        return extraAlpha < 256 ? blend<true>  (dest, destLayout, src, srcLayout, num, extraAlpha)
+                                : blend<false> (dest, destLayout, src, srcLayout, num, extraAlpha);
+    }
+
+private:
+    template <bool scaleSource>
+    static bool blend (uint8* dest, Layout destLayout, const uint8* src, Layout srcLayout, int num, uint32 extraAlpha) noexcept
+    {
+        switch (destLayout)
+        {
+            case Layout::argb:          return blendInto<Layout::argb, scaleSource> (dest, src, srcLayout, num, extraAlpha);
+            case Layout::rgbx:          return blendInto<Layout::rgbx, scaleSource> (dest, src, srcLayout, num, extraAlpha);
+            case Layout::rgb:           return blendInto<Layout::rgb,  scaleSource> (dest, src, srcLayout, num, extraAlpha);
+            case Layout::unsupported:   break;
+        }
+
+        return false;
+    }
+
+    template <Layout destLayout, bool scaleSource>
+    static bool blendInto (uint8* dest, const uint8* src, Layout srcLayout, int num, uint32 extraAlpha) noexcept
+    {
+        switch (srcLayout)
+        {
+            case Layout::argb:          Kernels::template blendPixels<destLayout, Layout::argb, scaleSource> (dest, src, num, extraAlpha); return true;
+            case Layout::rgbx:          Kernels::template blendPixels<destLayout, Layout::rgbx, scaleSource> (dest, src, num, extraAlpha); return true;
+            case Layout::rgb:           Kernels::template blendPixels<destLayout, Layout::rgb,  scaleSource> (dest, src, num, extraAlpha); return true;
+            case Layout::unsupported:   break;
+        }
+
+        return false;
+    }
+};
+
+//==============================================================================
+#if JUCE_SPAN_BLITTERS_SSE2
+ /*  Both x86 instruction sets blend pixels as 16-bit lanes, two (SSE2) or four (AVX2)
+     pixels per register. Every intermediate value fits in 16 bits: a colour byte multiplied
+     by an alpha of up to 256 is at most 65280, and the final sum of the two terms is at most
+     510 before packus saturates it, which is exactly what clampPixelComponents() does.
+ */
+ struct SSE2Ops
+ {
+     using Vec = __m128i;
+     enum { numPixels = 4 };
+
+     static forcedinline Vec load (const uint8* p) noexcept         { return _mm_loadu_si128 (reinterpret_cast<const __m128i*> (p)); }
+     static forcedinline void store (uint8* p, Vec v) noexcept      { _mm_storeu_si128 (reinterpret_cast<__m128i*> (p), v); }
+
+     static forcedinline Vec loadRGB (const uint8* p) noexcept
+     {
+         uint64 lo;
+         uint32 hi;
+         memcpy (&lo, p, 8);
+         memcpy (&hi, p + 8, 4);
+
+         return forceOpaque (_mm_set_epi32 ((int) (hi >> 8),
+                                            (int) ((lo >> 48) | (hi << 16)),
+                                            (int) (lo >> 24),
+                                            (int) lo));
+     }
+
+     static forcedinline void storeRGB (uint8* p, Vec v) noexcept
+     {
+         alignas (16) uint32 pixels[4];
+         _mm_store_si128 (reinterpret_cast<__m128i*> (pixels), v);
+
+         const auto lo = (uint64) (pixels[0] & 0xffffff) | ((uint64) (pixels[1] & 0xffffff) << 24) | ((uint64) pixels[2] << 48);
+         const auto hi = ((pixels[2] >> 16) & 0xff) | (pixels[3] << 8);
+         memcpy (p, &lo, 8);
+         memcpy (p + 8, &hi, 4);
+     }
+
+     static forcedinline Vec forceOpaque (Vec v) noexcept                   { return _mm_or_si128 (v, _mm_set1_epi32 ((int) 0xff000000)); }
+
+     static forcedinline Vec keepPadding (Vec v, Vec original) noexcept
+     {
+         const auto colourMask = _mm_set1_epi32 (0x00ffffff);
+         return _mm_or_si128 (_mm_and_si128 (v, colourMask), _mm_andnot_si128 (colourMask, original));
+     }
+
+     static forcedinline Vec unpackLo (Vec v) noexcept                      { return _mm_unpacklo_epi8 (v, _mm_setzero_si128()); }
+     static forcedinline Vec unpackHi (Vec v) noexcept                      { return _mm_unpackhi_epi8 (v, _mm_setzero_si128()); }
+     static forcedinline Vec pack (Vec lo, Vec hi) noexcept                 { return _mm_packus_epi16 (lo, hi); }
+     static forcedinline Vec set16 (int v) noexcept                         { return _mm_set1_epi16 ((short) v); }
+     static forcedinline Vec add16 (Vec a, Vec b) noexcept                  { return _mm_add_epi16 (a, b); }
+     static forcedinline Vec sub16 (Vec a, Vec b) noexcept                  { return _mm_sub_epi16 (a, b); }
+     static forcedinline Vec mulShift16 (Vec a, Vec b) noexcept             { return _mm_srli_epi16 (_mm_mullo_epi16 (a, b), 8); }
+     static forcedinline Vec broadcastAlpha16 (Vec v) noexcept              { return _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (v, 0xff), 0xff); }
+     static forcedinline void endVectorLoop() noexcept                      {}
+ };
+
+ #if JUCE_SPAN_BLITTERS_AVX2
+  #if JUCE_MSVC
+   #define JUCE_SPAN_AVX2_TARGET
+  #else
+   #define JUCE_SPAN_AVX2_TARGET   __attribute__ ((target ("avx2")))
+  #endif
+
+ struct AVX2Ops
+ {
+     using Vec = __m256i;
+     enum { numPixels = 8 };
+
+     JUCE_SPAN_AVX2_TARGET static forcedinline Vec load (const uint8* p) noexcept         { return _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (p)); }
+     JUCE_SPAN_AVX2_TARGET static forcedinline void store (uint8* p, Vec v) noexcept      { _mm256_storeu_si256 (reinterpret_cast<__m256i*> (p), v); }
+
+     // The 24 bytes are read as two overlapping halves, so that nothing past the end of the run is touched
+     JUCE_SPAN_AVX2_TARGET static forcedinline Vec loadRGB (const uint8* p) noexcept
+     {
+         const auto lo = _mm_shuffle_epi8 (_mm_loadu_si128 (reinterpret_cast<const __m128i*> (p)),
+                                           _mm_setr_epi8 (0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1));
+         const auto hi = _mm_shuffle_epi8 (_mm_loadu_si128 (reinterpret_cast<const __m128i*> (p + 8)),
+                                           _mm_setr_epi8 (4, 5, 6, -1, 7, 8, 9, -1, 10, 11, 12, -1, 13, 14, 15, -1));
+
+         return forceOpaque (_mm256_inserti128_si256 (_mm256_castsi128_si256 (lo), hi, 1));
+     }
+
+     JUCE_SPAN_AVX2_TARGET static forcedinline void storeRGB (uint8* p, Vec v) noexcept
+     {
+         const auto packRGB = _mm_setr_epi8 (0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+         const auto lo = _mm_shuffle_epi8 (_mm256_castsi256_si128 (v), packRGB);
+         const auto hi = _mm_shuffle_epi8 (_mm256_extracti128_si256 (v, 1), packRGB);
+
+         _mm_storeu_si128 (reinterpret_cast<__m128i*> (p), _mm_or_si128 (lo, _mm_slli_si128 (hi, 12)));
+         _mm_storel_epi64 (reinterpret_cast<__m128i*> (p + 16), _mm_srli_si128 (hi, 4));
+     }
+
+     JUCE_SPAN_AVX2_TARGET static forcedinline Vec forceOpaque (Vec v) noexcept           { return _mm256_or_si256 (v, _mm256_set1_epi32 ((int) 0xff000000)); }
+
+     JUCE_SPAN_AVX2_TARGET static forcedinline Vec keepPadding (Vec v, Vec original) noexcept
+     {
+         const auto colourMask = _mm256_set1_epi32 (0x00ffffff);
+         return _mm256_or_si256 (_mm256_and_si256 (v, colourMask), _mm256_andnot_si256 (colourMask, original));
+     }
+
+     // These unpack and pack within each 128-bit half, so the pixel order survives a round trip
+     JUCE_SPAN_AVX2_TARGET static forcedinline Vec unpackLo (Vec v) noexcept              { return _mm256_unpacklo_epi8 (v, _mm256_setzero_si256()); }
+     JUCE_SPAN_AVX2_TARGET static forcedinline Vec unpackHi (Vec v) noexcept              { return _mm256_unpackhi_epi8 (v, _mm256_setzero_si256()); }
+     JUCE_SPAN_AVX2_TARGET static forcedinline Vec pack (Vec lo, Vec hi) noexcept         { return _mm256_packus_epi16 (lo, hi); }
+     JUCE_SPAN_AVX2_TARGET static forcedinline Vec set16 (int v) noexcept                 { return _mm256_set1_epi16 ((short) v); }
+     JUCE_SPAN_AVX2_TARGET static forcedinline Vec add16 (Vec a, Vec b) noexcept          { return _mm256_add_epi16 (a, b); }
+     JUCE_SPAN_AVX2_TARGET static forcedinline Vec sub16 (Vec a, Vec b) noexcept          { return _mm256_sub_epi16 (a, b); }
+     JUCE_SPAN_AVX2_TARGET static forcedinline Vec mulShift16 (Vec a, Vec b) noexcept     { return _mm256_srli_epi16 (_mm256_mullo_epi16 (a, b), 8); }
+     JUCE_SPAN_AVX2_TARGET static forcedinline Vec broadcastAlpha16 (Vec v) noexcept      { return _mm256_shufflehi_epi16 (_mm256_shufflelo_epi16 (v, 0xff), 0xff); }
+
+     // The compiler doesn't emit a vzeroupper before the scalar loops that finish off a span, as
+     // they're tail calls. Without it, the renderer's own SSE code would keep paying the penalty
+     // for mixing it with dirty 256-bit registers until something else cleared them.
+     JUCE_SPAN_AVX2_TARGET static forcedinline void endVectorLoop() noexcept              { _mm256_zeroupper(); }
+ };
+ #endif
+
+ /*  The same loops are needed for both instruction sets, but as the target attribute
+     can't depend on a template parameter, this macro stamps out one kernel template per set.
+ */
+ #define JUCE_DECLARE_SPAN_KERNELS(KernelName, TARGET) \
+     template <typename Ops> \
+     struct KernelName \
+     { \
+         using Vec = typename Ops::Vec; \
+      \
+         template <Layout layout> \
+         TARGET static forcedinline Vec loadDest (const uint8* p) noexcept \
+         { \
+             if constexpr (layout == Layout::rgb)         return Ops::loadRGB (p); \
+             else                                         return Ops::load (p); \
+         } \
+      \
+         template <Layout layout> \
+         TARGET static forcedinline Vec loadSource (const uint8* p) noexcept \
+         { \
+             if constexpr (layout == Layout::rgb)         return Ops::loadRGB (p); \
+             else if constexpr (layout == Layout::rgbx)   return Ops::forceOpaque (Ops::load (p)); \
+             else                                         return Ops::load (p); \
+         } \
+      \
+         template <Layout layout> \
+         TARGET static forcedinline void store (uint8* p, Vec v, Vec original) noexcept \
+         { \
+             if constexpr (layout == Layout::rgb)         Ops::storeRGB (p, v); \
+             else if constexpr (layout == Layout::rgbx)   Ops::store (p, Ops::keepPadding (v, original)); \
+             else                                         Ops::store (p, v); \
+         } \
+      \
+         template <Layout destLayout, Layout srcLayout, bool scaleSource> \
+         TARGET static void blendPixels (uint8* dest, const uint8* src, int num, uint32 extraAlpha) noexcept \
+         { \
+             const auto extra = Ops::set16 ((int) extraAlpha); \
+             const auto fullAlpha = Ops::set16 (256); \
+          \
+             for (; num >= (int) Ops::numPixels; num -= (int) Ops::numPixels) \
+             { \
+                 const auto d = loadDest<destLayout> (dest); \
+                 const auto s = loadSource<srcLayout> (src); \
+                 auto sLo = Ops::unpackLo (s); \
+                 auto sHi = Ops::unpackHi (s); \
+          \
+                 if constexpr (scaleSource) \
+                 { \
+                     sLo = Ops::mulShift16 (sLo, extra); \
+                     sHi = Ops::mulShift16 (sHi, extra); \
+                 } \
+          \
+                 const auto dLo = Ops::mulShift16 (Ops::unpackLo (d), Ops::sub16 (fullAlpha, Ops::broadcastAlpha16 (sLo))); \
+                 const auto dHi = Ops::mulShift16 (Ops::unpackHi (d), Ops::sub16 (fullAlpha, Ops::broadcastAlpha16 (sHi))); \
+                 store<destLayout> (dest, Ops::pack (Ops::add16 (sLo, dLo), Ops::add16 (sHi, dHi)), d); \
+          \
+                 dest += Ops::numPixels * spanPixelSize<destLayout>; \
+                 src  += Ops::numPixels * spanPixelSize<srcLayout>; \
+             } \
+          \
+             Ops::endVectorLoop(); \
+             blendPixelsScalar<destLayout, srcLayout> (dest, src, num, extraAlpha); \
+         } \
+      \
+         template <Layout destLayout> \
+         TARGET static void blendColour (uint8* dest, PixelARGB colour, int num) noexcept \
+         { \
+             /* three vectors always hold a whole number of pixels, whatever their size */ \
+             constexpr auto vecBytes = sizeof (Vec); \
+             constexpr auto pixelsPerBlock = (int) (3 * vecBytes) / spanPixelSize<destLayout>; \
+          \
+             uint8 colourBytes[3 * vecBytes], alphaBytes[3 * vecBytes]; \
+             fillColourPattern<destLayout> (colourBytes, alphaBytes, colour); \
+          \
+             const auto fullAlpha = Ops::set16 (256); \
+             Vec cLo[3], cHi[3], kLo[3], kHi[3]; \
+          \
+             for (size_t i = 0; i < 3; ++i) \
+             { \
+                 const auto c = Ops::load (colourBytes + i * vecBytes); \
+                 const auto a = Ops::load (alphaBytes + i * vecBytes); \
+                 cLo[i] = Ops::unpackLo (c); \
+                 cHi[i] = Ops::unpackHi (c); \
+                 kLo[i] = Ops::sub16 (fullAlpha, Ops::unpackLo (a)); \
+                 kHi[i] = Ops::sub16 (fullAlpha, Ops::unpackHi (a)); \
+             } \
+          \
+             for (; num >= pixelsPerBlock; num -= pixelsPerBlock) \
+             { \
+                 for (int i = 0; i < 3; ++i) \
+                 { \
+                     const auto d = Ops::load (dest); \
+                     Ops::store (dest, Ops::pack (Ops::add16 (cLo[i], Ops::mulShift16 (Ops::unpackLo (d), kLo[i])), \
+                                                  Ops::add16 (cHi[i], Ops::mulShift16 (Ops::unpackHi (d), kHi[i])))); \
+                     dest += vecBytes; \
+                 } \
+             } \
+          \
+             Ops::endVectorLoop(); \
+             blendColourScalar<destLayout> (dest, colour, num); \
+         } \
+     };
+
+ JUCE_DECLARE_SPAN_KERNELS (SSE2Kernels, )
+
+ #if JUCE_SPAN_BLITTERS_AVX2
+  JUCE_DECLARE_SPAN_KERNELS (AVX2Kernels, JUCE_SPAN_AVX2_TARGET)
+ #endif
+
+ #undef JUCE_DECLARE_SPAN_KERNELS
+
+ /*  The scalar version sums the four weighted pixels in one go, but as the horizontal
+     weights add up to 256, each row's sum fits in 16 bits before being weighted vertically,
+     which gives exactly the same total.
+ */
+ static void renderBilinearPixelSSE2 (PixelARGB* dest, const uint8* src, int lineStride, uint32 subPixelX, uint32 subPixelY) noexcept
+ {
+     const auto zero = _mm_setzero_si128();
+     const auto weightsX = _mm_unpacklo_epi64 (_mm_set1_epi16 ((short) (256 - subPixelX)), _mm_set1_epi16 ((short) subPixelX));
+
+     auto top    = _mm_mullo_epi16 (_mm_unpacklo_epi8 (_mm_loadl_epi64 (reinterpret_cast<const __m128i*> (src)), zero), weightsX);
+     auto bottom = _mm_mullo_epi16 (_mm_unpacklo_epi8 (_mm_loadl_epi64 (reinterpret_cast<const __m128i*> (src + lineStride)), zero), weightsX);
+     top    = _mm_add_epi16 (top,    _mm_srli_si128 (top, 8));
+     bottom = _mm_add_epi16 (bottom, _mm_srli_si128 (bottom, 8));
+
+     const auto weightTop    = _mm_set1_epi16 ((short) (256 - subPixelY));
+     const auto weightBottom = _mm_set1_epi16 ((short) subPixelY);
+
+     auto sum = _mm_add_epi32 (_mm_unpacklo_epi16 (_mm_mullo_epi16 (top, weightTop),       _mm_mulhi_epu16 (top, weightTop)),
+                               _mm_unpacklo_epi16 (_mm_mullo_epi16 (bottom, weightBottom), _mm_mulhi_epu16 (bottom, weightBottom)));
+     sum = _mm_srli_epi32 (_mm_add_epi32 (sum, _mm_set1_epi32 (256 * 128)), 16);
+     sum = _mm_packs_epi32 (sum, sum);
+
+     const auto result = _mm_cvtsi128_si32 (_mm_packus_epi16 (sum, sum));
+     memcpy (reinterpret_cast<uint8*> (dest), &result, sizeof (result));
+ }
+#endif
+
+//==============================================================================
+#if JUCE_SPAN_BLITTERS_NEON
+ /*  NEON's interleaved loads split eight pixels into one register per channel,
+     so the padding byte of an rgbx pixel can simply be stored back unchanged.
+ */
+ struct NEONKernels
+ {
+     template <Layout layout>
+     static forcedinline uint8x8x4_t load (const uint8* p) noexcept
+     {
+         if constexpr (layout == Layout::rgb)
+         {
+             const auto rgb = vld3_u8 (p);
+             return { { rgb.val[0], rgb.val[1], rgb.val[2], vdup_n_u8 (255) } };
+         }
+         else
+         {
+             return vld4_u8 (p);
+         }
+     }
+
+     template <Layout layout>
+     static forcedinline void store (uint8* p, const uint8x8x4_t& v) noexcept
+     {
+         if constexpr (layout == Layout::rgb)
+             vst3_u8 (p, uint8x8x3_t { { v.val[0], v.val[1], v.val[2] } });
+         else
+             vst4_u8 (p, v);
+     }
+
+     static forcedinline uint8x8_t blendChannel (uint16x8_t s, uint8x8_t d, uint16x8_t k) noexcept
+     {
+         return vqmovn_u16 (vaddq_u16 (s, vshrq_n_u16 (vmulq_u16 (vmovl_u8 (d), k), 8)));
+     }
+
+     template <Layout destLayout, Layout srcLayout, bool scaleSource>
+     static void blendPixels (uint8* dest, const uint8* src, int num, uint32 extraAlpha) noexcept
+     {
+         constexpr int numChannels = destLayout == Layout::argb ? 4 : 3;
+         const auto extra = vdupq_n_u16 ((uint16) extraAlpha);
+
+         for (; num >= 8; num -= 8)
+         {
+             auto d = load<destLayout> (dest);
+             auto s = load<srcLayout> (src);
+
+             if constexpr (srcLayout == Layout::rgbx)
+                 s.val[3] = vdup_n_u8 (255);
+
+             if constexpr (scaleSource)
+                 for (auto& channel : s.val)
+                     channel = vshrn_n_u16 (vmulq_u16 (vmovl_u8 (channel), extra), 8);
+
+             const auto k = vsubq_u16 (vdupq_n_u16 (256), vmovl_u8 (s.val[3]));
+
+             for (int i = 0; i < numChannels; ++i)
+                 d.val[i] = blendChannel (vmovl_u8 (s.val[i]), d.val[i], k);
+
+             store<destLayout> (dest, d);
+             dest += 8 * spanPixelSize<destLayout>;
+             src  += 8 * spanPixelSize<srcLayout>;
+         }
+
+         blendPixelsScalar<destLayout, srcLayout> (dest, src, num, extraAlpha);
+     }
+
+     template <Layout destLayout>
+     static void blendColour (uint8* dest, PixelARGB colour, int num) noexcept
+     {
+         constexpr int numChannels = destLayout == Layout::argb ? 4 : 3;
+
+         uint8 colourBytes[spanPixelSize<destLayout>], alphaBytes[spanPixelSize<destLayout>];
+         fillColourPattern<destLayout> (colourBytes, alphaBytes, colour);
+
+         const auto k = vdupq_n_u16 ((uint16) (256 - colour.getAlpha()));
+         uint16x8_t c[4];
+
+         for (int i = 0; i < numChannels; ++i)
+             c[i] = vdupq_n_u16 (colourBytes[i]);
+
+         for (; num >= 8; num -= 8)
+         {
+             auto d = load<destLayout> (dest);
+
+             for (int i = 0; i < numChannels; ++i)
+                 d.val[i] = blendChannel (c[i], d.val[i], k);
+
+             store<destLayout> (dest, d);
+             dest += 8 * spanPixelSize<destLayout>;
+         }
+
+         blendColourScalar<destLayout> (dest, colour, num);
+     }
+ };
+
+ // See renderBilinearPixelSSE2() for why summing each row first gives the same result
+ static void renderBilinearPixelNEON (PixelARGB* dest, const uint8* src, int lineStride, uint32 subPixelX, uint32 subPixelY) noexcept
+ {
+     const auto weightsX = vcombine_u16 (vdup_n_u16 ((uint16) (256 - subPixelX)), vdup_n_u16 ((uint16) subPixelX));
+     const auto top    = vmulq_u16 (vmovl_u8 (vld1_u8 (src)), weightsX);
+     const auto bottom = vmulq_u16 (vmovl_u8 (vld1_u8 (src + lineStride)), weightsX);
+
+     auto sum = vmull_n_u16 (vadd_u16 (vget_low_u16 (top), vget_high_u16 (top)), (uint16) (256 - subPixelY));
+     sum = vmlal_n_u16 (sum, vadd_u16 (vget_low_u16 (bottom), vget_high_u16 (bottom)), (uint16) subPixelY);
+
+     const auto narrowed = vshrn_n_u32 (vaddq_u32 (sum, vdupq_n_u32 (256 * 128)), 16);
+     const auto result = vget_lane_u32 (vreinterpret_u32_u8 (vmovn_u16 (vcombine_u16 (narrowed, narrowed))), 0);
+     memcpy (reinterpret_cast<uint8*> (dest), &result, sizeof (result));
+ }
+#endif
+
+//==============================================================================
+static std::atomic<InstructionSet>& getActiveInstructionSet() noexcept
+{
+    static std::atomic<InstructionSet> level {
+       #if JUCE_SPAN_BLITTERS_AVX2
+        SystemStats::hasAVX2() ? InstructionSet::avx2 : InstructionSet::sse2
+       #elif JUCE_SPAN_BLITTERS_SSE2
+        InstructionSet::sse2
+       #elif JUCE_SPAN_BLITTERS_NEON
+        InstructionSet::neon
+       #else
+        InstructionSet::scalar
+       #endif
+    };
+
+    return level;
+}
+
+Array<InstructionSet> JUCE_CALLTYPE getAvailableInstructionSets()
+{
+    Array<InstructionSet> sets { InstructionSet::scalar };
+
+   #if JUCE_SPAN_BLITTERS_SSE2
+    sets.add (InstructionSet::sse2);
+   #endif
+
+   #if JUCE_SPAN_BLITTERS_AVX2
+    if (SystemStats::hasAVX2())
+        sets.add (InstructionSet::avx2);
+   #endif
+
+   #if JUCE_SPAN_BLITTERS_NEON
+    sets.add (InstructionSet::neon);
+   #endif
+
+    return sets;
+}
+
+InstructionSet JUCE_CALLTYPE getInstructionSet() noexcept
+{
+    return getActiveInstructionSet().load();
+}
+
+InstructionSet JUCE_CALLTYPE setInstructionSet (InstructionSet newSet) noexcept
+{
+    jassert (getAvailableInstructionSets().contains (newSet));
+    return getActiveInstructionSet().exchange (newSet);
+}
+
+bool JUCE_CALLTYPE blendColourSpan (uint8* dest, Layout destLayout, PixelARGB colour, int numPixels) noexcept
+{
+    [[maybe_unused]] const auto level = getActiveInstructionSet().load (std::memory_order_relaxed);
+
+   #if JUCE_SPAN_BLITTERS_AVX2
+    if (level == InstructionSet::avx2)
+        return SpanDispatcher<AVX2Kernels<AVX2Ops>>::blendColour (dest, destLayout, colour, numPixels);
+   #endif
+
+   #if JUCE_SPAN_BLITTERS_SSE2
+    if (level == InstructionSet::sse2)
+        return SpanDispatcher<SSE2Kernels<SSE2Ops>>::blendColour (dest, destLayout, colour, numPixels);
+   #endif
+
+   #if JUCE_SPAN_BLITTERS_NEON
+    if (level == InstructionSet::neon)
+        return SpanDispatcher<NEONKernels>::blendColour (dest, destLayout, colour, numPixels);
+   #endif
+
+    return false;
+}
+
+bool JUCE_CALLTYPE blendSpan (uint8* dest, Layout destLayout, const uint8* src, Layout srcLayout,
+                              int numPixels, uint32 extraAlpha) noexcept
+{
+    [[maybe_unused]] const auto level = getActiveInstructionSet().load (std::memory_order_relaxed);
+
+    if ((destLayout == Layout::argb) != (srcLayout == Layout::argb) && ! rgbMatchesARGBByteOrder)
+        return false;
+
+    jassert (extraAlpha <= 256);
+
+   #if JUCE_SPAN_BLITTERS_AVX2
+    if (level == InstructionSet::avx2)
+        return SpanDispatcher<AVX2Kernels<AVX2Ops>>::blend (dest, destLayout, src, srcLayout, numPixels, extraAlpha);
+   #endif
+
+   #if JUCE_SPAN_BLITTERS_SSE2
+    if (level == InstructionSet::sse2)
+        return SpanDispatcher<SSE2Kernels<SSE2Ops>>::blend (dest, destLayout, src, srcLayout, numPixels, extraAlpha);
+   #endif
+
+   #if JUCE_SPAN_BLITTERS_NEON
+    if (level == InstructionSet::neon)
+        return SpanDispatcher<NEONKernels>::blend (dest, destLayout, src, srcLayout, numPixels, extraAlpha);
+   #endif
+
+    return false;
+}
+
+bool JUCE_CALLTYPE renderBilinearPixel (PixelARGB* dest, const uint8* src, int pixelStride, int lineStride,
+                                        uint32 subPixelX, uint32 subPixelY) noexcept
+{
+    [[maybe_unused]] const auto level = getActiveInstructionSet().load (std::memory_order_relaxed);
+
+    if (pixelStride != (int) sizeof (PixelARGB))
+        return false;
+
+    jassert (subPixelX < 256 && subPixelY < 256);
+
+   #if JUCE_SPAN_BLITTERS_SSE2
+    if (level != InstructionSet::scalar)
+    {
+        renderBilinearPixelSSE2 (dest, src, lineStride, subPixelX, subPixelY);
+        return true;
+    }
+   #endif
+
+   #if JUCE_SPAN_BLITTERS_NEON
+    if (level == InstructionSet::neon)
+    {
+        renderBilinearPixelNEON (dest, src, lineStride, subPixelX, subPixelY);
+        return true;
+    }
+   #endif
+
+    return false;
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class SpanBlittersTests final : public UnitTest
+{
+public:
+    SpanBlittersTests()
+        : UnitTest ("SpanBlitters", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Unsupported pixel formats are left to the caller");
+        {
+            PixelAlpha dest[16] {};
+            PixelARGB src[16] {};
+
+            expect (! blendColourSpan (dest, 1, PixelARGB (128, 10, 20, 30), 16));
+            expect (! blendSpan (dest, 1, src, 4, 16, 256));
+            expect (! blendSpan (src, 4, dest, 1, 16, 256));
+        }
+
+        const auto detectedSet = getInstructionSet();
+
+        for (auto testSet : getAvailableInstructionSets())
+        {
+            if (testSet == InstructionSet::scalar)
+                continue;
+
+            const auto setName = getName (testSet);
+            beginTest ("Spans match scalar results (" + setName + ")");
+            setInstructionSet (testSet);
+
+            auto r = getRandom();
+
+            for (auto destLayout : { Layout::argb, Layout::rgbx, Layout::rgb })
+            {
+                checkColourSpans (r, destLayout);
+
+                for (auto srcLayout : { Layout::argb, Layout::rgbx, Layout::rgb })
+                    checkSpans (r, destLayout, srcLayout);
+            }
+
+            checkBilinearPixels (r);
+
+            beginTest ("Rendering matches scalar results (" + setName + ")");
+
+            for (auto format : { Image::ARGB, Image::RGB })
+            {
+                setInstructionSet (InstructionSet::scalar);
+                const auto expected = renderScene (format);
+
+                setInstructionSet (testSet);
+                const auto actual = renderScene (format);
+
+                expect (imagesAreIdentical (expected, actual));
+            }
+        }
+
+        setInstructionSet (detectedSet);
+    }
+
+private:
+    struct ScalarKernels
+    {
+        template <Layout destLayout, Layout srcLayout, bool>
+        static void blendPixels (uint8* dest, const uint8* src, int num, uint32 extraAlpha) noexcept
+        {
+            blendPixelsScalar<destLayout, srcLayout> (dest, src, num, extraAlpha);
+        }
+
+        template <Layout destLayout>
+        static void blendColour (uint8* dest, PixelARGB colour, int num) noexcept
+        {
+            blendColourScalar<destLayout> (dest, colour, num);
+        }
+    };
+
+    static String getName (InstructionSet set)
+    {
+        switch (set)
+        {
+            case InstructionSet::scalar:    return "scalar";
+            case InstructionSet::sse2:      return "SSE2";
+            case InstructionSet::avx2:      return "AVX2";
+            case InstructionSet::neon:      return "NEON";
+        }
+
+        return {};
+    }
+
+    static int getPixelSize (Layout layout)     { return layout == Layout::rgb ? 3 : 4; }
+
+    // Picks the extreme values more often than a uniform distribution would, as that's where rounding goes wrong
+    static uint8 randomByte (Random& r)
+    {
+        switch (r.nextInt (4))
+        {
+            case 0:     return 0;
+            case 1:     return 255;
+            default:    return (uint8) r.nextInt (256);
+        }
+    }
+
+    static std::vector<uint8> randomBytes (Random& r, int num)
+    {
+        std::vector<uint8> bytes ((size_t) num);
+
+        for (auto& b : bytes)
+            b = randomByte (r);
+
+        return bytes;
+    }
+
+    void checkColourSpans (Random& r, Layout destLayout)
+    {
+        for (int i = 0; i < 50; ++i)
+        {
+            const auto num = r.nextInt (100);
+            const PixelARGB colour (randomByte (r), randomByte (r), randomByte (r), randomByte (r));
+
+            auto expected = randomBytes (r, num * getPixelSize (destLayout) + 1);
+            auto actual = expected;
+
+            SpanDispatcher<ScalarKernels>::blendColour (expected.data(), destLayout, colour, num);
+            expect (blendColourSpan (actual.data(), destLayout, colour, num));
+            expect (expected == actual);
+        }
+    }
+
+    void checkSpans (Random& r, Layout destLayout, Layout srcLayout)
+    {
+        for (int i = 0; i < 50; ++i)
+        {
+            const auto num = r.nextInt (100);
+            const auto extraAlpha = r.nextBool() ? 256u : (uint32) r.nextInt (256);
+            const auto src = randomBytes (r, num * getPixelSize (srcLayout));
+
+            auto expected = randomBytes (r, num * getPixelSize (destLayout) + 1);
+            auto actual = expected;
+
+            SpanDispatcher<ScalarKernels>::blend (expected.data(), destLayout, src.data(), srcLayout, num, extraAlpha);
+
+            if (blendSpan (actual.data(), destLayout, src.data(), srcLayout, num, extraAlpha))
+                expect (expected == actual);
+            else
+                expect ((destLayout == Layout::argb) != (srcLayout == Layout::argb) && ! rgbMatchesARGBByteOrder);
+        }
+    }
+
+    void checkBilinearPixels (Random& r)
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            const auto src = randomBytes (r, 16);
+            const auto subPixelX = (uint32) r.nextInt (256);
+            const auto subPixelY = (uint32) r.nextInt (256);
+
+            int expected[4];
+
+            for (int c = 0; c < 4; ++c)
+                expected[c] = (int) ((256 * 128 + (256 - subPixelX) * (256 - subPixelY) * src[(size_t) c]
+                                         + subPixelX * (256 - subPixelY) * src[(size_t) c + 4]
+                                         + (256 - subPixelX) * subPixelY * src[(size_t) c + 8]
+                                         + subPixelX * subPixelY * src[(size_t) c + 12]) >> 16);
+
+            PixelARGB actual;
+            expect (renderBilinearPixel (&actual, src.data(), 4, 8, subPixelX, subPixelY));
+
+            const auto* actualBytes = reinterpret_cast<const uint8*> (&actual);
+
+            for (int c = 0; c < 4; ++c)
+                expectEquals ((int) actualBytes[c], expected[c]);
+        }
+    }
+
+    static Image createSourceImage (Image::PixelFormat format, int w, int h, Random& r)
+    {
+        Image image (format, w, h, false, SoftwareImageType());
+
+        for (int y = 0; y < h; ++y)
+            for (int x = 0; x < w; ++x)
+                image.setPixelAt (x, y, Colour ((uint32) r.nextInt()).withAlpha (randomByte (r)));
+
+        return image;
+    }
+
+    // Exercises each of the fillers that can use the vectorised code, at a range of span lengths
+    static Image renderScene (Image::PixelFormat format)
+    {
+        Random r (0x5eed);
+        Image image (format, 301, 203, true, SoftwareImageType());
+        Graphics g (image);
+
+        g.fillAll (Colours::lightgrey);
+
+        for (int i = 0; i < 40; ++i)
+        {
+            g.setColour (Colour ((uint32) r.nextInt()).withAlpha (randomByte (r)));
+            g.fillRect (Rectangle<float> (r.nextFloat() * 280.0f, r.nextFloat() * 180.0f, r.nextFloat() * 120.0f, r.nextFloat() * 90.0f));
+        }
+
+        g.setGradientFill (ColourGradient (Colours::red.withAlpha (0.7f), 10.0f, 10.0f, Colours::blue, 290.0f, 40.0f, false));
+        g.fillEllipse (5.0f, 5.0f, 290.0f, 120.0f);
+
+        g.setGradientFill (ColourGradient (Colours::yellow, 0.0f, 50.0f, Colours::green.withAlpha (0.2f), 0.0f, 180.0f, false));
+        g.fillRect (200, 20, 90, 170);
+
+        g.setGradientFill (ColourGradient (Colours::white, 150.0f, 100.0f, Colours::transparentBlack, 230.0f, 150.0f, true));
+        g.fillRect (image.getBounds());
+
+        for (auto sourceFormat : { Image::ARGB, Image::RGB })
+        {
+            const auto source = createSourceImage (sourceFormat, 67, 41, r);
+
+            g.drawImageAt (source, 3, 150);
+            g.setOpacity (0.6f);
+            g.drawImageAt (source, 60, 140);
+            g.setOpacity (1.0f);
+
+            g.setFillType (FillType (source, AffineTransform::translation (7.0f, 3.0f)));
+            g.fillRect (100, 20, 170, 60);
+
+            for (auto quality : { Graphics::lowResamplingQuality, Graphics::mediumResamplingQuality })
+            {
+                g.setImageResamplingQuality (quality);
+                g.setOpacity (r.nextBool() ? 1.0f : 0.4f);
+                g.drawImageTransformed (source, AffineTransform::rotation (0.3f).scaled (2.3f, 1.7f).translated (120.0f, 60.0f));
+            }
+
+            g.setOpacity (1.0f);
+
+            {
+                Graphics::ScopedSaveState s (g);
+                g.addTransform (AffineTransform::rotation (-0.4f, 150.0f, 100.0f));
+                g.setGradientFill (ColourGradient (Colours::orange, 150.0f, 100.0f, Colours::purple.withAlpha (0.5f), 200.0f, 100.0f, true));
+                g.fillRect (40, 30, 220, 150);
+            }
+        }
+
+        return image;
+    }
+
+    static bool imagesAreIdentical (const Image& a, const Image& b)
+    {
+        const Image::BitmapData da (a, Image::BitmapData::readOnly);
+        const Image::BitmapData db (b, Image::BitmapData::readOnly);
+
+        for (int y = 0; y < da.height; ++y)
+            if (memcmp (da.getLinePointer (y), db.getLinePointer (y), (size_t) (da.width * da.pixelStride)) != 0)
+                return false;
+
+        return true;
+    }
+};
+
+static SpanBlittersTests spanBlittersTests;
+
+#endif
+
+} // namespace juce::RenderingHelpers::SpanBlitters
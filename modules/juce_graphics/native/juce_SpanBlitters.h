@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::RenderingHelpers
+{
+
+/** Vectorised versions of the inner pixel loops used by the EdgeTableFillers.
+
+    Each of these produces exactly the same bytes as running the equivalent
+    PixelARGB or PixelRGB blend() call over every pixel, so the software renderer's
+    output doesn't depend on which instruction set ends up being used. An AVX2
+    version is chosen at runtime if the CPU has it, otherwise SSE2 or NEON are used.
+
+    The functions return false if they can't handle a particular request, e.g. for
+    PixelAlpha images, spans that are too short to be worth it, or platforms without
+    any vector instructions, in which case the caller should fall back to its own loop.
+*/
+namespace SpanBlitters
+{
+    /** The memory layouts of pixel runs that the vectorised loops can handle. */
+    enum class Layout
+    {
+        unsupported,
+        argb,       /**< PixelARGB, 4 bytes per pixel. */
+        rgbx,       /**< PixelRGB padded out to 4 bytes per pixel, as used by some native framebuffers. */
+        rgb         /**< Tightly packed 3-byte PixelRGB. */
+    };
+
+    template <class PixelType>
+    constexpr Layout getLayout (const PixelType*, int) noexcept               { return Layout::unsupported; }
+    constexpr Layout getLayout (const PixelARGB*, int pixelStride) noexcept   { return pixelStride == 4 ? Layout::argb : Layout::unsupported; }
+
+    constexpr Layout getLayout (const PixelRGB*, int pixelStride) noexcept
+    {
+        return pixelStride == 3 ? Layout::rgb
+                                : (pixelStride == 4 ? Layout::rgbx : Layout::unsupported);
+    }
+
+    /** Spans shorter than this are left to the scalar loops, as they'd gain nothing. */
+    constexpr int minimumSpanLength = 8;
+
+    /** The instruction sets that the span functions may be using. */
+    enum class InstructionSet
+    {
+        scalar,     /**< No vector instructions, so the span functions all return false. */
+        sse2,
+        avx2,
+        neon
+    };
+
+    /** Returns the instruction sets that this build can use on the current CPU, starting with scalar. */
+    JUCE_API Array<InstructionSet> JUCE_CALLTYPE getAvailableInstructionSets();
+
+    /** Returns the instruction set that the span functions are currently using. */
+    JUCE_API InstructionSet JUCE_CALLTYPE getInstructionSet() noexcept;
+
+    /** Switches the span functions to a different instruction set, and returns the one that
+        was in use before.
+
+        This affects every renderer in the process, and is meant for tests and benchmarks
+        that compare the kernels. The set must be one of getAvailableInstructionSets().
+    */
+    JUCE_API InstructionSet JUCE_CALLTYPE setInstructionSet (InstructionSet) noexcept;
+
+    /** Performs dest[i].blend (colour) over a run of pixels. */
+    JUCE_API bool JUCE_CALLTYPE blendColourSpan (uint8* dest, Layout destLayout, PixelARGB colour, int numPixels) noexcept;
+
+    /** Performs dest[i].blend (src[i], extraAlpha) over a run of pixels.
+        An extraAlpha of 256 gives the same result as dest[i].blend (src[i]).
+    */
+    JUCE_API bool JUCE_CALLTYPE blendSpan (uint8* dest, Layout destLayout,
+                                           const uint8* src, Layout srcLayout,
+                                           int numPixels, uint32 extraAlpha) noexcept;
+
+    /** Calculates the bilinear average of the 2x2 block of ARGB pixels starting at src,
+        rounding in the same way as TransformedImageFill's scalar code.
+    */
+    JUCE_API bool JUCE_CALLTYPE renderBilinearPixel (PixelARGB* dest, const uint8* src, int pixelStride, int lineStride,
+                                                     uint32 subPixelX, uint32 subPixelY) noexcept;
+
+    //==============================================================================
+    template <class DestPixelType>
+    bool blendColourSpan (DestPixelType* dest, int destStride, PixelARGB colour, int numPixels) noexcept
+    {
+        const auto destLayout = getLayout (dest, destStride);
+
+        return numPixels >= minimumSpanLength
+                && destLayout != Layout::unsupported
+                && blendColourSpan (reinterpret_cast<uint8*> (dest), destLayout, colour, numPixels);
+    }
+
+    template <class DestPixelType, class SrcPixelType>
+    bool blendSpan (DestPixelType* dest, int destStride, const SrcPixelType* src, int srcStride,
+                    int numPixels, uint32 extraAlpha) noexcept
+    {
+        const auto destLayout = getLayout (dest, destStride);
+        const auto srcLayout  = getLayout (src, srcStride);
+
+        return numPixels >= minimumSpanLength
+                && destLayout != Layout::unsupported
+                && srcLayout != Layout::unsupported
+                && blendSpan (reinterpret_cast<uint8*> (dest), destLayout,
+                              reinterpret_cast<const uint8*> (src), srcLayout,
+                              numPixels, extraAlpha);
+    }
+}
+
+} // namespace juce::RenderingHelpers
@@ -232,6 +232,7 @@ void Component::setVisible (bool shouldBeVisible)
 
         const WeakReference<Component> safePointer (this);
         flags.visibleFlag = shouldBeVisible;
+        flags.repaintPendingFlag = false;
 
         if (shouldBeVisible)
             repaint();
@@ -814,6 +815,7 @@ void Component::setBounds (int x, int y, int w, int h)
     if (wasMoved || wasResized)
     {
         const bool showing = isShowing();
+        flags.repaintPendingFlag = false;
 
         if (showing)
         {
@@ -994,29 +996,33 @@ void Component::setTransform (const AffineTransform& newTransform)
     // and there will be all sorts of maths errors when converting coordinates.
     jassert (! newTransform.isSingularity());
 
+    const auto repaintAfterChange = [this]
+    {
+        flags.repaintPendingFlag = false;
+        repaint();
+        sendMovedResizedMessages (false, false);
+    };
+
     if (newTransform.isIdentity())
     {
         if (affineTransform != nullptr)
         {
             repaint();
             affineTransform.reset();
-            repaint();
-            sendMovedResizedMessages (false, false);
+            repaintAfterChange();
         }
     }
     else if (affineTransform == nullptr)
     {
         repaint();
         affineTransform.reset (new AffineTransform (newTransform));
-        repaint();
-        sendMovedResizedMessages (false, false);
+        repaintAfterChange();
     }
     else if (*affineTransform != newTransform)
     {
         repaint();
         *affineTransform = newTransform;
-        repaint();
-        sendMovedResizedMessages (false, false);
+        repaintAfterChange();
     }
 }
 
@@ -1164,6 +1170,7 @@ void Component::addChildComponent (Component& child, int zOrder)
             child.removeFromDesktop();
 
         child.parentComponent = this;
+        child.flags.repaintPendingFlag = false;
 
         if (child.isVisible())
             child.repaintParent();
@@ -1246,6 +1253,7 @@ Component* Component::removeChildComponent (int index, bool sendParentEvents, bo
 
         childComponentList.remove (index);
         child->parentComponent = nullptr;
+        child->flags.repaintPendingFlag = false;
 
         detail::ComponentHelpers::releaseAllCachedImageResources (*child);
 
@@ -1610,6 +1618,16 @@ void Component::internalRepaintUnchecked (Rectangle<int> area, bool isEntireComp
 
     if (flags.visibleFlag)
     {
+       #if JUCE_COALESCE_REPAINTS
+        // The pending flag shares a word with all the other flags, so only the message thread
+        // uses it. A repaint from a thread that's holding a MessageManagerLock isn't coalesced.
+        const auto canCoalesce = MessageManager::existsAndIsCurrentThread();
+
+        // The whole component is already waiting to be painted, so there's nothing more to do
+        if (canCoalesce && flags.repaintPendingFlag)
+            return;
+       #endif
+
         if (cachedImage != nullptr)
             if (! (isEntireComponent ? cachedImage->invalidateAll()
                                      : cachedImage->invalidate (area)))
@@ -1633,7 +1651,16 @@ void Component::internalRepaintUnchecked (Rectangle<int> area, bool isEntireComp
         else
         {
             if (parentComponent != nullptr)
+            {
+               #if JUCE_COALESCE_REPAINTS
+                // Remember that the whole component is now waiting to be painted, so that
+                // further repaints can be skipped until it has been
+                if (canCoalesce)
+                    flags.repaintPendingFlag = isEntireComponent;
+               #endif
+
                 parentComponent->internalRepaint (detail::ComponentHelpers::convertToParentSpace (*this, area));
+            }
         }
     }
 }
@@ -1678,6 +1705,17 @@ void Component::paintComponentAndChildren (Graphics& g)
             paint (g);
     }
 
+    const auto isOccluder = [] (const Component& c)
+    {
+        return c.flags.opaqueFlag && c.flags.visibleFlag && c.affineTransform == nullptr && c.componentTransparency == 0;
+    };
+
+    // Only children below the top-most opaque child can be covered by one
+    auto lastOccluderIndex = childComponentList.size() - 1;
+
+    while (lastOccluderIndex >= 0 && ! isOccluder (*childComponentList.getUnchecked (lastOccluderIndex)))
+        --lastOccluderIndex;
+
     for (int i = 0; i < childComponentList.size(); ++i)
     {
         auto& child = *childComponentList.getUnchecked (i);
@@ -1703,20 +1741,27 @@ void Component::paintComponentAndChildren (Graphics& g)
                 }
                 else if (g.reduceClipRegion (child.getBounds()))
                 {
-                    bool nothingClipped = true;
+                    const auto childBounds = child.getBounds();
+                    bool nothingClipped = true, isHidden = false;
 
-                    for (int j = i + 1; j < childComponentList.size(); ++j)
+                    for (int j = i + 1; j <= lastOccluderIndex; ++j)
                     {
                         auto& sibling = *childComponentList.getUnchecked (j);
 
-                        if (sibling.flags.opaqueFlag && sibling.isVisible() && sibling.affineTransform == nullptr)
+                        if (isOccluder (sibling) && sibling.getBounds().intersects (childBounds))
                         {
+                            if (sibling.getBounds().contains (childBounds))
+                            {
+                                isHidden = true;
+                                break;
+                            }
+
                             nothingClipped = false;
                             g.excludeClipRegion (sibling.getBounds());
                         }
                     }
 
-                    if (nothingClipped || ! g.isClipEmpty())
+                    if (! isHidden && (nothingClipped || ! g.isClipEmpty()))
                         child.paintWithinParentContext (g);
                 }
             }
@@ -1741,6 +1786,9 @@ void Component::paintEntireComponent (Graphics& g, bool ignoreAlphaLevel)
     flags.isInsidePaintCall = true;
    #endif
 
+    const PaintProfiler::ScopedComponentPaint profiledPaint (*this);
+    flags.repaintPendingFlag = false;
+
     if (effect != nullptr)
     {
         auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
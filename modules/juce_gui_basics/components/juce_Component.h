@@ -2609,6 +2609,7 @@ private:
         bool viewportIgnoreDragFlag       : 1;
         bool accessibilityIgnoredFlag     : 1;
         bool cachedMouseInsideComponent   : 1;
+        bool repaintPendingFlag           : 1;
        #if JUCE_DEBUG
         bool isInsidePaintCall            : 1;
        #endif
@@ -0,0 +1,248 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+DisplayListCachedComponentImage::DisplayListCachedComponentImage (Component& c)  : owner (c) {}
+
+DisplayListCachedComponentImage::~DisplayListCachedComponentImage()
+{
+    cancelPendingUpdate();
+}
+
+void DisplayListCachedComponentImage::record (DisplayList& list) const
+{
+    LowLevelGraphicsDisplayListRecorder recorder (list, owner.getLocalBounds(), scale);
+    Graphics g (recorder);
+    owner.paintEntireComponent (g, true);
+}
+
+void DisplayListCachedComponentImage::paint (Graphics& g)
+{
+    auto& context = g.getInternalContext();
+    scale = context.getPhysicalPixelScaleFactor();
+
+    updateNowIfNeeded();
+
+    if (! hasRecording)
+    {
+        record (displayList);
+        hasRecording = true;
+    }
+
+    auto alpha = owner.getAlpha();
+
+    if (alpha < 1.0f)
+        context.beginTransparencyLayer (alpha);
+
+    displayList.replay (context, g.getClipBounds());
+
+    if (alpha < 1.0f)
+        context.endTransparencyLayer();
+}
+
+void DisplayListCachedComponentImage::updateNowIfNeeded()
+{
+    handleUpdateNowIfNeeded();
+}
+
+void DisplayListCachedComponentImage::handleAsyncUpdate()
+{
+    if (! hasRecording)
+        return;
+
+    DisplayList newList;
+    record (newList);
+
+    auto changedArea = DisplayList::findChangedArea (displayList, newList);
+    displayList = std::move (newList);
+
+    const ScopedValueSetter<bool> svs (isRepaintingChanges, true);
+
+    for (auto& area : changedArea)
+        owner.repaint (area);
+}
+
+bool DisplayListCachedComponentImage::invalidateAll()
+{
+    return invalidate (owner.getLocalBounds());
+}
+
+bool DisplayListCachedComponentImage::invalidate (const Rectangle<int>&)
+{
+    // Until the component has been recorded, there's nothing to compare a new
+    // recording with, so the repaint just goes ahead as normal.
+    if (isRepaintingChanges || ! hasRecording)
+        return true;
+
+    triggerAsyncUpdate();
+    return false;
+}
+
+void DisplayListCachedComponentImage::releaseResources()
+{
+    cancelPendingUpdate();
+    displayList.clear();
+    hasRecording = false;
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct DisplayListCachedComponentImageTests final : public UnitTest
+{
+    DisplayListCachedComponentImageTests()
+        : UnitTest ("DisplayListCachedComponentImage", UnitTestCategories::gui)
+    {}
+
+    void runTest() override
+    {
+        ScopedJuceInitialiser_GUI libraryInitialiser;
+        const MessageManagerLock mml;
+
+        TestParent cached, reference;
+        auto* cache = new DisplayListCachedComponentImage (cached.child);
+        cached.child.setCachedComponentImage (cache);
+
+        auto* invalidations = new InvalidationRecorder();
+        cached.setCachedComponentImage (invalidations);
+
+        beginTest ("The component is drawn as if it wasn't cached");
+        {
+            expect (snapshotsMatch (cached, reference));
+            expectEquals (cached.child.numPaints, 1);
+            expect (! cache->getDisplayList().isEmpty());
+        }
+
+        beginTest ("Drawing the component again doesn't call paint()");
+        {
+            expect (snapshotsMatch (cached, reference));
+            expect (snapshotsMatch (cached, reference, 2.0f));
+            expectEquals (cached.child.numPaints, 1);
+        }
+
+        beginTest ("Repainting only invalidates the area that has changed");
+        {
+            invalidations->areas.clear();
+
+            for (auto* parent : { &cached, &reference })
+            {
+                parent->child.rightColour = Colours::orange;
+                parent->child.repaint();
+            }
+
+            expect (invalidations->areas.isEmpty());
+
+            cache->updateNowIfNeeded();
+            expectEquals (cached.child.numPaints, 2);
+
+            auto rightHalf = cached.child.getBounds().withTrimmedLeft (cached.child.getWidth() / 2);
+            expect (! invalidations->areas.isEmpty());
+            expect (invalidations->areas.containsRectangle (rightHalf.reduced (3)));
+            expect (! invalidations->areas.intersects (cached.child.getBounds().withWidth (cached.child.getWidth() / 2 - 2)));
+
+            expect (snapshotsMatch (cached, reference));
+            expectEquals (cached.child.numPaints, 2);
+        }
+
+        beginTest ("Repainting without changing anything doesn't invalidate anything");
+        {
+            invalidations->areas.clear();
+            cached.child.repaint();
+            cache->updateNowIfNeeded();
+
+            expect (invalidations->areas.isEmpty());
+            expectEquals (cached.child.numPaints, 3);
+        }
+    }
+
+    struct TestChild final  : public Component
+    {
+        void paint (Graphics& g) override
+        {
+            ++numPaints;
+            auto bounds = getLocalBounds().toFloat();
+            g.setColour (Colours::darkblue);
+            g.fillRoundedRectangle (bounds.removeFromLeft (bounds.getWidth() / 2).reduced (3.0f), 4.0f);
+            g.setColour (rightColour);
+            g.fillEllipse (bounds.reduced (3.0f));
+        }
+
+        Colour rightColour { Colours::green };
+        int numPaints = 0;
+    };
+
+    struct TestParent final  : public Component
+    {
+        TestParent()
+        {
+            setBounds (0, 0, 200, 100);
+            child.setBounds (15, 20, 110, 50);
+            addAndMakeVisible (child);
+            setVisible (true);
+        }
+
+        void paint (Graphics& g) override
+        {
+            g.fillAll (Colours::white);
+        }
+
+        TestChild child;
+    };
+
+    struct InvalidationRecorder final  : public CachedComponentImage
+    {
+        void paint (Graphics&) override {}
+        bool invalidateAll() override                           { areas.add ({ 0, 0, 200, 100 }); return false; }
+        bool invalidate (const Rectangle<int>& area) override   { areas.add (area); return false; }
+        void releaseResources() override {}
+
+        RectangleList<int> areas;
+    };
+
+    static bool snapshotsMatch (Component& a, Component& b, float scale = 1.0f)
+    {
+        auto imageA = a.createComponentSnapshot (a.getLocalBounds(), true, scale);
+        auto imageB = b.createComponentSnapshot (b.getLocalBounds(), true, scale);
+
+        const Image::BitmapData dataA (imageA, Image::BitmapData::readOnly);
+        const Image::BitmapData dataB (imageB, Image::BitmapData::readOnly);
+
+        for (int y = 0; y < dataA.height; ++y)
+            if (memcmp (dataA.getLinePointer (y), dataB.getLinePointer (y), (size_t) (dataA.width * dataA.pixelStride)) != 0)
+                return false;
+
+        return true;
+    }
+};
+
+static DisplayListCachedComponentImageTests displayListCachedComponentImageTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A CachedComponentImage which stores a component's drawing as a DisplayList
+    rather than as a bitmap.
+
+    Once the component has been recorded, it can be drawn again (e.g. when its parent
+    is repainted, or when it's drawn with a different transform) by replaying the list,
+    without calling its paint() method.
+
+    When the component is repainted, its drawing is recorded again, and the new list
+    is compared with the old one so that only the areas that actually look different
+    get passed on to be repainted. This happens asynchronously, or when
+    updateNowIfNeeded() is called.
+
+    Because the list is resolution-independent, it isn't recorded again when the
+    component is drawn at a different scale. Use Component::setBufferedToImage()
+    instead if the component's drawing is very expensive to replay, e.g. if it contains
+    large numbers of paths.
+
+    To use it, create one and pass it to Component::setCachedComponentImage().
+
+    @see DisplayList, Component::setCachedComponentImage
+
+    @tags{GUI}
+*/
+class JUCE_API  DisplayListCachedComponentImage  : public CachedComponentImage,
+                                                   private AsyncUpdater
+{
+public:
+    //==============================================================================
+    /** Creates a cache for the given component. */
+    explicit DisplayListCachedComponentImage (Component& componentToCache);
+
+    /** Destructor. */
+    ~DisplayListCachedComponentImage() override;
+
+    //==============================================================================
+    /** If the component has been repainted since it was last recorded, this records it
+        again now and repaints any areas which have changed, rather than waiting for
+        this to happen asynchronously.
+    */
+    void updateNowIfNeeded();
+
+    /** Returns the list that the component was last recorded into.
+        This will be empty if the component hasn't been drawn yet.
+    */
+    const DisplayList& getDisplayList() const noexcept      { return displayList; }
+
+    //==============================================================================
+    /** @internal */
+    void paint (Graphics&) override;
+    /** @internal */
+    bool invalidateAll() override;
+    /** @internal */
+    bool invalidate (const Rectangle<int>&) override;
+    /** @internal */
+    void releaseResources() override;
+
+private:
+    //==============================================================================
+    void handleAsyncUpdate() override;
+    void record (DisplayList&) const;
+
+    Component& owner;
+    DisplayList displayList;
+    float scale = 1.0f;
+    bool hasRecording = false, isRepaintingChanges = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DisplayListCachedComponentImage)
+};
+
+} // namespace juce
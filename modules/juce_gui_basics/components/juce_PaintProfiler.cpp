@@ -0,0 +1,382 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+namespace juce
+{
+
+// The profiler that's recording the paint currently happening on this thread, if any.
+static thread_local PaintProfiler* currentPaintProfiler = nullptr;
+
+PaintProfiler::PaintProfiler (int maxNumFramesToKeep)
+    : maxNumFrames ((size_t) jmax (1, maxNumFramesToKeep))
+{
+}
+
+PaintProfiler::~PaintProfiler()
+{
+    // A profiler mustn't be deleted while it's recording a paint
+    jassert (currentPaintProfiler != this);
+}
+
+void PaintProfiler::clear()
+{
+    frames.clear();
+}
+
+//==============================================================================
+void PaintProfiler::beginFrame (Rectangle<int> area)
+{
+    currentFrame.frameNumber = nextFrameNumber++;
+    currentFrame.startTimeMs = Time::getMillisecondCounterHiRes();
+    currentFrame.area = area;
+    currentFrame.components.clear();
+    openComponents.clear();
+}
+
+void PaintProfiler::endFrame()
+{
+    currentFrame.durationMs = Time::getMillisecondCounterHiRes() - currentFrame.startTimeMs;
+
+    if (frames.size() >= maxNumFrames)
+        frames.erase (frames.begin(), frames.begin() + (std::ptrdiff_t) (frames.size() + 1 - maxNumFrames));
+
+    frames.push_back (std::move (currentFrame));
+    currentFrame = {};
+}
+
+void PaintProfiler::beginComponent (Component& c)
+{
+    ComponentPaint paint;
+    paint.component = &c;
+    paint.name = c.getName();
+
+    if (paint.name.isEmpty())
+        paint.name = c.getComponentID();
+
+    if (paint.name.isEmpty())
+        paint.name = typeid (c).name();
+
+    paint.bounds = c.getBounds();
+    paint.depth = (int) openComponents.size();
+    paint.parentIndex = openComponents.empty() ? -1 : openComponents.back();
+    paint.startMs = Time::getMillisecondCounterHiRes() - currentFrame.startTimeMs;
+
+    openComponents.push_back ((int) currentFrame.components.size());
+    currentFrame.components.push_back (std::move (paint));
+}
+
+void PaintProfiler::endComponent()
+{
+    jassert (! openComponents.empty());
+
+    auto& paint = currentFrame.components[(size_t) openComponents.back()];
+    openComponents.pop_back();
+
+    paint.totalMs = Time::getMillisecondCounterHiRes() - currentFrame.startTimeMs - paint.startMs;
+    paint.selfMs += paint.totalMs;
+
+    if (paint.parentIndex >= 0)
+        currentFrame.components[(size_t) paint.parentIndex].selfMs -= paint.totalMs;
+}
+
+void PaintProfiler::recordUpload (int numRectangles, int64 numPixels, double durationMs, bool usedSharedMemory)
+{
+    // The upload belongs to the frame that was just painted
+    jassert (! frames.empty());
+
+    if (frames.empty())
+        return;
+
+    auto& frame = frames.back();
+    frame.uploadMs = durationMs;
+    frame.numRectanglesUploaded = numRectangles;
+    frame.numPixelsUploaded = numPixels;
+    frame.uploadUsedSharedMemory = usedSharedMemory;
+}
+
+//==============================================================================
+PaintProfiler::ScopedFrame::ScopedFrame (PaintProfiler* p, Rectangle<int> area)
+    : profiler (p), previous (currentPaintProfiler)
+{
+    currentPaintProfiler = profiler;
+
+    if (profiler != nullptr)
+        profiler->beginFrame (area);
+}
+
+PaintProfiler::ScopedFrame::~ScopedFrame()
+{
+    if (profiler != nullptr)
+        profiler->endFrame();
+
+    currentPaintProfiler = previous;
+}
+
+PaintProfiler::ScopedComponentPaint::ScopedComponentPaint (Component& c)
+    : profiler (currentPaintProfiler)
+{
+    if (profiler != nullptr)
+        profiler->beginComponent (c);
+}
+
+PaintProfiler::ScopedComponentPaint::~ScopedComponentPaint()
+{
+    if (profiler != nullptr)
+        profiler->endComponent();
+}
+
+//==============================================================================
+std::vector<PaintProfiler::ComponentSummary> PaintProfiler::getSummary() const
+{
+    std::vector<ComponentSummary> result;
+    std::map<Component*, size_t> indexForComponent;
+    std::map<String, size_t> indexForDeletedComponent;
+
+    for (auto& frame : frames)
+    {
+        for (auto& paint : frame.components)
+        {
+            auto& index = paint.component != nullptr ? indexForComponent.emplace (paint.component.getComponent(), result.size()).first->second
+                                                     : indexForDeletedComponent.emplace (paint.name, result.size()).first->second;
+
+            if (index == result.size())
+                result.push_back ({ paint.component, paint.name });
+
+            auto& summary = result[index];
+            ++summary.numPaints;
+            summary.totalSelfMs += paint.selfMs;
+            summary.maxSelfMs = jmax (summary.maxSelfMs, paint.selfMs);
+        }
+    }
+
+    std::stable_sort (result.begin(), result.end(), [] (const auto& a, const auto& b) { return a.totalSelfMs > b.totalSelfMs; });
+    return result;
+}
+
+void PaintProfiler::writeAsTraceEventJSON (OutputStream& out) const
+{
+    Array<var> events;
+
+    const auto addEvent = [&events] (const String& name, double startMs, double durationMs, DynamicObject::Ptr args)
+    {
+        DynamicObject::Ptr event = new DynamicObject();
+        event->setProperty ("name", name);
+        event->setProperty ("cat", "paint");
+        event->setProperty ("ph", "X");
+        event->setProperty ("ts", startMs * 1000.0);
+        event->setProperty ("dur", durationMs * 1000.0);
+        event->setProperty ("pid", 1);
+        event->setProperty ("tid", 1);
+        event->setProperty ("args", args.get());
+        events.add (event.get());
+    };
+
+    for (auto& frame : frames)
+    {
+        DynamicObject::Ptr frameArgs = new DynamicObject();
+        frameArgs->setProperty ("area", frame.area.toString());
+
+        if (frame.numRectanglesUploaded > 0)
+        {
+            frameArgs->setProperty ("uploadMs", frame.uploadMs);
+            frameArgs->setProperty ("rectanglesUploaded", frame.numRectanglesUploaded);
+            frameArgs->setProperty ("pixelsUploaded", frame.numPixelsUploaded);
+            frameArgs->setProperty ("sharedMemory", frame.uploadUsedSharedMemory);
+        }
+
+        addEvent ("Frame " + String (frame.frameNumber), frame.startTimeMs, frame.durationMs, frameArgs);
+
+        for (auto& paint : frame.components)
+        {
+            DynamicObject::Ptr args = new DynamicObject();
+            args->setProperty ("selfMs", paint.selfMs);
+            args->setProperty ("bounds", paint.bounds.toString());
+            addEvent (paint.name, frame.startTimeMs + paint.startMs, paint.totalMs, args);
+        }
+    }
+
+    DynamicObject::Ptr root = new DynamicObject();
+    root->setProperty ("traceEvents", events);
+    root->setProperty ("displayTimeUnit", "ms");
+
+    JSON::writeToStream (out, root.get(), true);
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class PaintProfilerTests final : public UnitTest
+{
+public:
+    PaintProfilerTests() : UnitTest ("PaintProfiler", UnitTestCategories::gui) {}
+
+    void runTest() override
+    {
+        Slow parent ("parent", 0), child ("child", 3), grandchild ("grandchild", 2);
+        parent.setBounds (0, 0, 100, 100);
+        child.setBounds (10, 10, 50, 50);
+        grandchild.setBounds (5, 5, 10, 10);
+        parent.addAndMakeVisible (child);
+        child.addAndMakeVisible (grandchild);
+
+        PaintProfiler profiler (2);
+
+        const auto paintFrame = [&]
+        {
+            Image image (Image::ARGB, 100, 100, true);
+            Graphics g (image);
+            PaintProfiler::ScopedFrame frame (&profiler, g.getClipBounds());
+            parent.paintEntireComponent (g, true);
+        };
+
+        beginTest ("Paints are recorded with their nesting and self times");
+        {
+            paintFrame();
+            expectEquals (profiler.getNumFrames(), 1);
+
+            auto& frame = profiler.getFrame (0);
+            expectEquals ((int) frame.components.size(), 3);
+            expectEquals (frame.components[0].name, String ("parent"));
+            expectEquals (frame.components[1].name, String ("child"));
+            expectEquals (frame.components[2].name, String ("grandchild"));
+            expectEquals (frame.components[2].depth, 2);
+            expectEquals (frame.components[2].parentIndex, 1);
+            expect (frame.components[2].bounds == grandchild.getBounds());
+
+            expect (frame.components[1].totalMs >= 5.0);
+            expect (frame.components[1].selfMs >= 3.0 && frame.components[1].selfMs < frame.components[1].totalMs);
+            expectWithinAbsoluteError (frame.components[0].selfMs + frame.components[1].selfMs + frame.components[2].selfMs,
+                                       frame.components[0].totalMs, 1.0e-6);
+        }
+
+        beginTest ("Only the most recent frames are kept");
+        {
+            paintFrame();
+            paintFrame();
+            expectEquals (profiler.getNumFrames(), 2);
+            expectEquals ((int) profiler.getFrame (0).frameNumber, 1);
+            expectEquals ((int) profiler.getFrame (1).frameNumber, 2);
+        }
+
+        beginTest ("Summary and trace export");
+        {
+            auto summary = profiler.getSummary();
+            expectEquals ((int) summary.size(), 3);
+            expect (summary[0].component == &child);
+            expectEquals (summary[0].numPaints, 2);
+
+            MemoryOutputStream out;
+            profiler.writeAsTraceEventJSON (out);
+            auto parsed = JSON::parse (out.toString());
+            expectEquals (parsed["traceEvents"].size(), 8);
+            expectEquals (parsed["traceEvents"][1]["name"].toString(), String ("parent"));
+        }
+
+        beginTest ("Uploads are added to the latest frame");
+        {
+            profiler.recordUpload (2, 1500, 0.25, true);
+
+            auto& frame = profiler.getFrame (profiler.getNumFrames() - 1);
+            expectEquals (frame.numRectanglesUploaded, 2);
+            expectEquals (frame.numPixelsUploaded, (int64) 1500);
+            expect (frame.uploadUsedSharedMemory);
+            expectEquals (profiler.getFrame (0).numRectanglesUploaded, 0);
+
+            MemoryOutputStream out;
+            profiler.writeAsTraceEventJSON (out);
+            auto parsed = JSON::parse (out.toString());
+            expectEquals ((int) parsed["traceEvents"][4]["args"]["pixelsUploaded"], 1500);
+        }
+
+        beginTest ("Nothing is recorded without a frame");
+        {
+            profiler.clear();
+            Image image (Image::ARGB, 100, 100, true);
+            Graphics g (image);
+            parent.paintEntireComponent (g, true);
+            expectEquals (profiler.getNumFrames(), 0);
+        }
+
+        beginTest ("Children covered by an opaque sibling aren't painted");
+        {
+            Slow covered ("covered", 0), cover ("cover", 0);
+            covered.setBounds (20, 20, 10, 10);
+            cover.setBounds (10, 10, 40, 40);
+            cover.setOpaque (true);
+            parent.addAndMakeVisible (covered);
+            parent.addAndMakeVisible (cover);
+            child.setVisible (false);
+
+            const auto paintedNames = [&]
+            {
+                profiler.clear();
+                paintFrame();
+
+                StringArray names;
+
+                for (auto& c : profiler.getFrame (0).components)
+                    names.add (c.name);
+
+                return names;
+            };
+
+            expect (paintedNames() == StringArray ("parent", "cover"));
+
+            cover.setAlpha (0.5f);
+            expect (paintedNames() == StringArray ("parent", "covered", "cover"));
+
+            cover.setAlpha (1.0f);
+            covered.setBounds (0, 0, 20, 20);
+            expect (paintedNames() == StringArray ("parent", "covered", "cover"));
+
+            parent.removeChildComponent (&covered);
+            parent.removeChildComponent (&cover);
+            child.setVisible (true);
+        }
+    }
+
+private:
+    struct Slow final : public Component
+    {
+        Slow (const String& name, int msToTake) : Component (name), ms (msToTake) {}
+
+        void paint (Graphics&) override
+        {
+            const auto end = Time::getMillisecondCounterHiRes() + ms;
+
+            while (Time::getMillisecondCounterHiRes() < end)
+            {}
+        }
+
+        int ms;
+    };
+};
+
+static PaintProfilerTests paintProfilerTests;
+
+#endif
+
+} // namespace juce
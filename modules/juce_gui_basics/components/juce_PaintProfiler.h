@@ -0,0 +1,219 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+namespace juce
+{
+
+//==============================================================================
+/**
+    Records how long each component takes to paint, frame by frame.
+
+    Attach one of these to a window's ComponentPeer with ComponentPeer::setPaintProfiler(),
+    and every time the peer paints, the profiler will store a Frame listing each component
+    that was drawn, with the time spent in the component itself and in its children.
+
+    Only a limited number of frames are kept, so a profiler can be left attached while
+    you use the app, and then you can look at getSummary() to see which components are the
+    most expensive, or save the frames with writeAsTraceEventJSON() and open them in a
+    trace viewer such as Perfetto or chrome://tracing.
+
+    Paints that happen on threads other than the one painting the peer, e.g. components
+    drawn by an OpenGLContext, aren't recorded.
+
+    @code
+    PaintProfiler profiler;
+    window.getPeer()->setPaintProfiler (&profiler);
+
+    // ...later:
+    for (auto& c : profiler.getSummary())
+        DBG (c.name << ": " << c.totalSelfMs << "ms in " << c.numPaints << " paints");
+    @endcode
+
+    @see ComponentPeer::setPaintProfiler
+
+    @tags{GUI}
+*/
+class JUCE_API  PaintProfiler
+{
+public:
+    //==============================================================================
+    /** Creates a profiler which will keep the given number of the most recent frames. */
+    explicit PaintProfiler (int maxNumFramesToKeep = 300);
+
+    /** Destructor. */
+    ~PaintProfiler();
+
+    //==============================================================================
+    /** The record of one component being painted during a frame. */
+    struct ComponentPaint
+    {
+        /** The component, which will be null if it has been deleted since. */
+        Component::SafePointer<Component> component;
+
+        /** The component's name, or its ID if it has no name, or its type name if it has neither. */
+        String name;
+
+        /** The component's bounds, relative to its parent, when it was painted. */
+        Rectangle<int> bounds;
+
+        /** How deeply this component was nested in the paint call: 0 for the peer's component. */
+        int depth = 0;
+
+        /** The index in Frame::components of the component that painted this one, or -1. */
+        int parentIndex = -1;
+
+        /** When this component started painting, relative to the start of the frame. */
+        double startMs = 0;
+
+        /** The total time spent painting this component, including its children. */
+        double totalMs = 0;
+
+        /** The time spent painting this component, excluding its children. */
+        double selfMs = 0;
+    };
+
+    /** The record of one paint of a peer. */
+    struct Frame
+    {
+        /** Counts up from 0 for each frame that this profiler has recorded. */
+        int64 frameNumber = 0;
+
+        /** The Time::getMillisecondCounterHiRes() value at which the frame started. */
+        double startTimeMs = 0;
+
+        /** The total time taken by the frame. */
+        double durationMs = 0;
+
+        /** The area that was painted, relative to the peer's component. */
+        Rectangle<int> area;
+
+        /** The components that were painted, in the order in which they started painting. */
+        std::vector<ComponentPaint> components;
+
+        /** The time taken to send the painted pixels to the window after the paint had finished.
+
+            This is only measured by peers that upload their pixels themselves, which is
+            currently only on Linux, and will be 0 elsewhere. When shared memory is used this is
+            the time taken to queue the upload, as the display server copies the pixels later.
+        */
+        double uploadMs = 0;
+
+        /** The number of separate rectangles that were sent to the window. */
+        int numRectanglesUploaded = 0;
+
+        /** The total number of pixels that were sent to the window. */
+        int64 numPixelsUploaded = 0;
+
+        /** True if the pixels were handed to the display server in shared memory (X11 MIT-SHM)
+            rather than being copied through the connection to it.
+        */
+        bool uploadUsedSharedMemory = false;
+    };
+
+    /** Returns the number of frames that are currently stored. */
+    int getNumFrames() const noexcept                       { return (int) frames.size(); }
+
+    /** Returns one of the stored frames, with 0 being the oldest. */
+    const Frame& getFrame (int index) const                 { return frames[(size_t) index]; }
+
+    /** Discards all the stored frames. */
+    void clear();
+
+    //==============================================================================
+    /** The paint times of one component, totalled over all the stored frames. */
+    struct ComponentSummary
+    {
+        /** The component, which will be null if it has been deleted since. */
+        Component::SafePointer<Component> component;
+
+        /** The component's name, as described in ComponentPaint::name. */
+        String name;
+
+        /** The number of times the component was painted. */
+        int numPaints = 0;
+
+        /** The total time spent painting this component, excluding its children. */
+        double totalSelfMs = 0;
+
+        /** The longest time that a single paint of this component took, excluding its children. */
+        double maxSelfMs = 0;
+    };
+
+    /** Returns the paint times of all the components in the stored frames, with the most
+        expensive first.
+    */
+    std::vector<ComponentSummary> getSummary() const;
+
+    /** Writes the stored frames in the JSON Trace Event Format, which can be opened by
+        trace viewers such as Perfetto or chrome://tracing.
+
+        Each frame and each component paint is written as a complete ("X") event.
+    */
+    void writeAsTraceEventJSON (OutputStream&) const;
+
+    //==============================================================================
+    /** @internal */
+    void recordUpload (int numRectangles, int64 numPixels, double durationMs, bool usedSharedMemory);
+
+    /** @internal */
+    struct ScopedFrame
+    {
+        ScopedFrame (PaintProfiler*, Rectangle<int> area);
+        ~ScopedFrame();
+
+        PaintProfiler* profiler;
+        PaintProfiler* previous;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedFrame)
+    };
+
+    /** @internal */
+    struct ScopedComponentPaint
+    {
+        explicit ScopedComponentPaint (Component&);
+        ~ScopedComponentPaint();
+
+        PaintProfiler* profiler;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedComponentPaint)
+    };
+
+private:
+    //==============================================================================
+    void beginFrame (Rectangle<int>);
+    void endFrame();
+    void beginComponent (Component&);
+    void endComponent();
+
+    std::vector<Frame> frames;
+    Frame currentFrame;
+    std::vector<int> openComponents;
+    const size_t maxNumFrames;
+    int64 nextFrameNumber = 0;
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE (PaintProfiler)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PaintProfiler)
+};
+
+} // namespace juce
@@ -242,8 +242,10 @@
 #include "commands/juce_KeyPressMappingSet.cpp"
 #include "components/juce_Component.cpp"
 #include "components/juce_ComponentListener.cpp"
+#include "components/juce_DisplayListCachedComponentImage.cpp"
 #include "components/juce_FocusTraverser.cpp"
 #include "components/juce_ModalComponentManager.cpp"
+#include "components/juce_PaintProfiler.cpp"
 #include "desktop/juce_Desktop.cpp"
 #include "desktop/juce_Displays.cpp"
 #include "detail/juce_AccessibilityHelpers.cpp"
@@ -355,4 +357,5 @@
 #include "windows/juce_TooltipWindow.cpp"
 #include "windows/juce_TopLevelWindow.cpp"
 #include "windows/juce_VBlankAttachment.cpp"
+#include "windows/juce_FrameScheduler.cpp"
 #include "windows/juce_NativeScaleFactorNotifier.cpp"
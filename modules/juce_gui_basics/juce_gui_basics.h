@@ -70,6 +70,16 @@
  #define JUCE_ENABLE_REPAINT_DEBUGGING 0
 #endif
 
+/** Config: JUCE_COALESCE_REPAINTS
+    If this is enabled, calling repaint() on a component whose whole area is already
+    waiting to be painted returns immediately, rather than passing the area up through
+    its parents again. This makes it cheap for components to call repaint() many times
+    between paints. Only repaints made on the message thread are coalesced.
+*/
+#ifndef JUCE_COALESCE_REPAINTS
+ #define JUCE_COALESCE_REPAINTS 1
+#endif
+
 /** Config: JUCE_USE_XRANDR
     Enables Xrandr multi-monitor support (Linux only).
     Unless you specifically want to disable this, it's best to leave this option turned on.
@@ -195,6 +205,8 @@ namespace juce
 #include "components/juce_ComponentListener.h"
 #include "components/juce_CachedComponentImage.h"
 #include "components/juce_Component.h"
+#include "components/juce_DisplayListCachedComponentImage.h"
+#include "components/juce_PaintProfiler.h"
 #include "layout/juce_ComponentAnimator.h"
 #include "desktop/juce_Desktop.h"
 #include "desktop/juce_Displays.h"
@@ -291,6 +303,7 @@ namespace juce
 #include "windows/juce_ThreadWithProgressWindow.h"
 #include "windows/juce_TooltipWindow.h"
 #include "windows/juce_VBlankAttachment.h"
+#include "windows/juce_FrameScheduler.h"
 #include "windows/juce_WindowUtils.h"
 #include "windows/juce_NativeScaleFactorNotifier.h"
 #include "layout/juce_MultiDocumentPanel.h"
@@ -38,7 +38,7 @@ struct FlexBoxLayoutCalculation
                        || fb.flexDirection == FlexBox::Direction::rowReverse),
           containerLineLength (getContainerSize (Axis::main))
     {
-        lineItems.calloc (numItems * numItems);
+        lineItems.calloc (numItems);
         lineInfo.calloc (numItems);
     }
 
@@ -65,7 +65,7 @@ struct FlexBoxLayoutCalculation
 
     struct RowInfo
     {
-        int numItems;
+        int numItems, firstItem;
         Coord crossSize, lineY, totalLength;
     };
 
@@ -78,11 +78,13 @@ struct FlexBoxLayoutCalculation
     int numberOfRows = 1;
     Coord containerCrossLength = 0;
 
+    // The items in each line follow on from the ones in the line before, so this holds all
+    // of them in order, and each RowInfo knows where its line starts.
     HeapBlock<ItemWithState*> lineItems;
     HeapBlock<RowInfo> lineInfo;
     Array<ItemWithState> itemStates;
 
-    ItemWithState& getItem (int x, int y) const noexcept     { return *lineItems[y * numItems + x]; }
+    ItemWithState& getItem (int x, int y) const noexcept     { return *lineItems[lineInfo[y].firstItem + x]; }
 
     static bool isAuto (Coord value) noexcept
     {
@@ -189,7 +191,7 @@ struct FlexBoxLayoutCalculation
         else // if multi-line, group the flexbox items into multiple lines
         {
             auto currentLength = containerLineLength;
-            int column = 0, row = 0;
+            int column = 0, row = 0, index = 0;
             bool firstRow = true;
 
             for (auto& item : itemStates)
@@ -209,10 +211,11 @@ struct FlexBoxLayoutCalculation
                     column = 0;
                     currentLength = containerLineLength;
                     numberOfRows = jmax (numberOfRows, row + 1);
+                    lineInfo[row].firstItem = index;
                 }
 
                 currentLength -= flexitemLength;
-                lineItems[row * numItems + column] = &item;
+                lineItems[index++] = &item;
                 ++column;
                 lineInfo[row].numItems = jmax (lineInfo[row].numItems, column);
                 firstRow = false;
@@ -753,23 +756,85 @@ FlexBox::FlexBox (Direction d, Wrap w, AlignContent ac, AlignItems ai, JustifyCo
 {
 }
 
+//==============================================================================
+/*  The inputs and results of a layout. The copies of the items have their currentBounds
+    relative to the target area, so the same layout can be used wherever the area is.
+*/
+struct FlexBox::LayoutCache
+{
+    float width, height;
+    Direction flexDirection;
+    Wrap flexWrap;
+    AlignContent alignContent;
+    AlignItems alignItems;
+    JustifyContent justifyContent;
+    Array<FlexItem> items;
+
+    static bool haveSameLayoutProperties (const FlexItem& a, const FlexItem& b) noexcept
+    {
+        return a.order == b.order
+            && a.alignSelf == b.alignSelf
+            && exactlyEqual (a.flexGrow,  b.flexGrow)
+            && exactlyEqual (a.flexShrink, b.flexShrink)
+            && exactlyEqual (a.flexBasis, b.flexBasis)
+            && exactlyEqual (a.width,     b.width)
+            && exactlyEqual (a.minWidth,  b.minWidth)
+            && exactlyEqual (a.maxWidth,  b.maxWidth)
+            && exactlyEqual (a.height,    b.height)
+            && exactlyEqual (a.minHeight, b.minHeight)
+            && exactlyEqual (a.maxHeight, b.maxHeight)
+            && exactlyEqual (a.margin.left,   b.margin.left)
+            && exactlyEqual (a.margin.right,  b.margin.right)
+            && exactlyEqual (a.margin.top,    b.margin.top)
+            && exactlyEqual (a.margin.bottom, b.margin.bottom);
+    }
+
+    bool matches (const FlexBox& box, float w, float h) const noexcept
+    {
+        return exactlyEqual (width, w)
+            && exactlyEqual (height, h)
+            && flexDirection == box.flexDirection
+            && flexWrap == box.flexWrap
+            && alignContent == box.alignContent
+            && alignItems == box.alignItems
+            && justifyContent == box.justifyContent
+            && std::equal (items.begin(), items.end(), box.items.begin(), box.items.end(), haveSameLayoutProperties);
+    }
+};
+
+//==============================================================================
 void FlexBox::performLayout (Rectangle<float> targetArea)
 {
+    lastTargetArea = targetArea;
+
     if (! items.isEmpty())
     {
-        FlexBoxLayoutCalculation layout (*this, targetArea.getWidth(), targetArea.getHeight());
-
-        layout.createStates();
-        layout.initialiseItems();
-        layout.resolveFlexibleLengths();
-        layout.resolveAutoMarginsOnMainAxis();
-        layout.calculateCrossSizesByLine();
-        layout.calculateCrossSizeOfAllItems();
-        layout.alignLinesPerAlignContent();
-        layout.resolveAutoMarginsOnCrossAxis();
-        layout.alignItemsInCrossAxisInLinesPerAlignSelf();
-        layout.alignItemsByJustifyContent();
-        layout.layoutAllItems();
+        const auto width = targetArea.getWidth(), height = targetArea.getHeight();
+
+        if (lastLayout == nullptr || ! lastLayout->matches (*this, width, height))
+        {
+            FlexBoxLayoutCalculation layout (*this, width, height);
+
+            layout.createStates();
+            layout.initialiseItems();
+            layout.resolveFlexibleLengths();
+            layout.resolveAutoMarginsOnMainAxis();
+            layout.calculateCrossSizesByLine();
+            layout.calculateCrossSizeOfAllItems();
+            layout.alignLinesPerAlignContent();
+            layout.resolveAutoMarginsOnCrossAxis();
+            layout.alignItemsInCrossAxisInLinesPerAlignSelf();
+            layout.alignItemsByJustifyContent();
+            layout.layoutAllItems();
+
+            lastLayout = std::make_shared<const LayoutCache> (LayoutCache { width, height, flexDirection, flexWrap,
+                                                                            alignContent, alignItems, justifyContent, items });
+        }
+        else
+        {
+            for (int i = 0; i < items.size(); ++i)
+                items.getReference (i).currentBounds = lastLayout->items.getReference (i).currentBounds;
+        }
 
         for (auto& item : items)
         {
@@ -792,6 +857,12 @@ void FlexBox::performLayout (Rectangle<int> targetArea)
     performLayout (targetArea.toFloat());
 }
 
+void FlexBox::performLayout()
+{
+    if (lastTargetArea.has_value())
+        performLayout (*lastTargetArea);
+}
+
 //==============================================================================
 FlexItem::FlexItem() noexcept {}
 FlexItem::FlexItem (float w, float h) noexcept                  : currentBounds (w, h), minWidth (w), minHeight (h) {}
@@ -1139,6 +1210,54 @@ public:
                 expect (flex.items[2].currentBounds == Rectangle<float> (rect.getX(), rect.getBottom() + spacer, 10.0f, 10.0f));
             }
         }
+
+        beginTest ("in a multiline layout, items are wrapped onto as many lines as they need");
+        {
+            juce::FlexBox flex;
+            flex.flexWrap = FlexBox::Wrap::wrap;
+            flex.alignContent = FlexBox::AlignContent::flexStart;
+
+            for (int i = 0; i < 5; ++i)
+                flex.items.add (FlexItem().withWidth (40.0f).withHeight (10.0f));
+
+            flex.performLayout (Rectangle<float> (100.0f, 100.0f));
+
+            for (int i = 0; i < 5; ++i)
+                expect (flex.items[i].currentBounds == Rectangle<float> ((float) (i % 2) * 40.0f, (float) (i / 2) * 10.0f, 40.0f, 10.0f));
+        }
+
+        beginTest ("a layout is reused when only its position changes");
+        {
+            juce::FlexBox flex;
+            flex.items = { FlexItem().withFlex (1.0f), FlexItem().withFlex (2.0f) };
+
+            flex.performLayout (Rectangle<float> (0.0f, 0.0f, 300.0f, 50.0f));
+            expect (flex.items[1].currentBounds == Rectangle<float> (100.0f, 0.0f, 200.0f, 50.0f));
+
+            flex.performLayout (Rectangle<float> (10.0f, 20.0f, 300.0f, 50.0f));
+            expect (flex.items[1].currentBounds == Rectangle<float> (110.0f, 20.0f, 200.0f, 50.0f));
+
+            flex.items.getReference (0).flexGrow = 2.0f;
+            flex.performLayout (Rectangle<float> (10.0f, 20.0f, 300.0f, 50.0f));
+            expect (flex.items[1].currentBounds == Rectangle<float> (160.0f, 20.0f, 150.0f, 50.0f));
+
+            flex.performLayout (Rectangle<float> (10.0f, 20.0f, 400.0f, 50.0f));
+            expect (flex.items[1].currentBounds == Rectangle<float> (210.0f, 20.0f, 200.0f, 50.0f));
+        }
+
+        beginTest ("a nested box can be laid out again on its own");
+        {
+            juce::FlexBox inner, outer;
+            inner.items = { FlexItem().withFlex (1.0f), FlexItem().withFlex (1.0f) };
+            outer.items = { FlexItem().withFlex (1.0f), FlexItem (inner).withFlex (1.0f) };
+
+            outer.performLayout (Rectangle<float> (200.0f, 100.0f));
+            expect (inner.items[1].currentBounds == Rectangle<float> (150.0f, 0.0f, 50.0f, 100.0f));
+
+            inner.items.getReference (0).flexGrow = 3.0f;
+            inner.performLayout();
+            expect (inner.items[1].currentBounds == Rectangle<float> (175.0f, 0.0f, 25.0f, 100.0f));
+        }
     }
 };
 
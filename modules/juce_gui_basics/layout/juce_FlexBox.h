@@ -35,6 +35,12 @@ namespace juce
     to the items array, and call performLayout() in the resized() function of your
     Component.
 
+    A FlexBox remembers its last layout. If performLayout() is called again while the
+    box's properties and items are the same and the area is the same size, the items
+    are just moved to the new position instead of being laid out again. FlexBoxes nested
+    inside it are checked in the same way, so when a window is resized only the boxes
+    whose size has actually changed are recalculated.
+
     @see FlexItem
 
     @tags{GUI}
@@ -106,6 +112,15 @@ public:
     /** Lays-out the box's items within the given rectangle. */
     void performLayout (Rectangle<int> targetArea);
 
+    /** Lays-out the box's items again, within the rectangle that was last passed to
+        performLayout().
+
+        Use this after changing the items of a box that's nested inside others, to update
+        just that box and the boxes inside it rather than the whole hierarchy. If the box
+        hasn't been laid out before, this does nothing.
+    */
+    void performLayout();
+
     //==============================================================================
     /** Specifies how flex items are placed in the flex container, and defines the
         direction of the main axis.
@@ -137,6 +152,11 @@ public:
     Array<FlexItem> items;
 
 private:
+    struct LayoutCache;
+
+    std::shared_ptr<const LayoutCache> lastLayout;
+    std::optional<Rectangle<float>> lastTargetArea;
+
     JUCE_LEAK_DETECTOR (FlexBox)
 };
 
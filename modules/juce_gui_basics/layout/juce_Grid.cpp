@@ -980,22 +980,21 @@ struct Grid::Helpers
             {
                 auto& array = tracksInDirection.items;
 
-                for (int index = 0; index < array.size(); ++index)
+                // An auto track is as big as the largest item that only occupies that track
+                std::vector<float> largestItemSizes ((size_t) array.size(), 0.0f);
+
+                for (const auto& element : placements)
                 {
-                    if (array.getReference (index).isAuto())
-                    {
-                        const auto combiner = [&] (const auto acc, const auto& element)
-                        {
-                            const auto item = getItem (element.second);
-                            const auto isNotSpan = std::abs (item.end - item.start) <= 1;
-                            return isNotSpan && item.start == index + 1 - tracksInDirection.numImplicitLeading
-                                   ? std::max (acc, getItemSize (*element.first))
-                                   : acc;
-                        };
-
-                        array.getReference (index).size = std::accumulate (placements.begin(), placements.end(), 0.0f, combiner);
-                    }
+                    const auto item = getItem (element.second);
+                    const auto index = item.start - 1 + tracksInDirection.numImplicitLeading;
+
+                    if (std::abs (item.end - item.start) <= 1 && isPositiveAndBelow (index, array.size()))
+                        largestItemSizes[(size_t) index] = std::max (largestItemSizes[(size_t) index], getItemSize (*element.first));
                 }
+
+                for (int index = 0; index < array.size(); ++index)
+                    if (array.getReference (index).isAuto())
+                        array.getReference (index).size = largestItemSizes[(size_t) index];
             };
 
             setSizes (tracks.rows,
@@ -1100,10 +1099,96 @@ float Grid::TrackInfo::getAbsoluteSize (float relativeFractionalUnit) const
     return isFractional() ? size * relativeFractionalUnit : size;
 }
 
+//==============================================================================
+//==============================================================================
+/*  The placement of each item in the grid, with copies of the properties that it was worked
+    out from. The items are stored by index, so that the placement can still be used if the
+    array of items has been rebuilt with the same properties.
+*/
+struct Grid::PlacementCache
+{
+    explicit PlacementCache (Grid& grid)
+        : templateColumns (grid.templateColumns),
+          templateRows (grid.templateRows),
+          templateAreas (grid.templateAreas),
+          autoFlow (grid.autoFlow)
+    {
+        for (auto& item : grid.items)
+            items.add ({ item.order, item.column, item.row, item.area });
+
+        for (auto& placement : Helpers::AutoPlacement().deduceAllItems (grid))
+            placements.add ({ (int) (placement.first - grid.items.begin()), placement.second });
+    }
+
+    bool matches (const Grid& grid) const
+    {
+        return autoFlow == grid.autoFlow
+            && templateAreas == grid.templateAreas
+            && std::equal (templateColumns.begin(), templateColumns.end(), grid.templateColumns.begin(), grid.templateColumns.end(), haveSameLineNames)
+            && std::equal (templateRows.begin(), templateRows.end(), grid.templateRows.begin(), grid.templateRows.end(), haveSameLineNames)
+            && std::equal (items.begin(), items.end(), grid.items.begin(), grid.items.end(), [] (const auto& a, const GridItem& b)
+               {
+                   return a.order == b.order
+                       && a.area == b.area
+                       && isSame (a.column, b.column)
+                       && isSame (a.row, b.row);
+               });
+    }
+
+    Helpers::AutoPlacement::ItemPlacementArray getItemsAndAreas (Grid& grid) const
+    {
+        Helpers::AutoPlacement::ItemPlacementArray result;
+        result.ensureStorageAllocated (placements.size());
+
+        for (auto& placement : placements)
+            result.add ({ &grid.items.getReference (placement.first), placement.second });
+
+        return result;
+    }
+
+private:
+    // The sizes of the tracks don't affect the placement, only the lines' names and numbers
+    static bool haveSameLineNames (const TrackInfo& a, const TrackInfo& b)
+    {
+        return a.getStartLineName() == b.getStartLineName() && a.getEndLineName() == b.getEndLineName();
+    }
+
+    static bool isSame (const GridItem::Property& a, const GridItem::Property& b)
+    {
+        return a.hasAuto() == b.hasAuto()
+            && a.hasSpan() == b.hasSpan()
+            && a.getNumber() == b.getNumber()
+            && a.getName() == b.getName();
+    }
+
+    static bool isSame (const GridItem::StartAndEndProperty& a, const GridItem::StartAndEndProperty& b)
+    {
+        return isSame (a.start, b.start) && isSame (a.end, b.end);
+    }
+
+    struct ItemProperties
+    {
+        int order;
+        GridItem::StartAndEndProperty column, row;
+        String area;
+    };
+
+    Array<TrackInfo> templateColumns, templateRows;
+    StringArray templateAreas;
+    AutoFlow autoFlow;
+    Array<ItemProperties> items;
+    Array<std::pair<int, Helpers::PlacementHelpers::LineArea>> placements;
+};
+
 //==============================================================================
 void Grid::performLayout (Rectangle<int> targetArea)
 {
-    const auto itemsAndAreas = Helpers::AutoPlacement().deduceAllItems (*this);
+    lastTargetArea = targetArea;
+
+    if (lastPlacement == nullptr || ! lastPlacement->matches (*this))
+        lastPlacement = std::make_shared<const PlacementCache> (*this);
+
+    const auto itemsAndAreas = lastPlacement->getItemsAndAreas (*this);
 
     auto implicitTracks = Helpers::AutoPlacement::createImplicitTracks (*this, itemsAndAreas);
 
@@ -1157,6 +1242,12 @@ void Grid::performLayout (Rectangle<int> targetArea)
     }
 }
 
+void Grid::performLayout()
+{
+    if (lastTargetArea.has_value())
+        performLayout (*lastTargetArea);
+}
+
 //==============================================================================
 #if JUCE_UNIT_TESTS
 
@@ -1632,6 +1723,42 @@ struct GridTests final : public UnitTest
                 evaluateInvariants (randomSolution);
             }
         }
+
+        beginTest ("Items are placed again when their positions change");
+        {
+            Grid grid;
+            grid.templateColumns = { Tr (1_fr), Tr (1_fr) };
+            grid.templateRows    = { Tr (1_fr), Tr (1_fr) };
+            grid.items = { GridItem(), GridItem(), GridItem() };
+
+            grid.performLayout ({ 200, 100 });
+            expect (grid.items[2].currentBounds == Rect (0.0f, 50.0f, 100.0f, 50.0f));
+
+            grid.performLayout ({ 10, 20, 400, 100 });
+            expect (grid.items[2].currentBounds == Rect (10.0f, 70.0f, 200.0f, 50.0f));
+
+            grid.items.getReference (0).setArea (2, 2);
+            grid.performLayout();
+            expect (grid.items[0].currentBounds == Rect (210.0f, 70.0f, 200.0f, 50.0f));
+            expect (grid.items[2].currentBounds == Rect (210.0f, 20.0f, 200.0f, 50.0f));
+
+            grid.items = { GridItem(), GridItem().withArea (1, 1) };
+            grid.performLayout();
+            expect (grid.items[0].currentBounds == Rect (210.0f, 20.0f, 200.0f, 50.0f));
+        }
+
+        beginTest ("Auto rows are as tall as the tallest item that's only in that row");
+        {
+            Grid grid;
+            grid.templateColumns = { Tr (1_fr), Tr (1_fr) };
+            grid.items = { GridItem().withHeight (10.0f), GridItem().withHeight (30.0f),
+                           GridItem().withHeight (20.0f).withMargin ({ 5.0f }),
+                           GridItem().withHeight (100.0f).withArea (2, 1, 4, 2) };
+
+            grid.performLayout ({ 200, 200 });
+            expect (grid.items[2].currentBounds == Rect (105.0f, 35.0f, 90.0f, 20.0f));
+            expect (grid.items[3].currentBounds == Rect (0.0f, 30.0f, 100.0f, 100.0f));
+        }
     }
 };
 
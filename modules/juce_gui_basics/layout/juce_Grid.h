@@ -32,6 +32,10 @@ namespace juce
     Implemented from the `CSS Grid Layout` specification as described at:
     https://css-tricks.com/snippets/css/complete-guide-grid/
 
+    The placement of the items in the grid's cells only depends on the templates and the
+    items' positions and spans, not on the size of the grid, so it's remembered between
+    calls to performLayout() and only worked out again when one of those changes.
+
     @see GridItem
 
     @tags{GUI}
@@ -205,6 +209,13 @@ public:
     /** Lays-out the grid's items within the given rectangle. */
     void performLayout (Rectangle<int>);
 
+    /** Lays-out the grid's items again, within the rectangle that was last passed to
+        performLayout().
+
+        If the grid hasn't been laid out before, this does nothing.
+    */
+    void performLayout();
+
     //==============================================================================
     /** Returns the number of columns. */
     int getNumberOfColumns() const noexcept         { return templateColumns.size(); }
@@ -214,6 +225,10 @@ public:
 private:
     //==============================================================================
     struct Helpers;
+    struct PlacementCache;
+
+    std::shared_ptr<const PlacementCache> lastPlacement;
+    std::optional<Rectangle<int>> lastTargetArea;
 };
 
 constexpr Grid::Px operator""_px (long double px)          { return Grid::Px { px }; }
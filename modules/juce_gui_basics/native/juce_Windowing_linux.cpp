@@ -169,7 +169,22 @@ public:
     //==============================================================================
     StringArray getAvailableRenderingEngines() override
     {
-        return { "Software Renderer" };
+        return { "Software Renderer", "Multi-threaded Software Renderer" };
+    }
+
+    int getCurrentRenderingEngine() const override
+    {
+        return useTiledRenderer ? 1 : 0;
+    }
+
+    void setCurrentRenderingEngine (int index) override
+    {
+        jassert (isPositiveAndBelow (index, 2));
+
+        const auto shouldUseTiledRenderer = (index == 1);
+
+        if (std::exchange (useTiledRenderer, shouldUseTiledRenderer) != shouldUseTiledRenderer)
+            repaint (component.getLocalBounds());
     }
 
     void setVisible (bool shouldBeVisible) override
@@ -423,13 +438,11 @@ private:
         {
             XWindowSystem::getInstance()->processPendingPaintsForWindow (peer.windowH);
 
-            if (XWindowSystem::getInstance()->getNumPaintsPendingForWindow (peer.windowH) > 0)
-                return;
-
             if (! regionsNeedingRepaint.isEmpty())
                 performAnyPendingRepaintsNow();
-            else if (Time::getApproximateMillisecondCounter() > lastTimeImageUsed + 3000)
-                image = Image();
+            else if (Time::getApproximateMillisecondCounter() > lastTimeImageUsed + 3000
+                      && XWindowSystem::getInstance()->getNumPaintsPendingForWindow (peer.windowH) == 0)
+                images = {};
         }
 
         void repaint (Rectangle<int> area)
@@ -439,18 +452,31 @@ private:
 
         void performAnyPendingRepaintsNow()
         {
-            if (XWindowSystem::getInstance()->getNumPaintsPendingForWindow (peer.windowH) > 0)
+            // Each frame that's still being uploaded from shared memory holds on to its image, so
+            // we can only paint if the other image is free. Frames finish in order, so if only one
+            // is pending it must be the last one, which used the image we're not about to use.
+            if (XWindowSystem::getInstance()->getNumPaintsPendingForWindow (peer.windowH) >= (int) images.size())
                 return;
 
             auto originalRepaintRegion = regionsNeedingRepaint;
             regionsNeedingRepaint.clear();
+
+            // Painting and blitting a few extra pixels is cheaper than clipping to, and
+            // uploading, lots of small fragments separately.
+            originalRepaintRegion.coalesce (maxNumRepaintRectangles, maxExtraRepaintAreaPerMerge);
+
             auto totalArea = originalRepaintRegion.getBounds();
 
             if (! totalArea.isEmpty())
             {
-                const auto wasImageNull = image.isNull();
+                const auto wasImageNull = std::all_of (images.begin(), images.end(), [] (auto& i) { return i.isNull(); });
+
+                if (XWindowSystem::getInstance()->isUsingSharedMemory (images[currentImage]))
+                    currentImage = (currentImage + 1) % images.size();
+
+                auto& image = images[currentImage];
 
-                if (wasImageNull || image.getWidth() < totalArea.getWidth()
+                if (image.isNull() || image.getWidth() < totalArea.getWidth()
                      || image.getHeight() < totalArea.getHeight())
                 {
                     image = XWindowSystem::getInstance()->createImage (isSemiTransparentWindow,
@@ -482,24 +508,46 @@ private:
                         image.clear (i - totalArea.getPosition());
 
                 {
-                    auto context = peer.getComponent().getLookAndFeel()
-                                     .createGraphicsContext (image, -totalArea.getPosition(), adjustedList);
+                    auto context = peer.useTiledRenderer
+                                     ? std::make_unique<LowLevelGraphicsTiledSoftwareRenderer> (image, -totalArea.getPosition(), adjustedList)
+                                     : peer.getComponent().getLookAndFeel()
+                                           .createGraphicsContext (image, -totalArea.getPosition(), adjustedList);
 
                     context->addTransform (AffineTransform::scale ((float) peer.currentScaleFactor));
                     peer.handlePaint (*context);
                 }
 
-                for (auto& i : originalRepaintRegion)
-                   XWindowSystem::getInstance()->blitToWindow (peer.windowH, image, i, totalArea);
+                const auto uploadStart = Time::getMillisecondCounterHiRes();
+                XWindowSystem::getInstance()->blitToWindow (peer.windowH, image, originalRepaintRegion, totalArea);
+
+                if (auto* profiler = peer.getPaintProfiler())
+                {
+                    int64 numPixels = 0;
+
+                    for (auto& i : originalRepaintRegion)
+                        numPixels += (int64) i.getWidth() * i.getHeight();
+
+                    profiler->recordUpload (originalRepaintRegion.getNumRectangles(), numPixels,
+                                            Time::getMillisecondCounterHiRes() - uploadStart,
+                                            XWindowSystem::getInstance()->isUsingSharedMemory (image));
+                }
             }
 
             lastTimeImageUsed = Time::getApproximateMillisecondCounter();
         }
 
     private:
+        static constexpr int maxNumRepaintRectangles = 16;
+        static constexpr int maxExtraRepaintAreaPerMerge = 64 * 64;
+
         LinuxComponentPeer& peer;
         const bool isSemiTransparentWindow;
-        Image image;
+
+        // Two images, so that the next frame can be painted while the server is still reading
+        // the last one from shared memory. Without shared memory the pixels are copied when
+        // they're sent, so there's never a paint pending and only the first image gets used.
+        std::array<Image, 2> images;
+        size_t currentImage = 0;
         uint32 lastTimeImageUsed = 0;
         RectangleList<int> regionsNeedingRepaint;
 
@@ -579,7 +627,7 @@ private:
     ::Window windowH = {}, parentWindow = {};
     Rectangle<int> bounds;
     ComponentPeer::OptionalBorderSize windowBorder;
-    bool fullScreen = false, isAlwaysOnTop = false;
+    bool fullScreen = false, isAlwaysOnTop = false, useTiledRenderer = false;
     double currentScaleFactor = 1.0;
     Array<Component*> glRepaintListeners;
     ScopedWindowAssociation association;
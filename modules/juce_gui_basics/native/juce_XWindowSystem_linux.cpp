@@ -1011,13 +1011,15 @@ public:
 
     std::unique_ptr<ImageType> createType() const override     { return std::make_unique<NativeImageType>(); }
 
-    void blitToWindow (::Window window, int dx, int dy, unsigned int dw, unsigned int dh, int sx, int sy)
+    void blitToWindow (::Window window, int dx, int dy, unsigned int dw, unsigned int dh, int sx, int sy, bool sendCompletionEvent)
     {
         XWindowSystemUtilities::ScopedXLock xLock;
 
        #if JUCE_USE_XSHM
-        if (isUsingXShm())
+        if (isUsingXShm() && sendCompletionEvent)
             XWindowSystem::getInstance()->addPendingPaintForWindow (window);
+       #else
+        ignoreUnused (sendCompletionEvent);
        #endif
 
         if (gc == None)
@@ -1069,7 +1071,8 @@ public:
         // blit results to screen.
        #if JUCE_USE_XSHM
         if (isUsingXShm())
-            X11Symbols::getInstance()->xShmPutImage (display, (::Drawable) window, gc, xImage.get(), sx, sy, dx, dy, dw, dh, True);
+            X11Symbols::getInstance()->xShmPutImage (display, (::Drawable) window, gc, xImage.get(), sx, sy, dx, dy, dw, dh,
+                                                     sendCompletionEvent ? True : False);
         else
        #endif
             X11Symbols::getInstance()->xPutImage (display, (::Drawable) window, gc, xImage.get(), sx, sy, dx, dy, dw, dh);
@@ -2194,17 +2197,35 @@ Image XWindowSystem::createImage (bool isSemiTransparent, int width, int height,
                                     false, (unsigned int) visualAndDepth.depth, visualAndDepth.visual));
 }
 
-void XWindowSystem::blitToWindow (::Window windowH, Image image, Rectangle<int> destinationRect, Rectangle<int> totalRect) const
+void XWindowSystem::blitToWindow (::Window windowH, Image image, const RectangleList<int>& destinationAreas, Rectangle<int> totalRect) const
 {
     jassert (windowH != 0);
 
     auto* xbitmap = static_cast<XBitmapImage*> (image.getPixelData());
+    auto numLeft = destinationAreas.getNumRectangles();
+
+    // The server handles the puts in order, so only the last one needs to tell us when it's
+    // finished with the image. That way the number of pending paints is the number of frames
+    // that are still being uploaded.
+    for (auto& destinationRect : destinationAreas)
+        xbitmap->blitToWindow (windowH,
+                               destinationRect.getX(), destinationRect.getY(),
+                               (unsigned int) destinationRect.getWidth(),
+                               (unsigned int) destinationRect.getHeight(),
+                               destinationRect.getX() - totalRect.getX(), destinationRect.getY() - totalRect.getY(),
+                               --numLeft == 0);
+}
+
+bool XWindowSystem::isUsingSharedMemory (const Image& image) const
+{
+   #if JUCE_USE_XSHM
+    if (auto* xbitmap = dynamic_cast<XBitmapImage*> (image.getPixelData()))
+        return xbitmap->isUsingXShm();
+   #else
+    ignoreUnused (image);
+   #endif
 
-    xbitmap->blitToWindow (windowH,
-                           destinationRect.getX(), destinationRect.getY(),
-                           (unsigned int) destinationRect.getWidth(),
-                           (unsigned int) destinationRect.getHeight(),
-                           destinationRect.getX() - totalRect.getX(), destinationRect.getY() - totalRect.getY());
+    return false;
 }
 
 void XWindowSystem::processPendingPaintsForWindow (::Window windowH)
@@ -4018,4 +4039,101 @@ Image createSnapshotOfNativeWindow (void* window)
     return image.rescaled ((int) ((double) ww / scale), (int) ((double) wh / scale));
 }
 
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class XWindowSystemPaintingTests final : public UnitTest
+{
+public:
+    XWindowSystemPaintingTests() : UnitTest ("XWindowSystem painting", UnitTestCategories::gui) {}
+
+    void runTest() override
+    {
+        beginTest ("Only the repainted areas are uploaded");
+
+        // This needs an X server, so run the tests with something like xvfb-run to include it
+        auto* windowSystem = XWindowSystem::getInstance();
+
+        if (! windowSystem->isX11Available())
+        {
+            logMessage ("No X display available, skipping");
+            return;
+        }
+
+        PaintProfiler profiler;
+        Component window;
+        window.setOpaque (true);
+        window.setBounds (0, 0, 400, 300);
+        window.addToDesktop (0);
+        window.setVisible (true);
+
+        auto* peer = window.getPeer();
+        const auto windowH = (::Window) peer->getNativeHandle();
+        peer->setPaintProfiler (&profiler);
+
+        const auto waitForUploads = [&]
+        {
+            const auto timeout = Time::getMillisecondCounter() + 2000;
+
+            while (windowSystem->getNumPaintsPendingForWindow (windowH) > 0 && Time::getMillisecondCounter() < timeout)
+                windowSystem->processPendingPaintsForWindow (windowH);
+
+            expectEquals (windowSystem->getNumPaintsPendingForWindow (windowH), 0);
+        };
+
+        const auto paintFrame = [&]
+        {
+            waitForUploads();
+            peer->performAnyPendingRepaintsNow();
+
+            expect (profiler.getNumFrames() > 0);
+            return profiler.getFrame (profiler.getNumFrames() - 1);
+        };
+
+        window.repaint();
+        const auto fullFrame = paintFrame();
+        expectEquals (fullFrame.numRectanglesUploaded, 1);
+        expect (fullFrame.numPixelsUploaded >= 400 * 300);
+
+       #if JUCE_USE_XSHM
+        expect (fullFrame.uploadUsedSharedMemory == XSHMHelpers::isShmAvailable (windowSystem->getDisplay()));
+       #endif
+
+        window.repaint (10, 10, 20, 20);
+        window.repaint (300, 200, 20, 20);
+        const auto partialFrame = paintFrame();
+        expectEquals (partialFrame.numRectanglesUploaded, 2);
+        expect (partialFrame.numPixelsUploaded * 100 < fullFrame.numPixelsUploaded);
+
+        if (fullFrame.uploadUsedSharedMemory)
+        {
+            beginTest ("A frame can be painted while the last one is still being uploaded");
+
+            waitForUploads();
+            const auto numFrames = profiler.getNumFrames();
+
+            // Completion events aren't read while we're not looking for them, so the first two
+            // frames use both images, and the third has to wait for one of them to be free
+            for (int i = 0; i < 3; ++i)
+            {
+                window.repaint (0, 0, 10, 10);
+                peer->performAnyPendingRepaintsNow();
+            }
+
+            expectEquals (profiler.getNumFrames(), numFrames + 2);
+            expectEquals (windowSystem->getNumPaintsPendingForWindow (windowH), 2);
+
+            paintFrame();
+            expectEquals (profiler.getNumFrames(), numFrames + 3);
+            waitForUploads();
+        }
+    }
+};
+
+static XWindowSystemPaintingTests xWindowSystemPaintingTests;
+
+#endif
+
 } // namespace juce
@@ -208,7 +208,8 @@ public:
     void removePendingPaintForWindow (::Window);
 
     Image createImage (bool isSemiTransparentWindow, int width, int height, bool argb) const;
-    void blitToWindow (::Window, Image, Rectangle<int> destinationRect, Rectangle<int> totalRect) const;
+    void blitToWindow (::Window, Image, const RectangleList<int>& destinationAreas, Rectangle<int> totalRect) const;
+    bool isUsingSharedMemory (const Image&) const;
 
     void setScreenSaverEnabled (bool enabled) const;
 
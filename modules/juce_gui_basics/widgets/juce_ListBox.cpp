@@ -72,13 +72,15 @@ class ComponentWithListRowMouseBehaviours : public Component
     auto& getOwner() const { return asBase().getOwner(); }
 
 public:
-    void updateRowAndSelection (const int newRow, const bool nowSelected)
+    bool updateRowAndSelection (const int newRow, const bool nowSelected)
     {
         const auto rowChanged       = std::exchange (row,      newRow)      != newRow;
         const auto selectionChanged = std::exchange (selected, nowSelected) != nowSelected;
 
         if (rowChanged || selectionChanged)
             repaint();
+
+        return rowChanged || selectionChanged;
     }
 
     void mouseDown (const MouseEvent& e) override
@@ -163,9 +165,12 @@ public:
             m->paintListBoxItem (getRow(), g, getWidth(), getHeight(), isSelected());
     }
 
-    void update (const int newRow, const bool nowSelected)
+    void update (const int newRow, const bool nowSelected, const bool contentChanged)
     {
-        updateRowAndSelection (newRow, nowSelected);
+        // There's no need to go back to the model when this component is already
+        // showing the right row in the right state
+        if (! updateRowAndSelection (newRow, nowSelected) && ! contentChanged)
+            return;
 
         if (auto* m = owner.getListBoxModel())
         {
@@ -301,6 +306,143 @@ class ListBox::ListViewport final : public Viewport,
                                     private Timer
 {
 public:
+    //==============================================================================
+    /*  Maps between row numbers and y positions within the list's content.
+
+        When all the rows have the same height this is just arithmetic. Otherwise the
+        heights are held in a Fenwick tree, so that finding a row's position or the row
+        at a position is O (log n), and changing one row's height doesn't involve the
+        others. Positions outside the list carry on with the default row height.
+    */
+    class RowPositions
+    {
+    public:
+        void setUniform (int newNumRows, int newDefaultHeight)
+        {
+            numRows = jmax (0, newNumRows);
+            defaultHeight = jmax (1, newDefaultHeight);
+            sums.clear();
+            sums.shrink_to_fit();
+            totalHeight = numRows * defaultHeight;
+        }
+
+        template <typename HeightFunction>
+        void setVariable (int newNumRows, int newDefaultHeight, HeightFunction&& getHeight)
+        {
+            numRows = jmax (0, newNumRows);
+            defaultHeight = jmax (1, newDefaultHeight);
+            sums.assign ((size_t) numRows + 1, 0);
+
+            int64 total = 0;
+
+            for (int i = 1; i <= numRows; ++i)
+            {
+                const auto h = sanitiseHeight (getHeight (i - 1));
+                sums[(size_t) i] += h;
+                total += h;
+
+                const auto parent = i + (i & -i);
+
+                if (parent <= numRows)
+                    sums[(size_t) parent] += sums[(size_t) i];
+            }
+
+            // The list's content is a component, so its total height has to fit in an int
+            jassert (total <= std::numeric_limits<int>::max());
+            totalHeight = (int) total;
+        }
+
+        void setRowHeight (int row, int newHeight)
+        {
+            if (! isVariable() || ! isPositiveAndBelow (row, numRows))
+                return;
+
+            const auto delta = sanitiseHeight (newHeight) - getRowHeight (row);
+
+            if (delta == 0)
+                return;
+
+            for (auto i = row + 1; i <= numRows; i += (i & -i))
+                sums[(size_t) i] += delta;
+
+            totalHeight += delta;
+        }
+
+        bool isVariable() const noexcept        { return ! sums.empty(); }
+        int getDefaultHeight() const noexcept   { return defaultHeight; }
+        int getTotalHeight() const noexcept     { return totalHeight; }
+
+        int getRowY (int row) const noexcept
+        {
+            if (! isVariable() || row <= 0)
+                return row * defaultHeight;
+
+            if (row >= numRows)
+                return totalHeight + (row - numRows) * defaultHeight;
+
+            return getSumOfFirstRows (row);
+        }
+
+        int getRowHeight (int row) const noexcept
+        {
+            if (! isVariable() || ! isPositiveAndBelow (row, numRows))
+                return defaultHeight;
+
+            return getSumOfFirstRows (row + 1) - getSumOfFirstRows (row);
+        }
+
+        /*  Returns the row containing this y position, which may be outside the
+            range of the list's rows.
+        */
+        int getRowAt (int y) const noexcept
+        {
+            if (! isVariable() || y < 0)
+                return y / defaultHeight;
+
+            if (y >= totalHeight)
+                return numRows + (y - totalHeight) / defaultHeight;
+
+            int row = 0;
+
+            for (auto step = (int) nextPowerOfTwo (numRows + 1) / 2; step > 0; step /= 2)
+            {
+                const auto next = row + step;
+
+                if (next <= numRows && sums[(size_t) next] <= y)
+                {
+                    row = next;
+                    y -= sums[(size_t) next];
+                }
+            }
+
+            return row;
+        }
+
+        /*  Returns the first row whose top edge is at or below this y position. */
+        int getFirstRowStartingAt (int y) const noexcept
+        {
+            const auto row = getRowAt (y);
+            return getRowY (row) < y ? row + 1 : row;
+        }
+
+    private:
+        int sanitiseHeight (int h) const noexcept   { return h > 0 ? h : defaultHeight; }
+
+        int getSumOfFirstRows (int count) const noexcept
+        {
+            int sum = 0;
+
+            for (auto i = count; i > 0; i -= (i & -i))
+                sum += sums[(size_t) i];
+
+            return sum;
+        }
+
+        std::vector<int> sums;
+        int numRows = 0, defaultHeight = 22, totalHeight = 0;
+    };
+
+    //==============================================================================
     ListViewport (ListBox& lb)  : owner (lb)
     {
         setWantsKeyboardFocus (false);
@@ -344,6 +486,47 @@ public:
         return index + mod * ((startIndex / mod) + (index < (startIndex % mod) ? 1 : 0));
     }
 
+    const RowPositions& getRowPositions() const noexcept    { return positions; }
+
+    void updateRowPositions()
+    {
+        if (owner.variableRowHeights && owner.model != nullptr)
+            positions.setVariable (owner.totalItems, owner.rowHeight,
+                                   [m = owner.model] (int row) { return m->getHeightForRow (row); });
+        else
+            positions.setUniform (owner.totalItems, owner.rowHeight);
+
+        contentChanged = true;
+    }
+
+    void rowsChanged (const SparseSet<int>& changedRows)
+    {
+        for (int i = 0; i < changedRows.getNumRanges(); ++i)
+        {
+            const auto range = changedRows.getRange (i).getIntersectionWith ({ 0, owner.totalItems });
+
+            if (range.isEmpty())
+                continue;
+
+            if (positions.isVariable())
+                for (auto row = range.getStart(); row < range.getEnd(); ++row)
+                    positions.setRowHeight (row, owner.model->getHeightForRow (row));
+
+            rowsWithChangedContent.addRange (range);
+        }
+
+        updateVisibleArea (owner.isVisible());
+    }
+
+    int getNumRowsOnScreen() const noexcept
+    {
+        if (! positions.isVariable())
+            return getMaximumVisibleHeight() / positions.getDefaultHeight();
+
+        const auto y = getViewPositionY();
+        return jmax (0, positions.getRowAt (y + getMaximumVisibleHeight()) - positions.getFirstRowStartingAt (y));
+    }
+
     void visibleAreaChanged (const Rectangle<int>&) override
     {
         updateVisibleArea (true);
@@ -362,7 +545,7 @@ public:
         auto newX = content.getX();
         auto newY = content.getY();
         auto newW = jmax (owner.minimumRowWidth, getMaximumVisibleWidth());
-        auto newH = owner.totalItems * owner.getRowHeight();
+        auto newH = positions.getTotalHeight();
 
         if (newY + newH < getMaximumVisibleHeight() && newH > getMaximumVisibleHeight())
             newY = getMaximumVisibleHeight() - newH;
@@ -376,44 +559,50 @@ public:
     void updateContents()
     {
         hasUpdated = true;
-        auto rowH = owner.getRowHeight();
         auto& content = *getViewedComponent();
 
-        if (rowH > 0)
-        {
-            auto y = getViewPositionY();
-            auto w = content.getWidth();
+        auto y = getViewPositionY();
+        auto w = content.getWidth();
 
-            const auto numNeeded = (size_t) (4 + getMaximumVisibleHeight() / rowH);
-            rows.resize (jmin (numNeeded, rows.size()));
+        firstIndex = positions.getRowAt (y);
+        firstWholeIndex = positions.getFirstRowStartingAt (y);
+        lastWholeIndex = positions.getRowAt (y + getMaximumVisibleHeight() - 1);
 
-            while (numNeeded > rows.size())
-            {
-                rows.emplace_back (new RowComponent (owner));
-                content.addAndMakeVisible (*rows.back());
-            }
+        const auto numNeeded = (size_t) (4 + (positions.isVariable() ? lastWholeIndex - firstIndex
+                                                                      : getMaximumVisibleHeight() / positions.getDefaultHeight()));
 
-            firstIndex = y / rowH;
-            firstWholeIndex = (y + rowH - 1) / rowH;
-            lastWholeIndex = (y + getMaximumVisibleHeight() - 1) / rowH;
+        // Resizing the pool changes which component shows which row, so with variable
+        // heights it's only allowed to grow while scrolling, rather than following the
+        // number of rows that happen to be on-screen
+        if (contentChanged || ! positions.isVariable())
+            rows.resize (jmin (numNeeded, rows.size()));
+
+        while (numNeeded > rows.size())
+        {
+            rows.emplace_back (new RowComponent (owner));
+            content.addAndMakeVisible (*rows.back());
+        }
 
-            const auto startIndex = getIndexOfFirstVisibleRow();
-            const auto lastIndex = startIndex + (int) rows.size();
+        const auto startIndex = getIndexOfFirstVisibleRow();
+        const auto lastIndex = startIndex + (int) rows.size();
 
-            for (auto row = startIndex; row < lastIndex; ++row)
+        for (auto row = startIndex; row < lastIndex; ++row)
+        {
+            if (auto* rowComp = getComponentForRowIfOnscreen (row))
             {
-                if (auto* rowComp = getComponentForRowIfOnscreen (row))
-                {
-                    rowComp->setBounds (0, row * rowH, w, rowH);
-                    rowComp->update (row, owner.isRowSelected (row));
-                }
-                else
-                {
-                    jassertfalse;
-                }
+                rowComp->setBounds (0, positions.getRowY (row), w, positions.getRowHeight (row));
+                rowComp->update (row, owner.isRowSelected (row),
+                                 contentChanged || rowsWithChangedContent.contains (row));
+            }
+            else
+            {
+                jassertfalse;
             }
         }
 
+        contentChanged = false;
+        rowsWithChangedContent.clear();
+
         if (owner.headerComponent != nullptr)
             owner.headerComponent->setBounds (owner.outlineThickness + content.getX(),
                                               owner.outlineThickness,
@@ -422,14 +611,14 @@ public:
                                               owner.headerComponent->getHeight());
     }
 
-    void selectRow (const int row, const int rowH, const bool dontScroll,
+    void selectRow (const int row, const bool dontScroll,
                     const int lastSelectedRow, const int totalRows, const bool isMouseClick)
     {
         hasUpdated = false;
 
         if (row < firstWholeIndex && ! dontScroll)
         {
-            setViewPosition (getViewPositionX(), row * rowH);
+            setViewPosition (getViewPositionX(), positions.getRowY (row));
         }
         else if (row >= lastWholeIndex && ! dontScroll)
         {
@@ -440,12 +629,12 @@ public:
                  && ! isMouseClick)
             {
                 setViewPosition (getViewPositionX(),
-                                 jlimit (0, jmax (0, totalRows - rowsOnScreen), row) * rowH);
+                                 positions.getRowY (jlimit (0, jmax (0, totalRows - rowsOnScreen), row)));
             }
             else
             {
                 setViewPosition (getViewPositionX(),
-                                 jmax (0, (row  + 1) * rowH - getMaximumVisibleHeight()));
+                                 jmax (0, positions.getRowY (row + 1) - getMaximumVisibleHeight()));
             }
         }
 
@@ -453,16 +642,16 @@ public:
             updateContents();
     }
 
-    void scrollToEnsureRowIsOnscreen (const int row, const int rowH)
+    void scrollToEnsureRowIsOnscreen (const int row)
     {
         if (row < firstWholeIndex)
         {
-            setViewPosition (getViewPositionX(), row * rowH);
+            setViewPosition (getViewPositionX(), positions.getRowY (row));
         }
         else if (row >= lastWholeIndex)
         {
             setViewPosition (getViewPositionX(),
-                             jmax (0, (row  + 1) * rowH - getMaximumVisibleHeight()));
+                             jmax (0, positions.getRowY (row + 1) - getMaximumVisibleHeight()));
         }
     }
 
@@ -505,8 +694,10 @@ private:
 
     ListBox& owner;
     std::vector<std::unique_ptr<RowComponent>> rows;
+    RowPositions positions;
+    SparseSet<int> rowsWithChangedContent;
     int firstIndex = 0, firstWholeIndex = 0, lastWholeIndex = 0;
-    bool hasUpdated = false;
+    bool hasUpdated = false, contentChanged = true;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ListViewport)
 };
@@ -650,6 +841,7 @@ void ListBox::updateContent()
         selectionChanged = true;
     }
 
+    viewport->updateRowPositions();
     viewport->updateVisibleArea (isVisible());
     viewport->resized();
 
@@ -663,6 +855,16 @@ void ListBox::updateContent()
     }
 }
 
+void ListBox::updateRows (const SparseSet<int>& rowsThatChanged)
+{
+    checkModelPtrIsValid();
+
+    if (! hasDoneInitialUpdate || model == nullptr || model->getNumRows() != totalItems)
+        updateContent();
+    else
+        viewport->rowsChanged (rowsThatChanged);
+}
+
 //==============================================================================
 void ListBox::selectRow (int row, bool dontScroll, bool deselectOthersFirst)
 {
@@ -692,8 +894,7 @@ void ListBox::selectRowInternal (const int row,
             if (getHeight() == 0 || getWidth() == 0)
                 dontScroll = true;
 
-            viewport->selectRow (row, getRowHeight(), dontScroll,
-                                 lastRowSelected, totalItems, isMouseClick);
+            viewport->selectRow (row, dontScroll, lastRowSelected, totalItems, isMouseClick);
 
             lastRowSelected = row;
             model->selectedRowsChanged (row);
@@ -841,7 +1042,7 @@ int ListBox::getRowContainingPosition (const int x, const int y) const noexcept
 {
     if (isPositiveAndBelow (x, getWidth()))
     {
-        const int row = (viewport->getViewPositionY() + y - viewport->getY()) / rowHeight;
+        const int row = viewport->getRowPositions().getRowAt (viewport->getViewPositionY() + y - viewport->getY());
 
         if (isPositiveAndBelow (row, totalItems))
             return row;
@@ -853,7 +1054,14 @@ int ListBox::getRowContainingPosition (const int x, const int y) const noexcept
 int ListBox::getInsertionIndexForPosition (const int x, const int y) const noexcept
 {
     if (isPositiveAndBelow (x, getWidth()))
-        return jlimit (0, totalItems, (viewport->getViewPositionY() + y + rowHeight / 2 - viewport->getY()) / rowHeight);
+    {
+        auto& positions = viewport->getRowPositions();
+        const auto contentY = viewport->getViewPositionY() + y - viewport->getY();
+        const auto row = positions.getRowAt (contentY);
+        const auto rowH = positions.getRowHeight (row);
+
+        return jlimit (0, totalItems, contentY - positions.getRowY (row) >= rowH - rowH / 2 ? row + 1 : row);
+    }
 
     return -1;
 }
@@ -873,13 +1081,14 @@ int ListBox::getRowNumberOfComponent (const Component* const rowComponent) const
 
 Rectangle<int> ListBox::getRowPosition (int rowNumber, bool relativeToComponentTopLeft) const noexcept
 {
-    auto y = viewport->getY() + rowHeight * rowNumber;
+    auto& positions = viewport->getRowPositions();
+    auto y = viewport->getY() + positions.getRowY (rowNumber);
 
     if (relativeToComponentTopLeft)
         y -= viewport->getViewPositionY();
 
     return { viewport->getX(), y,
-             viewport->getViewedComponent()->getWidth(), rowHeight };
+             viewport->getViewedComponent()->getWidth(), positions.getRowHeight (rowNumber) };
 }
 
 void ListBox::setVerticalPosition (const double proportion)
@@ -905,7 +1114,7 @@ int ListBox::getVisibleRowWidth() const noexcept
 
 void ListBox::scrollToEnsureRowIsOnscreen (const int row)
 {
-    viewport->scrollToEnsureRowIsOnscreen (row, getRowHeight());
+    viewport->scrollToEnsureRowIsOnscreen (row);
 }
 
 //==============================================================================
@@ -913,7 +1122,8 @@ bool ListBox::keyPressed (const KeyPress& key)
 {
     checkModelPtrIsValid();
 
-    const int numVisibleRows = viewport->getHeight() / getRowHeight();
+    const int numVisibleRows = variableRowHeights ? jmax (1, getNumRowsOnScreen())
+                                                  : viewport->getHeight() / getRowHeight();
 
     const bool multiple = multipleSelection
                             && lastRowSelected >= 0
@@ -1032,15 +1242,22 @@ void ListBox::setRowHeight (const int newHeight)
     updateContent();
 }
 
+void ListBox::setVariableRowHeightsEnabled (const bool shouldBeEnabled)
+{
+    if (std::exchange (variableRowHeights, shouldBeEnabled) != shouldBeEnabled)
+        updateContent();
+}
+
 int ListBox::getNumRowsOnScreen() const noexcept
 {
-    return viewport->getMaximumVisibleHeight() / rowHeight;
+    return viewport->getNumRowsOnScreen();
 }
 
 void ListBox::setMinimumContentWidth (const int newMinimumWidth)
 {
-    minimumRowWidth = newMinimumWidth;
-    updateContent();
+    // This only changes the width of the rows, so there's no need to re-query the model
+    if (std::exchange (minimumRowWidth, newMinimumWidth) != newMinimumWidth)
+        viewport->updateVisibleArea (isVisible());
 }
 
 int ListBox::getVisibleContentWidth() const noexcept            { return viewport->getMaximumVisibleWidth(); }
@@ -1250,5 +1467,155 @@ void ListBoxModel::listWasScrolled() {}
 var ListBoxModel::getDragSourceDescription (const SparseSet<int>&)      { return {}; }
 String ListBoxModel::getTooltipForRow (int)                             { return {}; }
 MouseCursor ListBoxModel::getMouseCursorForRow (int)                    { return MouseCursor::NormalCursor; }
+int ListBoxModel::getHeightForRow (int)                                 { return 0; }
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ListBoxTests final : public UnitTest
+{
+public:
+    ListBoxTests() : UnitTest ("ListBox", UnitTestCategories::gui) {}
+
+    void runTest() override
+    {
+        auto r = getRandom();
+
+        beginTest ("Variable row heights");
+        {
+            TestModel model;
+
+            for (int i = 0; i < 5000; ++i)
+                model.heights.push_back (r.nextInt (4) == 0 ? 0 : 1 + r.nextInt (60));
+
+            ListBox list ({}, &model);
+            list.setBounds (0, 0, 200, 300);
+            list.setVisible (true);
+            list.setVariableRowHeightsEnabled (true);
+
+            expectRowPositionsMatch (list, model, r);
+
+            SparseSet<int> changed;
+
+            for (int i = 0; i < 50; ++i)
+            {
+                const auto row = r.nextInt ((int) model.heights.size());
+                model.heights[(size_t) row] = r.nextInt (100);
+                changed.addRange ({ row, row + 1 });
+            }
+
+            list.updateRows (changed);
+            expectRowPositionsMatch (list, model, r);
+
+            model.heights.resize (3000);
+            list.updateContent();
+            expectRowPositionsMatch (list, model, r);
+
+            list.setVariableRowHeightsEnabled (false);
+            expectEquals (list.getRowPosition (2999, false).getBottom() - list.getRowPosition (0, false).getY(),
+                          3000 * list.getRowHeight());
+        }
+
+        beginTest ("Rows are only re-queried when they change");
+        {
+            TestModel model;
+            model.heights.resize (1000);
+
+            ListBox list ({}, &model);
+            list.setBounds (0, 0, 200, 220);
+            list.setVisible (true);
+
+            model.numRefreshes = 0;
+            list.updateContent();
+
+            const auto numOnScreen = model.numRefreshes;
+            expectGreaterThan (numOnScreen, list.getNumRowsOnScreen());
+
+            model.numRefreshes = 0;
+            list.getViewport()->setViewPosition (0, 2 * list.getRowHeight());
+            expectEquals (model.numRefreshes, 1);
+
+            model.numRefreshes = 0;
+            list.selectRow (3);
+            expectEquals (model.numRefreshes, 1);
+
+            model.numRefreshes = 0;
+            list.selectRow (4);
+            expectEquals (model.numRefreshes, 2);
+
+            SparseSet<int> changed;
+            changed.addRange ({ 5, 7 });
+            changed.addRange ({ 500, 600 });
+
+            model.numRefreshes = 0;
+            list.updateRows (changed);
+            expectEquals (model.numRefreshes, 2);
+
+            model.numRefreshes = 0;
+            list.updateContent();
+            expectEquals (model.numRefreshes, numOnScreen);
+        }
+    }
+
+private:
+    struct TestModel final : public ListBoxModel
+    {
+        int getNumRows() override                          { return (int) heights.size(); }
+        void paintListBoxItem (int, Graphics&, int, int, bool) override {}
+        int getHeightForRow (int row) override             { return heights[(size_t) row]; }
+
+        Component* refreshComponentForRow (int, bool, Component* existing) override
+        {
+            ++numRefreshes;
+            return existing != nullptr ? existing : new Component();
+        }
+
+        std::vector<int> heights;
+        int numRefreshes = 0;
+    };
+
+    void expectRowPositionsMatch (ListBox& list, TestModel& model, Random& r)
+    {
+        const auto origin = list.getRowPosition (0, false).getY();
+        const auto numRows = (int) model.heights.size();
+        int y = 0;
+
+        for (int row = 0; row < numRows; ++row)
+        {
+            const auto h = model.heights[(size_t) row] > 0 ? model.heights[(size_t) row] : list.getRowHeight();
+            const auto pos = list.getRowPosition (row, false);
+
+            expectEquals (pos.getY() - origin, y);
+            expectEquals (pos.getHeight(), h);
+            y += h;
+        }
+
+        expectEquals (list.getViewport()->getViewedComponent()->getHeight(), y);
+
+        for (int i = 0; i < 20; ++i)
+        {
+            const auto row = r.nextInt (numRows);
+            list.scrollToEnsureRowIsOnscreen (row);
+
+            const auto pos = list.getRowPosition (row, true);
+            expect (list.getRowContainingPosition (10, pos.getY()) == row);
+            expect (list.getRowContainingPosition (10, pos.getBottom() - 1) == row);
+            expect (list.getInsertionIndexForPosition (10, pos.getY()) == row);
+
+            if (pos.getHeight() > 1)
+                expect (list.getInsertionIndexForPosition (10, pos.getBottom() - 1) == row + 1);
+
+            if (auto* comp = list.getComponentForRowNumber (row))
+                expectEquals (comp->getHeight(), pos.getHeight());
+            else
+                expect (false, "no component for visible row");
+        }
+    }
+};
+
+static ListBoxTests listBoxTests;
+
+#endif
 
 } // namespace juce
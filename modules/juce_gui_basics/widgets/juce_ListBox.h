@@ -169,6 +169,17 @@ public:
     /** You can override this to return a custom mouse cursor for each row. */
     virtual MouseCursor getMouseCursorForRow (int row);
 
+    /** Returns the height that a particular row should have.
+
+        This is only called if ListBox::setVariableRowHeightsEnabled() has been turned on.
+        In that case it'll be called for every row when ListBox::updateContent() is called,
+        and for just the rows concerned when ListBox::updateRows() is called, so it needs
+        to be quick. Returning 0 makes the row use the ListBox's default row height.
+
+        @see ListBox::setVariableRowHeightsEnabled, ListBox::setRowHeight
+    */
+    virtual int getHeightForRow (int rowNumber);
+
 private:
    #if ! JUCE_DISABLE_ASSERTIONS
     friend class ListBox;
@@ -237,9 +248,26 @@ public:
         to call refreshComponentForRow() on all the row components.
 
         This must only be called from the main message thread.
+
+        @see updateRows
     */
     void updateContent();
 
+    /** Refreshes just some of the rows in the list.
+
+        Call this when the content of some rows has changed but the number of rows hasn't.
+        Only the rows in this set will be re-queried: refreshComponentForRow() is called for
+        those that are on-screen, and if variable row heights are enabled, their heights are
+        re-read from the model. If the number of rows has changed, this falls back to
+        updateContent().
+
+        Scrolling and selection changes only refresh the row components whose row or selection
+        state actually changed, so you only need this (or updateContent()) when your data changes.
+
+        This must only be called from the main message thread.
+    */
+    void updateRows (const SparseSet<int>& rowsThatChanged);
+
     //==============================================================================
     /** Turns on multiple-selection of rows.
 
@@ -480,14 +508,37 @@ public:
     void setRowHeight (int newHeight);
 
     /** Returns the height of a row in the list.
+
+        If variable row heights are enabled, this is the default height used for rows
+        whose height the model doesn't specify; use getRowPosition() to find the height
+        of a particular row.
+
         @see setRowHeight
     */
     int getRowHeight() const noexcept                   { return rowHeight; }
 
+    /** Enables rows of different heights.
+
+        When this is enabled, the list calls ListBoxModel::getHeightForRow() to find the height
+        of each row. The heights are kept in an index so that finding a row's position, or the
+        row at a position, doesn't depend on the number of rows, but the model is asked for every
+        row's height whenever updateContent() is called. Use updateRows() when only some rows
+        have changed.
+
+        By default this is disabled, and all rows have the height set by setRowHeight().
+    */
+    void setVariableRowHeightsEnabled (bool shouldBeEnabled);
+
+    /** Returns true if variable row heights have been enabled.
+        @see setVariableRowHeightsEnabled
+    */
+    bool areVariableRowHeightsEnabled() const noexcept  { return variableRowHeights; }
+
     /** Returns the number of rows actually visible.
 
         This is the number of whole rows which will fit on-screen, so the value might
-        be more than the actual number of rows in the list.
+        be more than the actual number of rows in the list. If variable row heights are
+        enabled, it's the number of whole rows visible at the current scroll position.
     */
     int getNumRowsOnScreen() const noexcept;
 
@@ -630,6 +681,7 @@ private:
     int outlineThickness = 0;
     int lastRowSelected = -1;
     bool multipleSelection = false, alwaysFlipSelection = false, hasDoneInitialUpdate = false, selectOnMouseDown = true;
+    bool variableRowHeights = false;
 
    #if ! JUCE_DISABLE_ASSERTIONS
     std::weak_ptr<ListBoxModel::Empty> weakModelPtr;
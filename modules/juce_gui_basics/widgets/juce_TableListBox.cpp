@@ -506,9 +506,16 @@ void TableListBox::listWasScrolled()
         model->listWasScrolled();
 }
 
+int TableListBox::getHeightForRow (int row)
+{
+    return model != nullptr ? model->getHeightForRow (row) : 0;
+}
+
 void TableListBox::tableColumnsChanged (TableHeaderComponent*)
 {
+    // The set of columns may be different, so the cells all need to be re-queried
     setMinimumContentWidth (header->getTotalWidth());
+    updateContent();
     repaint();
     updateColumnComponents();
 }
@@ -662,6 +669,7 @@ void TableListBoxModel::cellDoubleClicked (int, int, const MouseEvent&) {}
 void TableListBoxModel::backgroundClicked (const MouseEvent&)           {}
 void TableListBoxModel::sortOrderChanged (int, bool)                    {}
 int TableListBoxModel::getColumnAutoSizeWidth (int)                     { return 0; }
+int TableListBoxModel::getHeightForRow (int)                            { return 0; }
 void TableListBoxModel::selectedRowsChanged (int)                       {}
 void TableListBoxModel::deleteKeyPressed (int)                          {}
 void TableListBoxModel::returnKeyPressed (int)                          {}
@@ -153,6 +153,15 @@ public:
     /** Returns a tooltip for a particular cell in the table. */
     virtual String getCellTooltip (int rowNumber, int columnId);
 
+    /** Returns the height that a particular row should have.
+
+        This is only used if ListBox::setVariableRowHeightsEnabled() has been turned on for
+        the table. Returning 0 makes the row use the table's default row height.
+
+        @see ListBoxModel::getHeightForRow
+    */
+    virtual int getHeightForRow (int rowNumber);
+
     //==============================================================================
     /** Override this to be informed when rows are selected or deselected.
         @see ListBox::selectedRowsChanged()
@@ -322,6 +331,8 @@ public:
     /** @internal */
     void listWasScrolled() override;
     /** @internal */
+    int getHeightForRow (int rowNumber) override;
+    /** @internal */
     void tableColumnsChanged (TableHeaderComponent*) override;
     /** @internal */
     void tableColumnsResized (TableHeaderComponent*) override;
@@ -31,13 +31,23 @@ struct TextAtom
 {
     //==============================================================================
     String atomText;
-    float width;
+    mutable float width = -1.0f;    // negative until the atom is first measured
     int numChars;
 
     //==============================================================================
     bool isWhitespace() const noexcept       { return CharacterFunctions::isWhitespace (atomText[0]); }
     bool isNewLine() const noexcept          { return atomText[0] == '\r' || atomText[0] == '\n'; }
 
+    // Shaping the text is by far the slowest part of creating an atom, so it's left until
+    // the layout actually reaches it.
+    float getWidth (const Font& font, juce_wchar passwordCharacter) const
+    {
+        if (width < 0.0f)
+            width = isNewLine() ? 0.0f : font.getStringWidthFloat (getText (passwordCharacter));
+
+        return width;
+    }
+
     String getText (juce_wchar passwordCharacter) const
     {
         if (passwordCharacter == 0)
@@ -81,33 +91,23 @@ public:
     {
         if (! other.atoms.isEmpty())
         {
+            totalLength += other.totalLength;
             int i = 0;
 
-            if (! atoms.isEmpty())
-            {
-                auto& lastAtom = atoms.getReference (atoms.size() - 1);
-
-                if (! CharacterFunctions::isWhitespace (lastAtom.atomText.getLastCharacter()))
-                {
-                    auto& first = other.atoms.getReference (0);
-
-                    if (! CharacterFunctions::isWhitespace (first.atomText[0]))
-                    {
-                        lastAtom.atomText += first.atomText;
-                        lastAtom.numChars = (uint16) (lastAtom.numChars + first.numChars);
-                        lastAtom.width = font.getStringWidthFloat (lastAtom.getText (passwordChar));
-                        ++i;
-                    }
-                }
-            }
+            if (! atoms.isEmpty() && joinIfSameWord (atoms.getReference (atoms.size() - 1), other.atoms.getReference (0)))
+                ++i;
 
             atoms.ensureStorageAllocated (atoms.size() + other.atoms.size() - i);
 
+            // the other section is about to be deleted, so its atoms can be moved rather than copied
             while (i < other.atoms.size())
             {
-                atoms.add (other.atoms.getReference (i));
+                atoms.add (std::move (other.atoms.getReference (i)));
                 ++i;
             }
+
+            other.atoms.clearQuick();
+            other.totalLength = 0;
         }
     }
 
@@ -123,10 +123,7 @@ public:
 
             if (index == indexToBreakAt)
             {
-                for (int j = i; j < atoms.size(); ++j)
-                    section2->atoms.add (atoms.getUnchecked (j));
-
-                atoms.removeRange (i, atoms.size());
+                moveAtomsTo (*section2, i);
                 break;
             }
 
@@ -134,19 +131,17 @@ public:
             {
                 TextAtom secondAtom;
                 secondAtom.atomText = atom.atomText.substring (indexToBreakAt - index);
-                secondAtom.width = font.getStringWidthFloat (secondAtom.getText (passwordChar));
                 secondAtom.numChars = (uint16) secondAtom.atomText.length();
 
                 section2->atoms.add (secondAtom);
 
                 atom.atomText = atom.atomText.substring (0, indexToBreakAt - index);
-                atom.width = font.getStringWidthFloat (atom.getText (passwordChar));
+                atom.width = -1.0f;
                 atom.numChars = (uint16) (indexToBreakAt - index);
 
-                for (int j = i + 1; j < atoms.size(); ++j)
-                    section2->atoms.add (atoms.getUnchecked (j));
-
-                atoms.removeRange (i + 1, atoms.size());
+                section2->totalLength = secondAtom.numChars;
+                totalLength -= secondAtom.numChars;
+                moveAtomsTo (*section2, i + 1);
                 break;
             }
 
@@ -156,6 +151,79 @@ public:
         return section2;
     }
 
+    // Inserts some text in this section's font and colour. The atoms end up the same as they
+    // would after splitting the section, adding the text as a new section and coalescing them
+    // again, but only the atoms around the insertion point have to be touched.
+    void insertText (int indexToInsertAt, const String& text)
+    {
+        const UniformTextSection inserted (text, font, colour, passwordChar);
+
+        int atomIndex = 0, index = 0;
+
+        while (atomIndex < atoms.size() && index + atoms.getReference (atomIndex).numChars <= indexToInsertAt)
+            index += atoms.getReference (atomIndex++).numChars;
+
+        // The atoms either side of the insertion point may join up with the new text, so
+        // they're replaced along with it
+        Array<TextAtom> replacement;
+        int firstReplaced = atomIndex, numBefore = 0, numAfter = 0;
+
+        if (index < indexToInsertAt)
+        {
+            auto& atom = atoms.getReference (atomIndex);
+
+            TextAtom before, after;
+            before.atomText = atom.atomText.substring (0, indexToInsertAt - index);
+            before.numChars = (uint16) (indexToInsertAt - index);
+            after.atomText = atom.atomText.substring (indexToInsertAt - index);
+            after.numChars = (uint16) after.atomText.length();
+
+            replacement.add (before);
+            replacement.addArray (inserted.atoms);
+            replacement.add (after);
+            numBefore = numAfter = 1;
+        }
+        else
+        {
+            if (atomIndex > 0)
+            {
+                replacement.add (atoms.getReference (--firstReplaced));
+                numBefore = 1;
+            }
+
+            replacement.addArray (inserted.atoms);
+
+            if (atomIndex < atoms.size())
+            {
+                replacement.add (atoms.getReference (atomIndex));
+                numAfter = 1;
+            }
+        }
+
+        const auto numReplaced = numBefore + numAfter - (index < indexToInsertAt ? 1 : 0);
+
+        if (numBefore > 0 && joinIfSameWord (replacement.getReference (0), replacement.getReference (1)))
+            replacement.remove (1);
+
+        const auto lastInserted = replacement.size() - numAfter - 1;
+
+        if (numAfter > 0 && lastInserted >= 0
+             && joinIfSameWord (replacement.getReference (lastInserted), replacement.getReference (lastInserted + 1)))
+            replacement.remove (lastInserted + 1);
+
+        const auto numReused = jmin (numReplaced, replacement.size());
+
+        for (int i = 0; i < numReused; ++i)
+            atoms.getReference (firstReplaced + i) = std::move (replacement.getReference (i));
+
+        if (replacement.size() > numReplaced)
+            atoms.insertArray (firstReplaced + numReused, replacement.begin() + numReused, replacement.size() - numReused);
+        else
+            atoms.removeRange (firstReplaced + numReused, numReplaced - numReused);
+
+        totalLength += inserted.totalLength;
+    }
+
     void appendAllText (MemoryOutputStream& mo) const
     {
         for (auto& atom : atoms)
@@ -187,12 +255,7 @@ public:
 
     int getTotalLength() const noexcept
     {
-        int total = 0;
-
-        for (auto& atom : atoms)
-            total += atom.numChars;
-
-        return total;
+        return totalLength;
     }
 
     void setFont (const Font& newFont, const juce_wchar passwordCharToUse)
@@ -203,7 +266,7 @@ public:
             passwordChar = passwordCharToUse;
 
             for (auto& atom : atoms)
-                atom.width = newFont.getStringWidthFloat (atom.getText (passwordChar));
+                atom.width = -1.0f;
         }
     }
 
@@ -214,6 +277,37 @@ public:
     juce_wchar passwordChar;
 
 private:
+    int totalLength = 0;
+
+    // Adds the second atom onto the end of the first if they're both parts of the same word.
+    static bool joinIfSameWord (TextAtom& first, const TextAtom& second)
+    {
+        if (CharacterFunctions::isWhitespace (first.atomText.getLastCharacter())
+             || CharacterFunctions::isWhitespace (second.atomText[0]))
+            return false;
+
+        first.atomText += second.atomText;
+        first.numChars = (uint16) (first.numChars + second.numChars);
+        first.width = -1.0f;
+        return true;
+    }
+
+    // Moves the atoms from startAtom onwards to the end of another section.
+    void moveAtomsTo (UniformTextSection& other, int startAtom)
+    {
+        other.atoms.ensureStorageAllocated (other.atoms.size() + atoms.size() - startAtom);
+
+        for (int j = startAtom; j < atoms.size(); ++j)
+        {
+            auto& atom = atoms.getReference (j);
+            other.totalLength += atom.numChars;
+            totalLength -= atom.numChars;
+            other.atoms.add (std::move (atom));
+        }
+
+        atoms.removeRange (startAtom, atoms.size());
+    }
+
     void initialiseAtoms (const String& textToParse)
     {
         auto text = textToParse.getCharPointer();
@@ -263,9 +357,9 @@ private:
 
             TextAtom atom;
             atom.atomText = String (start, numChars);
-            atom.width = (atom.isNewLine() ? 0.0f : font.getStringWidthFloat (atom.getText (passwordChar)));
             atom.numChars = (uint16) numChars;
-            atoms.add (atom);
+            totalLength += atom.numChars;
+            atoms.add (std::move (atom));
         }
     }
 
@@ -300,6 +394,54 @@ struct TextEditor::Iterator
     Iterator (const Iterator&) = default;
     Iterator& operator= (const Iterator&) = delete;
 
+    //==============================================================================
+    // The layout state just after a new-line atom, which is all that's needed to carry
+    // on iterating from that point.
+    struct Position
+    {
+        int sectionIndex, atomIndex, indexInText;
+        float lineY, lineHeight, maxDescent, atomX, atomRight;
+    };
+
+    bool isAtNewLine() const noexcept
+    {
+        return atom != nullptr && atom != &longAtom && atom->isNewLine();
+    }
+
+    Position getPosition() const noexcept
+    {
+        jassert (isAtNewLine());
+        return { sectionIndex, atomIndex, indexInText, lineY, lineHeight, maxDescent, atomX, atomRight };
+    }
+
+    bool setPosition (const Position& p)
+    {
+        if (! isPositiveAndBelow (p.sectionIndex, sections.size()))
+            return false;
+
+        auto* section = sections.getUnchecked (p.sectionIndex);
+
+        if (p.atomIndex <= 0 || p.atomIndex > section->atoms.size())
+            return false;
+
+        auto& newLineAtom = section->atoms.getReference (p.atomIndex - 1);
+
+        if (! newLineAtom.isNewLine())
+            return false;
+
+        currentSection = section;
+        sectionIndex = p.sectionIndex;
+        atomIndex = p.atomIndex;
+        atom = &newLineAtom;
+        indexInText = p.indexInText;
+        lineY = p.lineY;
+        lineHeight = p.lineHeight;
+        maxDescent = p.maxDescent;
+        atomX = p.atomX;
+        atomRight = p.atomRight;
+        return true;
+    }
+
     //==============================================================================
     bool next()
     {
@@ -335,7 +477,7 @@ struct TextEditor::Iterator
                 {
                     // handle the case where the last atom in a section is actually part of the same
                     // word as the first atom of the next section...
-                    float right = atomRight + lastAtom.width;
+                    float right = atomRight + lastAtom.getWidth (currentSection->font, currentSection->passwordChar);
                     float lineHeight2 = lineHeight;
                     float maxDescent2 = maxDescent;
 
@@ -351,7 +493,7 @@ struct TextEditor::Iterator
                         if (nextAtom.isWhitespace())
                             break;
 
-                        right += nextAtom.width;
+                        right += nextAtom.getWidth (s->font, s->passwordChar);
 
                         lineHeight2 = jmax (lineHeight2, s->font.getHeight());
                         maxDescent2 = jmax (maxDescent2, s->font.getDescent());
@@ -386,7 +528,7 @@ struct TextEditor::Iterator
         }
 
         atom = &(currentSection->atoms.getReference (atomIndex));
-        atomRight = atomX + atom->width;
+        atomRight = atomX + atom->getWidth (currentSection->font, currentSection->passwordChar);
         ++atomIndex;
 
         if (shouldWrap (atomRight) || forceNewLine)
@@ -450,7 +592,7 @@ struct TextEditor::Iterator
                 break;
 
             auto& nextAtom = section->atoms.getReference (tempAtomIndex);
-            nextLineWidth += nextAtom.width;
+            nextLineWidth += nextAtom.getWidth (section->font, section->passwordChar);
 
             if (shouldWrap (nextLineWidth) || nextAtom.isNewLine())
                 break;
@@ -633,10 +775,9 @@ struct TextEditor::Iterator
         return bottom * 0.5f;
     }
 
-    int getTotalTextHeight()
+    // Only valid once next() has returned false
+    int getTotalTextHeightAtEnd()
     {
-        while (next()) {}
-
         auto height = lineY + lineHeight + getYOffset();
 
         if (atom != nullptr && atom->isNewLine())
@@ -645,16 +786,6 @@ struct TextEditor::Iterator
         return roundToInt (height);
     }
 
-    int getTextRight()
-    {
-        float maxWidth = 0.0f;
-
-        while (next())
-            maxWidth = jmax (maxWidth, atomRight);
-
-        return roundToInt (maxWidth);
-    }
-
     Rectangle<int> getTextBounds (Range<int> range) const
     {
         auto startX = indexToX (range.getStart());
@@ -740,6 +871,277 @@ private:
 };
 
 
+//==============================================================================
+// Keeps the iterator's state at the start of every paragraph, so that painting and
+// hit-testing can start near the text they need instead of at the top of the document,
+// and so that after an edit only the paragraphs that actually moved get laid out again.
+//
+// The text is only laid out as far as something has asked about. Anything beyond that is
+// laid out a step at a time on a timer, and until it's done the size of the text is an
+// estimate based on the part that has been laid out.
+struct TextEditor::LayoutCache  : private Timer
+{
+    explicit LayoutCache (TextEditor& ed)  : owner (ed) {}
+
+    void reset()
+    {
+        paragraphs.clear();
+        stale.clear();
+        isComplete = false;
+    }
+
+    void textChanged (int index, int numRemoved, int numInserted)
+    {
+        // Paragraphs that follow the edit may still be valid once the new layout catches
+        // up with them, so they're kept as candidates to splice back in. Any left over from
+        // an earlier edit that hasn't been laid out yet can only be kept if they come first,
+        // otherwise they'd need two different adjustments.
+        std::vector<Paragraph> candidates;
+
+        auto firstInvalid = std::partition_point (paragraphs.begin(), paragraphs.end(),
+                                                  [index] (const Paragraph& p) { return p.start <= index; });
+
+        for (auto it = firstInvalid; it != paragraphs.end(); ++it)
+        {
+            if (it->position.indexInText >= index + numRemoved)
+            {
+                candidates.push_back (*it);
+                candidates.back().start += numInserted - numRemoved;
+                candidates.back().position.indexInText += numInserted - numRemoved;
+            }
+        }
+
+        for (auto& p : stale)
+            if (p.position.indexInText < index)
+                candidates.push_back (p);
+
+        paragraphs.erase (firstInvalid, paragraphs.end());
+        stale = std::move (candidates);
+        isComplete = false;
+    }
+
+    // Moves the iterator to the start of the paragraph containing the given character.
+    void skipToIndex (const TextEditor& ed, Iterator& i, int index)
+    {
+        layOutUntil (ed, [index] (const Paragraph& p) { return p.start > index; });
+
+        restore (i, std::partition_point (paragraphs.begin(), paragraphs.end(),
+                                          [index] (const Paragraph& p) { return p.start <= index; }));
+    }
+
+    // Moves the iterator to the start of the last paragraph whose preceding text is all
+    // above the given y position.
+    void skipToY (const TextEditor& ed, Iterator& i, float y)
+    {
+        layOutUntil (ed, [y] (const Paragraph& p) { return p.bottomBefore >= y; });
+
+        restore (i, std::partition_point (paragraphs.begin(), paragraphs.end(),
+                                          [y] (const Paragraph& p) { return p.bottomBefore < y; }));
+    }
+
+    int getTextHeight (const TextEditor& ed)
+    {
+        layOutFirstStep (ed);
+
+        if (isComplete)
+            return textHeight;
+
+        const auto& last = paragraphs.back();
+        return roundToInt (last.bottomBefore * (float) ed.getTotalNumChars() / (float) jmax (1, last.start));
+    }
+
+    int getTextRight (const TextEditor& ed)
+    {
+        layOutFirstStep (ed);
+
+        const auto right = paragraphs.empty() ? 0.0f : paragraphs.back().rightBefore;
+        return roundToInt (isComplete ? jmax (right, tailRight) : right);
+    }
+
+    // Lays out whatever is left, and brings the editor's size up to date if it was
+    // still using an estimate.
+    void finish()
+    {
+        if (isComplete && ! isTimerRunning())
+            return;
+
+        stopTimer();
+        layOutUntil (owner, [] (const Paragraph&) { return false; });
+        owner.checkLayout();
+    }
+
+private:
+    struct Paragraph
+    {
+        Iterator::Position position;   // the state just after the new-line that ends the previous paragraph
+        int start;                     // the index of the first character in this paragraph
+        float right, bottom;           // the extent of the atoms up to and including that new-line
+        float rightBefore;             // the furthest right edge of all the text before this paragraph
+        float bottomBefore;            // the lowest bottom edge of all the text before this paragraph
+    };
+
+    using Parameters = std::tuple<int, int, int, int, juce_wchar, float, float>;
+
+    // roughly how much text can be laid out in a few milliseconds
+    static constexpr int charactersPerStep = 65536;
+
+    TextEditor& owner;
+    std::vector<Paragraph> paragraphs, stale;
+    Parameters parameters;
+    bool isComplete = false;
+    int textHeight = 0;
+    float tailRight = 0.0f;
+
+    static Parameters getParameters (const TextEditor& ed)
+    {
+        return { ed.justification.getFlags(), ed.getMaximumTextWidth(), ed.getMaximumTextHeight(),
+                 ed.getWordWrapWidth(), ed.passwordCharacter, ed.lineSpacing, ed.currentFont.getHeight() };
+    }
+
+    void restore (Iterator& i, std::vector<Paragraph>::const_iterator next) const
+    {
+        if (next != paragraphs.begin())
+        {
+            const auto ok = i.setPosition (std::prev (next)->position);
+            ignoreUnused (ok);
+            jassert (ok);
+        }
+    }
+
+    // Short documents are laid out in one go, so their size is always exact. Anything
+    // longer is finished off in the background.
+    void layOutFirstStep (const TextEditor& ed)
+    {
+        layOutUntil (ed, [] (const Paragraph& p) { return p.start >= charactersPerStep; });
+
+        if (! isComplete && ! isTimerRunning())
+            startTimer (10);
+    }
+
+    void timerCallback() override
+    {
+        const auto end = (paragraphs.empty() ? 0 : paragraphs.back().start) + charactersPerStep;
+        layOutUntil (owner, [end] (const Paragraph& p) { return p.start >= end; });
+
+        if (isComplete)
+            stopTimer();
+
+        owner.checkLayout();
+    }
+
+    template <typename Predicate>
+    void layOutUntil (const TextEditor& ed, Predicate&& isFarEnough)
+    {
+        const auto newParameters = getParameters (ed);
+
+        if (newParameters != parameters)
+        {
+            reset();
+            parameters = newParameters;
+        }
+
+        if (isComplete || (! paragraphs.empty() && isFarEnough (paragraphs.back())))
+            return;
+
+        if (! layOut (ed, isFarEnough))
+        {
+            // the cached positions didn't match the text, so start again from scratch
+            jassertfalse;
+            reset();
+            layOut (ed, isFarEnough);
+        }
+    }
+
+    // Carries on from the last paragraph until one satisfies the predicate or the text runs out.
+    template <typename Predicate>
+    bool layOut (const TextEditor& ed, Predicate&& isFarEnough)
+    {
+        Iterator i (ed);
+
+        if (! paragraphs.empty() && ! i.setPosition (paragraphs.back().position))
+            return false;
+
+        const auto lineSpacingForBottom = jmax (1.0f, ed.lineSpacing);
+        float right = 0.0f, bottom = 0.0f;
+        size_t nextStale = 0;
+
+        while (i.next())
+        {
+            right = jmax (right, i.atomRight);
+            bottom = jmax (bottom, i.lineY + i.lineHeight * lineSpacingForBottom);
+
+            if (! i.isAtNewLine())
+                continue;
+
+            addParagraph ({ i.getPosition(), i.indexInText + i.atom->numChars, right, bottom, 0.0f, 0.0f });
+            right = bottom = 0.0f;
+
+            const auto& current = paragraphs.back().position;
+
+            while (nextStale < stale.size() && stale[nextStale].position.indexInText < current.indexInText)
+                ++nextStale;
+
+            if (nextStale < stale.size() && matches (stale[nextStale].position, current))
+            {
+                spliceStaleParagraphs (nextStale, current);
+                stale.clear();
+                nextStale = 0;
+
+                if (! i.setPosition (paragraphs.back().position))
+                    return false;
+            }
+
+            if (isFarEnough (paragraphs.back()))
+                return true;
+        }
+
+        tailRight = right;
+        textHeight = i.getTotalTextHeightAtEnd();
+        stale.clear();
+        isComplete = true;
+        return true;
+    }
+
+    void addParagraph (Paragraph p)
+    {
+        const auto previous = paragraphs.empty() ? Paragraph{} : paragraphs.back();
+        p.rightBefore = jmax (previous.rightBefore, p.right);
+        p.bottomBefore = jmax (previous.bottomBefore, p.bottom);
+        paragraphs.push_back (p);
+    }
+
+    static bool matches (const Iterator::Position& a, const Iterator::Position& b) noexcept
+    {
+        return a.indexInText == b.indexInText
+            && exactlyEqual (a.lineHeight, b.lineHeight)
+            && exactlyEqual (a.maxDescent, b.maxDescent)
+            && exactlyEqual (a.atomX, b.atomX)
+            && exactlyEqual (a.atomRight, b.atomRight);
+    }
+
+    // Once the new layout reaches a paragraph that hasn't changed, everything after it is
+    // the same as before apart from its vertical position and where its atoms are stored.
+    void spliceStaleParagraphs (size_t matchIndex, Iterator::Position current)
+    {
+        const auto old = stale[matchIndex].position;
+        const auto deltaY = current.lineY - old.lineY;
+
+        for (auto j = matchIndex + 1; j < stale.size(); ++j)
+        {
+            auto p = stale[j];
+            p.position.lineY += deltaY;
+            p.bottom += deltaY;
+
+            if (p.position.sectionIndex == old.sectionIndex)
+                p.position.atomIndex += current.atomIndex - old.atomIndex;
+
+            p.position.sectionIndex += current.sectionIndex - old.sectionIndex;
+            addParagraph (p);
+        }
+    }
+};
+
+
 //==============================================================================
 struct TextEditor::InsertAction final : public UndoableAction
 {
@@ -934,6 +1336,7 @@ TextEditor::TextEditor (const String& name, juce_wchar passwordChar)
     : Component (name),
       passwordCharacter (passwordChar)
 {
+    layoutCache.reset (new LayoutCache (*this));
     setMouseCursor (MouseCursor::IBeamCursor);
 
     viewport.reset (new TextEditorViewport (*this));
@@ -1100,6 +1503,7 @@ void TextEditor::applyFontToAllText (const Font& newFont, bool changeCurrentFont
     }
 
     coalesceSimilarSections();
+    layoutCache->reset();
     checkLayout();
     scrollToMakeSureCursorIsVisible();
     repaint();
@@ -1110,6 +1514,10 @@ void TextEditor::applyColourToAllText (const Colour& newColour, bool changeCurre
     for (auto* uts : sections)
         uts->colour = newColour;
 
+    // sections that now share a colour can be merged by the next edit, which would move
+    // the atoms that the layout cache refers to
+    layoutCache->reset();
+
     if (changeCurrentTextColour)
         setColour (TextEditor::textColourId, newColour);
     else
@@ -1354,6 +1762,7 @@ void TextEditor::repaintText (Range<int> range)
         }
 
         Iterator i (*this);
+        layoutCache->skipToIndex (*this, i, range.getStart());
 
         Point<float> anchor;
         auto lh = currentFont.getHeight();
@@ -1468,8 +1877,9 @@ RectangleList<int> TextEditor::getTextBounds (Range<int> textRange) const
 {
     RectangleList<int> boundingBox;
     Iterator i (*this);
+    layoutCache->skipToIndex (*this, i, textRange.getStart());
 
-    while (i.next())
+    while (i.next() && i.indexInText < textRange.getEnd())
     {
         if (textRange.intersects ({ i.indexInText,
                                     i.indexInText + i.atom->numChars }))
@@ -1506,9 +1916,9 @@ void TextEditor::checkLayout()
 {
     if (getWordWrapWidth() > 0)
     {
-        const auto textBottom = Iterator (*this).getTotalTextHeight() + topIndent;
+        const auto textBottom = layoutCache->getTextHeight (*this) + topIndent;
         const auto textRight = jmax (viewport->getMaximumVisibleWidth(),
-                                     Iterator (*this).getTextRight() + leftIndent + rightEdgeSpace);
+                                     layoutCache->getTextRight (*this) + leftIndent + rightEdgeSpace);
 
         textHolder->setSize (textRight, textBottom);
         viewport->setScrollBarsShown (scrollbarVisible && multiline && textBottom > viewport->getMaximumVisibleHeight(),
@@ -1516,8 +1926,8 @@ void TextEditor::checkLayout()
     }
 }
 
-int TextEditor::getTextWidth() const    { return textHolder->getWidth(); }
-int TextEditor::getTextHeight() const   { return textHolder->getHeight(); }
+int TextEditor::getTextWidth() const    { layoutCache->finish(); return textHolder->getWidth(); }
+int TextEditor::getTextHeight() const   { layoutCache->finish(); return textHolder->getHeight(); }
 
 void TextEditor::setIndents (int newLeftIndent, int newTopIndent)
 {
@@ -1726,6 +2136,7 @@ void TextEditor::drawContent (Graphics& g)
         }
 
         Iterator i (*this);
+        layoutCache->skipToY (*this, i, (float) clip.getY());
         Colour selectedTextColour;
 
         if (! selection.isEmpty())
@@ -1761,6 +2172,7 @@ void TextEditor::drawContent (Graphics& g)
         for (auto& underlinedSection : underlinedSections)
         {
             Iterator i2 (*this);
+            layoutCache->skipToY (*this, i2, (float) clip.getY());
 
             while (i2.next() && i2.lineY < (float) clip.getBottom())
             {
@@ -2336,15 +2748,27 @@ void TextEditor::insert (const String& text, int insertIndex, const Font& font,
         }
         else
         {
-            repaintText ({ insertIndex, getTotalNumChars() }); // must do this before and after changing the data, in case
-                                                               // a line gets moved due to word wrap
+            const auto numCharsBefore = getTotalNumChars();
+
+            repaintText ({ insertIndex, numCharsBefore }); // must do this before and after changing the data, in case
+                                                           // a line gets moved due to word wrap
 
             int index = 0;
             int nextIndex = 0;
 
             for (int i = 0; i < sections.size(); ++i)
             {
-                nextIndex = index + sections.getUnchecked (i)->getTotalLength();
+                auto* section = sections.getUnchecked (i);
+                nextIndex = index + section->getTotalLength();
+
+                // Text that matches a section it touches can go straight into it, rather than
+                // splitting the section and then moving everything after the split back again
+                if (insertIndex <= nextIndex && section->font == font && section->colour == colour)
+                {
+                    section->insertText (insertIndex - index, text);
+                    nextIndex = -1;
+                    break;
+                }
 
                 if (insertIndex == index)
                 {
@@ -2368,6 +2792,7 @@ void TextEditor::insert (const String& text, int insertIndex, const Font& font,
             coalesceSimilarSections();
             totalNumChars = -1;
             valueTextNeedsUpdating = true;
+            layoutCache->textChanged (insertIndex, 0, getTotalNumChars() - numCharsBefore);
 
             checkLayout();
             moveCaretTo (caretPositionToMoveTo, false);
@@ -2379,6 +2804,7 @@ void TextEditor::insert (const String& text, int insertIndex, const Font& font,
 
 void TextEditor::reinsert (int insertIndex, const OwnedArray<UniformTextSection>& sectionsToInsert)
 {
+    const auto numCharsBefore = getTotalNumChars();
     int index = 0;
     int nextIndex = 0;
 
@@ -2414,6 +2840,7 @@ void TextEditor::reinsert (int insertIndex, const OwnedArray<UniformTextSection>
     coalesceSimilarSections();
     totalNumChars = -1;
     valueTextNeedsUpdating = true;
+    layoutCache->textChanged (insertIndex, 0, getTotalNumChars() - numCharsBefore);
 }
 
 void TextEditor::remove (Range<int> range, UndoManager* const um, const int caretPositionToMoveTo)
@@ -2498,6 +2925,7 @@ void TextEditor::remove (Range<int> range, UndoManager* const um, const int care
             coalesceSimilarSections();
             totalNumChars = -1;
             valueTextNeedsUpdating = true;
+            layoutCache->textChanged (range.getStart(), range.getLength() - remainingRange.getLength(), 0);
 
             checkLayout();
             moveCaretTo (caretPositionToMoveTo, false);
@@ -2588,6 +3016,7 @@ void TextEditor::getCharPosition (int index, Point<float>& anchor, float& lineHe
         }
         else
         {
+            layoutCache->skipToIndex (*this, i, index);
             i.getCharPosition (index, anchor, lineHeight);
         }
     }
@@ -2597,7 +3026,10 @@ int TextEditor::indexAtPosition (const float x, const float y) const
 {
     if (getWordWrapWidth() > 0)
     {
-        for (Iterator i (*this); i.next();)
+        Iterator i (*this);
+        layoutCache->skipToY (*this, i, y);
+
+        while (i.next())
         {
             if (y < i.lineY + (i.lineHeight * lineSpacing))
             {
@@ -2774,4 +3206,130 @@ std::unique_ptr<AccessibilityHandler> TextEditor::createAccessibilityHandler()
     return std::make_unique<EditorAccessibilityHandler> (*this);
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class TextEditorTests final : public UnitTest
+{
+public:
+    TextEditorTests() : UnitTest ("TextEditor", UnitTestCategories::gui) {}
+
+    void runTest() override
+    {
+        ScopedJuceInitialiser_GUI libraryInitialiser;
+        const MessageManagerLock mml;
+
+        beginTest ("Incremental layout after edits matches a full layout");
+        {
+            auto r = getRandom();
+
+            for (auto wordWrap : { true, false })
+            {
+                TextEditor ed;
+                ed.setMultiLine (true, wordWrap);
+                ed.setSize (200, 300);
+                ed.setText (createRandomText (r, 400));
+
+                for (int i = 0; i < 50; ++i)
+                {
+                    const auto numChars = ed.getTotalNumChars();
+                    const auto op = r.nextInt (4);
+
+                    if (op == 0)
+                    {
+                        ed.undo();
+                    }
+                    else
+                    {
+                        const auto start = r.nextInt (numChars + 1);
+                        const auto end = op == 1 ? jmin (numChars, start + r.nextInt (100)) : start;
+
+                        ed.setHighlightedRegion ({ start, end });
+                        ed.insertTextAtCaret (op == 3 ? String() : createRandomText (r, r.nextInt (60)));
+                    }
+
+                    const auto incremental = getLayoutSummary (ed);
+
+                    // re-applying the font throws away any cached layout
+                    ed.applyFontToAllText (ed.getFont());
+
+                    expect (incremental == getLayoutSummary (ed));
+                }
+            }
+        }
+
+        beginTest ("Long text laid out on demand matches a full layout");
+        {
+            auto r = getRandom();
+            const auto text = createRandomText (r, 8000);
+            TextEditor onDemand, full;
+
+            for (auto* ed : { &onDemand, &full })
+            {
+                ed->setMultiLine (true, true);
+                ed->setSize (200, 300);
+                ed->setText (text);
+            }
+
+            for (int i = 0; i < 20; ++i)
+            {
+                const auto start = r.nextInt (full.getTotalNumChars() + 1);
+                const auto end = jmin (full.getTotalNumChars(), start + r.nextInt (50));
+                const auto newText = createRandomText (r, r.nextInt (20));
+
+                for (auto* ed : { &onDemand, &full })
+                {
+                    ed->setHighlightedRegion ({ start, end });
+                    ed->insertTextAtCaret (newText);
+                }
+
+                // one editor only lays out as far as the edit, the other lays out everything
+                expect (onDemand.getCaretRectangle() == full.getCaretRectangle());
+                expect (full.getTextHeight() > 0);
+            }
+
+            expect (getLayoutSummary (onDemand) == getLayoutSummary (full));
+        }
+    }
+
+private:
+    static String createRandomText (Random& r, int numWords)
+    {
+        static const char* const words[] = { "a", "word", "  ", " ", "\n", "\n\n", "longerwordthatwraps",
+                                             "aVeryLongWordThatIsWiderThanTheWholeEditorAndMustBeBrokenUp" };
+        String result;
+
+        for (int i = 0; i < numWords; ++i)
+            result << words[r.nextInt (numElementsInArray (words))] << (r.nextBool() ? " " : "");
+
+        return result;
+    }
+
+    static Array<int> getLayoutSummary (const TextEditor& ed)
+    {
+        Array<int> summary { ed.getTextWidth(), ed.getTextHeight() };
+        const auto numChars = ed.getTotalNumChars();
+
+        for (int i = 0; i <= numChars; i += 13)
+        {
+            const auto caret = ed.getCaretRectangleForCharIndex (i);
+            summary.addArray ({ caret.getX(), caret.getY(), caret.getHeight() });
+        }
+
+        for (int y = -10; y < ed.getTextHeight() + 10; y += 17)
+            for (int x = -10; x < ed.getTextWidth() + 10; x += 37)
+                summary.add (ed.getCharIndexForPoint ({ x, y }));
+
+        for (auto& rect : ed.getTextBounds ({ numChars / 3, numChars / 2 }))
+            summary.addArray ({ rect.getX(), rect.getY(), rect.getWidth(), rect.getHeight() });
+
+        return summary;
+    }
+};
+
+static TextEditorTests textEditorTests;
+
+#endif
+
 } // namespace juce
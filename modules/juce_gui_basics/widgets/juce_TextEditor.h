@@ -487,6 +487,9 @@ public:
 
         This may be larger than the size of the TextEditor, and can change when
         the TextEditor is resized or the text changes.
+
+        Long pieces of text are laid out gradually in the background, so calling this
+        before that's finished will lay out the rest of the text straight away.
     */
     int getTextWidth() const;
 
@@ -494,6 +497,9 @@ public:
 
         This may be larger than the size of the TextEditor, and can change when
         the TextEditor is resized or the text changes.
+
+        Like getTextWidth(), this will finish laying out any text that's still being
+        done in the background.
     */
     int getTextHeight() const;
 
@@ -767,6 +773,7 @@ private:
     //==============================================================================
     JUCE_PUBLIC_IN_DLL_BUILD (class UniformTextSection)
     struct Iterator;
+    struct LayoutCache;
     struct TextHolderComponent;
     struct TextEditorViewport;
     struct InsertAction;
@@ -820,6 +827,7 @@ private:
     mutable int totalNumChars = 0;
     int caretPosition = 0;
     OwnedArray<UniformTextSection> sections;
+    std::unique_ptr<LayoutCache> layoutCache;
     String textToShowWhenEmpty;
     Colour colourForTextWhenEmpty;
     juce_wchar passwordCharacter;
@@ -132,6 +132,7 @@ void ComponentPeer::handlePaint (LowLevelGraphicsContext& contextToPaintTo)
 
     JUCE_TRY
     {
+        const PaintProfiler::ScopedFrame profiledFrame (paintProfiler.get(), g.getClipBounds());
         component.paintEntireComponent (g, true);
     }
     JUCE_CATCH_EXCEPTION
@@ -394,6 +394,17 @@ public:
     */
     virtual void performAnyPendingRepaintsNow() = 0;
 
+    /** Attaches a PaintProfiler which will record the time taken by each component
+        whenever this window is painted.
+
+        The profiler isn't owned by the peer, and it's safe to delete it while it's
+        attached. Pass nullptr to stop profiling.
+    */
+    void setPaintProfiler (PaintProfiler* profilerToUse) noexcept   { paintProfiler = profilerToUse; }
+
+    /** Returns the PaintProfiler that was set with setPaintProfiler(), if it still exists. */
+    PaintProfiler* getPaintProfiler() const noexcept                { return paintProfiler.get(); }
+
     /** Changes the window's transparency. */
     virtual void setAlpha (float newAlpha) = 0;
 
@@ -591,6 +602,7 @@ private:
     Component* getTargetForKeyPress();
 
     WeakReference<Component> lastFocusedComponent, dragAndDropTargetComponent;
+    WeakReference<PaintProfiler> paintProfiler;
     Component* lastDragAndDropCompUnderMouse = nullptr;
     TextInputTarget* textInputTarget = nullptr;
     const uint32 uniqueID;
@@ -0,0 +1,399 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+FrameScheduler::FrameScheduler (Component& componentToSyncWith)
+    : vBlankAttachment (&componentToSyncWith, [this] { runFrame(); })
+{
+}
+
+FrameScheduler::~FrameScheduler()
+{
+    // All the Updaters that use this scheduler must be deleted before it is!
+    jassert (numUpdaters == 0);
+}
+
+//==============================================================================
+void FrameScheduler::addListener (Listener* listener)       { listeners.add (listener); }
+void FrameScheduler::removeListener (Listener* listener)    { listeners.remove (listener); }
+
+//==============================================================================
+FrameScheduler::Updater::Updater (FrameScheduler& scheduler)
+    : owner (scheduler)
+{
+    const SpinLock::ScopedLockType sl (owner.updaterLock);
+    ++owner.numUpdaters;
+}
+
+FrameScheduler::Updater::~Updater()
+{
+    const SpinLock::ScopedLockType sl (owner.updaterLock);
+    owner.removeUpdater (*this);
+    --owner.numUpdaters;
+}
+
+void FrameScheduler::Updater::triggerUpdate()
+{
+    if (pending.load())
+        return;
+
+    const SpinLock::ScopedLockType sl (owner.updaterLock);
+
+    if (! pending.exchange (true))
+        owner.pendingUpdaters.push_back (this);
+}
+
+void FrameScheduler::Updater::cancelPendingUpdate() noexcept
+{
+    const SpinLock::ScopedLockType sl (owner.updaterLock);
+    owner.removeUpdater (*this);
+}
+
+void FrameScheduler::removeUpdater (Updater& updater)
+{
+    updater.pending = false;
+
+    pendingUpdaters.erase (std::remove (pendingUpdaters.begin(), pendingUpdaters.end(), &updater),
+                           pendingUpdaters.end());
+
+    // If it was due to be delivered in the frame that's running, just leave a gap
+    std::replace (updatersInThisFrame.begin(), updatersInThisFrame.end(), &updater, (Updater*) nullptr);
+}
+
+//==============================================================================
+void FrameScheduler::repaintInNextFrame (Component& component)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    auto& repaint = getPendingRepaint (component);
+    repaint.entireComponent = true;
+    repaint.area.clear();
+}
+
+void FrameScheduler::repaintInNextFrame (Component& component, Rectangle<int> area)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    auto& repaint = getPendingRepaint (component);
+
+    if (! repaint.entireComponent)
+        repaint.area.add (area);
+}
+
+FrameScheduler::PendingRepaint& FrameScheduler::getPendingRepaint (Component& component)
+{
+    for (auto& repaint : pendingRepaints)
+        if (repaint.component == &component)
+            return repaint;
+
+    pendingRepaints.push_back ({ &component, {}, false });
+    return pendingRepaints.back();
+}
+
+//==============================================================================
+void FrameScheduler::resetStatistics() noexcept
+{
+    statistics = {};
+    totalFrameDurationMs = 0.0;
+    totalFrameIntervalMs = 0.0;
+    numFrameIntervals = 0;
+}
+
+void FrameScheduler::runFrame()
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    Frame frame;
+    frame.frameNumber = nextFrameNumber++;
+    frame.timeMs = Time::getMillisecondCounterHiRes();
+    frame.msSinceLastFrame = frame.frameNumber > 0 ? frame.timeMs - lastFrameStartMs : 0.0;
+    lastFrameStartMs = frame.timeMs;
+
+    listeners.call ([&] (Listener& l) { l.animationFrame (frame); });
+
+    deliverUpdates (frame.timeMs);
+
+    // Repaints requested while these are being made will wait for the next frame
+    repaintsInThisFrame.swap (pendingRepaints);
+
+    for (auto& repaint : repaintsInThisFrame)
+    {
+        if (auto* c = repaint.component.getComponent())
+        {
+            if (repaint.entireComponent)
+                c->repaint();
+            else
+                for (auto& r : repaint.area)
+                    c->repaint (r);
+        }
+    }
+
+    repaintsInThisFrame.clear();
+
+    const auto durationMs = Time::getMillisecondCounterHiRes() - frame.timeMs;
+
+    ++statistics.numFrames;
+    statistics.lastFrameDurationMs = durationMs;
+    statistics.maxFrameDurationMs = jmax (statistics.maxFrameDurationMs, durationMs);
+    totalFrameDurationMs += durationMs;
+    statistics.averageFrameDurationMs = totalFrameDurationMs / (double) statistics.numFrames;
+
+    if (durationMs > frameBudgetMs)
+        ++statistics.numFramesOverBudget;
+
+    if (frame.msSinceLastFrame > 0.0)
+    {
+        totalFrameIntervalMs += frame.msSinceLastFrame;
+        statistics.averageFrameIntervalMs = totalFrameIntervalMs / (double) ++numFrameIntervals;
+    }
+}
+
+void FrameScheduler::deliverUpdates (double frameStartMs)
+{
+    {
+        const SpinLock::ScopedLockType sl (updaterLock);
+        jassert (updatersInThisFrame.empty());
+        updatersInThisFrame.swap (pendingUpdaters);
+    }
+
+    // Anything triggered while these are being delivered will wait for the next frame
+    int numDelivered = 0;
+
+    for (size_t i = 0; i < updatersInThisFrame.size(); ++i)
+    {
+        Updater* updater = nullptr;
+
+        {
+            const SpinLock::ScopedLockType sl (updaterLock);
+
+            if (numDelivered > 0 && Time::getMillisecondCounterHiRes() - frameStartMs > frameBudgetMs)
+            {
+                // Out of time, so put the rest back at the front of the queue, ahead of
+                // anything that has been triggered since this frame started
+                const auto remaining = std::remove (updatersInThisFrame.begin() + (ptrdiff_t) i,
+                                                    updatersInThisFrame.end(),
+                                                    (Updater*) nullptr);
+
+                statistics.numDeferredUpdates += (int64) (remaining - (updatersInThisFrame.begin() + (ptrdiff_t) i));
+                pendingUpdaters.insert (pendingUpdaters.begin(), updatersInThisFrame.begin() + (ptrdiff_t) i, remaining);
+                break;
+            }
+
+            updater = std::exchange (updatersInThisFrame[i], nullptr);
+
+            if (updater == nullptr)
+                continue;
+
+            updater->pending = false;
+        }
+
+        ++numDelivered;
+
+        JUCE_TRY
+        {
+            updater->handleFrameUpdate();
+        }
+        JUCE_CATCH_EXCEPTION
+    }
+
+    const SpinLock::ScopedLockType sl (updaterLock);
+    updatersInThisFrame.clear();
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class FrameSchedulerTests final : public UnitTest
+{
+public:
+    FrameSchedulerTests() : UnitTest ("FrameScheduler", UnitTestCategories::gui) {}
+
+    void runTest() override
+    {
+        Component component;
+        component.setBounds (0, 0, 100, 100);
+        component.setVisible (true);
+
+        beginTest ("Listeners are called once per frame");
+        {
+            FrameScheduler scheduler (component);
+            Array<int64> frameNumbers;
+            Listener listener ([&] (const Frame& f) { frameNumbers.add (f.frameNumber); expect (f.frameNumber == 0 || f.msSinceLastFrame > 0.0); });
+
+            scheduler.addListener (&listener);
+            scheduler.runFrame();
+            scheduler.runFrame();
+            scheduler.removeListener (&listener);
+            scheduler.runFrame();
+
+            expect (frameNumbers == Array<int64> (0, 1));
+            expectEquals (scheduler.getStatistics().numFrames, (int64) 3);
+        }
+
+        beginTest ("Updaters are coalesced and delivered in the next frame");
+        {
+            FrameScheduler scheduler (component);
+            int numCalls = 0;
+            bool retrigger = true;
+            TestUpdater updater (scheduler, [&] (Updater& u) { ++numCalls; if (std::exchange (retrigger, false)) u.triggerUpdate(); });
+
+            updater.triggerUpdate();
+            updater.triggerUpdate();
+            expect (updater.isUpdatePending());
+
+            scheduler.runFrame();
+            expectEquals (numCalls, 1);
+            expect (updater.isUpdatePending());
+
+            scheduler.runFrame();
+            expectEquals (numCalls, 2);
+            expect (! updater.isUpdatePending());
+
+            updater.triggerUpdate();
+            updater.cancelPendingUpdate();
+            scheduler.runFrame();
+            expectEquals (numCalls, 2);
+
+            {
+                TestUpdater deleted (scheduler, [&] (Updater&) { ++numCalls; });
+                deleted.triggerUpdate();
+            }
+
+            scheduler.runFrame();
+            expectEquals (numCalls, 2);
+        }
+
+        beginTest ("Updaters that don't fit in the budget are left for the next frame");
+        {
+            FrameScheduler scheduler (component);
+            scheduler.setFrameBudget (1.0);
+
+            Array<int> order;
+            std::vector<std::unique_ptr<TestUpdater>> updaters;
+
+            for (int i = 0; i < 3; ++i)
+            {
+                updaters.push_back (std::make_unique<TestUpdater> (scheduler, [&order, i] (Updater&)
+                {
+                    order.add (i);
+                    const auto end = Time::getMillisecondCounterHiRes() + 2.0;
+
+                    while (Time::getMillisecondCounterHiRes() < end)
+                    {}
+                }));
+            }
+
+            for (auto& u : updaters)
+                u->triggerUpdate();
+
+            scheduler.runFrame();
+            expect (order == Array<int> (0));
+
+            updaters[0]->triggerUpdate();
+            scheduler.runFrame();
+            expect (order == Array<int> (0, 1));
+
+            scheduler.runFrame();
+            scheduler.runFrame();
+            expect (order == Array<int> (0, 1, 2, 0));
+
+            auto& stats = scheduler.getStatistics();
+            expectEquals (stats.numFrames, (int64) 4);
+            expectEquals (stats.numDeferredUpdates, (int64) 5);
+            expectEquals (stats.numFramesOverBudget, (int64) 4);
+            expect (stats.maxFrameDurationMs >= 2.0 && stats.averageFrameDurationMs >= 2.0);
+            expect (stats.averageFrameIntervalMs > 0.0);
+
+            scheduler.resetStatistics();
+            expectEquals (scheduler.getStatistics().numFrames, (int64) 0);
+        }
+
+        beginTest ("Repaints are combined and made at the end of the frame");
+        {
+            FrameScheduler scheduler (component);
+            auto* image = new CountingImage();
+            component.setCachedComponentImage (image);
+            image->numAll = 0;
+
+            scheduler.repaintInNextFrame (component, { 0, 0, 10, 10 });
+            scheduler.repaintInNextFrame (component, { 50, 50, 10, 10 });
+            expectEquals (image->numAreas, 0);
+
+            scheduler.runFrame();
+            expectEquals (image->numAreas, 2);
+            expectEquals (image->numAll, 0);
+
+            scheduler.repaintInNextFrame (component, { 0, 0, 10, 10 });
+            scheduler.repaintInNextFrame (component);
+            scheduler.repaintInNextFrame (component);
+            scheduler.runFrame();
+            expectEquals (image->numAreas, 2);
+            expectEquals (image->numAll, 1);
+
+            component.setCachedComponentImage (nullptr);
+        }
+    }
+
+private:
+    using Frame = FrameScheduler::Frame;
+    using Updater = FrameScheduler::Updater;
+
+    struct Listener final : public FrameScheduler::Listener
+    {
+        explicit Listener (std::function<void (const Frame&)> fn) : callback (std::move (fn)) {}
+        void animationFrame (const Frame& frame) override   { callback (frame); }
+
+        std::function<void (const Frame&)> callback;
+    };
+
+    struct TestUpdater final : public Updater
+    {
+        TestUpdater (FrameScheduler& s, std::function<void (Updater&)> fn) : Updater (s), callback (std::move (fn)) {}
+        ~TestUpdater() override                             { cancelPendingUpdate(); }
+        void handleFrameUpdate() override                   { callback (*this); }
+
+        std::function<void (Updater&)> callback;
+    };
+
+    struct CountingImage final : public CachedComponentImage
+    {
+        void paint (Graphics&) override                     {}
+        bool invalidateAll() override                       { ++numAll; return false; }
+        bool invalidate (const Rectangle<int>&) override    { ++numAreas; return false; }
+        void releaseResources() override                    {}
+
+        int numAll = 0, numAreas = 0;
+    };
+};
+
+static FrameSchedulerTests frameSchedulerTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,250 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Runs animation updates, deferred updates and repaints together, once for every
+    vertical blank of the display that a component is shown on.
+
+    When lots of independent Timers and AsyncUpdaters each change some state and call
+    repaint(), they do so at unrelated moments, so a component may be painted several
+    times per display refresh, or have its changes arrive just after a refresh. A
+    FrameScheduler instead collects all this work into a single phase at the start of
+    each frame:
+
+    - every Listener gets an animationFrame() callback,
+    - then any Updaters that have been triggered are delivered, for as long as the
+      frame's time budget allows (anything left over is delivered in the next frame),
+    - and finally, any repaints requested with repaintInNextFrame() are made.
+
+    Because this happens inside the peer's vblank callback, the resulting repaints are
+    painted in the same display refresh.
+
+    The scheduler only runs frames while its component is on the screen. It keeps some
+    statistics about how long each frame's work took, which can be used to find out
+    whether animations are keeping up with the display.
+
+    @see VBlankAttachment
+
+    @tags{GUI}
+*/
+class JUCE_API  FrameScheduler
+{
+public:
+    //==============================================================================
+    /** Creates a scheduler that runs at the refresh rate of the display that the given
+        component is shown on.
+
+        The component must outlive the scheduler.
+    */
+    explicit FrameScheduler (Component& componentToSyncWith);
+
+    /** Destructor.
+        Any Updaters that use this scheduler must be deleted before it is.
+    */
+    ~FrameScheduler();
+
+    //==============================================================================
+    /** Describes the frame that is being run. */
+    struct Frame
+    {
+        /** The number of frames that the scheduler has run before this one. */
+        int64 frameNumber = 0;
+
+        /** The time at which the frame started, as returned by Time::getMillisecondCounterHiRes(). */
+        double timeMs = 0.0;
+
+        /** The time since the previous frame started, or 0 for the first frame. */
+        double msSinceLastFrame = 0.0;
+    };
+
+    //==============================================================================
+    /** Receives a callback at the start of every frame. */
+    class JUCE_API  Listener
+    {
+    public:
+        /** Destructor. */
+        virtual ~Listener() = default;
+
+        /** Called on the message thread at the start of every frame.
+            This is the place to advance animations and change any state that they affect.
+        */
+        virtual void animationFrame (const Frame& frame) = 0;
+    };
+
+    /** Registers a listener to be called at the start of every frame. */
+    void addListener (Listener* listener);
+
+    /** Removes a previously-registered listener. */
+    void removeListener (Listener* listener);
+
+    //==============================================================================
+    /**
+        A replacement for AsyncUpdater that delivers its callback in the next frame of a
+        FrameScheduler, rather than as a separate message.
+
+        Like AsyncUpdater, any number of calls to triggerUpdate() before the callback
+        is made will result in a single call to handleFrameUpdate().
+    */
+    class JUCE_API  Updater
+    {
+    public:
+        /** Creates an Updater that is delivered by the given scheduler.
+            The scheduler must outlive the Updater.
+        */
+        explicit Updater (FrameScheduler& scheduler);
+
+        /** Destructor.
+            If an update is pending, it is cancelled.
+        */
+        virtual ~Updater();
+
+        /** Requests a call to handleFrameUpdate() in the next frame.
+            This can be called from any thread.
+        */
+        void triggerUpdate();
+
+        /** Cancels a pending update, if there is one. */
+        void cancelPendingUpdate() noexcept;
+
+        /** Returns true if an update has been triggered but not yet delivered. */
+        bool isUpdatePending() const noexcept           { return pending.load(); }
+
+        /** Called on the message thread, during the frame after triggerUpdate() was called. */
+        virtual void handleFrameUpdate() = 0;
+
+    private:
+        friend class FrameScheduler;
+
+        FrameScheduler& owner;
+        std::atomic<bool> pending { false };
+
+        JUCE_DECLARE_NON_COPYABLE (Updater)
+    };
+
+    //==============================================================================
+    /** Repaints the whole of a component at the end of the next frame.
+        Multiple requests for the same component in one frame are combined.
+    */
+    void repaintInNextFrame (Component& component);
+
+    /** Repaints an area of a component at the end of the next frame.
+        Multiple requests for the same component in one frame are combined.
+    */
+    void repaintInNextFrame (Component& component, Rectangle<int> area);
+
+    //==============================================================================
+    /** Sets how long a frame may spend delivering Updaters before leaving the rest for
+        the next frame. Listeners and repaints are always run. At least one pending Updater
+        is delivered in each frame, however small the budget is.
+
+        The default is 8 milliseconds.
+    */
+    void setFrameBudget (double milliseconds) noexcept  { frameBudgetMs = milliseconds; }
+
+    /** Returns the current frame budget in milliseconds. */
+    double getFrameBudget() const noexcept              { return frameBudgetMs; }
+
+    //==============================================================================
+    /** Timing information about the frames that have been run. */
+    struct Statistics
+    {
+        /** The number of frames that have been run. */
+        int64 numFrames = 0;
+
+        /** How long the most recent frame's work took. */
+        double lastFrameDurationMs = 0.0;
+
+        /** The mean time taken by each frame's work. */
+        double averageFrameDurationMs = 0.0;
+
+        /** The longest time taken by a frame's work. */
+        double maxFrameDurationMs = 0.0;
+
+        /** The mean time between the starts of consecutive frames. */
+        double averageFrameIntervalMs = 0.0;
+
+        /** The number of frames that ran past the frame budget. */
+        int64 numFramesOverBudget = 0;
+
+        /** The number of Updaters whose delivery was put off to a later frame because the
+            budget had been used up.
+        */
+        int64 numDeferredUpdates = 0;
+    };
+
+    /** Returns the statistics for the frames run since the scheduler was created, or since
+        resetStatistics() was last called.
+    */
+    const Statistics& getStatistics() const noexcept    { return statistics; }
+
+    /** Clears the frame statistics. */
+    void resetStatistics() noexcept;
+
+    //==============================================================================
+    /** Runs a frame immediately.
+        This is called at each vertical blank, but you can also call it yourself to drive
+        the scheduler from some other source. It must be called on the message thread.
+    */
+    void runFrame();
+
+private:
+    //==============================================================================
+    struct PendingRepaint
+    {
+        Component::SafePointer<Component> component;
+        RectangleList<int> area;
+        bool entireComponent = false;
+    };
+
+    PendingRepaint& getPendingRepaint (Component&);
+    void deliverUpdates (double frameStartMs);
+    void removeUpdater (Updater&);
+
+    ListenerList<Listener> listeners;
+
+    SpinLock updaterLock;
+    std::vector<Updater*> pendingUpdaters, updatersInThisFrame;
+    int numUpdaters = 0;
+
+    std::vector<PendingRepaint> pendingRepaints, repaintsInThisFrame;
+
+    double frameBudgetMs = 8.0;
+    int64 nextFrameNumber = 0;
+    double lastFrameStartMs = 0.0;
+
+    Statistics statistics;
+    double totalFrameDurationMs = 0.0, totalFrameIntervalMs = 0.0;
+    int64 numFrameIntervals = 0;
+
+    VBlankAttachment vBlankAttachment;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FrameScheduler)
+};
+
+} // namespace juce
@@ -414,7 +414,7 @@ void CodeDocument::Position::setLineAndIndex (const int newLineNum, const int ne
 
             auto& l = *owner->lines.getUnchecked (line);
             indexInLine = l.lineLengthWithoutNewLines;
-            characterPos = l.lineStartInFile + indexInLine;
+            characterPos = owner->getLineStart (line) + indexInLine;
         }
         else
         {
@@ -427,7 +427,7 @@ void CodeDocument::Position::setLineAndIndex (const int newLineNum, const int ne
             else
                 indexInLine = 0;
 
-            characterPos = l.lineStartInFile + indexInLine;
+            characterPos = owner->getLineStart (line) + indexInLine;
         }
     }
 }
@@ -452,13 +452,14 @@ void CodeDocument::Position::setPosition (const int newPosition)
                 for (int i = lineStart; i < lineEnd; ++i)
                 {
                     auto& l = *owner->lines.getUnchecked (i);
-                    auto index = newPosition - l.lineStartInFile;
+                    auto startOfLine = owner->getLineStart (i);
+                    auto index = newPosition - startOfLine;
 
                     if (index >= 0 && (index < l.lineLength || i == lineEnd - 1))
                     {
                         line = i;
                         indexInLine = jmin (l.lineLengthWithoutNewLines, index);
-                        characterPos = l.lineStartInFile + indexInLine;
+                        characterPos = startOfLine + indexInLine;
                     }
                 }
 
@@ -468,7 +469,7 @@ void CodeDocument::Position::setPosition (const int newPosition)
             {
                 auto midIndex = (lineStart + lineEnd + 1) / 2;
 
-                if (newPosition >= owner->lines.getUnchecked (midIndex)->lineStartInFile)
+                if (newPosition >= owner->getLineStart (midIndex))
                     lineStart = midIndex;
                 else
                     lineEnd = midIndex;
@@ -615,7 +616,7 @@ String CodeDocument::getTextBetween (const Position& start, const Position& end)
 int CodeDocument::getNumCharacters() const noexcept
 {
     if (auto* lastLine = lines.getLast())
-        return lastLine->lineStartInFile + lastLine->lineLength;
+        return getLineStart (lines.size() - 1) + lastLine->lineLength;
 
     return 0;
 }
@@ -864,16 +865,43 @@ void CodeDocument::checkLastLineStatus()
         lines.removeLast();
     }
 
+    moveLineStartOffsetTo (firstLineWithStartOffset);
+
     const CodeDocumentLine* const lastLine = lines.getLast();
 
     if (lastLine != nullptr && lastLine->endsWithLineBreak())
     {
         // check that there's an empty line at the end if the preceding one ends in a newline..
+        // (the new line comes after the offset boundary, so its stored start excludes the offset)
         lines.add (new CodeDocumentLine (StringRef(), StringRef(), 0, 0,
-                                         lastLine->lineStartInFile + lastLine->lineLength));
+                                         getLineStart (lines.size() - 1) + lastLine->lineLength - lineStartOffset));
     }
 }
 
+int CodeDocument::getLineStart (int lineIndex) const noexcept
+{
+    auto start = lines.getUnchecked (lineIndex)->lineStartInFile;
+    return lineIndex < firstLineWithStartOffset ? start : start + lineStartOffset;
+}
+
+void CodeDocument::moveLineStartOffsetTo (int lineIndex) noexcept
+{
+    firstLineWithStartOffset = jmin (firstLineWithStartOffset, lines.size());
+    // Rather than updating the start of every following line after each edit, the lines
+    // from firstLineWithStartOffset onwards all share a pending offset. Moving that boundary
+    // only touches the lines in between, so repeated edits in one place stay cheap.
+    lineIndex = jlimit (0, lines.size(), lineIndex);
+
+    for (; firstLineWithStartOffset < lineIndex; ++firstLineWithStartOffset)
+        lines.getUnchecked (firstLineWithStartOffset)->lineStartInFile += lineStartOffset;
+
+    for (; firstLineWithStartOffset > lineIndex; --firstLineWithStartOffset)
+        lines.getUnchecked (firstLineWithStartOffset - 1)->lineStartInFile -= lineStartOffset;
+
+    if (firstLineWithStartOffset >= lines.size())
+        lineStartOffset = 0;
+}
+
 //==============================================================================
 void CodeDocument::addListener    (CodeDocument::Listener* l)   { listeners.add (l); }
 void CodeDocument::removeListener (CodeDocument::Listener* l)   { listeners.remove (l); }
@@ -921,6 +949,7 @@ void CodeDocument::insert (const String& text, const int insertPos, const bool u
         {
             Position pos (*this, insertPos);
             auto firstAffectedLine = pos.getLineNumber();
+            moveLineStartOffsetTo (firstAffectedLine + 1);
 
             auto* firstLine = lines[firstAffectedLine];
             auto textInsideOriginalLine = text;
@@ -933,11 +962,24 @@ void CodeDocument::insert (const String& text, const int insertPos, const bool u
                                          + firstLine->line.substring (index);
             }
 
-            maximumLineLength = -1;
             Array<CodeDocumentLine*> newLines;
             CodeDocumentLine::createLines (newLines, textInsideOriginalLine);
             jassert (newLines.size() > 0);
 
+            if (maximumLineLength >= 0)
+            {
+                int longestNewLine = 0;
+
+                for (auto* l : newLines)
+                    longestNewLine = jmax (longestNewLine, l->lineLength);
+
+                // if the longest line has been split up, there's no telling which one is now the longest
+                if (firstLine != nullptr && firstLine->lineLength >= maximumLineLength && longestNewLine < maximumLineLength)
+                    maximumLineLength = -1;
+                else
+                    maximumLineLength = jmax (maximumLineLength, longestNewLine);
+            }
+
             auto* newFirstLine = newLines.getUnchecked (0);
             newFirstLine->lineStartInFile = firstLine != nullptr ? firstLine->lineStartInFile : 0;
             lines.set (firstAffectedLine, newFirstLine);
@@ -947,16 +989,21 @@ void CodeDocument::insert (const String& text, const int insertPos, const bool u
 
             int lineStart = newFirstLine->lineStartInFile;
 
-            for (int i = firstAffectedLine; i < lines.size(); ++i)
+            for (int i = firstAffectedLine; i < firstAffectedLine + newLines.size(); ++i)
             {
                 auto& l = *lines.getUnchecked (i);
                 l.lineStartInFile = lineStart;
                 lineStart += l.lineLength;
             }
 
-            checkLastLineStatus();
             auto newTextLength = text.length();
 
+            // the lines that follow the new ones haven't changed apart from being moved along by the new text
+            firstLineWithStartOffset = firstAffectedLine + newLines.size();
+
+            lineStartOffset += newTextLength;
+            checkLastLineStatus();
+
             for (auto* p : positionsToMaintain)
                 if (p->getPosition() >= insertPos)
                     p->setPosition (p->getPosition() + newTextLength);
@@ -1013,10 +1060,15 @@ void CodeDocument::remove (const int startPos, const int endPos, const bool undo
         Position startPosition (*this, startPos);
         Position endPosition (*this, endPos);
 
-        maximumLineLength = -1;
         auto firstAffectedLine = startPosition.getLineNumber();
         auto endLine = endPosition.getLineNumber();
         auto& firstLine = *lines.getUnchecked (firstAffectedLine);
+        moveLineStartOffsetTo (firstAffectedLine + 1);
+
+        if (maximumLineLength >= 0)
+            for (int i = firstAffectedLine; i <= endLine; ++i)
+                if (lines.getUnchecked (i)->lineLength >= maximumLineLength)
+                    maximumLineLength = -1;
 
         if (firstAffectedLine == endLine)
         {
@@ -1036,13 +1088,11 @@ void CodeDocument::remove (const int startPos, const int endPos, const bool undo
             lines.removeRange (firstAffectedLine + 1, numLinesToRemove);
         }
 
-        for (int i = firstAffectedLine + 1; i < lines.size(); ++i)
-        {
-            auto& l = *lines.getUnchecked (i);
-            auto& previousLine = *lines.getUnchecked (i - 1);
-            l.lineStartInFile = previousLine.lineStartInFile + previousLine.lineLength;
-        }
+        if (maximumLineLength >= 0)
+            maximumLineLength = jmax (maximumLineLength, firstLine.lineLength);
 
+        // the lines after the first one have only moved back by the number of characters removed
+        lineStartOffset -= endPosition.getPosition() - startPosition.getPosition();
         checkLastLineStatus();
         auto totalChars = getNumCharacters();
 
@@ -1287,6 +1337,47 @@ struct CodeDocumentTest final : public UnitTest
                 expectEquals (p3.getIndexInLine(), d.getLine (d.getNumLines() - 1).length(), comment3);
             }
         }
+
+        {
+            beginTest ("Line starts after random edits");
+
+            CodeDocument d;
+            d.replaceAllContent (jabberwocky);
+            auto r = getRandom();
+
+            for (int i = 0; i < 500; ++i)
+            {
+                const auto numChars = d.getNumCharacters();
+                const auto start = r.nextInt (numChars + 1);
+
+                if (r.nextInt (5) == 0)
+                    d.undo();
+                else if (r.nextBool())
+                    d.insertText (start, String ("ab\ncd\r\nef ").substring (r.nextInt (12)));
+                else
+                    d.deleteSection (start, jmin (numChars, start + r.nextInt (20)));
+
+                d.newTransaction();
+
+                int lineStart = 0, longestLine = 0;
+
+                for (int line = 0; line < d.getNumLines(); ++line)
+                {
+                    const auto length = d.getLine (line).length();
+                    expectEquals (CodeDocument::Position (d, line, 0).getPosition(), lineStart);
+
+                    if (length > 0)
+                        expectEquals (CodeDocument::Position (d, lineStart + length - 1).getLineNumber(), line);
+
+                    lineStart += length;
+                    longestLine = jmax (longestLine, length);
+                }
+
+                expectEquals (d.getNumCharacters(), lineStart);
+                expectEquals (d.getNumCharacters(), d.getAllContent().length());
+                expectEquals (d.getMaximumLineLength(), longestLine);
+            }
+        }
     }
 };
 
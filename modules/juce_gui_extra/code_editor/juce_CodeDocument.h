@@ -433,6 +433,7 @@ private:
     friend class Position;
 
     OwnedArray<CodeDocumentLine> lines;
+    int firstLineWithStartOffset = 0, lineStartOffset = 0;
     Array<Position*> positionsToMaintain;
     UndoManager undoManager;
     int currentActionIndex = 0, indexOfSavedState = -1;
@@ -443,6 +444,8 @@ private:
     void insert (const String& text, int insertPos, bool undoable);
     void remove (int startPos, int endPos, bool undoable);
     void checkLastLineStatus();
+    int getLineStart (int lineIndex) const noexcept;
+    void moveLineStartOffsetTo (int lineIndex) noexcept;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CodeDocument)
 };
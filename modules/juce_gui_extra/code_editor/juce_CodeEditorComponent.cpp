@@ -356,9 +356,23 @@ class CodeEditorComponent::Pimpl   : public Timer,
 public:
     Pimpl (CodeEditorComponent& ed) : owner (ed) {}
 
+    void startBackgroundTokenising()
+    {
+        if (! backgroundTokeniser.isTimerRunning())
+            backgroundTokeniser.startTimer (20);
+    }
+
 private:
     CodeEditorComponent& owner;
 
+    // Extends the editor's cached tokeniser positions a few milliseconds at a time, so
+    // that jumping to the end of a long document doesn't have to tokenise all of it at once.
+    TimedCallback backgroundTokeniser { [this]
+    {
+        if (owner.updateCachedIterators (owner.document.getNumLines() - 1, 4.0))
+            backgroundTokeniser.stopTimer();
+    } };
+
     void timerCallback() override        { owner.newTransaction(); }
     void handleAsyncUpdate() override    { owner.rebuildLineTokens(); }
 
@@ -372,11 +386,13 @@ private:
 
     void codeDocumentTextInserted (const String& newText, int pos) override
     {
+        owner.keepCachedIteratorsAfterEdit (pos, 0, newText.length());
         owner.codeDocumentChanged (pos, pos + newText.length());
     }
 
     void codeDocumentTextDeleted (int start, int end) override
     {
+        owner.keepCachedIteratorsAfterEdit (start, end - start, 0);
         owner.codeDocumentChanged (start, end);
     }
 
@@ -649,6 +665,9 @@ void CodeEditorComponent::rebuildLineTokens()
 
     if (gutter != nullptr)
         gutter->documentChanged (document, firstLineOnScreen);
+
+    if (codeTokeniser != nullptr)
+        pimpl->startBackgroundTokenising();
 }
 
 void CodeEditorComponent::codeDocumentChanged (const int startIndex, const int endIndex)
@@ -656,7 +675,8 @@ void CodeEditorComponent::codeDocumentChanged (const int startIndex, const int e
     const CodeDocument::Position affectedTextStart (document, startIndex);
     const CodeDocument::Position affectedTextEnd (document, endIndex);
 
-    retokenise (startIndex, endIndex);
+    clearCachedIterators (affectedTextStart.getLineNumber());
+    rebuildLineTokensAsync();
 
     updateCaretPosition();
     columnToTryToMaintain = -1;
@@ -677,6 +697,10 @@ void CodeEditorComponent::retokenise (int startIndex, [[maybe_unused]] int endIn
 {
     const CodeDocument::Position affectedTextStart (document, startIndex);
 
+    // the tokeniser itself may have changed, so none of the positions it reached before can be trusted
+    reusableIteratorPositions.clear();
+    nextReusableIteratorPosition = 0;
+    reusableIteratorPositionsMatched = false;
     clearCachedIterators (affectedTextStart.getLineNumber());
 
     rebuildLineTokensAsync();
@@ -1732,10 +1756,40 @@ void CodeEditorComponent::clearCachedIterators (const int firstLineToBeInvalid)
     cachedIterators.removeRange (jmax (0, i - 1), cachedIterators.size());
 }
 
+void CodeEditorComponent::keepCachedIteratorsAfterEdit (int startIndex, int numRemoved, int numInserted)
+{
+    // A tokeniser only reads forwards, so if re-tokenising the edited text happens to stop at
+    // one of the old positions that came after the edit, everything beyond it will tokenise
+    // exactly as it did before, and the old positions can be used again.
+    Array<int> positions;
+
+    const auto addIfAfterEdit = [&] (int position)
+    {
+        if (position >= startIndex + numRemoved)
+            positions.add (position + numInserted - numRemoved);
+    };
+
+    for (auto& t : cachedIterators)
+        addIfAfterEdit (t.getPosition());
+
+    for (int i = nextReusableIteratorPosition; i < reusableIteratorPositions.size(); ++i)
+        addIfAfterEdit (reusableIteratorPositions.getUnchecked (i));
+
+    reusableIteratorPositions = std::move (positions);
+    nextReusableIteratorPosition = 0;
+    reusableIteratorPositionsMatched = false;
+}
+
 void CodeEditorComponent::updateCachedIterators (int maxLineNum)
+{
+    updateCachedIterators (maxLineNum, std::numeric_limits<double>::max());
+}
+
+bool CodeEditorComponent::updateCachedIterators (int maxLineNum, double timeLimitMs)
 {
     const int maxNumCachedPositions = 5000;
     const int linesBetweenCachedSources = jmax (10, document.getNumLines() / maxNumCachedPositions);
+    const auto endTime = Time::getMillisecondCounterHiRes() + timeLimitMs;
 
     if (cachedIterators.size() == 0)
         cachedIterators.add (CodeDocument::Iterator (document));
@@ -1746,9 +1800,15 @@ void CodeEditorComponent::updateCachedIterators (int maxLineNum)
         {
             const auto last = cachedIterators.getLast();
 
-            if (last.getLine() >= maxLineNum)
+            if (last.getLine() >= maxLineNum || last.isEOF())
                 break;
 
+            if (Time::getMillisecondCounterHiRes() >= endTime)
+                return false;
+
+            if (reuseCachedIterator())
+                continue;
+
             cachedIterators.add (CodeDocument::Iterator (last));
             auto& t = cachedIterators.getReference (cachedIterators.size() - 1);
             const int targetLine = jmin (maxLineNum, last.getLine() + linesBetweenCachedSources);
@@ -1757,30 +1817,66 @@ void CodeEditorComponent::updateCachedIterators (int maxLineNum)
             {
                 codeTokeniser->readNextToken (t);
 
+                if (! reusableIteratorPositionsMatched)
+                {
+                    while (nextReusableIteratorPosition < reusableIteratorPositions.size()
+                            && reusableIteratorPositions.getUnchecked (nextReusableIteratorPosition) < t.getPosition())
+                        ++nextReusableIteratorPosition;
+
+                    reusableIteratorPositionsMatched = nextReusableIteratorPosition < reusableIteratorPositions.size()
+                                                        && reusableIteratorPositions.getUnchecked (nextReusableIteratorPosition) == t.getPosition();
+                }
+
                 if (t.getLine() >= targetLine)
                     break;
 
                 if (t.isEOF())
-                    return;
+                    return true;
             }
         }
     }
+
+    return true;
 }
 
-void CodeEditorComponent::getIteratorForPosition (int position, CodeDocument::Iterator& source)
+bool CodeEditorComponent::reuseCachedIterator()
 {
-    if (codeTokeniser != nullptr)
+    if (! reusableIteratorPositionsMatched)
+        return false;
+
+    const auto lastPosition = cachedIterators.getLast().getPosition();
+
+    while (nextReusableIteratorPosition < reusableIteratorPositions.size())
     {
-        for (int i = cachedIterators.size(); --i >= 0;)
+        const auto position = reusableIteratorPositions.getUnchecked (nextReusableIteratorPosition++);
+
+        if (position > lastPosition)
         {
-            auto& t = cachedIterators.getReference (i);
+            CodeDocument::Iterator t (CodeDocument::Position (document, position));
 
-            if (t.getPosition() <= position)
-            {
-                source = t;
+            if (t.getPosition() != position)
                 break;
-            }
+
+            cachedIterators.add (t);
+            return true;
         }
+    }
+
+    reusableIteratorPositions.clear();
+    nextReusableIteratorPosition = 0;
+    reusableIteratorPositionsMatched = false;
+    return false;
+}
+
+void CodeEditorComponent::getIteratorForPosition (int position, CodeDocument::Iterator& source)
+{
+    if (codeTokeniser != nullptr)
+    {
+        auto next = std::upper_bound (cachedIterators.begin(), cachedIterators.end(), position,
+                                      [] (int pos, const CodeDocument::Iterator& t) { return pos < t.getPosition(); });
+
+        if (next != cachedIterators.begin())
+            source = *std::prev (next);
 
         while (source.getPosition() < position)
         {
@@ -448,8 +448,14 @@ private:
     void codeDocumentChanged (int start, int end);
 
     Array<CodeDocument::Iterator> cachedIterators;
+    Array<int> reusableIteratorPositions;
+    int nextReusableIteratorPosition = 0;
+    bool reusableIteratorPositionsMatched = false;
     void clearCachedIterators (int firstLineToBeInvalid);
+    void keepCachedIteratorsAfterEdit (int startIndex, int numRemoved, int numInserted);
     void updateCachedIterators (int maxLineNum);
+    bool updateCachedIterators (int maxLineNum, double timeLimitMs);
+    bool reuseCachedIterator();
     void getIteratorForPosition (int position, CodeDocument::Iterator&);
 
     void moveLineDelta (int delta, bool selecting);
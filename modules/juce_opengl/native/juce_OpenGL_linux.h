@@ -72,6 +72,133 @@ private:
     ScopedWindowAssociation association;
 };
 
+//==============================================================================
+/*  A context on a surfaceless EGL display, which renders without a window or an X
+    server, e.g. with Mesa's llvmpipe on a headless machine.
+
+    libEGL is loaded at runtime, so it isn't needed unless one of these is created.
+*/
+class OffscreenEGLContext
+{
+public:
+    OffscreenEGLContext()
+    {
+        if (! lib.open ("libEGL.so.1"))
+            return;
+
+        getProcAddress  = (GetProcAddress)  lib.getFunction ("eglGetProcAddress");
+        initialise      = (Initialise)      lib.getFunction ("eglInitialize");
+        terminate       = (Terminate)       lib.getFunction ("eglTerminate");
+        bindAPI         = (BindAPI)         lib.getFunction ("eglBindAPI");
+        createContext   = (CreateContext)   lib.getFunction ("eglCreateContext");
+        destroyContext  = (DestroyContext)  lib.getFunction ("eglDestroyContext");
+        makeCurrent     = (MakeCurrent)     lib.getFunction ("eglMakeCurrent");
+        getCurrent      = (GetCurrent)      lib.getFunction ("eglGetCurrentContext");
+
+        if (getProcAddress == nullptr || initialise == nullptr || terminate == nullptr || bindAPI == nullptr
+             || createContext == nullptr || destroyContext == nullptr || makeCurrent == nullptr || getCurrent == nullptr)
+            return;
+
+        using GetPlatformDisplay = void* (*) (unsigned int, void*, const int32*);
+
+        if (auto getPlatformDisplay = (GetPlatformDisplay) getProcAddress ("eglGetPlatformDisplayEXT"))
+            display = getPlatformDisplay (platformSurfacelessMesa, nullptr, nullptr);
+
+        if (display != nullptr && ! initialise (display, nullptr, nullptr))
+            display = nullptr;
+    }
+
+    ~OffscreenEGLContext()
+    {
+        destroy();
+
+        if (display != nullptr)
+            terminate (display);
+    }
+
+    bool isValid() const noexcept   { return display != nullptr; }
+
+    bool create (OpenGLContext::OpenGLVersion version)
+    {
+        jassert (isValid());
+
+        if (! bindAPI (openGLAPI))
+            return false;
+
+        const auto components = [&]() -> Optional<Version>
+        {
+            switch (version)
+            {
+                case OpenGLContext::openGL3_2: return Version { 3, 2 };
+                case OpenGLContext::openGL4_1: return Version { 4, 1 };
+                case OpenGLContext::openGL4_3: return Version { 4, 3 };
+
+                case OpenGLContext::defaultGLVersion: break;
+            }
+
+            return {};
+        }();
+
+        std::vector<int32> attribs;
+
+        if (components.hasValue())
+            attribs = { contextMajorVersion, components->major,
+                        contextMinorVersion, components->minor,
+                        contextProfileMask,  contextCoreProfileBit };
+
+        attribs.push_back (none);
+
+        // No config is needed, because nothing is ever drawn to a surface
+        context = createContext (display, nullptr, nullptr, attribs.data());
+        return context != nullptr;
+    }
+
+    void destroy()
+    {
+        if (context == nullptr)
+            return;
+
+        if (isActive())
+            makeCurrent (display, nullptr, nullptr, nullptr);
+
+        destroyContext (display, context);
+        context = nullptr;
+    }
+
+    bool makeActive() const noexcept    { return context != nullptr && makeCurrent (display, nullptr, nullptr, context); }
+    bool isActive() const noexcept      { return context != nullptr && getCurrent() == context; }
+    void* getRawContext() const noexcept { return context; }
+
+private:
+    using GetProcAddress = void* (*) (const char*);
+    using Initialise     = unsigned int (*) (void*, int32*, int32*);
+    using Terminate      = unsigned int (*) (void*);
+    using BindAPI        = unsigned int (*) (unsigned int);
+    using CreateContext  = void* (*) (void*, void*, void*, const int32*);
+    using DestroyContext = unsigned int (*) (void*, void*);
+    using MakeCurrent    = unsigned int (*) (void*, void*, void*, void*);
+    using GetCurrent     = void* (*)();
+
+    static constexpr unsigned int platformSurfacelessMesa = 0x31dd, openGLAPI = 0x30a2;
+    static constexpr int32 contextMajorVersion = 0x3098, contextMinorVersion = 0x30fb,
+                           contextProfileMask = 0x30fd, contextCoreProfileBit = 0x1, none = 0x3038;
+
+    DynamicLibrary lib;
+    GetProcAddress getProcAddress = nullptr;
+    Initialise initialise = nullptr;
+    Terminate terminate = nullptr;
+    BindAPI bindAPI = nullptr;
+    CreateContext createContext = nullptr;
+    DestroyContext destroyContext = nullptr;
+    MakeCurrent makeCurrent = nullptr;
+    GetCurrent getCurrent = nullptr;
+
+    void* display = nullptr;
+    void* context = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OffscreenEGLContext)
+};
+
 //==============================================================================
 class OpenGLContext::NativeContext
 {
@@ -230,6 +357,19 @@ public:
         juce_LinuxAddRepaintListener (peer, &dummy);
     }
 
+    struct Offscreen {};
+
+    /*  Creates a context that isn't attached to a window, so it can only be used to
+        render into framebuffers and images.
+    */
+    NativeContext (Component& comp, Offscreen)
+        : component (comp),
+          offscreen (std::make_unique<OffscreenEGLContext>()),
+          contextToShareWith (nullptr),
+          dummy (*this)
+    {
+    }
+
     ~NativeContext()
     {
         if (auto* peer = component.getPeer())
@@ -257,17 +397,27 @@ public:
 
     InitResult initialiseOnRenderThread (OpenGLContext& c)
     {
+        if (offscreen != nullptr)
+        {
+            if (! offscreen->create (c.versionRequired))
+                return InitResult::fatal;
+
+            c.makeActive();
+            context = &c;
+            return InitResult::success;
+        }
+
         XWindowSystemUtilities::ScopedXLock xLock;
 
         const auto components = [&]() -> Optional<Version>
         {
             switch (c.versionRequired)
             {
-                case OpenGLVersion::openGL3_2: return Version { 3, 2 };
-                case OpenGLVersion::openGL4_1: return Version { 4, 1 };
-                case OpenGLVersion::openGL4_3: return Version { 4, 3 };
+                case OpenGLContext::openGL3_2: return Version { 3, 2 };
+                case OpenGLContext::openGL4_1: return Version { 4, 1 };
+                case OpenGLContext::openGL4_3: return Version { 4, 3 };
 
-                case OpenGLVersion::defaultGLVersion: break;
+                case OpenGLContext::defaultGLVersion: break;
             }
 
             return {};
@@ -315,6 +465,13 @@ public:
 
     void shutdownOnRenderThread()
     {
+        if (offscreen != nullptr)
+        {
+            context = nullptr;
+            offscreen->destroy();
+            return;
+        }
+
         XWindowSystemUtilities::ScopedXLock xLock;
         context = nullptr;
         deactivateCurrentContext();
@@ -324,6 +481,9 @@ public:
 
     bool makeActive() const noexcept
     {
+        if (offscreen != nullptr)
+            return offscreen->makeActive();
+
         XWindowSystemUtilities::ScopedXLock xLock;
         return renderContext != PtrGLXContext{}
                  && glXMakeContextCurrent (display, glxWindow.get(), glxWindow.get(), renderContext.get());
@@ -331,6 +491,9 @@ public:
 
     bool isActive() const noexcept
     {
+        if (offscreen != nullptr)
+            return offscreen->isActive();
+
         XWindowSystemUtilities::ScopedXLock xLock;
         return glXGetCurrentContext() == renderContext.get() && renderContext != PtrGLXContext{};
     }
@@ -346,12 +509,19 @@ public:
 
     void swapBuffers()
     {
+        if (offscreen != nullptr)
+            return;
+
         glXSwapBuffers (display, glxWindow.get());
     }
 
     void updateWindowPosition (Rectangle<int> newBounds)
     {
         bounds = newBounds;
+
+        if (offscreen != nullptr)
+            return;
+
         auto physicalBounds = Desktop::getInstance().getDisplays().logicalToPhysical (bounds);
 
         XWindowSystemUtilities::ScopedXLock xLock;
@@ -366,6 +536,9 @@ public:
         if (numFramesPerSwap == swapFrames)
             return true;
 
+        if (offscreen != nullptr)
+            return false;
+
         if (auto GLXSwapIntervalEXT
               = (PFNGLXSWAPINTERVALEXTPROC) OpenGLHelpers::getExtensionFunction ("glXSwapIntervalEXT"))
         {
@@ -379,8 +552,8 @@ public:
     }
 
     int getSwapInterval() const                 { return swapFrames; }
-    bool createdOk() const noexcept             { return true; }
-    void* getRawContext() const noexcept        { return renderContext.get(); }
+    bool createdOk() const noexcept             { return offscreen == nullptr || offscreen->isValid(); }
+    void* getRawContext() const noexcept        { return offscreen != nullptr ? offscreen->getRawContext() : renderContext.get(); }
     GLuint getFrameBufferID() const noexcept    { return 0; }
 
     void triggerRepaint()
@@ -428,6 +601,7 @@ private:
 
     CriticalSection mutex;
     Component& component;
+    std::unique_ptr<OffscreenEGLContext> offscreen;
     PtrGLXContext renderContext;
     PtrGLXWindow glxWindow;
     Window embeddedWindow = {};
@@ -450,6 +624,10 @@ private:
 //==============================================================================
 bool OpenGLHelpers::isContextActive()
 {
+    // Offscreen contexts aren't created through GLX, so glXGetCurrentContext() can't see them
+    if (auto* current = OpenGLContext::getCurrentContext(); current != nullptr && current->isActive())
+        return true;
+
     XWindowSystemUtilities::ScopedXLock xLock;
     return glXGetCurrentContext() != nullptr;
 }
@@ -138,12 +138,16 @@ class OpenGLContext::CachedImage final : public CachedComponentImage
 public:
     CachedImage (OpenGLContext& c, Component& comp,
                  const OpenGLPixelFormat& pixFormat, void* contextToShare)
-        : context (c),
-          component (comp)
+        : CachedImage (c, comp, std::make_unique<NativeContext> (comp, pixFormat, contextToShare,
+                                                                 c.useMultisampling, c.versionRequired))
     {
-        nativeContext.reset (new NativeContext (component, pixFormat, contextToShare,
-                                                c.useMultisampling, c.versionRequired));
+    }
 
+    CachedImage (OpenGLContext& c, Component& comp, std::unique_ptr<NativeContext> native)
+        : nativeContext (std::move (native)),
+          context (c),
+          component (comp)
+    {
         if (nativeContext->createdOk())
             context.nativeContext = nativeContext.get();
         else
@@ -427,6 +431,26 @@ public:
         return RenderStatus::nominal;
     }
 
+   #if JUCE_UNIT_TESTS
+    // Initialises the context and calls the renderer once on the calling thread, for
+    // contexts that have no window for the render thread to draw into.
+    bool renderOnCurrentThread()
+    {
+        if (nativeContext == nullptr || initialiseOnThread() != InitResult::success)
+            return false;
+
+        state |= StateFlags::initialised;
+
+        if (context.renderer != nullptr)
+        {
+            context.renderer->renderOpenGL();
+            clearGLError();
+        }
+
+        return true;
+    }
+   #endif
+
     void updateViewportSize()
     {
         JUCE_ASSERT_MESSAGE_THREAD
@@ -524,6 +548,8 @@ public:
 
                 paintOwner (*g);
                 JUCE_CHECK_OPENGL_ERROR
+
+                lastPaintStatistics = getOpenGLGraphicsContextStatistics (*g);
             }
         }
 
@@ -957,6 +983,7 @@ public:
 
     OpenGLFrameBuffer cachedImageFrameBuffer;
     RectangleList<int> validArea;
+    RenderingStatistics lastPaintStatistics;
     Rectangle<int> lastScreenBounds;
     AffineTransform transform;
     LockedAreaAndScale areaAndScale;
@@ -1365,6 +1392,27 @@ bool OpenGLContext::isActive() const noexcept
     return nativeContext != nullptr && nativeContext->isActive();
 }
 
+#if JUCE_UNIT_TESTS
+bool OpenGLContext::renderOffscreen()
+{
+   #if JUCE_LINUX || JUCE_BSD
+    jassert (attachment == nullptr);
+
+    // The component has no peer, so the attachment won't try to create a window for it
+    Component target;
+    attachment.reset (new Attachment (*this, target));
+    target.setCachedComponentImage (new CachedImage (*this, target,
+                                                     std::make_unique<NativeContext> (target, NativeContext::Offscreen{})));
+
+    const auto rendered = getCachedImage()->renderOnCurrentThread();
+    detach();
+    return rendered;
+   #else
+    return false;
+   #endif
+}
+#endif
+
 void OpenGLContext::deactivateCurrentContext()
 {
     NativeContext::deactivateCurrentContext();
@@ -1478,6 +1526,16 @@ void OpenGLContext::setAssociatedObject (const char* name, ReferenceCountedObjec
 void OpenGLContext::setImageCacheSize (size_t newSize) noexcept     { imageCacheMaxSize = newSize; }
 size_t OpenGLContext::getImageCacheSize() const noexcept            { return imageCacheMaxSize; }
 
+OpenGLContext::RenderingStatistics OpenGLContext::getComponentPaintStatistics() const
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    if (auto* c = getCachedImage())
+        return c->lastPaintStatistics;
+
+    return {};
+}
+
 void OpenGLContext::execute (OpenGLContext::AsyncWorker::Ptr workerToUse, bool shouldBlock)
 {
     if (auto* c = getCachedImage())
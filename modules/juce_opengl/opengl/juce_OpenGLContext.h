@@ -332,6 +332,31 @@ public:
     /** Returns the amount of GPU memory that the internal cache for Images is allowed to use. */
     size_t getImageCacheSize() const noexcept;
 
+    //==============================================================================
+    /** Counters describing the work that a graphics context created by
+        createOpenGLGraphicsContext() has submitted to the GPU.
+
+        Each draw call renders a batch of quads, and most state changes force the current
+        batch to be drawn before the next one can start, so a small number of draw calls
+        relative to the number of quads means that the painting is being batched well.
+
+        @see getComponentPaintStatistics, getOpenGLGraphicsContextStatistics
+    */
+    struct RenderingStatistics
+    {
+        int numDrawCalls = 0;           /**< The number of batches of quads that were drawn. */
+        int numQuads = 0;               /**< The total number of quads that were drawn. */
+        int numShaderChanges = 0;       /**< The number of times a different shader program was selected. */
+        int numTextureBinds = 0;        /**< The number of times a different texture was bound. */
+        int numBlendModeChanges = 0;    /**< The number of times blending was switched on or off, or changed. */
+        int numAtlasUploads = 0;        /**< The number of images and glyphs that were copied into the texture atlas. */
+    };
+
+    /** Returns the statistics for the most recent frame in which the attached component
+        was painted. This must be called on the message thread.
+    */
+    RenderingStatistics getComponentPaintStatistics() const;
+
     //==============================================================================
    #ifndef DOXYGEN
     class NativeContext;
@@ -383,6 +408,16 @@ private:
     CachedImage* getCachedImage() const noexcept;
     void execute (AsyncWorker::Ptr, bool);
 
+   #if JUCE_UNIT_TESTS
+    friend class OpenGLGraphicsContextTests;
+
+    /*  Creates a context that isn't attached to a window, makes it active on the calling
+        thread, and calls the renderer's callbacks once. Returns false if the context
+        couldn't be created, which is always the case on platforms other than Linux.
+    */
+    bool renderOffscreen();
+   #endif
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OpenGLContext)
 };
 
@@ -26,8 +26,6 @@
 namespace juce
 {
 
-extern void (*clearOpenGLGlyphCache)(); // declared in juce_graphics
-
 namespace OpenGLRendering
 {
 
@@ -38,6 +36,183 @@ struct TextureInfo
     float fullWidthProportion, fullHeightProportion;
 };
 
+//==============================================================================
+// Keeps track of where things have been put in a TextureAtlas. Items are packed into
+// horizontal shelves, and each time the layout is cleared its generation changes, so
+// that anything holding on to a position knows that it needs to ask for a new one.
+struct TextureAtlasLayout
+{
+    enum
+    {
+        atlasSize = 1024,
+        maxItemSize = 128,
+        whiteBlockSize = 4,
+        solidColourTexel = 2
+    };
+
+    int getGeneration() const noexcept      { return generation; }
+
+    std::optional<Point<int>> findSpace (int width, int height)
+    {
+        for (auto& shelf : shelves)
+        {
+            if (height <= shelf.height && height * 4 >= shelf.height * 3 && shelf.nextX + width <= atlasSize)
+            {
+                Point<int> position (shelf.nextX, shelf.y);
+                shelf.nextX += width;
+                return position;
+            }
+        }
+
+        auto y = shelves.empty() ? (int) whiteBlockSize : shelves.back().y + shelves.back().height;
+
+        if (y + height > atlasSize)
+            return {};
+
+        shelves.push_back ({ y, height, width });
+        return Point<int> (0, y);
+    }
+
+    void clear()
+    {
+        shelves.clear();
+        glyphs.clear();
+        ++generation;
+    }
+
+    // Glyphs are keyed by the mask and the level multiplier that was applied to it. The
+    // layout keeps a reference to each mask, so that its address can't be reused by a
+    // different glyph while the position is still stored here.
+    std::optional<Point<int>> findGlyph (const GlyphAtlas::Glyph& glyph, int levelMultiplier) const
+    {
+        auto found = glyphs.find ({ &glyph, levelMultiplier });
+
+        if (found != glyphs.end())
+            return found->second.position;
+
+        return {};
+    }
+
+    void addGlyph (const GlyphAtlas::Glyph::Ptr& glyph, int levelMultiplier, Point<int> position)
+    {
+        glyphs[{ glyph.get(), levelMultiplier }] = { glyph, position };
+    }
+
+private:
+    struct Shelf
+    {
+        int y, height, nextX;
+    };
+
+    struct AtlasGlyph
+    {
+        GlyphAtlas::Glyph::Ptr glyph;
+        Point<int> position;
+    };
+
+    std::vector<Shelf> shelves;
+    std::map<std::pair<const GlyphAtlas::Glyph*, int>, AtlasGlyph> glyphs;
+    int generation = 0;
+};
+
+//==============================================================================
+// A texture into which small images and glyphs are packed, so that they can be drawn
+// in the same batches of quads as solid colour fills. The block of white texels in its
+// top-left corner is what solid colours are drawn with.
+struct TextureAtlas final : public TextureAtlasLayout
+{
+    bool isCreated() const noexcept         { return texture.getTextureID() != 0; }
+    GLuint getTextureID() const noexcept    { return texture.getTextureID(); }
+    int getNumUploads() const noexcept      { return numUploads; }
+
+    // NB: this leaves the atlas bound to the active texture unit
+    void create()
+    {
+        texture.loadARGB (nullptr, atlasSize, atlasSize);
+        glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        PixelARGB white[whiteBlockSize * whiteBlockSize];
+
+        for (auto& p : white)
+            p.setARGB (255, 255, 255, 255);
+
+        glTexSubImage2D (GL_TEXTURE_2D, 0, 0, 0, whiteBlockSize, whiteBlockSize, JUCE_RGBA_FORMAT, GL_UNSIGNED_BYTE, white);
+        JUCE_CHECK_OPENGL_ERROR
+        clear();
+    }
+
+    // Finds space for an item. If the atlas is full, any quads that are still waiting to be
+    // drawn from it are flushed, and it's emptied so that the items can be packed again.
+    template <typename FlushFunction>
+    std::optional<Point<int>> allocate (int width, int height, FlushFunction&& flushPendingQuads)
+    {
+        jassert (width > 0 && height > 0 && width <= maxItemSize && height <= maxItemSize);
+
+        if (auto position = findSpace (width, height))
+            return position;
+
+        flushPendingQuads();
+        clear();
+        return findSpace (width, height);
+    }
+
+    // The atlas must be bound to the active texture unit when this is called.
+    void upload (Point<int> position, int width, int height, const PixelARGB* pixels)
+    {
+        glTexSubImage2D (GL_TEXTURE_2D, 0, position.x, position.y, width, height, JUCE_RGBA_FORMAT, GL_UNSIGNED_BYTE, pixels);
+        JUCE_CHECK_OPENGL_ERROR
+        ++numUploads;
+    }
+
+    // Returns the position of a glyph's coverage mask, adding it to the atlas if it's not there
+    // already. The coverage is stored with the level multiplier already applied, in all four channels.
+    template <typename FlushFunction>
+    std::optional<Point<int>> getGlyphPosition (const GlyphAtlas::Glyph::Ptr& glyph, int levelMultiplier,
+                                                FlushFunction&& flushPendingQuads)
+    {
+        auto w = glyph->getBounds().getWidth();
+        auto h = glyph->getBounds().getHeight();
+
+        if (w <= 0 || h <= 0 || w > maxItemSize || h > maxItemSize)
+            return {};
+
+        if (auto existing = findGlyph (*glyph, levelMultiplier))
+            return existing;
+
+        auto position = allocate (w, h, flushPendingQuads);
+
+        if (! position)
+            return {};
+
+        HeapBlock<PixelARGB> pixels ((size_t) (w * h));
+        auto* dest = pixels.get();
+
+        for (int y = 0; y < h; ++y)
+        {
+            auto* line = glyph->getLinePointer (y);
+
+            for (int x = 0; x < w; ++x)
+            {
+                auto level = (int) line[x];
+
+                if (levelMultiplier != 256)
+                    level = jmin (255, (level * levelMultiplier) >> 8);
+
+                (dest++)->setARGB ((uint8) level, (uint8) level, (uint8) level, (uint8) level);
+            }
+        }
+
+        upload (*position, w, h, pixels);
+        addGlyph (glyph, levelMultiplier, *position);
+        return position;
+    }
+
+private:
+    OpenGLTexture texture;
+    int numUploads = 0;
+};
+
 //==============================================================================
 // This list persists in the OpenGLContext, and will re-use cached textures which
 // are created from Images.
@@ -80,16 +255,36 @@ struct CachedImageList final : public ReferenceCountedObject,
                 return t;
             }
 
-            c = images.add (new CachedImage (*this, pixelData));
-            totalSize += c->imageSize;
-
-            while (totalSize > maxCacheSize && images.size() > 1 && totalSize > 0)
-                removeOldestItem();
+            c = addCachedImage (pixelData);
         }
 
         return c->getTextureInfo();
     }
 
+    static bool canUseTextureAtlasFor (const Image& image)
+    {
+        return image.getWidth()  > 0 && image.getWidth()  <= TextureAtlas::maxItemSize
+            && image.getHeight() > 0 && image.getHeight() <= TextureAtlas::maxItemSize
+            && OpenGLImageType::getFrameBufferFrom (image) == nullptr;
+    }
+
+    // Returns the position of a small image in the texture atlas, uploading it if it's
+    // not there yet or its pixels have changed.
+    template <typename FlushFunction>
+    std::optional<Point<int>> getAtlasPositionFor (const Image& image, FlushFunction&& flushPendingQuads)
+    {
+        if (! canUseTextureAtlasFor (image))
+            return {};
+
+        auto pixelData = image.getPixelData();
+        auto* c = findCachedImage (pixelData);
+
+        if (c == nullptr)
+            c = addCachedImage (pixelData);
+
+        return c->getAtlasPosition (atlas, flushPendingQuads);
+    }
+
     struct CachedImage
     {
         CachedImage (CachedImageList& list, ImagePixelData* im)
@@ -129,6 +324,39 @@ struct CachedImageList final : public ReferenceCountedObject,
             return t;
         }
 
+        template <typename FlushFunction>
+        std::optional<Point<int>> getAtlasPosition (TextureAtlas& atlas, FlushFunction&& flushPendingQuads)
+        {
+            if (pixelData == nullptr)
+                return {};
+
+            if (atlasGeneration != atlas.getGeneration())
+            {
+                auto position = atlas.allocate (pixelData->width, pixelData->height, flushPendingQuads);
+
+                if (! position)
+                    return {};
+
+                atlasPosition = *position;
+                atlasGeneration = atlas.getGeneration();
+                atlasNeedsReloading = true;
+            }
+            else if (atlasNeedsReloading)
+            {
+                // any quads that were added before the image changed must be drawn with its old pixels
+                flushPendingQuads();
+            }
+
+            if (atlasNeedsReloading)
+            {
+                atlasNeedsReloading = false;
+                uploadToAtlas (atlas);
+            }
+
+            lastUsed = Time::getCurrentTime();
+            return atlasPosition;
+        }
+
         CachedImageList& owner;
         ImagePixelData* pixelData;
         OpenGLTexture texture;
@@ -136,11 +364,48 @@ struct CachedImageList final : public ReferenceCountedObject,
         const size_t imageSize;
         bool textureNeedsReloading = true;
 
+        Point<int> atlasPosition;
+        int atlasGeneration = -1;
+        bool atlasNeedsReloading = true;
+
+    private:
+        template <class PixelType>
+        static void copyPixels (PixelARGB* dest, const Image::BitmapData& srcData)
+        {
+            for (int y = 0; y < srcData.height; ++y)
+            {
+                auto* src = (const PixelType*) srcData.getLinePointer (y);
+
+                for (int x = 0; x < srcData.width; ++x)
+                    (dest++)->set (src[x]);
+            }
+        }
+
+        void uploadToAtlas (TextureAtlas& atlas)
+        {
+            Image image (*pixelData);
+            Image::BitmapData srcData (image, Image::BitmapData::readOnly);
+            HeapBlock<PixelARGB> pixels ((size_t) (srcData.width * srcData.height));
+
+            switch (srcData.pixelFormat)
+            {
+                case Image::ARGB:           copyPixels<PixelARGB>  (pixels, srcData); break;
+                case Image::RGB:            copyPixels<PixelRGB>   (pixels, srcData); break;
+                case Image::SingleChannel:  copyPixels<PixelAlpha> (pixels, srcData); break;
+                case Image::UnknownFormat:
+                default: break;
+            }
+
+            atlas.upload (atlasPosition, srcData.width, srcData.height, pixels);
+        }
+
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CachedImage)
     };
 
     using Ptr = ReferenceCountedObjectPtr<CachedImageList>;
 
+    TextureAtlas atlas;
+
 private:
     OpenGLContext& context;
     OwnedArray<CachedImage> images;
@@ -155,7 +420,10 @@ private:
     void imageDataChanged (ImagePixelData* im) override
     {
         if (auto* c = findCachedImage (im))
+        {
             c->textureNeedsReloading = true;
+            c->atlasNeedsReloading = true;
+        }
     }
 
     void imageDataBeingDeleted (ImagePixelData* im) override
@@ -190,6 +458,17 @@ private:
         return {};
     }
 
+    CachedImage* addCachedImage (ImagePixelData* pixelData)
+    {
+        auto* c = images.add (new CachedImage (*this, pixelData));
+        totalSize += c->imageSize;
+
+        while (totalSize > maxCacheSize && images.size() > 1 && totalSize > 0)
+            removeOldestItem();
+
+        return c;
+    }
+
     void removeOldestItem()
     {
         CachedImage* oldest = nullptr;
@@ -353,6 +632,7 @@ struct ShaderPrograms final : public ReferenceCountedObject
     ShaderPrograms (OpenGLContext& context)
         : solidColourProgram (context),
           solidColourMasked (context),
+          textureAtlas (context),
           radialGradient (context),
           radialGradientMasked (context),
           linearGradient1 (context),
@@ -424,15 +704,15 @@ struct ShaderPrograms final : public ReferenceCountedObject
             screenBounds.set (bounds.getX(), bounds.getY(), 0.5f * bounds.getWidth(), 0.5f * bounds.getHeight());
         }
 
-        void bindAttributes()
+        virtual void bindAttributes()
         {
-            gl::glVertexAttribPointer ((GLuint) positionAttribute.attributeID, 2, GL_SHORT, GL_FALSE, 8, nullptr);
-            gl::glVertexAttribPointer ((GLuint) colourAttribute.attributeID, 4, GL_UNSIGNED_BYTE, GL_TRUE, 8, (void*) 4);
+            gl::glVertexAttribPointer ((GLuint) positionAttribute.attributeID, 2, GL_SHORT, GL_FALSE, 12, nullptr);
+            gl::glVertexAttribPointer ((GLuint) colourAttribute.attributeID, 4, GL_UNSIGNED_BYTE, GL_TRUE, 12, (void*) 4);
             gl::glEnableVertexAttribArray ((GLuint) positionAttribute.attributeID);
             gl::glEnableVertexAttribArray ((GLuint) colourAttribute.attributeID);
         }
 
-        void unbindAttributes()
+        virtual void unbindAttributes()
         {
             gl::glDisableVertexAttribArray ((GLuint) positionAttribute.attributeID);
             gl::glDisableVertexAttribArray ((GLuint) colourAttribute.attributeID);
@@ -479,6 +759,53 @@ struct ShaderPrograms final : public ReferenceCountedObject
                                               "1.0 - (pixelPos.y - float (maskBounds.y)) / float (maskBounds.w))"
     #define JUCE_GET_MASK_ALPHA         "texture2D (maskTexture, " JUCE_FRAGCOORD_TO_MASK_POS ").a"
 
+    // Draws solid colours, glyphs and small images from the TextureAtlas, so that all of
+    // these can go into the same batch of quads.
+    struct TextureAtlasProgram final : public ShaderBase
+    {
+        TextureAtlasProgram (OpenGLContext& context)
+            : ShaderBase (context, JUCE_DECLARE_VARYING_COLOUR
+                          "uniform sampler2D atlasTexture;"
+                          "varying " JUCE_HIGHP " vec2 texturePos;"
+                          "void main()"
+                          "{"
+                            "gl_FragColor = frontColour * texture2D (atlasTexture, texturePos);"
+                          "}",
+                          "attribute vec2 position;"
+                          "attribute vec4 colour;"
+                          "attribute vec2 textureCoord;"
+                          "uniform vec4 screenBounds;"
+                          "varying " JUCE_MEDIUMP " vec4 frontColour;"
+                          "varying " JUCE_HIGHP " vec2 texturePos;"
+                          "void main()"
+                          "{"
+                            "frontColour = colour;"
+                            "texturePos = textureCoord / 1024.0;"
+                            "vec2 adjustedPos = position - screenBounds.xy;"
+                            "vec2 scaledPos = adjustedPos / screenBounds.zw;"
+                            "gl_Position = vec4 (scaledPos.x - 1.0, 1.0 - scaledPos.y, 0, 1.0);"
+                          "}"),
+              textureCoordAttribute (program, "textureCoord")
+        {
+            static_assert (TextureAtlas::atlasSize == 1024, "The vertex shader needs updating to match the atlas size");
+        }
+
+        void bindAttributes() override
+        {
+            ShaderBase::bindAttributes();
+            gl::glVertexAttribPointer ((GLuint) textureCoordAttribute.attributeID, 2, GL_UNSIGNED_SHORT, GL_FALSE, 12, (void*) 8);
+            gl::glEnableVertexAttribArray ((GLuint) textureCoordAttribute.attributeID);
+        }
+
+        void unbindAttributes() override
+        {
+            ShaderBase::unbindAttributes();
+            gl::glDisableVertexAttribArray ((GLuint) textureCoordAttribute.attributeID);
+        }
+
+        OpenGLShaderProgram::Attribute textureCoordAttribute;
+    };
+
     struct SolidColourMaskedProgram final : public ShaderBase
     {
         SolidColourMaskedProgram (OpenGLContext& context)
@@ -805,6 +1132,7 @@ struct ShaderPrograms final : public ReferenceCountedObject
 
     SolidColourProgram solidColourProgram;
     SolidColourMaskedProgram solidColourMasked;
+    TextureAtlasProgram textureAtlas;
     RadialGradientProgram radialGradient;
     RadialGradientMaskedProgram radialGradientMasked;
     LinearGradient1Program linearGradient1;
@@ -954,6 +1282,7 @@ struct StateHelpers
                 quadQueue.flush();
                 blendingEnabled = true;
                 glEnable (GL_BLEND);
+                ++numChanges;
             }
 
             if (srcFunction != src || dstFunction != dst)
@@ -962,6 +1291,7 @@ struct StateHelpers
                 srcFunction = src;
                 dstFunction = dst;
                 glBlendFunc (src, dst);
+                ++numChanges;
             }
         }
 
@@ -973,6 +1303,7 @@ struct StateHelpers
                 quadQueue.flush();
                 blendingEnabled = false;
                 glDisable (GL_BLEND);
+                ++numChanges;
             }
         }
 
@@ -985,9 +1316,12 @@ struct StateHelpers
                 setPremultipliedBlendingMode (quadQueue);
         }
 
+        int getNumChanges() const noexcept      { return numChanges; }
+
     private:
         bool blendingEnabled = false;
         GLenum srcFunction = 0, dstFunction = 0;
+        int numChanges = 0;
     };
 
     //==============================================================================
@@ -1047,6 +1381,70 @@ struct StateHelpers
         JUCE_DECLARE_NON_COPYABLE (EdgeTableRenderer)
     };
 
+    // Draws from the TextureAtlas, where textureOffset is the position in the atlas
+    // that corresponds to device pixel (0, 0).
+    template <typename QuadQueueType>
+    struct TextureAtlasRenderer
+    {
+        TextureAtlasRenderer (QuadQueueType& q, PixelARGB c, Point<int> offset) noexcept
+            : quadQueue (q), colour (c), textureOffset (offset)
+        {}
+
+        void setEdgeTableYPos (int y) noexcept
+        {
+            currentY = y;
+        }
+
+        void handleEdgeTablePixel (int x, int alphaLevel) noexcept
+        {
+            auto c = colour;
+            c.multiplyAlpha (alphaLevel);
+            add (x, currentY, 1, 1, c);
+        }
+
+        void handleEdgeTablePixelFull (int x) noexcept
+        {
+            add (x, currentY, 1, 1, colour);
+        }
+
+        void handleEdgeTableLine (int x, int width, int alphaLevel) noexcept
+        {
+            auto c = colour;
+            c.multiplyAlpha (alphaLevel);
+            add (x, currentY, width, 1, c);
+        }
+
+        void handleEdgeTableLineFull (int x, int width) noexcept
+        {
+            add (x, currentY, width, 1, colour);
+        }
+
+        void handleEdgeTableRectangle (int x, int y, int width, int height, int alphaLevel) noexcept
+        {
+            auto c = colour;
+            c.multiplyAlpha (alphaLevel);
+            add (x, y, width, height, c);
+        }
+
+        void handleEdgeTableRectangleFull (int x, int y, int width, int height) noexcept
+        {
+            add (x, y, width, height, colour);
+        }
+
+    private:
+        QuadQueueType& quadQueue;
+        const PixelARGB colour;
+        const Point<int> textureOffset;
+        int currentY;
+
+        void add (int x, int y, int width, int height, PixelARGB c) noexcept
+        {
+            quadQueue.add (x, y, width, height, c, x + textureOffset.x, y + textureOffset.y);
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (TextureAtlasRenderer)
+    };
+
     template <typename QuadQueueType>
     struct FloatRectangleRenderer
     {
@@ -1180,6 +1578,7 @@ struct StateHelpers
                 currentTextureID[currentActiveTexture] = textureID;
                 glBindTexture (GL_TEXTURE_2D, textureID);
                 JUCE_CHECK_OPENGL_ERROR
+                ++numBinds;
             }
             else
             {
@@ -1191,10 +1590,12 @@ struct StateHelpers
             }
         }
 
+        int getNumBinds() const noexcept    { return numBinds; }
+
     private:
         static constexpr auto numTextures = 3;
         GLuint currentTextureID[numTextures];
-        int texturesEnabled = 0, currentActiveTexture = -1;
+        int texturesEnabled = 0, currentActiveTexture = -1, numBinds = 0;
         const OpenGLContext& context;
         const bool needsToEnableTexture = ! context.isCoreProfile();
 
@@ -1273,7 +1674,7 @@ struct StateHelpers
 
         ~ShaderQuadQueue() noexcept
         {
-            static_assert (sizeof (VertexInfo) == 8, "Sanity check VertexInfo size");
+            static_assert (sizeof (VertexInfo) == 12, "Sanity check VertexInfo size");
         }
 
         void initialise() noexcept
@@ -1307,31 +1708,13 @@ struct StateHelpers
 
         void add (int x, int y, int w, int h, PixelARGB colour) noexcept
         {
-            jassert (w > 0 && h > 0);
-
-            auto* v = vertexData + numVertices;
-            v[0].x = v[2].x = (GLshort) x;
-            v[0].y = v[1].y = (GLshort) y;
-            v[1].x = v[3].x = (GLshort) (x + w);
-            v[2].y = v[3].y = (GLshort) (y + h);
-
-           #if JUCE_BIG_ENDIAN
-            auto rgba = (GLuint) ((colour.getRed() << 24) | (colour.getGreen() << 16)
-                                | (colour.getBlue() << 8) |  colour.getAlpha());
-           #else
-            auto rgba = (GLuint) ((colour.getAlpha() << 24) | (colour.getBlue() << 16)
-                                | (colour.getGreen() << 8) |  colour.getRed());
-           #endif
-
-            v[0].colour = rgba;
-            v[1].colour = rgba;
-            v[2].colour = rgba;
-            v[3].colour = rgba;
-
-            numVertices += 4;
+            add (x, y, w, h, colour, TextureAtlas::solidColourTexel, TextureAtlas::solidColourTexel, 0, 0);
+        }
 
-            if (numVertices > maxVertices)
-                draw();
+        // Adds a quad which is drawn from the area of the TextureAtlas whose top-left is at (textureX, textureY).
+        void add (int x, int y, int w, int h, PixelARGB colour, int textureX, int textureY) noexcept
+        {
+            add (x, y, w, h, colour, textureX, textureY, w, h);
         }
 
         void add (Rectangle<int> r, PixelARGB colour) noexcept
@@ -1369,17 +1752,29 @@ struct StateHelpers
             et.iterate (etr);
         }
 
+        template <typename IteratorType>
+        void add (const IteratorType& et, PixelARGB colour, Point<int> textureOffset)
+        {
+            TextureAtlasRenderer<ShaderQuadQueue> renderer (*this, colour, textureOffset);
+            et.iterate (renderer);
+        }
+
         void flush() noexcept
         {
             if (numVertices > 0)
                 draw();
         }
 
+        // These include the quads that are still waiting to be drawn.
+        int getNumDrawCalls() const noexcept    { return numDrawCalls + (numVertices > 0 ? 1 : 0); }
+        int getNumQuads() const noexcept        { return numQuadsDrawn + numVertices / 4; }
+
     private:
         struct VertexInfo
         {
             GLshort x, y;
             GLuint colour;
+            GLushort textureX, textureY;
         };
 
         enum { maxNumQuads = 256 };
@@ -1389,7 +1784,7 @@ struct StateHelpers
         VertexInfo vertexData[maxNumQuads * 4];
         GLushort indexData[maxNumQuads * 6];
         const OpenGLContext& context;
-        int numVertices = 0;
+        int numVertices = 0, numDrawCalls = 0, numQuadsDrawn = 0;
 
        #if JUCE_ANDROID || JUCE_IOS
         enum { maxVertices = maxNumQuads * 4 - 4 };
@@ -1404,9 +1799,46 @@ struct StateHelpers
             // their driver.. Can't find a workaround unfortunately.
             glDrawElements (GL_TRIANGLES, (numVertices * 3) / 2, GL_UNSIGNED_SHORT, nullptr);
             JUCE_CHECK_OPENGL_ERROR
+            ++numDrawCalls;
+            numQuadsDrawn += numVertices / 4;
             numVertices = 0;
         }
 
+        void add (int x, int y, int w, int h, PixelARGB colour,
+                  int textureX, int textureY, int textureW, int textureH) noexcept
+        {
+            jassert (w > 0 && h > 0);
+
+            auto* v = vertexData + numVertices;
+            v[0].x = v[2].x = (GLshort) x;
+            v[0].y = v[1].y = (GLshort) y;
+            v[1].x = v[3].x = (GLshort) (x + w);
+            v[2].y = v[3].y = (GLshort) (y + h);
+
+            v[0].textureX = v[2].textureX = (GLushort) textureX;
+            v[0].textureY = v[1].textureY = (GLushort) textureY;
+            v[1].textureX = v[3].textureX = (GLushort) (textureX + textureW);
+            v[2].textureY = v[3].textureY = (GLushort) (textureY + textureH);
+
+           #if JUCE_BIG_ENDIAN
+            auto rgba = (GLuint) ((colour.getRed() << 24) | (colour.getGreen() << 16)
+                                | (colour.getBlue() << 8) |  colour.getAlpha());
+           #else
+            auto rgba = (GLuint) ((colour.getAlpha() << 24) | (colour.getBlue() << 16)
+                                | (colour.getGreen() << 8) |  colour.getRed());
+           #endif
+
+            v[0].colour = rgba;
+            v[1].colour = rgba;
+            v[2].colour = rgba;
+            v[3].colour = rgba;
+
+            numVertices += 4;
+
+            if (numVertices > maxVertices)
+                draw();
+        }
+
         JUCE_DECLARE_NON_COPYABLE (ShaderQuadQueue)
     };
 
@@ -1439,6 +1871,7 @@ struct StateHelpers
                 activeShader = &shader;
                 shader.program.use();
                 shader.bindAttributes();
+                ++numShaderChanges;
 
                 if (shader.onShaderActivated)
                     shader.onShaderActivated (shader.program);
@@ -1471,12 +1904,15 @@ struct StateHelpers
             }
         }
 
+        int getNumShaderChanges() const noexcept    { return numShaderChanges; }
+
         OpenGLContext& context;
         ShaderPrograms::Ptr programs;
 
     private:
         ShaderPrograms::ShaderBase* activeShader = nullptr;
         Rectangle<int> currentBounds;
+        int numShaderChanges = 0;
 
         CurrentShader& operator= (const CurrentShader&);
     };
@@ -1502,6 +1938,7 @@ struct GLState
         activeTextures.clear();
         shaderQuadQueue.initialise();
         cachedImageList = CachedImageList::get (t.context);
+        initialNumAtlasUploads = cachedImageList->atlas.getNumUploads();
         JUCE_CHECK_OPENGL_ERROR
     }
 
@@ -1524,6 +1961,49 @@ struct GLState
         JUCE_CHECK_OPENGL_ERROR
     }
 
+    // Solid colours, glyphs and small images are all drawn with this shader, so that
+    // they can share batches of quads.
+    void setShaderForTextureAtlas (bool replaceExistingContents)
+    {
+        auto& atlas = cachedImageList->atlas;
+
+        if (! atlas.isCreated())
+        {
+            shaderQuadQueue.flush();
+            atlas.create();
+            activeTextures.clear();
+        }
+
+        blendMode.setBlendMode (shaderQuadQueue, replaceExistingContents);
+        setShader (currentShader.programs->textureAtlas);
+        activeTextures.setSingleTextureMode (shaderQuadQueue);
+        activeTextures.bindTexture (atlas.getTextureID());
+    }
+
+    // These must be called after setShaderForTextureAtlas(), because they may need to upload
+    // pixels to the atlas.
+    std::optional<Point<int>> getTextureAtlasPosition (const Image& image)
+    {
+        return cachedImageList->getAtlasPositionFor (image, [this] { shaderQuadQueue.flush(); });
+    }
+
+    std::optional<Point<int>> getTextureAtlasPosition (const GlyphAtlas::Glyph::Ptr& glyph, int levelMultiplier)
+    {
+        return cachedImageList->atlas.getGlyphPosition (glyph, levelMultiplier, [this] { shaderQuadQueue.flush(); });
+    }
+
+    OpenGLContext::RenderingStatistics getStatistics() const
+    {
+        OpenGLContext::RenderingStatistics stats;
+        stats.numDrawCalls          = shaderQuadQueue.getNumDrawCalls();
+        stats.numQuads              = shaderQuadQueue.getNumQuads();
+        stats.numShaderChanges      = currentShader.getNumShaderChanges();
+        stats.numTextureBinds       = activeTextures.getNumBinds();
+        stats.numBlendModeChanges   = blendMode.getNumChanges();
+        stats.numAtlasUploads       = cachedImageList->atlas.getNumUploads() - initialNumAtlasUploads;
+        return stats;
+    }
+
     void setShaderForGradientFill (const ColourGradient& g, const AffineTransform& transform,
                                    int maskTextureID, const Rectangle<int>* maskArea)
     {
@@ -1688,6 +2168,7 @@ struct GLState
 private:
     GLuint previousFrameBufferTarget;
     SavedBinding<TraitsVAO> savedVAOBinding;
+    int initialNumAtlasUploads = 0;
 };
 
 //==============================================================================
@@ -1744,47 +2225,23 @@ struct SavedState final : public RenderingHelpers::SavedStateBase<SavedState>
         }
     }
 
-    using GlyphCacheType = RenderingHelpers::GlyphCache<RenderingHelpers::CachedGlyphEdgeTable<SavedState>, SavedState>;
-
     void drawGlyph (int glyphNumber, const AffineTransform& trans)
     {
         if (clip != nullptr)
         {
-            if (trans.isOnlyTranslation() && ! transform.isRotated)
+            if (auto positioned = findAtlasGlyph (glyphNumber, trans))
             {
-                auto& cache = GlyphCacheType::getInstance();
-                Point<float> pos (trans.getTranslationX(), trans.getTranslationY());
+                if (positioned->glyph == nullptr)
+                    return;
 
-                if (transform.isOnlyTranslated)
-                {
-                    cache.drawGlyph (*this, font, glyphNumber, pos + transform.offset.toFloat());
-                }
+                if (fillType.isColour() && ! isUsingCustomShader)
+                    fillGlyphFromTextureAtlas (*positioned);
                 else
-                {
-                    pos = transform.transformed (pos);
-
-                    Font f (font);
-                    f.setHeight (font.getHeight() * transform.complexTransform.mat11);
-
-                    auto xScale = transform.complexTransform.mat00 / transform.complexTransform.mat11;
-
-                    if (std::abs (xScale - 1.0f) > 0.01f)
-                        f.setHorizontalScale (xScale);
-
-                    cache.drawGlyph (*this, f, glyphNumber, pos);
-                }
+                    fillAtlasGlyph (*positioned);
             }
             else
             {
-                auto fontHeight = font.getHeight();
-
-                auto t = transform.getTransformWith (AffineTransform::scale (fontHeight * font.getHorizontalScale(), fontHeight)
-                                                                     .followedBy (trans));
-
-                const std::unique_ptr<EdgeTable> et (font.getTypefacePtr()->getEdgeTableForGlyph (glyphNumber, t, fontHeight));
-
-                if (et != nullptr)
-                    fillShape (*new EdgeTableRegionType (*et), false);
+                fillUncachedGlyph (glyphNumber, trans);
             }
         }
     }
@@ -1814,6 +2271,18 @@ struct SavedState final : public RenderingHelpers::SavedStateBase<SavedState>
     template <typename IteratorType>
     void renderImageUntransformed (IteratorType& iter, const Image& src, int alpha, int x, int y, bool tiledFill) const
     {
+        if (! tiledFill && CachedImageList::canUseTextureAtlasFor (src))
+        {
+            state->setShaderForTextureAtlas (false);
+
+            if (auto position = state->getTextureAtlasPosition (src))
+            {
+                state->shaderQuadQueue.add (iter, PixelARGB ((uint8) alpha, (uint8) alpha, (uint8) alpha, (uint8) alpha),
+                                            *position - Point<int> (x, y));
+                return;
+            }
+        }
+
         renderImageTransformed (iter, src, alpha, AffineTransform::translation ((float) x, (float) y),
                                 Graphics::lowResamplingQuality, tiledFill);
     }
@@ -1822,11 +2291,7 @@ struct SavedState final : public RenderingHelpers::SavedStateBase<SavedState>
     void fillWithSolidColour (IteratorType& iter, PixelARGB colour, bool replaceContents) const
     {
         if (! isUsingCustomShader)
-        {
-            state->activeTextures.disableTextures (state->shaderQuadQueue);
-            state->blendMode.setBlendMode (state->shaderQuadQueue, replaceContents);
-            state->setShader (state->currentShader.programs->solidColourProgram);
-        }
+            state->setShaderForTextureAtlas (replaceContents);
 
         state->shaderQuadQueue.add (iter, colour);
     }
@@ -1858,6 +2323,45 @@ private:
     Image transparencyLayer;
     std::unique_ptr<Target> previousTarget;
 
+    void fillGlyphFromTextureAtlas (const GlyphAtlas::PositionedGlyph& positioned)
+    {
+        auto area = positioned.getBounds().getIntersection (clip->getClipBounds());
+
+        if (area.isEmpty())
+            return;
+
+        state->setShaderForTextureAtlas (false);
+
+        auto position = state->getTextureAtlasPosition (positioned.glyph, getGlyphLevelMultiplier());
+
+        if (! position)
+        {
+            fillAtlasGlyph (positioned);
+            return;
+        }
+
+        StateHelpers::TextureAtlasRenderer<StateHelpers::ShaderQuadQueue> renderer (state->shaderQuadQueue,
+                                                                                    fillType.colour.getPixelARGB(),
+                                                                                    *position - positioned.getBounds().getPosition());
+
+        // The transparent parts of the glyph's mask are drawn too, so a rectangular clip
+        // only needs one quad per rectangle.
+        if (auto* rectangleClip = dynamic_cast<RectangleListRegionType*> (clip.get()))
+        {
+            for (auto& r : rectangleClip->clip)
+            {
+                auto clipped = r.getIntersection (area);
+
+                if (! clipped.isEmpty())
+                    renderer.handleEdgeTableRectangleFull (clipped.getX(), clipped.getY(), clipped.getWidth(), clipped.getHeight());
+            }
+        }
+        else if (auto clipped = clip->applyClipTo (*new EdgeTableRegionType (area)))
+        {
+            static_cast<EdgeTableRegionType&> (*clipped).edgeTable.iterate (renderer);
+        }
+    }
+
     SavedState& operator= (const SavedState&);
 };
 
@@ -1926,15 +2430,8 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (NonShaderContext)
 };
 
-static void clearOpenGLGlyphCacheCallback()
-{
-    SavedState::GlyphCacheType::getInstance().reset();
-}
-
 static std::unique_ptr<LowLevelGraphicsContext> createOpenGLContext (const Target& target)
 {
-    clearOpenGLGlyphCache = clearOpenGLGlyphCacheCallback;
-
     if (target.context.areShadersAvailable())
         return std::make_unique<ShaderContext> (target);
 
@@ -1960,6 +2457,14 @@ std::unique_ptr<LowLevelGraphicsContext> createOpenGLGraphicsContext (OpenGLCont
     return OpenGLRendering::createOpenGLContext (OpenGLRendering::Target (context, frameBufferID, width, height));
 }
 
+OpenGLContext::RenderingStatistics getOpenGLGraphicsContextStatistics (const LowLevelGraphicsContext& context)
+{
+    if (auto* sc = dynamic_cast<const OpenGLRendering::ShaderContext*> (&context))
+        return sc->glState.getStatistics();
+
+    return {};
+}
+
 //==============================================================================
 struct CustomProgram final : public ReferenceCountedObject,
                              public OpenGLRendering::ShaderPrograms::ShaderBase
@@ -2053,4 +2558,286 @@ Result OpenGLGraphicsContextCustomShader::checkCompilation (LowLevelGraphicsCont
     return Result::fail (errorMessage);
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class OpenGLGraphicsContextTests final : public UnitTest
+{
+public:
+    OpenGLGraphicsContextTests()
+        : UnitTest ("OpenGL graphics context", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        using Layout = OpenGLRendering::TextureAtlasLayout;
+
+        beginTest ("The texture atlas packs items into shelves");
+        {
+            Layout layout;
+
+            expect (layout.findSpace (10, 10) == Point<int> (0, Layout::whiteBlockSize));
+            expect (layout.findSpace (20, 10) == Point<int> (10, Layout::whiteBlockSize));
+
+            // Slightly shorter items share a shelf, but much shorter ones start a new one
+            expect (layout.findSpace (5, 8) == Point<int> (30, Layout::whiteBlockSize));
+            expect (layout.findSpace (5, 5) == Point<int> (0, Layout::whiteBlockSize + 10));
+
+            // An item that doesn't fit at the end of a shelf goes onto a new one
+            expect (layout.findSpace (Layout::atlasSize - 20, 10) == Point<int> (0, Layout::whiteBlockSize + 15));
+        }
+
+        beginTest ("Items in the texture atlas don't overlap");
+        {
+            Layout layout;
+            Random r (1234);
+            RectangleList<int> used;
+            const Rectangle<int> atlasArea (Layout::atlasSize, Layout::atlasSize);
+            const Rectangle<int> whiteBlock (Layout::whiteBlockSize, Layout::whiteBlockSize);
+            int numAllocated = 0;
+
+            for (;;)
+            {
+                auto w = 1 + r.nextInt (Layout::maxItemSize);
+                auto h = 1 + r.nextInt (Layout::maxItemSize);
+                auto position = layout.findSpace (w, h);
+
+                if (! position)
+                    break;
+
+                Rectangle<int> area (position->x, position->y, w, h);
+                expect (atlasArea.contains (area));
+                expect (! area.intersects (whiteBlock));
+                expect (! used.intersectsRectangle (area));
+
+                used.add (area);
+                ++numAllocated;
+            }
+
+            expect (numAllocated > 50);
+        }
+
+        beginTest ("Clearing the texture atlas starts a new generation");
+        {
+            Layout layout;
+            const auto generation = layout.getGeneration();
+
+            while (layout.findSpace (Layout::maxItemSize, Layout::maxItemSize)) {}
+
+            expect (! layout.findSpace (Layout::maxItemSize, Layout::maxItemSize).has_value());
+            expectEquals (layout.getGeneration(), generation);
+
+            layout.clear();
+            expectEquals (layout.getGeneration(), generation + 1);
+            expect (layout.findSpace (Layout::maxItemSize, Layout::maxItemSize) == Point<int> (0, Layout::whiteBlockSize));
+        }
+
+        beginTest ("Glyphs in the texture atlas are reused for the same level multiplier");
+        {
+            Layout layout;
+            auto glyph = createGlyph ('a');
+            auto other = createGlyph ('b');
+
+            if (glyph == nullptr || other == nullptr)
+            {
+                logMessage ("No glyphs available, skipping");
+            }
+            else
+            {
+                expect (! layout.findGlyph (*glyph, 256).has_value());
+
+                const auto numReferences = glyph->getReferenceCount();
+                layout.addGlyph (glyph, 256, { 10, 20 });
+
+                expect (layout.findGlyph (*glyph, 256) == Point<int> (10, 20));
+                expect (! layout.findGlyph (*glyph, 128).has_value());
+                expect (! layout.findGlyph (*other, 256).has_value());
+
+                // The layout holds on to the glyph, so its address can't be reused by another one
+                expectEquals (glyph->getReferenceCount(), numReferences + 1);
+
+                layout.clear();
+                expect (! layout.findGlyph (*glyph, 256).has_value());
+                expectEquals (glyph->getReferenceCount(), numReferences);
+            }
+        }
+
+        beginTest ("Interleaved fills, text and images are drawn in a few batches");
+        {
+            SceneRenderer renderer;
+            OpenGLContext context;
+            context.setRenderer (&renderer);
+
+            // On Linux this uses a surfaceless EGL context, so it runs on a headless machine
+            // as long as Mesa is installed, and a failure to render is a real failure
+            if (context.renderOffscreen())
+            {
+                logMessage ("Rendering offscreen with " + renderer.rendererName);
+                expect (renderer.result.isValid());
+            }
+            else if (! renderInWindow (context, renderer))
+            {
+                logMessage ("Couldn't create an OpenGL context, skipping");
+                return;
+            }
+
+            if (renderer.shadersAvailable)
+            {
+                expect (renderer.statistics.numDrawCalls <= 3);
+                expect (renderer.statistics.numShaderChanges <= 2);
+                expect (renderer.statistics.numQuads >= numSceneItems * 2);
+                expect (renderer.statistics.numAtlasUploads > 0);
+            }
+
+            Image expected (Image::ARGB, sceneWidth, sceneHeight, true, SoftwareImageType());
+
+            {
+                Graphics g (expected);
+                drawScene (g);
+            }
+
+            expectEquals (countDifferences (expected, renderer.result, 8), 0);
+        }
+    }
+
+private:
+    static constexpr int sceneWidth = 320, sceneHeight = 240, numSceneItems = 10;
+
+    struct SceneRenderer;
+
+    static bool renderInWindow (OpenGLContext& context, SceneRenderer& renderer)
+    {
+       #if JUCE_LINUX || JUCE_BSD
+        if (! XWindowSystem::getInstance()->isX11Available())
+            return false;
+       #endif
+
+        Component window;
+
+        context.setComponentPaintingEnabled (false);
+        context.setContinuousRepainting (true);
+
+        window.setBounds (0, 0, sceneWidth, sceneHeight);
+        window.addToDesktop (0);
+        window.setVisible (true);
+        context.attachTo (window);
+
+        const auto rendered = renderer.finished.wait (5000);
+        context.detach();
+
+        return rendered && renderer.result.isValid();
+    }
+
+    static GlyphAtlas::Glyph::Ptr createGlyph (juce_wchar character)
+    {
+        Font font (16.0f);
+        Array<int> glyphNumbers;
+        Array<float> offsets;
+        font.getGlyphPositions (String::charToString (character), glyphNumbers, offsets);
+
+        if (glyphNumbers.isEmpty())
+            return {};
+
+        return GlyphAtlas::findOrCreateGlyph (font, glyphNumbers.getFirst(), { 10.0f, 20.0f }).glyph;
+    }
+
+    static Image createIcon()
+    {
+        Image icon (Image::ARGB, 16, 16, true, SoftwareImageType());
+        Graphics g (icon);
+        g.setColour (Colours::darkorange);
+        g.fillRect (2, 2, 12, 12);
+        g.setColour (Colours::navy);
+        g.fillRect (5, 5, 6, 6);
+        return icon;
+    }
+
+    // Alternates between the three kinds of drawing that share the texture atlas
+    static void drawScene (Graphics& g)
+    {
+        const auto icon = createIcon();
+
+        g.fillAll (Colours::white);
+        g.setFont (14.0f);
+
+        for (int i = 0; i < numSceneItems; ++i)
+        {
+            const auto y = 4 + i * 23;
+
+            g.setColour (i % 2 == 0 ? Colours::lightgrey : Colours::lightblue);
+            g.fillRect (0, y, sceneWidth, 20);
+
+            g.setColour (Colours::black);
+            g.drawText ("Row " + String (i), 30, y, 200, 20, Justification::centredLeft, false);
+
+            g.drawImageAt (icon, 8, y + 2);
+        }
+    }
+
+    static int countDifferences (const Image& a, const Image& b, int tolerance)
+    {
+        const Image::BitmapData da (a, Image::BitmapData::readOnly);
+        const Image::BitmapData db (b, Image::BitmapData::readOnly);
+        int numDifferences = 0;
+
+        for (int y = 0; y < a.getHeight(); ++y)
+        {
+            for (int x = 0; x < a.getWidth(); ++x)
+            {
+                const auto pa = da.getPixelColour (x, y);
+                const auto pb = db.getPixelColour (x, y);
+
+                if (std::abs (pa.getRed()   - pb.getRed())   > tolerance
+                     || std::abs (pa.getGreen() - pb.getGreen()) > tolerance
+                     || std::abs (pa.getBlue()  - pb.getBlue())  > tolerance)
+                    ++numDifferences;
+            }
+        }
+
+        return numDifferences;
+    }
+
+    // Draws the scene into an OpenGL image the first time it's called, and keeps the
+    // statistics and a software copy of the result.
+    struct SceneRenderer final : public OpenGLRenderer
+    {
+        void newOpenGLContextCreated() override {}
+        void openGLContextClosing() override {}
+
+        void renderOpenGL() override
+        {
+            if (finished.wait (0))
+                return;
+
+            if (auto* context = OpenGLContext::getCurrentContext())
+            {
+                shadersAvailable = context->areShadersAvailable();
+                rendererName = String::fromUTF8 ((const char*) glGetString (GL_RENDERER));
+                Image image (OpenGLImageType().create (Image::ARGB, sceneWidth, sceneHeight, true));
+
+                {
+                    Graphics g (image);
+                    drawScene (g);
+                    statistics = getOpenGLGraphicsContextStatistics (g.getInternalContext());
+                }
+
+                result = SoftwareImageType().convert (image);
+            }
+
+            finished.signal();
+        }
+
+        WaitableEvent finished { true };
+        OpenGLContext::RenderingStatistics statistics;
+        Image result;
+        String rendererName;
+        bool shadersAvailable = false;
+    };
+};
+
+static OpenGLGraphicsContextTests openGLGraphicsContextTests;
+
+#endif
+
 } // namespace juce
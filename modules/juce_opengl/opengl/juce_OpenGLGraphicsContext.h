@@ -39,6 +39,12 @@ std::unique_ptr<LowLevelGraphicsContext> createOpenGLGraphicsContext (OpenGLCont
                                                                       unsigned int frameBufferID,
                                                                       int width, int height);
 
+/** Returns the work that a context created by createOpenGLGraphicsContext() has submitted
+    to the GPU so far, including the batch of quads that it hasn't drawn yet.
+    For any other kind of context, this returns an empty set of statistics.
+*/
+OpenGLContext::RenderingStatistics getOpenGLGraphicsContextStatistics (const LowLevelGraphicsContext&);
+
 
 //==============================================================================
 /**